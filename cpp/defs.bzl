@@ -28,8 +28,11 @@ Available rules:
     cpp_component: Build C++ WebAssembly component
     cpp_wit_bindgen: Generate C/C++ bindings from WIT
     cc_component_library: Create reusable C/C++ component library
+    cpp_component_variants: Build a component once per SIMD variant
     cpp_wasm_binary: Build C++ WASM binary (CLI executable)
     c_wasm_binary: Build C WASM binary (CLI executable)
+    cpp_pgo_profile: Train a profile for -fprofile-use (profile attribute)
+    cpp_wasm_benchmark: Benchmark libraries AOT-compiled under wasmtime
 
 C/C++ WebAssembly Component Model rules
 
@@ -68,9 +71,18 @@ Example usage:
     )
 """
 
+load("@bazel_skylib//rules:common_settings.bzl", "BuildSettingInfo")
 load("@rules_cc//cc/common:cc_common.bzl", "cc_common")
 load("@rules_cc//cc/common:cc_info.bzl", "CcInfo")
 load("//common:wasm_component_utils.bzl", "VALIDATE_WIT_ATTR_KWARGS", "WASI_VERSION_ATTR_KWARGS", "create_component_info")
+load(
+    "//cpp/private:cpp_pgo.bzl",
+    "add_pgo_flags",
+    "pgo_inputs",
+    "pgo_mode",
+    _cpp_pgo_profile = "cpp_pgo_profile",
+)
+load("//cpp/private:cpp_wasm_benchmark.bzl", _cpp_wasm_benchmark = "cpp_wasm_benchmark")
 load(
     "//cpp/private:cpp_wasm_binary.bzl",
     _c_wasm_binary = "c_wasm_binary",
@@ -80,6 +92,148 @@ load("//providers:providers.bzl", "WasmComponentInfo")
 load("//rust:transitions.bzl", "wasm_transition")
 load("//tools/bazel_helpers:file_ops_actions.bzl", "setup_cpp_workspace_action")
 
+# Forwards wasmtime wizer's init call to a component's wizer_init
+_WIZER_SHIM_TEMPLATE = """// Generated by cpp_component(wizer_init = "{init}")
+extern void {init}(void);
+
+__attribute__((export_name("wizer-initialize")))
+void rules_wasm_component_wizer_initialize(void) {{
+    {init}();
+}}
+"""
+
+def _is_c_identifier(name):
+    """Whether name is usable as a C function name."""
+    if not name or name[0].isdigit():
+        return False
+    for c in name.elems():
+        if not (c.isalnum() or c == "_"):
+            return False
+    return True
+
+def _wasm_target(ctx):
+    """Target triple for a compile; wasi-threads needs the wasip1-threads sysroot."""
+
+    # Preview 2 components cannot declare shared memory yet, so threaded
+    # builds use the wasi-threads target and its pthread-enabled libc/libc++
+    return "wasm32-wasip1-threads" if ctx.attr.threads else "wasm32-wasip2"
+
+def _add_thread_flags(ctx, args):
+    """Adds -pthread (atomics, bulk memory, _REENTRANT) to a threaded compile."""
+    if ctx.attr.threads:
+        args.add("-pthread")
+
+def _add_optimization_flags(ctx, args):
+    """Adds -O3 with ThinLTO, or -O0 -g; the same flags compile objects and link them."""
+    if ctx.attr.optimize:
+        args.add("-O3")
+        args.add("-flto=thin")
+    else:
+        args.add("-O0")
+        args.add("-g")
+
+# wasm-opt passes per wasm_opt profile; debug builds (optimize = False) only
+# get the cheap passes and keep names and DWARF
+_WASM_OPT_FLAGS = {
+    "speed": ["-O3"],
+    "size": ["-Oz"],
+}
+
+_WASM_OPT_DEBUG_FLAGS = ["-O1", "-g"]
+
+def _run_wasm_opt(ctx, wasm_tools, linked_wasm, wasm_binary):
+    """Runs wasm-opt on the linked core module and writes wasm_binary.
+
+    Features come from the module's target_features section. A wasip2
+    module is turned back into the component the link would have produced;
+    a wasi-threads module stays a core module.
+    """
+    binaryen_toolchain = ctx.toolchains["@rules_wasm_component//toolchains:binaryen_toolchain_type"]
+    if not binaryen_toolchain:
+        fail("cpp_component wasm_opt needs a registered binaryen toolchain")
+
+    optimized_wasm = wasm_binary
+    if not ctx.attr.threads:
+        optimized_wasm = ctx.actions.declare_file(ctx.attr.name + "_opt.wasm")
+
+    opt_args = ctx.actions.args()
+    opt_args.add_all(_WASM_OPT_FLAGS[ctx.attr.wasm_opt] if ctx.attr.optimize else _WASM_OPT_DEBUG_FLAGS)
+    opt_args.add(linked_wasm)
+    opt_args.add("-o", optimized_wasm)
+
+    ctx.actions.run(
+        executable = binaryen_toolchain.wasm_opt,
+        arguments = [opt_args],
+        inputs = [linked_wasm],
+        outputs = [optimized_wasm],
+        mnemonic = "CppWasmOpt",
+        progress_message = "Optimizing %s with wasm-opt (%s)" % (ctx.label, ctx.attr.wasm_opt),
+    )
+
+    if ctx.attr.threads:
+        return
+
+    # The component-type sections from libc and the bindings survive
+    # wasm-opt, so this is the wrapping wasm-component-ld skipped
+    new_args = ctx.actions.args()
+    new_args.add("component")
+    new_args.add("new")
+    new_args.add(optimized_wasm)
+    new_args.add("-o", wasm_binary)
+
+    ctx.actions.run(
+        executable = wasm_tools,
+        arguments = [new_args],
+        inputs = [optimized_wasm],
+        outputs = [wasm_binary],
+        mnemonic = "CppWasmComponentNew",
+        progress_message = "Wrapping optimized module for %s" % ctx.label,
+    )
+
+# SIMD variants: compiler flags and the wasm features a host runtime must enable
+_SIMD_FLAGS = {
+    "none": ["-mno-simd128", "-mno-relaxed-simd"],
+    "simd128": ["-msimd128"],
+    "relaxed": ["-msimd128", "-mrelaxed-simd"],
+}
+
+_SIMD_FEATURES = {
+    "none": [],
+    "simd128": ["simd"],
+    "relaxed": ["simd", "relaxed-simd"],
+}
+
+_SIMD_VALUES = [""] + _SIMD_FLAGS.keys()
+
+def _simd_level(ctx, setting_first = False):
+    """SIMD variant of a compile, "" when neither the target nor //cpp:simd sets one.
+
+    A component's own simd wins over //cpp:simd; a library takes //cpp:simd
+    first, since that is how the component linking it passes its variant down.
+    """
+    setting = ctx.attr._simd_setting[BuildSettingInfo].value
+    setting = "" if setting == "auto" else setting
+    if setting_first:
+        return setting or ctx.attr.simd
+    return ctx.attr.simd or setting
+
+def _add_simd_flags(ctx, args, setting_first = False):
+    """Adds the SIMD variant's flags; call after copts so they take precedence."""
+    level = _simd_level(ctx, setting_first)
+    if level:
+        args.add_all(_SIMD_FLAGS[level])
+
+def _simd_deps_transition_impl(settings, attr):
+    # A component's simd applies to the libraries it links, so every
+    # variant compiles its own copy of them
+    return {"//cpp:simd": attr.simd if attr.simd else settings["//cpp:simd"]}
+
+_simd_deps_transition = transition(
+    implementation = _simd_deps_transition_impl,
+    inputs = ["//cpp:simd"],
+    outputs = ["//cpp:simd"],
+)
+
 def _cpp_component_impl(ctx):
     """Implementation of cpp_component rule for C/C++ WebAssembly components.
 
@@ -96,29 +250,38 @@ def _cpp_component_impl(ctx):
             - ctx.attr.language: Either "c" or "cpp"
             - ctx.attr.cxx_std: C++ standard (c++17/20/23)
             - ctx.attr.enable_exceptions: Enable C++ exception handling
-            - ctx.attr.optimize: Enable optimizations (-O3, -flto)
+            - ctx.attr.optimize: Enable optimizations (-O3, ThinLTO)
+            - ctx.attr.cabi_arena: Link the per-call cabi_realloc arena
+            - ctx.attr.threads: Build for wasi-threads with shared memory
+            - ctx.attr.simd: SIMD variant (none, simd128, relaxed), also applied to deps
+            - ctx.file.profile: Merged .profdata for -fprofile-use
+            - ctx.attr.wizer_init: C function to run and snapshot at build time
+            - ctx.attr.wasm_opt: wasm-opt profile for the linked module (speed, size)
 
     Returns:
         List of providers:
         - WasmComponentInfo: Component metadata with language and toolchain info
         - DefaultInfo: Component .wasm file and validation logs
-        - OutputGroupInfo: Organized outputs (bindings, wasm_module, validation)
+        - OutputGroupInfo: Organized outputs (bindings, wasm_module, validation,
+          uninitialized)
 
     The implementation follows these steps:
     1. Generate C/C++ bindings from WIT using wit-bindgen
     2. Set up compilation workspace with proper header staging
     3. Compile WIT bindings separately (C compilation to avoid C++ flags)
-    4. Compile application sources with dependency headers and includes
+    4. Compile each application source to an object (ThinLTO bitcode when optimizing)
     5. Link everything together with C++ standard library (if needed)
-    6. Embed WIT metadata and create component using wasm-tools
-    7. Optionally validate the component against WIT specification
+    6. Optionally run wasm-opt on the linked module (wasm_opt)
+    7. Embed WIT metadata and create component using wasm-tools
+    8. Optionally pre-initialize it with wasmtime wizer (wizer_init)
+    9. Optionally validate the component against WIT specification
 
     Key features:
     - Cross-package header dependency resolution using CcInfo
     - Proper staging of local vs external headers
     - Support for modern C++ standards (C++17/20/23)
     - Exception handling support (increases binary size)
-    - LTO optimization for size reduction
+    - Per-source compile actions with ThinLTO, so edits rebuild one object
     - WASI SDK Preview2 native compilation
     """
 
@@ -204,22 +367,31 @@ def _cpp_component_impl(ctx):
     )
 
     # Create working directory for compilation using File Operations Component
+    # Sources compile from their own paths, so only headers are staged
     work_dir = setup_cpp_workspace_action(
         ctx,
-        sources = sources,
+        sources = [],
         headers = headers,
         dep_headers = dep_headers,
         bindings_dir = bindings_dir,
     )
 
-    # Compile to WASM
+    # Compile each source to its own object, then link them in a separate step
     wasm_binary = ctx.actions.declare_file(ctx.attr.name + "_module.wasm")
 
+    # Flags shared by the per-source compiles
     compile_args = ctx.actions.args()
 
+    # Flags for the final link
+    link_args = ctx.actions.args()
+
     # Basic compiler flags for Preview2
-    compile_args.add("--target=wasm32-wasip2")
-    compile_args.add("-mexec-model=reactor")  # Library component, not CLI
+    compile_args.add("--target=" + _wasm_target(ctx))
+    compile_args.add("-c")
+    _add_thread_flags(ctx, compile_args)
+    link_args.add("--target=" + _wasm_target(ctx))
+    link_args.add("-mexec-model=reactor")  # Library component, not CLI
+    _add_thread_flags(ctx, link_args)
 
     # Build sysroot path from toolchain repository for external compatibility
     if sysroot_files and sysroot_files.files:
@@ -237,6 +409,7 @@ def _cpp_component_impl(ctx):
         sysroot_path = sysroot
 
     compile_args.add("--sysroot=" + sysroot_path)
+    link_args.add("--sysroot=" + sysroot_path)
 
     # Component model definitions
     compile_args.add("-D_WASI_EMULATED_PROCESS_CLOCKS")
@@ -246,18 +419,15 @@ def _cpp_component_impl(ctx):
 
     # Standard library control
     if ctx.attr.nostdlib:
-        compile_args.add("-nostdlib")
+        link_args.add("-nostdlib")
 
         # When using nostdlib, we need to be more selective about what we link
-        compile_args.add("-Wl,--no-entry")  # Don't expect a main function
+        link_args.add("-Wl,--no-entry")  # Don't expect a main function
 
-    # Optimization and language settings
-    if ctx.attr.optimize:
-        compile_args.add("-O3")
-        compile_args.add("-flto")
-    else:
-        compile_args.add("-O0")
-        compile_args.add("-g")
+    # Optimization and language settings; objects carry ThinLTO bitcode, so
+    # the link optimizes across them without merging into one module
+    _add_optimization_flags(ctx, compile_args)
+    _add_optimization_flags(ctx, link_args)
 
     # C++ specific flags (for source compilation)
     if needs_cpp_compilation:
@@ -280,7 +450,7 @@ def _cpp_component_impl(ctx):
     # Include directories
     compile_args.add("-I" + work_dir.path)
 
-    # Add C++ standard library paths for wasm32-wasip2 target
+    # Add C++ standard library paths for the target
     if needs_cpp_compilation:
         # WASI SDK stores C++ headers in share/wasi-sysroot, not just sysroot
         if "/external/" in sysroot_path:
@@ -288,7 +458,7 @@ def _cpp_component_impl(ctx):
             wasi_sysroot = toolchain_repo + "/share/wasi-sysroot"
         else:
             wasi_sysroot = sysroot_path
-        compile_args.add("-I" + wasi_sysroot + "/include/wasm32-wasip2/c++/v1")
+        compile_args.add("-I" + wasi_sysroot + "/include/" + _wasm_target(ctx) + "/c++/v1")
         compile_args.add("-I" + wasi_sysroot + "/include/c++/v1")
 
         # Also add clang's builtin headers
@@ -313,12 +483,22 @@ def _cpp_component_impl(ctx):
     for define in ctx.attr.defines:
         compile_args.add("-D" + define)
 
-    # Compile flags
+    # Compile flags; they also reach the link, as they did when one clang
+    # invocation compiled and linked, so -Wl, options keep working
     for flag in ctx.attr.copts:
         compile_args.add(flag)
-
-    # Output
-    compile_args.add("-o", wasm_binary.path)
+        link_args.add(flag)
+    _add_simd_flags(ctx, compile_args)
+    _add_simd_flags(ctx, link_args)
+    add_pgo_flags(ctx, compile_args)
+    add_pgo_flags(ctx, link_args)
+
+    # Per-call canonical ABI arena: sources see cabi_arena.h and the define
+    cabi_arena_files = []
+    if ctx.attr.cabi_arena:
+        cabi_arena_files = [ctx.file._cabi_arena_src, ctx.file._cabi_arena_hdr]
+        compile_args.add("-DWASM_CABI_ARENA=1")
+        compile_args.add("-I" + ctx.file._cabi_arena_hdr.dirname)
 
     # Add external dependency headers to inputs (from CcInfo)
     external_headers = []
@@ -327,10 +507,6 @@ def _cpp_component_impl(ctx):
             cc_info = dep[CcInfo]
             external_headers.extend(cc_info.compilation_context.headers.to_list())
 
-    # Add source files from work directory
-    for src in sources:
-        compile_args.add(work_dir.path + "/" + src.basename)
-
     # Compile generated WIT binding file separately
     # wit-bindgen generates filenames by converting hyphens to underscores: http-service-world -> http_service_world.c
     world_name = ctx.attr.world or "component"  # Default to "component" if no world specified
@@ -343,13 +519,40 @@ def _cpp_component_impl(ctx):
     # Add bindings header directory to include path
     compile_args.add("-I" + bindings_dir.path)
 
+    # One action per source, compiled from its own path: the workspace only
+    # stages headers, so editing a source reruns just that source's compile
+    source_inputs = [work_dir, bindings_dir] + headers + cabi_arena_files + sysroot_files.files.to_list() + dep_headers + external_headers + pgo_inputs(ctx)
+    source_objects = []
+    for src in sources:
+        # Keyed by the full source path, extension included, so foo.c and
+        # foo.cpp or a/util.cpp and b/util.cpp get separate objects; sources
+        # from other repositories (../repo/...) keep their repository name
+        obj_file = ctx.actions.declare_file("{}_objs/{}.o".format(ctx.attr.name, src.short_path.removeprefix("../")))
+        source_objects.append(obj_file)
+
+        src_args = ctx.actions.args()
+        src_args.add("-o", obj_file.path)
+        src_args.add(src.path)
+
+        ctx.actions.run(
+            executable = clang,
+            arguments = [compile_args, src_args],
+            inputs = [src] + source_inputs,
+            outputs = [obj_file],
+            mnemonic = "Compile" + ("C" if ctx.attr.language == "c" else "Cpp") + "Object",
+            progress_message = "Compiling {} {} for {}".format(ctx.attr.language.upper(), src.basename, ctx.label),
+        )
+
+    link_args.add_all(source_objects)
+
     # Compile the generated C binding file separately to avoid C++ flags
     binding_obj_file = ctx.actions.declare_file(ctx.attr.name + "_bindings.o")
 
     binding_compile_args = ctx.actions.args()
-    binding_compile_args.add("--target=wasm32-wasip2")
+    binding_compile_args.add("--target=" + _wasm_target(ctx))
     binding_compile_args.add("--sysroot=" + sysroot_path)
     binding_compile_args.add("-c")  # Compile only, don't link
+    _add_thread_flags(ctx, binding_compile_args)
 
     # Component model definitions (same as main compilation)
     binding_compile_args.add("-D_WASI_EMULATED_PROCESS_CLOCKS")
@@ -358,12 +561,7 @@ def _cpp_component_impl(ctx):
     binding_compile_args.add("-DCOMPONENT_MODEL_PREVIEW2")
 
     # Optimization settings
-    if ctx.attr.optimize:
-        binding_compile_args.add("-O3")
-        binding_compile_args.add("-flto")
-    else:
-        binding_compile_args.add("-O0")
-        binding_compile_args.add("-g")
+    _add_optimization_flags(ctx, binding_compile_args)
 
     # Exception handling for binding compilation (if C++ exceptions are enabled)
     if ctx.attr.language == "cpp" and ctx.attr.enable_exceptions:
@@ -384,7 +582,7 @@ def _cpp_component_impl(ctx):
             wasi_sysroot = toolchain_repo + "/share/wasi-sysroot"
         else:
             wasi_sysroot = sysroot_path
-        binding_compile_args.add("-I" + wasi_sysroot + "/include/wasm32-wasip2/c++/v1")
+        binding_compile_args.add("-I" + wasi_sysroot + "/include/" + _wasm_target(ctx) + "/c++/v1")
         binding_compile_args.add("-I" + wasi_sysroot + "/include/c++/v1")
 
         # Also add clang's builtin headers
@@ -413,22 +611,85 @@ def _cpp_component_impl(ctx):
     )
 
     # Add compiled binding object file and pre-compiled component type object to linking
-    compile_args.add(binding_obj_file.path)
-    compile_args.add(binding_o_file)
+    link_args.add(binding_obj_file.path)
+    link_args.add(binding_o_file)
+
+    # The arena's strong cabi_realloc must be a linked object, not an archive
+    # member, to take precedence over the weak definition in the bindings
+    link_objects = source_objects + [binding_obj_file]
+    if ctx.attr.cabi_arena:
+        arena_obj_file = ctx.actions.declare_file(ctx.attr.name + "_cabi_arena.o")
+
+        arena_compile_args = ctx.actions.args()
+        arena_compile_args.add("--target=" + _wasm_target(ctx))
+        arena_compile_args.add("--sysroot=" + sysroot_path)
+        arena_compile_args.add("-c")
+        _add_thread_flags(ctx, arena_compile_args)
+        _add_optimization_flags(ctx, arena_compile_args)
+        arena_compile_args.add("-I" + ctx.file._cabi_arena_hdr.dirname)
+        arena_compile_args.add("-o", arena_obj_file.path)
+        arena_compile_args.add(ctx.file._cabi_arena_src.path)
+
+        ctx.actions.run(
+            executable = clang,
+            arguments = [arena_compile_args],
+            inputs = cabi_arena_files + sysroot_files.files.to_list(),
+            outputs = [arena_obj_file],
+            mnemonic = "CompileCabiArena",
+            progress_message = "Compiling canonical ABI arena for %s" % ctx.label,
+        )
+
+        link_args.add(arena_obj_file.path)
+        link_objects.append(arena_obj_file)
+
+    # wasmtime wizer calls the core export wizer-initialize, which a WIT
+    # world cannot declare, so link a shim that forwards it to wizer_init
+    if ctx.attr.wizer_init:
+        if not _is_c_identifier(ctx.attr.wizer_init):
+            fail("cpp_component wizer_init must name a C function, got '{}'".format(ctx.attr.wizer_init))
+
+        wizer_shim = ctx.actions.declare_file(ctx.attr.name + "_wizer_init.c")
+        ctx.actions.write(
+            output = wizer_shim,
+            content = _WIZER_SHIM_TEMPLATE.format(init = ctx.attr.wizer_init),
+        )
+
+        wizer_obj_file = ctx.actions.declare_file(ctx.attr.name + "_wizer_init.o")
+
+        wizer_compile_args = ctx.actions.args()
+        wizer_compile_args.add("--target=" + _wasm_target(ctx))
+        wizer_compile_args.add("--sysroot=" + sysroot_path)
+        wizer_compile_args.add("-c")
+        _add_thread_flags(ctx, wizer_compile_args)
+        wizer_compile_args.add("-O2")
+        wizer_compile_args.add("-o", wizer_obj_file.path)
+        wizer_compile_args.add(wizer_shim.path)
+
+        ctx.actions.run(
+            executable = clang,
+            arguments = [wizer_compile_args],
+            inputs = [wizer_shim] + sysroot_files.files.to_list(),
+            outputs = [wizer_obj_file],
+            mnemonic = "CompileWizerInit",
+            progress_message = "Compiling wizer init shim for %s" % ctx.label,
+        )
+
+        link_args.add(wizer_obj_file.path)
+        link_objects.append(wizer_obj_file)
 
     # Add library linking
     if ctx.attr.nostdlib:
         # When nostdlib is enabled, only link explicitly specified libraries
         for lib in ctx.attr.libs:
             if lib.startswith("-"):
-                compile_args.add(lib)  # Direct linker flag (e.g., "-lm", "-ldl")
+                link_args.add(lib)  # Direct linker flag (e.g., "-lm", "-ldl")
             else:
-                compile_args.add("-l" + lib)  # Library name (e.g., "m" -> "-lm")
+                link_args.add("-l" + lib)  # Library name (e.g., "m" -> "-lm")
     else:
         # Standard library linking for C++ source files
         if needs_cpp_compilation:
-            compile_args.add("-lc++")
-            compile_args.add("-lc++abi")
+            link_args.add("-lc++")
+            link_args.add("-lc++abi")
 
             # Add exception handling support if enabled
             # Note: Exception handling symbols are typically in libc++abi which we already link
@@ -436,30 +697,54 @@ def _cpp_component_impl(ctx):
         # Add any additional libraries specified by user
         for lib in ctx.attr.libs:
             if lib.startswith("-"):
-                compile_args.add(lib)  # Direct linker flag
+                link_args.add(lib)  # Direct linker flag
             else:
-                compile_args.add("-l" + lib)  # Library name
+                link_args.add("-l" + lib)  # Library name
 
     # Add dependency libraries for linking
     for lib in dep_libraries:
-        compile_args.add(lib.path)
+        link_args.add(lib.path)
+
+    # wasi-threads instantiates every thread against one imported shared
+    # memory, which must declare a fixed maximum
+    if ctx.attr.threads:
+        link_args.add("-Wl,--import-memory")
+        link_args.add("-Wl,--export-memory")
+        link_args.add("-Wl,--shared-memory")
+        link_args.add("-Wl,--max-memory=%d" % ctx.attr.max_memory)
+
+    # wasm-opt only reads core modules, so a wasip2 link stops before
+    # wasm-component-ld wraps the module and wasm-tools does it afterwards
+    linked_wasm = wasm_binary
+    if ctx.attr.wasm_opt:
+        linked_wasm = ctx.actions.declare_file(ctx.attr.name + "_linked.wasm")
+        if not ctx.attr.threads:
+            link_args.add("-Wl,--skip-wit-component")
+
+    link_args.add("-o", linked_wasm.path)
 
     ctx.actions.run(
         executable = clang,
-        arguments = [compile_args],
-        inputs = [work_dir, bindings_dir, binding_obj_file] + sysroot_files.files.to_list() + dep_libraries + dep_headers + external_headers,
-        outputs = [wasm_binary],
-        mnemonic = "Compile" + ("C" if ctx.attr.language == "c" else "Cpp") + "Wasm",
-        progress_message = "Compiling %s to WASM for %s" % (ctx.attr.language.upper(), ctx.label),
+        arguments = [link_args],
+        inputs = [bindings_dir] + link_objects + sysroot_files.files.to_list() + dep_libraries + pgo_inputs(ctx),
+        outputs = [linked_wasm],
+        mnemonic = "Link" + ("C" if ctx.attr.language == "c" else "Cpp") + "Wasm",
+        progress_message = "Linking %s WASM for %s" % (ctx.attr.language.upper(), ctx.label),
     )
 
+    if ctx.attr.wasm_opt:
+        _run_wasm_opt(ctx, wasm_tools, linked_wasm, wasm_binary)
     # Embed WIT metadata and create component in one step
     embed_args = ctx.actions.args()
     embed_args.add("component")
     embed_args.add("embed")
     embed_args.add(wit_file.path)
     embed_args.add(wasm_binary.path)
-    embed_args.add("--output", component_wasm.path)
+    # With wizer_init the embedded component is only an intermediate
+    uninitialized_wasm = component_wasm
+    if ctx.attr.wizer_init:
+        uninitialized_wasm = ctx.actions.declare_file(ctx.attr.name + "_uninitialized.wasm")
+    embed_args.add("--output", uninitialized_wasm.path)
 
     if ctx.attr.world:
         embed_args.add("--world", ctx.attr.world)
@@ -468,11 +753,37 @@ def _cpp_component_impl(ctx):
         executable = wasm_tools,
         arguments = [embed_args],
         inputs = [wasm_binary, wit_file],
-        outputs = [component_wasm],
+        outputs = [uninitialized_wasm],
         mnemonic = "Create" + ("C" if ctx.attr.language == "c" else "Cpp") + "Component",
         progress_message = "Creating %s WebAssembly component for %s" % (ctx.attr.language.upper(), ctx.label),
     )
 
+    # Run wizer_init once and snapshot the memory and globals it leaves;
+    # wizer drops the wizer-initialize export from the result
+    wizer_outputs = []
+    if ctx.attr.wizer_init:
+        wasmtime_toolchain = ctx.toolchains["@rules_wasm_component//toolchains:wasmtime_toolchain_type"]
+        if not wasmtime_toolchain:
+            fail("cpp_component wizer_init needs a registered wasmtime toolchain")
+
+        wizer_args = ctx.actions.args()
+        wizer_args.add("wizer")
+        wizer_args.add("--init-func", "wizer-initialize")
+        wizer_args.add("-o", component_wasm.path)
+        wizer_args.add(uninitialized_wasm.path)
+
+        ctx.actions.run(
+            executable = wasmtime_toolchain.wasmtime,
+            arguments = [wizer_args],
+            inputs = [uninitialized_wasm],
+            outputs = [component_wasm],
+            mnemonic = "CppComponentWizer",
+            progress_message = "Pre-initializing %s with wasmtime wizer" % ctx.label,
+            use_default_shell_env = False,
+            env = {"RUST_BACKTRACE": "1"},
+        )
+        wizer_outputs.append(uninitialized_wasm)
+
     # Optional WIT validation
     validation_outputs = []
     if ctx.attr.validate_wit:
@@ -529,6 +840,12 @@ def _cpp_component_impl(ctx):
             "toolchain": "wasi-sdk",
             "cxx_std": ctx.attr.cxx_std if ctx.attr.cxx_std else None,
             "optimization": ctx.attr.optimize,
+            "cabi_arena": ctx.attr.cabi_arena,
+            "threads": ctx.attr.threads,
+            "simd": _simd_level(ctx) or None,
+            "pgo": pgo_mode(ctx),
+            "wizer_init": ctx.attr.wizer_init or None,
+            "wasm_opt": ctx.attr.wasm_opt or None,
         },
     )
 
@@ -539,6 +856,7 @@ def _cpp_component_impl(ctx):
             bindings = depset([bindings_dir]),
             wasm_module = depset([wasm_binary]),
             validation = depset(validation_outputs),
+            uninitialized = depset(wizer_outputs),
         ),
     ]
 
@@ -556,6 +874,7 @@ cpp_component = rule(
             doc = "C/C++ header files",
         ),
         "deps": attr.label_list(
+            cfg = _simd_deps_transition,
             doc = "Dependencies (cc_component_library targets)",
         ),
         "wit": attr.label(
@@ -608,10 +927,59 @@ cpp_component = rule(
         ),
         "validate_wit": attr.bool(**VALIDATE_WIT_ATTR_KWARGS),
         "wasi_version": attr.string(**WASI_VERSION_ATTR_KWARGS),
+        "cabi_arena": attr.bool(
+            default = False,
+            doc = "Serve export arguments from a per-call bump arena (cabi_realloc) reset when each export returns. Sources get WASM_CABI_ARENA and cabi_arena.h; every export must open a CabiArenaScope and must not free its arguments",
+        ),
+        "threads": attr.bool(
+            default = False,
+            doc = "Build against wasi-threads (wasm32-wasip1-threads, -pthread, shared memory) so std::thread and pthreads work. Every cc_component_library dep must also set threads = True; the host must enable wasi-threads (wasmtime -S threads)",
+        ),
+        "max_memory": attr.int(
+            default = 1073741824,
+            doc = "Maximum linear memory in bytes when threads = True; shared memory cannot grow past it",
+        ),
+        "simd": attr.string(
+            default = "",
+            values = _SIMD_VALUES,
+            doc = "SIMD variant: none (baseline wasm), simd128 (-msimd128) or relaxed (-msimd128 -mrelaxed-simd). Applies to every cc_component_library dep through //cpp:simd; empty keeps //cpp:simd and the copts as they are. The host must enable the matching wasm features (wasmtime -W relaxed-simd)",
+        ),
+        "profile": attr.label(
+            allow_single_file = [".profdata"],
+            doc = "Merged LLVM profile (usually a cpp_pgo_profile target) to optimize with via -fprofile-use. Covers this target's own sources; set it on the cc_component_library deps whose code the training run exercised too",
+        ),
+        "wizer_init": attr.string(
+            doc = "C function (extern \"C\" void fn(void) from C++) that wasmtime wizer runs at build time; the component then starts from the memory it leaves, so one-time setup such as lookup tables is paid once per build. It must not rely on host state that differs at run time (clocks, environment, files)",
+        ),
+        "wasm_opt": attr.string(
+            default = "",
+            values = ["", "speed", "size"],
+            doc = "Run Binaryen wasm-opt on the linked module: speed (-O3) or size (-Oz); -O1 -g when optimize = False. Empty skips it. Needs the binaryen toolchain",
+        ),
+        "_pgo_instrument_setting": attr.label(
+            default = "//cpp:pgo_instrument",
+        ),
+        "_simd_setting": attr.label(
+            default = "//cpp:simd",
+        ),
+        "_allowlist_function_transition": attr.label(
+            default = "@bazel_tools//tools/allowlists/function_transition_allowlist",
+        ),
+        "_cabi_arena_src": attr.label(
+            default = "//cpp/runtime:cabi_arena.c",
+            allow_single_file = True,
+        ),
+        "_cabi_arena_hdr": attr.label(
+            default = "//cpp/runtime:cabi_arena.h",
+            allow_single_file = True,
+        ),
     },
     toolchains = [
         "@rules_wasm_component//toolchains:cpp_component_toolchain_type",
         "@rules_wasm_component//toolchains:file_ops_toolchain_type",
+        # Only needed for wizer_init and wasm_opt
+        config_common.toolchain_type("@rules_wasm_component//toolchains:wasmtime_toolchain_type", mandatory = False),
+        config_common.toolchain_type("@rules_wasm_component//toolchains:binaryen_toolchain_type", mandatory = False),
     ],
     doc = """
     Builds a WebAssembly component from C/C++ source code using Preview2.
@@ -633,6 +1001,98 @@ cpp_component = rule(
     """,
 )
 
+def _cpp_component_variants_manifest_impl(ctx):
+    entries = []
+    for variant, target in zip(ctx.attr.variants, ctx.attr.components):
+        # DefaultInfo may also carry a validation log
+        wasm = [f for f in target[DefaultInfo].files.to_list() if f.extension == "wasm"][0]
+        entries.append(struct(
+            variant = variant,
+            component = wasm.short_path,
+            features = _SIMD_FEATURES[variant],
+        ))
+    ctx.actions.write(ctx.outputs.out, json.encode_indent(struct(variants = entries)) + "\n")
+    return [DefaultInfo(files = depset([ctx.outputs.out]))]
+
+_cpp_component_variants_manifest = rule(
+    implementation = _cpp_component_variants_manifest_impl,
+    attrs = {
+        "components": attr.label_list(mandatory = True),
+        "variants": attr.string_list(mandatory = True),
+        "out": attr.output(mandatory = True),
+    },
+)
+
+def cpp_component_variants(
+        name,
+        simd_variants = ["relaxed", "simd128", "none"],
+        default_variant = "simd128",
+        visibility = None,
+        tags = [],
+        **kwargs):
+    """Builds one cpp_component per SIMD variant, plus a manifest for hosts.
+
+    A wasm module cannot detect CPU features at run time: if it contains an
+    instruction the runtime does not support, the whole module fails to
+    validate. So each variant is a separate build, and the host picks one
+    when it loads the component.
+
+    Creates:
+    - <name>_<variant>: a cpp_component with simd = variant. Its
+      cc_component_library deps are compiled once per variant.
+    - <name>: an alias of the default_variant component.
+    - <name>_manifest: <name>_variants.json listing each component and the
+      wasm features it needs, in simd_variants order (most capable first).
+      A host loads the first entry whose features its runtime enables, e.g.
+      with wasmtime -W relaxed-simd.
+    - <name>_all_variants: all components plus the manifest.
+
+    Args:
+        name: Base target name.
+        simd_variants: Variants to build, most capable first.
+        default_variant: Variant the <name> alias points at.
+        visibility: Visibility of the public targets.
+        tags: Tags for every target.
+        **kwargs: cpp_component attributes shared by all variants.
+    """
+    if default_variant not in simd_variants:
+        fail("default_variant {} is not in simd_variants".format(default_variant))
+
+    components = []
+    for variant in simd_variants:
+        component_name = "{}_{}".format(name, variant)
+        cpp_component(
+            name = component_name,
+            simd = variant,
+            visibility = visibility,
+            tags = tags,
+            **kwargs
+        )
+        components.append(":" + component_name)
+
+    native.alias(
+        name = name,
+        actual = ":{}_{}".format(name, default_variant),
+        visibility = visibility,
+        tags = tags,
+    )
+
+    _cpp_component_variants_manifest(
+        name = name + "_manifest",
+        components = components,
+        variants = simd_variants,
+        out = name + "_variants.json",
+        visibility = visibility,
+        tags = tags,
+    )
+
+    native.filegroup(
+        name = name + "_all_variants",
+        srcs = components + [":" + name + "_manifest"],
+        visibility = visibility,
+        tags = tags,
+    )
+
 def _cpp_wit_bindgen_impl(ctx):
     """Implementation of cpp_wit_bindgen rule for standalone WIT binding generation.
 
@@ -770,6 +1230,9 @@ def _cc_component_library_impl(ctx):
             - ctx.attr.cxx_std: C++ standard for compilation
             - ctx.attr.optimize: Enable optimizations
             - ctx.attr.includes: Additional include directories
+            - ctx.attr.threads: Compile for wasi-threads
+            - ctx.attr.simd: SIMD variant, overridden by an enclosing cpp_component's
+            - ctx.file.profile: Merged .profdata for -fprofile-use
 
     Returns:
         List of providers:
@@ -855,7 +1318,8 @@ def _cc_component_library_impl(ctx):
 
         # Compile arguments
         compile_args = ctx.actions.args()
-        compile_args.add("--target=wasm32-wasip2")
+        compile_args.add("--target=" + _wasm_target(ctx))
+        _add_thread_flags(ctx, compile_args)
 
         # Resolve sysroot path dynamically for external repository compatibility
         if sysroot_files and sysroot_files.files:
@@ -876,12 +1340,8 @@ def _cc_component_library_impl(ctx):
         compile_args.add("-DCOMPONENT_MODEL_PREVIEW2")
 
         # Optimization
-        if ctx.attr.optimize:
-            compile_args.add("-O3")
-            compile_args.add("-flto")  # Enable LTO for compatibility with cpp_component
-        else:
-            compile_args.add("-O0")
-            compile_args.add("-g")
+        # Optimization, ThinLTO like cpp_component
+        _add_optimization_flags(ctx, compile_args)
 
         # C++ specific flags (for source compilation)
         if needs_cpp_compilation:
@@ -898,7 +1358,7 @@ def _cc_component_library_impl(ctx):
         # Include directories - CRITICAL FIX: Use workspace directory for proper header staging
         compile_args.add("-I" + work_dir.path)  # Workspace with staged headers
 
-        # Add C++ standard library paths for wasm32-wasip2 target
+        # Add C++ standard library paths for the target
         if needs_cpp_compilation:
             # WASI SDK stores C++ headers in share/wasi-sysroot, not just sysroot
             if "/external/" in sysroot_dir:
@@ -906,7 +1366,7 @@ def _cc_component_library_impl(ctx):
                 wasi_sysroot = toolchain_repo + "/share/wasi-sysroot"
             else:
                 wasi_sysroot = sysroot_dir
-            compile_args.add("-I" + wasi_sysroot + "/include/wasm32-wasip2/c++/v1")
+            compile_args.add("-I" + wasi_sysroot + "/include/" + _wasm_target(ctx) + "/c++/v1")
             compile_args.add("-I" + wasi_sysroot + "/include/c++/v1")
 
             # Also add clang's builtin headers
@@ -942,13 +1402,15 @@ def _cc_component_library_impl(ctx):
         # Compiler options
         for opt in ctx.attr.copts:
             compile_args.add(opt)
+        _add_simd_flags(ctx, compile_args, setting_first = True)
+        add_pgo_flags(ctx, compile_args)
 
         # Output and input - CRITICAL FIX: Use source file from workspace
         compile_args.add("-o", obj_file.path)
         compile_args.add(work_dir.path + "/" + src.basename)
 
         # Add external dependency headers to inputs
-        all_inputs = [work_dir] + sysroot_files.files.to_list()
+        all_inputs = [work_dir] + sysroot_files.files.to_list() + pgo_inputs(ctx)
         for dep in ctx.attr.deps:
             if CcInfo in dep:
                 cc_info = dep[CcInfo]
@@ -1084,6 +1546,25 @@ cc_component_library = rule(
             default = [],
             doc = "Libraries to link. When nostdlib=True, only these libraries are linked. When nostdlib=False, these are added to standard libraries. Examples: ['m', 'dl'] or ['-lm', '-ldl']",
         ),
+        "threads": attr.bool(
+            default = False,
+            doc = "Compile for wasi-threads (wasm32-wasip1-threads, -pthread); must match the cpp_component that links this library",
+        ),
+        "simd": attr.string(
+            default = "",
+            values = _SIMD_VALUES,
+            doc = "SIMD variant when built on its own (none, simd128, relaxed); a cpp_component's simd, or --//cpp:simd, takes precedence",
+        ),
+        "profile": attr.label(
+            allow_single_file = [".profdata"],
+            doc = "Merged LLVM profile (usually a cpp_pgo_profile target) to optimize with via -fprofile-use. Use the profile of the training run that exercised this library, typically the same one as the cpp_component linking it",
+        ),
+        "_pgo_instrument_setting": attr.label(
+            default = "//cpp:pgo_instrument",
+        ),
+        "_simd_setting": attr.label(
+            default = "//cpp:simd",
+        ),
     },
     toolchains = [
         "@rules_wasm_component//toolchains:cpp_component_toolchain_type",
@@ -1110,3 +1591,9 @@ cc_component_library = rule(
 # Re-export binary rules for convenience
 cpp_wasm_binary = _cpp_wasm_binary
 c_wasm_binary = _c_wasm_binary
+
+# Re-export the PGO training rule
+cpp_pgo_profile = _cpp_pgo_profile
+
+# Re-export the benchmark macro
+cpp_wasm_benchmark = _cpp_wasm_benchmark
@@ -0,0 +1,260 @@
+# Copyright 2025 Ralf Anton Beier. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Profile-guided optimization for C/C++ WebAssembly targets.
+
+The workflow has three parts:
+
+1. Instrument: with --//cpp:pgo_instrument every cpp_component,
+   cpp_wasm_binary and cc_component_library compiles and links with
+   -fprofile-generate.
+2. Train: cpp_pgo_profile builds a training cpp_wasm_binary instrumented,
+   runs its workload under wasmtime in a build action, and merges the
+   .profraw it writes into a .profdata with llvm-profdata.
+3. Use: the profile attribute of cpp_component, cc_component_library and
+   cpp_wasm_binary passes the .profdata to -fprofile-use.
+
+The profile is an ordinary build input (an action output, or a .profdata
+checked in after a run on production traffic), so optimized builds stay
+hermetic and cacheable. Profiles match functions by name and control-flow
+hash, so a training binary that links the same cc_component_library code
+profiles those libraries for every component that links them.
+
+The instrumented build needs the LLVM profile runtime for wasm32
+(libclang_rt.profile) in the toolchain's clang resource directory. The
+runtime writes the .profraw when the program exits, so training drives a
+command (cpp_wasm_binary) rather than a reactor component.
+
+Example:
+
+    cc_component_library(
+        name = "request_parser",
+        srcs = ["request_parser.c"],
+        hdrs = ["request_parser.h"],
+        language = "c",
+        profile = ":parser_profile",
+    )
+
+    cpp_wasm_binary(
+        name = "parser_training",
+        srcs = ["parser_training.c"],
+        language = "c",
+        deps = [":request_parser"],
+    )
+
+    cpp_pgo_profile(
+        name = "parser_profile",
+        binary = ":parser_training",
+        args = ["$(location testdata/requests.txt)"],
+        data = ["testdata/requests.txt"],
+    )
+
+The training build of request_parser ignores its profile attribute, and
+cpp_pgo_profile drops its binary in that configuration, so the loop above
+is not a dependency cycle.
+"""
+
+load("@bazel_skylib//rules:common_settings.bzl", "BuildSettingInfo")
+load("//providers:providers.bzl", "WasmComponentInfo")
+
+def pgo_instrumented(ctx):
+    """Whether --//cpp:pgo_instrument asks for an instrumented build."""
+    return ctx.attr._pgo_instrument_setting[BuildSettingInfo].value
+
+def add_pgo_flags(ctx, args):
+    """Adds -fprofile-generate or -fprofile-use; used for compiles and the final link."""
+    if pgo_instrumented(ctx):
+        args.add("-fprofile-generate")
+    elif ctx.file.profile:
+        args.add("-fprofile-use=" + ctx.file.profile.path)
+
+        # Functions the training run never reached are expected
+        args.add("-Wno-profile-instr-unprofiled")
+
+def pgo_inputs(ctx):
+    """The .profdata a compile reads, if any."""
+    if ctx.file.profile and not pgo_instrumented(ctx):
+        return [ctx.file.profile]
+    return []
+
+def pgo_mode(ctx):
+    """PGO state for component metadata."""
+    if pgo_instrumented(ctx):
+        return "instrument"
+    return "profile" if ctx.file.profile else None
+
+def _pgo_instrument_transition_impl(settings, attr):
+    return {"//cpp:pgo_instrument": True}
+
+_pgo_instrument_transition = transition(
+    implementation = _pgo_instrument_transition_impl,
+    inputs = [],
+    outputs = ["//cpp:pgo_instrument"],
+)
+
+def _cpp_pgo_profile_impl(ctx):
+    """Runs an instrumented training binary and merges its profile.
+
+    Args:
+        ctx: The rule context containing:
+            - ctx.attr.binary: Training cpp_wasm_binary, built instrumented
+            - ctx.attr.args: Workload arguments, with $(location) expansion
+            - ctx.files.data: Files the workload reads
+
+    Returns:
+        List of providers:
+        - DefaultInfo: The merged .profdata
+        - OutputGroupInfo: profraw directory from the training run
+    """
+    profdata = ctx.actions.declare_file(ctx.label.name + ".profdata")
+
+    # Seen from an instrumented build, which never reads the profile
+    if not ctx.attr.binary:
+        ctx.actions.write(profdata, "")
+        return [DefaultInfo(files = depset([profdata]))]
+
+    cpp_toolchain = ctx.toolchains["@rules_wasm_component//toolchains:cpp_component_toolchain_type"]
+    wasmtime = ctx.toolchains["@rules_wasm_component//toolchains:wasmtime_toolchain_type"].wasmtime
+    llvm_profdata = cpp_toolchain.llvm_profdata
+    if not llvm_profdata:
+        fail("cpp_pgo_profile needs llvm-profdata, which the C/C++ toolchain does not provide")
+
+    binary = ctx.attr.binary[0]
+    component_info = binary[WasmComponentInfo]
+    if component_info.metadata.get("pgo") != "instrument":
+        fail("cpp_pgo_profile: {} was not built with -fprofile-generate".format(ctx.attr.binary[0].label))
+
+    profraw_dir = ctx.actions.declare_directory(ctx.label.name + "_profraw")
+
+    # Train: the profile runtime writes LLVM_PROFILE_FILE at exit, through
+    # the preopened execroot
+    train_args = ctx.actions.args()
+    train_args.add(wasmtime)
+    train_args.add(component_info.wasm_file)
+    train_args.add(profraw_dir.path)
+    train_args.add_all([ctx.expand_location(arg, ctx.attr.data) for arg in ctx.attr.args])
+
+    ctx.actions.run_shell(
+        command = '''
+        set -e
+        wasmtime="$1"
+        module="$2"
+        profraw_dir="$3"
+        shift 3
+        mkdir -p "$profraw_dir"
+        "$wasmtime" run --dir . --env "LLVM_PROFILE_FILE=$profraw_dir/training.profraw" "$module" "$@"
+        if [ ! -s "$profraw_dir/training.profraw" ]; then
+            echo "ERROR: training run of $module wrote no profile" >&2
+            exit 1
+        fi
+        ''',
+        arguments = [train_args],
+        inputs = [component_info.wasm_file] + ctx.files.data,
+        outputs = [profraw_dir],
+        tools = [wasmtime],
+        mnemonic = "CppPgoTrain",
+        progress_message = "Running PGO training workload for %s" % ctx.label,
+    )
+
+    merge_args = ctx.actions.args()
+    merge_args.add("merge")
+    merge_args.add("-o", profdata)
+    merge_args.add_all([profraw_dir])
+
+    ctx.actions.run(
+        executable = llvm_profdata,
+        arguments = [merge_args],
+        inputs = [profraw_dir],
+        outputs = [profdata],
+        mnemonic = "CppPgoMerge",
+        progress_message = "Merging PGO profile for %s" % ctx.label,
+    )
+
+    return [
+        DefaultInfo(files = depset([profdata])),
+        OutputGroupInfo(
+            profraw = depset([profraw_dir]),
+        ),
+    ]
+
+_cpp_pgo_profile = rule(
+    implementation = _cpp_pgo_profile_impl,
+    attrs = {
+        "binary": attr.label(
+            cfg = _pgo_instrument_transition,
+            providers = [WasmComponentInfo],
+            doc = "Training cpp_wasm_binary; built with --//cpp:pgo_instrument, along with its deps",
+        ),
+        "args": attr.string_list(
+            doc = "Arguments for the training run; $(location) expands labels in data",
+        ),
+        "data": attr.label_list(
+            allow_files = True,
+            doc = "Inputs the training workload reads, visible under the execroot",
+        ),
+        "_allowlist_function_transition": attr.label(
+            default = "@bazel_tools//tools/allowlists/function_transition_allowlist",
+        ),
+    },
+    toolchains = [
+        "@rules_wasm_component//toolchains:cpp_component_toolchain_type",
+        "@rules_wasm_component//toolchains:wasmtime_toolchain_type",
+    ],
+    doc = "Runs an instrumented training binary and merges its profile; use cpp_pgo_profile.",
+)
+
+def cpp_pgo_profile(name, binary, args = [], data = [], **kwargs):
+    """Produces a .profdata for -fprofile-use by running a training workload.
+
+    Builds binary instrumented, runs it under wasmtime with args in a build
+    action, and merges the profile it writes with llvm-profdata. The result
+    is cached like any other action output and rebuilt only when the
+    training binary, its arguments or its data change.
+
+    In an instrumented configuration the target yields an empty placeholder
+    and does not depend on binary; that is what lets the libraries the
+    training binary links point their profile attribute back at it.
+
+    Example:
+        cpp_pgo_profile(
+            name = "hash_table_profile",
+            binary = ":hash_table_training",
+            args = ["--operations", "1000000"],
+        )
+
+        cc_component_library(
+            name = "hash_table",
+            srcs = ["hash_table.cpp"],
+            hdrs = ["hash_table.h"],
+            profile = ":hash_table_profile",
+        )
+
+    Args:
+        name: Target name; the profile is <name>.profdata.
+        binary: Training cpp_wasm_binary; it and its deps are built with
+            --//cpp:pgo_instrument.
+        args: Arguments for the training run; $(location) expands labels in data.
+        data: Inputs the training workload reads, visible under the execroot.
+        **kwargs: Common attributes (visibility, tags, ...).
+    """
+    _cpp_pgo_profile(
+        name = name,
+        binary = select({
+            Label("//cpp:pgo_instrument_enabled"): None,
+            "//conditions:default": binary,
+        }),
+        args = args,
+        data = data,
+        **kwargs
+    )
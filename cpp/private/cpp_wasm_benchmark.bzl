@@ -0,0 +1,251 @@
+# Copyright 2025 Ralf Anton Beier. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#    http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Benchmarks for C/C++ WebAssembly code, run AOT-compiled under wasmtime.
+
+cpp_wasm_benchmark builds a harness (sources using
+//cpp/runtime:wasm_benchmark.h) against the cc_component_library targets a
+cpp_component links, precompiles it with wasm_precompile, and runs it in a
+build action. The result is <name>.json with ns/op, throughput and
+allocations per benchmark.
+
+With baseline set, the run compares against a JSON kept in the tree and
+fails when a benchmark is more than threshold_percent slower. Refresh the
+baseline by copying a fresh <name>.json over it.
+
+Timings are only comparable on the same machine, so the run never comes
+from or goes to a remote cache. Build benchmarks on a quiet machine, one
+at a time (--jobs=1), and pin them to a core with cpu.
+"""
+
+load("//providers:providers.bzl", "WasmPrecompiledInfo")
+load("//wasm/private:wasm_precompile.bzl", "wasm_precompile")
+load(":cpp_wasm_binary.bzl", "cpp_wasm_binary")
+
+def _cpp_wasm_benchmark_run_impl(ctx):
+    """Runs a precompiled benchmark harness and collects its JSON.
+
+    Args:
+        ctx: The rule context containing:
+            - ctx.attr.precompiled: wasm_precompile target of the harness
+            - ctx.attr.warmup, repetitions, min_time_ms, filter: Harness settings
+            - ctx.attr.cpu: CPU list for taskset, empty to run unpinned
+            - ctx.file.baseline: Earlier <name>.json to compare against
+            - ctx.attr.threshold_percent: Allowed slowdown against the baseline
+
+    Returns:
+        List of providers:
+        - DefaultInfo: The results JSON
+        - OutputGroupInfo: log with the harness's report
+    """
+    wasmtime = ctx.toolchains["@rules_wasm_component//toolchains:wasmtime_toolchain_type"].wasmtime
+    cwasm = ctx.attr.precompiled[WasmPrecompiledInfo].cwasm_file
+
+    results = ctx.actions.declare_file(ctx.label.name + ".json")
+    log = ctx.actions.declare_file(ctx.label.name + ".log")
+
+    harness_args = [
+        "--warmup={}".format(ctx.attr.warmup),
+        "--repetitions={}".format(ctx.attr.repetitions),
+        "--min_time_ms={}".format(ctx.attr.min_time_ms),
+        "--output=" + results.path,
+    ]
+    if ctx.attr.filter:
+        harness_args.append("--filter=" + ctx.attr.filter)
+
+    inputs = [cwasm]
+    if ctx.file.baseline:
+        harness_args.append("--baseline=" + ctx.file.baseline.path)
+        harness_args.append("--threshold_percent={}".format(ctx.attr.threshold_percent))
+        inputs.append(ctx.file.baseline)
+
+    args = ctx.actions.args()
+    args.add(wasmtime)
+    args.add(cwasm)
+    args.add(log)
+    args.add(ctx.attr.cpu)
+    args.add_all(harness_args)
+
+    ctx.actions.run_shell(
+        command = '''
+        wasmtime="$1"
+        cwasm="$2"
+        log="$3"
+        cpu="$4"
+        shift 4
+
+        pin=""
+        if [ -n "$cpu" ]; then
+            if command -v taskset >/dev/null 2>&1; then
+                pin="taskset -c $cpu"
+            else
+                echo "WARNING: taskset not found, running unpinned" >&2
+            fi
+        fi
+
+        # The harness writes its JSON through the preopened execroot
+        status=0
+        $pin "$wasmtime" run --allow-precompiled --dir . "$cwasm" "$@" 2>"$log" || status=$?
+        cat "$log" >&2
+        exit $status
+        ''',
+        arguments = [args],
+        inputs = inputs,
+        outputs = [results, log],
+        tools = [wasmtime],
+        mnemonic = "CppWasmBenchmark",
+        progress_message = "Benchmarking %s" % ctx.label,
+        # Timings belong to the machine that measured them
+        execution_requirements = {
+            "no-cache": "1",
+            "no-remote": "1",
+        },
+    )
+
+    return [
+        DefaultInfo(files = depset([results])),
+        OutputGroupInfo(
+            log = depset([log]),
+        ),
+    ]
+
+_cpp_wasm_benchmark_run = rule(
+    implementation = _cpp_wasm_benchmark_run_impl,
+    attrs = {
+        "precompiled": attr.label(
+            mandatory = True,
+            providers = [WasmPrecompiledInfo],
+            doc = "wasm_precompile target of the benchmark harness",
+        ),
+        "warmup": attr.int(
+            default = 3,
+            doc = "Untimed repetitions before measuring",
+        ),
+        "repetitions": attr.int(
+            default = 10,
+            doc = "Timed repetitions; the reported ns/op is their median",
+        ),
+        "min_time_ms": attr.int(
+            default = 100,
+            doc = "Minimum length of one repetition; sets the iteration count",
+        ),
+        "filter": attr.string(
+            doc = "Only run benchmarks whose name contains this",
+        ),
+        "cpu": attr.string(
+            doc = "CPU list for taskset -c (e.g. \"2\"); empty runs unpinned",
+        ),
+        "baseline": attr.label(
+            allow_single_file = [".json"],
+            doc = "Results of an earlier run to compare against",
+        ),
+        "threshold_percent": attr.int(
+            default = 5,
+            doc = "Slowdown against baseline, in percent, that fails the build",
+        ),
+    },
+    toolchains = ["@rules_wasm_component//toolchains:wasmtime_toolchain_type"],
+    doc = "Runs a precompiled benchmark harness; use cpp_wasm_benchmark.",
+)
+
+def cpp_wasm_benchmark(
+        name,
+        srcs,
+        hdrs = [],
+        deps = [],
+        copts = [],
+        defines = [],
+        cxx_std = "c++17",
+        optimization_level = "2",
+        warmup = 3,
+        repetitions = 10,
+        min_time_ms = 100,
+        filter = "",
+        cpu = "",
+        baseline = None,
+        threshold_percent = 5,
+        visibility = None,
+        **kwargs):
+    """Benchmarks C/C++ WebAssembly code AOT-compiled under wasmtime.
+
+    A component's exports can only be driven by a host, so the harness
+    links the cc_component_library targets behind the component directly.
+    It is a command binary (<name>_harness) whose sources register
+    benchmarks with WASM_BENCHMARK and end with WASM_BENCHMARK_MAIN();
+    <name>_cwasm precompiles it, and <name> runs it.
+
+    Example:
+        cpp_wasm_benchmark(
+            name = "hash_table_benchmark",
+            srcs = ["test/hash_table_benchmark.cpp"],
+            deps = [":hash_table"],
+            baseline = "test/hash_table_benchmark.baseline.json",
+            cpu = "2",
+        )
+
+    Args:
+        name: Target name; results are <name>.json.
+        srcs: Harness sources.
+        hdrs: Harness headers.
+        deps: cc_component_library targets under test.
+        copts: Additional compiler options for the harness.
+        defines: Preprocessor definitions for the harness.
+        cxx_std: C++ standard of the harness.
+        optimization_level: wasmtime compile opt-level (0, 1, 2 or s).
+        warmup: Untimed repetitions before measuring.
+        repetitions: Timed repetitions; ns/op is their median.
+        min_time_ms: Minimum length of one repetition.
+        filter: Only run benchmarks whose name contains this.
+        cpu: CPU list for taskset -c; empty runs unpinned.
+        baseline: Earlier results JSON; the build fails on regressions.
+        threshold_percent: Allowed slowdown against baseline.
+        visibility: Visibility of <name>.
+        **kwargs: Common attributes (tags, target_compatible_with, ...) for
+            every generated target.
+    """
+    cpp_wasm_binary(
+        name = name + "_harness",
+        srcs = srcs,
+        hdrs = hdrs,
+        deps = deps + [Label("//cpp/runtime:wasm_benchmark")],
+        copts = copts,
+        defines = defines,
+        cxx_std = cxx_std,
+        language = "cpp",
+        optimize = True,
+        visibility = ["//visibility:private"],
+        **kwargs
+    )
+
+    wasm_precompile(
+        name = name + "_cwasm",
+        component = ":" + name + "_harness",
+        optimization_level = optimization_level,
+        visibility = ["//visibility:private"],
+        **kwargs
+    )
+
+    _cpp_wasm_benchmark_run(
+        name = name,
+        precompiled = ":" + name + "_cwasm",
+        warmup = warmup,
+        repetitions = repetitions,
+        min_time_ms = min_time_ms,
+        filter = filter,
+        cpu = cpu,
+        baseline = baseline,
+        threshold_percent = threshold_percent,
+        visibility = visibility,
+        **kwargs
+    )
@@ -31,6 +31,7 @@ Example usage:
 
 load("@rules_cc//cc/common:cc_info.bzl", "CcInfo")
 load("//providers:providers.bzl", "WasmComponentInfo")
+load(":cpp_pgo.bzl", "add_pgo_flags", "pgo_inputs", "pgo_mode")
 load("//rust:transitions.bzl", "wasm_transition")
 load("//tools/bazel_helpers:file_ops_actions.bzl", "setup_cpp_workspace_action")
 
@@ -48,6 +49,7 @@ def _cpp_wasm_binary_impl(ctx):
             - ctx.attr.language: Either "c" or "cpp"
             - ctx.attr.cxx_std: C++ standard (c++17/20/23)
             - ctx.attr.optimize: Enable optimizations
+            - ctx.file.profile: Merged .profdata for -fprofile-use
 
     Returns:
         List of providers:
@@ -134,7 +136,7 @@ def _cpp_wasm_binary_impl(ctx):
     # Optimization settings
     if ctx.attr.optimize:
         compile_args.add("-O3")
-        compile_args.add("-flto")
+        compile_args.add("-flto=thin")  # Matches the ThinLTO bitcode of cc_component_library deps
     else:
         compile_args.add("-O0")
         compile_args.add("-g")
@@ -190,6 +192,8 @@ def _cpp_wasm_binary_impl(ctx):
     for flag in ctx.attr.copts:
         compile_args.add(flag)
 
+    add_pgo_flags(ctx, compile_args)
+
     # Output
     compile_args.add("-o", wasm_binary.path)
 
@@ -222,7 +226,7 @@ def _cpp_wasm_binary_impl(ctx):
     ctx.actions.run(
         executable = clang,
         arguments = [compile_args],
-        inputs = [work_dir] + sysroot_files.files.to_list() + dep_libraries + dep_headers + external_headers,
+        inputs = [work_dir] + sysroot_files.files.to_list() + dep_libraries + dep_headers + external_headers + pgo_inputs(ctx),
         outputs = [wasm_binary],
         mnemonic = "Compile" + ("C" if ctx.attr.language == "c" else "Cpp") + "WasmBinary",
         progress_message = "Compiling %s to WASM binary for %s" % (ctx.attr.language.upper(), ctx.label),
@@ -244,6 +248,7 @@ def _cpp_wasm_binary_impl(ctx):
             "toolchain": "wasi-sdk",
             "cxx_std": ctx.attr.cxx_std if ctx.attr.cxx_std else None,
             "optimization": ctx.attr.optimize,
+            "pgo": pgo_mode(ctx),
         },
         profile = "release" if ctx.attr.optimize else "debug",
         profile_variants = {},
@@ -307,6 +312,13 @@ cpp_wasm_binary = rule(
             default = [],
             doc = "Additional libraries to link",
         ),
+        "profile": attr.label(
+            allow_single_file = [".profdata"],
+            doc = "Merged LLVM profile (usually a cpp_pgo_profile target) to optimize with via -fprofile-use",
+        ),
+        "_pgo_instrument_setting": attr.label(
+            default = "//cpp:pgo_instrument",
+        ),
     },
     toolchains = [
         "@rules_wasm_component//toolchains:cpp_component_toolchain_type",
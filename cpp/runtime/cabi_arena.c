@@ -0,0 +1,170 @@
+#include "cabi_arena.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CABI_ARENA_CHUNK_SIZE
+#define CABI_ARENA_CHUNK_SIZE (64 * 1024)
+#endif
+
+// A call that needed more than this gives the memory back after it returns
+#ifndef CABI_ARENA_RETAIN_BYTES
+#define CABI_ARENA_RETAIN_BYTES (8 * 1024 * 1024)
+#endif
+
+typedef struct cabi_arena_chunk {
+    struct cabi_arena_chunk* next;  // Older chunks of the same call
+    size_t size;                    // Usable bytes after the header
+    size_t used;
+} cabi_arena_chunk;
+
+static cabi_arena_chunk* arena_head;
+static void* arena_last;       // Most recent allocation, may grow in place
+static size_t arena_in_use;    // Bytes handed out since the last reset
+static size_t arena_high_water;
+static int arena_depth;
+static int arena_armed;        // Set between exports, while arguments are lowered
+
+static uint8_t* chunk_data(cabi_arena_chunk* chunk) {
+    return (uint8_t*)(chunk + 1);
+}
+
+static void* arena_alloc(size_t size, size_t align) {
+    cabi_arena_chunk* chunk = arena_head;
+    if (chunk) {
+        uintptr_t base = (uintptr_t)chunk_data(chunk);
+        uintptr_t at = (base + chunk->used + align - 1) & ~(uintptr_t)(align - 1);
+        if (at - base <= chunk->size && size <= chunk->size - (at - base)) {
+            chunk->used = at - base + size;
+            arena_in_use += size;
+            arena_last = (void*)at;
+            return arena_last;
+        }
+    }
+
+    // New chunk, at least double the previous one so a call needs few of them
+    size_t capacity = CABI_ARENA_CHUNK_SIZE;
+    if (chunk && chunk->size < SIZE_MAX / 2) {
+        capacity = chunk->size * 2;
+    }
+    while (capacity < size + align) {
+        if (capacity > SIZE_MAX / 2) {
+            return NULL;
+        }
+        capacity *= 2;
+    }
+
+    cabi_arena_chunk* fresh = (cabi_arena_chunk*)malloc(sizeof(cabi_arena_chunk) + capacity);
+    if (!fresh) {
+        return NULL;
+    }
+    fresh->next = chunk;
+    fresh->size = capacity;
+    fresh->used = 0;
+    arena_head = fresh;
+    return arena_alloc(size, align);
+}
+
+static void arena_reset(void) {
+    if (arena_in_use > arena_high_water) {
+        arena_high_water = arena_in_use;
+    }
+
+    // Fold a multi-chunk call into one chunk so the next call bumps inside it
+    size_t total = 0;
+    for (cabi_arena_chunk* chunk = arena_head; chunk; chunk = chunk->next) {
+        total += chunk->size;
+    }
+    if (arena_head && (arena_head->next || total > CABI_ARENA_RETAIN_BYTES)) {
+        while (arena_head) {
+            cabi_arena_chunk* next = arena_head->next;
+            free(arena_head);
+            arena_head = next;
+        }
+        if (total <= CABI_ARENA_RETAIN_BYTES) {
+            arena_head = (cabi_arena_chunk*)malloc(sizeof(cabi_arena_chunk) + total);
+            if (arena_head) {
+                arena_head->next = NULL;
+                arena_head->size = total;
+            }
+        }
+    }
+
+    if (arena_head) {
+        arena_head->used = 0;
+    }
+    arena_last = NULL;
+    arena_in_use = 0;
+}
+
+void cabi_arena_enter(void) {
+    arena_depth++;
+    arena_armed = 0;
+}
+
+void cabi_arena_leave(void) {
+    if (arena_depth > 0 && --arena_depth == 0) {
+        // This call's arguments are dead; the next call's go in from the start
+        arena_reset();
+        arena_armed = 1;
+    }
+}
+
+int cabi_arena_owns(const void* ptr) {
+    const uint8_t* p = (const uint8_t*)ptr;
+    for (cabi_arena_chunk* chunk = arena_head; chunk; chunk = chunk->next) {
+        if (p >= chunk_data(chunk) && p < chunk_data(chunk) + chunk->size) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+size_t cabi_arena_high_water(void) {
+    return arena_in_use > arena_high_water ? arena_in_use : arena_high_water;
+}
+
+// Strong definition; replaces the weak one emitted by wit-bindgen
+__attribute__((__export_name__("cabi_realloc")))
+void* cabi_realloc(void* ptr, size_t old_size, size_t align, size_t new_size) {
+    if (new_size == 0) {
+        return (void*)align;
+    }
+
+    void* ret;
+    if (!arena_armed) {
+        if (ptr && cabi_arena_owns(ptr)) {
+            ret = malloc(new_size);
+            if (ret) {
+                memcpy(ret, ptr, old_size < new_size ? old_size : new_size);
+            }
+        } else {
+            ret = realloc(ptr, new_size);
+        }
+        if (!ret) {
+            abort();
+        }
+        return ret;
+    }
+
+    // Growing the latest buffer (string transcoding) stays in place if it fits
+    if (ptr && ptr == arena_last) {
+        uint8_t* base = chunk_data(arena_head);
+        size_t offset = (size_t)((uint8_t*)ptr - base);
+        if (new_size <= arena_head->size - offset) {
+            arena_in_use = arena_in_use - old_size + new_size;
+            arena_head->used = offset + new_size;
+            return ptr;
+        }
+    }
+
+    ret = arena_alloc(new_size, align);
+    if (!ret) {
+        abort();
+    }
+    if (ptr) {
+        memcpy(ret, ptr, old_size < new_size ? old_size : new_size);
+    }
+    return ret;
+}
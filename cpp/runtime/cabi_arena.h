@@ -0,0 +1,52 @@
+#ifndef RULES_WASM_COMPONENT_CABI_ARENA_H
+#define RULES_WASM_COMPONENT_CABI_ARENA_H
+
+/*
+ * Per-call arena for canonical ABI allocations (cpp_component cabi_arena = True).
+ *
+ * The host lowers export arguments (lists, strings) through cabi_realloc.
+ * This runtime replaces the bindings' weak malloc-based cabi_realloc with a
+ * bump arena: every argument buffer of one call is a pointer bump, and the
+ * whole arena is reset when the export leaves.
+ *
+ * The arena only serves allocations between an export leaving and the next
+ * one entering, which is exactly when the host lowers arguments. While an
+ * export runs, cabi_realloc falls back to the heap, so import results and
+ * wasi-libc's own allocations can still be released with free().
+ *
+ * Contract for component code:
+ * - every export opens a scope (CabiArenaScope, or enter/leave in C);
+ * - argument buffers must not be freed, and must be copied if they outlive
+ *   the call;
+ * - results must not alias argument buffers (post-return frees them).
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Marks export entry/exit; leaving the outermost scope resets the arena
+void cabi_arena_enter(void);
+void cabi_arena_leave(void);
+
+// True if ptr is an argument buffer of the current call
+int cabi_arena_owns(const void* ptr);
+
+// Largest number of argument bytes any single call has needed
+size_t cabi_arena_high_water(void);
+
+#ifdef __cplusplus
+}
+
+class CabiArenaScope {
+public:
+    CabiArenaScope() { cabi_arena_enter(); }
+    ~CabiArenaScope() { cabi_arena_leave(); }
+    CabiArenaScope(const CabiArenaScope&) = delete;
+    CabiArenaScope& operator=(const CabiArenaScope&) = delete;
+};
+#endif
+
+#endif // RULES_WASM_COMPONENT_CABI_ARENA_H
@@ -0,0 +1,408 @@
+#include "wasm_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace wasm_benchmark {
+
+namespace {
+
+// Upper bound for calibration, so a benchmark the optimizer emptied out
+// still terminates
+constexpr size_t kMaxIterations = size_t(1) << 30;
+
+struct Registration {
+    const char* name;
+    BenchmarkFunction function;
+};
+
+// Function-local so registrations from static initializers find it built
+std::vector<Registration>& registry() {
+    static std::vector<Registration> benchmarks;
+    return benchmarks;
+}
+
+AllocationProbe allocation_probe = nullptr;
+void* allocation_probe_context = nullptr;
+
+uint64_t now_ns() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+struct Options {
+    uint64_t warmup = 3;
+    uint64_t repetitions = 10;
+    uint64_t min_time_ms = 100;
+    const char* filter = nullptr;
+    const char* output = nullptr;
+    const char* baseline = nullptr;
+    double threshold_percent = 5.0;
+};
+
+struct Result {
+    std::string name;
+    size_t iterations = 0;
+    size_t repetitions = 0;
+    double ns_per_op = 0.0;  // Median over the repetitions
+    double ns_per_op_mean = 0.0;
+    double ns_per_op_min = 0.0;
+    double ns_per_op_stddev = 0.0;
+    double bytes_per_second = 0.0;
+    double items_per_second = 0.0;
+    double allocations_per_op = 0.0;
+    double allocated_bytes_per_op = 0.0;
+};
+
+struct BaselineEntry {
+    std::string name;
+    double ns_per_op;
+};
+
+void print_usage() {
+    fprintf(stderr,
+            "usage: <benchmark> [--warmup=N] [--repetitions=N] [--min_time_ms=N] [--filter=TEXT]\n"
+            "                   [--output=FILE] [--baseline=FILE] [--threshold_percent=P]\n");
+}
+
+// Value of --key=value, or nullptr when arg is another flag
+const char* flag_value(const char* arg, const char* key) {
+    size_t length = strlen(key);
+    if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, key, length) != 0 || arg[2 + length] != '=') {
+        return nullptr;
+    }
+    return arg + 3 + length;
+}
+
+bool parse_count(const char* text, uint64_t* out) {
+    char* end = nullptr;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text || *end != '\0') return false;
+    *out = value;
+    return true;
+}
+
+bool parse_options(int argc, char** argv, Options* options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = nullptr;
+        bool ok = true;
+
+        if ((value = flag_value(arg, "warmup"))) {
+            ok = parse_count(value, &options->warmup);
+        } else if ((value = flag_value(arg, "repetitions"))) {
+            ok = parse_count(value, &options->repetitions) && options->repetitions > 0;
+        } else if ((value = flag_value(arg, "min_time_ms"))) {
+            ok = parse_count(value, &options->min_time_ms);
+        } else if ((value = flag_value(arg, "filter"))) {
+            options->filter = value;
+        } else if ((value = flag_value(arg, "output"))) {
+            options->output = value;
+        } else if ((value = flag_value(arg, "baseline"))) {
+            options->baseline = value;
+        } else if ((value = flag_value(arg, "threshold_percent"))) {
+            char* end = nullptr;
+            options->threshold_percent = strtod(value, &end);
+            ok = end != value && *end == '\0' && options->threshold_percent >= 0.0;
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "wasm_benchmark: bad argument %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Nanoseconds one call took, minus the time State::pause_timing excluded
+uint64_t timed_call(BenchmarkFunction function, State& state) {
+    uint64_t start = now_ns();
+    function(state);
+    uint64_t elapsed = now_ns() - start;
+    return elapsed - std::min(elapsed, state.paused_ns());
+}
+
+// Smallest iteration count, growing geometrically, whose run lasts at
+// least min_time_ns
+size_t calibrate(BenchmarkFunction function, uint64_t min_time_ns) {
+    size_t iterations = 1;
+    for (;;) {
+        State state(iterations);
+        uint64_t elapsed = timed_call(function, state);
+        if (elapsed >= min_time_ns || iterations >= kMaxIterations) return iterations;
+
+        // Aim 40% past the target so the next try usually lands; runs too
+        // short to time well grow tenfold
+        double scale = 10.0;
+        if (elapsed * 10 > min_time_ns) {
+            scale = std::min(10.0, 1.4 * static_cast<double>(min_time_ns) / static_cast<double>(elapsed));
+        }
+        size_t next = static_cast<size_t>(static_cast<double>(iterations) * scale);
+        iterations = std::min(kMaxIterations, std::max(iterations + 1, next));
+    }
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    if (values.size() % 2 == 1) return values[middle];
+    return (values[middle - 1] + values[middle]) / 2.0;
+}
+
+Result run_benchmark(const Registration& benchmark, const Options& options) {
+    size_t iterations = calibrate(benchmark.function, options.min_time_ms * 1000000);
+
+    for (uint64_t i = 0; i < options.warmup; ++i) {
+        State state(iterations);
+        timed_call(benchmark.function, state);
+    }
+
+    std::vector<double> ns_per_op;
+    ns_per_op.reserve(options.repetitions);
+    uint64_t allocations = 0;
+    uint64_t allocated_bytes = 0;
+    uint64_t bytes_per_iteration = 0;
+    uint64_t items_per_iteration = 0;
+
+    for (uint64_t i = 0; i < options.repetitions; ++i) {
+        State state(iterations);
+        AllocationCounts before;
+        if (allocation_probe) before = allocation_probe(allocation_probe_context);
+
+        uint64_t elapsed = timed_call(benchmark.function, state);
+
+        if (allocation_probe) {
+            // A probe that went backwards (a pool reset) counts as nothing
+            AllocationCounts after = allocation_probe(allocation_probe_context);
+            allocations += after.allocations > before.allocations ? after.allocations - before.allocations : 0;
+            allocated_bytes += after.bytes > before.bytes ? after.bytes - before.bytes : 0;
+        }
+        ns_per_op.push_back(static_cast<double>(elapsed) / static_cast<double>(iterations));
+        bytes_per_iteration = state.bytes_per_iteration();
+        items_per_iteration = state.items_per_iteration();
+    }
+
+    Result result;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.repetitions = ns_per_op.size();
+    result.ns_per_op = median(ns_per_op);
+    result.ns_per_op_min = *std::min_element(ns_per_op.begin(), ns_per_op.end());
+
+    double sum = 0.0;
+    for (double value : ns_per_op) sum += value;
+    result.ns_per_op_mean = sum / static_cast<double>(ns_per_op.size());
+    if (ns_per_op.size() > 1) {
+        double squares = 0.0;
+        for (double value : ns_per_op) {
+            squares += (value - result.ns_per_op_mean) * (value - result.ns_per_op_mean);
+        }
+        result.ns_per_op_stddev = std::sqrt(squares / static_cast<double>(ns_per_op.size() - 1));
+    }
+
+    if (result.ns_per_op > 0.0) {
+        result.bytes_per_second = static_cast<double>(bytes_per_iteration) * 1e9 / result.ns_per_op;
+        result.items_per_second = static_cast<double>(items_per_iteration) * 1e9 / result.ns_per_op;
+    }
+
+    double total_ops = static_cast<double>(iterations) * static_cast<double>(result.repetitions);
+    result.allocations_per_op = static_cast<double>(allocations) / total_ops;
+    result.allocated_bytes_per_op = static_cast<double>(allocated_bytes) / total_ops;
+    return result;
+}
+
+void write_json_string(FILE* out, const std::string& text) {
+    fputc('"', out);
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            fprintf(out, "\\u%04x", static_cast<unsigned>(c));
+        } else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+void write_json(FILE* out, const Options& options, const std::vector<Result>& results) {
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"warmup\": %llu,\n", static_cast<unsigned long long>(options.warmup));
+    fprintf(out, "    \"repetitions\": %llu,\n", static_cast<unsigned long long>(options.repetitions));
+    fprintf(out, "    \"min_time_ms\": %llu,\n", static_cast<unsigned long long>(options.min_time_ms));
+    fprintf(out, "    \"allocation_probe\": %s\n", allocation_probe ? "true" : "false");
+    fprintf(out, "  },\n  \"benchmarks\": [");
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        fprintf(out, "%s\n    {\n      \"name\": ", i ? "," : "");
+        write_json_string(out, result.name);
+        fprintf(out, ",\n      \"ns_per_op\": %.4f,\n", result.ns_per_op);
+        fprintf(out, "      \"ns_per_op_mean\": %.4f,\n", result.ns_per_op_mean);
+        fprintf(out, "      \"ns_per_op_min\": %.4f,\n", result.ns_per_op_min);
+        fprintf(out, "      \"ns_per_op_stddev\": %.4f,\n", result.ns_per_op_stddev);
+        fprintf(out, "      \"iterations\": %zu,\n", result.iterations);
+        fprintf(out, "      \"repetitions\": %zu,\n", result.repetitions);
+        fprintf(out, "      \"bytes_per_second\": %.0f,\n", result.bytes_per_second);
+        fprintf(out, "      \"items_per_second\": %.0f,\n", result.items_per_second);
+        fprintf(out, "      \"allocations_per_op\": %.4f,\n", result.allocations_per_op);
+        fprintf(out, "      \"allocated_bytes_per_op\": %.4f\n    }", result.allocated_bytes_per_op);
+    }
+    fprintf(out, "%s]\n}\n", results.empty() ? "" : "\n  ");
+}
+
+bool read_file(const char* path, std::string* contents) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+    char buffer[4096];
+    size_t read = 0;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents->append(buffer, read);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+// Reads the name and ns_per_op of every benchmark in a JSON this harness
+// wrote; anything else in the file is skipped
+bool load_baseline(const char* path, std::vector<BaselineEntry>* entries) {
+    std::string text;
+    if (!read_file(path, &text)) return false;
+
+    static const char kNameKey[] = "\"name\"";
+    static const char kNsKey[] = "\"ns_per_op\"";
+    size_t pos = text.find(kNameKey);
+    while (pos != std::string::npos) {
+        size_t next = text.find(kNameKey, pos + 1);
+        size_t colon = text.find(':', pos + strlen(kNameKey));
+        size_t quote = colon == std::string::npos ? colon : text.find('"', colon);
+        if (quote == std::string::npos || quote > next) {
+            pos = next;
+            continue;
+        }
+
+        BaselineEntry entry;
+        size_t i = quote + 1;
+        for (; i < text.size() && text[i] != '"'; ++i) {
+            if (text[i] == '\\' && i + 1 < text.size()) ++i;
+            entry.name += text[i];
+        }
+
+        size_t ns = text.find(kNsKey, i);
+        if (ns != std::string::npos && ns < next) {
+            size_t value = text.find(':', ns + strlen(kNsKey));
+            if (value != std::string::npos) {
+                const char* start = text.c_str() + value + 1;
+                char* end = nullptr;
+                entry.ns_per_op = strtod(start, &end);
+                if (end != start) entries->push_back(entry);
+            }
+        }
+        pos = next;
+    }
+    return true;
+}
+
+// Prints the comparison and returns the number of regressions
+size_t compare_to_baseline(const std::vector<Result>& results, const std::vector<BaselineEntry>& baseline,
+                           const Options& options) {
+    size_t regressions = 0;
+    fprintf(stderr, "\nComparison against %s (threshold %.1f%%)\n", options.baseline, options.threshold_percent);
+    fprintf(stderr, "%-40s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+
+    for (const Result& result : results) {
+        const BaselineEntry* match = nullptr;
+        for (const BaselineEntry& entry : baseline) {
+            if (entry.name == result.name) {
+                match = &entry;
+                break;
+            }
+        }
+        if (!match || match->ns_per_op <= 0.0) {
+            fprintf(stderr, "%-40s %14s %14.2f %9s\n", result.name.c_str(), "-", result.ns_per_op, "new");
+            continue;
+        }
+
+        double change = (result.ns_per_op / match->ns_per_op - 1.0) * 100.0;
+        bool regressed = change > options.threshold_percent;
+        if (regressed) ++regressions;
+        fprintf(stderr, "%-40s %14.2f %14.2f %+8.1f%%%s\n", result.name.c_str(), match->ns_per_op,
+                result.ns_per_op, change, regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+} // namespace
+
+void State::pause_timing() {
+    pause_start_ns_ = now_ns();
+}
+
+void State::resume_timing() {
+    paused_ns_ += now_ns() - pause_start_ns_;
+}
+
+bool register_benchmark(const char* name, BenchmarkFunction function) {
+    registry().push_back({name, function});
+    return true;
+}
+
+void set_allocation_probe(AllocationProbe probe, void* context) {
+    allocation_probe = probe;
+    allocation_probe_context = context;
+}
+
+int run(int argc, char** argv) {
+    Options options;
+    if (!parse_options(argc, argv, &options)) {
+        print_usage();
+        return 2;
+    }
+
+    std::vector<BaselineEntry> baseline;
+    if (options.baseline && !load_baseline(options.baseline, &baseline)) {
+        fprintf(stderr, "wasm_benchmark: cannot read baseline %s\n", options.baseline);
+        return 2;
+    }
+
+    std::vector<Result> results;
+    for (const Registration& benchmark : registry()) {
+        if (options.filter && !strstr(benchmark.name, options.filter)) continue;
+
+        results.push_back(run_benchmark(benchmark, options));
+        const Result& result = results.back();
+        fprintf(stderr, "%-40s %12.2f ns/op  (%zu iterations x %zu)\n", result.name.c_str(), result.ns_per_op,
+                result.iterations, result.repetitions);
+    }
+
+    if (results.empty()) {
+        fprintf(stderr, "wasm_benchmark: no benchmarks to run\n");
+        return 1;
+    }
+
+    FILE* out = options.output ? fopen(options.output, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "wasm_benchmark: cannot write %s\n", options.output);
+        return 1;
+    }
+    write_json(out, options, results);
+    if (out != stdout) fclose(out);
+
+    if (options.baseline && compare_to_baseline(results, baseline, options) > 0) {
+        fprintf(stderr, "wasm_benchmark: regressions past %.1f%%\n", options.threshold_percent);
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace wasm_benchmark
@@ -0,0 +1,99 @@
+#ifndef RULES_WASM_COMPONENT_WASM_BENCHMARK_H
+#define RULES_WASM_COMPONENT_WASM_BENCHMARK_H
+
+/*
+ * Benchmark harness for cpp_wasm_benchmark.
+ *
+ * A harness registers functions with WASM_BENCHMARK and ends with
+ * WASM_BENCHMARK_MAIN(). Each function loops state.iterations() times over
+ * the operation under test; the harness picks the iteration count so one
+ * repetition runs for at least --min_time_ms, runs --warmup untimed
+ * repetitions, then times --repetitions of them and reports the median.
+ *
+ *     void hash_lookup(wasm_benchmark::State& state) {
+ *         Table table = make_table();
+ *         for (size_t i = 0; i < state.iterations(); ++i) {
+ *             wasm_benchmark::do_not_optimize(table.get(i));
+ *         }
+ *         state.set_items_per_iteration(1);
+ *     }
+ *     WASM_BENCHMARK(hash_lookup);
+ *
+ *     WASM_BENCHMARK_MAIN()
+ *
+ * Results are written as JSON to --output (stdout by default). With
+ * --baseline the run compares each benchmark's median against a JSON from
+ * an earlier run and exits 1 when one is more than --threshold_percent
+ * slower.
+ *
+ * The harness only sees allocations through a probe: set_allocation_probe
+ * takes a function returning cumulative counts (MemoryPool::get_stats for
+ * pool-backed code) that is read around every timed repetition.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace wasm_benchmark {
+
+// Cumulative allocation counters; the harness reports their growth per op
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+using AllocationProbe = AllocationCounts (*)(void* context);
+
+class State {
+public:
+    explicit State(size_t iterations) : iterations_(iterations) {}
+
+    size_t iterations() const { return iterations_; }
+
+    // Throughput: bytes or items one iteration processes
+    void set_bytes_per_iteration(uint64_t bytes) { bytes_per_iteration_ = bytes; }
+    void set_items_per_iteration(uint64_t items) { items_per_iteration_ = items; }
+
+    // Exclude setup inside the loop from the timing
+    void pause_timing();
+    void resume_timing();
+
+    uint64_t bytes_per_iteration() const { return bytes_per_iteration_; }
+    uint64_t items_per_iteration() const { return items_per_iteration_; }
+    uint64_t paused_ns() const { return paused_ns_; }
+
+private:
+    size_t iterations_;
+    uint64_t bytes_per_iteration_ = 0;
+    uint64_t items_per_iteration_ = 0;
+    uint64_t paused_ns_ = 0;
+    uint64_t pause_start_ns_ = 0;
+};
+
+using BenchmarkFunction = void (*)(State& state);
+
+// Registers a benchmark under name; WASM_BENCHMARK calls it at static init
+bool register_benchmark(const char* name, BenchmarkFunction function);
+
+// Allocation counters to diff around each timed repetition
+void set_allocation_probe(AllocationProbe probe, void* context = nullptr);
+
+// Runs the registered benchmarks as argv asks; returns the exit status
+int run(int argc, char** argv);
+
+// Keeps value, and the work that produced it, from being optimized away
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+} // namespace wasm_benchmark
+
+#define WASM_BENCHMARK(function) \
+    static const bool wasm_benchmark_registered_##function = \
+        ::wasm_benchmark::register_benchmark(#function, function)
+
+#define WASM_BENCHMARK_MAIN() \
+    int main(int argc, char** argv) { return ::wasm_benchmark::run(argc, argv); }
+
+#endif // RULES_WASM_COMPONENT_WASM_BENCHMARK_H
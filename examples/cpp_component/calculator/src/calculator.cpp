@@ -1,5 +1,8 @@
 #include "calculator_impl.h"
+#include "columnar_batch.h"
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 #include <algorithm>
 
@@ -110,6 +113,59 @@ std::vector<Calculator::CalculationResult> Calculator::calculate_batch(
     return results;
 }
 
+// Columnar batch operations
+std::optional<size_t> Calculator::calculate_columnar_into(OperationType op,
+                                                          std::span<const double> a,
+                                                          std::span<const double> b,
+                                                          double* values,
+                                                          uint64_t* error_mask) const {
+    bool unary = op == OperationType::Sqrt || op == OperationType::Factorial;
+    if (!unary && a.size() != b.size()) {
+        return std::nullopt;
+    }
+    if (a.empty()) {
+        return 0;
+    }
+
+    switch (op) {
+        case OperationType::Add:
+            return columnar_arith(COLUMNAR_ADD, a.data(), b.data(), a.size(), values, error_mask);
+        case OperationType::Subtract:
+            return columnar_arith(COLUMNAR_SUBTRACT, a.data(), b.data(), a.size(), values, error_mask);
+        case OperationType::Multiply:
+            return columnar_arith(COLUMNAR_MULTIPLY, a.data(), b.data(), a.size(), values, error_mask);
+        case OperationType::Divide:
+            return columnar_arith(COLUMNAR_DIVIDE, a.data(), b.data(), a.size(), values, error_mask);
+        case OperationType::Power:
+            return columnar_power(a.data(), b.data(), a.size(), values, error_mask);
+        case OperationType::Sqrt:
+            return columnar_sqrt(a.data(), a.size(), values, error_mask);
+        case OperationType::Factorial:
+            return columnar_factorial(a.data(), a.size(), values, error_mask);
+        default:
+            return std::nullopt;
+    }
+}
+
+Calculator::ColumnarResult Calculator::calculate_batch_columnar(OperationType op,
+                                                                std::span<const double> a,
+                                                                std::span<const double> b) const {
+    ColumnarResult result;
+    result.values.resize(a.size());
+    result.error_mask.resize(COLUMNAR_MASK_WORDS(a.size()));
+
+    auto failed = calculate_columnar_into(op, a, b, result.values.data(), result.error_mask.data());
+    if (!failed.has_value()) {
+        result.success = false;
+        result.error = "Binary operation requires operand columns of equal length";
+        result.values.clear();
+        result.error_mask.clear();
+        return result;
+    }
+    result.error_count = failed.value();
+    return result;
+}
+
 // Component metadata - simplified
 Calculator::ComponentInfo Calculator::get_calculator_info() const {
     return ComponentInfo{
@@ -323,6 +379,73 @@ void exports_example_calculator_calc_calculate_batch(exports_example_calculator_
     }
 }
 
+void exports_example_calculator_calc_calculate_batch_columnar(exports_example_calculator_calc_operation_type_t *op,
+                                                              calculator_list_f64_t *a,
+                                                              calculator_list_f64_t *b,
+                                                              exports_example_calculator_calc_columnar_result_t *ret) {
+    memset(ret, 0, sizeof(*ret));
+
+    calculator::Calculator::OperationType cpp_op;
+    switch (op->tag) {
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_ADD:
+            cpp_op = calculator::Calculator::OperationType::Add;
+            break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_SUBTRACT:
+            cpp_op = calculator::Calculator::OperationType::Subtract;
+            break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_MULTIPLY:
+            cpp_op = calculator::Calculator::OperationType::Multiply;
+            break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_DIVIDE:
+            cpp_op = calculator::Calculator::OperationType::Divide;
+            break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_POWER:
+            cpp_op = calculator::Calculator::OperationType::Power;
+            break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_SQRT:
+            cpp_op = calculator::Calculator::OperationType::Sqrt;
+            break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_FACTORIAL:
+            cpp_op = calculator::Calculator::OperationType::Factorial;
+            break;
+        default:
+            ret->error.is_some = true;
+            calculator_string_dup(&ret->error.val, "Unknown operation type");
+            return;
+    }
+
+    // Compute straight into the buffers handed back to the bindings
+    size_t count = a->len;
+    double* values = count ? (double*)malloc(count * sizeof(double)) : nullptr;
+    uint64_t* error_mask = count ? (uint64_t*)malloc(COLUMNAR_MASK_WORDS(count) * sizeof(uint64_t)) : nullptr;
+    if (count && (!values || !error_mask)) {
+        free(values);
+        free(error_mask);
+        ret->error.is_some = true;
+        calculator_string_dup(&ret->error.val, "Out of memory");
+        return;
+    }
+
+    auto failed = calc.calculate_columnar_into(cpp_op,
+                                               std::span<const double>(a->ptr, a->len),
+                                               std::span<const double>(b->ptr, b->len),
+                                               values, error_mask);
+    if (!failed.has_value()) {
+        free(values);
+        free(error_mask);
+        ret->error.is_some = true;
+        calculator_string_dup(&ret->error.val, "Binary operation requires operand columns of equal length");
+        return;
+    }
+
+    ret->success = true;
+    ret->values.ptr = values;
+    ret->values.len = count;
+    ret->error_mask.ptr = error_mask;
+    ret->error_mask.len = COLUMNAR_MASK_WORDS(count);
+    ret->error_count = static_cast<uint32_t>(failed.value());
+}
+
 void exports_example_calculator_calc_get_calculator_info(exports_example_calculator_calc_component_info_t *ret) {
     auto info = calc.get_calculator_info();
 
@@ -1,4 +1,5 @@
 #include "calculator_c.h"
+#include "columnar_batch.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -237,6 +238,66 @@ calculation_result_t* calculator_c_calculate_batch(const operation_t* operations
     return results;
 }
 
+static columnar_result_t create_columnar_error(const char* message) {
+    columnar_result_t result = {0};
+    calculation_result_t error = create_error(message);
+    result.error = error.error;
+    return result;
+}
+
+columnar_result_t calculator_c_calculate_batch_columnar(operation_type_t op,
+                                                        const double* a,
+                                                        const double* b,
+                                                        size_t count) {
+    bool binary = op != OP_SQRT && op != OP_FACTORIAL;
+    if ((unsigned)op > OP_FACTORIAL) {
+        return create_columnar_error("Unknown operation type");
+    }
+    if (count > 0 && (!a || (binary && !b))) {
+        return create_columnar_error("Null operand column");
+    }
+
+    columnar_result_t result = {0};
+    result.success = true;
+    result.count = count;
+    if (count == 0) {
+        return result;
+    }
+
+    result.values = malloc(count * sizeof(double));
+    result.error_mask = malloc(COLUMNAR_MASK_WORDS(count) * sizeof(uint64_t));
+    if (!result.values || !result.error_mask) {
+        calculator_c_free_columnar_result(&result);
+        return create_columnar_error("Out of memory");
+    }
+
+    switch (op) {
+        case OP_ADD:
+            result.error_count = columnar_arith(COLUMNAR_ADD, a, b, count, result.values, result.error_mask);
+            break;
+        case OP_SUBTRACT:
+            result.error_count = columnar_arith(COLUMNAR_SUBTRACT, a, b, count, result.values, result.error_mask);
+            break;
+        case OP_MULTIPLY:
+            result.error_count = columnar_arith(COLUMNAR_MULTIPLY, a, b, count, result.values, result.error_mask);
+            break;
+        case OP_DIVIDE:
+            result.error_count = columnar_arith(COLUMNAR_DIVIDE, a, b, count, result.values, result.error_mask);
+            break;
+        case OP_POWER:
+            result.error_count = columnar_power(a, b, count, result.values, result.error_mask);
+            break;
+        case OP_SQRT:
+            result.error_count = columnar_sqrt(a, count, result.values, result.error_mask);
+            break;
+        case OP_FACTORIAL:
+            result.error_count = columnar_factorial(a, count, result.values, result.error_mask);
+            break;
+    }
+
+    return result;
+}
+
 // Component metadata
 component_info_t calculator_c_get_info(void) {
     component_info_t info;
@@ -292,6 +353,19 @@ void calculator_c_free_results(calculation_result_t* results, size_t count) {
     free(results);
 }
 
+void calculator_c_free_columnar_result(columnar_result_t* result) {
+    if (!result) return;
+
+    free(result->error);
+    free(result->values);
+    free(result->error_mask);
+    result->error = NULL;
+    result->values = NULL;
+    result->error_mask = NULL;
+    result->count = 0;
+    result->error_count = 0;
+}
+
 void calculator_c_free_component_info(component_info_t* info) {
     if (!info) return;
 
@@ -445,6 +519,51 @@ void exports_example_calculator_calc_calculate_batch(exports_example_calculator_
     }
 }
 
+void exports_example_calculator_calc_calculate_batch_columnar(exports_example_calculator_calc_operation_type_t *op,
+                                                              calculator_list_f64_t *a,
+                                                              calculator_list_f64_t *b,
+                                                              exports_example_calculator_calc_columnar_result_t *ret) {
+    memset(ret, 0, sizeof(*ret));
+
+    operation_type_t c_op;
+    switch (op->tag) {
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_ADD: c_op = OP_ADD; break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_SUBTRACT: c_op = OP_SUBTRACT; break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_MULTIPLY: c_op = OP_MULTIPLY; break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_DIVIDE: c_op = OP_DIVIDE; break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_POWER: c_op = OP_POWER; break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_SQRT: c_op = OP_SQRT; break;
+        case EXPORTS_EXAMPLE_CALCULATOR_CALC_OPERATION_TYPE_FACTORIAL: c_op = OP_FACTORIAL; break;
+        default:
+            ret->error.is_some = 1;
+            calculator_string_dup(&ret->error.val, "Unknown operation type");
+            return;
+    }
+
+    // Unary operations ignore b; binary ones need a column per operand
+    if (c_op != OP_SQRT && c_op != OP_FACTORIAL && a->len != b->len) {
+        ret->error.is_some = 1;
+        calculator_string_dup(&ret->error.val, "Binary operation requires operand columns of equal length");
+        return;
+    }
+
+    columnar_result_t result = calculator_c_calculate_batch_columnar(c_op, a->ptr, b->ptr, a->len);
+    ret->success = result.success;
+    if (!result.success) {
+        ret->error.is_some = 1;
+        calculator_string_dup(&ret->error.val, result.error);
+        calculator_c_free_columnar_result(&result);
+        return;
+    }
+
+    // Hand the columns to the bindings, which free them after the call
+    ret->values.ptr = result.values;
+    ret->values.len = result.count;
+    ret->error_mask.ptr = result.error_mask;
+    ret->error_mask.len = result.values ? COLUMNAR_MASK_WORDS(result.count) : 0;
+    ret->error_count = (uint32_t)result.error_count;
+}
+
 void exports_example_calculator_calc_get_calculator_info(exports_example_calculator_calc_component_info_t *ret) {
     component_info_t info = calculator_c_get_info();
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -33,6 +34,17 @@ typedef struct {
     bool has_b;      // Indicates if b parameter is valid
 } operation_t;
 
+// Result of a columnar batch: one value per element, NaN where the element
+// failed, and a bitmap with bit i % 64 of word i / 64 set for each failure
+typedef struct {
+    bool success;          // false when the operand columns were rejected
+    char* error;           // NULL if success is true
+    double* values;
+    uint64_t* error_mask;  // (count + 63) / 64 words
+    size_t count;
+    size_t error_count;
+} columnar_result_t;
+
 // Component information structure
 typedef struct {
     char* name;
@@ -59,6 +71,10 @@ calculation_result_t calculator_c_calculate(const operation_t* operation);
 calculation_result_t* calculator_c_calculate_batch(const operation_t* operations,
                                                    size_t count,
                                                    size_t* result_count);
+columnar_result_t calculator_c_calculate_batch_columnar(operation_type_t op,
+                                                        const double* a,
+                                                        const double* b,
+                                                        size_t count);
 
 // Component metadata
 component_info_t calculator_c_get_info(void);
@@ -71,6 +87,7 @@ double calculator_c_get_e(void);
 void calculator_c_free_result(calculation_result_t* result);
 void calculator_c_free_results(calculation_result_t* results, size_t count);
 void calculator_c_free_component_info(component_info_t* info);
+void calculator_c_free_columnar_result(columnar_result_t* result);
 
 // Utility functions
 bool calculator_c_is_valid_number(double n);
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "math_utils.h"
+#include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -57,6 +59,34 @@ public:
     CalculationResult calculate(const Operation& operation) const;
     std::vector<CalculationResult> calculate_batch(const std::vector<Operation>& operations) const;
 
+    // Columnar batch: one operation over whole operand columns, b ignored
+    // for unary operations. Failed elements hold NaN and set bit i % 64 of
+    // error_mask[i / 64] instead of carrying a result each.
+    struct ColumnarResult {
+        bool success = true;
+        std::optional<std::string> error;
+        std::vector<double> values;
+        std::vector<uint64_t> error_mask;
+        size_t error_count = 0;
+
+        bool failed(size_t index) const {
+            return (error_mask[index / 64] >> (index % 64)) & 1;
+        }
+    };
+
+    ColumnarResult calculate_batch_columnar(OperationType op,
+                                            std::span<const double> a,
+                                            std::span<const double> b) const;
+
+    // Same into caller buffers of a.size() values and
+    // (a.size() + 63) / 64 mask words; returns the failed element count,
+    // nullopt when the columns don't fit the operation
+    std::optional<size_t> calculate_columnar_into(OperationType op,
+                                                  std::span<const double> a,
+                                                  std::span<const double> b,
+                                                  double* values,
+                                                  uint64_t* error_mask) const;
+
     // Component metadata
     struct ComponentInfo {
         std::string name;
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// WebAssembly SIMD support (-msimd128); baseline wasm builds use the scalar paths
+#if defined(__wasm__) && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define COLUMNAR_SIMD_SUPPORTED 1
+#else
+#define COLUMNAR_SIMD_SUPPORTED 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Columnar batch kernels shared by the C and C++ calculators
+ *
+ * A columnar batch applies one operation to whole operand columns:
+ * out[i] = op(a[i], b[i]). Instead of a result record per element, failures
+ * are reported in a bitmap, bit i % 64 of word i / 64 set when element i
+ * failed, and failed elements hold NaN. An element fails when an operand or
+ * the result is NaN or infinite, which covers division by zero, square roots
+ * of negative numbers and overflow without a branch per element. Results are
+ * not rounded the way the single-operation C functions round them.
+ *
+ * Add, subtract, multiply, divide and sqrt run two lanes at a time with
+ * f64x2 SIMD; power and factorial have no vector form and run scalar, still
+ * without the per-element dispatch of the operation list.
+ *
+ * Every kernel writes count values and COLUMNAR_MASK_WORDS(count) mask words
+ * and returns the number of failed elements.
+ */
+
+#define COLUMNAR_MASK_WORDS(count) (((count) + 63) / 64)
+#define COLUMNAR_MAX_FACTORIAL 20
+
+typedef enum {
+    COLUMNAR_ADD = 0,
+    COLUMNAR_SUBTRACT,
+    COLUMNAR_MULTIPLY,
+    COLUMNAR_DIVIDE
+} columnar_arith_t;
+
+static inline void columnar_mark_failed(uint64_t* mask, size_t index) {
+    mask[index / 64] |= (uint64_t)1 << (index % 64);
+}
+
+static inline double columnar_scalar_arith(columnar_arith_t op, double a, double b) {
+    switch (op) {
+        case COLUMNAR_ADD: return a + b;
+        case COLUMNAR_SUBTRACT: return a - b;
+        case COLUMNAR_MULTIPLY: return a * b;
+        case COLUMNAR_DIVIDE: return a / b;
+    }
+    return NAN;
+}
+
+#if COLUMNAR_SIMD_SUPPORTED
+static inline v128_t columnar_simd_arith(columnar_arith_t op, v128_t a, v128_t b) {
+    switch (op) {
+        case COLUMNAR_ADD: return wasm_f64x2_add(a, b);
+        case COLUMNAR_SUBTRACT: return wasm_f64x2_sub(a, b);
+        case COLUMNAR_MULTIPLY: return wasm_f64x2_mul(a, b);
+        case COLUMNAR_DIVIDE: return wasm_f64x2_div(a, b);
+    }
+    return wasm_f64x2_splat(NAN);
+}
+
+// All-ones lanes where value is finite; NaN compares false
+static inline v128_t columnar_simd_finite(v128_t value) {
+    return wasm_f64x2_lt(wasm_f64x2_abs(value), wasm_f64x2_splat(INFINITY));
+}
+
+// Store value with failed lanes replaced by NaN and record them in mask;
+// index is even, so both lanes fall in the same mask word
+static inline size_t columnar_simd_store(double* out, uint64_t* mask, size_t index,
+                                         v128_t value, v128_t ok) {
+    wasm_v128_store(out + index, wasm_v128_bitselect(value, wasm_f64x2_splat(NAN), ok));
+    uint64_t failed = ~(uint64_t)wasm_i64x2_bitmask(ok) & 3;
+    mask[index / 64] |= failed << (index % 64);
+    return (size_t)(failed & 1) + (size_t)(failed >> 1);
+}
+#endif
+
+static inline size_t columnar_arith(columnar_arith_t op, const double* a, const double* b,
+                                    size_t count, double* out, uint64_t* mask) {
+    size_t failed = 0;
+    size_t i = 0;
+    memset(mask, 0, COLUMNAR_MASK_WORDS(count) * sizeof(uint64_t));
+
+#if COLUMNAR_SIMD_SUPPORTED
+    for (; i + 2 <= count; i += 2) {
+        v128_t va = wasm_v128_load(a + i);
+        v128_t vb = wasm_v128_load(b + i);
+        v128_t result = columnar_simd_arith(op, va, vb);
+        v128_t ok = wasm_v128_and(wasm_v128_and(columnar_simd_finite(va), columnar_simd_finite(vb)),
+                                  columnar_simd_finite(result));
+        failed += columnar_simd_store(out, mask, i, result, ok);
+    }
+#endif
+
+    for (; i < count; i++) {
+        double result = columnar_scalar_arith(op, a[i], b[i]);
+        if (isfinite(a[i]) && isfinite(b[i]) && isfinite(result)) {
+            out[i] = result;
+        } else {
+            out[i] = NAN;
+            columnar_mark_failed(mask, i);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+static inline size_t columnar_sqrt(const double* a, size_t count, double* out, uint64_t* mask) {
+    size_t failed = 0;
+    size_t i = 0;
+    memset(mask, 0, COLUMNAR_MASK_WORDS(count) * sizeof(uint64_t));
+
+#if COLUMNAR_SIMD_SUPPORTED
+    for (; i + 2 <= count; i += 2) {
+        // Negative and NaN inputs give NaN, infinity stays infinite
+        v128_t result = wasm_f64x2_sqrt(wasm_v128_load(a + i));
+        failed += columnar_simd_store(out, mask, i, result, columnar_simd_finite(result));
+    }
+#endif
+
+    for (; i < count; i++) {
+        double result = sqrt(a[i]);
+        if (isfinite(result)) {
+            out[i] = result;
+        } else {
+            out[i] = NAN;
+            columnar_mark_failed(mask, i);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+static inline size_t columnar_power(const double* base, const double* exponent, size_t count,
+                                    double* out, uint64_t* mask) {
+    size_t failed = 0;
+    memset(mask, 0, COLUMNAR_MASK_WORDS(count) * sizeof(uint64_t));
+
+    for (size_t i = 0; i < count; i++) {
+        // 0^negative overflows and a negative base with a fractional
+        // exponent gives NaN, so the finite check catches both
+        double result = pow(base[i], exponent[i]);
+        if (isfinite(base[i]) && isfinite(exponent[i]) && isfinite(result)) {
+            out[i] = result;
+        } else {
+            out[i] = NAN;
+            columnar_mark_failed(mask, i);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+static inline size_t columnar_factorial(const double* a, size_t count, double* out, uint64_t* mask) {
+    static const double factorials[COLUMNAR_MAX_FACTORIAL + 1] = {
+        1.0, 1.0, 2.0, 6.0, 24.0, 120.0, 720.0, 5040.0, 40320.0, 362880.0,
+        3628800.0, 39916800.0, 479001600.0, 6227020800.0, 87178291200.0,
+        1307674368000.0, 20922789888000.0, 355687428096000.0,
+        6402373705728000.0, 121645100408832000.0, 2432902008176640000.0,
+    };
+
+    size_t failed = 0;
+    memset(mask, 0, COLUMNAR_MASK_WORDS(count) * sizeof(uint64_t));
+
+    for (size_t i = 0; i < count; i++) {
+        // Non-negative integers up to the table size; NaN fails both compares
+        double n = a[i];
+        if (n >= 0.0 && n <= COLUMNAR_MAX_FACTORIAL && floor(n) == n) {
+            out[i] = factorials[(size_t)n];
+        } else {
+            out[i] = NAN;
+            columnar_mark_failed(mask, i);
+            failed++;
+        }
+    }
+    return failed;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -24,6 +24,7 @@ public:
         test_cpp_basic_operations();
         test_cpp_advanced_operations();
         test_cpp_batch_operations();
+        test_cpp_columnar_batch();
         test_cpp_error_handling();
         test_cpp_component_info();
 
@@ -31,6 +32,7 @@ public:
         test_c_basic_operations();
         test_c_advanced_operations();
         test_c_batch_operations();
+        test_c_columnar_batch();
         test_c_error_handling();
         test_c_component_info();
 
@@ -112,6 +114,36 @@ private:
         std::cout << "  ✓ C++ Batch operations tests passed" << std::endl;
     }
 
+    void test_cpp_columnar_batch() {
+        calculator::Calculator calc;
+
+        // Enough elements to fill more than one mask word
+        std::vector<double> a(100), b(100);
+        for (size_t i = 0; i < a.size(); i++) {
+            a[i] = static_cast<double>(i);
+            b[i] = static_cast<double>(i % 10);
+        }
+
+        auto result = calc.calculate_batch_columnar(
+            calculator::Calculator::OperationType::Divide, a, b);
+        ASSERT_TRUE(result.success);
+        ASSERT_EQ(100, result.values.size());
+        ASSERT_EQ(2, result.error_mask.size());
+        ASSERT_EQ(10, result.error_count);  // Every b that is zero
+        ASSERT_TRUE(result.failed(0));
+        ASSERT_TRUE(result.failed(90));
+        ASSERT_FALSE(result.failed(91));
+        ASSERT_DOUBLE_EQ(91.0, result.values[91]);
+
+        // Binary operations need columns of equal length
+        std::vector<double> short_b(3, 1.0);
+        auto mismatched = calc.calculate_batch_columnar(
+            calculator::Calculator::OperationType::Add, a, short_b);
+        ASSERT_FALSE(mismatched.success);
+
+        std::cout << "  ✓ C++ Columnar batch tests passed" << std::endl;
+    }
+
     void test_cpp_error_handling() {
         calculator::Calculator calc;
 
@@ -223,6 +255,29 @@ private:
         std::cout << "  ✓ C Batch operations tests passed" << std::endl;
     }
 
+    void test_c_columnar_batch() {
+        // Odd length so the scalar tail runs after the SIMD pairs
+        double a[] = {16.0, -4.0, 9.0, 0.0, NAN};
+        columnar_result_t result = calculator_c_calculate_batch_columnar(OP_SQRT, a, NULL, 5);
+
+        ASSERT_TRUE(result.success);
+        ASSERT_EQ(5, result.count);
+        ASSERT_EQ(2, result.error_count);
+        ASSERT_EQ(0x12ULL, result.error_mask[0]);
+        ASSERT_DOUBLE_EQ(4.0, result.values[0]);
+        ASSERT_TRUE(std::isnan(result.values[1]));
+        ASSERT_DOUBLE_EQ(3.0, result.values[2]);
+        calculator_c_free_columnar_result(&result);
+
+        double n[] = {5.0, 2.5, 21.0};
+        result = calculator_c_calculate_batch_columnar(OP_FACTORIAL, n, NULL, 3);
+        ASSERT_EQ(2, result.error_count);
+        ASSERT_DOUBLE_EQ(120.0, result.values[0]);
+        calculator_c_free_columnar_result(&result);
+
+        std::cout << "  ✓ C Columnar batch tests passed" << std::endl;
+    }
+
     void test_c_error_handling() {
         // Test invalid inputs
         ASSERT_TRUE(isnan(calculator_c_add(NAN, 5.0)));
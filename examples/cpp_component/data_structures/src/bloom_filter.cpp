@@ -0,0 +1,129 @@
+#include "bloom_filter.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace data_structures {
+
+namespace {
+
+constexpr size_t BLOCKS_PER_LINE = BlockedBloomFilter::LINE_BYTES / BlockedBloomFilter::BLOCK_BYTES;
+
+// One bit per 16-bit lane, chosen by consecutive nibbles of the low hash half
+struct BlockMask {
+    uint64_t lo;  // Lanes 0-3
+    uint64_t hi;  // Lanes 4-7
+};
+
+inline BlockMask block_mask(uint64_t hash) {
+    uint32_t bits = static_cast<uint32_t>(hash);
+    BlockMask mask{0, 0};
+    for (int lane = 0; lane < 4; ++lane) {
+        mask.lo |= 1ULL << (lane * 16 + ((bits >> (lane * 4)) & 15));
+        mask.hi |= 1ULL << (lane * 16 + ((bits >> (lane * 4 + 16)) & 15));
+    }
+    return mask;
+}
+
+} // namespace
+
+BlockedBloomFilter::~BlockedBloomFilter() {
+    release();
+}
+
+void BlockedBloomFilter::release() {
+    free(blocks_);
+    blocks_ = nullptr;
+    block_count_ = 0;
+    capacity_ = 0;
+    inserted_ = 0;
+    removed_ = 0;
+}
+
+bool BlockedBloomFilter::init(size_t expected_keys, uint32_t bits_per_key) {
+    release();
+    bits_per_key_ = bits_per_key;
+    if (bits_per_key == 0) {
+        return true;  // Disabled by configuration
+    }
+
+    size_t keys = expected_keys < MIN_KEYS ? MIN_KEYS : expected_keys;
+    uint64_t bits = static_cast<uint64_t>(keys) * bits_per_key;
+    uint64_t blocks = (bits + BLOCK_BYTES * 8 - 1) / (BLOCK_BYTES * 8);
+    blocks = (blocks + BLOCKS_PER_LINE - 1) / BLOCKS_PER_LINE * BLOCKS_PER_LINE;
+    if (blocks > UINT32_MAX || blocks * BLOCK_BYTES > SIZE_MAX) {
+        return false;
+    }
+
+    size_t bytes = static_cast<size_t>(blocks * BLOCK_BYTES);
+    blocks_ = static_cast<uint8_t*>(aligned_alloc(LINE_BYTES, bytes));
+    if (!blocks_) {
+        return false;
+    }
+    memset(blocks_, 0, bytes);
+    block_count_ = static_cast<uint32_t>(blocks);
+    capacity_ = keys;
+    return true;
+}
+
+void BlockedBloomFilter::clear() {
+    if (blocks_) {
+        memset(blocks_, 0, memory_usage());
+    }
+    inserted_ = 0;
+    removed_ = 0;
+}
+
+const uint8_t* BlockedBloomFilter::block_for(uint64_t hash) const {
+    // Multiply-shift maps the high half onto [0, block_count_) without a divide
+    uint64_t index = ((hash >> 32) * block_count_) >> 32;
+    return blocks_ + index * BLOCK_BYTES;
+}
+
+void BlockedBloomFilter::insert(uint64_t hash) {
+    if (!blocks_) {
+        return;
+    }
+    uint8_t* block = const_cast<uint8_t*>(block_for(hash));
+    BlockMask mask = block_mask(hash);
+    uint64_t words[2];
+    memcpy(words, block, sizeof(words));
+    words[0] |= mask.lo;
+    words[1] |= mask.hi;
+    memcpy(block, words, sizeof(words));
+    inserted_++;
+}
+
+bool BlockedBloomFilter::may_contain(uint64_t hash) const {
+    if (!blocks_) {
+        return true;
+    }
+    const uint8_t* block = block_for(hash);
+    BlockMask mask = block_mask(hash);
+#ifdef __wasm_simd128__
+    v128_t bits = wasm_v128_load(block);
+    v128_t wanted = wasm_i64x2_make(static_cast<int64_t>(mask.lo), static_cast<int64_t>(mask.hi));
+    return !wasm_v128_any_true(wasm_v128_andnot(wanted, bits));
+#else
+    uint64_t words[2];
+    memcpy(words, block, sizeof(words));
+    return (words[0] & mask.lo) == mask.lo && (words[1] & mask.hi) == mask.hi;
+#endif
+}
+
+bool BlockedBloomFilter::needs_rebuild(size_t live_keys) const {
+    if (!blocks_) {
+        return false;
+    }
+    // Past its sizing the false positive rate climbs quickly. After heavy
+    // removal a smaller filter keeps the same rate in less memory.
+    bool overfull = inserted_ > capacity_;
+    bool mostly_removed = capacity_ > MIN_KEYS && removed_ > live_keys && live_keys * 8 < capacity_;
+    return overfull || mostly_removed;
+}
+
+} // namespace data_structures
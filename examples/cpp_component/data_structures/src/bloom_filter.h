@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace data_structures {
+
+/**
+ * Blocked Bloom filter for short-circuiting lookups of absent keys.
+ *
+ * Each key maps to one 16-byte block and sets one bit in each of its eight
+ * 16-bit lanes, so a probe is a single v128 load and compare. Blocks are
+ * packed four to a 64-byte aligned line and never straddle one. False
+ * positive rates: about 4% at 8 bits per key, 1.7% at 10, 0.8% at 12.
+ *
+ * The filter works on 64-bit key hashes supplied by its owner: the high half
+ * picks the block and the low half the bits. Bits cannot be cleared, so the
+ * owner reports removals and rebuilds from its live keys when
+ * needs_rebuild() says the filter has outgrown its sizing or gone stale.
+ */
+class BlockedBloomFilter {
+public:
+    static constexpr size_t BLOCK_BYTES = 16;
+    static constexpr size_t LINE_BYTES = 64;
+    static constexpr size_t MIN_KEYS = 1024;
+
+    BlockedBloomFilter() = default;
+    ~BlockedBloomFilter();
+
+    BlockedBloomFilter(const BlockedBloomFilter&) = delete;
+    BlockedBloomFilter& operator=(const BlockedBloomFilter&) = delete;
+
+    // Sizes the filter for expected_keys; false (filter disabled) on allocation failure
+    bool init(size_t expected_keys, uint32_t bits_per_key);
+    // Resizes for live_keys and re-inserts them; for_each(emit) calls emit(hash) per key
+    template<typename ForEach>
+    bool rebuild(size_t live_keys, ForEach for_each);
+    void clear();  // Drops every key, keeps the sizing
+
+    bool enabled() const { return blocks_ != nullptr; }
+    void insert(uint64_t hash);
+    void note_removed() { removed_++; }
+    // False only if the hash was never inserted; always true when disabled
+    bool may_contain(uint64_t hash) const;
+    bool needs_rebuild(size_t live_keys) const;
+
+    size_t memory_usage() const { return block_count_ * BLOCK_BYTES; }
+
+private:
+    uint8_t* blocks_ = nullptr;
+    uint32_t block_count_ = 0;
+    uint32_t bits_per_key_ = 0;
+    size_t capacity_ = 0;  // Keys the sizing was made for
+    size_t inserted_ = 0;  // Inserts since the last reset, repeats included
+    size_t removed_ = 0;   // Removals whose bits are still set
+
+    void release();
+    const uint8_t* block_for(uint64_t hash) const;
+};
+
+template<typename ForEach>
+bool BlockedBloomFilter::rebuild(size_t live_keys, ForEach for_each) {
+    // Twice the live keys leaves room to grow before the next rebuild
+    if (!init(live_keys * 2, bits_per_key_)) {
+        return false;
+    }
+    for_each([this](uint64_t hash) { insert(hash); });
+    return true;
+}
+
+} // namespace data_structures
@@ -0,0 +1,9 @@
+#include "btree.h"
+
+namespace data_structures {
+
+// The data-structures component stores string keys and byte values; build
+// that instantiation once here instead of in every translation unit.
+template class BPlusTree<std::string, std::vector<uint8_t>>;
+
+} // namespace data_structures
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace data_structures {
+
+/**
+ * B+tree with cache-line sized nodes, optimized for WebAssembly.
+ *
+ * Values live only in leaves, and leaves are doubly linked, so a range scan
+ * is one descent followed by a sequential walk over contiguous key arrays.
+ * Keys and values are stored in separate arrays inside a node: the binary
+ * search touches only key cache lines, and a value is read after a hit.
+ */
+
+// Tree statistics
+struct BTreeStats {
+    uint32_t height;
+    uint32_t node_count;
+    uint32_t key_count;
+    uint32_t internal_nodes;
+    uint32_t leaf_nodes;
+    uint32_t memory_usage;
+    float average_leaf_fill;
+};
+
+template<typename K, typename V, size_t NodeBytes = 256>
+class BPlusTree {
+public:
+    static constexpr size_t CACHE_LINE = 64;
+    static_assert(NodeBytes % CACHE_LINE == 0, "NodeBytes must be a whole number of cache lines");
+
+    // Fan-out: enough keys to fill NodeBytes of key storage, never below 4
+    static constexpr size_t LEAF_CAPACITY =
+        NodeBytes / sizeof(K) < 4 ? 4 : NodeBytes / sizeof(K);
+    static constexpr size_t INTERNAL_CAPACITY =
+        NodeBytes / (sizeof(K) + sizeof(void*)) < 4 ? 4 : NodeBytes / (sizeof(K) + sizeof(void*));
+
+private:
+    struct Node {
+        bool is_leaf;
+        uint16_t count;  // Number of keys
+    };
+
+    struct LeafNode : Node {
+        K keys[LEAF_CAPACITY];
+        V values[LEAF_CAPACITY];
+        LeafNode* prev;
+        LeafNode* next;
+    };
+
+    struct InternalNode : Node {
+        // children[i] holds keys < keys[i]; children[i + 1] holds keys >= keys[i]
+        K keys[INTERNAL_CAPACITY];
+        Node* children[INTERNAL_CAPACITY + 1];
+    };
+
+public:
+    BPlusTree();
+    // Bulk load from strictly ascending pairs; leaves are packed full and the
+    // index is built bottom-up. Unsorted input falls back to per-key inserts.
+    explicit BPlusTree(const std::vector<std::pair<K, V>>& sorted_pairs);
+    ~BPlusTree();
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+    BPlusTree(BPlusTree&& other) noexcept;
+    BPlusTree& operator=(BPlusTree&& other) noexcept;
+
+    // Forward iterator over leaf entries in key order
+    class Iterator {
+    public:
+        Iterator() : leaf_(nullptr), index_(0) {}
+
+        const K& key() const { return leaf_->keys[index_]; }
+        const V& value() const { return leaf_->values[index_]; }
+        std::pair<const K&, const V&> operator*() const { return {key(), value()}; }
+
+        Iterator& operator++();
+        bool operator==(const Iterator& other) const {
+            return leaf_ == other.leaf_ && index_ == other.index_;
+        }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class BPlusTree;
+        Iterator(const LeafNode* leaf, size_t index);
+
+        const LeafNode* leaf_;
+        size_t index_;
+    };
+
+    // Streaming view over [first, last); nothing is materialized
+    class Range {
+    public:
+        Iterator begin() const { return first_; }
+        Iterator end() const { return last_; }
+        bool empty() const { return first_ == last_; }
+        // Walks leaf counts only, without touching keys or values
+        size_t count() const;
+
+    private:
+        friend class BPlusTree;
+        Range(Iterator first, Iterator last) : first_(first), last_(last) {}
+
+        Iterator first_;
+        Iterator last_;
+    };
+
+    // Core operations
+    bool insert(const K& key, const V& value);  // Inserts or overwrites; false on allocation failure
+    const V* find(const K& key) const;
+    bool erase(const K& key);
+    bool contains(const K& key) const { return find(key) != nullptr; }
+    void clear();
+    // Replace the contents with count entries the caller guarantees are
+    // strictly ascending; fill(i, key, value) writes entry i straight into its
+    // leaf slot. False, leaving the tree empty, on allocation failure.
+    template<typename Fill>
+    bool assign_sorted(size_t count, Fill fill);
+
+    // Ordered access
+    Iterator begin() const;
+    Iterator end() const { return Iterator(); }
+    Iterator lower_bound(const K& key) const;  // First key >= key
+    Iterator upper_bound(const K& key) const;  // First key > key
+    Range range(const K& start_key, const K& end_key) const;  // Inclusive on both ends
+
+    const K* min_key() const;
+    const K* max_key() const;
+    const K* predecessor(const K& key) const;  // Largest key < key
+    const K* successor(const K& key) const;    // Smallest key > key
+
+    // Information and statistics
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    uint32_t height() const { return height_; }
+    uint32_t node_count() const { return leaf_count_ + internal_count_; }
+    uint32_t leaf_count() const { return leaf_count_; }
+    uint32_t internal_count() const { return internal_count_; }
+    size_t memory_usage() const;
+    BTreeStats get_stats() const;
+
+    // Debugging and validation
+    bool validate() const;
+
+private:
+    Node* root_;
+    LeafNode* head_;  // Leftmost leaf
+    LeafNode* tail_;  // Rightmost leaf
+    size_t size_;
+    uint32_t height_;
+    uint32_t leaf_count_;
+    uint32_t internal_count_;
+
+    // Internal nodes reserved ahead of a split so an insert never fails halfway
+    static constexpr size_t MAX_HEIGHT = 32;
+    InternalNode* spare_internal_[MAX_HEIGHT];
+    size_t spare_count_;
+
+    static constexpr size_t LEAF_MIN = LEAF_CAPACITY / 2;
+    static constexpr size_t INTERNAL_MIN = INTERNAL_CAPACITY / 2;
+
+    // Node management
+    LeafNode* allocate_leaf();
+    InternalNode* allocate_internal();
+    bool reserve_internal(size_t count);
+    InternalNode* take_internal();
+    void free_node(Node* node);
+    void free_subtree(Node* node);
+
+    // Search helpers
+    const LeafNode* find_leaf(const K& key) const;
+    static size_t leaf_lower_bound(const LeafNode* leaf, const K& key);
+    static size_t child_index(const InternalNode* node, const K& key);
+
+    // Insertion: a split hands back the separator and the new right sibling
+    enum class InsertStatus { INSERTED, UPDATED, SPLIT, FAILED };
+    InsertStatus insert_recursive(Node* node, const K& key, const V& value, size_t reserved,
+                                  K& split_key, Node*& split_node);
+    InsertStatus insert_into_leaf(LeafNode* leaf, const K& key, const V& value,
+                                  K& split_key, Node*& split_node);
+    InsertStatus insert_into_internal(InternalNode* node, size_t child, const K& key, Node* right,
+                                      K& split_key, Node*& split_node);
+
+    // Deletion with borrow/merge rebalancing
+    bool erase_recursive(Node* node, const K& key);
+    void fix_underflow(InternalNode* parent, size_t child);
+    void merge_children(InternalNode* parent, size_t left_index);
+    bool is_underfull(const Node* node) const;
+
+    // Bulk loading
+    bool bulk_load(const std::vector<std::pair<K, V>>& sorted_pairs);
+    template<typename Fill>
+    bool build_sorted(size_t total, Fill& fill);
+
+    bool validate_node(const Node* node, const K* lower, const K* upper,
+                       uint32_t depth, uint32_t& leaf_depth, size_t& keys) const;
+};
+
+} // namespace data_structures
+
+// Include template implementations
+#include "btree_impl.h"
@@ -0,0 +1,789 @@
+#pragma once
+
+// Template implementations for btree.h (included at the end of that header)
+
+#include <algorithm>
+#include <new>
+
+namespace data_structures {
+
+// BPlusTree::Iterator
+
+template<typename K, typename V, size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>::Iterator::Iterator(const LeafNode* leaf, size_t index)
+    : leaf_(leaf), index_(index) {
+    // Normalize "one past the last key of a leaf" to the next leaf (or end)
+    while (leaf_ && index_ >= leaf_->count) {
+        leaf_ = leaf_->next;
+        index_ = 0;
+    }
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::Iterator& BPlusTree<K, V, NodeBytes>::Iterator::operator++() {
+    if (++index_ >= leaf_->count) {
+        *this = Iterator(leaf_->next, 0);
+    }
+    return *this;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+size_t BPlusTree<K, V, NodeBytes>::Range::count() const {
+    size_t total = 0;
+    const LeafNode* leaf = first_.leaf_;
+    size_t index = first_.index_;
+    while (leaf && leaf != last_.leaf_) {
+        total += leaf->count - index;
+        leaf = leaf->next;
+        index = 0;
+    }
+    if (leaf) {
+        total += last_.index_ - index;
+    }
+    return total;
+}
+
+// Construction
+
+template<typename K, typename V, size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>::BPlusTree()
+    : root_(nullptr), head_(nullptr), tail_(nullptr), size_(0),
+      height_(0), leaf_count_(0), internal_count_(0), spare_count_(0) {}
+
+template<typename K, typename V, size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>::BPlusTree(const std::vector<std::pair<K, V>>& sorted_pairs)
+    : BPlusTree() {
+    if (!bulk_load(sorted_pairs)) {
+        // Not strictly ascending (or out of memory): build it the slow way
+        clear();
+        for (const auto& pair : sorted_pairs) {
+            insert(pair.first, pair.second);
+        }
+    }
+}
+
+template<typename K, typename V, size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>::~BPlusTree() {
+    clear();
+    while (spare_count_ > 0) {
+        delete spare_internal_[--spare_count_];
+    }
+}
+
+template<typename K, typename V, size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>::BPlusTree(BPlusTree&& other) noexcept
+    : root_(other.root_), head_(other.head_), tail_(other.tail_), size_(other.size_),
+      height_(other.height_), leaf_count_(other.leaf_count_),
+      internal_count_(other.internal_count_), spare_count_(0) {
+    other.root_ = nullptr;
+    other.head_ = nullptr;
+    other.tail_ = nullptr;
+    other.size_ = 0;
+    other.height_ = 0;
+    other.leaf_count_ = 0;
+    other.internal_count_ = 0;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+BPlusTree<K, V, NodeBytes>& BPlusTree<K, V, NodeBytes>::operator=(BPlusTree&& other) noexcept {
+    if (this != &other) {
+        clear();
+        std::swap(root_, other.root_);
+        std::swap(head_, other.head_);
+        std::swap(tail_, other.tail_);
+        std::swap(size_, other.size_);
+        std::swap(height_, other.height_);
+        std::swap(leaf_count_, other.leaf_count_);
+        std::swap(internal_count_, other.internal_count_);
+    }
+    return *this;
+}
+
+// Core operations
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::insert(const K& key, const V& value) {
+    if (!root_) {
+        LeafNode* leaf = allocate_leaf();
+        if (!leaf) return false;
+        root_ = head_ = tail_ = leaf;
+        height_ = 1;
+    }
+
+    // A full root may split into a new root; reserve it before anything changes
+    size_t reserved = root_->count == (root_->is_leaf ? LEAF_CAPACITY : INTERNAL_CAPACITY) ? 1 : 0;
+    if (!reserve_internal(reserved)) {
+        return false;
+    }
+
+    K split_key;
+    Node* split_node = nullptr;
+    InsertStatus status = insert_recursive(root_, key, value, reserved, split_key, split_node);
+
+    if (status == InsertStatus::SPLIT) {
+        // Root split: grow the tree by one level
+        InternalNode* new_root = take_internal();
+        new_root->keys[0] = std::move(split_key);
+        new_root->children[0] = root_;
+        new_root->children[1] = split_node;
+        new_root->count = 1;
+        root_ = new_root;
+        height_++;
+        status = InsertStatus::INSERTED;
+    }
+
+    if (status == InsertStatus::INSERTED) {
+        size_++;
+    }
+    return status != InsertStatus::FAILED;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+const V* BPlusTree<K, V, NodeBytes>::find(const K& key) const {
+    const LeafNode* leaf = find_leaf(key);
+    if (!leaf) return nullptr;
+    size_t index = leaf_lower_bound(leaf, key);
+    if (index < leaf->count && !(key < leaf->keys[index])) {
+        return &leaf->values[index];
+    }
+    return nullptr;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::erase(const K& key) {
+    if (!root_ || !erase_recursive(root_, key)) {
+        return false;
+    }
+    size_--;
+
+    if (!root_->is_leaf && root_->count == 0) {
+        // Root lost its last separator: its only child becomes the root
+        InternalNode* old_root = static_cast<InternalNode*>(root_);
+        root_ = old_root->children[0];
+        free_node(old_root);
+        height_--;
+    } else if (root_->is_leaf && root_->count == 0) {
+        free_node(root_);
+        root_ = head_ = tail_ = nullptr;
+        height_ = 0;
+    }
+    return true;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::clear() {
+    free_subtree(root_);
+    root_ = head_ = tail_ = nullptr;
+    size_ = 0;
+    height_ = 0;
+    leaf_count_ = 0;
+    internal_count_ = 0;
+}
+
+// Ordered access
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::Iterator BPlusTree<K, V, NodeBytes>::begin() const {
+    return Iterator(head_, 0);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::Iterator BPlusTree<K, V, NodeBytes>::lower_bound(const K& key) const {
+    const LeafNode* leaf = find_leaf(key);
+    if (!leaf) return end();
+    return Iterator(leaf, leaf_lower_bound(leaf, key));
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::Iterator BPlusTree<K, V, NodeBytes>::upper_bound(const K& key) const {
+    const LeafNode* leaf = find_leaf(key);
+    if (!leaf) return end();
+    size_t index = std::upper_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys;
+    return Iterator(leaf, index);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::Range BPlusTree<K, V, NodeBytes>::range(
+    const K& start_key, const K& end_key) const {
+    if (end_key < start_key) {
+        return Range(end(), end());
+    }
+    return Range(lower_bound(start_key), upper_bound(end_key));
+}
+
+template<typename K, typename V, size_t NodeBytes>
+const K* BPlusTree<K, V, NodeBytes>::min_key() const {
+    return head_ && head_->count ? &head_->keys[0] : nullptr;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+const K* BPlusTree<K, V, NodeBytes>::max_key() const {
+    return tail_ && tail_->count ? &tail_->keys[tail_->count - 1] : nullptr;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+const K* BPlusTree<K, V, NodeBytes>::predecessor(const K& key) const {
+    const LeafNode* leaf = find_leaf(key);
+    if (!leaf) return nullptr;
+    size_t index = leaf_lower_bound(leaf, key);
+    if (index > 0) {
+        return &leaf->keys[index - 1];
+    }
+    return leaf->prev ? &leaf->prev->keys[leaf->prev->count - 1] : nullptr;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+const K* BPlusTree<K, V, NodeBytes>::successor(const K& key) const {
+    Iterator it = upper_bound(key);
+    return it != end() ? &it.key() : nullptr;
+}
+
+// Information and statistics
+
+template<typename K, typename V, size_t NodeBytes>
+size_t BPlusTree<K, V, NodeBytes>::memory_usage() const {
+    return sizeof(*this) + leaf_count_ * sizeof(LeafNode) + internal_count_ * sizeof(InternalNode);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+BTreeStats BPlusTree<K, V, NodeBytes>::get_stats() const {
+    BTreeStats stats = {};
+    stats.height = height_;
+    stats.node_count = node_count();
+    stats.key_count = static_cast<uint32_t>(size_);
+    stats.internal_nodes = internal_count_;
+    stats.leaf_nodes = leaf_count_;
+    stats.memory_usage = static_cast<uint32_t>(memory_usage());
+    stats.average_leaf_fill = leaf_count_
+        ? static_cast<float>(size_) / (static_cast<float>(leaf_count_) * LEAF_CAPACITY)
+        : 0.0f;
+    return stats;
+}
+
+// Debugging and validation
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::validate() const {
+    if (!root_) {
+        return size_ == 0 && !head_ && !tail_ && height_ == 0;
+    }
+
+    uint32_t leaf_depth = 0;
+    size_t keys = 0;
+    if (!validate_node(root_, nullptr, nullptr, 1, leaf_depth, keys)) {
+        return false;
+    }
+    if (keys != size_ || leaf_depth != height_) {
+        return false;
+    }
+
+    // The leaf chain must visit every key once, in strictly ascending order
+    size_t chained = 0;
+    const LeafNode* previous = nullptr;
+    for (const LeafNode* leaf = head_; leaf; leaf = leaf->next) {
+        if (leaf->prev != previous) return false;
+        if (previous && previous->count && leaf->count &&
+            !(previous->keys[previous->count - 1] < leaf->keys[0])) {
+            return false;
+        }
+        chained += leaf->count;
+        previous = leaf;
+    }
+    return previous == tail_ && chained == size_;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::validate_node(const Node* node, const K* lower, const K* upper,
+                                               uint32_t depth, uint32_t& leaf_depth,
+                                               size_t& keys) const {
+    const K* node_keys = node->is_leaf
+        ? static_cast<const LeafNode*>(node)->keys
+        : static_cast<const InternalNode*>(node)->keys;
+
+    for (size_t i = 0; i < node->count; ++i) {
+        if (i > 0 && !(node_keys[i - 1] < node_keys[i])) return false;
+        if (lower && node_keys[i] < *lower) return false;
+        if (upper && !(node_keys[i] < *upper)) return false;
+    }
+
+    if (node->is_leaf) {
+        if (leaf_depth == 0) {
+            leaf_depth = depth;
+        }
+        keys += node->count;
+        return leaf_depth == depth && (node == root_ || node->count > 0);
+    }
+
+    const InternalNode* internal = static_cast<const InternalNode*>(node);
+    if (internal->count == 0) return false;
+    for (size_t i = 0; i <= internal->count; ++i) {
+        const K* child_lower = i > 0 ? &internal->keys[i - 1] : lower;
+        const K* child_upper = i < internal->count ? &internal->keys[i] : upper;
+        if (!validate_node(internal->children[i], child_lower, child_upper, depth + 1, leaf_depth, keys)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Node management
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::LeafNode* BPlusTree<K, V, NodeBytes>::allocate_leaf() {
+    LeafNode* leaf = new (std::nothrow) LeafNode();
+    if (leaf) {
+        leaf->is_leaf = true;
+        leaf->count = 0;
+        leaf->prev = nullptr;
+        leaf->next = nullptr;
+        leaf_count_++;
+    }
+    return leaf;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::InternalNode* BPlusTree<K, V, NodeBytes>::allocate_internal() {
+    InternalNode* node = new (std::nothrow) InternalNode();
+    if (node) {
+        node->is_leaf = false;
+        node->count = 0;
+        internal_count_++;
+    }
+    return node;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::reserve_internal(size_t count) {
+    while (spare_count_ < count) {
+        if (spare_count_ == MAX_HEIGHT) return false;
+        InternalNode* node = new (std::nothrow) InternalNode();
+        if (!node) return false;
+        spare_internal_[spare_count_++] = node;
+    }
+    return true;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::InternalNode* BPlusTree<K, V, NodeBytes>::take_internal() {
+    // Only called after reserve_internal() covered this split
+    InternalNode* node = spare_internal_[--spare_count_];
+    node->is_leaf = false;
+    node->count = 0;
+    internal_count_++;
+    return node;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::free_node(Node* node) {
+    if (node->is_leaf) {
+        delete static_cast<LeafNode*>(node);
+        leaf_count_--;
+    } else {
+        delete static_cast<InternalNode*>(node);
+        internal_count_--;
+    }
+}
+
+template<typename K, typename V, size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::free_subtree(Node* node) {
+    if (!node) return;
+    if (!node->is_leaf) {
+        InternalNode* internal = static_cast<InternalNode*>(node);
+        for (size_t i = 0; i <= internal->count; ++i) {
+            free_subtree(internal->children[i]);
+        }
+    }
+    free_node(node);
+}
+
+// Search helpers
+
+template<typename K, typename V, size_t NodeBytes>
+const typename BPlusTree<K, V, NodeBytes>::LeafNode*
+BPlusTree<K, V, NodeBytes>::find_leaf(const K& key) const {
+    const Node* node = root_;
+    if (!node) return nullptr;
+    while (!node->is_leaf) {
+        const InternalNode* internal = static_cast<const InternalNode*>(node);
+        node = internal->children[child_index(internal, key)];
+    }
+    return static_cast<const LeafNode*>(node);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+size_t BPlusTree<K, V, NodeBytes>::leaf_lower_bound(const LeafNode* leaf, const K& key) {
+    return std::lower_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+size_t BPlusTree<K, V, NodeBytes>::child_index(const InternalNode* node, const K& key) {
+    return std::upper_bound(node->keys, node->keys + node->count, key) - node->keys;
+}
+
+// Insertion
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::InsertStatus BPlusTree<K, V, NodeBytes>::insert_recursive(
+    Node* node, const K& key, const V& value, size_t reserved, K& split_key, Node*& split_node) {
+    if (node->is_leaf) {
+        return insert_into_leaf(static_cast<LeafNode*>(node), key, value, split_key, split_node);
+    }
+
+    InternalNode* internal = static_cast<InternalNode*>(node);
+    size_t child = child_index(internal, key);
+
+    // A full node on the path splits if everything below it does. Reserve its
+    // sibling on the way down: once the leaf has split, nothing may fail.
+    // A node with room absorbs any split, so nothing above it needs a spare.
+    if (internal->count < INTERNAL_CAPACITY) {
+        reserved = 0;
+    } else if (!reserve_internal(++reserved)) {
+        return InsertStatus::FAILED;
+    }
+
+    K child_split_key;
+    Node* child_split_node = nullptr;
+    InsertStatus status = insert_recursive(internal->children[child], key, value, reserved,
+                                           child_split_key, child_split_node);
+    if (status != InsertStatus::SPLIT) {
+        return status;
+    }
+    return insert_into_internal(internal, child, child_split_key, child_split_node,
+                                split_key, split_node);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::InsertStatus BPlusTree<K, V, NodeBytes>::insert_into_leaf(
+    LeafNode* leaf, const K& key, const V& value, K& split_key, Node*& split_node) {
+    size_t pos = leaf_lower_bound(leaf, key);
+    if (pos < leaf->count && !(key < leaf->keys[pos])) {
+        leaf->values[pos] = value;
+        return InsertStatus::UPDATED;
+    }
+
+    LeafNode* target = leaf;
+    LeafNode* right = nullptr;
+
+    if (leaf->count == LEAF_CAPACITY) {
+        right = allocate_leaf();
+        if (!right) return InsertStatus::FAILED;
+
+        // Move the upper half across, then insert on whichever side owns pos.
+        // Appending past the rightmost key (sequential loads) keeps the left
+        // leaf full instead of leaving a trail of half-empty leaves.
+        bool append = leaf == tail_ && pos == LEAF_CAPACITY;
+        size_t half = append ? LEAF_CAPACITY : LEAF_CAPACITY / 2;
+        std::move(leaf->keys + half, leaf->keys + LEAF_CAPACITY, right->keys);
+        std::move(leaf->values + half, leaf->values + LEAF_CAPACITY, right->values);
+        right->count = static_cast<uint16_t>(LEAF_CAPACITY - half);
+        leaf->count = static_cast<uint16_t>(half);
+
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next) {
+            leaf->next->prev = right;
+        } else {
+            tail_ = right;
+        }
+        leaf->next = right;
+
+        if (append || pos > half) {
+            target = right;
+            pos -= half;
+        }
+    }
+
+    std::move_backward(target->keys + pos, target->keys + target->count, target->keys + target->count + 1);
+    std::move_backward(target->values + pos, target->values + target->count, target->values + target->count + 1);
+    target->keys[pos] = key;
+    target->values[pos] = value;
+    target->count++;
+
+    if (!right) {
+        return InsertStatus::INSERTED;
+    }
+    split_key = right->keys[0];
+    split_node = right;
+    return InsertStatus::SPLIT;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+typename BPlusTree<K, V, NodeBytes>::InsertStatus BPlusTree<K, V, NodeBytes>::insert_into_internal(
+    InternalNode* node, size_t child, const K& key, Node* right, K& split_key, Node*& split_node) {
+    if (node->count < INTERNAL_CAPACITY) {
+        std::move_backward(node->keys + child, node->keys + node->count, node->keys + node->count + 1);
+        std::move_backward(node->children + child + 1, node->children + node->count + 1,
+                           node->children + node->count + 2);
+        node->keys[child] = key;
+        node->children[child + 1] = right;
+        node->count++;
+        return InsertStatus::INSERTED;
+    }
+
+    InternalNode* sibling = take_internal();
+
+    // Stage the overfull node, then promote its middle key
+    K keys[INTERNAL_CAPACITY + 1];
+    Node* children[INTERNAL_CAPACITY + 2];
+    std::move(node->keys, node->keys + child, keys);
+    keys[child] = key;
+    std::move(node->keys + child, node->keys + INTERNAL_CAPACITY, keys + child + 1);
+    std::copy(node->children, node->children + child + 1, children);
+    children[child + 1] = right;
+    std::copy(node->children + child + 1, node->children + INTERNAL_CAPACITY + 1, children + child + 2);
+
+    size_t mid = (INTERNAL_CAPACITY + 1) / 2;
+    std::move(keys, keys + mid, node->keys);
+    std::copy(children, children + mid + 1, node->children);
+    node->count = static_cast<uint16_t>(mid);
+
+    std::move(keys + mid + 1, keys + INTERNAL_CAPACITY + 1, sibling->keys);
+    std::copy(children + mid + 1, children + INTERNAL_CAPACITY + 2, sibling->children);
+    sibling->count = static_cast<uint16_t>(INTERNAL_CAPACITY - mid);
+
+    split_key = std::move(keys[mid]);
+    split_node = sibling;
+    return InsertStatus::SPLIT;
+}
+
+// Deletion
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::erase_recursive(Node* node, const K& key) {
+    if (node->is_leaf) {
+        LeafNode* leaf = static_cast<LeafNode*>(node);
+        size_t pos = leaf_lower_bound(leaf, key);
+        if (pos >= leaf->count || key < leaf->keys[pos]) {
+            return false;
+        }
+        // Separators equal to the removed key stay valid lower bounds
+        std::move(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+        std::move(leaf->values + pos + 1, leaf->values + leaf->count, leaf->values + pos);
+        leaf->count--;
+        return true;
+    }
+
+    InternalNode* internal = static_cast<InternalNode*>(node);
+    size_t child = child_index(internal, key);
+    if (!erase_recursive(internal->children[child], key)) {
+        return false;
+    }
+    if (is_underfull(internal->children[child])) {
+        fix_underflow(internal, child);
+    }
+    return true;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::is_underfull(const Node* node) const {
+    return node->count < (node->is_leaf ? LEAF_MIN : INTERNAL_MIN);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::fix_underflow(InternalNode* parent, size_t child) {
+    Node* node = parent->children[child];
+    Node* left = child > 0 ? parent->children[child - 1] : nullptr;
+    Node* right = child < parent->count ? parent->children[child + 1] : nullptr;
+    size_t minimum = node->is_leaf ? LEAF_MIN : INTERNAL_MIN;
+
+    if (left && left->count > minimum) {
+        // Borrow the largest entry of the left sibling
+        if (node->is_leaf) {
+            LeafNode* leaf = static_cast<LeafNode*>(node);
+            LeafNode* donor = static_cast<LeafNode*>(left);
+            std::move_backward(leaf->keys, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::move_backward(leaf->values, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+            leaf->keys[0] = std::move(donor->keys[donor->count - 1]);
+            leaf->values[0] = std::move(donor->values[donor->count - 1]);
+            leaf->count++;
+            donor->count--;
+            parent->keys[child - 1] = leaf->keys[0];
+        } else {
+            InternalNode* internal = static_cast<InternalNode*>(node);
+            InternalNode* donor = static_cast<InternalNode*>(left);
+            std::move_backward(internal->keys, internal->keys + internal->count,
+                               internal->keys + internal->count + 1);
+            std::move_backward(internal->children, internal->children + internal->count + 1,
+                               internal->children + internal->count + 2);
+            internal->keys[0] = std::move(parent->keys[child - 1]);
+            internal->children[0] = donor->children[donor->count];
+            internal->count++;
+            parent->keys[child - 1] = std::move(donor->keys[donor->count - 1]);
+            donor->count--;
+        }
+        return;
+    }
+
+    if (right && right->count > minimum) {
+        // Borrow the smallest entry of the right sibling
+        if (node->is_leaf) {
+            LeafNode* leaf = static_cast<LeafNode*>(node);
+            LeafNode* donor = static_cast<LeafNode*>(right);
+            leaf->keys[leaf->count] = std::move(donor->keys[0]);
+            leaf->values[leaf->count] = std::move(donor->values[0]);
+            leaf->count++;
+            std::move(donor->keys + 1, donor->keys + donor->count, donor->keys);
+            std::move(donor->values + 1, donor->values + donor->count, donor->values);
+            donor->count--;
+            parent->keys[child] = donor->keys[0];
+        } else {
+            InternalNode* internal = static_cast<InternalNode*>(node);
+            InternalNode* donor = static_cast<InternalNode*>(right);
+            internal->keys[internal->count] = std::move(parent->keys[child]);
+            internal->children[internal->count + 1] = donor->children[0];
+            internal->count++;
+            parent->keys[child] = std::move(donor->keys[0]);
+            std::move(donor->keys + 1, donor->keys + donor->count, donor->keys);
+            std::move(donor->children + 1, donor->children + donor->count + 1, donor->children);
+            donor->count--;
+        }
+        return;
+    }
+
+    // Neither sibling can spare an entry, so both fit in one node
+    merge_children(parent, left ? child - 1 : child);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+void BPlusTree<K, V, NodeBytes>::merge_children(InternalNode* parent, size_t left_index) {
+    Node* left = parent->children[left_index];
+    Node* right = parent->children[left_index + 1];
+
+    if (left->is_leaf) {
+        LeafNode* dst = static_cast<LeafNode*>(left);
+        LeafNode* src = static_cast<LeafNode*>(right);
+        std::move(src->keys, src->keys + src->count, dst->keys + dst->count);
+        std::move(src->values, src->values + src->count, dst->values + dst->count);
+        dst->count = static_cast<uint16_t>(dst->count + src->count);
+        dst->next = src->next;
+        if (src->next) {
+            src->next->prev = dst;
+        } else {
+            tail_ = dst;
+        }
+    } else {
+        InternalNode* dst = static_cast<InternalNode*>(left);
+        InternalNode* src = static_cast<InternalNode*>(right);
+        dst->keys[dst->count] = std::move(parent->keys[left_index]);
+        std::move(src->keys, src->keys + src->count, dst->keys + dst->count + 1);
+        std::copy(src->children, src->children + src->count + 1, dst->children + dst->count + 1);
+        dst->count = static_cast<uint16_t>(dst->count + 1 + src->count);
+    }
+    free_node(right);
+
+    std::move(parent->keys + left_index + 1, parent->keys + parent->count, parent->keys + left_index);
+    std::copy(parent->children + left_index + 2, parent->children + parent->count + 1,
+              parent->children + left_index + 1);
+    parent->count--;
+}
+
+// Bulk loading
+
+template<typename K, typename V, size_t NodeBytes>
+bool BPlusTree<K, V, NodeBytes>::bulk_load(const std::vector<std::pair<K, V>>& sorted_pairs) {
+    for (size_t i = 1; i < sorted_pairs.size(); ++i) {
+        if (!(sorted_pairs[i - 1].first < sorted_pairs[i].first)) {
+            return false;
+        }
+    }
+    auto fill = [&sorted_pairs](size_t i, K& key, V& value) {
+        key = sorted_pairs[i].first;
+        value = sorted_pairs[i].second;
+    };
+    return build_sorted(sorted_pairs.size(), fill);
+}
+
+template<typename K, typename V, size_t NodeBytes>
+template<typename Fill>
+bool BPlusTree<K, V, NodeBytes>::assign_sorted(size_t count, Fill fill) {
+    clear();
+    if (!build_sorted(count, fill)) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+template<typename K, typename V, size_t NodeBytes>
+template<typename Fill>
+bool BPlusTree<K, V, NodeBytes>::build_sorted(size_t total, Fill& fill) {
+    if (total == 0) {
+        return true;
+    }
+
+    // Spread keys evenly so the last leaf is not left nearly empty
+    size_t leaves = (total + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+    std::vector<Node*> level;
+    std::vector<K> separators;  // separators[i] = smallest key under level[i]
+    level.reserve(leaves);
+    separators.reserve(leaves);
+
+    size_t next_pair = 0;
+    LeafNode* previous = nullptr;
+    for (size_t i = 0; i < leaves; ++i) {
+        LeafNode* leaf = allocate_leaf();
+        if (!leaf) {
+            for (Node* node : level) free_node(node);
+            head_ = tail_ = nullptr;
+            return false;
+        }
+        size_t count = total / leaves + (i < total % leaves ? 1 : 0);
+        for (size_t j = 0; j < count; ++j, ++next_pair) {
+            fill(next_pair, leaf->keys[j], leaf->values[j]);
+        }
+        leaf->count = static_cast<uint16_t>(count);
+        leaf->prev = previous;
+        if (previous) {
+            previous->next = leaf;
+        } else {
+            head_ = leaf;
+        }
+        previous = leaf;
+        level.push_back(leaf);
+        separators.push_back(leaf->keys[0]);
+    }
+    tail_ = previous;
+    height_ = 1;
+
+    // Build internal levels bottom-up, again spreading children evenly
+    while (level.size() > 1) {
+        size_t fanout = INTERNAL_CAPACITY + 1;
+        size_t parents = (level.size() + fanout - 1) / fanout;
+        std::vector<Node*> next_level;
+        std::vector<K> next_separators;
+        next_level.reserve(parents);
+        next_separators.reserve(parents);
+
+        size_t next_child = 0;
+        for (size_t i = 0; i < parents; ++i) {
+            InternalNode* node = allocate_internal();
+            if (!node) {
+                // Free the half-built index along with the leaves under it
+                for (Node* built : next_level) free_subtree(built);
+                for (size_t j = next_child; j < level.size(); ++j) free_subtree(level[j]);
+                head_ = tail_ = nullptr;
+                return false;
+            }
+            size_t count = level.size() / parents + (i < level.size() % parents ? 1 : 0);
+            next_separators.push_back(separators[next_child]);
+            for (size_t j = 0; j < count; ++j, ++next_child) {
+                node->children[j] = level[next_child];
+                if (j > 0) {
+                    node->keys[j - 1] = std::move(separators[next_child]);
+                }
+            }
+            node->count = static_cast<uint16_t>(count - 1);
+            next_level.push_back(node);
+        }
+
+        level.swap(next_level);
+        separators.swap(next_separators);
+        height_++;
+    }
+
+    root_ = level.front();
+    size_ = total;
+    return true;
+}
+
+} // namespace data_structures
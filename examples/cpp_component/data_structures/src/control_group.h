@@ -0,0 +1,98 @@
+#pragma once
+
+#include "simd_utils.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace data_structures {
+
+/**
+ * Control-byte group used by the SIMD_GROUP_PROBING collision strategy.
+ *
+ * Every slot of the table owns one control byte kept in a separate array:
+ * EMPTY, DELETED, or a 7-bit tag taken from the top of the key's hash.
+ * A probe loads 16 control bytes at once and compares them against the
+ * tag with a single v128 compare, so only slots whose tag matches ever
+ * touch the (much larger) HashEntry.
+ */
+struct ControlGroup {
+    static constexpr size_t WIDTH = 16;
+
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr uint8_t DELETED = 0xFE;
+
+    // 7-bit tag stored in the control byte (top bit clear marks a full slot)
+    static uint8_t tag(uint64_t hash) { return static_cast<uint8_t>(hash >> 57); }
+
+    static bool is_full(uint8_t ctrl) { return (ctrl & 0x80) == 0; }
+
+    explicit ControlGroup(const uint8_t* ctrl) {
+#if SIMD_SUPPORTED
+        bytes_ = simd_utils::simd_load_unaligned(ctrl);
+#else
+        for (size_t i = 0; i < WIDTH; ++i) {
+            bytes_.bytes[i] = ctrl[i];
+        }
+#endif
+    }
+
+    // Bitmask of slots whose tag equals the given tag
+    uint32_t match(uint8_t h2) const {
+#if SIMD_SUPPORTED
+        return simd_utils::simd_bitmask_u8(
+            simd_utils::simd_eq_u8(bytes_, simd_utils::simd_splat_u8(h2)));
+#else
+        return match_scalar(h2);
+#endif
+    }
+
+    // Bitmask of EMPTY slots (a probe sequence can stop at the first one)
+    uint32_t match_empty() const {
+#if SIMD_SUPPORTED
+        return simd_utils::simd_bitmask_u8(
+            simd_utils::simd_eq_u8(bytes_, simd_utils::simd_splat_u8(EMPTY)));
+#else
+        return match_scalar(EMPTY);
+#endif
+    }
+
+    // Bitmask of EMPTY or DELETED slots (both have the top bit set)
+    uint32_t match_empty_or_deleted() const {
+#if SIMD_SUPPORTED
+        return simd_utils::simd_bitmask_u8(bytes_);
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < WIDTH; ++i) {
+            if (bytes_.bytes[i] & 0x80) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Iterate set bits: index of the lowest bit, then clear it
+    static uint32_t lowest_bit(uint32_t mask) { return static_cast<uint32_t>(__builtin_ctz(mask)); }
+    static uint32_t clear_lowest_bit(uint32_t mask) { return mask & (mask - 1); }
+
+    // Count leading/trailing empty-free slots (used to decide EMPTY vs DELETED on erase)
+    static uint32_t leading_zeros(uint32_t mask) {
+        return mask ? static_cast<uint32_t>(__builtin_clz(mask)) - (32 - WIDTH) : WIDTH;
+    }
+    static uint32_t trailing_zeros(uint32_t mask) {
+        return mask ? static_cast<uint32_t>(__builtin_ctz(mask)) : WIDTH;
+    }
+
+private:
+    v128_t bytes_;
+
+#if !SIMD_SUPPORTED
+    uint32_t match_scalar(uint8_t value) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < WIDTH; ++i) {
+            if (bytes_.bytes[i] == value) mask |= 1u << i;
+        }
+        return mask;
+    }
+#endif
+};
+
+} // namespace data_structures
@@ -1,41 +1,113 @@
 #include "data_structures.h"
+#include "hash_table.h"
+#include <algorithm>
 #include <map>
 #include <cstring>
 #include <cstdio>
+#include <new>
+#include <tuple>
 
 // Include generated WIT binding header
 #include "data_structures_world.h"
 
+// cpp_component(cabi_arena = True) serves argument buffers from a per-call
+// arena; every export opens a scope so the arena resets as it returns
+#ifdef WASM_CABI_ARENA
+#include "cabi_arena.h"
+#define EXPORT_SCOPE() CabiArenaScope cabi_arena_scope
+#else
+#define EXPORT_SCOPE() ((void)0)
+#endif
+
 namespace data_structures {
 
-// Global collection storage (simplified)
-static std::map<std::string, std::unique_ptr<SimpleHashTable>> hash_tables;
-static std::map<std::string, std::unique_ptr<SimpleBTree>> btrees;
-static std::map<std::string, std::unique_ptr<SimpleGraph>> graphs;
+// Name registry for the by-name exports; resource handles share ownership
+static std::unordered_map<std::string, std::shared_ptr<SimpleHashTable>> hash_tables;
+static std::unordered_map<std::string, std::shared_ptr<SimpleBTree>> btrees;
+static std::unordered_map<std::string, std::shared_ptr<SimpleGraph>> graphs;
+
+// Key hash shared by the Bloom filters in front of the hash tables and B-trees
+static uint64_t filter_hash(const std::string& key) {
+    return HashFunctions::wide_hash(key.data(), key.size());
+}
 
 // SimpleHashTable Implementation
-SimpleHashTable::SimpleHashTable(const std::string& name) : name_(name) {}
+SimpleHashTable::SimpleHashTable(const std::string& name, uint32_t bloom_bits_per_key,
+                                 size_t expected_keys)
+    : name_(name), bloom_bits_per_key_(bloom_bits_per_key) {
+    filter_.init(expected_keys, bloom_bits_per_key);
+}
+
+bool SimpleHashTable::definitely_absent(const std::string& key) const {
+    return filter_.enabled() && !filter_.may_contain(filter_hash(key));
+}
+
+void SimpleHashTable::filter_insert(const std::string& key) {
+    if (!filter_.enabled()) return;
+    filter_.insert(filter_hash(key));
+    if (filter_.needs_rebuild(data_.size())) {
+        rebuild_filter();
+    }
+}
+
+void SimpleHashTable::filter_remove() {
+    if (!filter_.enabled()) return;
+    filter_.note_removed();
+    if (filter_.needs_rebuild(data_.size())) {
+        rebuild_filter();
+    }
+}
+
+void SimpleHashTable::rebuild_filter() {
+    filter_.rebuild(data_.size(), [this](auto emit) {
+        for (const auto& pair : data_) {
+            emit(filter_hash(pair.first));
+        }
+    });
+}
 
 bool SimpleHashTable::put(const std::string& key, const std::vector<uint8_t>& value) {
-    data_[key] = value;
+    auto result = data_.insert_or_assign(key, value);
+    if (result.second) {
+        filter_insert(result.first->first);
+    }
+    return true;
+}
+
+bool SimpleHashTable::put(std::string&& key, std::vector<uint8_t>&& value) {
+    auto result = data_.insert_or_assign(std::move(key), std::move(value));
+    if (result.second) {
+        filter_insert(result.first->first);
+    }
     return true;
 }
 
 std::optional<std::vector<uint8_t>> SimpleHashTable::get(const std::string& key) {
+    const std::vector<uint8_t>* value = find(key);
+    return value ? std::make_optional(*value) : std::nullopt;
+}
+
+const std::vector<uint8_t>* SimpleHashTable::find(const std::string& key) const {
+    if (definitely_absent(key)) return nullptr;
     auto it = data_.find(key);
-    return it != data_.end() ? std::make_optional(it->second) : std::nullopt;
+    return it != data_.end() ? &it->second : nullptr;
 }
 
 bool SimpleHashTable::remove(const std::string& key) {
-    return data_.erase(key) > 0;
+    if (definitely_absent(key) || data_.erase(key) == 0) {
+        return false;
+    }
+    filter_remove();
+    return true;
 }
 
 bool SimpleHashTable::contains(const std::string& key) {
-    return data_.find(key) != data_.end();
+    return find(key) != nullptr;
 }
 
 void SimpleHashTable::clear() {
     data_.clear();
+    filter_.clear();
 }
 
 std::vector<std::string> SimpleHashTable::keys() {
@@ -58,6 +130,10 @@ uint32_t SimpleHashTable::size() const {
     return data_.size();
 }
 
+void SimpleHashTable::reserve(size_t entries) {
+    data_.reserve(entries);
+}
+
 uint32_t SimpleHashTable::capacity() const {
     return data_.bucket_count();
 }
@@ -75,45 +151,456 @@ uint32_t SimpleHashTable::resize_count() const {
 }
 
 uint32_t SimpleHashTable::memory_usage() const {
-    uint32_t usage = sizeof(*this);
+    uint32_t usage = sizeof(*this) + filter_.memory_usage();
     for (const auto& pair : data_) {
         usage += pair.first.size() + pair.second.size();
     }
     return usage;
 }
 
+size_t SimpleHashTable::snapshot_size(size_t* payload_bytes) const {
+    size_t key_bytes = 0;
+    size_t value_bytes = 0;
+    for (const auto& pair : data_) {
+        key_bytes += pair.first.size();
+        value_bytes += pair.second.size();
+    }
+    if (payload_bytes) {
+        *payload_bytes = key_bytes + value_bytes;
+    }
+    return SnapshotWriter::encoded_size(data_.size(), key_bytes, value_bytes);
+}
+
+bool SimpleHashTable::write_snapshot(uint8_t* buffer) const {
+    size_t key_bytes = 0;
+    size_t value_bytes = 0;
+    for (const auto& pair : data_) {
+        key_bytes += pair.first.size();
+        value_bytes += pair.second.size();
+    }
+    if (SnapshotWriter::encoded_size(data_.size(), key_bytes, value_bytes) == 0) {
+        return false;
+    }
+
+    SnapshotWriter writer(buffer, SnapshotKind::HASH_TABLE, data_.size(), key_bytes, value_bytes);
+    for (const auto& pair : data_) {
+        if (!writer.add(pair.first.data(), pair.first.size(), pair.second.data(), pair.second.size())) {
+            return false;
+        }
+    }
+    return writer.finish(false);
+}
+
+bool SimpleHashTable::load_snapshot(const SnapshotView& snapshot) {
+    // Size the table once, then construct each entry directly from the buffer
+    data_.clear();
+    data_.reserve(snapshot.size());
+    for (uint32_t i = 0; i < snapshot.size(); ++i) {
+        std::string_view key = snapshot.key(i);
+        ByteView value = snapshot.value(i);
+        data_.emplace(std::piecewise_construct,
+                      std::forward_as_tuple(key.data(), key.size()),
+                      std::forward_as_tuple(value.data, value.data + value.size));
+    }
+    rebuild_filter();
+    return true;
+}
+
 // SimpleBTree Implementation
-SimpleBTree::SimpleBTree(const std::string& name) : name_(name) {}
-bool SimpleBTree::insert(const std::string& key, const std::vector<uint8_t>& value) { return true; }
-std::optional<std::vector<uint8_t>> SimpleBTree::search(const std::string& key) { return std::nullopt; }
-bool SimpleBTree::remove(const std::string& key) { return true; }
-std::vector<std::pair<std::string, std::vector<uint8_t>>> SimpleBTree::range_query(const std::string& start_key, const std::string& end_key) { return {}; }
-std::optional<std::string> SimpleBTree::min_key() { return std::nullopt; }
-std::optional<std::string> SimpleBTree::max_key() { return std::nullopt; }
-std::optional<std::string> SimpleBTree::predecessor(const std::string& key) { return std::nullopt; }
-std::optional<std::string> SimpleBTree::successor(const std::string& key) { return std::nullopt; }
-uint32_t SimpleBTree::height() const { return 1; }
-uint32_t SimpleBTree::node_count() const { return data_.size(); }
-uint32_t SimpleBTree::key_count() const { return data_.size(); }
-uint32_t SimpleBTree::memory_usage() const { return 0; }
+SimpleBTree::SimpleBTree(const std::string& name, uint32_t bloom_bits_per_key)
+    : name_(name), bloom_bits_per_key_(bloom_bits_per_key) {
+    filter_.init(0, bloom_bits_per_key);
+}
+
+SimpleBTree::SimpleBTree(const std::string& name,
+                         const std::vector<std::pair<std::string, std::vector<uint8_t>>>& sorted_pairs,
+                         uint32_t bloom_bits_per_key)
+    : tree_(sorted_pairs), name_(name), bloom_bits_per_key_(bloom_bits_per_key) {
+    filter_.init(0, bloom_bits_per_key);
+    rebuild_filter();
+}
+
+bool SimpleBTree::definitely_absent(const std::string& key) const {
+    return filter_.enabled() && !filter_.may_contain(filter_hash(key));
+}
+
+void SimpleBTree::filter_insert(const std::string& key) {
+    // Overwrites count as inserts too; a rebuild resizes from the live keys
+    if (!filter_.enabled()) return;
+    filter_.insert(filter_hash(key));
+    if (filter_.needs_rebuild(tree_.size())) {
+        rebuild_filter();
+    }
+}
+
+void SimpleBTree::filter_remove() {
+    if (!filter_.enabled()) return;
+    filter_.note_removed();
+    if (filter_.needs_rebuild(tree_.size())) {
+        rebuild_filter();
+    }
+}
+
+void SimpleBTree::rebuild_filter() {
+    filter_.rebuild(tree_.size(), [this](auto emit) {
+        for (auto it = tree_.begin(); it != tree_.end(); ++it) {
+            emit(filter_hash(it.key()));
+        }
+    });
+}
+
+bool SimpleBTree::insert(const std::string& key, const std::vector<uint8_t>& value) {
+    if (!tree_.insert(key, value)) {
+        return false;
+    }
+    filter_insert(key);
+    return true;
+}
+
+std::optional<std::vector<uint8_t>> SimpleBTree::search(const std::string& key) {
+    if (definitely_absent(key)) return std::nullopt;
+    const std::vector<uint8_t>* value = tree_.find(key);
+    return value ? std::make_optional(*value) : std::nullopt;
+}
+
+bool SimpleBTree::remove(const std::string& key) {
+    if (definitely_absent(key) || !tree_.erase(key)) {
+        return false;
+    }
+    filter_remove();
+    return true;
+}
+
+std::vector<std::pair<std::string, std::vector<uint8_t>>> SimpleBTree::range_query(const std::string& start_key, const std::string& end_key) {
+    Tree::Range matches = tree_.range(start_key, end_key);
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> result;
+    result.reserve(matches.count());
+    for (const auto& entry : matches) {
+        result.emplace_back(entry.first, entry.second);
+    }
+    return result;
+}
+
+SimpleBTree::Tree::Range SimpleBTree::range(const std::string& start_key, const std::string& end_key) const {
+    return tree_.range(start_key, end_key);
+}
+
+std::optional<std::string> SimpleBTree::min_key() {
+    const std::string* key = tree_.min_key();
+    return key ? std::make_optional(*key) : std::nullopt;
+}
+
+std::optional<std::string> SimpleBTree::max_key() {
+    const std::string* key = tree_.max_key();
+    return key ? std::make_optional(*key) : std::nullopt;
+}
+
+std::optional<std::string> SimpleBTree::predecessor(const std::string& key) {
+    const std::string* found = tree_.predecessor(key);
+    return found ? std::make_optional(*found) : std::nullopt;
+}
+
+std::optional<std::string> SimpleBTree::successor(const std::string& key) {
+    const std::string* found = tree_.successor(key);
+    return found ? std::make_optional(*found) : std::nullopt;
+}
+
+uint32_t SimpleBTree::height() const { return tree_.height(); }
+uint32_t SimpleBTree::node_count() const { return tree_.node_count(); }
+uint32_t SimpleBTree::key_count() const { return tree_.size(); }
+uint32_t SimpleBTree::internal_node_count() const { return tree_.internal_count(); }
+uint32_t SimpleBTree::leaf_node_count() const { return tree_.leaf_count(); }
+
+uint32_t SimpleBTree::memory_usage() const {
+    size_t usage = sizeof(*this) - sizeof(tree_) + tree_.memory_usage() + filter_.memory_usage();
+    for (auto it = tree_.begin(); it != tree_.end(); ++it) {
+        usage += it.key().size() + it.value().size();
+    }
+    return usage;
+}
+
+size_t SimpleBTree::snapshot_size(size_t* payload_bytes) const {
+    size_t key_bytes = 0;
+    size_t value_bytes = 0;
+    for (auto it = tree_.begin(); it != tree_.end(); ++it) {
+        key_bytes += it.key().size();
+        value_bytes += it.value().size();
+    }
+    if (payload_bytes) {
+        *payload_bytes = key_bytes + value_bytes;
+    }
+    return SnapshotWriter::encoded_size(tree_.size(), key_bytes, value_bytes);
+}
+
+bool SimpleBTree::write_snapshot(uint8_t* buffer) const {
+    size_t key_bytes = 0;
+    size_t value_bytes = 0;
+    for (auto it = tree_.begin(); it != tree_.end(); ++it) {
+        key_bytes += it.key().size();
+        value_bytes += it.value().size();
+    }
+    if (SnapshotWriter::encoded_size(tree_.size(), key_bytes, value_bytes) == 0) {
+        return false;
+    }
+
+    // Leaf order is key order, so the snapshot is marked sorted
+    SnapshotWriter writer(buffer, SnapshotKind::BTREE, tree_.size(), key_bytes, value_bytes);
+    for (auto it = tree_.begin(); it != tree_.end(); ++it) {
+        if (!writer.add(it.key().data(), it.key().size(), it.value().data(), it.value().size())) {
+            return false;
+        }
+    }
+    return writer.finish(true);
+}
+
+bool SimpleBTree::load_snapshot(const SnapshotView& snapshot) {
+    // Sorted snapshots fill leaves straight from the buffer. Anything else
+    // (e.g. a hash table snapshot) is sorted through an index permutation.
+    std::vector<uint32_t> order;
+    if (!snapshot.sorted()) {
+        order.resize(snapshot.size());
+        for (uint32_t i = 0; i < snapshot.size(); ++i) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [&snapshot](uint32_t a, uint32_t b) {
+            return snapshot.key(a) < snapshot.key(b);
+        });
+        for (size_t i = 1; i < order.size(); ++i) {
+            if (snapshot.key(order[i - 1]) == snapshot.key(order[i])) {
+                return false;  // Duplicate keys
+            }
+        }
+    }
+
+    // Through the wrapper, so the Bloom filter is rebuilt from the loaded keys
+    return assign_sorted(snapshot.size(),
+        [&snapshot, &order](size_t i, std::string& key, std::vector<uint8_t>& value) {
+            uint32_t entry = order.empty() ? static_cast<uint32_t>(i) : order[i];
+            std::string_view source_key = snapshot.key(entry);
+            ByteView source_value = snapshot.value(entry);
+            key.assign(source_key.data(), source_key.size());
+            value.assign(source_value.data, source_value.data + source_value.size);
+        });
+}
 
 // SimpleGraph Implementation
-SimpleGraph::SimpleGraph(const std::string& name, bool directed) : name_(name), directed_(directed) {}
-bool SimpleGraph::add_node(uint64_t node_id, const std::vector<uint8_t>& data) { return true; }
-bool SimpleGraph::remove_node(uint64_t node_id) { return true; }
-bool SimpleGraph::add_edge(uint64_t source, uint64_t target, double weight, const std::vector<uint8_t>& data) { return true; }
-bool SimpleGraph::remove_edge(uint64_t source, uint64_t target) { return true; }
-bool SimpleGraph::has_node(uint64_t node_id) { return false; }
-bool SimpleGraph::has_edge(uint64_t source, uint64_t target) { return false; }
-std::vector<uint64_t> SimpleGraph::get_neighbors(uint64_t node_id) { return {}; }
-std::vector<SimpleEdge> SimpleGraph::get_edges(uint64_t node_id) { return {}; }
-std::vector<uint64_t> SimpleGraph::dfs(uint64_t start) { return {}; }
-std::vector<uint64_t> SimpleGraph::bfs(uint64_t start) { return {}; }
-std::vector<uint64_t> SimpleGraph::shortest_path(uint64_t start, uint64_t end) { return {}; }
+SimpleGraph::SimpleGraph(const std::string& name, bool directed,
+                         bool allow_self_loops, bool allow_parallel_edges)
+    : name_(name), directed_(directed), allow_self_loops_(allow_self_loops),
+      allow_parallel_edges_(allow_parallel_edges) {}
+
+const CSRGraph& SimpleGraph::frozen() const {
+    if (!csr_dirty_) return csr_;
+
+    // Dense indices follow ascending node id so results are deterministic
+    index_to_id_.clear();
+    index_to_id_.reserve(nodes_.size());
+    for (const auto& node : nodes_) {
+        index_to_id_.push_back(node.first);
+    }
+    std::sort(index_to_id_.begin(), index_to_id_.end());
+
+    id_to_index_.clear();
+    id_to_index_.reserve(index_to_id_.size());
+    for (uint32_t i = 0; i < index_to_id_.size(); ++i) {
+        id_to_index_[index_to_id_[i]] = i;
+    }
+
+    std::vector<CSRInputEdge> arcs;
+    arcs.reserve(edges_.size());
+    for (uint32_t i = 0; i < edges_.size(); ++i) {
+        const SimpleEdge& edge = edges_[i];
+        arcs.push_back({id_to_index_[edge.source], id_to_index_[edge.target], edge.weight, i});
+    }
+    csr_.build(static_cast<uint32_t>(index_to_id_.size()), arcs, directed_);
+    csr_dirty_ = false;
+    return csr_;
+}
+
+bool SimpleGraph::index_of(uint64_t node_id, uint32_t& index) const {
+    frozen();
+    auto it = id_to_index_.find(node_id);
+    if (it == id_to_index_.end()) return false;
+    index = it->second;
+    return true;
+}
+
+std::vector<uint64_t> SimpleGraph::to_ids(const std::vector<uint32_t>& indices) const {
+    std::vector<uint64_t> ids;
+    ids.reserve(indices.size());
+    for (uint32_t index : indices) {
+        ids.push_back(index_to_id_[index]);
+    }
+    return ids;
+}
+
+std::pair<uint64_t, uint64_t> SimpleGraph::edge_key(uint64_t source, uint64_t target) const {
+    if (!directed_ && target < source) std::swap(source, target);
+    return {source, target};
+}
+
+bool SimpleGraph::add_node(uint64_t node_id, const std::vector<uint8_t>& data) {
+    if (!nodes_.emplace(node_id, data).second) return false;
+    csr_dirty_ = true;
+    return true;
+}
+
+bool SimpleGraph::remove_node(uint64_t node_id) {
+    if (nodes_.erase(node_id) == 0) return false;
+
+    edges_.erase(std::remove_if(edges_.begin(), edges_.end(), [&](const SimpleEdge& edge) {
+        if (edge.source != node_id && edge.target != node_id) return false;
+        edge_keys_.erase(edge_key(edge.source, edge.target));
+        return true;
+    }), edges_.end());
+    csr_dirty_ = true;
+    return true;
+}
+
+bool SimpleGraph::add_edge(uint64_t source, uint64_t target, double weight, const std::vector<uint8_t>& data) {
+    if (nodes_.find(source) == nodes_.end() || nodes_.find(target) == nodes_.end()) return false;
+    if (source == target && !allow_self_loops_) return false;
+    if (!allow_parallel_edges_ && !edge_keys_.insert(edge_key(source, target)).second) return false;
+
+    edges_.push_back({source, target, weight, data});
+    csr_dirty_ = true;
+    return true;
+}
+
+bool SimpleGraph::remove_edge(uint64_t source, uint64_t target) {
+    auto key = edge_key(source, target);
+    size_t before = edges_.size();
+    edges_.erase(std::remove_if(edges_.begin(), edges_.end(), [&](const SimpleEdge& edge) {
+        return edge_key(edge.source, edge.target) == key;
+    }), edges_.end());
+    if (edges_.size() == before) return false;
+
+    edge_keys_.erase(key);
+    csr_dirty_ = true;
+    return true;
+}
+
+bool SimpleGraph::has_node(uint64_t node_id) {
+    return nodes_.find(node_id) != nodes_.end();
+}
+
+bool SimpleGraph::has_edge(uint64_t source, uint64_t target) {
+    uint32_t from, to;
+    if (!index_of(source, from) || !index_of(target, to)) return false;
+    return csr_.has_arc(from, to);
+}
+
+std::vector<uint64_t> SimpleGraph::get_neighbors(uint64_t node_id) {
+    uint32_t index;
+    if (!index_of(node_id, index)) return {};
+
+    CSRGraph::Neighbors row = csr_.neighbors(index);
+    std::vector<uint64_t> neighbors;
+    neighbors.reserve(row.size);
+    for (uint32_t i = 0; i < row.size; ++i) {
+        // Parallel edges share a target and sit next to each other in the row
+        if (i > 0 && row.targets[i] == row.targets[i - 1]) continue;
+        neighbors.push_back(index_to_id_[row.targets[i]]);
+    }
+    return neighbors;
+}
+
+std::vector<SimpleEdge> SimpleGraph::get_edges(uint64_t node_id) {
+    uint32_t index;
+    if (!index_of(node_id, index)) return {};
+
+    CSRGraph::Neighbors row = csr_.neighbors(index);
+    std::vector<SimpleEdge> result;
+    result.reserve(row.size);
+    for (uint32_t i = 0; i < row.size; ++i) {
+        // An undirected self loop is stored as two arcs of the same edge
+        if (i > 0 && row.edge_ids[i] == row.edge_ids[i - 1]) continue;
+        result.push_back(edges_[row.edge_ids[i]]);
+    }
+    return result;
+}
+
+std::vector<uint64_t> SimpleGraph::dfs(uint64_t start) {
+    uint32_t index;
+    if (!index_of(start, index)) return {};
+    return to_ids(csr_.dfs(index));
+}
+
+std::vector<uint64_t> SimpleGraph::bfs(uint64_t start) {
+    uint32_t index;
+    if (!index_of(start, index)) return {};
+    return to_ids(csr_.bfs(index));
+}
+
+std::vector<uint64_t> SimpleGraph::shortest_path(uint64_t start, uint64_t end) {
+    return find_path(start, end).nodes;
+}
+
+SimplePath SimpleGraph::find_path(uint64_t start, uint64_t end) {
+    SimplePath result{false, 0.0, {}};
+    uint32_t from, to;
+    if (!index_of(start, from) || !index_of(end, to)) return result;
+
+    std::vector<uint32_t> path;
+    result.exists = csr_.shortest_path(from, to, result.distance, path);
+    result.nodes = to_ids(path);
+    return result;
+}
+
+std::vector<std::vector<uint64_t>> SimpleGraph::connected_components() {
+    const CSRGraph& graph = frozen();
+    std::vector<std::vector<uint64_t>> components;
+    for (const auto& component : graph.connected_components()) {
+        components.push_back(to_ids(component));
+    }
+    return components;
+}
+
+std::vector<SimpleEdge> SimpleGraph::minimum_spanning_tree() {
+    const CSRGraph& graph = frozen();
+    std::vector<SimpleEdge> tree;
+    for (uint32_t edge_id : graph.minimum_spanning_forest()) {
+        tree.push_back(edges_[edge_id]);
+    }
+    return tree;
+}
+
+bool SimpleGraph::is_connected() {
+    return frozen().connected_components().size() <= 1;
+}
+
+bool SimpleGraph::has_cycles() {
+    return frozen().has_cycle();
+}
+
 uint32_t SimpleGraph::node_count() const { return nodes_.size(); }
 uint32_t SimpleGraph::edge_count() const { return edges_.size(); }
-double SimpleGraph::density() const { return 0.0; }
-uint32_t SimpleGraph::memory_usage() const { return 0; }
+
+double SimpleGraph::density() const {
+    double n = static_cast<double>(nodes_.size());
+    if (n < 2) return 0.0;
+    double possible = n * (n - 1);
+    return (directed_ ? 1.0 : 2.0) * edges_.size() / possible;
+}
+
+double SimpleGraph::average_degree() const {
+    if (nodes_.empty()) return 0.0;
+    return (directed_ ? 1.0 : 2.0) * edges_.size() / nodes_.size();
+}
+
+uint32_t SimpleGraph::memory_usage() const {
+    size_t usage = sizeof(*this) + csr_.memory_usage();
+    for (const auto& node : nodes_) {
+        usage += sizeof(node) + node.second.size();
+    }
+    for (const auto& edge : edges_) {
+        usage += sizeof(edge) + edge.data.size();
+    }
+    usage += edge_keys_.size() * sizeof(std::pair<uint64_t, uint64_t>);
+    usage += index_to_id_.capacity() * sizeof(uint64_t) +
+             id_to_index_.size() * (sizeof(uint64_t) + sizeof(uint32_t));
+    return usage;
+}
 
 CollectionManager& CollectionManager::instance() {
     static CollectionManager instance_;
@@ -132,19 +619,25 @@ SimpleHashTable* CollectionManager::get_hash_table(const std::string& name) {
 }
 
 bool CollectionManager::create_btree(const std::string& name) {
-    return true; // Stub
+    if (btrees_.find(name) != btrees_.end()) return false;
+    btrees_[name] = std::make_unique<SimpleBTree>(name);
+    return true;
 }
 
 SimpleBTree* CollectionManager::get_btree(const std::string& name) {
-    return nullptr; // Stub
+    auto it = btrees_.find(name);
+    return it != btrees_.end() ? it->second.get() : nullptr;
 }
 
 bool CollectionManager::create_graph(const std::string& name, bool directed) {
-    return true; // Stub
+    if (graphs_.find(name) != graphs_.end()) return false;
+    graphs_[name] = std::make_unique<SimpleGraph>(name, directed);
+    return true;
 }
 
 SimpleGraph* CollectionManager::get_graph(const std::string& name) {
-    return nullptr; // Stub
+    auto it = graphs_.find(name);
+    return it != graphs_.end() ? it->second.get() : nullptr;
 }
 
 bool CollectionManager::collection_exists(const std::string& name) {
@@ -174,11 +667,47 @@ uint32_t CollectionManager::garbage_collect() { return 0; }
 void CollectionManager::record_operation() {}
 double CollectionManager::get_operations_per_second() { return 0.0; }
 
-// Serialization helpers (stub)
+// Serialization helpers (binary uses the snapshot format; JSON is still a stub)
 std::vector<uint8_t> serialize_to_json(const std::unordered_map<std::string, std::vector<uint8_t>>& data) { return {}; }
-std::vector<uint8_t> serialize_to_binary(const std::unordered_map<std::string, std::vector<uint8_t>>& data) { return {}; }
+std::vector<uint8_t> serialize_to_binary(const std::unordered_map<std::string, std::vector<uint8_t>>& data) {
+    size_t key_bytes = 0;
+    size_t value_bytes = 0;
+    for (const auto& pair : data) {
+        key_bytes += pair.first.size();
+        value_bytes += pair.second.size();
+    }
+    size_t size = SnapshotWriter::encoded_size(data.size(), key_bytes, value_bytes);
+    if (size == 0) {
+        return {};
+    }
+
+    std::vector<uint8_t> buffer(size);
+    SnapshotWriter writer(buffer.data(), SnapshotKind::HASH_TABLE, data.size(), key_bytes, value_bytes);
+    for (const auto& pair : data) {
+        writer.add(pair.first.data(), pair.first.size(), pair.second.data(), pair.second.size());
+    }
+    if (!writer.finish(false)) {
+        return {};
+    }
+    return buffer;
+}
 bool deserialize_from_json(const std::vector<uint8_t>& data, std::unordered_map<std::string, std::vector<uint8_t>>& output) { return false; }
-bool deserialize_from_binary(const std::vector<uint8_t>& data, std::unordered_map<std::string, std::vector<uint8_t>>& output) { return false; }
+bool deserialize_from_binary(const std::vector<uint8_t>& data, std::unordered_map<std::string, std::vector<uint8_t>>& output) {
+    SnapshotView snapshot;
+    if (!snapshot.open(data.data(), data.size())) {
+        return false;
+    }
+    output.clear();
+    output.reserve(snapshot.size());
+    for (uint32_t i = 0; i < snapshot.size(); ++i) {
+        std::string_view key = snapshot.key(i);
+        ByteView value = snapshot.value(i);
+        output.emplace(std::piecewise_construct,
+                       std::forward_as_tuple(key.data(), key.size()),
+                       std::forward_as_tuple(value.data, value.data + value.size));
+    }
+    return true;
+}
 
 } // namespace data_structures
 
@@ -197,136 +726,913 @@ void string_to_wit_string(data_structures_world_string_t* out, const std::string
     data_structures_world_string_dup(out, s.c_str());
 }
 
-// Hash Table Interface - Minimal working implementations
-bool exports_example_data_structures_data_structures_create_hash_table(data_structures_world_string_t *name, exports_example_data_structures_data_structures_hash_table_config_t *config) {
-    std::string table_name = wit_string_to_string(name);
-    data_structures::hash_tables[table_name] = std::make_unique<data_structures::SimpleHashTable>(table_name);
-    return true;
+static void bytes_to_wit_list(data_structures_world_list_u8_t *out, const std::vector<uint8_t>& bytes) {
+    out->len = bytes.size();
+    out->ptr = static_cast<uint8_t*>(malloc(bytes.size()));
+    if (out->ptr && !bytes.empty()) {
+        memcpy(out->ptr, bytes.data(), bytes.size());
+    }
 }
 
-bool exports_example_data_structures_data_structures_hash_put(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) {
-    std::string name = wit_string_to_string(table_name);
-    std::string k = wit_string_to_string(key);
-    std::vector<uint8_t> v(value->ptr, value->ptr + value->len);
+// Collection lookup by name (the name-based exports below are thin wrappers
+// over the same operations the resource methods call with their handle)
+static data_structures::SimpleHashTable* find_hash_table(data_structures_world_string_t *table_name) {
+    auto it = data_structures::hash_tables.find(wit_string_to_string(table_name));
+    return it != data_structures::hash_tables.end() ? it->second.get() : nullptr;
+}
+
+static data_structures::SimpleBTree* find_btree(data_structures_world_string_t *tree_name) {
+    auto it = data_structures::btrees.find(wit_string_to_string(tree_name));
+    return it != data_structures::btrees.end() ? it->second.get() : nullptr;
+}
 
-    auto it = data_structures::hash_tables.find(name);
-    if (it != data_structures::hash_tables.end()) {
-        return it->second->put(k, v);
+static data_structures::SimpleGraph* find_graph(data_structures_world_string_t *graph_name) {
+    auto it = data_structures::graphs.find(wit_string_to_string(graph_name));
+    return it != data_structures::graphs.end() ? it->second.get() : nullptr;
+}
+
+// Hash table operations
+static bool hash_put(data_structures::SimpleHashTable* table, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) {
+    if (!table) return false;
+    return table->put(wit_string_to_string(key), std::vector<uint8_t>(value->ptr, value->ptr + value->len));
+}
+
+static void hash_get(data_structures::SimpleHashTable* table, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_hash_result_t *ret) {
+    const std::vector<uint8_t>* value = table ? table->find(wit_string_to_string(key)) : nullptr;
+    if (value) {
+        ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_HASH_RESULT_SUCCESS;
+        bytes_to_wit_list(&ret->val.success, *value);
+        return;
     }
-    return false;
+    ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_HASH_RESULT_NOT_FOUND;
 }
 
-void exports_example_data_structures_data_structures_hash_get(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_hash_result_t *ret) {
-    std::string name = wit_string_to_string(table_name);
-    std::string k = wit_string_to_string(key);
+static bool hash_remove(data_structures::SimpleHashTable* table, exports_example_data_structures_data_structures_key_type_t *key) {
+    return table && table->remove(wit_string_to_string(key));
+}
 
-    auto it = data_structures::hash_tables.find(name);
-    if (it != data_structures::hash_tables.end()) {
-        auto result = it->second->get(k);
+static bool hash_contains(data_structures::SimpleHashTable* table, exports_example_data_structures_data_structures_key_type_t *key) {
+    return table && table->contains(wit_string_to_string(key));
+}
+
+// Batched hash operations: one table lookup and one ABI crossing per batch
+static uint32_t hash_put_batch(data_structures::SimpleHashTable* table, data_structures_world_list_tuple2_key_type_value_type_t *entries) {
+    if (!table) {
+        return 0;
+    }
+
+    table->reserve(table->size() + entries->len);
+    uint32_t stored = 0;
+    for (size_t i = 0; i < entries->len; ++i) {
+        const auto& entry = entries->ptr[i];
+        std::string key(reinterpret_cast<const char*>(entry.f0.ptr), entry.f0.len);
+        std::vector<uint8_t> value(entry.f1.ptr, entry.f1.ptr + entry.f1.len);
+        if (table->put(std::move(key), std::move(value))) {
+            stored++;
+        }
+    }
+    return stored;
+}
+
+static void hash_get_batch(data_structures::SimpleHashTable* table, data_structures_world_list_key_type_t *keys, data_structures_world_list_option_value_type_t *ret) {
+    ret->ptr = nullptr;
+    ret->len = 0;
+
+    if (!table || keys->len == 0) {
+        return;
+    }
+    ret->ptr = static_cast<data_structures_world_option_value_type_t*>(malloc(keys->len * sizeof(*ret->ptr)));
+    if (!ret->ptr) {
+        return;
+    }
+    ret->len = keys->len;
+
+    std::string lookup;  // Reused across keys so most lookups do not allocate
+    for (size_t i = 0; i < keys->len; ++i) {
+        lookup.assign(reinterpret_cast<const char*>(keys->ptr[i].ptr), keys->ptr[i].len);
+        const std::vector<uint8_t>* value = table->find(lookup);
+        ret->ptr[i].is_some = value != nullptr;
+        if (value) {
+            bytes_to_wit_list(&ret->ptr[i].val, *value);
+        }
+    }
+}
+
+static uint32_t hash_remove_batch(data_structures::SimpleHashTable* table, data_structures_world_list_key_type_t *keys) {
+    if (!table) {
+        return 0;
+    }
+
+    uint32_t removed = 0;
+    std::string lookup;
+    for (size_t i = 0; i < keys->len; ++i) {
+        lookup.assign(reinterpret_cast<const char*>(keys->ptr[i].ptr), keys->ptr[i].len);
+        if (table->remove(lookup)) {
+            removed++;
+        }
+    }
+    return removed;
+}
+
+// B-tree operations
+static bool btree_insert(data_structures::SimpleBTree* tree, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) {
+    if (!tree) return false;
+    return tree->insert(wit_string_to_string(key), std::vector<uint8_t>(value->ptr, value->ptr + value->len));
+}
+
+static bool keys_strictly_ascending(const data_structures_world_list_tuple2_key_type_value_type_t *entries) {
+    for (size_t i = 1; i < entries->len; ++i) {
+        std::string_view previous(reinterpret_cast<const char*>(entries->ptr[i - 1].f0.ptr), entries->ptr[i - 1].f0.len);
+        std::string_view current(reinterpret_cast<const char*>(entries->ptr[i].f0.ptr), entries->ptr[i].f0.len);
+        if (!(previous < current)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t btree_insert_batch(data_structures::SimpleBTree* tree, data_structures_world_list_tuple2_key_type_value_type_t *entries) {
+    if (!tree) {
+        return 0;
+    }
+
+    // An empty tree fed ascending keys is bulk loaded instead of split leaf by leaf
+    if (tree->key_count() == 0 && entries->len > 1 && keys_strictly_ascending(entries)) {
+        bool loaded = tree->assign_sorted(entries->len,
+            [entries](size_t i, std::string& key, std::vector<uint8_t>& value) {
+                const auto& entry = entries->ptr[i];
+                key.assign(reinterpret_cast<const char*>(entry.f0.ptr), entry.f0.len);
+                value.assign(entry.f1.ptr, entry.f1.ptr + entry.f1.len);
+            });
+        if (loaded) {
+            return entries->len;
+        }
+    }
+
+    uint32_t stored = 0;
+    std::string key;
+    std::vector<uint8_t> value;
+    for (size_t i = 0; i < entries->len; ++i) {
+        const auto& entry = entries->ptr[i];
+        key.assign(reinterpret_cast<const char*>(entry.f0.ptr), entry.f0.len);
+        value.assign(entry.f1.ptr, entry.f1.ptr + entry.f1.len);
+        if (tree->insert(key, value)) {
+            stored++;
+        }
+    }
+    return stored;
+}
+
+static void btree_search(data_structures::SimpleBTree* tree, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_btree_result_t *ret) {
+    if (tree) {
+        auto result = tree->search(wit_string_to_string(key));
         if (result) {
-            ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_HASH_RESULT_SUCCESS;
-            ret->val.success.len = result->size();
-            ret->val.success.ptr = static_cast<uint8_t*>(malloc(result->size()));
-            if (ret->val.success.ptr && !result->empty()) {
-                memcpy(ret->val.success.ptr, result->data(), result->size());
-            }
+            ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_BTREE_RESULT_SUCCESS;
+            bytes_to_wit_list(&ret->val.success, *result);
             return;
         }
     }
+    ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_BTREE_RESULT_NOT_FOUND;
+}
 
-    ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_HASH_RESULT_NOT_FOUND;
+static bool btree_delete(data_structures::SimpleBTree* tree, exports_example_data_structures_data_structures_key_type_t *key) {
+    return tree && tree->remove(wit_string_to_string(key));
+}
+
+static void btree_range_query(data_structures::SimpleBTree* tree, exports_example_data_structures_data_structures_key_type_t *start_key, exports_example_data_structures_data_structures_key_type_t *end_key, data_structures_world_list_tuple2_key_type_value_type_t *ret) {
+    ret->ptr = nullptr;
+    ret->len = 0;
+
+    if (!tree) return;
+
+    // Copy straight from the leaves into the canonical ABI list, no intermediate vector
+    auto matches = tree->range(wit_string_to_string(start_key), wit_string_to_string(end_key));
+    size_t count = matches.count();
+    if (count == 0) return;
+
+    ret->ptr = static_cast<data_structures_world_tuple2_key_type_value_type_t*>(
+        malloc(count * sizeof(data_structures_world_tuple2_key_type_value_type_t)));
+    if (!ret->ptr) return;
+
+    size_t i = 0;
+    for (const auto& entry : matches) {
+        string_to_wit_string(&ret->ptr[i].f0, entry.first);
+        bytes_to_wit_list(&ret->ptr[i].f1, entry.second);
+        i++;
+    }
+    ret->len = i;
+}
+
+static void btree_stats(data_structures::SimpleBTree* tree, exports_example_data_structures_data_structures_btree_stats_t *ret) {
+    ret->height = tree->height();
+    ret->node_count = tree->node_count();
+    ret->key_count = tree->key_count();
+    ret->internal_nodes = tree->internal_node_count();
+    ret->leaf_nodes = tree->leaf_node_count();
+    ret->memory_usage = tree->memory_usage();
+    ret->cache_hit_ratio = 0.0f;  // No page cache: the whole tree is resident
+}
+
+// Graph operations
+static void ids_to_wit_list(data_structures_world_list_node_id_t *out, const std::vector<uint64_t>& ids) {
+    out->len = 0;
+    out->ptr = nullptr;
+    if (ids.empty()) return;
+    out->ptr = static_cast<uint64_t*>(malloc(ids.size() * sizeof(uint64_t)));
+    if (!out->ptr) return;
+    memcpy(out->ptr, ids.data(), ids.size() * sizeof(uint64_t));
+    out->len = ids.size();
+}
+
+static void edges_to_wit_list(exports_example_data_structures_data_structures_list_edge_t *out, const std::vector<data_structures::SimpleEdge>& edges) {
+    out->len = 0;
+    out->ptr = nullptr;
+    if (edges.empty()) return;
+    out->ptr = static_cast<exports_example_data_structures_data_structures_edge_t*>(
+        malloc(edges.size() * sizeof(exports_example_data_structures_data_structures_edge_t)));
+    if (!out->ptr) return;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        out->ptr[i].source_node = edges[i].source;
+        out->ptr[i].to = edges[i].target;
+        out->ptr[i].weight = edges[i].weight;
+        out->ptr[i].data.is_some = !edges[i].data.empty();
+        if (out->ptr[i].data.is_some) {
+            bytes_to_wit_list(&out->ptr[i].data.val, edges[i].data);
+        }
+    }
+    out->len = edges.size();
+}
+
+static std::shared_ptr<data_structures::SimpleGraph> make_graph(const std::string& graph_name, const exports_example_data_structures_data_structures_graph_config_t *config) {
+    bool directed = config->graph_type != EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_GRAPH_TYPE_UNDIRECTED;
+    return std::make_shared<data_structures::SimpleGraph>(
+        graph_name, directed, config->allow_self_loops, config->allow_parallel_edges);
+}
+
+static bool graph_add_node(data_structures::SimpleGraph* graph, exports_example_data_structures_data_structures_node_id_t node_id, exports_example_data_structures_data_structures_value_type_t *maybe_data) {
+    if (!graph) return false;
+    std::vector<uint8_t> data;
+    if (maybe_data) {
+        data.assign(maybe_data->ptr, maybe_data->ptr + maybe_data->len);
+    }
+    return graph->add_node(node_id, data);
+}
+
+static bool graph_add_edge(data_structures::SimpleGraph* graph, exports_example_data_structures_data_structures_edge_t *edge) {
+    if (!graph) return false;
+    std::vector<uint8_t> data;
+    if (edge->data.is_some) {
+        data.assign(edge->data.val.ptr, edge->data.val.ptr + edge->data.val.len);
+    }
+    return graph->add_edge(edge->source_node, edge->to, edge->weight, data);
+}
+
+static void graph_shortest_path(data_structures::SimpleGraph* graph, exports_example_data_structures_data_structures_node_id_t start, exports_example_data_structures_data_structures_node_id_t end, exports_example_data_structures_data_structures_path_result_t *ret) {
+    data_structures::SimplePath path = graph ? graph->find_path(start, end)
+                                             : data_structures::SimplePath{false, 0.0, {}};
+    ret->exists = path.exists;
+    ret->distance = path.distance;
+    ids_to_wit_list(&ret->path, path.nodes);
+    ret->edge_count = path.nodes.empty() ? 0 : static_cast<uint32_t>(path.nodes.size() - 1);
+}
+
+static void graph_stats(data_structures::SimpleGraph* graph, exports_example_data_structures_data_structures_graph_stats_t *ret) {
+    ret->node_count = graph->node_count();
+    ret->edge_count = graph->edge_count();
+    ret->density = graph->density();
+    ret->average_degree = graph->average_degree();
+    ret->is_connected = graph->is_connected();
+    ret->has_cycles = graph->has_cycles();
+    ret->memory_usage = graph->memory_usage();
+}
+
+// Hash Table Interface
+bool exports_example_data_structures_data_structures_create_hash_table(data_structures_world_string_t *name, exports_example_data_structures_data_structures_hash_table_config_t *config) {
+    EXPORT_SCOPE();
+    std::string table_name = wit_string_to_string(name);
+    data_structures::hash_tables[table_name] = std::make_shared<data_structures::SimpleHashTable>(
+        table_name, config->bloom_bits_per_key, config->initial_capacity);
+    return true;
+}
+
+bool exports_example_data_structures_data_structures_hash_put(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) {
+    EXPORT_SCOPE();
+    return hash_put(find_hash_table(table_name), key, value);
+}
+
+void exports_example_data_structures_data_structures_hash_get(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_hash_result_t *ret) {
+    EXPORT_SCOPE();
+    hash_get(find_hash_table(table_name), key, ret);
 }
 
 bool exports_example_data_structures_data_structures_hash_remove(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_key_type_t *key) {
-    return true; // Stub
+    EXPORT_SCOPE();
+    return hash_remove(find_hash_table(table_name), key);
 }
 
 bool exports_example_data_structures_data_structures_hash_contains(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_key_type_t *key) {
-    return false; // Stub
+    EXPORT_SCOPE();
+    return hash_contains(find_hash_table(table_name), key);
 }
 
 bool exports_example_data_structures_data_structures_hash_clear(data_structures_world_string_t *table_name) {
-    return true; // Stub
+    EXPORT_SCOPE();
+    data_structures::SimpleHashTable* table = find_hash_table(table_name);
+    if (!table) return false;
+    table->clear();
+    return true;
 }
 
 void exports_example_data_structures_data_structures_hash_keys(data_structures_world_string_t *table_name, data_structures_world_list_key_type_t *ret) {
+    EXPORT_SCOPE();
     ret->ptr = nullptr;
     ret->len = 0;
 }
 
 void exports_example_data_structures_data_structures_hash_values(data_structures_world_string_t *table_name, data_structures_world_list_value_type_t *ret) {
+    EXPORT_SCOPE();
     ret->ptr = nullptr;
     ret->len = 0;
 }
 
 uint32_t exports_example_data_structures_data_structures_hash_size(data_structures_world_string_t *table_name) {
-    return 0; // Stub
+    EXPORT_SCOPE();
+    data_structures::SimpleHashTable* table = find_hash_table(table_name);
+    return table ? table->size() : 0;
 }
 
 bool exports_example_data_structures_data_structures_hash_stats(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_hash_table_stats_t *ret) {
+    EXPORT_SCOPE();
     return false; // Stub
 }
 
+uint32_t exports_example_data_structures_data_structures_hash_put_batch(data_structures_world_string_t *table_name, data_structures_world_list_tuple2_key_type_value_type_t *entries) {
+    EXPORT_SCOPE();
+    return hash_put_batch(find_hash_table(table_name), entries);
+}
+
+void exports_example_data_structures_data_structures_hash_get_batch(data_structures_world_string_t *table_name, data_structures_world_list_key_type_t *keys, data_structures_world_list_option_value_type_t *ret) {
+    EXPORT_SCOPE();
+    hash_get_batch(find_hash_table(table_name), keys, ret);
+}
+
+uint32_t exports_example_data_structures_data_structures_hash_remove_batch(data_structures_world_string_t *table_name, data_structures_world_list_key_type_t *keys) {
+    EXPORT_SCOPE();
+    return hash_remove_batch(find_hash_table(table_name), keys);
+}
+
+// B-Tree Interface
+bool exports_example_data_structures_data_structures_create_btree(data_structures_world_string_t *name, exports_example_data_structures_data_structures_btree_config_t *config) {
+    EXPORT_SCOPE();
+    // Node fan-out is fixed at compile time to fit cache lines; config->order is advisory
+    std::string tree_name = wit_string_to_string(name);
+    data_structures::btrees[tree_name] = std::make_shared<data_structures::SimpleBTree>(
+        tree_name, config->bloom_bits_per_key);
+    return true;
+}
+
+bool exports_example_data_structures_data_structures_btree_insert(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) {
+    EXPORT_SCOPE();
+    return btree_insert(find_btree(tree_name), key, value);
+}
+
+uint32_t exports_example_data_structures_data_structures_btree_insert_batch(data_structures_world_string_t *tree_name, data_structures_world_list_tuple2_key_type_value_type_t *entries) {
+    EXPORT_SCOPE();
+    return btree_insert_batch(find_btree(tree_name), entries);
+}
+
+void exports_example_data_structures_data_structures_btree_search(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_btree_result_t *ret) {
+    EXPORT_SCOPE();
+    btree_search(find_btree(tree_name), key, ret);
+}
+
+bool exports_example_data_structures_data_structures_btree_delete(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key) {
+    EXPORT_SCOPE();
+    return btree_delete(find_btree(tree_name), key);
+}
+
+void exports_example_data_structures_data_structures_btree_range_query(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *start_key, exports_example_data_structures_data_structures_key_type_t *end_key, data_structures_world_list_tuple2_key_type_value_type_t *ret) {
+    EXPORT_SCOPE();
+    btree_range_query(find_btree(tree_name), start_key, end_key, ret);
+}
+
+static bool optional_key_to_wit(const std::optional<std::string>& key, exports_example_data_structures_data_structures_key_type_t *ret) {
+    if (!key) return false;
+    string_to_wit_string(ret, *key);
+    return true;
+}
+
+bool exports_example_data_structures_data_structures_btree_min_key(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleBTree* tree = find_btree(tree_name);
+    return tree && optional_key_to_wit(tree->min_key(), ret);
+}
+
+bool exports_example_data_structures_data_structures_btree_max_key(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleBTree* tree = find_btree(tree_name);
+    return tree && optional_key_to_wit(tree->max_key(), ret);
+}
+
+bool exports_example_data_structures_data_structures_btree_predecessor(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_key_type_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleBTree* tree = find_btree(tree_name);
+    return tree && optional_key_to_wit(tree->predecessor(wit_string_to_string(key)), ret);
+}
+
+bool exports_example_data_structures_data_structures_btree_successor(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_key_type_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleBTree* tree = find_btree(tree_name);
+    return tree && optional_key_to_wit(tree->successor(wit_string_to_string(key)), ret);
+}
+
+bool exports_example_data_structures_data_structures_get_btree_stats(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_btree_stats_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleBTree* tree = find_btree(tree_name);
+    if (!tree) return false;
+    btree_stats(tree, ret);
+    return true;
+}
+
+// Graph Interface
+bool exports_example_data_structures_data_structures_create_graph(data_structures_world_string_t *name, exports_example_data_structures_data_structures_graph_config_t *config) {
+    EXPORT_SCOPE();
+    std::string graph_name = wit_string_to_string(name);
+    data_structures::graphs[graph_name] = make_graph(graph_name, config);
+    return true;
+}
+
+bool exports_example_data_structures_data_structures_graph_add_node(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id, exports_example_data_structures_data_structures_value_type_t *maybe_data) {
+    EXPORT_SCOPE();
+    return graph_add_node(find_graph(graph_name), node_id, maybe_data);
+}
+
+bool exports_example_data_structures_data_structures_graph_remove_node(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    return graph && graph->remove_node(node_id);
+}
+
+bool exports_example_data_structures_data_structures_graph_add_edge(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_edge_t *edge) {
+    EXPORT_SCOPE();
+    return graph_add_edge(find_graph(graph_name), edge);
+}
+
+bool exports_example_data_structures_data_structures_graph_remove_edge(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t source_node, exports_example_data_structures_data_structures_node_id_t to) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    return graph && graph->remove_edge(source_node, to);
+}
+
+bool exports_example_data_structures_data_structures_graph_has_node(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    return graph && graph->has_node(node_id);
+}
+
+bool exports_example_data_structures_data_structures_graph_has_edge(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t source_node, exports_example_data_structures_data_structures_node_id_t to) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    return graph && graph->has_edge(source_node, to);
+}
+
+void exports_example_data_structures_data_structures_graph_get_neighbors(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id, data_structures_world_list_node_id_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    ids_to_wit_list(ret, graph ? graph->get_neighbors(node_id) : std::vector<uint64_t>());
+}
+
+void exports_example_data_structures_data_structures_graph_get_edges(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id, exports_example_data_structures_data_structures_list_edge_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    edges_to_wit_list(ret, graph ? graph->get_edges(node_id) : std::vector<data_structures::SimpleEdge>());
+}
+
+void exports_example_data_structures_data_structures_graph_shortest_path(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t start, exports_example_data_structures_data_structures_node_id_t end, exports_example_data_structures_data_structures_path_result_t *ret) {
+    EXPORT_SCOPE();
+    graph_shortest_path(find_graph(graph_name), start, end, ret);
+}
+
+void exports_example_data_structures_data_structures_graph_dfs(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t start, data_structures_world_list_node_id_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    ids_to_wit_list(ret, graph ? graph->dfs(start) : std::vector<uint64_t>());
+}
+
+void exports_example_data_structures_data_structures_graph_bfs(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t start, data_structures_world_list_node_id_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    ids_to_wit_list(ret, graph ? graph->bfs(start) : std::vector<uint64_t>());
+}
+
+void exports_example_data_structures_data_structures_graph_connected_components(data_structures_world_string_t *graph_name, data_structures_world_list_list_node_id_t *ret) {
+    EXPORT_SCOPE();
+    ret->ptr = nullptr;
+    ret->len = 0;
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    if (!graph) return;
+
+    auto components = graph->connected_components();
+    if (components.empty()) return;
+    ret->ptr = static_cast<data_structures_world_list_node_id_t*>(
+        malloc(components.size() * sizeof(data_structures_world_list_node_id_t)));
+    if (!ret->ptr) return;
+    for (size_t i = 0; i < components.size(); ++i) {
+        ids_to_wit_list(&ret->ptr[i], components[i]);
+    }
+    ret->len = components.size();
+}
+
+void exports_example_data_structures_data_structures_graph_minimum_spanning_tree(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_list_edge_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    edges_to_wit_list(ret, graph ? graph->minimum_spanning_tree() : std::vector<data_structures::SimpleEdge>());
+}
+
+bool exports_example_data_structures_data_structures_get_graph_stats(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_graph_stats_t *ret) {
+    EXPORT_SCOPE();
+    data_structures::SimpleGraph* graph = find_graph(graph_name);
+    if (!graph) return false;
+    graph_stats(graph, ret);
+    return true;
+}
+
+// Resource Interface - handles borrow straight to their collection (no name
+// lookup). A handle shares ownership with the name registry, so a collection
+// stays usable through its handle after delete-collection or re-creation.
+struct exports_example_data_structures_data_structures_hash_table_t {
+    std::shared_ptr<data_structures::SimpleHashTable> table;
+};
+
+struct exports_example_data_structures_data_structures_btree_t {
+    std::shared_ptr<data_structures::SimpleBTree> tree;
+};
+
+struct exports_example_data_structures_data_structures_graph_t {
+    std::shared_ptr<data_structures::SimpleGraph> graph;
+};
+
+// Resource constructors cannot report failure through WIT, so running out of
+// memory for the handle itself traps
+static void trap_if_null(const void* rep) {
+    if (!rep) abort();
+}
+
+exports_example_data_structures_data_structures_own_hash_table_t exports_example_data_structures_data_structures_constructor_hash_table(data_structures_world_string_t *name, exports_example_data_structures_data_structures_hash_table_config_t *config) {
+    EXPORT_SCOPE();
+    std::string table_name = wit_string_to_string(name);
+    auto table = std::make_shared<data_structures::SimpleHashTable>(
+        table_name, config->bloom_bits_per_key, config->initial_capacity);
+    data_structures::hash_tables[table_name] = table;
+    auto* rep = new (std::nothrow) exports_example_data_structures_data_structures_hash_table_t{std::move(table)};
+    trap_if_null(rep);
+    return exports_example_data_structures_data_structures_hash_table_new(rep);
+}
+
+bool exports_example_data_structures_data_structures_open_hash_table(data_structures_world_string_t *name, exports_example_data_structures_data_structures_own_hash_table_t *ret) {
+    EXPORT_SCOPE();
+    auto it = data_structures::hash_tables.find(wit_string_to_string(name));
+    if (it == data_structures::hash_tables.end()) return false;
+    auto* rep = new (std::nothrow) exports_example_data_structures_data_structures_hash_table_t{it->second};
+    trap_if_null(rep);
+    *ret = exports_example_data_structures_data_structures_hash_table_new(rep);
+    return true;
+}
+
+void exports_example_data_structures_data_structures_hash_table_destructor(exports_example_data_structures_data_structures_hash_table_t *rep) {
+    EXPORT_SCOPE();
+    delete rep;
+}
+
+bool exports_example_data_structures_data_structures_method_hash_table_put(exports_example_data_structures_data_structures_borrow_hash_table_t self, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) {
+    EXPORT_SCOPE();
+    return hash_put(self->table.get(), key, value);
+}
+
+void exports_example_data_structures_data_structures_method_hash_table_get(exports_example_data_structures_data_structures_borrow_hash_table_t self, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_hash_result_t *ret) {
+    EXPORT_SCOPE();
+    hash_get(self->table.get(), key, ret);
+}
+
+bool exports_example_data_structures_data_structures_method_hash_table_remove(exports_example_data_structures_data_structures_borrow_hash_table_t self, exports_example_data_structures_data_structures_key_type_t *key) {
+    EXPORT_SCOPE();
+    return hash_remove(self->table.get(), key);
+}
+
+bool exports_example_data_structures_data_structures_method_hash_table_contains(exports_example_data_structures_data_structures_borrow_hash_table_t self, exports_example_data_structures_data_structures_key_type_t *key) {
+    EXPORT_SCOPE();
+    return hash_contains(self->table.get(), key);
+}
+
+void exports_example_data_structures_data_structures_method_hash_table_clear(exports_example_data_structures_data_structures_borrow_hash_table_t self) {
+    EXPORT_SCOPE();
+    self->table->clear();
+}
+
+uint32_t exports_example_data_structures_data_structures_method_hash_table_size(exports_example_data_structures_data_structures_borrow_hash_table_t self) {
+    EXPORT_SCOPE();
+    return self->table->size();
+}
+
+uint32_t exports_example_data_structures_data_structures_method_hash_table_put_batch(exports_example_data_structures_data_structures_borrow_hash_table_t self, data_structures_world_list_tuple2_key_type_value_type_t *entries) {
+    EXPORT_SCOPE();
+    return hash_put_batch(self->table.get(), entries);
+}
+
+void exports_example_data_structures_data_structures_method_hash_table_get_batch(exports_example_data_structures_data_structures_borrow_hash_table_t self, data_structures_world_list_key_type_t *keys, data_structures_world_list_option_value_type_t *ret) {
+    EXPORT_SCOPE();
+    hash_get_batch(self->table.get(), keys, ret);
+}
+
+uint32_t exports_example_data_structures_data_structures_method_hash_table_remove_batch(exports_example_data_structures_data_structures_borrow_hash_table_t self, data_structures_world_list_key_type_t *keys) {
+    EXPORT_SCOPE();
+    return hash_remove_batch(self->table.get(), keys);
+}
+
+exports_example_data_structures_data_structures_own_btree_t exports_example_data_structures_data_structures_constructor_btree(data_structures_world_string_t *name, exports_example_data_structures_data_structures_btree_config_t *config) {
+    EXPORT_SCOPE();
+    std::string tree_name = wit_string_to_string(name);
+    auto tree = std::make_shared<data_structures::SimpleBTree>(tree_name, config->bloom_bits_per_key);
+    data_structures::btrees[tree_name] = tree;
+    auto* rep = new (std::nothrow) exports_example_data_structures_data_structures_btree_t{std::move(tree)};
+    trap_if_null(rep);
+    return exports_example_data_structures_data_structures_btree_new(rep);
+}
+
+bool exports_example_data_structures_data_structures_open_btree(data_structures_world_string_t *name, exports_example_data_structures_data_structures_own_btree_t *ret) {
+    EXPORT_SCOPE();
+    auto it = data_structures::btrees.find(wit_string_to_string(name));
+    if (it == data_structures::btrees.end()) return false;
+    auto* rep = new (std::nothrow) exports_example_data_structures_data_structures_btree_t{it->second};
+    trap_if_null(rep);
+    *ret = exports_example_data_structures_data_structures_btree_new(rep);
+    return true;
+}
+
+void exports_example_data_structures_data_structures_btree_destructor(exports_example_data_structures_data_structures_btree_t *rep) {
+    EXPORT_SCOPE();
+    delete rep;
+}
+
+bool exports_example_data_structures_data_structures_method_btree_insert(exports_example_data_structures_data_structures_borrow_btree_t self, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) {
+    EXPORT_SCOPE();
+    return btree_insert(self->tree.get(), key, value);
+}
+
+uint32_t exports_example_data_structures_data_structures_method_btree_insert_batch(exports_example_data_structures_data_structures_borrow_btree_t self, data_structures_world_list_tuple2_key_type_value_type_t *entries) {
+    EXPORT_SCOPE();
+    return btree_insert_batch(self->tree.get(), entries);
+}
+
+void exports_example_data_structures_data_structures_method_btree_search(exports_example_data_structures_data_structures_borrow_btree_t self, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_btree_result_t *ret) {
+    EXPORT_SCOPE();
+    btree_search(self->tree.get(), key, ret);
+}
+
+bool exports_example_data_structures_data_structures_method_btree_delete(exports_example_data_structures_data_structures_borrow_btree_t self, exports_example_data_structures_data_structures_key_type_t *key) {
+    EXPORT_SCOPE();
+    return btree_delete(self->tree.get(), key);
+}
+
+void exports_example_data_structures_data_structures_method_btree_range_query(exports_example_data_structures_data_structures_borrow_btree_t self, exports_example_data_structures_data_structures_key_type_t *start_key, exports_example_data_structures_data_structures_key_type_t *end_key, data_structures_world_list_tuple2_key_type_value_type_t *ret) {
+    EXPORT_SCOPE();
+    btree_range_query(self->tree.get(), start_key, end_key, ret);
+}
+
+void exports_example_data_structures_data_structures_method_btree_stats(exports_example_data_structures_data_structures_borrow_btree_t self, exports_example_data_structures_data_structures_btree_stats_t *ret) {
+    EXPORT_SCOPE();
+    btree_stats(self->tree.get(), ret);
+}
+
+exports_example_data_structures_data_structures_own_graph_t exports_example_data_structures_data_structures_constructor_graph(data_structures_world_string_t *name, exports_example_data_structures_data_structures_graph_config_t *config) {
+    EXPORT_SCOPE();
+    std::string graph_name = wit_string_to_string(name);
+    auto graph = make_graph(graph_name, config);
+    data_structures::graphs[graph_name] = graph;
+    auto* rep = new (std::nothrow) exports_example_data_structures_data_structures_graph_t{std::move(graph)};
+    trap_if_null(rep);
+    return exports_example_data_structures_data_structures_graph_new(rep);
+}
+
+bool exports_example_data_structures_data_structures_open_graph(data_structures_world_string_t *name, exports_example_data_structures_data_structures_own_graph_t *ret) {
+    EXPORT_SCOPE();
+    auto it = data_structures::graphs.find(wit_string_to_string(name));
+    if (it == data_structures::graphs.end()) return false;
+    auto* rep = new (std::nothrow) exports_example_data_structures_data_structures_graph_t{it->second};
+    trap_if_null(rep);
+    *ret = exports_example_data_structures_data_structures_graph_new(rep);
+    return true;
+}
+
+void exports_example_data_structures_data_structures_graph_destructor(exports_example_data_structures_data_structures_graph_t *rep) {
+    EXPORT_SCOPE();
+    delete rep;
+}
+
+bool exports_example_data_structures_data_structures_method_graph_add_node(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t node_id, exports_example_data_structures_data_structures_value_type_t *maybe_data) {
+    EXPORT_SCOPE();
+    return graph_add_node(self->graph.get(), node_id, maybe_data);
+}
+
+bool exports_example_data_structures_data_structures_method_graph_remove_node(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t node_id) {
+    EXPORT_SCOPE();
+    return self->graph->remove_node(node_id);
+}
+
+bool exports_example_data_structures_data_structures_method_graph_add_edge(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_edge_t *edge) {
+    EXPORT_SCOPE();
+    return graph_add_edge(self->graph.get(), edge);
+}
+
+bool exports_example_data_structures_data_structures_method_graph_remove_edge(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t source_node, exports_example_data_structures_data_structures_node_id_t to) {
+    EXPORT_SCOPE();
+    return self->graph->remove_edge(source_node, to);
+}
+
+bool exports_example_data_structures_data_structures_method_graph_has_node(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t node_id) {
+    EXPORT_SCOPE();
+    return self->graph->has_node(node_id);
+}
+
+bool exports_example_data_structures_data_structures_method_graph_has_edge(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t source_node, exports_example_data_structures_data_structures_node_id_t to) {
+    EXPORT_SCOPE();
+    return self->graph->has_edge(source_node, to);
+}
+
+void exports_example_data_structures_data_structures_method_graph_get_neighbors(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t node_id, data_structures_world_list_node_id_t *ret) {
+    EXPORT_SCOPE();
+    ids_to_wit_list(ret, self->graph->get_neighbors(node_id));
+}
+
+void exports_example_data_structures_data_structures_method_graph_shortest_path(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t start, exports_example_data_structures_data_structures_node_id_t end, exports_example_data_structures_data_structures_path_result_t *ret) {
+    EXPORT_SCOPE();
+    graph_shortest_path(self->graph.get(), start, end, ret);
+}
+
+void exports_example_data_structures_data_structures_method_graph_dfs(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t start, data_structures_world_list_node_id_t *ret) {
+    EXPORT_SCOPE();
+    ids_to_wit_list(ret, self->graph->dfs(start));
+}
+
+void exports_example_data_structures_data_structures_method_graph_bfs(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_node_id_t start, data_structures_world_list_node_id_t *ret) {
+    EXPORT_SCOPE();
+    ids_to_wit_list(ret, self->graph->bfs(start));
+}
+
+void exports_example_data_structures_data_structures_method_graph_stats(exports_example_data_structures_data_structures_borrow_graph_t self, exports_example_data_structures_data_structures_graph_stats_t *ret) {
+    EXPORT_SCOPE();
+    graph_stats(self->graph.get(), ret);
+}
+
+// Serialization Interface - binary snapshots for hash tables and B-trees
+static void serialization_error(exports_example_data_structures_data_structures_serialization_result_t *ret, const char* message) {
+    ret->success = false;
+    ret->data.is_some = false;
+    ret->size = 0;
+    ret->compression_ratio = 0.0f;
+    ret->error.is_some = true;
+    string_to_wit_string(&ret->error.val, message);
+}
+
+// Allocates the returned list so the snapshot is written straight into it.
+// compression-ratio is raw key/value bytes over encoded bytes: the format does
+// not compress, so framing overhead shows up as a ratio below 1.0.
+static uint8_t* begin_snapshot_result(exports_example_data_structures_data_structures_serialization_result_t *ret, size_t encoded, size_t payload) {
+    if (encoded == 0) {
+        serialization_error(ret, "Collection too large for a snapshot");
+        return nullptr;
+    }
+    uint8_t* buffer = static_cast<uint8_t*>(malloc(encoded));
+    if (!buffer) {
+        serialization_error(ret, "Out of memory");
+        return nullptr;
+    }
+    ret->success = true;
+    ret->data.is_some = true;
+    ret->data.val.ptr = buffer;
+    ret->data.val.len = encoded;
+    ret->size = encoded;
+    ret->compression_ratio = static_cast<float>(static_cast<double>(payload) / encoded);
+    ret->error.is_some = false;
+    return buffer;
+}
+
+static void abort_snapshot_result(exports_example_data_structures_data_structures_serialization_result_t *ret) {
+    free(ret->data.val.ptr);
+    serialization_error(ret, "Snapshot encoding failed");
+}
+
+void exports_example_data_structures_data_structures_serialize_hash_table(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_serialization_format_t format, exports_example_data_structures_data_structures_serialization_result_t *ret) {
+    EXPORT_SCOPE();
+    if (format != EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_SERIALIZATION_FORMAT_BINARY) {
+        serialization_error(ret, "Only the binary format is supported");
+        return;
+    }
+    auto it = data_structures::hash_tables.find(wit_string_to_string(table_name));
+    if (it == data_structures::hash_tables.end()) {
+        serialization_error(ret, "Hash table not found");
+        return;
+    }
+
+    size_t payload = 0;
+    size_t encoded = it->second->snapshot_size(&payload);
+    uint8_t* buffer = begin_snapshot_result(ret, encoded, payload);
+    if (buffer && !it->second->write_snapshot(buffer)) {
+        abort_snapshot_result(ret);
+    }
+}
+
+bool exports_example_data_structures_data_structures_deserialize_hash_table(data_structures_world_string_t *name, data_structures_world_list_u8_t *data, exports_example_data_structures_data_structures_serialization_format_t format) {
+    EXPORT_SCOPE();
+    data_structures::SnapshotView snapshot;
+    if (format != EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_SERIALIZATION_FORMAT_BINARY ||
+        !snapshot.open(data->ptr, data->len)) {
+        return false;
+    }
+
+    // Load into a fresh table so a failed load leaves the existing one intact;
+    // the replacement keeps the existing table's filter setting
+    std::string table_name = wit_string_to_string(name);
+    data_structures::SimpleHashTable* existing = find_hash_table(name);
+    auto table = std::make_unique<data_structures::SimpleHashTable>(
+        table_name, existing ? existing->bloom_bits_per_key() : 0);
+    if (!table->load_snapshot(snapshot)) {
+        return false;
+    }
+    data_structures::hash_tables[table_name] = std::move(table);
+    return true;
+}
+
+void exports_example_data_structures_data_structures_serialize_btree(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_serialization_format_t format, exports_example_data_structures_data_structures_serialization_result_t *ret) {
+    EXPORT_SCOPE();
+    if (format != EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_SERIALIZATION_FORMAT_BINARY) {
+        serialization_error(ret, "Only the binary format is supported");
+        return;
+    }
+    data_structures::SimpleBTree* tree = find_btree(tree_name);
+    if (!tree) {
+        serialization_error(ret, "B-tree not found");
+        return;
+    }
+
+    size_t payload = 0;
+    size_t encoded = tree->snapshot_size(&payload);
+    uint8_t* buffer = begin_snapshot_result(ret, encoded, payload);
+    if (buffer && !tree->write_snapshot(buffer)) {
+        abort_snapshot_result(ret);
+    }
+}
+
+bool exports_example_data_structures_data_structures_deserialize_btree(data_structures_world_string_t *name, data_structures_world_list_u8_t *data, exports_example_data_structures_data_structures_serialization_format_t format) {
+    EXPORT_SCOPE();
+    data_structures::SnapshotView snapshot;
+    if (format != EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_SERIALIZATION_FORMAT_BINARY ||
+        !snapshot.open(data->ptr, data->len)) {
+        return false;
+    }
+
+    std::string tree_name = wit_string_to_string(name);
+    data_structures::SimpleBTree* existing = find_btree(name);
+    auto tree = std::make_unique<data_structures::SimpleBTree>(
+        tree_name, existing ? existing->bloom_bits_per_key() : 0);
+    if (!tree->load_snapshot(snapshot)) {
+        return false;
+    }
+    data_structures::btrees[tree_name] = std::move(tree);
+    return true;
+}
+
 // All remaining functions as minimal stubs
-bool exports_example_data_structures_data_structures_create_btree(data_structures_world_string_t *name, exports_example_data_structures_data_structures_btree_config_t *config) { return true; }
-bool exports_example_data_structures_data_structures_btree_insert(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) { return true; }
-void exports_example_data_structures_data_structures_btree_search(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_btree_result_t *ret) { ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_BTREE_RESULT_NOT_FOUND; }
-bool exports_example_data_structures_data_structures_btree_delete(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key) { return true; }
-void exports_example_data_structures_data_structures_btree_range_query(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *start_key, exports_example_data_structures_data_structures_key_type_t *end_key, data_structures_world_list_tuple2_key_type_value_type_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-bool exports_example_data_structures_data_structures_btree_min_key(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *ret) { return false; }
-bool exports_example_data_structures_data_structures_btree_max_key(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *ret) { return false; }
-bool exports_example_data_structures_data_structures_btree_predecessor(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_key_type_t *ret) { return false; }
-bool exports_example_data_structures_data_structures_btree_successor(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_key_type_t *ret) { return false; }
-bool exports_example_data_structures_data_structures_get_btree_stats(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_btree_stats_t *ret) { return false; }
-bool exports_example_data_structures_data_structures_create_graph(data_structures_world_string_t *name, exports_example_data_structures_data_structures_graph_config_t *config) { return true; }
-bool exports_example_data_structures_data_structures_graph_add_node(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id, exports_example_data_structures_data_structures_value_type_t *maybe_data) { return true; }
-bool exports_example_data_structures_data_structures_graph_remove_node(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id) { return true; }
-bool exports_example_data_structures_data_structures_graph_add_edge(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_edge_t *edge) { return true; }
-bool exports_example_data_structures_data_structures_graph_remove_edge(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t source_node, exports_example_data_structures_data_structures_node_id_t to) { return true; }
-bool exports_example_data_structures_data_structures_graph_has_node(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id) { return false; }
-bool exports_example_data_structures_data_structures_graph_has_edge(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t source_node, exports_example_data_structures_data_structures_node_id_t to) { return false; }
-void exports_example_data_structures_data_structures_graph_get_neighbors(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id, data_structures_world_list_node_id_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-void exports_example_data_structures_data_structures_graph_get_edges(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t node_id, exports_example_data_structures_data_structures_list_edge_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-void exports_example_data_structures_data_structures_graph_shortest_path(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t start, exports_example_data_structures_data_structures_node_id_t end, exports_example_data_structures_data_structures_path_result_t *ret) { ret->exists = false; ret->distance = 0.0; ret->path.ptr = nullptr; ret->path.len = 0; ret->edge_count = 0; }
-void exports_example_data_structures_data_structures_graph_dfs(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t start, data_structures_world_list_node_id_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-void exports_example_data_structures_data_structures_graph_bfs(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_node_id_t start, data_structures_world_list_node_id_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-void exports_example_data_structures_data_structures_graph_connected_components(data_structures_world_string_t *graph_name, data_structures_world_list_list_node_id_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-void exports_example_data_structures_data_structures_graph_minimum_spanning_tree(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_list_edge_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-bool exports_example_data_structures_data_structures_get_graph_stats(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_graph_stats_t *ret) { return false; }
-void exports_example_data_structures_data_structures_serialize_hash_table(data_structures_world_string_t *table_name, exports_example_data_structures_data_structures_serialization_format_t format, exports_example_data_structures_data_structures_serialization_result_t *ret) { ret->success = false; ret->data.is_some = false; ret->size = 0; ret->compression_ratio = 0.0; ret->error.is_some = true; string_to_wit_string(&ret->error.val, "Not implemented"); }
-bool exports_example_data_structures_data_structures_deserialize_hash_table(data_structures_world_string_t *name, data_structures_world_list_u8_t *data, exports_example_data_structures_data_structures_serialization_format_t format) { return false; }
-void exports_example_data_structures_data_structures_serialize_btree(data_structures_world_string_t *tree_name, exports_example_data_structures_data_structures_serialization_format_t format, exports_example_data_structures_data_structures_serialization_result_t *ret) { ret->success = false; ret->data.is_some = false; ret->size = 0; ret->compression_ratio = 0.0; ret->error.is_some = true; string_to_wit_string(&ret->error.val, "Not implemented"); }
-bool exports_example_data_structures_data_structures_deserialize_btree(data_structures_world_string_t *name, data_structures_world_list_u8_t *data, exports_example_data_structures_data_structures_serialization_format_t format) { return false; }
-void exports_example_data_structures_data_structures_serialize_graph(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_serialization_format_t format, exports_example_data_structures_data_structures_serialization_result_t *ret) { ret->success = false; ret->data.is_some = false; ret->size = 0; ret->compression_ratio = 0.0; ret->error.is_some = true; string_to_wit_string(&ret->error.val, "Not implemented"); }
-bool exports_example_data_structures_data_structures_deserialize_graph(data_structures_world_string_t *name, data_structures_world_list_u8_t *data, exports_example_data_structures_data_structures_serialization_format_t format) { return false; }
-void exports_example_data_structures_data_structures_get_memory_stats(exports_example_data_structures_data_structures_memory_stats_t *ret) { ret->total_allocated = 0; ret->total_freed = 0; ret->current_usage = 0; ret->peak_usage = 0; ret->allocation_count = 0; ret->fragmentation_ratio = 0.0; }
-bool exports_example_data_structures_data_structures_defragment_memory(void) { return true; }
-bool exports_example_data_structures_data_structures_set_memory_limit(uint32_t limit_bytes) { return true; }
-uint32_t exports_example_data_structures_data_structures_garbage_collect(void) { return 0; }
-void exports_example_data_structures_data_structures_list_collections(exports_example_data_structures_data_structures_list_collection_info_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-bool exports_example_data_structures_data_structures_collection_exists(data_structures_world_string_t *name) { return false; }
-bool exports_example_data_structures_data_structures_delete_collection(data_structures_world_string_t *name) { return false; }
-bool exports_example_data_structures_data_structures_rename_collection(data_structures_world_string_t *old_name, data_structures_world_string_t *new_name) { return false; }
-bool exports_example_data_structures_data_structures_clone_collection(data_structures_world_string_t *source_name, data_structures_world_string_t *dest_name) { return false; }
-void exports_example_data_structures_data_structures_execute_batch(exports_example_data_structures_data_structures_list_batch_operation_t *operations, exports_example_data_structures_data_structures_batch_result_t *ret) { ret->success = false; ret->results.ptr = nullptr; ret->results.len = 0; ret->error_count = 0; ret->processing_time_ms = 0; }
-exports_example_data_structures_data_structures_transaction_id_t exports_example_data_structures_data_structures_begin_transaction(void) { return 1; }
-bool exports_example_data_structures_data_structures_commit_transaction(exports_example_data_structures_data_structures_transaction_id_t tx_id) { return true; }
-bool exports_example_data_structures_data_structures_rollback_transaction(exports_example_data_structures_data_structures_transaction_id_t tx_id) { return true; }
-bool exports_example_data_structures_data_structures_transaction_put(exports_example_data_structures_data_structures_transaction_id_t tx_id, data_structures_world_string_t *collection, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) { return true; }
-void exports_example_data_structures_data_structures_transaction_get(exports_example_data_structures_data_structures_transaction_id_t tx_id, data_structures_world_string_t *collection, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_hash_result_t *ret) { ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_HASH_RESULT_NOT_FOUND; }
-bool exports_example_data_structures_data_structures_transaction_delete(exports_example_data_structures_data_structures_transaction_id_t tx_id, data_structures_world_string_t *collection, exports_example_data_structures_data_structures_key_type_t *key) { return true; }
-void exports_example_data_structures_data_structures_execute_query(data_structures_world_string_t *collection, data_structures_world_string_t *query, exports_example_data_structures_data_structures_query_result_t *ret) { ret->success = false; ret->rows.ptr = nullptr; ret->rows.len = 0; ret->row_count = 0; ret->execution_time_ms = 0; ret->error.is_some = true; string_to_wit_string(&ret->error.val, "Not implemented"); }
-bool exports_example_data_structures_data_structures_create_index(data_structures_world_string_t *collection, data_structures_world_string_t *field_name, data_structures_world_string_t *index_type) { return false; }
-bool exports_example_data_structures_data_structures_drop_index(data_structures_world_string_t *collection, data_structures_world_string_t *field_name) { return false; }
-void exports_example_data_structures_data_structures_list_indexes(data_structures_world_string_t *collection, data_structures_world_list_string_t *ret) { ret->ptr = nullptr; ret->len = 0; }
-void exports_example_data_structures_data_structures_get_performance_metrics(data_structures_world_string_t *collection, exports_example_data_structures_data_structures_performance_metrics_t *ret) { ret->operations_per_second = 0.0; ret->average_latency_ms = 0.0; ret->memory_efficiency = 0.0; ret->cache_hit_ratio = 0.0; ret->error_rate = 0.0; }
-bool exports_example_data_structures_data_structures_reset_performance_metrics(data_structures_world_string_t *collection) { return true; }
-void exports_example_data_structures_data_structures_get_system_config(exports_example_data_structures_data_structures_system_config_t *ret) { ret->memory_limit = 1024 * 1024 * 100; ret->cache_size = 1024 * 1024 * 10; ret->max_collections = 1000; ret->enable_compression = false; ret->enable_encryption = false; string_to_wit_string(&ret->log_level, "info"); }
-bool exports_example_data_structures_data_structures_update_system_config(exports_example_data_structures_data_structures_system_config_t *config) { return true; }
-bool exports_example_data_structures_data_structures_health_check(void) { return true; }
-bool exports_example_data_structures_data_structures_validate_collection(data_structures_world_string_t *name) { return true; }
-bool exports_example_data_structures_data_structures_repair_collection(data_structures_world_string_t *name) { return true; }
-void exports_example_data_structures_data_structures_export_diagnostics(data_structures_world_list_u8_t *ret) { std::string diag = "System healthy"; ret->len = diag.size(); ret->ptr = static_cast<uint8_t*>(malloc(diag.size())); if (ret->ptr) memcpy(ret->ptr, diag.data(), diag.size()); }
+void exports_example_data_structures_data_structures_serialize_graph(data_structures_world_string_t *graph_name, exports_example_data_structures_data_structures_serialization_format_t format, exports_example_data_structures_data_structures_serialization_result_t *ret) { EXPORT_SCOPE(); ret->success = false; ret->data.is_some = false; ret->size = 0; ret->compression_ratio = 0.0; ret->error.is_some = true; string_to_wit_string(&ret->error.val, "Not implemented"); }
+bool exports_example_data_structures_data_structures_deserialize_graph(data_structures_world_string_t *name, data_structures_world_list_u8_t *data, exports_example_data_structures_data_structures_serialization_format_t format) { EXPORT_SCOPE(); return false; }
+void exports_example_data_structures_data_structures_get_memory_stats(exports_example_data_structures_data_structures_memory_stats_t *ret) { EXPORT_SCOPE(); ret->total_allocated = 0; ret->total_freed = 0; ret->current_usage = 0; ret->peak_usage = 0; ret->allocation_count = 0; ret->fragmentation_ratio = 0.0; }
+bool exports_example_data_structures_data_structures_defragment_memory(void) { EXPORT_SCOPE(); return true; }
+bool exports_example_data_structures_data_structures_set_memory_limit(uint32_t limit_bytes) { EXPORT_SCOPE(); return true; }
+uint32_t exports_example_data_structures_data_structures_garbage_collect(void) { EXPORT_SCOPE(); return 0; }
+void exports_example_data_structures_data_structures_list_collections(exports_example_data_structures_data_structures_list_collection_info_t *ret) { EXPORT_SCOPE(); ret->ptr = nullptr; ret->len = 0; }
+bool exports_example_data_structures_data_structures_collection_exists(data_structures_world_string_t *name) { EXPORT_SCOPE(); return false; }
+bool exports_example_data_structures_data_structures_delete_collection(data_structures_world_string_t *name) { EXPORT_SCOPE(); return false; }
+bool exports_example_data_structures_data_structures_rename_collection(data_structures_world_string_t *old_name, data_structures_world_string_t *new_name) { EXPORT_SCOPE(); return false; }
+bool exports_example_data_structures_data_structures_clone_collection(data_structures_world_string_t *source_name, data_structures_world_string_t *dest_name) { EXPORT_SCOPE(); return false; }
+void exports_example_data_structures_data_structures_execute_batch(exports_example_data_structures_data_structures_list_batch_operation_t *operations, exports_example_data_structures_data_structures_batch_result_t *ret) { EXPORT_SCOPE(); ret->success = false; ret->results.ptr = nullptr; ret->results.len = 0; ret->error_count = 0; ret->processing_time_ms = 0; }
+exports_example_data_structures_data_structures_transaction_id_t exports_example_data_structures_data_structures_begin_transaction(void) { EXPORT_SCOPE(); return 1; }
+bool exports_example_data_structures_data_structures_commit_transaction(exports_example_data_structures_data_structures_transaction_id_t tx_id) { EXPORT_SCOPE(); return true; }
+bool exports_example_data_structures_data_structures_rollback_transaction(exports_example_data_structures_data_structures_transaction_id_t tx_id) { EXPORT_SCOPE(); return true; }
+bool exports_example_data_structures_data_structures_transaction_put(exports_example_data_structures_data_structures_transaction_id_t tx_id, data_structures_world_string_t *collection, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_value_type_t *value) { EXPORT_SCOPE(); return true; }
+void exports_example_data_structures_data_structures_transaction_get(exports_example_data_structures_data_structures_transaction_id_t tx_id, data_structures_world_string_t *collection, exports_example_data_structures_data_structures_key_type_t *key, exports_example_data_structures_data_structures_hash_result_t *ret) { EXPORT_SCOPE(); ret->tag = EXPORTS_EXAMPLE_DATA_STRUCTURES_DATA_STRUCTURES_HASH_RESULT_NOT_FOUND; }
+bool exports_example_data_structures_data_structures_transaction_delete(exports_example_data_structures_data_structures_transaction_id_t tx_id, data_structures_world_string_t *collection, exports_example_data_structures_data_structures_key_type_t *key) { EXPORT_SCOPE(); return true; }
+void exports_example_data_structures_data_structures_execute_query(data_structures_world_string_t *collection, data_structures_world_string_t *query, exports_example_data_structures_data_structures_query_result_t *ret) { EXPORT_SCOPE(); ret->success = false; ret->rows.ptr = nullptr; ret->rows.len = 0; ret->row_count = 0; ret->execution_time_ms = 0; ret->error.is_some = true; string_to_wit_string(&ret->error.val, "Not implemented"); }
+bool exports_example_data_structures_data_structures_create_index(data_structures_world_string_t *collection, data_structures_world_string_t *field_name, data_structures_world_string_t *index_type) { EXPORT_SCOPE(); return false; }
+bool exports_example_data_structures_data_structures_drop_index(data_structures_world_string_t *collection, data_structures_world_string_t *field_name) { EXPORT_SCOPE(); return false; }
+void exports_example_data_structures_data_structures_list_indexes(data_structures_world_string_t *collection, data_structures_world_list_string_t *ret) { EXPORT_SCOPE(); ret->ptr = nullptr; ret->len = 0; }
+void exports_example_data_structures_data_structures_get_performance_metrics(data_structures_world_string_t *collection, exports_example_data_structures_data_structures_performance_metrics_t *ret) { EXPORT_SCOPE(); ret->operations_per_second = 0.0; ret->average_latency_ms = 0.0; ret->memory_efficiency = 0.0; ret->cache_hit_ratio = 0.0; ret->error_rate = 0.0; }
+bool exports_example_data_structures_data_structures_reset_performance_metrics(data_structures_world_string_t *collection) { EXPORT_SCOPE(); return true; }
+void exports_example_data_structures_data_structures_get_system_config(exports_example_data_structures_data_structures_system_config_t *ret) { EXPORT_SCOPE(); ret->memory_limit = 1024 * 1024 * 100; ret->cache_size = 1024 * 1024 * 10; ret->max_collections = 1000; ret->enable_compression = false; ret->enable_encryption = false; string_to_wit_string(&ret->log_level, "info"); }
+bool exports_example_data_structures_data_structures_update_system_config(exports_example_data_structures_data_structures_system_config_t *config) { EXPORT_SCOPE(); return true; }
+bool exports_example_data_structures_data_structures_health_check(void) { EXPORT_SCOPE(); return true; }
+bool exports_example_data_structures_data_structures_validate_collection(data_structures_world_string_t *name) { EXPORT_SCOPE(); return true; }
+bool exports_example_data_structures_data_structures_repair_collection(data_structures_world_string_t *name) { EXPORT_SCOPE(); return true; }
+void exports_example_data_structures_data_structures_export_diagnostics(data_structures_world_list_u8_t *ret) { EXPORT_SCOPE(); std::string diag = "System healthy"; ret->len = diag.size(); ret->ptr = static_cast<uint8_t*>(malloc(diag.size())); if (ret->ptr) memcpy(ret->ptr, diag.data(), diag.size()); }
 
 } // extern "C"
 
@@ -4,10 +4,16 @@
 #include <vector>
 #include <unordered_map>
 #include <map>
+#include <set>
 #include <memory>
 #include <chrono>
 #include <optional>
 
+#include "bloom_filter.h"
+#include "btree.h"
+#include "graph.h"
+#include "serializer.h"
+
 namespace data_structures {
 
 // Simple implementations of core data structures for testing/example purposes
@@ -19,18 +25,30 @@ private:
     uint64_t created_time_;
     uint32_t collision_count_ = 0;
     uint32_t resize_count_ = 0;
+    uint32_t bloom_bits_per_key_;
+    BlockedBloomFilter filter_;  // Optional; answers most misses without a probe
+
+    bool definitely_absent(const std::string& key) const;
+    void filter_insert(const std::string& key);
+    void filter_remove();
+    void rebuild_filter();
 
 public:
-    explicit SimpleHashTable(const std::string& name);
+    // bloom_bits_per_key > 0 fronts lookups with a blocked Bloom filter
+    explicit SimpleHashTable(const std::string& name, uint32_t bloom_bits_per_key = 0,
+                             size_t expected_keys = 0);
 
     bool put(const std::string& key, const std::vector<uint8_t>& value);
+    bool put(std::string&& key, std::vector<uint8_t>&& value);
     std::optional<std::vector<uint8_t>> get(const std::string& key);
+    const std::vector<uint8_t>* find(const std::string& key) const;  // No copy of the value
     bool remove(const std::string& key);
     bool contains(const std::string& key);
     void clear();
     std::vector<std::string> keys();
     std::vector<std::vector<uint8_t>> values();
     uint32_t size() const;
+    void reserve(size_t entries);  // Pre-size buckets ahead of a batch
 
     // Stats
     uint32_t capacity() const;
@@ -38,22 +56,51 @@ public:
     uint32_t collision_count() const;
     uint32_t resize_count() const;
     uint32_t memory_usage() const;
+    uint32_t bloom_bits_per_key() const { return bloom_bits_per_key_; }
+    // Binary snapshot (serializer.h); write_snapshot fills snapshot_size() bytes
+    size_t snapshot_size(size_t* payload_bytes = nullptr) const;  // 0 if too large
+    bool write_snapshot(uint8_t* buffer) const;
+    bool load_snapshot(const SnapshotView& snapshot);
 };
 
 class SimpleBTree {
+public:
+    using Tree = BPlusTree<std::string, std::vector<uint8_t>>;
+
 private:
-    std::map<std::string, std::vector<uint8_t>> data_; // Using std::map as simple ordered container
+    Tree tree_;  // Cache-line sized B+tree nodes with linked leaves
     std::string name_;
     uint64_t created_time_;
+    uint32_t bloom_bits_per_key_;
+    BlockedBloomFilter filter_;  // Optional; answers most misses without a descent
+
+    bool definitely_absent(const std::string& key) const;
+    void filter_insert(const std::string& key);
+    void filter_remove();
+    void rebuild_filter();
 
 public:
-    explicit SimpleBTree(const std::string& name);
+    // bloom_bits_per_key > 0 fronts searches with a blocked Bloom filter
+    explicit SimpleBTree(const std::string& name, uint32_t bloom_bits_per_key = 0);
+    // Bulk load from pairs sorted by key (unsorted input is still accepted)
+    SimpleBTree(const std::string& name,
+                const std::vector<std::pair<std::string, std::vector<uint8_t>>>& sorted_pairs,
+                uint32_t bloom_bits_per_key = 0);
 
     bool insert(const std::string& key, const std::vector<uint8_t>& value);
+    // Replace the contents with strictly ascending entries (see BPlusTree::assign_sorted)
+    template<typename Fill>
+    bool assign_sorted(size_t count, Fill fill) {
+        bool loaded = tree_.assign_sorted(count, fill);
+        rebuild_filter();
+        return loaded;
+    }
     std::optional<std::vector<uint8_t>> search(const std::string& key);
     bool remove(const std::string& key);
     std::vector<std::pair<std::string, std::vector<uint8_t>>> range_query(
         const std::string& start_key, const std::string& end_key);
+    // Streaming view over [start_key, end_key]; iterates leaves in place
+    Tree::Range range(const std::string& start_key, const std::string& end_key) const;
 
     std::optional<std::string> min_key();
     std::optional<std::string> max_key();
@@ -64,7 +111,14 @@ public:
     uint32_t height() const;
     uint32_t node_count() const;
     uint32_t key_count() const;
+    uint32_t internal_node_count() const;
+    uint32_t leaf_node_count() const;
     uint32_t memory_usage() const;
+    uint32_t bloom_bits_per_key() const { return bloom_bits_per_key_; }
+    // Binary snapshot (serializer.h); write_snapshot fills snapshot_size() bytes
+    size_t snapshot_size(size_t* payload_bytes = nullptr) const;  // 0 if too large
+    bool write_snapshot(uint8_t* buffer) const;
+    bool load_snapshot(const SnapshotView& snapshot);
 };
 
 struct SimpleEdge {
@@ -74,16 +128,37 @@ struct SimpleEdge {
     std::vector<uint8_t> data;
 };
 
+struct SimplePath {
+    bool exists;
+    double distance;
+    std::vector<uint64_t> nodes;
+};
+
 class SimpleGraph {
 private:
     std::unordered_map<uint64_t, std::vector<uint8_t>> nodes_;
     std::vector<SimpleEdge> edges_;
+    std::set<std::pair<uint64_t, uint64_t>> edge_keys_;  // Only kept when parallel edges are refused
     std::string name_;
     bool directed_;
+    bool allow_self_loops_;
+    bool allow_parallel_edges_;
     uint64_t created_time_;
 
+    // CSR snapshot over dense indices, rebuilt on the first query after a mutation
+    mutable CSRGraph csr_;
+    mutable std::vector<uint64_t> index_to_id_;
+    mutable std::unordered_map<uint64_t, uint32_t> id_to_index_;
+    mutable bool csr_dirty_ = true;
+
+    const CSRGraph& frozen() const;
+    bool index_of(uint64_t node_id, uint32_t& index) const;
+    std::vector<uint64_t> to_ids(const std::vector<uint32_t>& indices) const;
+    std::pair<uint64_t, uint64_t> edge_key(uint64_t source, uint64_t target) const;
+
 public:
-    explicit SimpleGraph(const std::string& name, bool directed = true);
+    explicit SimpleGraph(const std::string& name, bool directed = true,
+                         bool allow_self_loops = true, bool allow_parallel_edges = true);
 
     bool add_node(uint64_t node_id, const std::vector<uint8_t>& data = {});
     bool remove_node(uint64_t node_id);
@@ -96,15 +171,21 @@ public:
     std::vector<uint64_t> get_neighbors(uint64_t node_id);
     std::vector<SimpleEdge> get_edges(uint64_t node_id);
 
-    // Simplified algorithms
+    // Algorithms (run over the CSR snapshot)
     std::vector<uint64_t> dfs(uint64_t start);
     std::vector<uint64_t> bfs(uint64_t start);
     std::vector<uint64_t> shortest_path(uint64_t start, uint64_t end);
+    SimplePath find_path(uint64_t start, uint64_t end);  // Dijkstra, with distance
+    std::vector<std::vector<uint64_t>> connected_components();
+    std::vector<SimpleEdge> minimum_spanning_tree();
+    bool is_connected();
+    bool has_cycles();
 
     // Stats
     uint32_t node_count() const;
     uint32_t edge_count() const;
     double density() const;
+    double average_degree() const;
     uint32_t memory_usage() const;
 };
 
@@ -0,0 +1,381 @@
+#include "graph.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace data_structures {
+
+namespace {
+
+constexpr uint32_t NO_NODE = std::numeric_limits<uint32_t>::max();
+
+// Union-find with path halving and union by size
+class DisjointSet {
+public:
+    explicit DisjointSet(uint32_t count) : parent_(count), size_(count, 1) {
+        for (uint32_t i = 0; i < count; ++i) {
+            parent_[i] = i;
+        }
+    }
+
+    uint32_t find(uint32_t x) {
+        while (parent_[x] != x) {
+            parent_[x] = parent_[parent_[x]];
+            x = parent_[x];
+        }
+        return x;
+    }
+
+    // False if already in the same set
+    bool unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (size_[a] < size_[b]) std::swap(a, b);
+        parent_[b] = a;
+        size_[a] += size_[b];
+        return true;
+    }
+
+private:
+    std::vector<uint32_t> parent_;
+    std::vector<uint32_t> size_;
+};
+
+// Monotone radix heap keyed by the bit pattern of a non-negative double.
+// IEEE-754 ordering of non-negative doubles matches their unsigned bit
+// patterns, and Dijkstra only ever pushes keys >= the last popped key.
+class RadixHeap {
+public:
+    bool empty() const { return size_ == 0; }
+
+    void push(double distance, uint32_t node) {
+        uint64_t key = to_key(distance);
+        buckets_[bucket_for(key)].push_back({key, node});
+        size_++;
+    }
+
+    // Returns the node with the smallest key; caller checks empty() first
+    uint32_t pop(double& distance) {
+        if (buckets_[0].empty()) {
+            size_t i = 1;
+            while (buckets_[i].empty()) {
+                i++;
+            }
+            // Everything in bucket i shares a higher prefix with the new
+            // minimum, so it always redistributes into lower buckets
+            uint64_t minimum = buckets_[i][0].first;
+            for (const auto& item : buckets_[i]) {
+                minimum = std::min(minimum, item.first);
+            }
+            last_ = minimum;
+            for (const auto& item : buckets_[i]) {
+                buckets_[bucket_for(item.first)].push_back(item);
+            }
+            buckets_[i].clear();
+        }
+
+        auto top = buckets_[0].back();
+        buckets_[0].pop_back();
+        size_--;
+        std::memcpy(&distance, &top.first, sizeof(distance));
+        return top.second;
+    }
+
+private:
+    std::vector<std::pair<uint64_t, uint32_t>> buckets_[65];
+    uint64_t last_ = 0;
+    size_t size_ = 0;
+
+    static uint64_t to_key(double distance) {
+        uint64_t key;
+        std::memcpy(&key, &distance, sizeof(key));
+        return key;
+    }
+
+    size_t bucket_for(uint64_t key) const {
+        return key == last_ ? 0 : 64 - static_cast<size_t>(__builtin_clzll(key ^ last_));
+    }
+};
+
+} // namespace
+
+void CSRGraph::build(uint32_t node_count, const std::vector<CSRInputEdge>& edges, bool directed) {
+    directed_ = directed;
+    has_negative_weight_ = false;
+
+    size_t arcs = directed ? edges.size() : edges.size() * 2;
+    std::vector<CSRInputEdge> by_target(arcs);
+    std::vector<uint32_t> counts(node_count + 1, 0);
+
+    // Two stable counting sorts (target, then source) leave every row sorted
+    // by target in O(V + E), without a comparison sort per row
+    auto for_each_arc = [&](auto&& visit) {
+        for (const auto& edge : edges) {
+            visit(edge);
+            if (!directed) {
+                visit(CSRInputEdge{edge.target, edge.source, edge.weight, edge.edge_id});
+            }
+        }
+    };
+
+    for_each_arc([&](const CSRInputEdge& arc) {
+        counts[arc.target + 1]++;
+        if (!(arc.weight >= 0.0)) {
+            has_negative_weight_ = true;
+        }
+    });
+    for (uint32_t i = 0; i < node_count; ++i) {
+        counts[i + 1] += counts[i];
+    }
+    for_each_arc([&](const CSRInputEdge& arc) {
+        by_target[counts[arc.target]++] = arc;
+    });
+
+    offsets_.assign(node_count + 1, 0);
+    for (const auto& arc : by_target) {
+        offsets_[arc.source + 1]++;
+    }
+    for (uint32_t i = 0; i < node_count; ++i) {
+        offsets_[i + 1] += offsets_[i];
+    }
+
+    targets_.resize(arcs);
+    weights_.resize(arcs);
+    edge_ids_.resize(arcs);
+    std::vector<uint32_t> cursor(offsets_.begin(), offsets_.end() - 1);
+    for (const auto& arc : by_target) {
+        uint32_t slot = cursor[arc.source]++;
+        targets_[slot] = arc.target;
+        weights_[slot] = arc.weight;
+        edge_ids_[slot] = arc.edge_id;
+    }
+}
+
+void CSRGraph::clear() {
+    offsets_.clear();
+    targets_.clear();
+    weights_.clear();
+    edge_ids_.clear();
+    has_negative_weight_ = false;
+}
+
+CSRGraph::Neighbors CSRGraph::neighbors(uint32_t node) const {
+    if (node >= node_count()) {
+        return {nullptr, nullptr, nullptr, 0};
+    }
+    uint32_t begin = offsets_[node];
+    return {targets_.data() + begin, weights_.data() + begin, edge_ids_.data() + begin,
+            offsets_[node + 1] - begin};
+}
+
+bool CSRGraph::has_arc(uint32_t source, uint32_t target) const {
+    Neighbors row = neighbors(source);
+    return std::binary_search(row.targets, row.targets + row.size, target);
+}
+
+std::vector<uint32_t> CSRGraph::bfs(uint32_t source) const {
+    std::vector<uint32_t> order;
+    if (source >= node_count()) return order;
+
+    std::vector<bool> visited(node_count(), false);
+    order.reserve(node_count());
+    order.push_back(source);
+    visited[source] = true;
+
+    // The output doubles as the FIFO queue
+    for (size_t head = 0; head < order.size(); ++head) {
+        Neighbors row = neighbors(order[head]);
+        for (uint32_t i = 0; i < row.size; ++i) {
+            uint32_t next = row.targets[i];
+            if (!visited[next]) {
+                visited[next] = true;
+                order.push_back(next);
+            }
+        }
+    }
+    return order;
+}
+
+std::vector<uint32_t> CSRGraph::dfs(uint32_t source) const {
+    std::vector<uint32_t> order;
+    if (source >= node_count()) return order;
+
+    std::vector<bool> visited(node_count(), false);
+    std::vector<uint32_t> stack;
+    stack.push_back(source);
+
+    while (!stack.empty()) {
+        uint32_t node = stack.back();
+        stack.pop_back();
+        if (visited[node]) continue;
+        visited[node] = true;
+        order.push_back(node);
+
+        // Push in reverse so the smallest neighbor is explored first, as recursion would
+        Neighbors row = neighbors(node);
+        for (uint32_t i = row.size; i-- > 0;) {
+            if (!visited[row.targets[i]]) {
+                stack.push_back(row.targets[i]);
+            }
+        }
+    }
+    return order;
+}
+
+bool CSRGraph::shortest_path(uint32_t source, uint32_t target,
+                             double& distance, std::vector<uint32_t>& path) const {
+    path.clear();
+    distance = 0.0;
+    if (source >= node_count() || target >= node_count() || has_negative_weight_) {
+        return false;
+    }
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> best(node_count(), infinity);
+    std::vector<uint32_t> parent(node_count(), NO_NODE);
+    RadixHeap heap;
+
+    best[source] = 0.0;
+    heap.push(0.0, source);
+
+    while (!heap.empty()) {
+        double current;
+        uint32_t node = heap.pop(current);
+        if (current > best[node]) continue;  // Stale entry
+        if (node == target) break;
+
+        Neighbors row = neighbors(node);
+        for (uint32_t i = 0; i < row.size; ++i) {
+            double candidate = current + row.weights[i];
+            uint32_t next = row.targets[i];
+            if (candidate < best[next]) {
+                best[next] = candidate;
+                parent[next] = node;
+                heap.push(candidate, next);
+            }
+        }
+    }
+
+    if (best[target] == infinity) {
+        return false;
+    }
+
+    for (uint32_t node = target; node != NO_NODE; node = parent[node]) {
+        path.push_back(node);
+    }
+    std::reverse(path.begin(), path.end());
+    distance = best[target];
+    return true;
+}
+
+std::vector<std::vector<uint32_t>> CSRGraph::connected_components() const {
+    DisjointSet sets(node_count());
+    for (uint32_t node = 0; node < node_count(); ++node) {
+        Neighbors row = neighbors(node);
+        for (uint32_t i = 0; i < row.size; ++i) {
+            sets.unite(node, row.targets[i]);
+        }
+    }
+
+    // Scanning nodes in order keeps each component sorted and the list
+    // ordered by smallest member
+    std::vector<std::vector<uint32_t>> components;
+    std::vector<uint32_t> component_of_root(node_count(), NO_NODE);
+    for (uint32_t node = 0; node < node_count(); ++node) {
+        uint32_t root = sets.find(node);
+        if (component_of_root[root] == NO_NODE) {
+            component_of_root[root] = static_cast<uint32_t>(components.size());
+            components.emplace_back();
+        }
+        components[component_of_root[root]].push_back(node);
+    }
+    return components;
+}
+
+std::vector<uint32_t> CSRGraph::minimum_spanning_forest() const {
+    struct Candidate {
+        double weight;
+        uint32_t edge_id;
+        uint32_t source;
+        uint32_t target;
+    };
+
+    // Undirected edges appear as two arcs; keep the source <= target copy
+    std::vector<Candidate> candidates;
+    candidates.reserve(directed_ ? arc_count() : arc_count() / 2);
+    for (uint32_t node = 0; node < node_count(); ++node) {
+        Neighbors row = neighbors(node);
+        for (uint32_t i = 0; i < row.size; ++i) {
+            uint32_t next = row.targets[i];
+            if (next == node || (!directed_ && next < node)) continue;
+            candidates.push_back({row.weights[i], row.edge_ids[i], node, next});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.weight < b.weight || (a.weight == b.weight && a.edge_id < b.edge_id);
+    });
+
+    std::vector<uint32_t> forest;
+    DisjointSet sets(node_count());
+    for (const auto& candidate : candidates) {
+        if (sets.unite(candidate.source, candidate.target)) {
+            forest.push_back(candidate.edge_id);
+            if (forest.size() + 1 == node_count()) break;
+        }
+    }
+    return forest;
+}
+
+bool CSRGraph::has_cycle() const {
+    if (!directed_) {
+        // An edge inside an existing component closes a cycle; a self loop is one
+        DisjointSet sets(node_count());
+        for (uint32_t node = 0; node < node_count(); ++node) {
+            Neighbors row = neighbors(node);
+            for (uint32_t i = 0; i < row.size; ++i) {
+                uint32_t next = row.targets[i];
+                if (next == node) return true;
+                if (next < node) continue;  // Mirror arc of an edge already seen
+                if (!sets.unite(node, next)) return true;
+            }
+        }
+        return false;
+    }
+
+    // Directed: iterative three-color DFS looking for a back edge
+    enum Color : uint8_t { WHITE, GRAY, BLACK };
+    std::vector<uint8_t> color(node_count(), WHITE);
+    std::vector<std::pair<uint32_t, uint32_t>> stack;  // (node, next arc in row)
+
+    for (uint32_t root = 0; root < node_count(); ++root) {
+        if (color[root] != WHITE) continue;
+        color[root] = GRAY;
+        stack.push_back({root, 0});
+
+        while (!stack.empty()) {
+            auto& frame = stack.back();
+            Neighbors row = neighbors(frame.first);
+            if (frame.second == row.size) {
+                color[frame.first] = BLACK;
+                stack.pop_back();
+                continue;
+            }
+            uint32_t next = row.targets[frame.second++];
+            if (color[next] == GRAY) return true;
+            if (color[next] == WHITE) {
+                color[next] = GRAY;
+                stack.push_back({next, 0});
+            }
+        }
+    }
+    return false;
+}
+
+size_t CSRGraph::memory_usage() const {
+    return sizeof(*this) +
+           (offsets_.capacity() + targets_.capacity() + edge_ids_.capacity()) * sizeof(uint32_t) +
+           weights_.capacity() * sizeof(double);
+}
+
+} // namespace data_structures
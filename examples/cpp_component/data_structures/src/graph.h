@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace data_structures {
+
+/**
+ * Immutable compressed-sparse-row adjacency, optimized for WebAssembly.
+ *
+ * Nodes are dense indices [0, node_count). The arcs leaving node u occupy
+ * [offsets[u], offsets[u + 1]) of three parallel arrays (target, weight,
+ * edge id), sorted by target, so a neighbor walk is a linear scan over
+ * contiguous memory and an arc lookup is a binary search within one row.
+ * Undirected edges are stored as two arcs sharing an edge id.
+ */
+
+// Edge fed to CSRGraph::build; edge_id is echoed back by the algorithms
+struct CSRInputEdge {
+    uint32_t source;
+    uint32_t target;
+    double weight;
+    uint32_t edge_id;
+};
+
+class CSRGraph {
+public:
+    // Contiguous view of one adjacency row
+    struct Neighbors {
+        const uint32_t* targets;
+        const double* weights;
+        const uint32_t* edge_ids;
+        uint32_t size;
+    };
+
+    CSRGraph() : directed_(true), has_negative_weight_(false) {}
+
+    void build(uint32_t node_count, const std::vector<CSRInputEdge>& edges, bool directed);
+    void clear();
+
+    uint32_t node_count() const { return offsets_.empty() ? 0 : static_cast<uint32_t>(offsets_.size() - 1); }
+    size_t arc_count() const { return targets_.size(); }
+    bool directed() const { return directed_; }
+
+    Neighbors neighbors(uint32_t node) const;
+    bool has_arc(uint32_t source, uint32_t target) const;
+
+    // Traversals return dense indices in visit order; out-of-range sources yield nothing
+    std::vector<uint32_t> bfs(uint32_t source) const;
+    std::vector<uint32_t> dfs(uint32_t source) const;
+
+    // Dijkstra over a radix heap; false if unreachable or a negative weight is seen
+    bool shortest_path(uint32_t source, uint32_t target,
+                       double& distance, std::vector<uint32_t>& path) const;
+
+    // Weakly connected components, each sorted, ordered by smallest member
+    std::vector<std::vector<uint32_t>> connected_components() const;
+
+    // Kruskal minimum spanning forest (arcs treated as undirected); edge ids
+    std::vector<uint32_t> minimum_spanning_forest() const;
+
+    bool has_cycle() const;
+    size_t memory_usage() const;
+
+private:
+    bool directed_;
+    bool has_negative_weight_;  // Dijkstra refuses these graphs
+    std::vector<uint32_t> offsets_;
+    std::vector<uint32_t> targets_;
+    std::vector<double> weights_;
+    std::vector<uint32_t> edge_ids_;
+};
+
+} // namespace data_structures
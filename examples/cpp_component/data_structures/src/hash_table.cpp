@@ -0,0 +1,648 @@
+#include "hash_table.h"
+#include <cstring>
+
+#ifdef __wasm_simd128__
+#include <wasm_simd128.h>
+#endif
+
+namespace data_structures {
+
+namespace {
+
+inline uint64_t read_u64(const uint8_t* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t read_u32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t rotr64(uint64_t x, int r) {
+    return r == 0 ? x : (x >> r) | (x << (64 - r));
+}
+
+inline uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// xxHash64 primes
+constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t xxh64_round(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+inline uint64_t xxh64_merge_round(uint64_t acc, uint64_t val) {
+    acc ^= xxh64_round(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+// CityHash64 constants
+constexpr uint64_t CITY_K0 = 0xc3a5c85c97cb3127ULL;
+constexpr uint64_t CITY_K1 = 0xb492b66fbe98f273ULL;
+constexpr uint64_t CITY_K2 = 0x9ae16a3b2f90404fULL;
+constexpr uint64_t CITY_KMUL = 0x9ddfea08eb382d69ULL;
+
+inline uint64_t city_shift_mix(uint64_t val) {
+    return val ^ (val >> 47);
+}
+
+inline uint64_t city_hash_len16(uint64_t u, uint64_t v, uint64_t mul) {
+    uint64_t a = (u ^ v) * mul;
+    a ^= (a >> 47);
+    uint64_t b = (v ^ a) * mul;
+    b ^= (b >> 47);
+    return b * mul;
+}
+
+uint64_t city_hash_len0to16(const uint8_t* s, size_t len) {
+    if (len >= 8) {
+        uint64_t mul = CITY_K2 + len * 2;
+        uint64_t a = read_u64(s) + CITY_K2;
+        uint64_t b = read_u64(s + len - 8);
+        uint64_t c = rotr64(b, 37) * mul + a;
+        uint64_t d = (rotr64(a, 25) + b) * mul;
+        return city_hash_len16(c, d, mul);
+    }
+    if (len >= 4) {
+        uint64_t mul = CITY_K2 + len * 2;
+        uint64_t a = read_u32(s);
+        return city_hash_len16(len + (a << 3), read_u32(s + len - 4), mul);
+    }
+    if (len > 0) {
+        uint8_t a = s[0];
+        uint8_t b = s[len >> 1];
+        uint8_t c = s[len - 1];
+        uint32_t y = static_cast<uint32_t>(a) + (static_cast<uint32_t>(b) << 8);
+        uint32_t z = static_cast<uint32_t>(len) + (static_cast<uint32_t>(c) << 2);
+        return city_shift_mix(y * CITY_K2 ^ z * CITY_K0) * CITY_K2;
+    }
+    return CITY_K2;
+}
+
+uint64_t city_hash_len17to32(const uint8_t* s, size_t len) {
+    uint64_t mul = CITY_K2 + len * 2;
+    uint64_t a = read_u64(s) * CITY_K1;
+    uint64_t b = read_u64(s + 8);
+    uint64_t c = read_u64(s + len - 8) * mul;
+    uint64_t d = read_u64(s + len - 16) * CITY_K2;
+    return city_hash_len16(rotr64(a + b, 43) + rotr64(c, 30) + d,
+                           a + rotr64(b + CITY_K2, 18) + c, mul);
+}
+
+uint64_t city_hash_len33to64(const uint8_t* s, size_t len) {
+    uint64_t mul = CITY_K2 + len * 2;
+    uint64_t a = read_u64(s) * CITY_K2;
+    uint64_t b = read_u64(s + 8);
+    uint64_t c = read_u64(s + len - 24);
+    uint64_t d = read_u64(s + len - 32);
+    uint64_t e = read_u64(s + 16) * CITY_K2;
+    uint64_t f = read_u64(s + 24) * 9;
+    uint64_t g = read_u64(s + len - 8);
+    uint64_t h = read_u64(s + len - 16) * mul;
+    uint64_t u = rotr64(a + g, 43) + (rotr64(b, 30) + c) * 9;
+    uint64_t v = ((a + g) ^ d) + f + 1;
+    uint64_t w = __builtin_bswap64((u + v) * mul) + h;
+    uint64_t x = rotr64(e + f, 42) + c;
+    uint64_t y = (__builtin_bswap64((v + w) * mul) + g) * mul;
+    uint64_t z = e + f + c;
+    a = __builtin_bswap64((x + z) * mul + y) + b;
+    b = city_shift_mix((z + a) * mul + d + h) * mul;
+    return b + x;
+}
+
+struct CityPair {
+    uint64_t first;
+    uint64_t second;
+};
+
+inline CityPair city_weak_hash_len32_with_seeds(const uint8_t* s, uint64_t a, uint64_t b) {
+    uint64_t w = read_u64(s);
+    uint64_t x = read_u64(s + 8);
+    uint64_t y = read_u64(s + 16);
+    uint64_t z = read_u64(s + 24);
+    a += w;
+    b = rotr64(b + a + z, 21);
+    uint64_t c = a;
+    a += x;
+    a += y;
+    b += rotr64(a, 44);
+    return {a + z, b + c};
+}
+
+// SipHash-2-4 round
+inline void sip_round(uint64_t& v0, uint64_t& v1, uint64_t& v2, uint64_t& v3) {
+    v0 += v1; v1 = rotl64(v1, 13); v1 ^= v0; v0 = rotl64(v0, 32);
+    v2 += v3; v3 = rotl64(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotl64(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotl64(v1, 17); v1 ^= v2; v2 = rotl64(v2, 32);
+}
+
+// Wide hash: 192-byte secret filled by splitmix64 at compile time
+constexpr size_t WIDE_SECRET_SIZE = 192;
+constexpr size_t WIDE_STRIPE = 64;
+constexpr size_t WIDE_STRIPES_PER_BLOCK = (WIDE_SECRET_SIZE - WIDE_STRIPE) / 8;
+constexpr uint64_t WIDE_PRIME32_1 = 0x9E3779B1ULL;
+
+struct WideSecret {
+    uint8_t bytes[WIDE_SECRET_SIZE];
+
+    constexpr WideSecret() : bytes() {
+        uint64_t state = 0x243F6A8885A308D3ULL;  // Digits of pi
+        for (size_t i = 0; i < WIDE_SECRET_SIZE; i += 8) {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            z ^= z >> 31;
+            for (size_t b = 0; b < 8; ++b) {
+                bytes[i + b] = static_cast<uint8_t>(z >> (8 * b));
+            }
+        }
+    }
+};
+
+constexpr WideSecret WIDE_SECRET{};
+
+// Low xor high half of the 128-bit product; wasm32 has no wide multiply,
+// so it is spelled out in 32-bit halves there
+inline uint64_t wide_fold64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__) && !defined(__wasm__)
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+    return lower ^ upper;
+#endif
+}
+
+inline uint64_t wide_avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t wide_mix16(const uint8_t* p, const uint8_t* secret, uint64_t seed) {
+    return wide_fold64(read_u64(p) ^ (read_u64(secret) + seed),
+                       read_u64(p + 8) ^ (read_u64(secret + 8) - seed));
+}
+
+// One 64-byte stripe into eight 64-bit lanes:
+// acc[i] += lo32(d ^ k) * hi32(d ^ k), acc[i ^ 1] += d
+inline void wide_accumulate(uint64_t* acc, const uint8_t* p, const uint8_t* secret) {
+#ifdef __wasm_simd128__
+    for (size_t j = 0; j < 4; ++j) {
+        v128_t data = wasm_v128_load(p + 16 * j);
+        v128_t key = wasm_v128_xor(data, wasm_v128_load(secret + 16 * j));
+        v128_t product = wasm_u64x2_extmul_low_u32x4(wasm_i32x4_shuffle(key, key, 0, 2, 0, 2),
+                                                     wasm_i32x4_shuffle(key, key, 1, 3, 1, 3));
+        v128_t lanes = wasm_v128_load(acc + 2 * j);
+        lanes = wasm_i64x2_add(lanes, wasm_i64x2_add(product, wasm_i64x2_shuffle(data, data, 1, 0)));
+        wasm_v128_store(acc + 2 * j, lanes);
+    }
+#else
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t data = read_u64(p + 8 * i);
+        uint64_t key = data ^ read_u64(secret + 8 * i);
+        acc[i ^ 1] += data;
+        acc[i] += (key & 0xFFFFFFFFULL) * (key >> 32);
+    }
+#endif
+}
+
+inline void wide_scramble(uint64_t* acc, const uint8_t* secret) {
+#ifdef __wasm_simd128__
+    const v128_t prime = wasm_i64x2_splat(static_cast<int64_t>(WIDE_PRIME32_1));
+    for (size_t j = 0; j < 4; ++j) {
+        v128_t lanes = wasm_v128_load(acc + 2 * j);
+        lanes = wasm_v128_xor(lanes, wasm_u64x2_shr(lanes, 47));
+        lanes = wasm_v128_xor(lanes, wasm_v128_load(secret + 16 * j));
+        wasm_v128_store(acc + 2 * j, wasm_i64x2_mul(lanes, prime));
+    }
+#else
+    for (size_t i = 0; i < 8; ++i) {
+        uint64_t lane = acc[i];
+        lane ^= lane >> 47;
+        lane ^= read_u64(secret + 8 * i);
+        acc[i] = lane * WIDE_PRIME32_1;
+    }
+#endif
+}
+
+uint64_t wide_hash_long(const uint8_t* p, size_t len, uint64_t seed) {
+    const uint8_t* secret = WIDE_SECRET.bytes;
+    uint64_t acc[8] = {
+        0xC2B2AE3DULL + seed, XXH_PRIME64_1 - seed, XXH_PRIME64_2 + seed, XXH_PRIME64_3 - seed,
+        XXH_PRIME64_4 + seed, 0x85EBCA77ULL - seed, XXH_PRIME64_5 + seed, WIDE_PRIME32_1 - seed
+    };
+
+    const size_t block_len = WIDE_STRIPE * WIDE_STRIPES_PER_BLOCK;
+    const size_t blocks = (len - 1) / block_len;
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t s = 0; s < WIDE_STRIPES_PER_BLOCK; ++s) {
+            wide_accumulate(acc, p + b * block_len + s * WIDE_STRIPE, secret + s * 8);
+        }
+        wide_scramble(acc, secret + WIDE_SECRET_SIZE - WIDE_STRIPE);
+    }
+
+    const size_t stripes = ((len - 1) - blocks * block_len) / WIDE_STRIPE;
+    for (size_t s = 0; s < stripes; ++s) {
+        wide_accumulate(acc, p + blocks * block_len + s * WIDE_STRIPE, secret + s * 8);
+    }
+    // Last stripe, overlapping the previous one
+    wide_accumulate(acc, p + len - WIDE_STRIPE, secret + WIDE_SECRET_SIZE - WIDE_STRIPE - 7);
+
+    uint64_t h = static_cast<uint64_t>(len) * XXH_PRIME64_1;
+    for (size_t i = 0; i < 4; ++i) {
+        h += wide_fold64(acc[2 * i] ^ read_u64(secret + 11 + 16 * i),
+                         acc[2 * i + 1] ^ read_u64(secret + 19 + 16 * i));
+    }
+    return wide_avalanche(h);
+}
+
+} // namespace
+
+// FNV-1a
+
+uint64_t HashFunctions::fnv1a_hash(const void* data, size_t len) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t HashFunctions::fnv1a_hash(const std::string& str) {
+    return fnv1a_hash(str.data(), str.size());
+}
+
+// MurmurHash3 (x64_128 variant, low 64 bits)
+
+uint64_t HashFunctions::murmur3_hash(const void* data, size_t len, uint32_t seed) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    const size_t nblocks = len / 16;
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    for (size_t i = 0; i < nblocks; ++i) {
+        uint64_t k1 = read_u64(bytes + i * 16);
+        uint64_t k2 = read_u64(bytes + i * 16 + 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const uint8_t* tail = bytes + nblocks * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    switch (len & 15) {
+        case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; [[fallthrough]];
+        case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; [[fallthrough]];
+        case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; [[fallthrough]];
+        case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; [[fallthrough]];
+        case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; [[fallthrough]];
+        case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8; [[fallthrough]];
+        case 9:
+            k2 ^= static_cast<uint64_t>(tail[8]);
+            k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+            [[fallthrough]];
+        case 8: k1 ^= static_cast<uint64_t>(tail[7]) << 56; [[fallthrough]];
+        case 7: k1 ^= static_cast<uint64_t>(tail[6]) << 48; [[fallthrough]];
+        case 6: k1 ^= static_cast<uint64_t>(tail[5]) << 40; [[fallthrough]];
+        case 5: k1 ^= static_cast<uint64_t>(tail[4]) << 32; [[fallthrough]];
+        case 4: k1 ^= static_cast<uint64_t>(tail[3]) << 24; [[fallthrough]];
+        case 3: k1 ^= static_cast<uint64_t>(tail[2]) << 16; [[fallthrough]];
+        case 2: k1 ^= static_cast<uint64_t>(tail[1]) << 8; [[fallthrough]];
+        case 1:
+            k1 ^= static_cast<uint64_t>(tail[0]);
+            k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+            break;
+        default:
+            break;
+    }
+
+    h1 ^= len;
+    h2 ^= len;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+    h1 += h2;
+    return h1;
+}
+
+uint64_t HashFunctions::murmur3_hash(const std::string& str, uint32_t seed) {
+    return murmur3_hash(str.data(), str.size(), seed);
+}
+
+// xxHash64
+
+uint64_t HashFunctions::xxhash(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + len;
+    uint64_t h64;
+
+    if (len >= 32) {
+        const uint8_t* limit = end - 32;
+        uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        uint64_t v2 = seed + XXH_PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME64_1;
+
+        do {
+            v1 = xxh64_round(v1, read_u64(p)); p += 8;
+            v2 = xxh64_round(v2, read_u64(p)); p += 8;
+            v3 = xxh64_round(v3, read_u64(p)); p += 8;
+            v4 = xxh64_round(v4, read_u64(p)); p += 8;
+        } while (p <= limit);
+
+        h64 = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h64 = xxh64_merge_round(h64, v1);
+        h64 = xxh64_merge_round(h64, v2);
+        h64 = xxh64_merge_round(h64, v3);
+        h64 = xxh64_merge_round(h64, v4);
+    } else {
+        h64 = seed + XXH_PRIME64_5;
+    }
+
+    h64 += static_cast<uint64_t>(len);
+
+    while (p + 8 <= end) {
+        h64 ^= xxh64_round(0, read_u64(p));
+        h64 = rotl64(h64, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h64 ^= static_cast<uint64_t>(read_u32(p)) * XXH_PRIME64_1;
+        h64 = rotl64(h64, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    while (p < end) {
+        h64 ^= (*p) * XXH_PRIME64_5;
+        h64 = rotl64(h64, 11) * XXH_PRIME64_1;
+        p++;
+    }
+
+    h64 ^= h64 >> 33;
+    h64 *= XXH_PRIME64_2;
+    h64 ^= h64 >> 29;
+    h64 *= XXH_PRIME64_3;
+    h64 ^= h64 >> 32;
+    return h64;
+}
+
+uint64_t HashFunctions::xxhash(const std::string& str, uint64_t seed) {
+    return xxhash(str.data(), str.size(), seed);
+}
+
+// SipHash-2-4
+
+uint64_t HashFunctions::sip_hash(const void* data, size_t len, const uint8_t key[16]) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t k0 = read_u64(key);
+    uint64_t k1 = read_u64(key + 8);
+
+    uint64_t v0 = 0x736f6d6570736575ULL ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dULL ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ULL ^ k0;
+    uint64_t v3 = 0x7465646279746573ULL ^ k1;
+
+    const size_t full_words = len / 8;
+    for (size_t i = 0; i < full_words; ++i) {
+        uint64_t m = read_u64(bytes + i * 8);
+        v3 ^= m;
+        sip_round(v0, v1, v2, v3);
+        sip_round(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    uint64_t last = static_cast<uint64_t>(len) << 56;
+    const uint8_t* tail = bytes + full_words * 8;
+    for (size_t i = 0; i < (len & 7); ++i) {
+        last |= static_cast<uint64_t>(tail[i]) << (8 * i);
+    }
+
+    v3 ^= last;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    for (int i = 0; i < 4; ++i) {
+        sip_round(v0, v1, v2, v3);
+    }
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// CityHash64
+
+uint64_t HashFunctions::city_hash(const void* data, size_t len) {
+    const uint8_t* s = static_cast<const uint8_t*>(data);
+
+    if (len <= 16) return city_hash_len0to16(s, len);
+    if (len <= 32) return city_hash_len17to32(s, len);
+    if (len <= 64) return city_hash_len33to64(s, len);
+
+    // Process 64-byte chunks, keeping 56 bytes of state
+    uint64_t x = read_u64(s + len - 40);
+    uint64_t y = read_u64(s + len - 16) + read_u64(s + len - 56);
+    uint64_t z = city_hash_len16(read_u64(s + len - 48) + len, read_u64(s + len - 24), CITY_KMUL);
+    CityPair v = city_weak_hash_len32_with_seeds(s + len - 64, len, z);
+    CityPair w = city_weak_hash_len32_with_seeds(s + len - 32, y + CITY_K1, x);
+    x = x * CITY_K1 + read_u64(s);
+
+    size_t remaining = (len - 1) & ~static_cast<size_t>(63);
+    do {
+        x = rotr64(x + y + v.first + read_u64(s + 8), 37) * CITY_K1;
+        y = rotr64(y + v.second + read_u64(s + 48), 42) * CITY_K1;
+        x ^= w.second;
+        y += v.first + read_u64(s + 40);
+        z = rotr64(z + w.first, 33) * CITY_K1;
+        v = city_weak_hash_len32_with_seeds(s, v.second * CITY_K1, x + w.first);
+        w = city_weak_hash_len32_with_seeds(s + 32, z + w.second, y + read_u64(s + 16));
+        uint64_t tmp = z;
+        z = x;
+        x = tmp;
+        s += 64;
+        remaining -= 64;
+    } while (remaining != 0);
+
+    return city_hash_len16(city_hash_len16(v.first, w.first, CITY_KMUL) + city_shift_mix(y) * CITY_K1 + z,
+                           city_hash_len16(v.second, w.second, CITY_KMUL) + x, CITY_KMUL);
+}
+
+uint64_t HashFunctions::city_hash(const std::string& str) {
+    return city_hash(str.data(), str.size());
+}
+
+// Wide hash
+
+uint64_t HashFunctions::wide_hash(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* secret = WIDE_SECRET.bytes;
+
+    if (len <= 16) {
+        if (len > 8) {
+            uint64_t lo = read_u64(p) ^ (read_u64(secret + 24) + seed);
+            uint64_t hi = read_u64(p + len - 8) ^ (read_u64(secret + 32) - seed);
+            return wide_avalanche(len + __builtin_bswap64(lo) + hi + wide_fold64(lo, hi));
+        }
+        if (len >= 4) {
+            uint64_t combined = read_u32(p + len - 4) + (static_cast<uint64_t>(read_u32(p)) << 32);
+            uint64_t x = combined ^ (read_u64(secret + 8) - seed);
+            return wide_avalanche(wide_fold64(x, XXH_PRIME64_1 + (len << 2)));
+        }
+        if (len > 0) {
+            uint32_t combined = (static_cast<uint32_t>(p[0]) << 16) |
+                                (static_cast<uint32_t>(p[len >> 1]) << 24) |
+                                static_cast<uint32_t>(p[len - 1]) |
+                                (static_cast<uint32_t>(len) << 8);
+            return wide_avalanche(fmix64(combined ^ (read_u32(secret) + seed)));
+        }
+        return wide_avalanche(seed ^ read_u64(secret + 56) ^ read_u64(secret + 64));
+    }
+
+    if (len <= 128) {
+        // Pairs of 16-byte chunks from both ends, so every byte is covered
+        uint64_t acc = static_cast<uint64_t>(len) * XXH_PRIME64_1;
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc += wide_mix16(p + 48, secret + 96, seed);
+                    acc += wide_mix16(p + len - 64, secret + 112, seed);
+                }
+                acc += wide_mix16(p + 32, secret + 64, seed);
+                acc += wide_mix16(p + len - 48, secret + 80, seed);
+            }
+            acc += wide_mix16(p + 16, secret + 32, seed);
+            acc += wide_mix16(p + len - 32, secret + 48, seed);
+        }
+        acc += wide_mix16(p, secret, seed);
+        acc += wide_mix16(p + len - 16, secret + 16, seed);
+        return wide_avalanche(acc);
+    }
+
+    return wide_hash_long(p, len, seed);
+}
+
+uint64_t HashFunctions::wide_hash(const std::string& str, uint64_t seed) {
+    return wide_hash(str.data(), str.size(), seed);
+}
+
+// Generic dispatcher
+
+uint64_t HashFunctions::hash(const void* data, size_t len, HashAlgorithm algo, uint64_t seed) {
+    switch (algo) {
+        case HashAlgorithm::MURMUR3:
+            return murmur3_hash(data, len, static_cast<uint32_t>(seed ^ (seed >> 32)));
+        case HashAlgorithm::XXHASH:
+            return xxhash(data, len, seed);
+        case HashAlgorithm::SIP_HASH: {
+            uint8_t key[16];
+            uint64_t k0 = seed;
+            uint64_t k1 = fmix64(seed ^ 0x5851f42d4c957f2dULL);
+            std::memcpy(key, &k0, 8);
+            std::memcpy(key + 8, &k1, 8);
+            return sip_hash(data, len, key);
+        }
+        case HashAlgorithm::CITY_HASH:
+            return city_hash(data, len) ^ seed;
+        case HashAlgorithm::WIDE:
+            return wide_hash(data, len, seed);
+        case HashAlgorithm::FNV1A:
+        default:
+            // FNV-1a mixes weakly into the high bits, which group probing uses for tags
+            return fmix64(fnv1a_hash(data, len) ^ seed);
+    }
+}
+
+// StringHashTable
+
+StringHashTable::StringHashTable(const HashTableConfig& config, MemoryPool* pool)
+    : HashTable<std::string, std::vector<uint8_t>>(config, pool) {}
+
+uint64_t StringHashTable::hash_cstring(const char* str) const {
+    return hash_bytes(str, std::strlen(str));
+}
+
+bool StringHashTable::strings_equal(const char* s1, const std::string& s2) const {
+    size_t len = std::strlen(s1);
+    return len == s2.size() && std::memcmp(s1, s2.data(), len) == 0;
+}
+
+// HashTableFactory presets
+
+HashTableConfig HashTableFactory::get_cache_config() {
+    // Lookup-heavy, tolerates a dense table: tags keep probes short at high load
+    HashTableConfig config;
+    config.load_factor_threshold = 0.875f;
+    config.shrink_threshold = 0.0f;
+    config.hash_algorithm = HashAlgorithm::XXHASH;
+    config.collision_strategy = CollisionStrategy::SIMD_GROUP_PROBING;
+    config.enable_stats = false;
+    return config;
+}
+
+HashTableConfig HashTableFactory::get_database_config() {
+    // Mixed workload on long-lived tables: bounded probe lengths and full stats
+    HashTableConfig config;
+    config.load_factor_threshold = 0.85f;
+    config.shrink_threshold = 0.2f;
+    config.hash_algorithm = HashAlgorithm::MURMUR3;
+    config.collision_strategy = CollisionStrategy::ROBIN_HOOD;
+    config.enable_stats = true;
+    return config;
+}
+
+HashTableConfig HashTableFactory::get_real_time_config() {
+    // Tail latency first: growth is spread over later operations instead of
+    // stalling one put, and no shrinking or timing calls on the hot path
+    HashTableConfig config;
+    config.load_factor_threshold = 0.75f;
+    config.shrink_threshold = 0.0f;
+    config.hash_algorithm = HashAlgorithm::XXHASH;
+    config.collision_strategy = CollisionStrategy::CHAINING;
+    config.enable_stats = false;
+    config.incremental_resize = true;
+    config.incremental_resize_step = 64;
+    return config;
+}
+
+} // namespace data_structures
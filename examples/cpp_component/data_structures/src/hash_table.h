@@ -1,11 +1,14 @@
 #pragma once
 
 #include "memory_pool.h"
+#include "control_group.h"
 #include <cstdint>
 #include <string>
 #include <vector>
 #include <functional>
 #include <optional>
+#include <atomic>
+#include <mutex>
 
 namespace data_structures {
 
@@ -20,7 +23,8 @@ enum class HashAlgorithm {
     MURMUR3,
     XXHASH,
     SIP_HASH,
-    CITY_HASH
+    CITY_HASH,
+    WIDE         // xxh3-style, 16-byte mixing; v128 accumulators for long keys
 };
 
 // Collision resolution strategies
@@ -29,7 +33,8 @@ enum class CollisionStrategy {
     LINEAR_PROBING,
     QUADRATIC_PROBING,
     DOUBLE_HASHING,
-    ROBIN_HOOD
+    ROBIN_HOOD,
+    SIMD_GROUP_PROBING  // 7-bit tags in a separate control array, probed 16 slots at a time
 };
 
 // Hash table configuration
@@ -41,13 +46,16 @@ struct HashTableConfig {
     HashAlgorithm hash_algorithm;
     CollisionStrategy collision_strategy;
     bool enable_stats;
+    bool incremental_resize;        // CHAINING only: migrate buckets a few at a time
+    size_t incremental_resize_step; // Non-empty old buckets migrated per operation
 
     HashTableConfig()
         : initial_capacity(16), load_factor_threshold(0.75f),
           shrink_threshold(0.25f), enable_resize(true),
-          hash_algorithm(HashAlgorithm::FNV1A),
+          hash_algorithm(HashAlgorithm::WIDE),
           collision_strategy(CollisionStrategy::CHAINING),
-          enable_stats(true) {}
+          enable_stats(true), incremental_resize(false),
+          incremental_resize_step(64) {}
 };
 
 // Hash table statistics
@@ -101,6 +109,12 @@ public:
     static uint64_t city_hash(const void* data, size_t len);
     static uint64_t city_hash(const std::string& str);
 
+    // Wide hash: 128-bit multiply folds over 16-byte chunks up to 128 bytes,
+    // then 64-byte stripes into eight 64-bit lanes (four v128 with wasm SIMD).
+    // The scalar and SIMD paths produce identical values.
+    static uint64_t wide_hash(const void* data, size_t len, uint64_t seed = 0);
+    static uint64_t wide_hash(const std::string& str, uint64_t seed = 0);
+
     // Generic hash dispatcher
     static uint64_t hash(const void* data, size_t len, HashAlgorithm algo, uint64_t seed = 0);
 };
@@ -113,6 +127,8 @@ public:
     using ValueType = V;
     using EntryType = HashEntry<K, V>;
 
+    // Entries churn at one size; a PoolConfig::small_objects() pool serves
+    // them from size-class slabs instead of the best-fit free list
     explicit HashTable(const HashTableConfig& config = HashTableConfig(),
                       MemoryPool* pool = nullptr);
     ~HashTable();
@@ -155,6 +171,7 @@ public:
     size_t capacity() const { return capacity_; }
     bool empty() const { return size_ == 0; }
     float load_factor() const { return static_cast<float>(size_) / capacity_; }
+    bool is_rehashing() const { return old_buckets_ != nullptr; }
 
     HashTableStats get_stats() const;
     void reset_stats();
@@ -174,14 +191,27 @@ public:
     void dump_structure() const;
     std::vector<size_t> get_bucket_sizes() const;
 
+protected:
+    // Hash of raw key bytes with this table's algorithm and seed
+    uint64_t hash_bytes(const void* data, size_t len) const;
+
 private:
     HashTableConfig config_;
     MemoryPool* memory_pool_;
     bool owns_pool_;
 
     EntryType** buckets_;
+    uint8_t* control_bytes_;  // SIMD_GROUP_PROBING only: capacity_ + ControlGroup::WIDTH bytes
     size_t capacity_;
     size_t size_;
+    size_t tombstone_count_;
+
+    // Incremental resize: slots [rehash_index_, old_capacity_) of the previous
+    // bucket array still hold chains that have not been migrated yet
+    EntryType** old_buckets_;
+    size_t old_capacity_;
+    size_t rehash_index_;
+
     uint32_t collision_count_;
     uint32_t resize_count_;
 
@@ -204,6 +234,17 @@ private:
 
     bool resize(size_t new_capacity);
     void rehash();
+    void insert_unique(EntryType* entry);  // Place an entry known to be absent
+
+    // Incremental resize (CHAINING only)
+    bool uses_incremental_resize() const {
+        return config_.incremental_resize &&
+               config_.collision_strategy == CollisionStrategy::CHAINING;
+    }
+    bool begin_incremental_resize(size_t new_capacity);
+    void migrate_buckets(size_t bucket_budget);
+    void finish_incremental_resize();
+    EntryType* find_in_old_buckets(const K& key, uint64_t hash) const;
 
     // Collision resolution implementations
     bool put_chaining(const K& key, const V& value, uint64_t hash);
@@ -216,11 +257,23 @@ private:
     bool remove_chaining(const K& key, uint64_t hash);
     bool remove_open_addressing(const K& key, uint64_t hash);
 
+    // SIMD group probing (control-byte tags, 16 slots per probe step)
+    bool put_group_probing(const K& key, const V& value, uint64_t hash);
+    bool remove_group_probing(const K& key, uint64_t hash);
+    size_t find_slot_group_probing(const K& key, uint64_t hash) const;
+    size_t find_insert_slot_group_probing(uint64_t hash) const;
+    void set_control_byte(size_t index, uint8_t value);
+    bool uses_group_probing() const {
+        return config_.collision_strategy == CollisionStrategy::SIMD_GROUP_PROBING;
+    }
+
     // Memory management helpers
     EntryType* allocate_entry();
     void deallocate_entry(EntryType* entry);
     EntryType** allocate_buckets(size_t count);
     void deallocate_buckets(EntryType** buckets, size_t count);
+    uint8_t* allocate_control_bytes(size_t count);
+    void deallocate_control_bytes(uint8_t* control_bytes);
 
     // Utility methods
     bool should_resize_up() const;
@@ -262,12 +315,19 @@ public:
     std::vector<std::string> keys_matching_pattern(const std::string& pattern) const;
 
 private:
-    // String-specific hash optimizations
+    // Hashes the bytes in place, matching hash_key(std::string(str))
     uint64_t hash_cstring(const char* str) const;
     bool strings_equal(const char* s1, const std::string& s2) const;
 };
 
 // Concurrent hash table (thread-safe)
+//
+// Writers are serialized per segment; get/contains take no lock. Each segment
+// is a chained table whose nodes are immutable once published: an update links
+// in a replacement node and a resize publishes a fresh bucket array, so readers
+// can walk a chain while a writer changes it. Unlinked nodes and old bucket
+// arrays are retired and freed by a two-epoch scheme once every reader that
+// could still hold a pointer to them has left.
 template<typename K, typename V>
 class ConcurrentHashTable {
 public:
@@ -276,37 +336,91 @@ public:
                                 MemoryPool* pool = nullptr);
     ~ConcurrentHashTable();
 
-    // Thread-safe operations
+    // Thread-safe operations (get/contains are lock-free)
     bool put(const K& key, const V& value);
     std::optional<V> get(const K& key) const;
     bool remove(const K& key);
     bool contains(const K& key) const;
     void clear();
 
-    // Bulk operations (locked per segment)
+    // Bulk operations (writes locked per segment)
     void put_batch(const std::vector<std::pair<K, V>>& pairs);
     std::vector<std::optional<V>> get_batch(const std::vector<K>& keys) const;
 
-    // Global operations (require global lock)
+    // Global operations (aggregate relaxed per-segment counters, no lock)
     size_t size() const;
     HashTableStats get_combined_stats() const;
 
 private:
-    struct Segment {
-        HashTable<K, V> table;
-        mutable std::mutex mutex;
+    struct Node {
+        const K key;
+        const V value;
+        const uint64_t hash;
+        std::atomic<Node*> next;
+
+        Node(const K& k, const V& v, uint64_t h, Node* n)
+            : key(k), value(v), hash(h), next(n) {}
+    };
+
+    struct BucketArray {
+        size_t capacity;  // Power of two
+        std::unique_ptr<std::atomic<Node*>[]> slots;
+
+        explicit BucketArray(size_t cap);
+    };
 
-        Segment(const HashTableConfig& config, MemoryPool* pool)
-            : table(config, pool) {}
+    // Padded so readers of one segment do not false-share with its neighbours
+    struct alignas(64) Segment {
+        std::atomic<BucketArray*> buckets;
+        std::atomic<size_t> size;
+        std::atomic<uint32_t> collision_count;
+        std::atomic<uint32_t> resize_count;
+        mutable std::atomic<uint64_t> total_lookups;
+        mutable std::atomic<uint64_t> successful_lookups;
+
+        // Reclamation state: readers register in the counter of the epoch
+        // they entered; retired memory is tagged with the writer's epoch.
+        std::atomic<uint64_t> epoch;
+        mutable std::atomic<uint32_t> readers[2];
+        std::vector<Node*> retired_nodes[2];
+        std::vector<BucketArray*> retired_buckets[2];
+
+        std::mutex mutex;  // Serializes writers only
+
+        explicit Segment(size_t initial_capacity);
+        ~Segment();
+    };
+
+    // RAII reader registration for the lock-free read path
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const Segment& segment);
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        const Segment& segment_;
+        size_t parity_;
     };
 
     std::vector<std::unique_ptr<Segment>> segments_;
     size_t segment_count_;
-    mutable std::mutex global_mutex_;
+    HashTableConfig config_;
+    MemoryPool* memory_pool_;  // Kept for API compatibility; nodes use the global heap
+    uint64_t hash_seed_;
 
-    size_t get_segment_index(const K& key) const;
-    Segment& get_segment(const K& key);
-    const Segment& get_segment(const K& key) const;
+    uint64_t hash_key(const K& key) const;
+    size_t get_segment_index(uint64_t hash) const;
+    Segment& get_segment(uint64_t hash);
+    const Segment& get_segment(uint64_t hash) const;
+
+    const Node* find_node(const Segment& segment, const K& key, uint64_t hash) const;
+    void grow(Segment& segment);
+    void retire(Segment& segment, Node* node);
+    void retire(Segment& segment, BucketArray* buckets);
+    void try_reclaim(Segment& segment);
 };
 
 // Hash table factory for creating optimized instances
@@ -339,4 +453,4 @@ private:
 } // namespace data_structures
 
 // Include template implementations
-#include "hash_table.tpp"
+#include "hash_table_impl.h"
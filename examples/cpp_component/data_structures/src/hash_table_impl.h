@@ -0,0 +1,1689 @@
+#pragma once
+
+// Template implementations for hash_table.h (included at the end of that header)
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <type_traits>
+
+namespace data_structures {
+
+namespace hash_table_detail {
+
+inline uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+inline size_t next_power_of_two(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace hash_table_detail
+
+// HashTable::Iterator
+
+template<typename K, typename V>
+HashTable<K, V>::Iterator::Iterator(EntryType** buckets, size_t capacity, size_t index)
+    : buckets_(buckets), capacity_(capacity), bucket_index_(index),
+      current_entry_(index < capacity ? buckets[index] : nullptr) {
+    advance_to_next_valid();
+}
+
+template<typename K, typename V>
+typename HashTable<K, V>::Iterator& HashTable<K, V>::Iterator::operator++() {
+    if (current_entry_) {
+        current_entry_ = current_entry_->next;
+    }
+    advance_to_next_valid();
+    return *this;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::Iterator::operator!=(const Iterator& other) const {
+    return bucket_index_ != other.bucket_index_ || current_entry_ != other.current_entry_;
+}
+
+template<typename K, typename V>
+std::pair<const K&, V&> HashTable<K, V>::Iterator::operator*() {
+    return {current_entry_->key, current_entry_->value};
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::Iterator::advance_to_next_valid() {
+    while (true) {
+        // Tombstones left behind by open addressing are skipped
+        while (current_entry_ && current_entry_->is_deleted) {
+            current_entry_ = current_entry_->next;
+        }
+        if (current_entry_ || bucket_index_ >= capacity_) {
+            return;
+        }
+        if (++bucket_index_ >= capacity_) {
+            return;
+        }
+        current_entry_ = buckets_[bucket_index_];
+    }
+}
+
+template<typename K, typename V>
+typename HashTable<K, V>::Iterator HashTable<K, V>::begin() {
+    // Iteration walks a single bucket array
+    finish_incremental_resize();
+    return Iterator(buckets_, capacity_, 0);
+}
+
+template<typename K, typename V>
+typename HashTable<K, V>::Iterator HashTable<K, V>::end() {
+    finish_incremental_resize();
+    return Iterator(buckets_, capacity_, capacity_);
+}
+
+// Construction
+
+template<typename K, typename V>
+HashTable<K, V>::HashTable(const HashTableConfig& config, MemoryPool* pool)
+    : config_(config), memory_pool_(pool), owns_pool_(false),
+      buckets_(nullptr), control_bytes_(nullptr), capacity_(0), size_(0),
+      tombstone_count_(0), old_buckets_(nullptr), old_capacity_(0), rehash_index_(0),
+      collision_count_(0), resize_count_(0),
+      total_lookups_(0), successful_lookups_(0), total_lookup_time_ns_(0),
+      hash_seed_(0x9E3779B97F4A7C15ULL) {
+    for (size_t i = 0; i < sizeof(sip_key_); ++i) {
+        sip_key_[i] = static_cast<uint8_t>(hash_seed_ >> ((i % 8) * 8)) ^ static_cast<uint8_t>(i);
+    }
+
+    capacity_ = calculate_optimal_capacity(config_.initial_capacity);
+    buckets_ = allocate_buckets(capacity_);
+    if (uses_group_probing()) {
+        control_bytes_ = allocate_control_bytes(capacity_);
+    }
+    if (!buckets_ || (uses_group_probing() && !control_bytes_)) {
+        // WASI-compatible: leave the table empty instead of throwing
+        deallocate_buckets(buckets_, capacity_);
+        deallocate_control_bytes(control_bytes_);
+        buckets_ = nullptr;
+        control_bytes_ = nullptr;
+        capacity_ = 0;
+    }
+}
+
+template<typename K, typename V>
+HashTable<K, V>::~HashTable() {
+    clear();
+    deallocate_buckets(buckets_, capacity_);
+    deallocate_control_bytes(control_bytes_);
+}
+
+// Core operations
+
+template<typename K, typename V>
+bool HashTable<K, V>::put(const K& key, const V& value) {
+    if (capacity_ == 0) return false;
+
+    if (is_rehashing()) {
+        migrate_buckets(config_.incremental_resize_step);
+    }
+
+    if (should_resize_up()) {
+        if (uses_incremental_resize()) {
+            // Still migrating from the last growth: finish it before starting another
+            finish_incremental_resize();
+            begin_incremental_resize(capacity_ * 2);
+        } else {
+            resize(capacity_ * 2);
+        }
+    }
+
+    uint64_t hash = hash_key(key);
+
+    switch (config_.collision_strategy) {
+        case CollisionStrategy::CHAINING:
+            return put_chaining(key, value, hash);
+        case CollisionStrategy::ROBIN_HOOD:
+            return put_robin_hood(key, value, hash);
+        case CollisionStrategy::SIMD_GROUP_PROBING:
+            return put_group_probing(key, value, hash);
+        default:
+            return put_open_addressing(key, value, hash);
+    }
+}
+
+template<typename K, typename V>
+std::optional<V> HashTable<K, V>::get(const K& key) {
+    if (capacity_ == 0) return std::nullopt;
+
+    if (is_rehashing()) {
+        migrate_buckets(config_.incremental_resize_step);
+    }
+
+    uint64_t start = config_.enable_stats ? hash_table_detail::now_ns() : 0;
+    uint64_t hash = hash_key(key);
+
+    std::optional<V> result = config_.collision_strategy == CollisionStrategy::CHAINING
+        ? get_chaining(key, hash)
+        : get_open_addressing(key, hash);
+
+    if (config_.enable_stats) {
+        update_lookup_stats(result.has_value(), hash_table_detail::now_ns() - start);
+    }
+    return result;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::remove(const K& key) {
+    if (capacity_ == 0) return false;
+
+    if (is_rehashing()) {
+        migrate_buckets(config_.incremental_resize_step);
+    }
+
+    uint64_t hash = hash_key(key);
+    bool removed;
+
+    switch (config_.collision_strategy) {
+        case CollisionStrategy::CHAINING:
+            removed = remove_chaining(key, hash);
+            break;
+        case CollisionStrategy::SIMD_GROUP_PROBING:
+            removed = remove_group_probing(key, hash);
+            break;
+        default:
+            removed = remove_open_addressing(key, hash);
+            break;
+    }
+
+    if (removed && should_resize_down()) {
+        if (uses_incremental_resize()) {
+            if (!is_rehashing()) {
+                begin_incremental_resize(capacity_ / 2);
+            }
+        } else {
+            resize(capacity_ / 2);
+        }
+    }
+    return removed;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::contains(const K& key) const {
+    if (capacity_ == 0) return false;
+    return find_entry(key, hash_key(key)) != nullptr;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::clear() {
+    if (!buckets_) return;
+
+    for (size_t i = rehash_index_; i < old_capacity_; ++i) {
+        EntryType* entry = old_buckets_[i];
+        while (entry) {
+            EntryType* next = entry->next;
+            deallocate_entry(entry);
+            entry = next;
+        }
+    }
+    deallocate_buckets(old_buckets_, old_capacity_);
+    old_buckets_ = nullptr;
+    old_capacity_ = 0;
+    rehash_index_ = 0;
+
+    for (size_t i = 0; i < capacity_; ++i) {
+        EntryType* entry = buckets_[i];
+        while (entry) {
+            EntryType* next = entry->next;
+            deallocate_entry(entry);
+            entry = next;
+        }
+        buckets_[i] = nullptr;
+    }
+
+    if (control_bytes_) {
+        std::memset(control_bytes_, ControlGroup::EMPTY, capacity_ + ControlGroup::WIDTH);
+    }
+
+    size_ = 0;
+    tombstone_count_ = 0;
+}
+
+// Bulk operations
+
+template<typename K, typename V>
+void HashTable<K, V>::put_batch(const std::vector<std::pair<K, V>>& pairs) {
+    reserve(size_ + pairs.size());
+    for (const auto& pair : pairs) {
+        put(pair.first, pair.second);
+    }
+}
+
+template<typename K, typename V>
+std::vector<std::optional<V>> HashTable<K, V>::get_batch(const std::vector<K>& keys) {
+    std::vector<std::optional<V>> results;
+    results.reserve(keys.size());
+    for (const auto& key : keys) {
+        results.push_back(get(key));
+    }
+    return results;
+}
+
+template<typename K, typename V>
+size_t HashTable<K, V>::remove_batch(const std::vector<K>& keys) {
+    size_t removed = 0;
+    for (const auto& key : keys) {
+        if (remove(key)) {
+            removed++;
+        }
+    }
+    return removed;
+}
+
+// Statistics
+
+template<typename K, typename V>
+HashTableStats HashTable<K, V>::get_stats() const {
+    HashTableStats stats = {};
+    stats.size = static_cast<uint32_t>(size_);
+    stats.capacity = static_cast<uint32_t>(capacity_);
+    stats.load_factor = capacity_ ? load_factor() : 0.0f;
+    stats.collision_count = collision_count_;
+    stats.resize_count = resize_count_;
+    stats.memory_usage = static_cast<uint32_t>(memory_usage());
+    stats.max_chain_length = static_cast<uint32_t>(calculate_max_chain_length());
+    stats.average_chain_length = calculate_average_chain_length();
+    stats.total_lookups = total_lookups_;
+    stats.successful_lookups = successful_lookups_;
+    stats.average_lookup_time_ns = total_lookups_
+        ? static_cast<double>(total_lookup_time_ns_) / total_lookups_
+        : 0.0;
+    return stats;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::reset_stats() {
+    collision_count_ = 0;
+    total_lookups_ = 0;
+    successful_lookups_ = 0;
+    total_lookup_time_ns_ = 0;
+}
+
+// Configuration
+
+template<typename K, typename V>
+void HashTable<K, V>::set_load_factor_threshold(float threshold) {
+    config_.load_factor_threshold = std::min(std::max(threshold, 0.1f), 0.95f);
+    if (should_resize_up()) {
+        resize(calculate_optimal_capacity(
+            static_cast<size_t>(size_ / config_.load_factor_threshold) + 1));
+    }
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::set_hash_algorithm(HashAlgorithm algo) {
+    if (config_.hash_algorithm == algo) return;
+    config_.hash_algorithm = algo;
+    rehash();
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::enable_auto_resize(bool enable) {
+    config_.enable_resize = enable;
+}
+
+// Memory management
+
+template<typename K, typename V>
+size_t HashTable<K, V>::memory_usage() const {
+    size_t usage = sizeof(*this);
+    usage += (capacity_ + old_capacity_) * sizeof(EntryType*);
+    if (control_bytes_) {
+        usage += capacity_ + ControlGroup::WIDTH;
+    }
+    usage += (size_ + tombstone_count_) * sizeof(EntryType);
+    return usage;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::reserve(size_t new_capacity) {
+    size_t required = calculate_optimal_capacity(
+        static_cast<size_t>(new_capacity / config_.load_factor_threshold) + 1);
+    if (required > capacity_) {
+        resize(required);
+    }
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::shrink_to_fit() {
+    size_t required = calculate_optimal_capacity(
+        static_cast<size_t>(size_ / config_.load_factor_threshold) + 1);
+    if (required < capacity_) {
+        resize(required);
+    }
+}
+
+// Debugging and validation
+
+template<typename K, typename V>
+bool HashTable<K, V>::validate() const {
+    size_t live = 0;
+    size_t dead = 0;
+
+    for (size_t i = 0; i < capacity_; ++i) {
+        for (EntryType* entry = buckets_[i]; entry; entry = entry->next) {
+            if (entry->is_deleted) {
+                dead++;
+                continue;
+            }
+            live++;
+            if (entry->hash != hash_key(entry->key)) {
+                return false;
+            }
+            if (config_.collision_strategy == CollisionStrategy::CHAINING &&
+                get_bucket_index(entry->hash) != i) {
+                return false;
+            }
+        }
+
+        if (uses_group_probing()) {
+            uint8_t ctrl = control_bytes_[i];
+            if (buckets_[i] == nullptr ? ControlGroup::is_full(ctrl)
+                                       : ctrl != ControlGroup::tag(buckets_[i]->hash)) {
+                return false;
+            }
+            if (ctrl == ControlGroup::DELETED) {
+                dead++;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < old_capacity_; ++i) {
+        if (!old_buckets_[i]) continue;
+        // Migrated slots must have been emptied
+        if (i < rehash_index_) {
+            return false;
+        }
+        for (EntryType* entry = old_buckets_[i]; entry; entry = entry->next) {
+            live++;
+            if (entry->hash != hash_key(entry->key) ||
+                (static_cast<size_t>(entry->hash) & (old_capacity_ - 1)) != i) {
+                return false;
+            }
+        }
+    }
+
+    if (uses_group_probing()) {
+        // Mirrored tail must track the first group so unaligned loads see the wrap-around
+        if (std::memcmp(control_bytes_, control_bytes_ + capacity_, ControlGroup::WIDTH) != 0) {
+            return false;
+        }
+    }
+
+    return live == size_ && dead == tombstone_count_;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::dump_structure() const {
+    std::cout << "HashTable: size=" << size_ << " capacity=" << capacity_
+              << " tombstones=" << tombstone_count_
+              << " load_factor=" << (capacity_ ? load_factor() : 0.0f) << std::endl;
+    if (is_rehashing()) {
+        std::cout << "  rehashing from capacity=" << old_capacity_
+                  << " migrated=" << rehash_index_ << std::endl;
+    }
+
+    for (size_t i = 0; i < capacity_; ++i) {
+        if (!buckets_[i]) continue;
+        size_t chain = 0;
+        for (EntryType* entry = buckets_[i]; entry; entry = entry->next) {
+            chain++;
+        }
+        std::cout << "  [" << i << "] entries=" << chain;
+        if (uses_group_probing()) {
+            std::cout << " tag=0x" << std::hex << static_cast<int>(control_bytes_[i]) << std::dec;
+        } else if (config_.collision_strategy != CollisionStrategy::CHAINING) {
+            std::cout << " distance=" << get_distance(buckets_[i]->hash, i);
+        }
+        std::cout << std::endl;
+    }
+}
+
+template<typename K, typename V>
+std::vector<size_t> HashTable<K, V>::get_bucket_sizes() const {
+    std::vector<size_t> sizes(capacity_, 0);
+    for (size_t i = 0; i < capacity_; ++i) {
+        for (EntryType* entry = buckets_[i]; entry; entry = entry->next) {
+            if (!entry->is_deleted) {
+                sizes[i]++;
+            }
+        }
+    }
+    return sizes;
+}
+
+// Internal methods
+
+template<typename K, typename V>
+uint64_t HashTable<K, V>::hash_key(const K& key) const {
+    const void* data;
+    size_t len;
+
+    if constexpr (std::is_same<K, std::string>::value) {
+        data = key.data();
+        len = key.size();
+    } else {
+        static_assert(std::is_trivially_copyable<K>::value,
+                      "HashTable keys must be std::string or trivially copyable");
+        data = &key;
+        len = sizeof(K);
+    }
+
+    return hash_bytes(data, len);
+}
+
+template<typename K, typename V>
+uint64_t HashTable<K, V>::hash_bytes(const void* data, size_t len) const {
+    if (config_.hash_algorithm == HashAlgorithm::SIP_HASH) {
+        return HashFunctions::sip_hash(data, len, sip_key_);
+    }
+    return HashFunctions::hash(data, len, config_.hash_algorithm, hash_seed_);
+}
+
+template<typename K, typename V>
+size_t HashTable<K, V>::get_bucket_index(uint64_t hash) const {
+    // Capacity is always a power of two
+    return static_cast<size_t>(hash) & (capacity_ - 1);
+}
+
+template<typename K, typename V>
+size_t HashTable<K, V>::get_probe_sequence(uint64_t hash, size_t attempt) const {
+    size_t home = get_bucket_index(hash);
+    size_t mask = capacity_ - 1;
+
+    switch (config_.collision_strategy) {
+        case CollisionStrategy::QUADRATIC_PROBING:
+            // Triangular numbers visit every slot of a power-of-two table
+            return (home + attempt * (attempt + 1) / 2) & mask;
+        case CollisionStrategy::DOUBLE_HASHING:
+            // An odd step is coprime with a power-of-two capacity
+            return (home + attempt * (static_cast<size_t>(hash >> 32) | 1)) & mask;
+        default:
+            return (home + attempt) & mask;
+    }
+}
+
+template<typename K, typename V>
+typename HashTable<K, V>::EntryType* HashTable<K, V>::find_entry(const K& key, uint64_t hash) const {
+    switch (config_.collision_strategy) {
+        case CollisionStrategy::CHAINING: {
+            for (EntryType* entry = buckets_[get_bucket_index(hash)]; entry; entry = entry->next) {
+                if (entry->hash == hash && entry->key == key) {
+                    return entry;
+                }
+            }
+            return find_in_old_buckets(key, hash);
+        }
+
+        case CollisionStrategy::SIMD_GROUP_PROBING: {
+            size_t slot = find_slot_group_probing(key, hash);
+            return slot < capacity_ ? buckets_[slot] : nullptr;
+        }
+
+        case CollisionStrategy::ROBIN_HOOD: {
+            size_t index = get_bucket_index(hash);
+            for (size_t distance = 0; distance < capacity_; ++distance) {
+                EntryType* entry = buckets_[index];
+                // A resident closer to its home than we are ends the search
+                if (!entry || get_distance(entry->hash, index) < distance) {
+                    return nullptr;
+                }
+                if (entry->hash == hash && entry->key == key) {
+                    return entry;
+                }
+                index = (index + 1) & (capacity_ - 1);
+            }
+            return nullptr;
+        }
+
+        default: {
+            for (size_t attempt = 0; attempt < capacity_; ++attempt) {
+                EntryType* entry = buckets_[get_probe_sequence(hash, attempt)];
+                if (!entry) {
+                    return nullptr;
+                }
+                if (!entry->is_deleted && entry->hash == hash && entry->key == key) {
+                    return entry;
+                }
+            }
+            return nullptr;
+        }
+    }
+}
+
+template<typename K, typename V>
+typename HashTable<K, V>::EntryType* HashTable<K, V>::find_entry_for_insertion(const K& key, uint64_t hash) {
+    // Chaining only: returns the existing entry or a freshly linked one
+    size_t index = get_bucket_index(hash);
+    for (EntryType* entry = buckets_[index]; entry; entry = entry->next) {
+        if (entry->hash == hash && entry->key == key) {
+            return entry;
+        }
+    }
+    // Keys not yet migrated are updated where they are
+    if (EntryType* pending = find_in_old_buckets(key, hash)) {
+        return pending;
+    }
+
+    EntryType* entry = allocate_entry();
+    if (!entry) return nullptr;
+
+    entry->key = key;
+    entry->hash = hash;
+    if (buckets_[index]) {
+        collision_count_++;
+    }
+    entry->next = buckets_[index];
+    buckets_[index] = entry;
+    size_++;
+    return entry;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::resize(size_t new_capacity) {
+    finish_incremental_resize();
+    new_capacity = calculate_optimal_capacity(std::max(new_capacity, size_ + 1));
+
+    EntryType** new_buckets = allocate_buckets(new_capacity);
+    if (!new_buckets) return false;
+
+    uint8_t* new_control = nullptr;
+    if (uses_group_probing()) {
+        new_control = allocate_control_bytes(new_capacity);
+        if (!new_control) {
+            deallocate_buckets(new_buckets, new_capacity);
+            return false;
+        }
+    }
+
+    EntryType** old_buckets = buckets_;
+    uint8_t* old_control = control_bytes_;
+    size_t old_capacity = capacity_;
+
+    buckets_ = new_buckets;
+    control_bytes_ = new_control;
+    capacity_ = new_capacity;
+    size_ = 0;
+    tombstone_count_ = 0;
+
+    for (size_t i = 0; i < old_capacity; ++i) {
+        EntryType* entry = old_buckets[i];
+        while (entry) {
+            EntryType* next = entry->next;
+            entry->next = nullptr;
+            if (entry->is_deleted) {
+                deallocate_entry(entry);
+            } else {
+                insert_unique(entry);
+            }
+            entry = next;
+        }
+    }
+
+    deallocate_buckets(old_buckets, old_capacity);
+    deallocate_control_bytes(old_control);
+    resize_count_++;
+    return true;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::rehash() {
+    // Recompute stored hashes (hash algorithm changed), then redistribute
+    finish_incremental_resize();
+    for (size_t i = 0; i < capacity_; ++i) {
+        for (EntryType* entry = buckets_[i]; entry; entry = entry->next) {
+            if (!entry->is_deleted) {
+                entry->hash = hash_key(entry->key);
+            }
+        }
+    }
+    resize(capacity_);
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::insert_unique(EntryType* entry) {
+    size_t mask = capacity_ - 1;
+
+    switch (config_.collision_strategy) {
+        case CollisionStrategy::CHAINING: {
+            size_t index = get_bucket_index(entry->hash);
+            entry->next = buckets_[index];
+            buckets_[index] = entry;
+            break;
+        }
+
+        case CollisionStrategy::SIMD_GROUP_PROBING: {
+            size_t slot = find_insert_slot_group_probing(entry->hash);
+            set_control_byte(slot, ControlGroup::tag(entry->hash));
+            buckets_[slot] = entry;
+            break;
+        }
+
+        case CollisionStrategy::ROBIN_HOOD: {
+            // Take slots from residents that are closer to home ("rich") than the carried entry
+            size_t index = get_bucket_index(entry->hash);
+            size_t distance = 0;
+            EntryType* carried = entry;
+            while (buckets_[index]) {
+                size_t resident_distance = get_distance(buckets_[index]->hash, index);
+                if (resident_distance < distance) {
+                    std::swap(carried, buckets_[index]);
+                    distance = resident_distance;
+                }
+                index = (index + 1) & mask;
+                distance++;
+            }
+            buckets_[index] = carried;
+            break;
+        }
+
+        default: {
+            for (size_t attempt = 0; attempt < capacity_; ++attempt) {
+                size_t index = get_probe_sequence(entry->hash, attempt);
+                if (!buckets_[index]) {
+                    buckets_[index] = entry;
+                    break;
+                }
+            }
+            break;
+        }
+    }
+
+    size_++;
+}
+
+// Chaining
+
+template<typename K, typename V>
+bool HashTable<K, V>::put_chaining(const K& key, const V& value, uint64_t hash) {
+    EntryType* entry = find_entry_for_insertion(key, hash);
+    if (!entry) return false;
+    entry->value = value;
+    return true;
+}
+
+template<typename K, typename V>
+std::optional<V> HashTable<K, V>::get_chaining(const K& key, uint64_t hash) const {
+    for (EntryType* entry = buckets_[get_bucket_index(hash)]; entry; entry = entry->next) {
+        if (entry->hash == hash && entry->key == key) {
+            return entry->value;
+        }
+    }
+    if (EntryType* pending = find_in_old_buckets(key, hash)) {
+        return pending->value;
+    }
+    return std::nullopt;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::remove_chaining(const K& key, uint64_t hash) {
+    EntryType** link = &buckets_[get_bucket_index(hash)];
+    while (*link) {
+        EntryType* entry = *link;
+        if (entry->hash == hash && entry->key == key) {
+            *link = entry->next;
+            deallocate_entry(entry);
+            size_--;
+            return true;
+        }
+        link = &entry->next;
+    }
+
+    if (is_rehashing()) {
+        link = &old_buckets_[static_cast<size_t>(hash) & (old_capacity_ - 1)];
+        while (*link) {
+            EntryType* entry = *link;
+            if (entry->hash == hash && entry->key == key) {
+                *link = entry->next;
+                deallocate_entry(entry);
+                size_--;
+                return true;
+            }
+            link = &entry->next;
+        }
+    }
+    return false;
+}
+
+// Incremental resize
+//
+// Both bucket arrays stay alive while a resize is in flight. New entries go
+// to the new array; every put/get/remove first moves up to
+// incremental_resize_step old chains across, so no single call pays for the
+// whole table. Lookups check the new array, then the key's old slot, which
+// is already empty once migrated.
+
+template<typename K, typename V>
+bool HashTable<K, V>::begin_incremental_resize(size_t new_capacity) {
+    new_capacity = calculate_optimal_capacity(std::max(new_capacity, size_ + 1));
+
+    EntryType** new_buckets = allocate_buckets(new_capacity);
+    if (!new_buckets) return false;
+
+    old_buckets_ = buckets_;
+    old_capacity_ = capacity_;
+    rehash_index_ = 0;
+
+    buckets_ = new_buckets;
+    capacity_ = new_capacity;
+    resize_count_++;
+
+    migrate_buckets(config_.incremental_resize_step);
+    return true;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::migrate_buckets(size_t bucket_budget) {
+    if (!is_rehashing()) return;
+
+    bucket_budget = std::max<size_t>(1, bucket_budget);
+    // Bound the scan too, so a sparse old array cannot turn one call into a full pass
+    size_t empty_visits = bucket_budget * 10;
+
+    while (bucket_budget > 0 && rehash_index_ < old_capacity_) {
+        EntryType* entry = old_buckets_[rehash_index_];
+        if (!entry) {
+            rehash_index_++;
+            if (--empty_visits == 0) break;
+            continue;
+        }
+
+        while (entry) {
+            EntryType* next = entry->next;
+            size_t index = get_bucket_index(entry->hash);
+            entry->next = buckets_[index];
+            buckets_[index] = entry;
+            entry = next;
+        }
+        old_buckets_[rehash_index_++] = nullptr;
+        bucket_budget--;
+    }
+
+    if (rehash_index_ >= old_capacity_) {
+        deallocate_buckets(old_buckets_, old_capacity_);
+        old_buckets_ = nullptr;
+        old_capacity_ = 0;
+        rehash_index_ = 0;
+    }
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::finish_incremental_resize() {
+    while (is_rehashing()) {
+        migrate_buckets(old_capacity_);
+    }
+}
+
+template<typename K, typename V>
+typename HashTable<K, V>::EntryType* HashTable<K, V>::find_in_old_buckets(const K& key, uint64_t hash) const {
+    if (!is_rehashing()) return nullptr;
+    for (EntryType* entry = old_buckets_[static_cast<size_t>(hash) & (old_capacity_ - 1)];
+         entry; entry = entry->next) {
+        if (entry->hash == hash && entry->key == key) {
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+// Open addressing (linear, quadratic, double hashing)
+
+template<typename K, typename V>
+bool HashTable<K, V>::put_open_addressing(const K& key, const V& value, uint64_t hash) {
+    size_t first_tombstone = capacity_;
+    size_t empty_slot = capacity_;
+
+    for (size_t attempt = 0; attempt < capacity_; ++attempt) {
+        size_t index = get_probe_sequence(hash, attempt);
+        EntryType* entry = buckets_[index];
+
+        if (!entry) {
+            if (attempt > 0) {
+                collision_count_++;
+            }
+            empty_slot = index;
+            break;
+        }
+
+        if (entry->is_deleted) {
+            if (first_tombstone == capacity_) {
+                first_tombstone = index;
+            }
+            continue;
+        }
+
+        if (entry->hash == hash && entry->key == key) {
+            entry->value = value;
+            return true;
+        }
+    }
+
+    if (first_tombstone < capacity_) {
+        // Reuse the tombstone's entry in place
+        EntryType* reused = buckets_[first_tombstone];
+        reused->key = key;
+        reused->value = value;
+        reused->hash = hash;
+        reused->is_deleted = false;
+        tombstone_count_--;
+        size_++;
+        return true;
+    }
+
+    if (empty_slot == capacity_) {
+        return false;  // Table full and auto-resize disabled
+    }
+
+    EntryType* created = allocate_entry();
+    if (!created) return false;
+    created->key = key;
+    created->value = value;
+    created->hash = hash;
+    buckets_[empty_slot] = created;
+    size_++;
+    return true;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::put_robin_hood(const K& key, const V& value, uint64_t hash) {
+    if (EntryType* existing = find_entry(key, hash)) {
+        existing->value = value;
+        return true;
+    }
+
+    if (size_ + 1 >= capacity_) {
+        return false;  // Table full and auto-resize disabled
+    }
+
+    EntryType* entry = allocate_entry();
+    if (!entry) return false;
+
+    entry->key = key;
+    entry->value = value;
+    entry->hash = hash;
+    if (buckets_[get_bucket_index(hash)]) {
+        collision_count_++;
+    }
+    insert_unique(entry);
+    return true;
+}
+
+template<typename K, typename V>
+std::optional<V> HashTable<K, V>::get_open_addressing(const K& key, uint64_t hash) const {
+    EntryType* entry = find_entry(key, hash);
+    if (!entry) return std::nullopt;
+    return entry->value;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::remove_open_addressing(const K& key, uint64_t hash) {
+    if (config_.collision_strategy == CollisionStrategy::ROBIN_HOOD) {
+        EntryType* entry = find_entry(key, hash);
+        if (!entry) return false;
+
+        size_t mask = capacity_ - 1;
+        size_t index = get_bucket_index(hash);
+        while (buckets_[index] != entry) {
+            index = (index + 1) & mask;
+        }
+        deallocate_entry(entry);
+
+        // Backward-shift deletion keeps Robin Hood tables tombstone-free
+        size_t next = (index + 1) & mask;
+        while (buckets_[next] && get_distance(buckets_[next]->hash, next) > 0) {
+            swap_entries(index, next);
+            index = next;
+            next = (next + 1) & mask;
+        }
+        buckets_[index] = nullptr;
+        size_--;
+        return true;
+    }
+
+    EntryType* entry = find_entry(key, hash);
+    if (!entry) return false;
+
+    // Leave a tombstone so later probe sequences stay intact; drop the payload now
+    entry->is_deleted = true;
+    entry->value = V();
+    size_--;
+    tombstone_count_++;
+    return true;
+}
+
+// SIMD group probing
+
+template<typename K, typename V>
+size_t HashTable<K, V>::find_slot_group_probing(const K& key, uint64_t hash) const {
+    const size_t mask = capacity_ - 1;
+    const uint8_t h2 = ControlGroup::tag(hash);
+    size_t position = get_bucket_index(hash);
+    size_t stride = 0;
+
+    for (size_t probe = 0; probe < capacity_ / ControlGroup::WIDTH; ++probe) {
+        ControlGroup group(control_bytes_ + position);
+
+        for (uint32_t bits = group.match(h2); bits; bits = ControlGroup::clear_lowest_bit(bits)) {
+            size_t slot = (position + ControlGroup::lowest_bit(bits)) & mask;
+            const EntryType* entry = buckets_[slot];
+            if (entry->hash == hash && entry->key == key) {
+                return slot;
+            }
+        }
+
+        if (group.match_empty()) {
+            return capacity_;
+        }
+
+        // Triangular group strides visit every group of a power-of-two table
+        stride += ControlGroup::WIDTH;
+        position = (position + stride) & mask;
+    }
+
+    return capacity_;
+}
+
+template<typename K, typename V>
+size_t HashTable<K, V>::find_insert_slot_group_probing(uint64_t hash) const {
+    const size_t mask = capacity_ - 1;
+    size_t position = get_bucket_index(hash);
+    size_t stride = 0;
+
+    for (size_t probe = 0; probe < capacity_ / ControlGroup::WIDTH; ++probe) {
+        uint32_t bits = ControlGroup(control_bytes_ + position).match_empty_or_deleted();
+        if (bits) {
+            return (position + ControlGroup::lowest_bit(bits)) & mask;
+        }
+        stride += ControlGroup::WIDTH;
+        position = (position + stride) & mask;
+    }
+
+    return capacity_;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::set_control_byte(size_t index, uint8_t value) {
+    control_bytes_[index] = value;
+    // Mirror the first group past the end so a 16-byte load never needs to wrap
+    if (index < ControlGroup::WIDTH) {
+        control_bytes_[capacity_ + index] = value;
+    }
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::put_group_probing(const K& key, const V& value, uint64_t hash) {
+    size_t existing = find_slot_group_probing(key, hash);
+    if (existing < capacity_) {
+        buckets_[existing]->value = value;
+        return true;
+    }
+
+    size_t slot = find_insert_slot_group_probing(hash);
+    if (slot >= capacity_) {
+        return false;  // Table full and auto-resize disabled
+    }
+
+    EntryType* entry = allocate_entry();
+    if (!entry) return false;
+
+    entry->key = key;
+    entry->value = value;
+    entry->hash = hash;
+
+    if (slot != get_bucket_index(hash)) {
+        collision_count_++;
+    }
+    if (control_bytes_[slot] == ControlGroup::DELETED) {
+        tombstone_count_--;
+    }
+    set_control_byte(slot, ControlGroup::tag(hash));
+    buckets_[slot] = entry;
+    size_++;
+    return true;
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::remove_group_probing(const K& key, uint64_t hash) {
+    size_t slot = find_slot_group_probing(key, hash);
+    if (slot >= capacity_) return false;
+
+    deallocate_entry(buckets_[slot]);
+    buckets_[slot] = nullptr;
+    size_--;
+
+    // If no 16-slot window around the slot was ever completely full, no probe
+    // sequence can have passed over it and the slot can go straight back to EMPTY.
+    const size_t mask = capacity_ - 1;
+    uint32_t empty_after = ControlGroup(control_bytes_ + slot).match_empty();
+    uint32_t empty_before = ControlGroup(control_bytes_ + ((slot - ControlGroup::WIDTH) & mask)).match_empty();
+    bool was_never_full = empty_before && empty_after &&
+        ControlGroup::trailing_zeros(empty_after) + ControlGroup::leading_zeros(empty_before) < ControlGroup::WIDTH;
+
+    if (was_never_full) {
+        set_control_byte(slot, ControlGroup::EMPTY);
+    } else {
+        set_control_byte(slot, ControlGroup::DELETED);
+        tombstone_count_++;
+    }
+    return true;
+}
+
+// Memory management helpers
+
+template<typename K, typename V>
+typename HashTable<K, V>::EntryType* HashTable<K, V>::allocate_entry() {
+    if (memory_pool_) {
+        void* memory = memory_pool_->allocate(sizeof(EntryType));
+        return memory ? new (memory) EntryType() : nullptr;
+    }
+    return new (std::nothrow) EntryType();
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::deallocate_entry(EntryType* entry) {
+    if (!entry) return;
+    if (memory_pool_) {
+        entry->~EntryType();
+        memory_pool_->deallocate(entry);
+    } else {
+        delete entry;
+    }
+}
+
+template<typename K, typename V>
+typename HashTable<K, V>::EntryType** HashTable<K, V>::allocate_buckets(size_t count) {
+    EntryType** buckets;
+    if (memory_pool_) {
+        buckets = static_cast<EntryType**>(memory_pool_->allocate(count * sizeof(EntryType*)));
+    } else {
+        buckets = new (std::nothrow) EntryType*[count];
+    }
+    if (buckets) {
+        std::fill(buckets, buckets + count, nullptr);
+    }
+    return buckets;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::deallocate_buckets(EntryType** buckets, size_t count) {
+    (void)count;
+    if (!buckets) return;
+    if (memory_pool_) {
+        memory_pool_->deallocate(buckets);
+    } else {
+        delete[] buckets;
+    }
+}
+
+template<typename K, typename V>
+uint8_t* HashTable<K, V>::allocate_control_bytes(size_t count) {
+    size_t bytes = count + ControlGroup::WIDTH;
+    uint8_t* control;
+    if (memory_pool_) {
+        control = static_cast<uint8_t*>(memory_pool_->allocate(bytes));
+    } else {
+        control = new (std::nothrow) uint8_t[bytes];
+    }
+    if (control) {
+        std::memset(control, ControlGroup::EMPTY, bytes);
+    }
+    return control;
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::deallocate_control_bytes(uint8_t* control_bytes) {
+    if (!control_bytes) return;
+    if (memory_pool_) {
+        memory_pool_->deallocate(control_bytes);
+    } else {
+        delete[] control_bytes;
+    }
+}
+
+// Utility methods
+
+template<typename K, typename V>
+bool HashTable<K, V>::should_resize_up() const {
+    if (!config_.enable_resize) return false;
+
+    float threshold = config_.load_factor_threshold;
+    if (uses_group_probing()) {
+        // Probing stops at the first EMPTY slot in a group; keep at least 1/8 free
+        threshold = std::min(threshold, 0.875f);
+    }
+    // Tombstones lengthen probe sequences just like live entries do
+    size_t occupied = config_.collision_strategy == CollisionStrategy::CHAINING
+        ? size_ + 1
+        : size_ + tombstone_count_ + 1;
+    return occupied > static_cast<size_t>(capacity_ * threshold);
+}
+
+template<typename K, typename V>
+bool HashTable<K, V>::should_resize_down() const {
+    if (!config_.enable_resize || config_.shrink_threshold <= 0.0f) return false;
+    size_t minimum = calculate_optimal_capacity(config_.initial_capacity);
+    return capacity_ > minimum && size_ < static_cast<size_t>(capacity_ * config_.shrink_threshold);
+}
+
+template<typename K, typename V>
+size_t HashTable<K, V>::calculate_optimal_capacity(size_t min_capacity) const {
+    size_t floor = uses_group_probing() ? ControlGroup::WIDTH : 8;
+    return hash_table_detail::next_power_of_two(std::max(min_capacity, floor));
+}
+
+// Robin Hood hashing helpers
+
+template<typename K, typename V>
+size_t HashTable<K, V>::get_distance(uint64_t hash, size_t actual_index) const {
+    return (actual_index - get_bucket_index(hash)) & (capacity_ - 1);
+}
+
+template<typename K, typename V>
+void HashTable<K, V>::swap_entries(size_t index1, size_t index2) {
+    std::swap(buckets_[index1], buckets_[index2]);
+}
+
+// Statistics helpers
+
+template<typename K, typename V>
+void HashTable<K, V>::update_lookup_stats(bool successful, uint64_t time_ns) const {
+    total_lookups_++;
+    if (successful) {
+        successful_lookups_++;
+    }
+    total_lookup_time_ns_ += time_ns;
+}
+
+template<typename K, typename V>
+size_t HashTable<K, V>::calculate_max_chain_length() const {
+    size_t longest = 0;
+    for (size_t i = 0; i < capacity_; ++i) {
+        if (!buckets_[i]) continue;
+        if (config_.collision_strategy == CollisionStrategy::CHAINING) {
+            size_t chain = 0;
+            for (EntryType* entry = buckets_[i]; entry; entry = entry->next) {
+                chain++;
+            }
+            longest = std::max(longest, chain);
+        } else if (!buckets_[i]->is_deleted) {
+            // Probe length for open addressing
+            longest = std::max(longest, get_distance(buckets_[i]->hash, i) + 1);
+        }
+    }
+    return longest;
+}
+
+template<typename K, typename V>
+float HashTable<K, V>::calculate_average_chain_length() const {
+    if (config_.collision_strategy != CollisionStrategy::CHAINING) {
+        if (size_ == 0) return 0.0f;
+        size_t total = 0;
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (buckets_[i] && !buckets_[i]->is_deleted) {
+                total += get_distance(buckets_[i]->hash, i) + 1;
+            }
+        }
+        return static_cast<float>(total) / size_;
+    }
+
+    size_t used_buckets = 0;
+    for (size_t i = 0; i < capacity_; ++i) {
+        if (buckets_[i]) {
+            used_buckets++;
+        }
+    }
+    return used_buckets ? static_cast<float>(size_) / used_buckets : 0.0f;
+}
+
+// ConcurrentHashTable
+//
+// Reclamation protocol: a reader registers in readers[epoch & 1] for the
+// duration of one lookup. A writer retires unlinked memory into the list of
+// the current epoch e and only advances to e + 1 once readers[(e - 1) & 1]
+// has drained; at that point nothing retired during e - 1 can still be
+// reachable from an active reader, so that list is freed. Readers enter in
+// the opposite parity from the one being drained, so a steady read load
+// cannot starve reclamation.
+
+template<typename K, typename V>
+ConcurrentHashTable<K, V>::BucketArray::BucketArray(size_t cap)
+    : capacity(cap), slots(new std::atomic<Node*>[cap]) {
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template<typename K, typename V>
+ConcurrentHashTable<K, V>::Segment::Segment(size_t initial_capacity)
+    : buckets(new BucketArray(initial_capacity)), size(0), collision_count(0),
+      resize_count(0), total_lookups(0), successful_lookups(0), epoch(0) {
+    readers[0].store(0, std::memory_order_relaxed);
+    readers[1].store(0, std::memory_order_relaxed);
+}
+
+template<typename K, typename V>
+ConcurrentHashTable<K, V>::Segment::~Segment() {
+    // No readers may be active once the table is being destroyed
+    BucketArray* current = buckets.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < current->capacity; ++i) {
+        Node* node = current->slots[i].load(std::memory_order_relaxed);
+        while (node) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+    delete current;
+
+    for (size_t parity = 0; parity < 2; ++parity) {
+        for (Node* node : retired_nodes[parity]) {
+            delete node;
+        }
+        for (BucketArray* array : retired_buckets[parity]) {
+            delete array;
+        }
+    }
+}
+
+template<typename K, typename V>
+ConcurrentHashTable<K, V>::ReadGuard::ReadGuard(const Segment& segment)
+    : segment_(segment), parity_(0) {
+    for (;;) {
+        uint64_t epoch = segment_.epoch.load();
+        parity_ = static_cast<size_t>(epoch & 1);
+        segment_.readers[parity_].fetch_add(1);
+        // A writer may have advanced between the load and the registration;
+        // re-check so we never sit in the counter it is about to drain.
+        if (segment_.epoch.load() == epoch) {
+            return;
+        }
+        segment_.readers[parity_].fetch_sub(1);
+    }
+}
+
+template<typename K, typename V>
+ConcurrentHashTable<K, V>::ReadGuard::~ReadGuard() {
+    segment_.readers[parity_].fetch_sub(1, std::memory_order_release);
+}
+
+template<typename K, typename V>
+ConcurrentHashTable<K, V>::ConcurrentHashTable(size_t segment_count,
+                                              const HashTableConfig& config,
+                                              MemoryPool* pool)
+    : segment_count_(std::max<size_t>(1, segment_count)),
+      config_(config),
+      memory_pool_(pool),
+      hash_seed_(0x9E3779B97F4A7C15ULL) {
+    if (config_.load_factor_threshold <= 0.0f || config_.load_factor_threshold > 4.0f) {
+        config_.load_factor_threshold = 0.75f;
+    }
+
+    size_t per_segment = hash_table_detail::next_power_of_two(
+        std::max<size_t>(8, config_.initial_capacity / segment_count_));
+
+    segments_.reserve(segment_count_);
+    for (size_t i = 0; i < segment_count_; ++i) {
+        segments_.push_back(std::make_unique<Segment>(per_segment));
+    }
+}
+
+template<typename K, typename V>
+ConcurrentHashTable<K, V>::~ConcurrentHashTable() = default;
+
+template<typename K, typename V>
+bool ConcurrentHashTable<K, V>::put(const K& key, const V& value) {
+    uint64_t hash = hash_key(key);
+    Segment& segment = get_segment(hash);
+    std::lock_guard<std::mutex> lock(segment.mutex);
+
+    BucketArray* array = segment.buckets.load(std::memory_order_relaxed);
+    std::atomic<Node*>* link = &array->slots[hash & (array->capacity - 1)];
+
+    for (Node* node = link->load(std::memory_order_relaxed); node;
+         node = link->load(std::memory_order_relaxed)) {
+        if (node->hash == hash && node->key == key) {
+            // Nodes are immutable once published: swap in a replacement
+            Node* replacement = new (std::nothrow) Node(
+                key, value, hash, node->next.load(std::memory_order_relaxed));
+            if (!replacement) {
+                return false;
+            }
+            link->store(replacement, std::memory_order_release);
+            retire(segment, node);
+            try_reclaim(segment);
+            return true;
+        }
+        link = &node->next;
+    }
+
+    std::atomic<Node*>& head = array->slots[hash & (array->capacity - 1)];
+    Node* first = head.load(std::memory_order_relaxed);
+    Node* created = new (std::nothrow) Node(key, value, hash, first);
+    if (!created) {
+        return false;
+    }
+    if (first) {
+        segment.collision_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    head.store(created, std::memory_order_release);
+    size_t new_size = segment.size.fetch_add(1, std::memory_order_relaxed) + 1;
+
+    if (config_.enable_resize &&
+        static_cast<float>(new_size) / array->capacity > config_.load_factor_threshold) {
+        grow(segment);
+    }
+    try_reclaim(segment);
+    return true;
+}
+
+template<typename K, typename V>
+std::optional<V> ConcurrentHashTable<K, V>::get(const K& key) const {
+    uint64_t hash = hash_key(key);
+    const Segment& segment = get_segment(hash);
+
+    std::optional<V> result;
+    {
+        ReadGuard guard(segment);
+        const Node* node = find_node(segment, key, hash);
+        if (node) {
+            result = node->value;
+        }
+    }
+
+    if (config_.enable_stats) {
+        segment.total_lookups.fetch_add(1, std::memory_order_relaxed);
+        if (result) {
+            segment.successful_lookups.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+template<typename K, typename V>
+bool ConcurrentHashTable<K, V>::remove(const K& key) {
+    uint64_t hash = hash_key(key);
+    Segment& segment = get_segment(hash);
+    std::lock_guard<std::mutex> lock(segment.mutex);
+
+    BucketArray* array = segment.buckets.load(std::memory_order_relaxed);
+    std::atomic<Node*>* link = &array->slots[hash & (array->capacity - 1)];
+
+    for (Node* node = link->load(std::memory_order_relaxed); node;
+         node = link->load(std::memory_order_relaxed)) {
+        if (node->hash == hash && node->key == key) {
+            link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+            segment.size.fetch_sub(1, std::memory_order_relaxed);
+            retire(segment, node);
+            try_reclaim(segment);
+            return true;
+        }
+        link = &node->next;
+    }
+    return false;
+}
+
+template<typename K, typename V>
+bool ConcurrentHashTable<K, V>::contains(const K& key) const {
+    uint64_t hash = hash_key(key);
+    const Segment& segment = get_segment(hash);
+    ReadGuard guard(segment);
+    return find_node(segment, key, hash) != nullptr;
+}
+
+template<typename K, typename V>
+void ConcurrentHashTable<K, V>::clear() {
+    for (auto& segment_ptr : segments_) {
+        Segment& segment = *segment_ptr;
+        std::lock_guard<std::mutex> lock(segment.mutex);
+
+        BucketArray* old_array = segment.buckets.load(std::memory_order_relaxed);
+        BucketArray* fresh = new (std::nothrow) BucketArray(old_array->capacity);
+        if (!fresh) {
+            continue;
+        }
+        segment.buckets.store(fresh, std::memory_order_release);
+        segment.size.store(0, std::memory_order_relaxed);
+
+        for (size_t i = 0; i < old_array->capacity; ++i) {
+            for (Node* node = old_array->slots[i].load(std::memory_order_relaxed); node;
+                 node = node->next.load(std::memory_order_relaxed)) {
+                retire(segment, node);
+            }
+        }
+        retire(segment, old_array);
+        try_reclaim(segment);
+    }
+}
+
+template<typename K, typename V>
+void ConcurrentHashTable<K, V>::put_batch(const std::vector<std::pair<K, V>>& pairs) {
+    for (const auto& pair : pairs) {
+        put(pair.first, pair.second);
+    }
+}
+
+template<typename K, typename V>
+std::vector<std::optional<V>> ConcurrentHashTable<K, V>::get_batch(const std::vector<K>& keys) const {
+    std::vector<std::optional<V>> results;
+    results.reserve(keys.size());
+    for (const auto& key : keys) {
+        results.push_back(get(key));
+    }
+    return results;
+}
+
+template<typename K, typename V>
+size_t ConcurrentHashTable<K, V>::size() const {
+    size_t total = 0;
+    for (const auto& segment : segments_) {
+        total += segment->size.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+template<typename K, typename V>
+HashTableStats ConcurrentHashTable<K, V>::get_combined_stats() const {
+    // Aggregated from relaxed counters: each field is exact for its segment
+    // but the totals are not a single atomic snapshot across segments.
+    HashTableStats stats{};
+    size_t capacity = 0;
+    for (const auto& segment : segments_) {
+        stats.size += static_cast<uint32_t>(segment->size.load(std::memory_order_relaxed));
+        stats.collision_count += segment->collision_count.load(std::memory_order_relaxed);
+        stats.resize_count += segment->resize_count.load(std::memory_order_relaxed);
+        stats.total_lookups += segment->total_lookups.load(std::memory_order_relaxed);
+        stats.successful_lookups += segment->successful_lookups.load(std::memory_order_relaxed);
+
+        ReadGuard guard(*segment);
+        capacity += segment->buckets.load(std::memory_order_acquire)->capacity;
+    }
+
+    stats.capacity = static_cast<uint32_t>(capacity);
+    stats.load_factor = capacity ? static_cast<float>(stats.size) / capacity : 0.0f;
+    stats.memory_usage = static_cast<uint32_t>(
+        sizeof(*this) + segment_count_ * sizeof(Segment) +
+        capacity * sizeof(std::atomic<Node*>) + stats.size * sizeof(Node));
+    stats.average_chain_length = capacity ? static_cast<float>(stats.size) / capacity : 0.0f;
+    return stats;
+}
+
+template<typename K, typename V>
+uint64_t ConcurrentHashTable<K, V>::hash_key(const K& key) const {
+    if constexpr (std::is_same<K, std::string>::value) {
+        return HashFunctions::hash(key.data(), key.size(), config_.hash_algorithm, hash_seed_);
+    } else {
+        static_assert(std::is_trivially_copyable<K>::value,
+                      "ConcurrentHashTable keys must be std::string or trivially copyable");
+        return HashFunctions::hash(&key, sizeof(K), config_.hash_algorithm, hash_seed_);
+    }
+}
+
+template<typename K, typename V>
+size_t ConcurrentHashTable<K, V>::get_segment_index(uint64_t hash) const {
+    // High bits pick the segment, low bits pick the bucket inside it
+    return static_cast<size_t>((hash >> 32) % segment_count_);
+}
+
+template<typename K, typename V>
+typename ConcurrentHashTable<K, V>::Segment& ConcurrentHashTable<K, V>::get_segment(uint64_t hash) {
+    return *segments_[get_segment_index(hash)];
+}
+
+template<typename K, typename V>
+const typename ConcurrentHashTable<K, V>::Segment&
+ConcurrentHashTable<K, V>::get_segment(uint64_t hash) const {
+    return *segments_[get_segment_index(hash)];
+}
+
+template<typename K, typename V>
+const typename ConcurrentHashTable<K, V>::Node*
+ConcurrentHashTable<K, V>::find_node(const Segment& segment, const K& key, uint64_t hash) const {
+    // Caller holds a ReadGuard (or the segment mutex)
+    const BucketArray* array = segment.buckets.load(std::memory_order_acquire);
+    const Node* node = array->slots[hash & (array->capacity - 1)].load(std::memory_order_acquire);
+    while (node) {
+        if (node->hash == hash && node->key == key) {
+            return node;
+        }
+        node = node->next.load(std::memory_order_acquire);
+    }
+    return nullptr;
+}
+
+template<typename K, typename V>
+void ConcurrentHashTable<K, V>::grow(Segment& segment) {
+    // Readers may be walking the old chains, so their next pointers cannot be
+    // rewritten in place. Copy every node into a fresh array, publish it, and
+    // retire the old array together with its nodes.
+    BucketArray* old_array = segment.buckets.load(std::memory_order_relaxed);
+    BucketArray* fresh = new (std::nothrow) BucketArray(old_array->capacity * 2);
+    if (!fresh) {
+        return;
+    }
+
+    std::vector<Node*> copied;
+    copied.reserve(segment.size.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < old_array->capacity; ++i) {
+        for (Node* node = old_array->slots[i].load(std::memory_order_relaxed); node;
+             node = node->next.load(std::memory_order_relaxed)) {
+            std::atomic<Node*>& head = fresh->slots[node->hash & (fresh->capacity - 1)];
+            Node* copy = new (std::nothrow) Node(node->key, node->value, node->hash,
+                                                 head.load(std::memory_order_relaxed));
+            if (!copy) {
+                for (Node* created : copied) {
+                    delete created;
+                }
+                delete fresh;
+                return;
+            }
+            head.store(copy, std::memory_order_relaxed);
+            copied.push_back(copy);
+        }
+    }
+
+    segment.buckets.store(fresh, std::memory_order_release);
+    segment.resize_count.fetch_add(1, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < old_array->capacity; ++i) {
+        for (Node* node = old_array->slots[i].load(std::memory_order_relaxed); node;
+             node = node->next.load(std::memory_order_relaxed)) {
+            retire(segment, node);
+        }
+    }
+    retire(segment, old_array);
+}
+
+template<typename K, typename V>
+void ConcurrentHashTable<K, V>::retire(Segment& segment, Node* node) {
+    segment.retired_nodes[segment.epoch.load(std::memory_order_relaxed) & 1].push_back(node);
+}
+
+template<typename K, typename V>
+void ConcurrentHashTable<K, V>::retire(Segment& segment, BucketArray* buckets) {
+    segment.retired_buckets[segment.epoch.load(std::memory_order_relaxed) & 1].push_back(buckets);
+}
+
+template<typename K, typename V>
+void ConcurrentHashTable<K, V>::try_reclaim(Segment& segment) {
+    // Caller holds the segment mutex, so the epoch only moves here
+    uint64_t epoch = segment.epoch.load(std::memory_order_relaxed);
+    size_t previous = static_cast<size_t>((epoch + 1) & 1);
+
+    if (segment.readers[previous].load() != 0) {
+        return;
+    }
+
+    for (Node* node : segment.retired_nodes[previous]) {
+        delete node;
+    }
+    for (BucketArray* array : segment.retired_buckets[previous]) {
+        delete array;
+    }
+    segment.retired_nodes[previous].clear();
+    segment.retired_buckets[previous].clear();
+
+    segment.epoch.store(epoch + 1);
+}
+
+// HashTableFactory
+
+namespace hash_table_detail {
+
+inline size_t capacity_for(size_t expected_size, float load_factor) {
+    return static_cast<size_t>(static_cast<double>(expected_size) / load_factor) + 1;
+}
+
+} // namespace hash_table_detail
+
+template<typename K, typename V>
+std::unique_ptr<HashTable<K, V>> HashTableFactory::create_for_cache(
+    size_t expected_size, MemoryPool* pool) {
+    HashTableConfig config = get_cache_config();
+    config.initial_capacity = hash_table_detail::capacity_for(expected_size, config.load_factor_threshold);
+    return std::make_unique<HashTable<K, V>>(config, pool);
+}
+
+template<typename K, typename V>
+std::unique_ptr<HashTable<K, V>> HashTableFactory::create_for_database(
+    size_t expected_size, MemoryPool* pool) {
+    HashTableConfig config = get_database_config();
+    config.initial_capacity = hash_table_detail::capacity_for(expected_size, config.load_factor_threshold);
+    return std::make_unique<HashTable<K, V>>(config, pool);
+}
+
+template<typename K, typename V>
+std::unique_ptr<HashTable<K, V>> HashTableFactory::create_for_real_time(
+    size_t expected_size, MemoryPool* pool) {
+    HashTableConfig config = get_real_time_config();
+    config.initial_capacity = hash_table_detail::capacity_for(expected_size, config.load_factor_threshold);
+    return std::make_unique<HashTable<K, V>>(config, pool);
+}
+
+template<typename K, typename V>
+std::unique_ptr<ConcurrentHashTable<K, V>> HashTableFactory::create_concurrent(
+    size_t expected_size, size_t thread_count, MemoryPool* pool) {
+    // A few segments per writer keeps mutex contention low; 0 means unknown
+    size_t segments = thread_count
+        ? hash_table_detail::next_power_of_two(thread_count * 4)
+        : 16;
+
+    HashTableConfig config;
+    config.initial_capacity = hash_table_detail::capacity_for(expected_size, config.load_factor_threshold);
+    return std::make_unique<ConcurrentHashTable<K, V>>(segments, config, pool);
+}
+
+} // namespace data_structures
@@ -1,19 +1,161 @@
 #include "memory_pool.h"
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 namespace data_structures {
 
+namespace {
+
+// Candidate block sizes: powers of two with a midpoint class between each pair
+constexpr uint32_t SIZE_CLASS_CANDIDATES[] = {
+    8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048
+};
+constexpr size_t MIN_SLAB_SIZE = 4096;
+constexpr uint32_t SLAB_MAGIC = 0x51AB51AB;
+
+// Pools with live thread caches; guards cache flushes racing pool destruction
+std::mutex& cache_registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<uint64_t>& live_cache_pools() {
+    static std::vector<uint64_t> ids;
+    return ids;
+}
+
+std::atomic<uint64_t> next_pool_id{1};
+
+inline size_t bitmap_words(size_t blocks) { return (blocks + 63) / 64; }
+
+inline uint32_t lowest_bit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_ctzll(word));
+#else
+    uint32_t bit = 0;
+    while (!(word & 1)) { word >>= 1; ++bit; }
+    return bit;
+#endif
+}
+
+} // namespace
+
+// One slab_size-aligned run of equal blocks. The header and free bitmap
+// (bit set = free) sit at the start, so a block finds its slab by masking.
+struct MemoryPool::Slab {
+    uint32_t magic;
+    uint32_t size_class;
+    MemoryPool* owner;
+    Slab* next;        // Partial list of its class
+    Slab* prev;
+    Slab* next_all;    // Every slab of the pool
+    Slab* prev_all;
+    uint8_t* blocks;
+    uint32_t block_size;
+    uint32_t block_count;
+    uint32_t free_count;
+    uint32_t hint;     // Lowest bitmap word that may hold a free bit
+
+    uint64_t* bitmap() { return reinterpret_cast<uint64_t*>(this + 1); }
+};
+
+// Per-thread stacks of free blocks, one entry per recently used pool
+struct MemoryPool::ThreadCache {
+    static constexpr size_t POOLS = 4;
+    static constexpr size_t CAPACITY = 32;
+
+    struct Entry {
+        MemoryPool* pool;
+        uint64_t pool_id;
+        uint16_t counts[MAX_SIZE_CLASSES];
+        void* blocks[MAX_SIZE_CLASSES][CAPACITY];
+    };
+
+    Entry entries[POOLS];
+    size_t next_victim;
+
+    ~ThreadCache() {
+        for (Entry& entry : entries) {
+            flush(entry);
+        }
+    }
+
+    static ThreadCache& local() {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    Entry* find(MemoryPool* pool) {
+        Entry* slot = nullptr;
+        for (Entry& entry : entries) {
+            if (entry.pool == pool) {
+                if (entry.pool_id == pool->pool_id_) {
+                    return &entry;
+                }
+                // A destroyed pool's address was reused; its blocks are gone
+                entry.pool = nullptr;
+            }
+            if (!slot && !entry.pool) {
+                slot = &entry;
+            }
+        }
+
+        if (!slot) {
+            slot = &entries[next_victim];
+            next_victim = (next_victim + 1) % POOLS;
+            flush(*slot);
+        }
+
+        slot->pool = pool;
+        slot->pool_id = pool->pool_id_;
+        std::memset(slot->counts, 0, sizeof(slot->counts));
+        return slot;
+    }
+
+    // Returns cached blocks to their pool if it still exists
+    static void flush(Entry& entry) {
+        if (!entry.pool) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> guard(cache_registry_mutex());
+            const std::vector<uint64_t>& live = live_cache_pools();
+            if (std::find(live.begin(), live.end(), entry.pool_id) != live.end()) {
+                for (size_t cls = 0; cls < MAX_SIZE_CLASSES; ++cls) {
+                    entry.pool->release_blocks(entry.blocks[cls], entry.counts[cls]);
+                }
+            }
+        }
+
+        entry.pool = nullptr;
+        std::memset(entry.counts, 0, sizeof(entry.counts));
+    }
+};
+
 MemoryPool::MemoryPool(const PoolConfig& config)
     : config_(config), pool_memory_(nullptr), total_size_(0), used_size_(0),
       peak_usage_(0), allocation_count_(0), free_count_(0),
-      free_list_head_(nullptr), used_list_head_(nullptr) {
+      free_list_head_(nullptr), used_list_head_(nullptr),
+      size_class_count_(0), slab_size_(0), slabs_(nullptr), slab_bytes_(0),
+      slab_used_(0), pool_id_(next_pool_id.fetch_add(1, std::memory_order_relaxed)),
+      thread_cache_enabled_(false) {
     initialize_pool();
+    initialize_size_classes();
 }
 
 MemoryPool::~MemoryPool() {
+    if (thread_cache_enabled_) {
+        // After this no thread cache hands blocks back to us
+        std::lock_guard<std::mutex> guard(cache_registry_mutex());
+        std::vector<uint64_t>& live = live_cache_pools();
+        live.erase(std::remove(live.begin(), live.end(), pool_id_), live.end());
+    }
+    cleanup_size_classes();
     cleanup_pool();
 }
 
@@ -50,6 +192,313 @@ void MemoryPool::cleanup_pool() {
     used_size_ = 0;
 }
 
+void MemoryPool::initialize_size_classes() {
+    if (config_.strategy != PoolStrategy::SIZE_CLASS || !is_initialized()) {
+        return;
+    }
+
+    slab_size_ = MIN_SLAB_SIZE;
+    while (slab_size_ < config_.slab_size && slab_size_ <= SIZE_MAX / 2) {
+        slab_size_ <<= 1;
+    }
+
+    // Blocks start past the header and bitmap, aligned like arena blocks
+    size_t align = std::max<size_t>(config_.alignment, alignof(std::max_align_t));
+    for (uint32_t candidate : SIZE_CLASS_CANDIDATES) {
+        if (candidate % config_.alignment != 0 || size_class_count_ == MAX_SIZE_CLASSES) {
+            continue;
+        }
+
+        size_t count = (slab_size_ - sizeof(Slab)) / candidate;
+        size_t offset = 0;
+        while (count > 0) {
+            offset = align_size(sizeof(Slab) + bitmap_words(count) * sizeof(uint64_t), align);
+            if (offset + count * candidate <= slab_size_) {
+                break;
+            }
+            count--;
+        }
+        if (count < 2) {
+            continue;  // Slab too small for this class to pay off
+        }
+
+        SizeClass& sc = size_classes_[size_class_count_++];
+        sc.block_size = candidate;
+        sc.block_count = static_cast<uint32_t>(count);
+        sc.blocks_offset = static_cast<uint32_t>(offset);
+        sc.partial = nullptr;
+    }
+
+    // Sizes above the largest usable class map to size_class_count_ (free list)
+    size_t cls = 0;
+    for (size_t unit = 0; unit <= MAX_SMALL_SIZE / 8; ++unit) {
+        while (cls < size_class_count_ && size_classes_[cls].block_size < unit * 8) {
+            cls++;
+        }
+        class_lookup_[unit] = static_cast<uint8_t>(cls);
+    }
+
+    if (config_.enable_thread_cache && size_class_count_ > 0) {
+        std::lock_guard<std::mutex> guard(cache_registry_mutex());
+        live_cache_pools().push_back(pool_id_);
+        thread_cache_enabled_ = true;
+    }
+}
+
+void MemoryPool::cleanup_size_classes() {
+    while (slabs_) {
+        Slab* next = slabs_->next_all;
+        std::free(slabs_);
+        slabs_ = next;
+    }
+    for (size_t i = 0; i < size_class_count_; ++i) {
+        size_classes_[i].partial = nullptr;
+    }
+    slab_bytes_ = 0;
+    slab_used_ = 0;
+}
+
+MemoryPool::Slab* MemoryPool::create_slab(size_t size_class) {
+    uint8_t* memory = static_cast<uint8_t*>(std::aligned_alloc(slab_size_, slab_size_));
+    if (!memory) {
+        return nullptr;
+    }
+
+    SizeClass& sc = size_classes_[size_class];
+    Slab* slab = reinterpret_cast<Slab*>(memory);
+    slab->magic = SLAB_MAGIC;
+    slab->size_class = static_cast<uint32_t>(size_class);
+    slab->owner = this;
+    slab->blocks = memory + sc.blocks_offset;
+    slab->block_size = sc.block_size;
+    slab->block_count = sc.block_count;
+    slab->free_count = sc.block_count;
+    slab->hint = 0;
+
+    uint64_t* bitmap = slab->bitmap();
+    size_t words = bitmap_words(sc.block_count);
+    for (size_t w = 0; w < words; ++w) {
+        bitmap[w] = ~uint64_t(0);
+    }
+    if (sc.block_count % 64 != 0) {
+        bitmap[words - 1] = (uint64_t(1) << (sc.block_count % 64)) - 1;
+    }
+
+    slab->prev = nullptr;
+    slab->next = sc.partial;
+    if (sc.partial) {
+        sc.partial->prev = slab;
+    }
+    sc.partial = slab;
+
+    slab->prev_all = nullptr;
+    slab->next_all = slabs_;
+    if (slabs_) {
+        slabs_->prev_all = slab;
+    }
+    slabs_ = slab;
+
+    slab_bytes_ += slab_size_;
+    return slab;
+}
+
+void MemoryPool::destroy_slab(Slab* slab) {
+    SizeClass& sc = size_classes_[slab->size_class];
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else if (sc.partial == slab) {
+        sc.partial = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+
+    if (slab->prev_all) {
+        slab->prev_all->next_all = slab->next_all;
+    } else {
+        slabs_ = slab->next_all;
+    }
+    if (slab->next_all) {
+        slab->next_all->prev_all = slab->prev_all;
+    }
+
+    slab->magic = 0;
+    slab_bytes_ -= slab_size_;
+    std::free(slab);
+}
+
+void* MemoryPool::take_block(size_t size_class) {
+    SizeClass& sc = size_classes_[size_class];
+    Slab* slab = sc.partial;
+    if (!slab) {
+        slab = create_slab(size_class);
+        if (!slab) {
+            return nullptr;
+        }
+    }
+
+    // Partial slabs always have a set bit at or after the hint
+    uint64_t* bitmap = slab->bitmap();
+    uint32_t word = slab->hint;
+    while (bitmap[word] == 0) {
+        word++;
+    }
+    uint32_t bit = lowest_bit(bitmap[word]);
+    bitmap[word] &= bitmap[word] - 1;
+    slab->hint = word;
+
+    if (--slab->free_count == 0) {
+        // Full slabs leave the partial list until a block comes back
+        sc.partial = slab->next;
+        if (sc.partial) {
+            sc.partial->prev = nullptr;
+        }
+        slab->next = slab->prev = nullptr;
+    }
+
+    slab_used_ += slab->block_size;
+    peak_usage_ = std::max(peak_usage_, used_size_ + slab_used_);
+    allocation_count_++;
+    return slab->blocks + (static_cast<size_t>(word) * 64 + bit) * slab->block_size;
+}
+
+void MemoryPool::release_block(Slab* slab, void* ptr) {
+    size_t index = static_cast<size_t>(static_cast<uint8_t*>(ptr) - slab->blocks) / slab->block_size;
+    uint64_t* bitmap = slab->bitmap();
+    uint32_t word = static_cast<uint32_t>(index / 64);
+    uint64_t mask = uint64_t(1) << (index % 64);
+
+    if (bitmap[word] & mask) {
+        if (config_.enable_debug) {
+            std::cerr << "Double free of size-class block: " << ptr << std::endl;
+        }
+        return;
+    }
+
+    bitmap[word] |= mask;
+    slab->hint = std::min(slab->hint, word);
+    slab_used_ -= slab->block_size;
+    free_count_++;
+
+    SizeClass& sc = size_classes_[slab->size_class];
+    if (++slab->free_count == 1) {
+        slab->prev = nullptr;
+        slab->next = sc.partial;
+        if (sc.partial) {
+            sc.partial->prev = slab;
+        }
+        sc.partial = slab;
+    } else if (slab->free_count == slab->block_count &&
+               (slab->prev || slab->next)) {
+        // Keep one empty slab per class so alloc/free at a boundary doesn't thrash
+        destroy_slab(slab);
+    }
+}
+
+void MemoryPool::release_blocks(void* const* blocks, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (config_.enable_thread_safety) {
+        lock.lock();
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        release_block(find_slab(blocks[i]), blocks[i]);
+    }
+}
+
+MemoryPool::Slab* MemoryPool::find_slab(const void* ptr) const {
+    if (size_class_count_ == 0 || !ptr) {
+        return nullptr;
+    }
+
+    uintptr_t addr = reinterpret_cast<uintptr_t>(ptr);
+    Slab* slab = reinterpret_cast<Slab*>(addr & ~static_cast<uintptr_t>(slab_size_ - 1));
+    if (!slab || slab->magic != SLAB_MAGIC || slab->owner != this) {
+        return nullptr;
+    }
+
+    const uint8_t* p = static_cast<const uint8_t*>(ptr);
+    if (p < slab->blocks) {
+        return nullptr;
+    }
+    size_t offset = static_cast<size_t>(p - slab->blocks);
+    if (offset % slab->block_size != 0 || offset / slab->block_size >= slab->block_count) {
+        return nullptr;
+    }
+    return slab;
+}
+
+void* MemoryPool::allocate_small(size_t size) {
+    size_t cls = class_lookup_[(size + 7) / 8];
+
+    if (thread_cache_enabled_) {
+        ThreadCache::Entry* cache = ThreadCache::local().find(this);
+        if (cache->counts[cls] == 0) {
+            // Refill half the stack in one locked pass
+            std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+            if (config_.enable_thread_safety) {
+                lock.lock();
+            }
+            size_t want = std::max<size_t>(1,
+                std::min(config_.thread_cache_blocks, ThreadCache::CAPACITY) / 2);
+            while (cache->counts[cls] < want) {
+                void* block = take_block(cls);
+                if (!block) {
+                    break;
+                }
+                cache->blocks[cls][cache->counts[cls]++] = block;
+            }
+            if (cache->counts[cls] == 0) {
+                return nullptr;
+            }
+        }
+        return cache->blocks[cls][--cache->counts[cls]];
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (config_.enable_thread_safety) {
+        lock.lock();
+    }
+    void* block = take_block(cls);
+
+    if (block && config_.enable_debug) {
+        log_allocation(block, size);
+    }
+    return block;
+}
+
+void MemoryPool::deallocate_small(void* ptr, Slab* slab) {
+    if (thread_cache_enabled_) {
+        ThreadCache::Entry* cache = ThreadCache::local().find(this);
+        size_t cls = slab->size_class;
+        size_t capacity = std::max<size_t>(1,
+            std::min(config_.thread_cache_blocks, ThreadCache::CAPACITY));
+        if (cache->counts[cls] >= capacity) {
+            // Hand the older half back so the stack keeps room for both directions
+            size_t keep = capacity / 2;
+            release_blocks(cache->blocks[cls], cache->counts[cls] - keep);
+            std::memmove(cache->blocks[cls], cache->blocks[cls] + (cache->counts[cls] - keep),
+                         keep * sizeof(void*));
+            cache->counts[cls] = static_cast<uint16_t>(keep);
+        }
+        cache->blocks[cls][cache->counts[cls]++] = ptr;
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
+    if (config_.enable_thread_safety) {
+        lock.lock();
+    }
+    if (config_.enable_debug) {
+        log_deallocation(ptr);
+    }
+    release_block(slab, ptr);
+}
+
 void* MemoryPool::allocate(size_t size) {
     if (size == 0) return nullptr;
 
@@ -58,6 +507,11 @@ void* MemoryPool::allocate(size_t size) {
         return nullptr;  // Graceful failure instead of crash
     }
 
+    if (size <= MAX_SMALL_SIZE && size_class_count_ > 0 &&
+        class_lookup_[(size + 7) / 8] < size_class_count_) {
+        return allocate_small(size);
+    }
+
     // WASI-compatible: Use proper conditional mutex locking
     std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
     if (config_.enable_thread_safety) {
@@ -90,7 +544,7 @@ void* MemoryPool::allocate(size_t size) {
     insert_used_block(block);
 
     used_size_ += block->size + sizeof(BlockHeader);
-    peak_usage_ = std::max(peak_usage_, used_size_);
+    peak_usage_ = std::max(peak_usage_, used_size_ + slab_used_);
     allocation_count_++;
 
     void* user_ptr = reinterpret_cast<uint8_t*>(block) + sizeof(BlockHeader);
@@ -121,6 +575,13 @@ void* MemoryPool::allocate_aligned(size_t size, size_t alignment) {
 void MemoryPool::deallocate(void* ptr) {
     if (!ptr) return;
 
+    if (size_class_count_ > 0 && !is_in_pool(ptr)) {
+        if (Slab* slab = find_slab(ptr)) {
+            deallocate_small(ptr, slab);
+            return;
+        }
+    }
+
     // WASI-compatible: Use proper conditional mutex locking
     std::unique_lock<std::mutex> lock(mutex_, std::defer_lock);
     if (config_.enable_thread_safety) {
@@ -326,7 +787,7 @@ MemoryStats MemoryPool::get_stats() const {
     }
 
     MemoryStats stats = {};
-    stats.current_usage = static_cast<uint32_t>(used_size_);
+    stats.current_usage = static_cast<uint32_t>(used_size_ + slab_used_);
     stats.peak_usage = static_cast<uint32_t>(peak_usage_);
     stats.allocation_count = allocation_count_;
     stats.free_count = free_count_;
@@ -347,6 +808,8 @@ MemoryStats MemoryPool::get_stats() const {
 
     stats.largest_free_block = static_cast<uint32_t>(largest_free);
     stats.free_block_count = free_blocks;
+    stats.size_class_reserved = static_cast<uint32_t>(slab_bytes_);
+    stats.size_class_used = static_cast<uint32_t>(slab_used_);
 
     if (free_size > 0) {
         stats.fragmentation_ratio = 1.0f - (static_cast<float>(largest_free) / free_size);
@@ -356,6 +819,9 @@ MemoryStats MemoryPool::get_stats() const {
 }
 
 bool MemoryPool::is_valid_pointer(void* ptr) const {
+    if (ptr && !is_in_pool(ptr) && find_slab(ptr)) {
+        return true;
+    }
     if (!ptr || !is_in_pool(ptr)) {
         return false;
     }
@@ -424,6 +890,23 @@ bool MemoryPool::validate_heap() const {
         current = current->next;
     }
 
+    // Every slab's free count must match its bitmap
+    for (Slab* slab = slabs_; slab; slab = slab->next_all) {
+        if (slab->magic != SLAB_MAGIC || slab->owner != this) {
+            return false;
+        }
+        uint32_t free_bits = 0;
+        uint64_t* bitmap = slab->bitmap();
+        for (size_t w = 0; w < bitmap_words(slab->block_count); ++w) {
+            for (uint64_t word = bitmap[w]; word; word &= word - 1) {
+                free_bits++;
+            }
+        }
+        if (free_bits != slab->free_count) {
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -37,6 +37,14 @@ struct MemoryStats {
     float fragmentation_ratio;
     uint32_t largest_free_block;
     uint32_t free_block_count;
+    uint32_t size_class_reserved;  // Slab bytes held by size classes
+    uint32_t size_class_used;      // Bytes of size-class blocks handed out
+};
+
+// Allocation strategy
+enum class PoolStrategy {
+    FREE_LIST,   // Best-fit free list over one growable arena
+    SIZE_CLASS   // Segregated slabs for small sizes; larger requests use the free list
 };
 
 // Memory pool configuration
@@ -49,17 +57,42 @@ struct PoolConfig {
     bool enable_defragmentation;
     float growth_factor;
 
+    // SIZE_CLASS mode: requests up to MemoryPool::MAX_SMALL_SIZE come from
+    // slabs of slab_size bytes (rounded up to a power of two). With
+    // enable_thread_cache each thread keeps up to thread_cache_blocks blocks
+    // per class, so most allocations and frees skip the pool mutex.
+    PoolStrategy strategy;
+    size_t slab_size;
+    bool enable_thread_cache;
+    size_t thread_cache_blocks;
+
     PoolConfig() : initial_size(1024 * 1024),     // 1MB
                    max_size(16 * 1024 * 1024),    // 16MB
                    alignment(8),
                    enable_debug(false),
                    enable_thread_safety(false),
                    enable_defragmentation(true),
-                   growth_factor(2.0f) {}
+                   growth_factor(2.0f),
+                   strategy(PoolStrategy::FREE_LIST),
+                   slab_size(64 * 1024),          // 64KB
+                   enable_thread_cache(false),
+                   thread_cache_blocks(16) {}
+
+    // Preset for small-object churn such as hash table nodes
+    static PoolConfig small_objects(bool thread_cache = false) {
+        PoolConfig config;
+        config.strategy = PoolStrategy::SIZE_CLASS;
+        config.enable_thread_cache = thread_cache;
+        config.enable_thread_safety = thread_cache;
+        return config;
+    }
 };
 
 class MemoryPool {
 public:
+    static constexpr size_t MAX_SIZE_CLASSES = 16;
+    static constexpr size_t MAX_SMALL_SIZE = 2048;  // Largest size-class request
+
     explicit MemoryPool(const PoolConfig& config = PoolConfig());
     ~MemoryPool();
 
@@ -123,6 +156,37 @@ private:
 
     mutable std::mutex mutex_;
 
+    // Size-class state (PoolStrategy::SIZE_CLASS)
+    struct Slab;
+    struct ThreadCache;
+    struct SizeClass {
+        uint32_t block_size;
+        uint32_t block_count;    // Blocks per slab
+        uint32_t blocks_offset;  // From slab start, past header and bitmap
+        Slab* partial;           // Slabs with at least one free block
+    };
+
+    SizeClass size_classes_[MAX_SIZE_CLASSES];
+    uint8_t class_lookup_[MAX_SMALL_SIZE / 8 + 1];  // (size + 7) / 8 -> class
+    size_t size_class_count_;
+    size_t slab_size_;
+    Slab* slabs_;       // Every slab, for validation and cleanup
+    size_t slab_bytes_;
+    size_t slab_used_;
+    uint64_t pool_id_;  // Tells pools apart in thread caches across address reuse
+    bool thread_cache_enabled_;
+
+    void initialize_size_classes();
+    void cleanup_size_classes();
+    void* allocate_small(size_t size);
+    void deallocate_small(void* ptr, Slab* slab);
+    Slab* create_slab(size_t size_class);
+    void destroy_slab(Slab* slab);
+    void* take_block(size_t size_class);        // Caller holds the mutex
+    void release_block(Slab* slab, void* ptr);  // Caller holds the mutex
+    void release_blocks(void* const* blocks, size_t count);
+    Slab* find_slab(const void* ptr) const;     // nullptr unless ptr is one of our blocks
+
     // Internal helper functions
     void initialize_pool();
     void cleanup_pool();
@@ -0,0 +1,180 @@
+#include "serializer.h"
+
+#include <cstring>
+
+namespace data_structures {
+
+namespace {
+
+constexpr size_t INDEX_SLOT_BYTES = 2 * sizeof(uint32_t);
+constexpr size_t LENGTH_BYTES = sizeof(uint32_t);
+
+// Unaligned little-endian accessors; wasm32 loads and stores are little-endian
+inline void store_u32(uint8_t* at, uint32_t value) { memcpy(at, &value, sizeof(value)); }
+
+inline uint32_t load_u32(const uint8_t* at) {
+    uint32_t value;
+    memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+// A length-prefixed record must fit inside its arena
+inline bool record_fits(const uint8_t* arena, uint32_t arena_size, uint32_t offset) {
+    if (offset > arena_size || arena_size - offset < LENGTH_BYTES) {
+        return false;
+    }
+    return load_u32(arena + offset) <= arena_size - offset - LENGTH_BYTES;
+}
+
+} // namespace
+
+// SnapshotWriter
+
+size_t SnapshotWriter::encoded_size(size_t entries, size_t key_bytes, size_t value_bytes) {
+    const uint64_t limit = UINT32_MAX;
+    uint64_t key_arena = static_cast<uint64_t>(entries) * LENGTH_BYTES + key_bytes;
+    uint64_t value_arena = static_cast<uint64_t>(entries) * LENGTH_BYTES + value_bytes;
+    if (entries > limit || key_arena > limit || value_arena > limit) {
+        return 0;
+    }
+    uint64_t total = sizeof(SnapshotHeader) + static_cast<uint64_t>(entries) * INDEX_SLOT_BYTES +
+                     key_arena + value_arena;
+    return total > SIZE_MAX ? 0 : static_cast<size_t>(total);
+}
+
+SnapshotWriter::SnapshotWriter(uint8_t* buffer, SnapshotKind kind, uint32_t entries,
+                               uint32_t key_bytes, uint32_t value_bytes)
+    : buffer_(buffer), kind_(kind), entries_(entries),
+      key_bytes_(entries * LENGTH_BYTES + key_bytes),
+      value_bytes_(entries * LENGTH_BYTES + value_bytes),
+      added_(0), key_cursor_(0), value_cursor_(0) {
+    index_ = buffer_ + sizeof(SnapshotHeader);
+    keys_ = index_ + static_cast<size_t>(entries_) * INDEX_SLOT_BYTES;
+    values_ = keys_ + key_bytes_;
+}
+
+bool SnapshotWriter::add(const void* key, uint32_t key_len, const void* value, uint32_t value_len) {
+    if (added_ == entries_ ||
+        key_bytes_ - key_cursor_ < LENGTH_BYTES ||
+        key_bytes_ - key_cursor_ - LENGTH_BYTES < key_len ||
+        value_bytes_ - value_cursor_ < LENGTH_BYTES ||
+        value_bytes_ - value_cursor_ - LENGTH_BYTES < value_len) {
+        return false;
+    }
+
+    uint8_t* slot = index_ + static_cast<size_t>(added_) * INDEX_SLOT_BYTES;
+    store_u32(slot, key_cursor_);
+    store_u32(slot + sizeof(uint32_t), value_cursor_);
+
+    store_u32(keys_ + key_cursor_, key_len);
+    if (key_len > 0) {
+        memcpy(keys_ + key_cursor_ + LENGTH_BYTES, key, key_len);
+    }
+    key_cursor_ += LENGTH_BYTES + key_len;
+
+    store_u32(values_ + value_cursor_, value_len);
+    if (value_len > 0) {
+        memcpy(values_ + value_cursor_ + LENGTH_BYTES, value, value_len);
+    }
+    value_cursor_ += LENGTH_BYTES + value_len;
+
+    added_++;
+    return true;
+}
+
+bool SnapshotWriter::finish(bool sorted) {
+    if (added_ != entries_ || key_cursor_ != key_bytes_ || value_cursor_ != value_bytes_) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.kind = static_cast<uint8_t>(kind_);
+    header.flags = sorted ? SNAPSHOT_FLAG_SORTED : 0;
+    header.entry_count = entries_;
+    header.key_arena_size = key_bytes_;
+    header.value_arena_size = value_bytes_;
+    header.reserved = 0;
+    memcpy(buffer_, &header, sizeof(header));
+    return true;
+}
+
+// SnapshotView
+
+SnapshotView::SnapshotView()
+    : header_(), index_(nullptr), keys_(nullptr), values_(nullptr), payload_bytes_(0) {}
+
+bool SnapshotView::open(const uint8_t* data, size_t size) {
+    *this = SnapshotView();
+    if (!data || size < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) {
+        return false;
+    }
+    if (header.kind != static_cast<uint8_t>(SnapshotKind::HASH_TABLE) &&
+        header.kind != static_cast<uint8_t>(SnapshotKind::BTREE)) {
+        return false;
+    }
+
+    uint64_t expected = sizeof(SnapshotHeader) +
+                        static_cast<uint64_t>(header.entry_count) * INDEX_SLOT_BYTES +
+                        header.key_arena_size + header.value_arena_size;
+    if (expected != size) {
+        return false;
+    }
+
+    const uint8_t* index = data + sizeof(SnapshotHeader);
+    const uint8_t* keys = index + static_cast<size_t>(header.entry_count) * INDEX_SLOT_BYTES;
+    const uint8_t* values = keys + header.key_arena_size;
+
+    // One bounds pass over the index; afterwards key()/value() need no checks
+    size_t payload = 0;
+    std::string_view previous;
+    bool sorted = (header.flags & SNAPSHOT_FLAG_SORTED) != 0;
+    for (uint32_t i = 0; i < header.entry_count; ++i) {
+        const uint8_t* slot = index + static_cast<size_t>(i) * INDEX_SLOT_BYTES;
+        uint32_t key_offset = load_u32(slot);
+        uint32_t value_offset = load_u32(slot + sizeof(uint32_t));
+        if (!record_fits(keys, header.key_arena_size, key_offset) ||
+            !record_fits(values, header.value_arena_size, value_offset)) {
+            return false;
+        }
+
+        uint32_t key_len = load_u32(keys + key_offset);
+        payload += key_len + load_u32(values + value_offset);
+
+        if (sorted) {
+            std::string_view current(reinterpret_cast<const char*>(keys + key_offset + LENGTH_BYTES),
+                                     key_len);
+            if (i > 0 && !(previous < current)) {
+                return false;
+            }
+            previous = current;
+        }
+    }
+
+    header_ = header;
+    index_ = index;
+    keys_ = keys;
+    values_ = values;
+    payload_bytes_ = payload;
+    return true;
+}
+
+std::string_view SnapshotView::key(uint32_t index) const {
+    const uint8_t* record = keys_ + load_u32(index_ + static_cast<size_t>(index) * INDEX_SLOT_BYTES);
+    return std::string_view(reinterpret_cast<const char*>(record + LENGTH_BYTES), load_u32(record));
+}
+
+ByteView SnapshotView::value(uint32_t index) const {
+    const uint8_t* slot = index_ + static_cast<size_t>(index) * INDEX_SLOT_BYTES;
+    const uint8_t* record = values_ + load_u32(slot + sizeof(uint32_t));
+    return ByteView{record + LENGTH_BYTES, load_u32(record)};
+}
+
+} // namespace data_structures
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace data_structures {
+
+/**
+ * Flat binary snapshot of a key/value collection, optimized for WebAssembly.
+ *
+ * Layout (little-endian, the byte order of wasm32):
+ *
+ *   header      SnapshotHeader
+ *   index       entry_count x { u32 key_offset, u32 value_offset }
+ *   key arena   per entry: u32 length, key bytes
+ *   value arena per entry: u32 length, value bytes
+ *
+ * Offsets are relative to the start of their arena. A reader validates the
+ * header and every index slot once, then hands out views straight into the
+ * buffer, so loading never decodes entries one at a time.
+ */
+
+constexpr uint32_t SNAPSHOT_MAGIC = 0x53534457;  // "WDSS"
+constexpr uint16_t SNAPSHOT_VERSION = 1;
+constexpr uint8_t SNAPSHOT_FLAG_SORTED = 0x01;   // Keys strictly ascending in index order
+
+enum class SnapshotKind : uint8_t {
+    HASH_TABLE = 1,
+    BTREE = 2,
+};
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t kind;
+    uint8_t flags;
+    uint32_t entry_count;
+    uint32_t key_arena_size;
+    uint32_t value_arena_size;
+    uint32_t reserved;
+};
+static_assert(sizeof(SnapshotHeader) == 24, "snapshot header must stay packed");
+
+// Bytes of one entry in place inside a snapshot buffer
+struct ByteView {
+    const uint8_t* data;
+    uint32_t size;
+};
+
+// Writes a snapshot into a caller-provided buffer sized by encoded_size()
+class SnapshotWriter {
+public:
+    // Total bytes for the given shape; 0 if it would not fit the 32-bit offsets
+    static size_t encoded_size(size_t entries, size_t key_bytes, size_t value_bytes);
+
+    SnapshotWriter(uint8_t* buffer, SnapshotKind kind, uint32_t entries,
+                   uint32_t key_bytes, uint32_t value_bytes);
+
+    // False once the entry or arena budget given to the constructor is exceeded
+    bool add(const void* key, uint32_t key_len, const void* value, uint32_t value_len);
+    // Writes the header; false unless exactly the planned entries were added
+    bool finish(bool sorted);
+
+private:
+    uint8_t* buffer_;
+    SnapshotKind kind_;
+    uint32_t entries_;
+    uint32_t key_bytes_;
+    uint32_t value_bytes_;
+    uint32_t added_;
+    uint32_t key_cursor_;
+    uint32_t value_cursor_;
+    uint8_t* index_;
+    uint8_t* keys_;
+    uint8_t* values_;
+};
+
+// Read-only view over a snapshot buffer; the buffer must outlive the view
+class SnapshotView {
+public:
+    SnapshotView();
+
+    // Validates the header and every index slot against the arenas; no copies
+    bool open(const uint8_t* data, size_t size);
+
+    SnapshotKind kind() const { return static_cast<SnapshotKind>(header_.kind); }
+    bool sorted() const { return (header_.flags & SNAPSHOT_FLAG_SORTED) != 0; }
+    uint32_t size() const { return header_.entry_count; }
+    // Raw key and value bytes, without lengths, index or header
+    size_t payload_bytes() const { return payload_bytes_; }
+
+    std::string_view key(uint32_t index) const;
+    ByteView value(uint32_t index) const;
+
+private:
+    SnapshotHeader header_;
+    const uint8_t* index_;
+    const uint8_t* keys_;
+    const uint8_t* values_;
+    size_t payload_bytes_;
+};
+
+} // namespace data_structures
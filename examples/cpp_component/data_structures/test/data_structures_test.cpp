@@ -0,0 +1,124 @@
+#include "../src/data_structures.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Test framework (simple assertions)
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::cerr << "ASSERTION FAILED: " << #condition << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_FALSE(condition) ASSERT_TRUE(!(condition))
+#define ASSERT_EQ(expected, actual) ASSERT_TRUE((expected) == (actual))
+
+using namespace data_structures;
+
+namespace {
+
+constexpr uint32_t kBloomBitsPerKey = 10;
+constexpr int kKeys = 500;
+
+std::string key_for(int i) {
+    return "key-" + std::to_string(i);
+}
+
+std::vector<uint8_t> value_for(int i) {
+    return {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+}
+
+template <typename Structure>
+std::vector<uint8_t> snapshot_of(const Structure& structure) {
+    std::vector<uint8_t> buffer(structure.snapshot_size());
+    ASSERT_FALSE(buffer.empty());
+    ASSERT_TRUE(structure.write_snapshot(buffer.data()));
+    return buffer;
+}
+
+} // namespace
+
+class DataStructuresTest {
+public:
+    void run_all_tests() {
+        std::cout << "Running data structures tests..." << std::endl;
+        test_filtered_btree_snapshot_round_trip();
+        test_filtered_hash_table_snapshot_round_trip();
+        test_hash_table_snapshot_into_filtered_btree();
+        std::cout << "All tests passed!" << std::endl;
+    }
+
+private:
+    // deserialize_btree loads into a new tree with the old tree's
+    // bloom_bits_per_key; the filter must cover the loaded keys
+    void test_filtered_btree_snapshot_round_trip() {
+        SimpleBTree source("source", kBloomBitsPerKey);
+        for (int i = 0; i < kKeys; ++i) {
+            ASSERT_TRUE(source.insert(key_for(i), value_for(i)));
+        }
+        std::vector<uint8_t> buffer = snapshot_of(source);
+
+        SnapshotView snapshot;
+        ASSERT_TRUE(snapshot.open(buffer.data(), buffer.size()));
+        SimpleBTree loaded("loaded", kBloomBitsPerKey);
+        ASSERT_TRUE(loaded.load_snapshot(snapshot));
+        ASSERT_EQ(static_cast<uint32_t>(kKeys), loaded.key_count());
+
+        for (int i = 0; i < kKeys; ++i) {
+            std::optional<std::vector<uint8_t>> value = loaded.search(key_for(i));
+            ASSERT_TRUE(value.has_value());
+            ASSERT_TRUE(*value == value_for(i));
+        }
+        ASSERT_FALSE(loaded.search("missing").has_value());
+
+        ASSERT_TRUE(loaded.remove(key_for(7)));
+        ASSERT_FALSE(loaded.search(key_for(7)).has_value());
+        ASSERT_TRUE(loaded.insert(key_for(kKeys), value_for(kKeys)));
+        ASSERT_TRUE(loaded.search(key_for(kKeys)).has_value());
+    }
+
+    void test_filtered_hash_table_snapshot_round_trip() {
+        SimpleHashTable source("source", kBloomBitsPerKey);
+        for (int i = 0; i < kKeys; ++i) {
+            ASSERT_TRUE(source.put(key_for(i), value_for(i)));
+        }
+        std::vector<uint8_t> buffer = snapshot_of(source);
+
+        SnapshotView snapshot;
+        ASSERT_TRUE(snapshot.open(buffer.data(), buffer.size()));
+        SimpleHashTable loaded("loaded", kBloomBitsPerKey);
+        ASSERT_TRUE(loaded.load_snapshot(snapshot));
+
+        for (int i = 0; i < kKeys; ++i) {
+            ASSERT_TRUE(loaded.get(key_for(i)).has_value());
+        }
+        ASSERT_TRUE(loaded.remove(key_for(3)));
+        ASSERT_FALSE(loaded.contains(key_for(3)));
+    }
+
+    // Unsorted snapshots take the index-permutation path in load_snapshot
+    void test_hash_table_snapshot_into_filtered_btree() {
+        SimpleHashTable source("source");
+        for (int i = 0; i < kKeys; ++i) {
+            ASSERT_TRUE(source.put(key_for(i), value_for(i)));
+        }
+        std::vector<uint8_t> buffer = snapshot_of(source);
+
+        SnapshotView snapshot;
+        ASSERT_TRUE(snapshot.open(buffer.data(), buffer.size()));
+        SimpleBTree loaded("loaded", kBloomBitsPerKey);
+        ASSERT_TRUE(loaded.load_snapshot(snapshot));
+
+        for (int i = 0; i < kKeys; ++i) {
+            ASSERT_TRUE(loaded.search(key_for(i)).has_value());
+        }
+    }
+};
+
+int main() {
+    DataStructuresTest test;
+    test.run_all_tests();
+    return 0;
+}
@@ -0,0 +1,165 @@
+// Hash function benchmark: throughput and bucket quality per algorithm by key length.
+//
+// Built as a WASI CLI binary and executed under wasmtime:
+//   bazel build //examples/cpp_component/data_structures:hash_benchmark_run
+// Results land in bazel-bin/.../hash_benchmark_run_output.log.
+
+#include "hash_table.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+using namespace data_structures;
+
+namespace {
+
+struct Algorithm {
+    const char* name;
+    HashAlgorithm algo;
+};
+
+const Algorithm ALGORITHMS[] = {
+    {"fnv1a", HashAlgorithm::FNV1A},
+    {"murmur3", HashAlgorithm::MURMUR3},
+    {"xxhash", HashAlgorithm::XXHASH},
+    {"siphash", HashAlgorithm::SIP_HASH},
+    {"cityhash", HashAlgorithm::CITY_HASH},
+    {"wide", HashAlgorithm::WIDE},
+};
+
+const size_t KEY_LENGTHS[] = {4, 8, 12, 16, 24, 32, 48, 64, 128, 256, 1024, 4096};
+
+constexpr size_t QUALITY_KEYS = 1 << 16;  // Also the bucket count for the quality test
+constexpr size_t TAG_BUCKETS = 128;       // 7-bit tags used by SIMD_GROUP_PROBING
+constexpr size_t THROUGHPUT_BYTES = 16 << 20;
+
+// Fixed-length keys, one after another in a flat buffer
+struct KeySet {
+    size_t length;
+    size_t count;
+    std::vector<uint8_t> bytes;
+
+    const uint8_t* key(size_t i) const { return bytes.data() + i * length; }
+};
+
+// Sequential ids ("----...001a") as they show up in real tables: a shared
+// prefix, with the distinguishing base-62 digits at the end
+KeySet make_id_keys(size_t length, size_t count) {
+    static const char DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    KeySet set{length, count, std::vector<uint8_t>(length * count, '-')};
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t* key = set.bytes.data() + i * length;
+        size_t value = i;
+        for (size_t pos = length; pos > 0 && (value > 0 || pos == length); --pos) {
+            key[pos - 1] = static_cast<uint8_t>(DIGITS[value % 62]);
+            value /= 62;
+        }
+    }
+    return set;
+}
+
+KeySet make_random_keys(size_t length, size_t count, uint32_t seed) {
+    KeySet set{length, count, std::vector<uint8_t>(length * count)};
+    std::mt19937 rng(seed);
+    for (uint8_t& b : set.bytes) {
+        b = static_cast<uint8_t>(rng());
+    }
+    return set;
+}
+
+double now_ns() {
+    using namespace std::chrono;
+    return static_cast<double>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+// Nanoseconds per hash over a working set that stays in cache
+double measure_ns_per_hash(const Algorithm& algorithm, const KeySet& keys) {
+    size_t rounds = std::max<size_t>(1, THROUGHPUT_BYTES / (keys.length * keys.count));
+    volatile uint64_t sink = 0;
+    uint64_t acc = 0;
+
+    // Warm-up pass
+    for (size_t i = 0; i < keys.count; ++i) {
+        acc ^= HashFunctions::hash(keys.key(i), keys.length, algorithm.algo);
+    }
+
+    double start = now_ns();
+    for (size_t r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < keys.count; ++i) {
+            acc += HashFunctions::hash(keys.key(i), keys.length, algorithm.algo, r);
+        }
+    }
+    double elapsed = now_ns() - start;
+    sink = acc;
+    (void)sink;
+    return elapsed / static_cast<double>(rounds * keys.count);
+}
+
+struct Quality {
+    double bucket_ratio;   // Colliding keys in a power-of-two table / ideal random
+    double tag_chi2;       // Chi-squared of the top-7-bit tags over dof (1.0 ideal)
+    size_t full_collisions;  // Equal 64-bit hashes for distinct keys
+};
+
+Quality measure_quality(const Algorithm& algorithm, const KeySet& keys) {
+    std::vector<uint8_t> occupied(QUALITY_KEYS, 0);
+    std::vector<size_t> tags(TAG_BUCKETS, 0);
+    std::unordered_set<uint64_t> seen;
+    seen.reserve(keys.count * 2);
+
+    size_t collisions = 0;
+    size_t full = 0;
+    for (size_t i = 0; i < keys.count; ++i) {
+        uint64_t h = HashFunctions::hash(keys.key(i), keys.length, algorithm.algo);
+        uint8_t& slot = occupied[h & (QUALITY_KEYS - 1)];
+        collisions += slot;
+        slot = 1;
+        tags[h >> 57]++;
+        full += seen.insert(h).second ? 0 : 1;
+    }
+
+    double n = static_cast<double>(keys.count);
+    double m = static_cast<double>(QUALITY_KEYS);
+    double ideal = n - m * (1.0 - std::pow(1.0 - 1.0 / m, n));
+
+    double expected_tag = n / TAG_BUCKETS;
+    double chi2 = 0;
+    for (size_t count : tags) {
+        double d = static_cast<double>(count) - expected_tag;
+        chi2 += d * d / expected_tag;
+    }
+
+    return Quality{static_cast<double>(collisions) / ideal, chi2 / (TAG_BUCKETS - 1), full};
+}
+
+} // namespace
+
+int main() {
+    std::printf("Hash benchmark: ns/hash and MB/s on cached keys; bucket quality on %zu keys\n",
+                QUALITY_KEYS);
+    std::printf("bucket = colliding keys / ideal random (1.00 ideal); tag = chi2/dof of top 7 bits\n\n");
+
+    for (size_t length : KEY_LENGTHS) {
+        size_t working_set = std::max<size_t>(16, std::min<size_t>(4096, (256 << 10) / length));
+        KeySet random_keys = make_random_keys(length, working_set, static_cast<uint32_t>(length));
+        KeySet id_keys = make_id_keys(length, QUALITY_KEYS);
+
+        std::printf("key length %zu\n", length);
+        std::printf("  %-9s %9s %9s %11s %8s %6s\n", "algorithm", "ns/hash", "MB/s", "bucket(id)",
+                    "tag(id)", "dup64");
+        for (const Algorithm& algorithm : ALGORITHMS) {
+            double ns = measure_ns_per_hash(algorithm, random_keys);
+            Quality quality = measure_quality(algorithm, id_keys);
+            std::printf("  %-9s %9.2f %9.1f %11.3f %8.2f %6zu\n", algorithm.name, ns,
+                        static_cast<double>(length) * 1e3 / ns, quality.bucket_ratio,
+                        quality.tag_chi2, quality.full_collisions);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Hash table operation benchmarks for cpp_wasm_benchmark.
+//
+// AOT-compiled and run under wasmtime by:
+//   bazel build //examples/cpp_component/data_structures:hash_table_benchmark
+// Results land in bazel-bin/.../hash_table_benchmark.json. Entries and
+// bucket arrays come from one MemoryPool, whose allocation count is the
+// allocations_per_op column.
+
+#include "hash_table.h"
+#include "wasm_benchmark.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace data_structures;
+
+namespace {
+
+using Table = HashTable<uint64_t, uint64_t>;
+
+constexpr size_t kTableKeys = 1 << 14;
+constexpr size_t kKeyMask = kTableKeys - 1;
+
+MemoryPool& entry_pool() {
+    static MemoryPool pool(PoolConfig::small_objects());
+    return pool;
+}
+
+wasm_benchmark::AllocationCounts pool_allocations(void*) {
+    // MemoryStats counts allocations but not the bytes they asked for
+    wasm_benchmark::AllocationCounts counts;
+    counts.allocations = entry_pool().get_stats().allocation_count;
+    return counts;
+}
+
+// splitmix64 sequence: well-mixed keys like ids from a random source
+std::vector<uint64_t> make_keys(size_t count, uint64_t seed) {
+    std::vector<uint64_t> keys(count);
+    uint64_t state = seed;
+    for (uint64_t& key : keys) {
+        state += 0x9e3779b97f4a7c15ull;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        key = z ^ (z >> 31);
+    }
+    return keys;
+}
+
+const std::vector<uint64_t>& present_keys() {
+    static const std::vector<uint64_t> keys = make_keys(kTableKeys, 1);
+    return keys;
+}
+
+const std::vector<uint64_t>& absent_keys() {
+    static const std::vector<uint64_t> keys = make_keys(kTableKeys, 2);
+    return keys;
+}
+
+HashTableConfig table_config(CollisionStrategy strategy) {
+    HashTableConfig config;
+    config.collision_strategy = strategy;
+    config.initial_capacity = kTableKeys * 2;
+    config.enable_stats = false;  // Per-lookup timing would dominate the numbers
+    return config;
+}
+
+Table& filled_table(Table& table) {
+    for (size_t i = 0; i < kTableKeys; ++i) {
+        table.put(present_keys()[i], i);
+    }
+    return table;
+}
+
+// Built by the first call, which the harness spends on calibration
+Table& chaining_table() {
+    static Table table(table_config(CollisionStrategy::CHAINING), &entry_pool());
+    static Table& filled = filled_table(table);
+    return filled;
+}
+
+Table& group_probing_table() {
+    static Table table(table_config(CollisionStrategy::SIMD_GROUP_PROBING), &entry_pool());
+    static Table& filled = filled_table(table);
+    return filled;
+}
+
+void lookups(wasm_benchmark::State& state, Table& table, const std::vector<uint64_t>& keys) {
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        wasm_benchmark::do_not_optimize(table.get(keys[i & kKeyMask]));
+    }
+    state.set_items_per_iteration(1);
+}
+
+// Insert then remove a key that is not in the table, leaving it as it was
+void churn(wasm_benchmark::State& state, Table& table) {
+    const std::vector<uint64_t>& keys = absent_keys();
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        uint64_t key = keys[i & kKeyMask];
+        table.put(key, i);
+        wasm_benchmark::do_not_optimize(table.remove(key));
+    }
+    state.set_items_per_iteration(1);
+}
+
+void chaining_get_hit(wasm_benchmark::State& state) {
+    lookups(state, chaining_table(), present_keys());
+}
+WASM_BENCHMARK(chaining_get_hit);
+
+void chaining_get_miss(wasm_benchmark::State& state) {
+    lookups(state, chaining_table(), absent_keys());
+}
+WASM_BENCHMARK(chaining_get_miss);
+
+void chaining_put_remove(wasm_benchmark::State& state) {
+    churn(state, chaining_table());
+}
+WASM_BENCHMARK(chaining_put_remove);
+
+void group_probing_get_hit(wasm_benchmark::State& state) {
+    lookups(state, group_probing_table(), present_keys());
+}
+WASM_BENCHMARK(group_probing_get_hit);
+
+void group_probing_get_miss(wasm_benchmark::State& state) {
+    lookups(state, group_probing_table(), absent_keys());
+}
+WASM_BENCHMARK(group_probing_get_miss);
+
+void group_probing_put_remove(wasm_benchmark::State& state) {
+    churn(state, group_probing_table());
+}
+WASM_BENCHMARK(group_probing_put_remove);
+
+} // namespace
+
+int main(int argc, char** argv) {
+    wasm_benchmark::set_allocation_probe(pool_allocations);
+    return wasm_benchmark::run(argc, argv);
+}
@@ -0,0 +1,386 @@
+#include "asset_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+#define ASSET_MAX_PATH 1024
+#define ASSET_INITIAL_BUCKETS 64
+
+// Suffixes of the precompressed variants' files and ETags, by encoding
+static const char* const variant_suffixes[HTTP_ASSET_ENCODING_COUNT] = {"", ".gz", ".br"};
+static const char* const etag_suffixes[HTTP_ASSET_ENCODING_COUNT] = {"", "-gz", "-br"};
+
+static uint64_t hash_bytes(const void* data, size_t size) {
+    // FNV-1a
+    const unsigned char* bytes = data;
+    uint64_t hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void http_asset_cache_init(http_asset_cache_t* cache, size_t max_bytes, size_t max_entry_size) {
+    if (!cache) return;
+
+    memset(cache, 0, sizeof(http_asset_cache_t));
+    cache->max_bytes = max_bytes ? max_bytes : HTTP_ASSET_CACHE_DEFAULT_MAX_BYTES;
+    cache->max_entry_size = max_entry_size ? max_entry_size : HTTP_ASSET_CACHE_DEFAULT_MAX_ENTRY_SIZE;
+    if (cache->max_entry_size > cache->max_bytes) {
+        cache->max_entry_size = cache->max_bytes;
+    }
+    cache->revalidate_ms = HTTP_ASSET_CACHE_DEFAULT_REVALIDATE_MS;
+}
+
+void http_asset_free(http_asset_t* asset) {
+    if (!asset) return;
+
+    free(asset->path);
+    for (int i = 0; i < HTTP_ASSET_ENCODING_COUNT; i++) {
+        free(asset->variants[i].data);
+    }
+    memset(asset, 0, sizeof(http_asset_t));
+}
+
+void http_asset_cache_clear(http_asset_cache_t* cache) {
+    if (!cache) return;
+
+    http_asset_t* entry = cache->lru_head;
+    while (entry) {
+        http_asset_t* next = entry->lru_next;
+        http_asset_free(entry);
+        free(entry);
+        entry = next;
+    }
+    if (cache->buckets) {
+        memset(cache->buckets, 0, cache->bucket_count * sizeof(http_asset_t*));
+    }
+    cache->lru_head = NULL;
+    cache->lru_tail = NULL;
+    cache->entry_count = 0;
+    cache->bytes = 0;
+}
+
+void http_asset_cache_free(http_asset_cache_t* cache) {
+    if (!cache) return;
+
+    http_asset_cache_clear(cache);
+    free(cache->buckets);
+    cache->buckets = NULL;
+    cache->bucket_count = 0;
+}
+
+// Read a whole regular file
+static bool read_file(const char* file_path, uint8_t** data, size_t* size, time_t* mtime) {
+    struct stat info;
+    if (stat(file_path, &info) != 0 || !S_ISREG(info.st_mode)) return false;
+
+    FILE* file = fopen(file_path, "rb");
+    if (!file) return false;
+
+    size_t length = (size_t)info.st_size;
+    uint8_t* buffer = malloc(length ? length : 1);
+    if (!buffer) {
+        fclose(file);
+        return false;
+    }
+
+    size_t read = fread(buffer, 1, length, file);
+    fclose(file);
+    if (read != length) {
+        free(buffer);
+        return false;
+    }
+
+    *data = buffer;
+    *size = length;
+    *mtime = info.st_mtime;
+    return true;
+}
+
+bool http_asset_load(http_asset_t* asset, const char* file_path, const char* path) {
+    if (!asset || !file_path || !path) return false;
+
+    memset(asset, 0, sizeof(http_asset_t));
+    http_asset_variant_t* identity = &asset->variants[HTTP_ASSET_IDENTITY];
+    if (!read_file(file_path, &identity->data, &identity->size, &asset->mtime)) return false;
+
+    asset->path = malloc(strlen(path) + 1);
+    if (!asset->path) {
+        http_asset_free(asset);
+        return false;
+    }
+    strcpy(asset->path, path);
+
+    // Precompressed variants, if the build wrote them and they are current
+    size_t file_path_length = strlen(file_path);
+    for (int i = HTTP_ASSET_GZIP; i < HTTP_ASSET_ENCODING_COUNT; i++) {
+        char variant_path[ASSET_MAX_PATH + 4];
+        if (file_path_length + strlen(variant_suffixes[i]) >= sizeof(variant_path)) continue;
+        snprintf(variant_path, sizeof(variant_path), "%s%s", file_path, variant_suffixes[i]);
+
+        http_asset_variant_t* variant = &asset->variants[i];
+        time_t variant_mtime;
+        if (!read_file(variant_path, &variant->data, &variant->size, &variant_mtime)) {
+            continue;
+        }
+        if (variant_mtime < asset->mtime || variant->size >= identity->size) {
+            free(variant->data);
+            variant->data = NULL;
+            variant->size = 0;
+        }
+    }
+
+    const char* extension = strrchr(path, '.');
+    asset->content_type = http_get_content_type(extension ? extension + 1 : NULL);
+
+    uint64_t hash = hash_bytes(identity->data, identity->size);
+    for (int i = 0; i < HTTP_ASSET_ENCODING_COUNT; i++) {
+        if (asset->variants[i].data) {
+            snprintf(asset->etags[i], sizeof(asset->etags[i]), "\"%016llx%s\"",
+                     (unsigned long long)hash, etag_suffixes[i]);
+        }
+    }
+
+    struct tm* gmt = gmtime(&asset->mtime);
+    if (gmt) {
+        strftime(asset->last_modified, sizeof(asset->last_modified),
+                 "%a, %d %b %Y %H:%M:%S GMT", gmt);
+    }
+
+    asset->footprint = sizeof(http_asset_t) + strlen(asset->path) + 1;
+    for (int i = 0; i < HTTP_ASSET_ENCODING_COUNT; i++) {
+        asset->footprint += asset->variants[i].size;
+    }
+    return true;
+}
+
+// Map a request path to a key, "/" ending paths to their index.html; false
+// for paths that could leave the root
+static bool normalize_path(const char* path, char* key, size_t key_size) {
+    if (!path || path[0] != '/') return false;
+    if (strstr(path, "..") || strchr(path, '\\')) return false;
+
+    size_t length = strlen(path);
+    const char* index = path[length - 1] == '/' ? "index.html" : "";
+    if (length + strlen(index) >= key_size) return false;
+
+    snprintf(key, key_size, "%s%s", path, index);
+    return true;
+}
+
+static http_asset_t** find_slot(http_asset_cache_t* cache, const char* key) {
+    if (!cache->buckets) return NULL;
+
+    size_t bucket = hash_bytes(key, strlen(key)) & (cache->bucket_count - 1);
+    http_asset_t** slot = &cache->buckets[bucket];
+    while (*slot && strcmp((*slot)->path, key) != 0) {
+        slot = &(*slot)->hash_next;
+    }
+    return slot;
+}
+
+static void lru_unlink(http_asset_cache_t* cache, http_asset_t* entry) {
+    if (entry->lru_prev) {
+        entry->lru_prev->lru_next = entry->lru_next;
+    } else {
+        cache->lru_head = entry->lru_next;
+    }
+    if (entry->lru_next) {
+        entry->lru_next->lru_prev = entry->lru_prev;
+    } else {
+        cache->lru_tail = entry->lru_prev;
+    }
+    entry->lru_prev = NULL;
+    entry->lru_next = NULL;
+}
+
+static void lru_push_front(http_asset_cache_t* cache, http_asset_t* entry) {
+    entry->lru_prev = NULL;
+    entry->lru_next = cache->lru_head;
+    if (cache->lru_head) {
+        cache->lru_head->lru_prev = entry;
+    } else {
+        cache->lru_tail = entry;
+    }
+    cache->lru_head = entry;
+}
+
+static void remove_entry(http_asset_cache_t* cache, http_asset_t* entry) {
+    http_asset_t** slot = find_slot(cache, entry->path);
+    if (slot && *slot == entry) {
+        *slot = entry->hash_next;
+    }
+    lru_unlink(cache, entry);
+    cache->entry_count--;
+    cache->bytes -= entry->footprint;
+    http_asset_free(entry);
+    free(entry);
+}
+
+// Double the buckets once entries outnumber them
+static bool grow_buckets(http_asset_cache_t* cache) {
+    if (cache->buckets && cache->entry_count < cache->bucket_count) return true;
+
+    size_t bucket_count = cache->bucket_count ? cache->bucket_count * 2 : ASSET_INITIAL_BUCKETS;
+    http_asset_t** buckets = calloc(bucket_count, sizeof(http_asset_t*));
+    if (!buckets) return cache->buckets != NULL;
+
+    for (size_t i = 0; i < cache->bucket_count; i++) {
+        http_asset_t* entry = cache->buckets[i];
+        while (entry) {
+            http_asset_t* next = entry->hash_next;
+            size_t bucket = hash_bytes(entry->path, strlen(entry->path)) & (bucket_count - 1);
+            entry->hash_next = buckets[bucket];
+            buckets[bucket] = entry;
+            entry = next;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = bucket_count;
+    return true;
+}
+
+const http_asset_t* http_asset_cache_get(http_asset_cache_t* cache, const char* root,
+                                         const char* path, http_asset_t* uncached, bool* hit) {
+    if (hit) *hit = false;
+    if (!cache || !root || !uncached) return NULL;
+
+    char key[ASSET_MAX_PATH];
+    char file_path[ASSET_MAX_PATH * 2];
+    if (!normalize_path(path, key, sizeof(key))) return NULL;
+    snprintf(file_path, sizeof(file_path), "%s%s", root, key);
+
+    uint64_t now = http_get_current_time_ms();
+    http_asset_t** slot = find_slot(cache, key);
+    http_asset_t* entry = slot ? *slot : NULL;
+    if (entry && now - entry->checked_ms >= cache->revalidate_ms) {
+        struct stat info;
+        if (stat(file_path, &info) != 0 || info.st_mtime != entry->mtime) {
+            remove_entry(cache, entry);
+            entry = NULL;
+        } else {
+            entry->checked_ms = now;
+        }
+    }
+    if (entry) {
+        lru_unlink(cache, entry);
+        lru_push_front(cache, entry);
+        if (hit) *hit = true;
+        return entry;
+    }
+
+    if (!http_asset_load(uncached, file_path, key)) return NULL;
+    uncached->checked_ms = now;
+    if (uncached->footprint > cache->max_entry_size) return uncached;
+
+    entry = malloc(sizeof(http_asset_t));
+    if (!entry || !grow_buckets(cache)) {
+        free(entry);
+        return uncached;
+    }
+    *entry = *uncached;
+    memset(uncached, 0, sizeof(http_asset_t));
+
+    while (cache->lru_tail && cache->bytes + entry->footprint > cache->max_bytes) {
+        remove_entry(cache, cache->lru_tail);
+    }
+
+    slot = find_slot(cache, key);
+    *slot = entry;
+    lru_push_front(cache, entry);
+    cache->entry_count++;
+    cache->bytes += entry->footprint;
+    return entry;
+}
+
+// Whether a comma-separated header lists token with a nonzero q
+static bool header_accepts(const char* header, const char* token) {
+    size_t token_length = strlen(token);
+    const char* item = header;
+    while (*item) {
+        while (*item == ' ' || *item == '\t' || *item == ',') item++;
+        const char* end = item;
+        while (*end && *end != ',' && *end != ';' && *end != ' ' && *end != '\t') end++;
+
+        bool named = (size_t)(end - item) == token_length &&
+                     strncasecmp(item, token, token_length) == 0;
+        bool wildcard = end - item == 1 && *item == '*';
+
+        // Parameters up to the next item; only q matters
+        double quality = 1.0;
+        const char* next = strchr(end, ',');
+        const char* q = strstr(end, "q=");
+        if (q && (!next || q < next)) {
+            quality = atof(q + 2);
+        }
+
+        if ((named || wildcard) && quality > 0.0) return true;
+        if (named) return false;  // Explicitly refused
+        if (!next) break;
+        item = next + 1;
+    }
+    return false;
+}
+
+http_asset_encoding_t http_asset_choose_encoding(const http_asset_t* asset,
+                                                 const http_request_t* request) {
+    if (!asset || !request) return HTTP_ASSET_IDENTITY;
+
+    http_header_t* accept = http_find_header(request->headers, request->header_count,
+                                             "Accept-Encoding");
+    if (!accept || !accept->value) return HTTP_ASSET_IDENTITY;
+
+    http_asset_encoding_t best = HTTP_ASSET_IDENTITY;
+    for (int i = HTTP_ASSET_GZIP; i < HTTP_ASSET_ENCODING_COUNT; i++) {
+        const http_asset_variant_t* variant = &asset->variants[i];
+        if (variant->data && variant->size < asset->variants[best].size &&
+            header_accepts(accept->value, http_asset_encoding_name((http_asset_encoding_t)i))) {
+            best = (http_asset_encoding_t)i;
+        }
+    }
+    return best;
+}
+
+bool http_asset_not_modified(const http_asset_t* asset, const http_request_t* request) {
+    if (!asset || !request) return false;
+
+    // If-None-Match takes precedence, compared weakly against every
+    // variant's ETag; the response then carries the served variant's
+    http_header_t* none_match = http_find_header(request->headers, request->header_count,
+                                                 "If-None-Match");
+    if (none_match && none_match->value) {
+        const char* tag = none_match->value;
+        while (*tag) {
+            while (*tag == ' ' || *tag == '\t' || *tag == ',') tag++;
+            if (*tag == '*') return true;
+            if (strncmp(tag, "W/", 2) == 0) tag += 2;
+            for (int i = 0; i < HTTP_ASSET_ENCODING_COUNT; i++) {
+                size_t etag_length = strlen(asset->etags[i]);
+                if (etag_length && strncmp(tag, asset->etags[i], etag_length) == 0) return true;
+            }
+
+            const char* next = strchr(tag, ',');
+            if (!next) break;
+            tag = next + 1;
+        }
+        return false;
+    }
+
+    http_header_t* modified_since = http_find_header(request->headers, request->header_count,
+                                                     "If-Modified-Since");
+    return modified_since && modified_since->value &&
+           strcmp(modified_since->value, asset->last_modified) == 0;
+}
+
+const char* http_asset_encoding_name(http_asset_encoding_t encoding) {
+    switch (encoding) {
+        case HTTP_ASSET_GZIP:   return "gzip";
+        case HTTP_ASSET_BROTLI: return "br";
+        default:                return NULL;
+    }
+}
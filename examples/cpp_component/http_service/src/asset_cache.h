@@ -0,0 +1,106 @@
+#pragma once
+
+#include "http_utils.h"
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// In-memory static asset cache
+//
+// Bounded LRU of files under the static root, keyed by request path. An entry
+// holds the file's bytes with the precompressed variants found next to it
+// (name.br, name.gz, as written by the build), a strong ETag per variant
+// (a hash of the identity bytes, suffixed -gz or -br for the compressed
+// ones, since a strong validator names exact bytes) and the Last-Modified date, so a conditional request is answered without
+// touching the file or the body. Entries are checked against the file's
+// modification time at most once per revalidate_ms.
+//
+// Entries live across requests and are allocated with plain malloc, never
+// from a request arena.
+
+#define HTTP_ASSET_CACHE_DEFAULT_MAX_BYTES (16 * 1024 * 1024)
+#define HTTP_ASSET_CACHE_DEFAULT_MAX_ENTRY_SIZE (1024 * 1024)
+#define HTTP_ASSET_CACHE_DEFAULT_REVALIDATE_MS 1000
+
+typedef enum {
+    HTTP_ASSET_IDENTITY = 0,
+    HTTP_ASSET_GZIP,
+    HTTP_ASSET_BROTLI,
+    HTTP_ASSET_ENCODING_COUNT
+} http_asset_encoding_t;
+
+// One representation of an asset
+typedef struct {
+    uint8_t* data;
+    size_t size;
+} http_asset_variant_t;
+
+typedef struct http_asset {
+    char* path;  // Request path, the key
+    const char* content_type;
+    http_asset_variant_t variants[HTTP_ASSET_ENCODING_COUNT];  // Identity always set
+    char etags[HTTP_ASSET_ENCODING_COUNT][24];  // "<64-bit hash>", "<hash>-gz", "<hash>-br"; empty without the variant
+    char last_modified[32];
+    time_t mtime;
+    uint64_t checked_ms;    // When the file was last compared with the entry
+
+    // Cache bookkeeping
+    size_t footprint;
+    struct http_asset* hash_next;
+    struct http_asset* lru_prev;
+    struct http_asset* lru_next;
+} http_asset_t;
+
+typedef struct {
+    http_asset_t** buckets;
+    size_t bucket_count;  // Power of two
+    size_t entry_count;
+    size_t bytes;
+
+    // Most recently used first
+    http_asset_t* lru_head;
+    http_asset_t* lru_tail;
+
+    size_t max_bytes;
+    size_t max_entry_size;  // Larger files are served, not cached
+    uint32_t revalidate_ms;
+} http_asset_cache_t;
+
+// Initialize an empty cache (0 for a limit: default)
+void http_asset_cache_init(http_asset_cache_t* cache, size_t max_bytes, size_t max_entry_size);
+
+// Free every entry
+void http_asset_cache_free(http_asset_cache_t* cache);
+
+// Drop every entry
+void http_asset_cache_clear(http_asset_cache_t* cache);
+
+// Find the asset for a request path under root, loading it on a miss; hit
+// tells which. Files over max_entry_size come back uncached in *uncached,
+// which the caller frees with http_asset_free. NULL when there is no such
+// file or the path leaves root.
+const http_asset_t* http_asset_cache_get(http_asset_cache_t* cache, const char* root,
+                                         const char* path, http_asset_t* uncached, bool* hit);
+
+// Load a file and its precompressed variants into asset
+bool http_asset_load(http_asset_t* asset, const char* file_path, const char* path);
+
+// Free what http_asset_load allocated
+void http_asset_free(http_asset_t* asset);
+
+// Pick the smallest variant the request's Accept-Encoding allows
+http_asset_encoding_t http_asset_choose_encoding(const http_asset_t* asset,
+                                                 const http_request_t* request);
+
+// Whether the request's If-None-Match (any variant's ETag) or
+// If-Modified-Since matches the asset
+bool http_asset_not_modified(const http_asset_t* asset, const http_request_t* request);
+
+// Content-Encoding token for an encoding, NULL for identity
+const char* http_asset_encoding_name(http_asset_encoding_t encoding);
+
+#ifdef __cplusplus
+}
+#endif
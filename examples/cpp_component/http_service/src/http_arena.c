@@ -0,0 +1,210 @@
+#include "http_arena.h"
+#include <stdalign.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every block is preceded by its size, so http_realloc knows how much to copy
+#define ARENA_ALIGN alignof(max_align_t)
+#define ARENA_HEADER ARENA_ALIGN
+
+struct http_arena_chunk {
+    http_arena_chunk_t* next;
+    size_t size;  // Bytes of data
+    size_t used;
+    alignas(ARENA_ALIGN) unsigned char data[];
+};
+
+// All initialized arenas, for http_free; the active one
+static http_arena_t* live_arenas = NULL;
+static http_arena_t* active_arena = NULL;
+
+static size_t align_up(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+static size_t block_size(const void* ptr) {
+    size_t size;
+    memcpy(&size, (const unsigned char*)ptr - ARENA_HEADER, sizeof(size));
+    return size;
+}
+
+void http_arena_init(http_arena_t* arena, size_t chunk_size) {
+    if (!arena) return;
+
+    memset(arena, 0, sizeof(http_arena_t));
+    arena->chunk_size = chunk_size ? chunk_size : HTTP_ARENA_DEFAULT_CHUNK_SIZE;
+    arena->next_live = live_arenas;
+    live_arenas = arena;
+}
+
+void http_arena_destroy(http_arena_t* arena) {
+    if (!arena) return;
+
+    if (active_arena == arena) {
+        active_arena = NULL;
+    }
+    for (http_arena_t** link = &live_arenas; *link; link = &(*link)->next_live) {
+        if (*link == arena) {
+            *link = arena->next_live;
+            break;
+        }
+    }
+
+    http_arena_chunk_t* chunk = arena->chunks;
+    while (chunk) {
+        http_arena_chunk_t* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+}
+
+void http_arena_reset(http_arena_t* arena) {
+    if (!arena) return;
+
+    if (arena->bytes_allocated > arena->peak_bytes) {
+        arena->peak_bytes = arena->bytes_allocated;
+    }
+    arena->bytes_allocated = 0;
+
+    http_arena_chunk_t* keep = NULL;
+    http_arena_chunk_t* chunk = arena->chunks;
+    while (chunk) {
+        http_arena_chunk_t* next = chunk->next;
+        if (!keep || chunk->size > keep->size) {
+            free(keep);
+            keep = chunk;
+        } else {
+            free(chunk);
+        }
+        chunk = next;
+    }
+    if (keep) {
+        keep->next = NULL;
+        keep->used = 0;
+    }
+    arena->chunks = keep;
+}
+
+void* http_arena_alloc(http_arena_t* arena, size_t size) {
+    if (!arena || size > SIZE_MAX / 2) return NULL;
+
+    size_t total = ARENA_HEADER + align_up(size);
+    http_arena_chunk_t* chunk = arena->chunks;
+    if (!chunk || chunk->size - chunk->used < total) {
+        // Blocks bigger than half a chunk get a chunk of their own, behind the
+        // current one so its free space stays in use
+        bool dedicated = chunk && total > arena->chunk_size / 2;
+        size_t chunk_size = total > arena->chunk_size ? total : arena->chunk_size;
+        http_arena_chunk_t* fresh = malloc(sizeof(http_arena_chunk_t) + chunk_size);
+        if (!fresh) return NULL;
+        fresh->size = chunk_size;
+        fresh->used = 0;
+        if (dedicated) {
+            fresh->next = chunk->next;
+            chunk->next = fresh;
+        } else {
+            fresh->next = chunk;
+            arena->chunks = fresh;
+            if (arena->chunk_size < HTTP_ARENA_MAX_CHUNK_SIZE) {
+                arena->chunk_size *= 2;
+            }
+        }
+        chunk = fresh;
+    }
+
+    unsigned char* block = chunk->data + chunk->used + ARENA_HEADER;
+    memcpy(block - ARENA_HEADER, &size, sizeof(size));
+    chunk->used += total;
+    arena->bytes_allocated += size;
+    return block;
+}
+
+bool http_arena_owns(const http_arena_t* arena, const void* ptr) {
+    if (!arena || !ptr) return false;
+
+    const unsigned char* p = ptr;
+    for (const http_arena_chunk_t* chunk = arena->chunks; chunk; chunk = chunk->next) {
+        if (p >= chunk->data && p < chunk->data + chunk->size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static http_arena_t* owner_of(const void* ptr) {
+    for (http_arena_t* arena = live_arenas; arena; arena = arena->next_live) {
+        if (http_arena_owns(arena, ptr)) {
+            return arena;
+        }
+    }
+    return NULL;
+}
+
+// Grow or shrink a block of arena; in place when it is the last block of the
+// current chunk
+static void* arena_realloc(http_arena_t* arena, void* ptr, size_t size) {
+    size_t old_size = block_size(ptr);
+    http_arena_chunk_t* chunk = arena->chunks;
+    unsigned char* end = (unsigned char*)ptr + align_up(old_size);
+    if (chunk && end == chunk->data + chunk->used && size <= SIZE_MAX / 2) {
+        size_t start = (size_t)((unsigned char*)ptr - chunk->data);
+        if (chunk->size - start >= align_up(size)) {
+            chunk->used = start + align_up(size);
+            memcpy((unsigned char*)ptr - ARENA_HEADER, &size, sizeof(size));
+            if (size > old_size) {
+                arena->bytes_allocated += size - old_size;
+            }
+            return ptr;
+        }
+    }
+
+    void* moved = http_arena_alloc(arena, size);
+    if (moved) {
+        memcpy(moved, ptr, old_size < size ? old_size : size);
+    }
+    return moved;
+}
+
+http_arena_t* http_arena_activate(http_arena_t* arena) {
+    http_arena_t* previous = active_arena;
+    active_arena = arena;
+    return previous;
+}
+
+http_arena_t* http_arena_active(void) {
+    return active_arena;
+}
+
+void* http_malloc(size_t size) {
+    return active_arena ? http_arena_alloc(active_arena, size) : malloc(size);
+}
+
+void* http_calloc(size_t count, size_t size) {
+    if (!active_arena) {
+        return calloc(count, size);
+    }
+    if (size && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void* ptr = http_arena_alloc(active_arena, count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void* http_realloc(void* ptr, size_t size) {
+    if (!ptr) {
+        return http_malloc(size);
+    }
+    http_arena_t* owner = live_arenas ? owner_of(ptr) : NULL;
+    return owner ? arena_realloc(owner, ptr, size) : realloc(ptr, size);
+}
+
+void http_free(void* ptr) {
+    if (ptr && !(live_arenas && owner_of(ptr))) {
+        free(ptr);
+    }
+}
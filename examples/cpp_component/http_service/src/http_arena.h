@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-request arena
+//
+// Bump allocator for everything that lives as long as one request/response
+// pair: parsed headers, cookies, form fields, multipart parts, the response
+// and its builder. While an arena is active, http_malloc and friends carve
+// from it; http_free of arena memory is a no-op, so the usual free_*
+// functions still work and cost nothing. http_arena_reset releases it all at
+// once after the response is out, keeping the largest chunk for the next
+// request so a steady load does no mallocs at all.
+//
+// Anything that outlives the request (routes, configuration, parser buffers)
+// must be allocated while no arena is active, or with plain malloc. A parser
+// that parsed under an arena must be reset before the arena is.
+
+typedef struct http_arena_chunk http_arena_chunk_t;
+
+typedef struct http_arena {
+    http_arena_chunk_t* chunks;  // Current chunk first
+    size_t chunk_size;           // Size of the next chunk to allocate
+    size_t bytes_allocated;      // Handed out since the last reset
+    size_t peak_bytes;           // Largest bytes_allocated seen at a reset
+    struct http_arena* next_live;
+} http_arena_t;
+
+#define HTTP_ARENA_DEFAULT_CHUNK_SIZE (16 * 1024)
+#define HTTP_ARENA_MAX_CHUNK_SIZE (1024 * 1024)
+
+// Initialize an arena whose first chunk holds chunk_size bytes (0: default);
+// chunks are allocated on first use
+void http_arena_init(http_arena_t* arena, size_t chunk_size);
+
+// Free every chunk; the arena must not be active
+void http_arena_destroy(http_arena_t* arena);
+
+// Release every allocation, keeping the largest chunk
+void http_arena_reset(http_arena_t* arena);
+
+// Allocate size bytes, aligned for any type; NULL when out of memory
+void* http_arena_alloc(http_arena_t* arena, size_t size);
+
+// Whether ptr came from arena
+bool http_arena_owns(const http_arena_t* arena, const void* ptr);
+
+// Make arena (or NULL for none) the one http_malloc allocates from;
+// returns the previously active arena
+http_arena_t* http_arena_activate(http_arena_t* arena);
+
+// Currently active arena, or NULL
+http_arena_t* http_arena_active(void);
+
+// Allocation for per-request objects: from the active arena, otherwise the
+// heap. http_realloc keeps a block where it lives, and http_free ignores
+// memory that belongs to any arena.
+void* http_malloc(size_t size);
+void* http_calloc(size_t count, size_t size);
+void* http_realloc(void* ptr, size_t size);
+void http_free(void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,6 +7,13 @@
 // Global service instance for WIT interface
 http_service_t* global_http_service = NULL;
 
+static void free_route_handler(route_handler_t* route) {
+    http_free_route(&route->route);
+    free(route->middleware);
+    free(route->chain);
+    free(route);
+}
+
 // Create new HTTP service
 http_service_t* http_service_create(const char* name, const char* version) {
     http_service_t* service = calloc(1, sizeof(http_service_t));
@@ -18,6 +25,10 @@ http_service_t* http_service_create(const char* name, const char* version) {
     service->config.max_request_size = HTTP_MAX_BODY_SIZE;
     service->config.timeout_ms = 30000;  // 30 seconds
 
+    http_router_init(&service->router);
+    http_arena_init(&service->arena, 0);
+    http_asset_cache_init(&service->asset_cache, 0, 0);
+
     // Initialize parser
     service->parser = http_parser_create(HTTP_MAX_HEADER_VALUE_LENGTH, HTTP_MAX_BODY_SIZE);
     if (!service->parser) {
@@ -95,19 +106,21 @@ void http_service_free(http_service_t* service) {
     route_handler_t* route = service->routes;
     while (route) {
         route_handler_t* next = route->next;
-        http_free_route(&route->route);
-        free(route);
+        free_route_handler(route);
         route = next;
     }
+    http_router_free(&service->router);
 
     // Free middleware
     free(service->middleware);
 
     // Free parser
     http_parser_free(service->parser);
+    http_arena_destroy(&service->arena);
 
     // Free other resources
     free(service->static_root);
+    http_asset_cache_free(&service->asset_cache);
     free(service->cors_origins);
     free(service->cors_methods);
     free(service->cors_headers);
@@ -131,9 +144,10 @@ bool http_service_add_route(http_service_t* service, http_method_t method,
     route_handler->handler = handler;
     route_handler->user_data = user_data;
 
-    if (!route_handler->route.path_pattern || !route_handler->route.handler_name) {
-        http_free_route(&route_handler->route);
-        free(route_handler);
+    void* replaced = NULL;
+    if (!route_handler->route.path_pattern || !route_handler->route.handler_name ||
+        !http_router_insert(&service->router, method, path_pattern, route_handler, &replaced)) {
+        free_route_handler(route_handler);
         return false;
     }
 
@@ -142,24 +156,182 @@ bool http_service_add_route(http_service_t* service, http_method_t method,
     service->routes = route_handler;
     service->route_count++;
 
+    if (replaced) {
+        route_handler_t** link = &service->routes;
+        while (*link != replaced) link = &(*link)->next;
+        *link = ((route_handler_t*)replaced)->next;
+        free_route_handler(replaced);
+        service->route_count--;
+    }
+
+    return true;
+}
+
+// Remove route
+bool http_service_remove_route(http_service_t* service, http_method_t method,
+                              const char* path_pattern) {
+    if (!service || !path_pattern) return false;
+
+    void* removed = NULL;
+    if (!http_router_remove(&service->router, method, path_pattern, &removed)) {
+        return false;
+    }
+
+    route_handler_t** link = &service->routes;
+    while (*link != removed) link = &(*link)->next;
+    *link = ((route_handler_t*)removed)->next;
+    free_route_handler(removed);
+    service->route_count--;
     return true;
 }
 
 // Find matching route for request
 route_handler_t* http_service_find_route(http_service_t* service,
                                         const http_request_t* request) {
-    if (!service || !request) return NULL;
+    if (!service || !request || !request->path) return NULL;
 
-    route_handler_t* route = service->routes;
-    while (route) {
-        if (route->route.method == request->method &&
-            http_path_matches_pattern(request->path, route->route.path_pattern)) {
-            return route;
+    if (!http_router_match(&service->router, request->method, request->path,
+                           strlen(request->path), &service->route_match)) {
+        return NULL;
+    }
+    return service->route_match.value;
+}
+
+// Get a parameter of the route being handled
+const http_route_param_t* http_service_get_path_param(const http_service_t* service,
+                                                      const char* name) {
+    if (!service) return NULL;
+    return http_route_match_param(&service->route_match, name);
+}
+
+// Add middleware
+bool http_service_add_middleware(http_service_t* service, route_handler_func_t middleware) {
+    if (!service || !middleware) return false;
+
+    if (service->middleware_count == service->middleware_capacity) {
+        size_t capacity = service->middleware_capacity ? service->middleware_capacity * 2 : 4;
+        route_handler_func_t* grown = realloc(service->middleware, capacity * sizeof(*grown));
+        if (!grown) return false;
+        service->middleware = grown;
+        service->middleware_capacity = capacity;
+    }
+
+    service->middleware[service->middleware_count++] = middleware;
+    service->middleware_generation++;
+    return true;
+}
+
+// Remove middleware
+bool http_service_remove_middleware(http_service_t* service, route_handler_func_t middleware) {
+    if (!service || !middleware) return false;
+
+    for (size_t i = 0; i < service->middleware_count; i++) {
+        if (service->middleware[i] == middleware) {
+            memmove(&service->middleware[i], &service->middleware[i + 1],
+                    (service->middleware_count - i - 1) * sizeof(*service->middleware));
+            service->middleware_count--;
+            service->middleware_generation++;
+            return true;
         }
+    }
+    return false;
+}
+
+// Add middleware to one route
+bool http_service_add_route_middleware(http_service_t* service, http_method_t method,
+                                       const char* path_pattern,
+                                       route_handler_func_t middleware) {
+    if (!service || !path_pattern || !middleware) return false;
+
+    route_handler_t* route = service->routes;
+    while (route && (route->route.method != method ||
+                     strcmp(route->route.path_pattern, path_pattern) != 0)) {
         route = route->next;
     }
+    if (!route) return false;
+
+    route_handler_func_t* grown = realloc(route->middleware,
+                                          (route->middleware_count + 1) * sizeof(*grown));
+    if (!grown) return false;
+    route->middleware = grown;
+    route->middleware[route->middleware_count++] = middleware;
+
+    // Generation 0 is never current, so the chain is rebuilt on next use
+    route->chain_generation = 0;
+    return true;
+}
+
+// Flatten service and route middleware into the route's chain
+static bool compile_route_chain(http_service_t* service, route_handler_t* route) {
+    size_t length = service->middleware_count + route->middleware_count;
+    route_handler_func_t* chain = NULL;
+    if (length > 0) {
+        chain = malloc(length * sizeof(*chain));
+        if (!chain) return false;
+        for (size_t i = 0; i < service->middleware_count; i++) {
+            chain[i] = service->middleware[i];
+        }
+        for (size_t i = 0; i < route->middleware_count; i++) {
+            chain[service->middleware_count + i] = route->middleware[i];
+        }
+    }
+
+    free(route->chain);
+    route->chain = chain;
+    route->chain_length = length;
+    route->chain_generation = service->middleware_generation + 1;
+    return true;
+}
+
+// Run a route's compiled chain and then its handler
+static request_result_t run_route(http_service_t* service, route_handler_t* route,
+                                  const http_request_t* request) {
+    if (route->chain_generation != service->middleware_generation + 1 &&
+        !compile_route_chain(service, route)) {
+        request_result_t result = {0};
+        result.success = false;
+        result.error_message = http_strdup("Failed to build middleware chain");
+        return result;
+    }
+
+    for (size_t i = 0; i < route->chain_length; i++) {
+        request_result_t result = route->chain[i](request, service);
+        if (!http_middleware_is_next(&result)) {
+            return result;
+        }
+    }
+    return route->handler(request, route->user_data);
+}
+
+// Enable the per-request arena
+void http_service_enable_request_arena(http_service_t* service, bool enable) {
+    if (service && !service->in_request) {
+        service->arena_enabled = enable;
+    }
+}
+
+// Start a request/response pair
+void http_service_begin_request(http_service_t* service) {
+    if (!service || service->in_request) return;
+
+    service->in_request = true;
+    service->previous_arena = service->arena_enabled
+        ? http_arena_activate(&service->arena)
+        : http_arena_active();
+}
+
+// Finish a request/response pair, releasing its arena
+void http_service_end_request(http_service_t* service) {
+    if (!service || !service->in_request) return;
 
-    return NULL;
+    service->in_request = false;
+    if (!service->arena_enabled) return;
+
+    http_arena_activate(service->previous_arena);
+    // The parser's request may live in the arena, so it goes first
+    http_parser_reset(service->parser);
+    memset(&service->route_match, 0, sizeof(service->route_match));
+    http_arena_reset(&service->arena);
 }
 
 // Main request handler
@@ -236,6 +408,7 @@ request_result_t http_service_handle_request(http_service_t* service,
 
                 return result;
             }
+            http_free(result.error_message);
         }
 
         // No route found, return 404
@@ -244,10 +417,8 @@ request_result_t http_service_handle_request(http_service_t* service,
                                        "Route not found");
     }
 
-    // Process through middleware chain
-    request_result_t result = http_service_process_middleware(service, request,
-                                                            route_handler->handler,
-                                                            route_handler->user_data);
+    // Process through the route's middleware chain
+    request_result_t result = run_route(service, route_handler, request);
 
     if (result.success) {
         service->stats.successful_requests++;
@@ -302,13 +473,15 @@ request_result_t http_service_process_middleware(http_service_t* service,
         return result;
     }
 
-    // If no middleware, call handler directly
-    if (service->middleware_count == 0) {
-        return final_handler(request, handler_data);
+    // Routes run their compiled chains instead; this walks the service's
+    // middleware for handlers that are not routes
+    for (size_t i = 0; i < service->middleware_count; i++) {
+        request_result_t result = service->middleware[i](request, service);
+        if (!http_middleware_is_next(&result)) {
+            return result;
+        }
     }
 
-    // TODO: Implement proper middleware chaining
-    // For now, just call the final handler
     return final_handler(request, handler_data);
 }
 
@@ -330,7 +503,7 @@ request_result_t http_service_handle_error(http_service_t* service,
     if (response) {
         response->status = status;
         result.response = *response;
-        free(response);  // Only free the container, not the contents
+        http_free(response);  // Only free the container, not the contents
     } else {
         result.success = false;
         result.error_message = http_strdup("Failed to create error response");
@@ -498,7 +671,7 @@ request_result_t http_service_default_404_handler(const http_request_t* request,
     http_response_t* response = build_not_found_response();
     if (response) {
         result.response = *response;
-        free(response);
+        http_free(response);
     } else {
         result.success = false;
         result.error_message = http_strdup("Failed to create 404 response");
@@ -522,7 +695,7 @@ request_result_t http_service_health_handler(const http_request_t* request,
                                                      healthy ? "Service is running" : "Service unavailable");
     if (response) {
         result.response = *response;
-        free(response);
+        http_free(response);
     } else {
         result.success = false;
         result.error_message = http_strdup("Failed to create health response");
@@ -545,9 +718,9 @@ request_result_t http_service_echo_handler(const http_request_t* request,
         http_response_t* response = build_text_response(HTTP_STATUS_OK, request_str);
         if (response) {
             result.response = *response;
-            free(response);
+            http_free(response);
         }
-        free(request_str);
+        http_free(request_str);
     }
 
     if (!result.response.body) {
@@ -591,6 +764,10 @@ bool init_global_http_service(void) {
         return false;
     }
 
+    // Requests from the host run on the arena, released once the result is
+    // copied out
+    http_service_enable_request_arena(global_http_service, true);
+
     // Add default routes
     http_service_add_route(global_http_service, HTTP_GET, "/health",
                           http_service_health_handler, global_http_service);
@@ -600,6 +777,14 @@ bool init_global_http_service(void) {
     return true;
 }
 
+// Build-time pre-initialization (cpp_component wizer_init): the service,
+// its routes and arena are in the snapshot, so the first request does not
+// pay for them. start_time holds the build time; uptime is measured from
+// the first get_stats call.
+void http_service_wizer_init(void) {
+    init_global_http_service();
+}
+
 // WIT interface functions
 
 extern request_result_t handle_request(const http_request_t* request) {
@@ -652,6 +837,58 @@ extern bool health_check(void) {
 
 // Missing helper function implementations
 
+// Enable static file serving from directory
+bool http_service_enable_static_files(http_service_t* service, const char* root_directory) {
+    if (!service || !root_directory) return false;
+
+    // Outlives any request
+    size_t length = strlen(root_directory);
+    while (length > 1 && root_directory[length - 1] == '/') length--;
+    char* root = malloc(length + 1);
+    if (!root) return false;
+    memcpy(root, root_directory, length);
+    root[length] = '\0';
+
+    free(service->static_root);
+    service->static_root = root;
+    http_asset_cache_clear(&service->asset_cache);
+    return true;
+}
+
+// Disable static file serving
+void http_service_disable_static_files(http_service_t* service) {
+    if (!service) return;
+
+    free(service->static_root);
+    service->static_root = NULL;
+    http_asset_cache_clear(&service->asset_cache);
+}
+
+// Bound the static asset cache
+void http_service_configure_asset_cache(http_service_t* service, size_t max_bytes,
+                                        size_t max_entry_size) {
+    if (!service) return;
+
+    http_asset_cache_free(&service->asset_cache);
+    http_asset_cache_init(&service->asset_cache, max_bytes, max_entry_size);
+}
+
+// Headers shared by a full response and a 304; the ETag is the variant's
+static bool add_asset_headers(response_builder_t* builder, const http_asset_t* asset,
+                              http_asset_encoding_t encoding) {
+    if (!response_add_header(builder, "ETag", asset->etags[encoding])) return false;
+    if (asset->last_modified[0] &&
+        !response_add_header(builder, "Last-Modified", asset->last_modified)) {
+        return false;
+    }
+    for (int i = HTTP_ASSET_GZIP; i < HTTP_ASSET_ENCODING_COUNT; i++) {
+        if (asset->variants[i].data) {
+            return response_add_header(builder, "Vary", "Accept-Encoding");
+        }
+    }
+    return true;
+}
+
 // Handle static file serving
 request_result_t http_service_handle_static_file(http_service_t* service,
                                                const http_request_t* request,
@@ -664,17 +901,67 @@ request_result_t http_service_handle_static_file(http_service_t* service,
         return result;
     }
 
-    // Simple static file response (placeholder implementation)
-    result.success = true;
+    if (!service->static_root ||
+        (request->method != HTTP_GET && request->method != HTTP_HEAD)) {
+        result.success = false;
+        result.error_message = http_strdup("Not a static file request");
+        return result;
+    }
 
-    http_response_t* response = build_text_response(HTTP_STATUS_OK, "Static file content placeholder");
-    if (response) {
-        result.response = *response;
-        free(response);
+    http_asset_t uncached;
+    bool hit = false;
+    const http_asset_t* asset = http_asset_cache_get(&service->asset_cache, service->static_root,
+                                                     file_path, &uncached, &hit);
+    if (!asset) {
+        result.success = false;
+        result.error_message = http_strdup("Static file not found");
+        return result;
+    }
+    if (hit) {
+        service->stats.cache_hits++;
+    } else {
+        service->stats.cache_misses++;
+    }
+
+    // A 304 names the variant this request would be served
+    http_asset_encoding_t encoding = http_asset_choose_encoding(asset, request);
+    response_builder_t* builder = response_builder_create();
+    bool built = builder != NULL;
+    if (built && http_asset_not_modified(asset, request)) {
+        builder->auto_content_length = false;
+        built = response_set_status(builder, HTTP_STATUS_NOT_MODIFIED) &&
+                add_asset_headers(builder, asset, encoding);
+    } else if (built) {
+        const http_asset_variant_t* variant = &asset->variants[encoding];
+        const char* encoding_name = http_asset_encoding_name(encoding);
+
+        built = response_set_status(builder, HTTP_STATUS_OK) &&
+                response_add_header(builder, "Content-Type", asset->content_type) &&
+                add_asset_headers(builder, asset, encoding) &&
+                (!encoding_name ||
+                 response_add_header(builder, "Content-Encoding", encoding_name));
+        if (built && request->method == HTTP_HEAD) {
+            char length_str[32];
+            snprintf(length_str, sizeof(length_str), "%zu", variant->size);
+            built = response_add_header(builder, "Content-Length", length_str);
+        } else if (built) {
+            built = response_set_body(builder, variant->data, variant->size);
+        }
+    }
+    if (asset == &uncached) {
+        http_asset_free(&uncached);
+    }
+
+    if (built) {
+        response_finalize(builder);
+        result.success = true;
+        result.response = *builder->response;
+        memset(builder->response, 0, sizeof(http_response_t));
     } else {
         result.success = false;
         result.error_message = http_strdup("Failed to create static file response");
     }
+    response_builder_free(builder);
 
     return result;
 }
@@ -708,6 +995,32 @@ extern bool is_form_request(const http_request_t* request) {
 // Include generated header for proper type definitions
 #include "http_service_world.h"
 
+// Statuses in the order of the WIT http-status enum
+static const http_status_t wit_statuses[] = {
+    HTTP_STATUS_OK,
+    HTTP_STATUS_CREATED,
+    HTTP_STATUS_NO_CONTENT,
+    HTTP_STATUS_NOT_MODIFIED,
+    HTTP_STATUS_BAD_REQUEST,
+    HTTP_STATUS_UNAUTHORIZED,
+    HTTP_STATUS_FORBIDDEN,
+    HTTP_STATUS_NOT_FOUND,
+    HTTP_STATUS_METHOD_NOT_ALLOWED,
+    HTTP_STATUS_INTERNAL_SERVER_ERROR,
+    HTTP_STATUS_NOT_IMPLEMENTED,
+    HTTP_STATUS_SERVICE_UNAVAILABLE,
+};
+
+// WIT enum value of a status; ones WIT does not know become internal errors
+static uint8_t convert_to_wit_status(http_status_t status) {
+    uint8_t internal_error = 0;
+    for (uint8_t i = 0; i < sizeof(wit_statuses) / sizeof(wit_statuses[0]); i++) {
+        if (wit_statuses[i] == status) return i;
+        if (wit_statuses[i] == HTTP_STATUS_INTERNAL_SERVER_ERROR) internal_error = i;
+    }
+    return internal_error;
+}
+
 // Convert internal request to WIT request structure
 static void convert_to_wit_request(const http_request_t* internal_req,
                                   exports_example_http_service_http_service_http_request_t* wit_req) {
@@ -758,16 +1071,16 @@ static void convert_to_wit_result(const request_result_t* internal_result,
         wit_result->tag = EXPORTS_EXAMPLE_HTTP_SERVICE_HTTP_SERVICE_REQUEST_RESULT_SUCCESS;
 
         // Convert response
-        wit_result->val.success.status = (uint8_t)internal_result->response.status;
+        wit_result->val.success.status = convert_to_wit_status(internal_result->response.status);
 
         // Convert headers
         wit_result->val.success.headers.len = internal_result->response.header_count;
         if (internal_result->response.header_count > 0) {
             wit_result->val.success.headers.ptr = malloc(sizeof(exports_example_http_service_http_service_http_header_t) * internal_result->response.header_count);
             for (size_t i = 0; i < internal_result->response.header_count; i++) {
-                http_service_world_string_set(&wit_result->val.success.headers.ptr[i].name,
+                http_service_world_string_dup(&wit_result->val.success.headers.ptr[i].name,
                                             internal_result->response.headers[i].name);
-                http_service_world_string_set(&wit_result->val.success.headers.ptr[i].value,
+                http_service_world_string_dup(&wit_result->val.success.headers.ptr[i].value,
                                             internal_result->response.headers[i].value);
             }
         } else {
@@ -778,17 +1091,65 @@ static void convert_to_wit_result(const request_result_t* internal_result,
         if (internal_result->response.body && internal_result->response.body_size > 0) {
             wit_result->val.success.body.is_some = true;
             wit_result->val.success.body.val.len = internal_result->response.body_size;
-            wit_result->val.success.body.val.ptr = (uint8_t*)internal_result->response.body;
+            wit_result->val.success.body.val.ptr = malloc(internal_result->response.body_size);
+            if (wit_result->val.success.body.val.ptr) {
+                memcpy(wit_result->val.success.body.val.ptr, internal_result->response.body,
+                       internal_result->response.body_size);
+            } else {
+                wit_result->val.success.body.is_some = false;
+            }
         } else {
             wit_result->val.success.body.is_some = false;
         }
     } else {
         wit_result->tag = EXPORTS_EXAMPLE_HTTP_SERVICE_HTTP_SERVICE_REQUEST_RESULT_ERROR;
-        http_service_world_string_set(&wit_result->val.error,
+        http_service_world_string_dup(&wit_result->val.error,
                                     internal_result->error_message ? internal_result->error_message : "Unknown error");
     }
 }
 
+// Copy a WIT string into a NUL-terminated one (in the request arena)
+static char* wit_string_copy(const http_service_world_string_t* string) {
+    char* copy = http_malloc(string->len + 1);
+    if (copy) {
+        memcpy(copy, string->ptr, string->len);
+        copy[string->len] = '\0';
+    }
+    return copy;
+}
+
+// Convert WIT request to internal request structure; the body is shared
+static bool convert_from_wit_request(const exports_example_http_service_http_service_http_request_t* wit_req,
+                                     http_request_t* internal_req) {
+    memset(internal_req, 0, sizeof(*internal_req));
+    internal_req->method = (http_method_t)wit_req->method.tag;
+    internal_req->path = wit_string_copy(&wit_req->path);
+    if (!internal_req->path) return false;
+
+    if (wit_req->query.is_some) {
+        internal_req->query = wit_string_copy(&wit_req->query.val);
+        if (!internal_req->query) return false;
+    }
+
+    if (wit_req->headers.len > 0) {
+        internal_req->headers = http_calloc(wit_req->headers.len, sizeof(http_header_t));
+        if (!internal_req->headers) return false;
+        for (size_t i = 0; i < wit_req->headers.len; i++) {
+            http_header_t* header = &internal_req->headers[i];
+            header->name = wit_string_copy(&wit_req->headers.ptr[i].name);
+            header->value = wit_string_copy(&wit_req->headers.ptr[i].value);
+            if (!header->name || !header->value) return false;
+            internal_req->header_count++;
+        }
+    }
+
+    if (wit_req->body.is_some) {
+        internal_req->body = wit_req->body.val.ptr;
+        internal_req->body_size = wit_req->body.val.len;
+    }
+    return true;
+}
+
 // WIT binding function implementations
 
 void exports_example_http_service_http_service_handle_request(
@@ -804,16 +1165,24 @@ void exports_example_http_service_http_service_handle_request(
         return;
     }
 
-    // Create internal request structure (simplified conversion)
-    http_request_t internal_req = {0};
-    internal_req.method = (http_method_t)request->method.tag;
-    internal_req.path = (char*)request->path.ptr; // Note: assumes null-terminated
+    // Everything allocated from here until the result is copied out lives in
+    // the request arena
+    http_service_begin_request(global_http_service);
+
+    http_request_t internal_req;
+    if (!convert_from_wit_request(request, &internal_req)) {
+        http_service_end_request(global_http_service);
+        ret->tag = EXPORTS_EXAMPLE_HTTP_SERVICE_HTTP_SERVICE_REQUEST_RESULT_ERROR;
+        http_service_world_string_dup(&ret->val.error, "Failed to convert request");
+        return;
+    }
 
     // Handle request
     request_result_t result = http_service_handle_request(global_http_service, &internal_req);
 
     // Convert result
     convert_to_wit_result(&result, ret);
+    http_service_end_request(global_http_service);
 }
 
 bool exports_example_http_service_http_service_add_route(
@@ -887,6 +1256,8 @@ void exports_example_http_service_http_service_get_stats(
     ret->failed_requests = global_http_service->stats.failed_requests;
     ret->average_response_time_ms = global_http_service->stats.average_response_time_ms;
     ret->uptime_seconds = http_get_uptime_seconds();
+    ret->cache_hits = global_http_service->stats.cache_hits;
+    ret->cache_misses = global_http_service->stats.cache_misses;
 }
 
 void exports_example_http_service_http_service_reset_stats(void) {
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "asset_cache.h"
 #include "http_utils.h"
 #include "request_parser.h"
 #include "response_builder.h"
+#include "router.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -22,25 +24,60 @@ struct route_handler {
     route_handler_func_t handler;
     void* user_data;
     route_handler_t* next;
+
+    // Middleware for this route only, run after the service's
+    route_handler_func_t* middleware;
+    size_t middleware_count;
+
+    // Service then route middleware, flattened when the route is first used
+    // after either changes
+    route_handler_func_t* chain;
+    size_t chain_length;
+    uint64_t chain_generation;
 };
 
+// Middleware shares the handler signature and is called with the service as
+// user_data. It returns http_middleware_next() to pass the request on; any
+// other result is the response and ends the chain.
+static inline request_result_t http_middleware_next(void) {
+    request_result_t result = {0};
+    result.success = true;  // With status 0, which no response has
+    return result;
+}
+
+static inline bool http_middleware_is_next(const request_result_t* result) {
+    return result->success && result->response.status == 0;
+}
+
 // HTTP service structure
 struct http_service {
     service_config_t config;
     service_stats_t stats;
 
-    // Route management
+    // Route management: the list owns the handlers, the router finds them
     route_handler_t* routes;
     size_t route_count;
+    http_router_t router;
 
-    // Middleware chain
+    // Parameters of the route being handled, pointing into its path
+    http_route_match_t route_match;
+
+    // Middleware chain; the generation moves on with every change so routes
+    // know to rebuild their chains
     route_handler_func_t* middleware;
     size_t middleware_count;
     size_t middleware_capacity;
+    uint64_t middleware_generation;
 
     // Request parser
     http_parser_t* parser;
 
+    // Per-request arena, used between begin and end of a request when enabled
+    http_arena_t arena;
+    http_arena_t* previous_arena;
+    bool arena_enabled;
+    bool in_request;
+
     // Service state
     bool initialized;
     bool running;
@@ -55,8 +92,9 @@ struct http_service {
     size_t max_response_size;
     uint32_t default_timeout_ms;
 
-    // Static file serving
+    // Static file serving, through the asset cache
     char* static_root;
+    http_asset_cache_t asset_cache;
     bool enable_directory_listing;
 
     // CORS settings
@@ -104,7 +142,8 @@ void http_service_reset_stats(http_service_t* service);
 
 // Route management functions
 
-// Add route handler
+// Add route handler; path_pattern may use :param and *wildcard segments (see
+// router.h). A route on the same method and pattern is replaced.
 bool http_service_add_route(http_service_t* service, http_method_t method,
                            const char* path_pattern, route_handler_func_t handler,
                            void* user_data);
@@ -116,10 +155,14 @@ bool http_service_remove_route(http_service_t* service, http_method_t method,
 // Get all routes
 http_route_t* http_service_list_routes(http_service_t* service, size_t* count);
 
-// Find matching route for request
+// Find matching route for request; its parameters are left in route_match
 route_handler_t* http_service_find_route(http_service_t* service,
                                         const http_request_t* request);
 
+// Get a parameter of the route being handled; NULL if it has none by that name
+const http_route_param_t* http_service_get_path_param(const http_service_t* service,
+                                                      const char* name);
+
 // Middleware management
 
 // Add middleware (executed in order of addition)
@@ -128,12 +171,25 @@ bool http_service_add_middleware(http_service_t* service, route_handler_func_t m
 // Remove middleware
 bool http_service_remove_middleware(http_service_t* service, route_handler_func_t middleware);
 
+// Add middleware to one route, run after the service's middleware
+bool http_service_add_route_middleware(http_service_t* service, http_method_t method,
+                                       const char* path_pattern,
+                                       route_handler_func_t middleware);
+
 // Request processing
 
 // Main request handler (implements WIT interface)
 request_result_t http_service_handle_request(http_service_t* service,
                                            const http_request_t* request);
 
+// Per-request arena: when enabled, everything allocated between
+// begin_request and end_request (the parsed request, handler results, the
+// response) comes from the service's arena and is released at end_request,
+// after the response has been sent. free_* calls on it in between are no-ops.
+void http_service_enable_request_arena(http_service_t* service, bool enable);
+void http_service_begin_request(http_service_t* service);
+void http_service_end_request(http_service_t* service);
+
 // Process request through middleware chain
 request_result_t http_service_process_middleware(http_service_t* service,
                                                const http_request_t* request,
@@ -166,6 +222,10 @@ request_result_t http_service_handle_static_file(http_service_t* service,
                                                const http_request_t* request,
                                                const char* file_path);
 
+// Bound the static asset cache (0 for a limit: default); drops cached assets
+void http_service_configure_asset_cache(http_service_t* service, size_t max_bytes,
+                                        size_t max_entry_size);
+
 // CORS support
 
 // Configure CORS settings
@@ -269,6 +329,9 @@ extern http_service_t* global_http_service;
 // Initialize global service
 bool init_global_http_service(void);
 
+// Runs init_global_http_service at build time under wasmtime wizer
+void http_service_wizer_init(void);
+
 // WIT interface functions (these will be called by generated bindings)
 extern request_result_t handle_request(const http_request_t* request);
 extern bool add_route(const http_route_t* route);
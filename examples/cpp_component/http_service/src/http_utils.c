@@ -24,7 +24,7 @@ const char* http_get_last_error(void) {
 char* http_strdup(const char* str) {
     if (!str) return NULL;
     size_t len = strlen(str);
-    char* copy = malloc(len + 1);
+    char* copy = http_malloc(len + 1);
     if (copy) {
         strcpy(copy, str);
     }
@@ -113,6 +113,7 @@ const char* http_status_to_reason_phrase(http_status_t status) {
         case HTTP_STATUS_OK:                    return "OK";
         case HTTP_STATUS_CREATED:               return "Created";
         case HTTP_STATUS_NO_CONTENT:            return "No Content";
+        case HTTP_STATUS_NOT_MODIFIED:          return "Not Modified";
         case HTTP_STATUS_BAD_REQUEST:           return "Bad Request";
         case HTTP_STATUS_UNAUTHORIZED:          return "Unauthorized";
         case HTTP_STATUS_FORBIDDEN:             return "Forbidden";
@@ -149,7 +150,7 @@ bool http_add_header(http_header_t** headers, size_t* count, size_t* capacity,
             return false;
         }
 
-        http_header_t* new_headers = realloc(*headers, new_capacity * sizeof(http_header_t));
+        http_header_t* new_headers = http_realloc(*headers, new_capacity * sizeof(http_header_t));
         if (!new_headers) {
             http_set_error("Failed to allocate memory for headers");
             return false;
@@ -164,8 +165,8 @@ bool http_add_header(http_header_t** headers, size_t* count, size_t* capacity,
     (*headers)[*count].value = http_strdup(value);
 
     if (!(*headers)[*count].name || !(*headers)[*count].value) {
-        free((*headers)[*count].name);
-        free((*headers)[*count].value);
+        http_free((*headers)[*count].name);
+        http_free((*headers)[*count].value);
         http_set_error("Failed to allocate memory for header strings");
         return false;
     }
@@ -178,10 +179,10 @@ void http_free_headers(http_header_t* headers, size_t count) {
     if (!headers) return;
 
     for (size_t i = 0; i < count; i++) {
-        free(headers[i].name);
-        free(headers[i].value);
+        http_free(headers[i].name);
+        http_free(headers[i].value);
     }
-    free(headers);
+    http_free(headers);
 }
 
 // Content type utilities
@@ -245,7 +246,7 @@ char* http_url_decode(const char* encoded) {
     if (!encoded) return NULL;
 
     size_t len = strlen(encoded);
-    char* decoded = malloc(len + 1);
+    char* decoded = http_malloc(len + 1);
     if (!decoded) return NULL;
 
     size_t j = 0;
@@ -282,7 +283,7 @@ char* http_url_encode(const char* decoded) {
         }
     }
 
-    char* encoded = malloc(len + 1);
+    char* encoded = http_malloc(len + 1);
     if (!encoded) return NULL;
 
     char* out = encoded;
@@ -323,13 +324,13 @@ bool http_parse_query_string(const char* query, http_header_t** params, size_t*
                 http_add_header(params, count, &capacity, name, value);
             }
 
-            free(name);
-            free(value);
+            http_free(name);
+            http_free(value);
         }
         pair = strtok_r(NULL, "&", &saveptr);
     }
 
-    free(query_copy);
+    http_free(query_copy);
     return true;
 }
 
@@ -337,10 +338,10 @@ bool http_parse_query_string(const char* query, http_header_t** params, size_t*
 void http_free_request(http_request_t* request) {
     if (!request) return;
 
-    free(request->path);
-    free(request->query);
+    http_free(request->path);
+    http_free(request->query);
     http_free_headers(request->headers, request->header_count);
-    free(request->body);
+    http_free(request->body);
 
     memset(request, 0, sizeof(http_request_t));
 }
@@ -349,7 +350,7 @@ void http_free_response(http_response_t* response) {
     if (!response) return;
 
     http_free_headers(response->headers, response->header_count);
-    free(response->body);
+    http_free(response->body);
 
     memset(response, 0, sizeof(http_response_t));
 }
@@ -357,8 +358,8 @@ void http_free_response(http_response_t* response) {
 void http_free_route(http_route_t* route) {
     if (!route) return;
 
-    free(route->path_pattern);
-    free(route->handler_name);
+    http_free(route->path_pattern);
+    http_free(route->handler_name);
 
     memset(route, 0, sizeof(http_route_t));
 }
@@ -366,9 +367,9 @@ void http_free_route(http_route_t* route) {
 void http_free_config(service_config_t* config) {
     if (!config) return;
 
-    free(config->name);
-    free(config->version);
-    free(config->supported_methods);
+    http_free(config->name);
+    http_free(config->version);
+    http_free(config->supported_methods);
 
     memset(config, 0, sizeof(service_config_t));
 }
@@ -451,7 +452,7 @@ char** http_extract_path_params(const char* path, const char* pattern, size_t* c
 
     *count = 0;
     size_t capacity = 4;
-    char** params = malloc(capacity * sizeof(char*));
+    char** params = http_malloc(capacity * sizeof(char*));
     if (!params) return NULL;
 
     while (*path && *pattern) {
@@ -474,7 +475,7 @@ char** http_extract_path_params(const char* path, const char* pattern, size_t* c
             if (param_len > 0) {
                 if (*count >= capacity) {
                     capacity *= 2;
-                    char** new_params = realloc(params, capacity * sizeof(char*));
+                    char** new_params = http_realloc(params, capacity * sizeof(char*));
                     if (!new_params) {
                         http_free_path_params(params, *count);
                         return NULL;
@@ -482,7 +483,7 @@ char** http_extract_path_params(const char* path, const char* pattern, size_t* c
                     params = new_params;
                 }
 
-                params[*count] = malloc(param_len + 1);
+                params[*count] = http_malloc(param_len + 1);
                 if (params[*count]) {
                     strncpy(params[*count], param_start, param_len);
                     params[*count][param_len] = '\0';
@@ -505,9 +506,9 @@ void http_free_path_params(char** params, size_t count) {
     if (!params) return;
 
     for (size_t i = 0; i < count; i++) {
-        free(params[i]);
+        http_free(params[i]);
     }
-    free(params);
+    http_free(params);
 }
 
 // Time utilities
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "http_arena.h"
 #include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -24,6 +25,7 @@ typedef enum {
     HTTP_STATUS_OK = 200,
     HTTP_STATUS_CREATED = 201,
     HTTP_STATUS_NO_CONTENT = 204,
+    HTTP_STATUS_NOT_MODIFIED = 304,
     HTTP_STATUS_BAD_REQUEST = 400,
     HTTP_STATUS_UNAUTHORIZED = 401,
     HTTP_STATUS_FORBIDDEN = 403,
@@ -84,6 +86,8 @@ typedef struct {
     uint64_t failed_requests;
     uint32_t average_response_time_ms;
     uint64_t uptime_seconds;
+    uint64_t cache_hits;    // Static assets served from the asset cache
+    uint64_t cache_misses;  // Static assets read from disk
 } service_stats_t;
 
 // Result structure for request processing
@@ -5,6 +5,11 @@
 #include <ctype.h>
 #include <time.h>
 
+#if defined(__wasm__) && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define HTTP_PARSER_SIMD 1
+#endif
+
 // Create and initialize a new parser
 http_parser_t* http_parser_create(size_t max_header_size, size_t max_body_size) {
     http_parser_t* parser = calloc(1, sizeof(http_parser_t));
@@ -38,9 +43,17 @@ void http_parser_reset(http_parser_t* parser) {
     parser->state = PARSER_STATE_METHOD;
     parser->position = 0;
     parser->buffer_size = 0;
-
-    http_free_request(parser->request);
-    parser->request = calloc(1, sizeof(http_request_t));
+    parser->headers_capacity = 0;
+    parser->mark = 0;
+    parser->input_length = 0;
+    memset(&parser->view, 0, sizeof(parser->view));
+
+    // http_free_request leaves the request zeroed, ready for reuse
+    if (parser->request) {
+        http_free_request(parser->request);
+    } else {
+        parser->request = calloc(1, sizeof(http_request_t));
+    }
 
     free(parser->current_header_name);
     parser->current_header_name = NULL;
@@ -59,12 +72,42 @@ void http_parser_free(http_parser_t* parser) {
     free(parser);
 }
 
+// Offset of the first byte in [from, end) equal to a, b, c or d; end if none.
+// With wasm SIMD, 16 bytes are compared against all four at once.
+static size_t scan_for(const char* data, size_t from, size_t end,
+                       char a, char b, char c, char d) {
+#ifdef HTTP_PARSER_SIMD
+    const v128_t va = wasm_i8x16_splat(a);
+    const v128_t vb = wasm_i8x16_splat(b);
+    const v128_t vc = wasm_i8x16_splat(c);
+    const v128_t vd = wasm_i8x16_splat(d);
+    for (; from + 16 <= end; from += 16) {
+        v128_t chunk = wasm_v128_load(data + from);
+        v128_t hits = wasm_v128_or(wasm_v128_or(wasm_i8x16_eq(chunk, va), wasm_i8x16_eq(chunk, vb)),
+                                   wasm_v128_or(wasm_i8x16_eq(chunk, vc), wasm_i8x16_eq(chunk, vd)));
+        uint32_t mask = wasm_i8x16_bitmask(hits);
+        if (mask) {
+            return from + __builtin_ctz(mask);
+        }
+    }
+#endif
+    for (; from < end; from++) {
+        char ch = data[from];
+        if (ch == a || ch == b || ch == c || ch == d) {
+            return from;
+        }
+    }
+    return end;
+}
+
 // Helper function to find line ending
 static const char* find_line_ending(const char* data, size_t length) {
-    for (size_t i = 0; i < length - 1; i++) {
-        if (data[i] == '\r' && data[i + 1] == '\n') {
+    size_t i = 0;
+    while ((i = scan_for(data, i, length, '\r', '\r', '\r', '\r')) + 1 < length) {
+        if (data[i + 1] == '\n') {
             return &data[i];
         }
+        i++;
     }
     return NULL;
 }
@@ -99,10 +142,268 @@ static bool append_to_buffer(http_parser_t* parser, const char* data, size_t len
     return true;
 }
 
+// Switch parser mode
+bool http_parser_set_mode(http_parser_t* parser, http_parser_mode_t mode) {
+    if (!parser || (mode != HTTP_PARSER_MODE_COPY && mode != HTTP_PARSER_MODE_VIEWS)) {
+        return false;
+    }
+    http_parser_reset(parser);
+    parser->mode = mode;
+    return true;
+}
+
+// View mode helpers
+
+static bool span_equals_nocase(const char* data, http_span_t span, const char* text) {
+    size_t i = 0;
+    for (; i < span.length; i++) {
+        if (!text[i] || tolower((unsigned char)data[span.offset + i]) != tolower((unsigned char)text[i])) {
+            return false;
+        }
+    }
+    return text[i] == '\0';
+}
+
+static bool span_equals(const char* data, http_span_t span, const char* text) {
+    return strlen(text) == span.length && memcmp(data + span.offset, text, span.length) == 0;
+}
+
+static char* span_strdup(const char* data, http_span_t span) {
+    char* copy = http_malloc(span.length + 1);
+    if (copy) {
+        memcpy(copy, data + span.offset, span.length);
+        copy[span.length] = '\0';
+    }
+    return copy;
+}
+
+static bool method_from_span(const char* data, http_span_t span, http_method_t* method) {
+    static const http_method_t methods[] = {
+        HTTP_GET, HTTP_POST, HTTP_PUT, HTTP_DELETE, HTTP_PATCH, HTTP_HEAD, HTTP_OPTIONS
+    };
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        if (span_equals_nocase(data, span, http_method_to_string(methods[i]))) {
+            *method = methods[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static int view_error(http_parser_t* parser, const char* message) {
+    snprintf(parser->error_message, sizeof(parser->error_message), "%s", message);
+    parser->state = PARSER_STATE_ERROR;
+    return -1;
+}
+
+// Checks the headers once the blank line is reached and works out the body
+static int view_finish_head(http_parser_t* parser, const char* data, size_t head_length) {
+    http_request_view_t* view = &parser->view;
+    if (head_length > parser->max_header_size) {
+        return view_error(parser, "Header too large");
+    }
+    if (http_view_find_header(view, data, "Transfer-Encoding")) {
+        return view_error(parser, "Transfer-Encoding is not supported");
+    }
+
+    view->body.offset = head_length;
+    view->body.length = 0;
+    const http_header_view_t* content_length = http_view_find_header(view, data, "Content-Length");
+    if (content_length) {
+        http_span_t value = content_length->value;
+        if (value.length == 0) {
+            return view_error(parser, "Invalid Content-Length");
+        }
+        // Repeated fields must agree (RFC 9112 section 6.3); otherwise a
+        // proxy framing by another of them would see a different body end
+        for (const http_header_view_t* other = content_length + 1;
+             other < view->headers + view->header_count; other++) {
+            if (span_equals_nocase(data, other->name, "Content-Length") &&
+                (other->value.length != value.length ||
+                 memcmp(data + other->value.offset, data + value.offset, value.length) != 0)) {
+                return view_error(parser, "Invalid Content-Length");
+            }
+        }
+        size_t body_size = 0;
+        for (size_t i = 0; i < value.length; i++) {
+            char digit = data[value.offset + i];
+            if (digit < '0' || digit > '9' || body_size > (SIZE_MAX - 9) / 10) {
+                return view_error(parser, "Invalid Content-Length");
+            }
+            body_size = body_size * 10 + (size_t)(digit - '0');
+        }
+        if (body_size > parser->max_body_size) {
+            snprintf(parser->error_message, sizeof(parser->error_message),
+                     "Body too large: %zu bytes", body_size);
+            parser->state = PARSER_STATE_ERROR;
+            return -1;
+        }
+        view->body.length = body_size;
+    }
+
+    parser->position = head_length;
+    parser->state = view->body.length > 0 ? PARSER_STATE_BODY : PARSER_STATE_COMPLETE;
+    return 0;
+}
+
+// View mode parse: each state scans on from position for the bytes that end
+// its part, which starts at mark, and records the part as a span. Running out
+// of input saves position, so the next call carries on from there.
+static int parse_views(http_parser_t* parser, const char* data, size_t length) {
+    http_request_view_t* view = &parser->view;
+    if (length < parser->input_length) {
+        return view_error(parser, "Input shrank between calls");
+    }
+    parser->input_length = length;
+
+    size_t pos = parser->position;
+    while (parser->state != PARSER_STATE_COMPLETE && parser->state != PARSER_STATE_ERROR) {
+        size_t hit;
+        switch (parser->state) {
+            case PARSER_STATE_METHOD: {
+                hit = scan_for(data, pos, length, ' ', '\r', '\n', '\n');
+                if (hit == length) break;
+                http_span_t method = { parser->mark, hit - parser->mark };
+                if (data[hit] != ' ' || !method_from_span(data, method, &view->method)) {
+                    return view_error(parser, "Invalid request method");
+                }
+                pos = parser->mark = hit + 1;
+                parser->state = PARSER_STATE_PATH;
+                continue;
+            }
+
+            case PARSER_STATE_PATH:
+            case PARSER_STATE_QUERY: {
+                bool path = parser->state == PARSER_STATE_PATH;
+                hit = scan_for(data, pos, length, ' ', path ? '?' : ' ', '\r', '\n');
+                if (hit == length) break;
+                if (data[hit] == '\r' || data[hit] == '\n') {
+                    return view_error(parser, "Invalid request line");
+                }
+                http_span_t part = { parser->mark, hit - parser->mark };
+                if (path) {
+                    if (part.length == 0) {
+                        return view_error(parser, "Empty request path");
+                    }
+                    view->path = part;
+                } else {
+                    view->query = part;
+                }
+                pos = parser->mark = hit + 1;
+                if (data[hit] == '?') {
+                    view->has_query = true;
+                    parser->state = PARSER_STATE_QUERY;
+                } else {
+                    parser->state = PARSER_STATE_VERSION;
+                }
+                continue;
+            }
+
+            case PARSER_STATE_VERSION: {
+                hit = scan_for(data, pos, length, '\r', '\n', '\n', '\n');
+                if (hit + 1 >= length) break;  // Need the '\n' after '\r' too
+                view->version.offset = parser->mark;
+                view->version.length = hit - parser->mark;
+                if (data[hit] != '\r' || data[hit + 1] != '\n') {
+                    return view_error(parser, "Invalid request line");
+                }
+                if (!span_equals(data, view->version, "HTTP/1.0") &&
+                    !span_equals(data, view->version, "HTTP/1.1") &&
+                    !span_equals(data, view->version, "HTTP/2.0")) {
+                    return view_error(parser, "Invalid HTTP version");
+                }
+                pos = parser->mark = hit + 2;
+                parser->state = PARSER_STATE_HEADER_NAME;
+                continue;
+            }
+
+            case PARSER_STATE_HEADER_NAME: {
+                if (pos == parser->mark) {
+                    // Start of a line: the blank line or a header
+                    if (pos + 1 >= length) {
+                        hit = pos;
+                        break;
+                    }
+                    if (data[pos] == '\r') {
+                        if (data[pos + 1] != '\n') {
+                            return view_error(parser, "Invalid header line");
+                        }
+                        if (view_finish_head(parser, data, pos + 2) < 0) {
+                            return -1;
+                        }
+                        pos = parser->position;
+                        continue;
+                    }
+                    if (data[pos] == ' ' || data[pos] == '\t') {
+                        return view_error(parser, "Folded header lines are not supported");
+                    }
+                }
+                hit = scan_for(data, pos, length, ':', '\r', '\n', '\n');
+                if (hit == length) break;
+                if (data[hit] != ':' || hit == parser->mark ||
+                    data[hit - 1] == ' ' || data[hit - 1] == '\t') {
+                    return view_error(parser, "Invalid header line");
+                }
+                if (view->header_count == HTTP_MAX_HEADER_COUNT) {
+                    return view_error(parser, "Too many headers");
+                }
+                http_header_view_t* header = &view->headers[view->header_count];
+                header->name.offset = parser->mark;
+                header->name.length = hit - parser->mark;
+                pos = parser->mark = hit + 1;
+                parser->state = PARSER_STATE_HEADER_VALUE;
+                continue;
+            }
+
+            case PARSER_STATE_HEADER_VALUE: {
+                hit = scan_for(data, pos, length, '\r', '\n', '\n', '\n');
+                if (hit + 1 >= length) break;
+                if (data[hit] != '\r' || data[hit + 1] != '\n') {
+                    return view_error(parser, "Invalid header line");
+                }
+                size_t start = parser->mark;
+                size_t end = hit;
+                while (start < end && (data[start] == ' ' || data[start] == '\t')) start++;
+                while (end > start && (data[end - 1] == ' ' || data[end - 1] == '\t')) end--;
+                http_header_view_t* header = &view->headers[view->header_count++];
+                header->value.offset = start;
+                header->value.length = end - start;
+                pos = parser->mark = hit + 2;
+                parser->state = PARSER_STATE_HEADER_NAME;
+                continue;
+            }
+
+            case PARSER_STATE_BODY:
+                // The body is a span too: just wait until all of it is here
+                if (length - view->body.offset < view->body.length) {
+                    return 0;
+                }
+                parser->state = PARSER_STATE_COMPLETE;
+                continue;
+
+            default:
+                return view_error(parser, "Invalid parser state");
+        }
+
+        // Out of input mid-head; hit is where the next call rescans from
+        parser->position = hit < length ? hit : length;
+        if (length > parser->max_header_size) {
+            return view_error(parser, "Header too large");
+        }
+        return 0;
+    }
+
+    return parser->state == PARSER_STATE_COMPLETE ? 1 : -1;
+}
+
 // Parse HTTP request data
 int http_parser_parse(http_parser_t* parser, const char* data, size_t length) {
     if (!parser || !data || length == 0) return -1;
 
+    if (parser->mode == HTTP_PARSER_MODE_VIEWS) {
+        return parse_views(parser, data, length);
+    }
+
     const char* current = data;
     size_t remaining = length;
 
@@ -249,7 +550,7 @@ int http_parser_parse(http_parser_t* parser, const char* data, size_t length) {
                                     return -1;
                                 }
 
-                                parser->request->body = malloc(body_size);
+                                parser->request->body = http_malloc(body_size);
                                 if (!parser->request->body) {
                                     snprintf(parser->error_message, sizeof(parser->error_message),
                                              "Failed to allocate body buffer");
@@ -292,16 +593,16 @@ int http_parser_parse(http_parser_t* parser, const char* data, size_t length) {
                     if (!http_add_header(&parser->request->headers,
                                          &parser->request->header_count,
                                          &capacity, name, value)) {
-                        free(name);
-                        free(value);
+                        http_free(name);
+                        http_free(value);
                         snprintf(parser->error_message, sizeof(parser->error_message),
                                  "Failed to add header");
                         parser->state = PARSER_STATE_ERROR;
                         return -1;
                     }
                     parser->headers_capacity = capacity;
-                    free(name);
-                    free(value);
+                    http_free(name);
+                    http_free(value);
                 } else {
                     snprintf(parser->error_message, sizeof(parser->error_message),
                              "Invalid header line: %s", parser->buffer);
@@ -356,6 +657,88 @@ http_request_t* http_parser_get_request(http_parser_t* parser) {
     return parser->request;
 }
 
+// Get the parsed request's spans
+const http_request_view_t* http_parser_get_view(const http_parser_t* parser) {
+    if (!parser || parser->mode != HTTP_PARSER_MODE_VIEWS ||
+        parser->state != PARSER_STATE_COMPLETE) {
+        return NULL;
+    }
+    return &parser->view;
+}
+
+// Bytes the complete request took
+size_t http_parser_consumed(const http_parser_t* parser) {
+    if (!parser || parser->mode != HTTP_PARSER_MODE_VIEWS ||
+        parser->state != PARSER_STATE_COMPLETE) {
+        return 0;
+    }
+    return parser->view.body.offset + parser->view.body.length;
+}
+
+// Find a header in a view
+const http_header_view_t* http_view_find_header(const http_request_view_t* view,
+                                                const char* data, const char* name) {
+    if (!view || !data || !name) return NULL;
+
+    for (size_t i = 0; i < view->header_count; i++) {
+        if (span_equals_nocase(data, view->headers[i].name, name)) {
+            return &view->headers[i];
+        }
+    }
+    return NULL;
+}
+
+// Copy a view into an owned request
+bool http_view_to_request(const http_request_view_t* view, const char* data,
+                          http_request_t* request) {
+    if (!view || !data || !request) return false;
+
+    memset(request, 0, sizeof(*request));
+    request->method = view->method;
+    request->path = span_strdup(data, view->path);
+    if (!request->path) return false;
+
+    if (view->has_query) {
+        request->query = span_strdup(data, view->query);
+        if (!request->query) {
+            http_free_request(request);
+            return false;
+        }
+    }
+
+    if (view->header_count > 0) {
+        request->headers = http_calloc(view->header_count, sizeof(http_header_t));
+        if (!request->headers) {
+            http_free_request(request);
+            return false;
+        }
+        for (size_t i = 0; i < view->header_count; i++) {
+            http_header_t* header = &request->headers[request->header_count];
+            header->name = span_strdup(data, view->headers[i].name);
+            header->value = span_strdup(data, view->headers[i].value);
+            if (!header->name || !header->value) {
+                http_free(header->name);
+                http_free(header->value);
+                http_free_request(request);
+                return false;
+            }
+            request->header_count++;
+        }
+    }
+
+    if (view->body.length > 0) {
+        request->body = http_malloc(view->body.length);
+        if (!request->body) {
+            http_free_request(request);
+            return false;
+        }
+        memcpy(request->body, data + view->body.offset, view->body.length);
+        request->body_size = view->body.length;
+    }
+
+    return true;
+}
+
 // Get error message
 const char* http_parser_get_error(http_parser_t* parser) {
     if (!parser) return "Invalid parser";
@@ -385,7 +768,7 @@ bool parse_request_line(const char* line, http_method_t* method, char** path, ch
 
     // Extract path
     size_t path_len = space2 - space1 - 1;
-    *path = malloc(path_len + 1);
+    *path = http_malloc(path_len + 1);
     if (!*path) return false;
 
     strncpy(*path, space1 + 1, path_len);
@@ -394,7 +777,7 @@ bool parse_request_line(const char* line, http_method_t* method, char** path, ch
     // Extract version
     *version = http_strdup(space2 + 1);
     if (!*version) {
-        free(*path);
+        http_free(*path);
         return false;
     }
 
@@ -411,7 +794,7 @@ bool parse_header_line(const char* line, char** name, char** value) {
 
     // Extract name
     size_t name_len = colon - line;
-    *name = malloc(name_len + 1);
+    *name = http_malloc(name_len + 1);
     if (!*name) return false;
 
     strncpy(*name, line, name_len);
@@ -431,7 +814,7 @@ bool parse_header_line(const char* line, char** name, char** value) {
 
     *value = http_strdup(value_start);
     if (!*value) {
-        free(*name);
+        http_free(*name);
         return false;
     }
 
@@ -492,7 +875,7 @@ bool request_set_header(http_request_t* request, const char* name, const char* v
             char* new_value = http_strdup(value);
             if (!new_value) return false;
 
-            free(request->headers[i].value);
+            http_free(request->headers[i].value);
             request->headers[i].value = new_value;
             return true;
         }
@@ -509,12 +892,12 @@ bool request_set_body(http_request_t* request, const uint8_t* body, size_t size)
     if (!request || (!body && size > 0)) return false;
 
     // Free existing body
-    free(request->body);
+    http_free(request->body);
     request->body = NULL;
     request->body_size = 0;
 
     if (size > 0) {
-        request->body = malloc(size);
+        request->body = http_malloc(size);
         if (!request->body) return false;
 
         memcpy(request->body, body, size);
@@ -529,6 +912,307 @@ bool request_set_body(http_request_t* request, const uint8_t* body, size_t size)
     return true;
 }
 
+// Clone a request
+http_request_t* request_clone(const http_request_t* request) {
+    if (!request) return NULL;
+
+    http_request_t* clone = http_calloc(1, sizeof(http_request_t));
+    if (!clone) return NULL;
+
+    clone->method = request->method;
+    clone->path = http_strdup(request->path);
+    clone->query = http_strdup(request->query);
+    bool ok = (clone->path || !request->path) && (clone->query || !request->query);
+
+    size_t capacity = 0;
+    for (size_t i = 0; ok && i < request->header_count; i++) {
+        ok = http_add_header(&clone->headers, &clone->header_count, &capacity,
+                             request->headers[i].name, request->headers[i].value);
+    }
+
+    if (ok && request->body_size > 0) {
+        clone->body = http_malloc(request->body_size);
+        if (clone->body) {
+            memcpy(clone->body, request->body, request->body_size);
+            clone->body_size = request->body_size;
+        } else {
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        http_free_request(clone);
+        http_free(clone);
+        return NULL;
+    }
+    return clone;
+}
+
+// First occurrence of needle in haystack, or NULL
+static const uint8_t* find_bytes(const uint8_t* haystack, size_t size,
+                                 const char* needle, size_t needle_size) {
+    if (needle_size == 0 || size < needle_size) return NULL;
+
+    const uint8_t* last = haystack + size - needle_size;
+    for (const uint8_t* p = haystack; p <= last; p++) {
+        p = memchr(p, needle[0], (size_t)(last - p) + 1);
+        if (!p) return NULL;
+        if (memcmp(p, needle, needle_size) == 0) return p;
+    }
+    return NULL;
+}
+
+static bool starts_with_nocase(const char* text, const char* prefix) {
+    for (; *prefix; text++, prefix++) {
+        if (tolower((unsigned char)*text) != tolower((unsigned char)*prefix)) return false;
+    }
+    return true;
+}
+
+// Value of a parameter such as name="x" in a header value like
+// Content-Disposition or Content-Type; quotes are removed
+static char* header_parameter(const char* value, const char* parameter) {
+    size_t length = strlen(parameter);
+    for (const char* p = value; (p = strchr(p, ';')) != NULL;) {
+        p++;
+        while (*p == ' ' || *p == '\t') p++;
+        if (!starts_with_nocase(p, parameter) || p[length] != '=') continue;
+
+        const char* start = p + length + 1;
+        const char* end;
+        if (*start == '"') {
+            start++;
+            end = strchr(start, '"');
+            if (!end) return NULL;
+        } else {
+            end = start + strcspn(start, "; \t");
+        }
+
+        char* result = http_malloc((size_t)(end - start) + 1);
+        if (result) {
+            memcpy(result, start, (size_t)(end - start));
+            result[end - start] = '\0';
+        }
+        return result;
+    }
+    return NULL;
+}
+
+// Parse multipart boundary from Content-Type header
+char* parse_multipart_boundary(const char* content_type) {
+    if (!content_type || !starts_with_nocase(content_type, "multipart/")) return NULL;
+
+    return header_parameter(content_type, "boundary");
+}
+
+// Parse one part's headers and pick out its name, filename and type
+static bool parse_part_headers(multipart_part_t* part, const uint8_t* start, size_t size) {
+    char* headers = http_malloc(size + 1);
+    if (!headers) return false;
+    memcpy(headers, start, size);
+    headers[size] = '\0';
+
+    size_t capacity = 0;
+    bool ok = true;
+    char* saveptr;
+    for (char* line = strtok_r(headers, "\r\n", &saveptr); ok && line;
+         line = strtok_r(NULL, "\r\n", &saveptr)) {
+        char* name = NULL;
+        char* value = NULL;
+        if (!parse_header_line(line, &name, &value)) continue;
+
+        ok = http_add_header(&part->headers, &part->header_count, &capacity, name, value);
+        if (ok && http_strcasecmp(name, "Content-Disposition") == 0) {
+            part->name = header_parameter(value, "name");
+            part->filename = header_parameter(value, "filename");
+        } else if (ok && http_strcasecmp(name, "Content-Type") == 0) {
+            part->content_type = http_strdup(value);
+        }
+        http_free(name);
+        http_free(value);
+    }
+
+    http_free(headers);
+    return ok;
+}
+
+// Parse multipart form data
+multipart_part_t* parse_multipart_body(const uint8_t* body, size_t size,
+                                       const char* boundary, size_t* part_count) {
+    if (!body || !boundary || !part_count) return NULL;
+    *part_count = 0;
+
+    // Parts are separated by CRLF "--" boundary; the first may open the body
+    size_t boundary_size = strlen(boundary);
+    char* delimiter = http_malloc(boundary_size + 5);
+    if (!delimiter) return NULL;
+    memcpy(delimiter, "\r\n--", 4);
+    memcpy(delimiter + 4, boundary, boundary_size + 1);
+    size_t delimiter_size = boundary_size + 4;
+
+    const uint8_t* end = body + size;
+    const uint8_t* p;
+    if (size >= delimiter_size - 2 && memcmp(body, delimiter + 2, delimiter_size - 2) == 0) {
+        p = body + delimiter_size - 2;
+    } else {
+        p = find_bytes(body, size, delimiter, delimiter_size);
+        p = p ? p + delimiter_size : NULL;
+    }
+
+    multipart_part_t* parts = NULL;
+    size_t capacity = 0;
+    bool ok = p != NULL;
+    while (ok) {
+        // "--" after a delimiter closes the body
+        if (end - p >= 2 && p[0] == '-' && p[1] == '-') break;
+        if (end - p < 2 || p[0] != '\r' || p[1] != '\n') {
+            ok = false;
+            break;
+        }
+        p += 2;
+
+        const uint8_t* headers_end = find_bytes(p, (size_t)(end - p), "\r\n\r\n", 4);
+        const uint8_t* next = headers_end
+            ? find_bytes(headers_end + 4, (size_t)(end - headers_end - 4), delimiter, delimiter_size)
+            : NULL;
+        if (!next) {
+            ok = false;
+            break;
+        }
+
+        if (*part_count == capacity) {
+            size_t new_capacity = capacity ? capacity * 2 : 4;
+            multipart_part_t* grown = http_realloc(parts, new_capacity * sizeof(multipart_part_t));
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            parts = grown;
+            capacity = new_capacity;
+        }
+
+        multipart_part_t* part = &parts[(*part_count)++];
+        memset(part, 0, sizeof(*part));
+        ok = parse_part_headers(part, p, (size_t)(headers_end - p));
+
+        const uint8_t* data = headers_end + 4;
+        part->body_size = (size_t)(next - data);
+        if (ok && part->body_size > 0) {
+            part->body = http_malloc(part->body_size);
+            if (part->body) {
+                memcpy(part->body, data, part->body_size);
+            } else {
+                ok = false;
+            }
+        }
+        p = next + delimiter_size;
+    }
+
+    http_free(delimiter);
+    if (!ok) {
+        free_multipart_parts(parts, *part_count);
+        *part_count = 0;
+        return NULL;
+    }
+    return parts;
+}
+
+// Free multipart parts
+void free_multipart_parts(multipart_part_t* parts, size_t count) {
+    if (!parts) return;
+
+    for (size_t i = 0; i < count; i++) {
+        http_free_headers(parts[i].headers, parts[i].header_count);
+        http_free(parts[i].body);
+        http_free(parts[i].name);
+        http_free(parts[i].filename);
+        http_free(parts[i].content_type);
+    }
+    http_free(parts);
+}
+
+// Parse application/x-www-form-urlencoded body
+http_header_t* parse_urlencoded_body(const char* body, size_t* param_count) {
+    if (!body || !param_count) return NULL;
+
+    http_header_t* params = NULL;
+    if (!http_parse_query_string(body, &params, param_count)) return NULL;
+    return params;
+}
+
+// Parse Cookie header ("name=value; name2=value2")
+http_cookie_t* parse_cookie_header(const char* cookie_header, size_t* cookie_count) {
+    if (!cookie_header || !cookie_count) return NULL;
+    *cookie_count = 0;
+
+    size_t capacity = 0;
+    http_cookie_t* cookies = NULL;
+    const char* p = cookie_header;
+    while (*p) {
+        while (*p == ' ' || *p == '\t' || *p == ';') p++;
+        if (!*p) break;
+
+        const char* pair_end = p + strcspn(p, ";");
+        const char* equals = memchr(p, '=', (size_t)(pair_end - p));
+        if (equals && equals > p) {
+            const char* name_end = equals;
+            while (name_end > p && (name_end[-1] == ' ' || name_end[-1] == '\t')) name_end--;
+            const char* value = equals + 1;
+            const char* value_end = pair_end;
+            while (value < value_end && (*value == ' ' || *value == '\t')) value++;
+            while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t')) value_end--;
+            if (value_end - value >= 2 && *value == '"' && value_end[-1] == '"') {
+                value++;
+                value_end--;
+            }
+
+            if (*cookie_count == capacity) {
+                size_t new_capacity = capacity ? capacity * 2 : 8;
+                http_cookie_t* grown = http_realloc(cookies, new_capacity * sizeof(http_cookie_t));
+                if (!grown) {
+                    free_cookies(cookies, *cookie_count);
+                    *cookie_count = 0;
+                    return NULL;
+                }
+                cookies = grown;
+                capacity = new_capacity;
+            }
+
+            http_cookie_t* cookie = &cookies[*cookie_count];
+            memset(cookie, 0, sizeof(*cookie));
+            cookie->name = http_malloc((size_t)(name_end - p) + 1);
+            cookie->value = http_malloc((size_t)(value_end - value) + 1);
+            if (!cookie->name || !cookie->value) {
+                http_free(cookie->name);
+                http_free(cookie->value);
+                free_cookies(cookies, *cookie_count);
+                *cookie_count = 0;
+                return NULL;
+            }
+            memcpy(cookie->name, p, (size_t)(name_end - p));
+            cookie->name[name_end - p] = '\0';
+            memcpy(cookie->value, value, (size_t)(value_end - value));
+            cookie->value[value_end - value] = '\0';
+            (*cookie_count)++;
+        }
+        p = pair_end;
+    }
+    return cookies;
+}
+
+// Free cookies
+void free_cookies(http_cookie_t* cookies, size_t count) {
+    if (!cookies) return;
+
+    for (size_t i = 0; i < count; i++) {
+        http_free(cookies[i].name);
+        http_free(cookies[i].value);
+        http_free(cookies[i].domain);
+        http_free(cookies[i].path);
+    }
+    http_free(cookies);
+}
+
 // Check if request contains JSON body
 bool request_is_json(const http_request_t* request) {
     if (!request) return false;
@@ -552,7 +1236,7 @@ char* request_get_json_string(const http_request_t* request) {
     }
 
     // Allocate string with null terminator
-    char* json = malloc(request->body_size + 1);
+    char* json = http_malloc(request->body_size + 1);
     if (!json) return NULL;
 
     memcpy(json, request->body, request->body_size);
@@ -575,7 +1259,7 @@ char* request_to_string(const http_request_t* request) {
 
     size += request->body_size + 100;
 
-    char* str = malloc(size);
+    char* str = http_malloc(size);
     if (!str) return NULL;
 
     // Format request
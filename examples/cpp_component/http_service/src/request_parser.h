@@ -10,6 +10,7 @@ extern "C" {
 typedef enum {
     PARSER_STATE_METHOD,
     PARSER_STATE_PATH,
+    PARSER_STATE_QUERY,
     PARSER_STATE_VERSION,
     PARSER_STATE_HEADER_NAME,
     PARSER_STATE_HEADER_VALUE,
@@ -18,9 +19,44 @@ typedef enum {
     PARSER_STATE_ERROR
 } parser_state_t;
 
+// How the parser hands out the request
+typedef enum {
+    // Copies each part into the malloc'd http_request_t of
+    // http_parser_get_request(); data may be discarded after each call
+    HTTP_PARSER_MODE_COPY,
+    // Records spans into the caller's input for http_parser_get_view(); every
+    // call passes the whole input so far, which the caller only appends to
+    HTTP_PARSER_MODE_VIEWS
+} http_parser_mode_t;
+
+// Part of the input: bytes [offset, offset + length)
+typedef struct {
+    size_t offset;
+    size_t length;
+} http_span_t;
+
+typedef struct {
+    http_span_t name;
+    http_span_t value;  // Surrounding whitespace trimmed
+} http_header_view_t;
+
+// Request parsed in HTTP_PARSER_MODE_VIEWS; nothing is copied or allocated,
+// so the spans are only meaningful together with the input they index
+typedef struct {
+    http_method_t method;
+    http_span_t path;
+    bool has_query;
+    http_span_t query;    // After '?', when has_query
+    http_span_t version;
+    http_header_view_t headers[HTTP_MAX_HEADER_COUNT];
+    size_t header_count;
+    http_span_t body;     // Content-Length bytes after the blank line
+} http_request_view_t;
+
 // HTTP parser structure
 typedef struct {
     parser_state_t state;
+    http_parser_mode_t mode;
     http_request_t* request;
 
     // Parsing buffers
@@ -28,9 +64,14 @@ typedef struct {
     size_t buffer_size;
     size_t buffer_capacity;
 
-    // Current parsing position
+    // Current parsing position; in view mode the offset scanning resumes from
     size_t position;
 
+    // View mode: start of the part being scanned, input seen so far, result
+    size_t mark;
+    size_t input_length;
+    http_request_view_t view;
+
     // Temporary storage during parsing
     char* current_header_name;
     size_t headers_capacity;
@@ -54,13 +95,33 @@ void http_parser_reset(http_parser_t* parser);
 // Free parser and associated resources
 void http_parser_free(http_parser_t* parser);
 
+// Switch between copy (the default) and view mode; resets the parser
+bool http_parser_set_mode(http_parser_t* parser, http_parser_mode_t mode);
+
 // Parse HTTP request data
 // Returns: 0 = need more data, 1 = complete, -1 = error
+// In view mode data is the whole input received so far, not just the new
+// bytes; scanning resumes where the previous call stopped.
 int http_parser_parse(http_parser_t* parser, const char* data, size_t length);
 
 // Get the parsed request (only valid after parse returns 1)
 http_request_t* http_parser_get_request(http_parser_t* parser);
 
+// Get the parsed request's spans (view mode, only valid after parse returns 1)
+const http_request_view_t* http_parser_get_view(const http_parser_t* parser);
+
+// Bytes of input the complete request took (view mode); a pipelined request
+// starts there
+size_t http_parser_consumed(const http_parser_t* parser);
+
+// Find a header by case-insensitive name in a view of data
+const http_header_view_t* http_view_find_header(const http_request_view_t* view,
+                                                const char* data, const char* name);
+
+// Copy a view of data into an owned request; free with http_free_request
+bool http_view_to_request(const http_request_view_t* view, const char* data,
+                          http_request_t* request);
+
 // Get error message (only valid after parse returns -1)
 const char* http_parser_get_error(http_parser_t* parser);
 
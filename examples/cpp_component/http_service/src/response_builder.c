@@ -6,12 +6,12 @@
 
 // Create a new response builder
 response_builder_t* response_builder_create(void) {
-    response_builder_t* builder = calloc(1, sizeof(response_builder_t));
+    response_builder_t* builder = http_calloc(1, sizeof(response_builder_t));
     if (!builder) return NULL;
 
-    builder->response = calloc(1, sizeof(http_response_t));
+    builder->response = http_calloc(1, sizeof(http_response_t));
     if (!builder->response) {
-        free(builder);
+        http_free(builder);
         return NULL;
     }
 
@@ -28,19 +28,21 @@ response_builder_t* response_builder_create(void) {
 void response_builder_reset(response_builder_t* builder) {
     if (!builder) return;
 
+    // The response struct is kept; its headers and body go
     http_free_response(builder->response);
-    builder->response = calloc(1, sizeof(http_response_t));
     builder->response->status = HTTP_STATUS_OK;
+    builder->headers_capacity = 0;
+    builder->body_capacity = 0;
 
     // Clear templates
     for (size_t i = 0; i < builder->template_count; i++) {
-        free(builder->templates[i]);
+        http_free(builder->templates[i]);
     }
     builder->template_count = 0;
 
     // Clear accepted types
     for (size_t i = 0; i < builder->accepted_count; i++) {
-        free(builder->accepted_types[i]);
+        http_free(builder->accepted_types[i]);
     }
     builder->accepted_count = 0;
 
@@ -52,20 +54,20 @@ void response_builder_free(response_builder_t* builder) {
     if (!builder) return;
 
     http_free_response(builder->response);
-    free(builder->response);
+    http_free(builder->response);
 
     // Free templates
     for (size_t i = 0; i < builder->template_count; i++) {
-        free(builder->templates[i]);
+        http_free(builder->templates[i]);
     }
-    free(builder->templates);
+    http_free(builder->templates);
 
     // Free accepted types
     for (size_t i = 0; i < builder->accepted_count; i++) {
-        free(builder->accepted_types[i]);
+        http_free(builder->accepted_types[i]);
     }
 
-    free(builder);
+    http_free(builder);
 }
 
 // Set response status
@@ -92,8 +94,8 @@ bool response_remove_header(response_builder_t* builder, const char* name) {
     for (size_t i = 0; i < builder->response->header_count; i++) {
         if (http_strcasecmp(builder->response->headers[i].name, name) == 0) {
             // Free this header
-            free(builder->response->headers[i].name);
-            free(builder->response->headers[i].value);
+            http_free(builder->response->headers[i].name);
+            http_free(builder->response->headers[i].value);
 
             // Shift remaining headers
             for (size_t j = i; j < builder->response->header_count - 1; j++) {
@@ -113,12 +115,12 @@ bool response_set_body(response_builder_t* builder, const uint8_t* body, size_t
     if (!builder) return false;
 
     // Free existing body
-    free(builder->response->body);
+    http_free(builder->response->body);
     builder->response->body = NULL;
     builder->response->body_size = 0;
 
     if (body && size > 0) {
-        builder->response->body = malloc(size);
+        builder->response->body = http_malloc(size);
         if (!builder->response->body) {
             snprintf(builder->error_message, sizeof(builder->error_message),
                      "Failed to allocate body buffer");
@@ -145,7 +147,7 @@ bool response_append_body(response_builder_t* builder, const uint8_t* data, size
     if (!builder || !data || size == 0) return false;
 
     size_t new_size = builder->response->body_size + size;
-    uint8_t* new_body = realloc(builder->response->body, new_size);
+    uint8_t* new_body = http_realloc(builder->response->body, new_size);
     if (!new_body) {
         snprintf(builder->error_message, sizeof(builder->error_message),
                  "Failed to expand body buffer");
@@ -294,7 +296,7 @@ char* response_substitute_variables(const char* template_str,
 
     size_t template_len = strlen(template_str);
     size_t result_capacity = template_len * 2;
-    char* result = malloc(result_capacity);
+    char* result = http_malloc(result_capacity);
     if (!result) return NULL;
 
     size_t result_len = 0;
@@ -329,9 +331,9 @@ char* response_substitute_variables(const char* template_str,
                         // Ensure capacity
                         while (result_len + value_len >= result_capacity) {
                             result_capacity *= 2;
-                            char* new_result = realloc(result, result_capacity);
+                            char* new_result = http_realloc(result, result_capacity);
                             if (!new_result) {
-                                free(result);
+                                http_free(result);
                                 return NULL;
                             }
                             result = new_result;
@@ -351,9 +353,9 @@ char* response_substitute_variables(const char* template_str,
         // Ensure capacity for one more character
         if (result_len >= result_capacity - 1) {
             result_capacity *= 2;
-            char* new_result = realloc(result, result_capacity);
+            char* new_result = http_realloc(result, result_capacity);
             if (!new_result) {
-                free(result);
+                http_free(result);
                 return NULL;
             }
             result = new_result;
@@ -570,16 +572,16 @@ http_response_t* build_health_response(bool healthy, const char* details) {
 http_response_t* response_clone_response(const http_response_t* response) {
     if (!response) return NULL;
 
-    http_response_t* clone = calloc(1, sizeof(http_response_t));
+    http_response_t* clone = http_calloc(1, sizeof(http_response_t));
     if (!clone) return NULL;
 
     clone->status = response->status;
 
     // Clone headers
     if (response->header_count > 0) {
-        clone->headers = malloc(response->header_count * sizeof(http_header_t));
+        clone->headers = http_malloc(response->header_count * sizeof(http_header_t));
         if (!clone->headers) {
-            free(clone);
+            http_free(clone);
             return NULL;
         }
 
@@ -590,7 +592,7 @@ http_response_t* response_clone_response(const http_response_t* response) {
 
             if (!clone->headers[i].name || !clone->headers[i].value) {
                 http_free_response(clone);
-                free(clone);
+                http_free(clone);
                 return NULL;
             }
         }
@@ -598,10 +600,10 @@ http_response_t* response_clone_response(const http_response_t* response) {
 
     // Clone body
     if (response->body_size > 0) {
-        clone->body = malloc(response->body_size);
+        clone->body = http_malloc(response->body_size);
         if (!clone->body) {
             http_free_response(clone);
-            free(clone);
+            http_free(clone);
             return NULL;
         }
 
@@ -611,3 +613,278 @@ http_response_t* response_clone_response(const http_response_t* response) {
 
     return clone;
 }
+
+// Response streaming
+
+static response_stream_t* stream_create(response_builder_t* builder) {
+    if (!builder) return NULL;
+
+    response_stream_t* stream = http_calloc(1, sizeof(response_stream_t));
+    if (!stream) return NULL;
+
+    stream->builder = builder;
+    return stream;
+}
+
+// Create streaming response
+response_stream_t* response_stream_create(response_builder_t* builder,
+                                         void (*write_chunk)(const uint8_t*, size_t, void*),
+                                         void* user_data) {
+    if (!write_chunk) return NULL;
+
+    response_stream_t* stream = stream_create(builder);
+    if (!stream) return NULL;
+
+    stream->write_chunk = write_chunk;
+    stream->user_data = user_data;
+    return stream;
+}
+
+// Create streaming response on a vectored sink with backpressure
+response_stream_t* response_stream_create_vectored(response_builder_t* builder,
+                                                   response_write_segments_t write_segments,
+                                                   void* user_data) {
+    if (!write_segments) return NULL;
+
+    response_stream_t* stream = stream_create(builder);
+    if (!stream) return NULL;
+
+    stream->write_segments = write_segments;
+    stream->user_data = user_data;
+    return stream;
+}
+
+// Statuses that never carry a body
+static bool status_has_body(http_status_t status) {
+    return status >= 200 && status != HTTP_STATUS_NO_CONTENT &&
+           status != HTTP_STATUS_NOT_MODIFIED;
+}
+
+// Append to the header block; false when it does not fit
+static bool header_block_append(response_stream_t* stream, const char* name, const char* value) {
+    size_t room = sizeof(stream->header_block) - stream->header_length;
+    int written = snprintf(stream->header_block + stream->header_length, room, "%s: %s\r\n",
+                           name, value);
+    if (written < 0 || (size_t)written >= room) return false;
+
+    stream->header_length += (size_t)written;
+    return true;
+}
+
+static bool serialize_headers(response_stream_t* stream) {
+    response_builder_t* builder = stream->builder;
+    http_response_t* response = builder->response;
+
+    // Date and Server as for a buffered response; the length is not known
+    bool auto_length = builder->auto_content_length;
+    builder->auto_content_length = false;
+    response_finalize(builder);
+    builder->auto_content_length = auto_length;
+
+    int written = snprintf(stream->header_block, sizeof(stream->header_block),
+                           "HTTP/1.1 %d %s\r\n", response->status,
+                           http_status_to_reason_phrase(response->status));
+    if (written < 0 || (size_t)written >= sizeof(stream->header_block)) return false;
+    stream->header_length = (size_t)written;
+
+    for (size_t i = 0; i < response->header_count; i++) {
+        if (!header_block_append(stream, response->headers[i].name,
+                                 response->headers[i].value)) {
+            return false;
+        }
+    }
+
+    stream->chunked = status_has_body(response->status) &&
+                      !http_find_header(response->headers, response->header_count,
+                                        "Content-Length");
+    if (stream->chunked && !header_block_append(stream, "Transfer-Encoding", "chunked")) {
+        return false;
+    }
+
+    if (sizeof(stream->header_block) - stream->header_length < 3) return false;
+    memcpy(stream->header_block + stream->header_length, "\r\n", 3);
+    stream->header_length += 2;
+    return true;
+}
+
+static void stream_fail(response_stream_t* stream, const char* message) {
+    stream->failed = true;
+    snprintf(stream->builder->error_message, sizeof(stream->builder->error_message), "%s",
+             message);
+}
+
+// Hand queued bytes to the sink
+response_stream_status_t response_stream_flush(response_stream_t* stream) {
+    if (!stream || stream->failed) return RESPONSE_STREAM_ERROR;
+
+    while (stream->pending_count > 0) {
+        // The first segment may be partly sent; present only its rest
+        response_segment_t first = stream->pending[0];
+        stream->pending[0].data += stream->pending_offset;
+        stream->pending[0].size -= stream->pending_offset;
+
+        size_t accepted;
+        if (stream->write_segments) {
+            accepted = stream->write_segments(stream->pending, stream->pending_count,
+                                              stream->user_data);
+        } else {
+            accepted = 0;
+            for (size_t i = 0; i < stream->pending_count; i++) {
+                if (stream->pending[i].size > 0) {
+                    stream->write_chunk(stream->pending[i].data, stream->pending[i].size,
+                                        stream->user_data);
+                }
+                accepted += stream->pending[i].size;
+            }
+        }
+        stream->pending[0] = first;
+
+        if (accepted == 0) return RESPONSE_STREAM_PENDING;
+
+        // Drop what the sink took
+        accepted += stream->pending_offset;
+        size_t done = 0;
+        while (done < stream->pending_count && accepted >= stream->pending[done].size) {
+            accepted -= stream->pending[done].size;
+            done++;
+        }
+        if (done == stream->pending_count && accepted > 0) {
+            stream_fail(stream, "Sink accepted more bytes than it was given");
+            return RESPONSE_STREAM_ERROR;
+        }
+        memmove(stream->pending, stream->pending + done,
+                (stream->pending_count - done) * sizeof(response_segment_t));
+        stream->pending_count -= done;
+        stream->pending_offset = accepted;
+    }
+
+    stream->pending_offset = 0;
+    return RESPONSE_STREAM_DONE;
+}
+
+static void queue_segment(response_stream_t* stream, const void* data, size_t size) {
+    if (size == 0) return;
+
+    stream->pending[stream->pending_count].data = data;
+    stream->pending[stream->pending_count].size = size;
+    stream->pending_count++;
+}
+
+static response_stream_status_t stream_begin(response_stream_t* stream) {
+    if (!stream || stream->failed || stream->finished) return RESPONSE_STREAM_ERROR;
+    if (stream->pending_count > 0) {
+        stream_fail(stream, "Stream written before its queued bytes were flushed");
+        return RESPONSE_STREAM_ERROR;
+    }
+    if (stream->headers_sent) return RESPONSE_STREAM_DONE;
+
+    if (!serialize_headers(stream)) {
+        stream_fail(stream, "Response headers exceed the stream header block");
+        return RESPONSE_STREAM_ERROR;
+    }
+    stream->headers_sent = true;
+    queue_segment(stream, stream->header_block, stream->header_length);
+    return RESPONSE_STREAM_DONE;
+}
+
+// Send headers for streaming response
+bool response_stream_send_headers(response_stream_t* stream) {
+    if (stream && stream->headers_sent) return !stream->failed;
+    if (stream_begin(stream) == RESPONSE_STREAM_ERROR) return false;
+
+    return response_stream_flush(stream) != RESPONSE_STREAM_ERROR;
+}
+
+// Write segments as one chunk
+response_stream_status_t response_stream_write_segments(response_stream_t* stream,
+                                                        const response_segment_t* segments,
+                                                        size_t count) {
+    if (count > RESPONSE_STREAM_MAX_SEGMENTS || (count > 0 && !segments)) {
+        return RESPONSE_STREAM_ERROR;
+    }
+    if (stream_begin(stream) == RESPONSE_STREAM_ERROR) return RESPONSE_STREAM_ERROR;
+
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += segments[i].size;
+    }
+
+    if (total > 0 && !status_has_body(stream->builder->response->status)) {
+        stream_fail(stream, "Response status does not allow a body");
+        return RESPONSE_STREAM_ERROR;
+    }
+
+    // An empty chunk would end the body
+    if (stream->chunked && total > 0) {
+        snprintf(stream->chunk_line, sizeof(stream->chunk_line), "%zx\r\n", total);
+        queue_segment(stream, stream->chunk_line, strlen(stream->chunk_line));
+    }
+    for (size_t i = 0; i < count; i++) {
+        queue_segment(stream, segments[i].data, segments[i].size);
+    }
+    if (stream->chunked && total > 0) {
+        queue_segment(stream, "\r\n", 2);
+    }
+    stream->body_bytes += total;
+
+    return response_stream_flush(stream);
+}
+
+// Write chunk to streaming response
+bool response_stream_write_chunk(response_stream_t* stream, const uint8_t* data, size_t size) {
+    if (size > 0 && !data) return false;
+
+    response_segment_t segment = {data, size};
+    return response_stream_write_segments(stream, &segment, 1) != RESPONSE_STREAM_ERROR;
+}
+
+// Send the builder's body as it is and finish
+response_stream_status_t response_stream_send_response(response_stream_t* stream) {
+    if (!stream || stream->headers_sent) return RESPONSE_STREAM_ERROR;
+
+    http_response_t* response = stream->builder->response;
+    if (status_has_body(response->status) &&
+        !http_find_header(response->headers, response->header_count, "Content-Length")) {
+        char length_str[32];
+        snprintf(length_str, sizeof(length_str), "%zu", response->body_size);
+        if (!response_add_header(stream->builder, "Content-Length", length_str)) {
+            return RESPONSE_STREAM_ERROR;
+        }
+    }
+
+    response_segment_t body = {response->body, response->body_size};
+    response_stream_status_t status = response_stream_write_segments(stream, &body, 1);
+    if (status == RESPONSE_STREAM_ERROR) return status;
+
+    stream->finished = true;
+    return status;
+}
+
+// Bytes still queued in the stream
+size_t response_stream_pending_bytes(const response_stream_t* stream) {
+    if (!stream) return 0;
+
+    size_t total = 0;
+    for (size_t i = 0; i < stream->pending_count; i++) {
+        total += stream->pending[i].size;
+    }
+    return total - stream->pending_offset;
+}
+
+// Finish streaming response; the last chunk may still be queued, so a
+// vectored caller flushes until nothing is pending
+bool response_stream_finish(response_stream_t* stream) {
+    if (stream && stream->finished) return !stream->failed;
+    if (stream_begin(stream) == RESPONSE_STREAM_ERROR) return false;
+
+    if (stream->chunked) {
+        queue_segment(stream, "0\r\n\r\n", 5);
+    }
+    stream->finished = true;
+    return response_stream_flush(stream) != RESPONSE_STREAM_ERROR;
+}
+
+// Free streaming response; the builder stays with the caller
+void response_stream_free(response_stream_t* stream) {
+    http_free(stream);
+}
@@ -236,27 +236,93 @@ http_response_t* build_options_response(const char* allowed_methods);
 http_response_t* build_health_response(bool healthy, const char* details);
 
 // Response streaming support (for large responses)
+//
+// A stream serializes the status line and headers once into a fixed buffer
+// and sends the body as segments that point at the caller's bytes (static
+// buffers, cached files, generated chunks), so nothing is concatenated or
+// copied. Without a Content-Length header the body goes out with chunked
+// transfer encoding, one chunk per write.
+//
+// Vectored sinks apply backpressure: they return how many bytes they took,
+// and whatever they did not take stays queued in the stream. A write then
+// returns RESPONSE_STREAM_PENDING; the caller keeps those bytes alive and
+// calls response_stream_flush when the sink can take more, and may only
+// write again once a flush returns RESPONSE_STREAM_DONE.
+
+#define RESPONSE_STREAM_HEADER_CAPACITY 4096
+#define RESPONSE_STREAM_MAX_SEGMENTS 16  // Per write
+
+// Bytes to send, not copied
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} response_segment_t;
+
+typedef enum {
+    RESPONSE_STREAM_DONE,     // Everything so far is with the sink
+    RESPONSE_STREAM_PENDING,  // Sink is full; flush later
+    RESPONSE_STREAM_ERROR
+} response_stream_status_t;
+
+// Vectored sink: returns the bytes of segments it accepted, in order
+typedef size_t (*response_write_segments_t)(const response_segment_t* segments, size_t count,
+                                            void* user_data);
 
 // Streaming response structure
 typedef struct {
     response_builder_t* builder;
     void (*write_chunk)(const uint8_t* data, size_t size, void* user_data);
+    response_write_segments_t write_segments;
     void* user_data;
     bool headers_sent;
     bool finished;
+    bool chunked;
+    bool failed;
+
+    // Status line and headers, serialized once
+    char header_block[RESPONSE_STREAM_HEADER_CAPACITY];
+    size_t header_length;
+
+    // Segments the sink has not taken yet; offset bytes of the first are sent
+    response_segment_t pending[RESPONSE_STREAM_MAX_SEGMENTS + 3];
+    size_t pending_count;
+    size_t pending_offset;
+    char chunk_line[24];  // Chunk size line of the write in flight
+
+    uint64_t body_bytes;
 } response_stream_t;
 
-// Create streaming response
+// Create streaming response; write_chunk takes every byte it is given
 response_stream_t* response_stream_create(response_builder_t* builder,
                                          void (*write_chunk)(const uint8_t*, size_t, void*),
                                          void* user_data);
 
+// Create streaming response on a vectored sink with backpressure
+response_stream_t* response_stream_create_vectored(response_builder_t* builder,
+                                                   response_write_segments_t write_segments,
+                                                   void* user_data);
+
 // Send headers for streaming response
 bool response_stream_send_headers(response_stream_t* stream);
 
 // Write chunk to streaming response
 bool response_stream_write_chunk(response_stream_t* stream, const uint8_t* data, size_t size);
 
+// Write up to RESPONSE_STREAM_MAX_SEGMENTS segments as one chunk; sends the
+// headers first if needed
+response_stream_status_t response_stream_write_segments(response_stream_t* stream,
+                                                        const response_segment_t* segments,
+                                                        size_t count);
+
+// Hand queued bytes to the sink
+response_stream_status_t response_stream_flush(response_stream_t* stream);
+
+// Send the builder's body as it is, with a Content-Length, and finish
+response_stream_status_t response_stream_send_response(response_stream_t* stream);
+
+// Bytes still queued in the stream
+size_t response_stream_pending_bytes(const response_stream_t* stream);
+
 // Finish streaming response
 bool response_stream_finish(response_stream_t* stream);
 
@@ -0,0 +1,413 @@
+#include "router.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tree node: static nodes match prefix; the param and wildcard children of a
+// node carry the :name / *name they bind
+struct http_router_node {
+    char* prefix;
+    size_t prefix_length;
+    char* name;
+    size_t name_length;
+
+    // Static children, sorted by the first byte of their prefix, which is
+    // unique among siblings
+    http_router_node_t** children;
+    size_t child_count;
+    size_t child_capacity;
+
+    http_router_node_t* param;
+    http_router_node_t* wildcard;
+
+    bool has_value;
+    void* value;
+};
+
+static http_router_node_t* node_create(const char* text, size_t length) {
+    http_router_node_t* node = calloc(1, sizeof(http_router_node_t));
+    if (!node) return NULL;
+
+    node->prefix = malloc(length + 1);
+    if (!node->prefix) {
+        free(node);
+        return NULL;
+    }
+    memcpy(node->prefix, text, length);
+    node->prefix[length] = '\0';
+    node->prefix_length = length;
+    return node;
+}
+
+static void node_free(http_router_node_t* node) {
+    if (!node) return;
+
+    for (size_t i = 0; i < node->child_count; i++) {
+        node_free(node->children[i]);
+    }
+    free(node->children);
+    node_free(node->param);
+    node_free(node->wildcard);
+    free(node->prefix);
+    free(node->name);
+    free(node);
+}
+
+// Index of the child starting with c, or of where it would go
+static size_t node_child_index(const http_router_node_t* node, char c) {
+    size_t low = 0;
+    size_t high = node->child_count;
+    while (low < high) {
+        size_t mid = (low + high) / 2;
+        if ((unsigned char)node->children[mid]->prefix[0] < (unsigned char)c) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static http_router_node_t* node_find_child(const http_router_node_t* node, char c) {
+    size_t index = node_child_index(node, c);
+    if (index < node->child_count && node->children[index]->prefix[0] == c) {
+        return node->children[index];
+    }
+    return NULL;
+}
+
+static bool node_add_child(http_router_node_t* node, http_router_node_t* child) {
+    if (node->child_count == node->child_capacity) {
+        size_t capacity = node->child_capacity ? node->child_capacity * 2 : 2;
+        http_router_node_t** children = realloc(node->children, capacity * sizeof(*children));
+        if (!children) return false;
+        node->children = children;
+        node->child_capacity = capacity;
+    }
+    size_t index = node_child_index(node, child->prefix[0]);
+    memmove(&node->children[index + 1], &node->children[index],
+            (node->child_count - index) * sizeof(*node->children));
+    node->children[index] = child;
+    node->child_count++;
+    return true;
+}
+
+// Split node's edge after at bytes; the rest, with everything below, moves
+// to a new child
+static bool node_split(http_router_node_t* node, size_t at) {
+    http_router_node_t* tail = node_create(node->prefix + at, node->prefix_length - at);
+    if (!tail) return false;
+
+    http_router_node_t** children = malloc(2 * sizeof(*children));
+    if (!children) {
+        node_free(tail);
+        return false;
+    }
+
+    tail->children = node->children;
+    tail->child_count = node->child_count;
+    tail->child_capacity = node->child_capacity;
+    tail->param = node->param;
+    tail->wildcard = node->wildcard;
+    tail->has_value = node->has_value;
+    tail->value = node->value;
+
+    children[0] = tail;
+    node->children = children;
+    node->child_count = 1;
+    node->child_capacity = 2;
+    node->param = NULL;
+    node->wildcard = NULL;
+    node->has_value = false;
+    node->value = NULL;
+    node->prefix_length = at;
+    node->prefix[at] = '\0';
+    return true;
+}
+
+// Whether pattern fits the tree: ':' and '*' only open a segment, '*' only
+// the last one, and the rest of the segment is a name of letters, digits and
+// '_' (non-empty for ':'). Anything else, such as "*.txt", is a glob.
+static bool is_tree_pattern(const char* pattern, size_t* param_count) {
+    *param_count = 0;
+    for (size_t i = 0; pattern[i]; i++) {
+        if (pattern[i] != ':' && pattern[i] != '*') continue;
+
+        if (i > 0 && pattern[i - 1] != '/') return false;
+        size_t end = i + 1;
+        for (; pattern[end] && pattern[end] != '/'; end++) {
+            if (!isalnum((unsigned char)pattern[end]) && pattern[end] != '_') return false;
+        }
+        if (pattern[i] == '*' ? pattern[end] != '\0' : end == i + 1) return false;
+
+        (*param_count)++;
+        i = end - 1;
+    }
+    return true;
+}
+
+// Follow pattern down from root, creating nodes when create is set. NULL when
+// the pattern is not in the tree, out of memory, or (conflict) a parameter is
+// named differently from an existing one in the same place.
+static http_router_node_t* node_walk(http_router_node_t* node, const char* pattern, bool create,
+                                     bool* conflict) {
+    const char* p = pattern;
+    while (*p) {
+        if (*p == ':' || *p == '*') {
+            http_router_node_t** slot = *p == ':' ? &node->param : &node->wildcard;
+            const char* name = p + 1;
+            size_t name_length = strcspn(name, "/");
+            if (!*slot) {
+                if (!create) return NULL;
+                *slot = node_create("", 0);
+                if (!*slot) return NULL;
+                (*slot)->name = malloc(name_length + 1);
+                if (!(*slot)->name) {
+                    node_free(*slot);
+                    *slot = NULL;
+                    return NULL;
+                }
+                memcpy((*slot)->name, name, name_length);
+                (*slot)->name[name_length] = '\0';
+                (*slot)->name_length = name_length;
+            } else if ((*slot)->name_length != name_length ||
+                       memcmp((*slot)->name, name, name_length) != 0) {
+                *conflict = create;
+                return NULL;
+            }
+            node = *slot;
+            p = name + name_length;
+            continue;
+        }
+
+        size_t length = strcspn(p, ":*");
+        while (length > 0) {
+            http_router_node_t* child = node_find_child(node, *p);
+            if (!child) {
+                if (!create) return NULL;
+                child = node_create(p, length);
+                if (!child || !node_add_child(node, child)) {
+                    node_free(child);
+                    return NULL;
+                }
+                node = child;
+                p += length;
+                break;
+            }
+
+            size_t common = 0;
+            while (common < length && common < child->prefix_length && child->prefix[common] == p[common]) {
+                common++;
+            }
+            if (common < child->prefix_length) {
+                if (!create || !node_split(child, common)) return NULL;
+            }
+            node = child;
+            p += common;
+            length -= common;
+        }
+    }
+    return node;
+}
+
+static bool node_match(const http_router_node_t* node, const char* path, size_t length,
+                       http_route_match_t* match) {
+    if (length == 0 && node->has_value) {
+        match->value = node->value;
+        return true;
+    }
+
+    if (length > 0) {
+        const http_router_node_t* child = node_find_child(node, path[0]);
+        if (child && child->prefix_length <= length &&
+            memcmp(child->prefix, path, child->prefix_length) == 0 &&
+            node_match(child, path + child->prefix_length, length - child->prefix_length, match)) {
+            return true;
+        }
+
+        if (node->param && match->param_count < HTTP_ROUTER_MAX_PARAMS) {
+            size_t segment = 0;
+            while (segment < length && path[segment] != '/') segment++;
+            if (segment > 0) {
+                http_route_param_t* param = &match->params[match->param_count++];
+                param->name = node->param->name;
+                param->name_length = node->param->name_length;
+                param->value = path;
+                param->value_length = segment;
+                if (node_match(node->param, path + segment, length - segment, match)) {
+                    return true;
+                }
+                match->param_count--;
+            }
+        }
+    }
+
+    if (node->wildcard && node->wildcard->has_value && match->param_count < HTTP_ROUTER_MAX_PARAMS) {
+        http_route_param_t* param = &match->params[match->param_count++];
+        param->name = node->wildcard->name;
+        param->name_length = node->wildcard->name_length;
+        param->value = path;
+        param->value_length = length;
+        match->value = node->wildcard->value;
+        return true;
+    }
+
+    return false;
+}
+
+void http_router_init(http_router_t* router) {
+    if (router) {
+        memset(router, 0, sizeof(http_router_t));
+    }
+}
+
+void http_router_free(http_router_t* router) {
+    if (!router) return;
+
+    for (size_t i = 0; i < HTTP_ROUTER_METHOD_COUNT; i++) {
+        node_free(router->roots[i]);
+    }
+    for (size_t i = 0; i < router->glob_count; i++) {
+        free(router->globs[i].pattern);
+    }
+    free(router->globs);
+    memset(router, 0, sizeof(http_router_t));
+}
+
+static http_router_glob_t* find_glob(const http_router_t* router, http_method_t method,
+                                     const char* pattern) {
+    for (size_t i = 0; i < router->glob_count; i++) {
+        if (router->globs[i].method == method && strcmp(router->globs[i].pattern, pattern) == 0) {
+            return &router->globs[i];
+        }
+    }
+    return NULL;
+}
+
+bool http_router_insert(http_router_t* router, http_method_t method, const char* pattern,
+                        void* value, void** replaced) {
+    if (!router || !pattern || (unsigned)method >= HTTP_ROUTER_METHOD_COUNT) return false;
+    if (replaced) *replaced = NULL;
+
+    size_t param_count = 0;
+    if (!is_tree_pattern(pattern, &param_count)) {
+        http_router_glob_t* glob = find_glob(router, method, pattern);
+        if (glob) {
+            if (replaced) *replaced = glob->value;
+            glob->value = value;
+            return true;
+        }
+        if (router->glob_count == router->glob_capacity) {
+            size_t capacity = router->glob_capacity ? router->glob_capacity * 2 : 4;
+            http_router_glob_t* globs = realloc(router->globs, capacity * sizeof(*globs));
+            if (!globs) return false;
+            router->globs = globs;
+            router->glob_capacity = capacity;
+        }
+        char* copy = http_strdup(pattern);
+        if (!copy) return false;
+        router->globs[router->glob_count].method = method;
+        router->globs[router->glob_count].pattern = copy;
+        router->globs[router->glob_count].value = value;
+        router->glob_count++;
+        router->route_count++;
+        return true;
+    }
+
+    if (param_count > HTTP_ROUTER_MAX_PARAMS) {
+        http_set_error("Route %s has more than %d parameters", pattern, HTTP_ROUTER_MAX_PARAMS);
+        return false;
+    }
+
+    if (!router->roots[method]) {
+        router->roots[method] = node_create("", 0);
+        if (!router->roots[method]) return false;
+    }
+
+    bool conflict = false;
+    http_router_node_t* node = node_walk(router->roots[method], pattern, true, &conflict);
+    if (!node) {
+        if (conflict) {
+            http_set_error("Route %s names a parameter differently from another route", pattern);
+        }
+        return false;
+    }
+
+    if (node->has_value) {
+        if (replaced) *replaced = node->value;
+    } else {
+        router->route_count++;
+    }
+    node->has_value = true;
+    node->value = value;
+    return true;
+}
+
+bool http_router_remove(http_router_t* router, http_method_t method, const char* pattern,
+                        void** removed) {
+    if (!router || !pattern || (unsigned)method >= HTTP_ROUTER_METHOD_COUNT) return false;
+
+    http_router_glob_t* glob = find_glob(router, method, pattern);
+    if (glob) {
+        if (removed) *removed = glob->value;
+        free(glob->pattern);
+        size_t index = (size_t)(glob - router->globs);
+        memmove(glob, glob + 1, (router->glob_count - index - 1) * sizeof(*glob));
+        router->glob_count--;
+        router->route_count--;
+        return true;
+    }
+
+    // Emptied nodes stay in the tree; they only cost a little memory
+    bool conflict = false;
+    http_router_node_t* node = router->roots[method]
+        ? node_walk(router->roots[method], pattern, false, &conflict)
+        : NULL;
+    if (!node || !node->has_value) return false;
+
+    if (removed) *removed = node->value;
+    node->has_value = false;
+    node->value = NULL;
+    router->route_count--;
+    return true;
+}
+
+bool http_router_match(const http_router_t* router, http_method_t method, const char* path,
+                       size_t path_length, http_route_match_t* match) {
+    if (!router || !path || !match || (unsigned)method >= HTTP_ROUTER_METHOD_COUNT) return false;
+
+    match->value = NULL;
+    match->param_count = 0;
+    if (router->roots[method] && node_match(router->roots[method], path, path_length, match)) {
+        return true;
+    }
+
+    if (router->glob_count > 0 && path_length < HTTP_MAX_PATH_LENGTH) {
+        char terminated[HTTP_MAX_PATH_LENGTH];
+        memcpy(terminated, path, path_length);
+        terminated[path_length] = '\0';
+        // Most recently added first
+        for (size_t i = router->glob_count; i-- > 0;) {
+            if (router->globs[i].method == method &&
+                http_path_matches_pattern(terminated, router->globs[i].pattern)) {
+                match->value = router->globs[i].value;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+const http_route_param_t* http_route_match_param(const http_route_match_t* match,
+                                                 const char* name) {
+    if (!match || !name) return NULL;
+
+    size_t length = strlen(name);
+    for (size_t i = 0; i < match->param_count; i++) {
+        if (match->params[i].name_length == length &&
+            memcmp(match->params[i].name, name, length) == 0) {
+            return &match->params[i];
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "http_utils.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Radix-tree router
+//
+// Each method has its own compressed radix tree, so a lookup costs the
+// length of the path rather than the number of routes. Patterns are made of
+// static text and whole segments of two kinds, name being letters, digits
+// and '_':
+//   :name   matches one path segment (up to the next '/')
+//   *name   matches the rest of the path, and must be the last segment; the
+//           name may be empty
+// Static text wins over a parameter, and a parameter over a wildcard, with
+// backtracking when a more specific branch leads nowhere. Patterns that use
+// '*' as a glob inside a segment ("/files/*.txt") cannot live in the tree and
+// are kept in a list matched with http_path_matches_pattern after a tree miss.
+
+#define HTTP_ROUTER_MAX_PARAMS 8
+#define HTTP_ROUTER_METHOD_COUNT 7  // HTTP_GET .. HTTP_OPTIONS
+
+// A parameter bound by a match; name points into the router, value into the
+// matched path, neither is NUL terminated
+typedef struct {
+    const char* name;
+    size_t name_length;
+    const char* value;
+    size_t value_length;
+} http_route_param_t;
+
+typedef struct {
+    void* value;  // What the matching route was inserted with
+    size_t param_count;
+    http_route_param_t params[HTTP_ROUTER_MAX_PARAMS];
+} http_route_match_t;
+
+typedef struct http_router_node http_router_node_t;
+
+// Pattern the tree cannot hold
+typedef struct {
+    http_method_t method;
+    char* pattern;
+    void* value;
+} http_router_glob_t;
+
+typedef struct {
+    http_router_node_t* roots[HTTP_ROUTER_METHOD_COUNT];
+    http_router_glob_t* globs;
+    size_t glob_count;
+    size_t glob_capacity;
+    size_t route_count;
+} http_router_t;
+
+// Initialize an empty router
+void http_router_init(http_router_t* router);
+
+// Free all nodes; the values are the caller's
+void http_router_free(http_router_t* router);
+
+// Add a route; a route already on method and pattern has its value replaced
+// and the old one returned in replaced (NULL otherwise). Fails on a parameter
+// name that conflicts with another route's at the same position, or more
+// than HTTP_ROUTER_MAX_PARAMS parameters.
+bool http_router_insert(http_router_t* router, http_method_t method, const char* pattern,
+                        void* value, void** replaced);
+
+// Remove a route, returning its value in removed
+bool http_router_remove(http_router_t* router, http_method_t method, const char* pattern,
+                        void** removed);
+
+// Find the route for a path; false when none matches
+bool http_router_match(const http_router_t* router, http_method_t method, const char* path,
+                       size_t path_length, http_route_match_t* match);
+
+// Look up a bound parameter by name
+const http_route_param_t* http_route_match_param(const http_route_match_t* match,
+                                                 const char* name);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,169 @@
+// Host tests for the HTTP service: static file handling and request parsing.
+
+#include "../src/asset_cache.h"
+#include "../src/http_service.h"
+#include "../src/http_utils.h"
+#include "../src/request_parser.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "ASSERTION FAILED: %s at %s:%d\n", #condition, __FILE__, __LINE__); \
+        exit(1); \
+    } \
+} while (0)
+
+#define ASSERT_STR_EQ(expected, actual) ASSERT_TRUE((actual) && strcmp((expected), (actual)) == 0)
+
+static void write_file(const char* dir, const char* name, const char* content) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "wb");
+    ASSERT_TRUE(file != NULL);
+    ASSERT_TRUE(fwrite(content, 1, strlen(content), file) == strlen(content));
+    fclose(file);
+}
+
+static void remove_file(const char* dir, const char* name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    unlink(path);
+}
+
+// GET path with up to two headers (NULL name: none)
+static request_result_t get(http_service_t* service, const char* path,
+                            const char* name1, const char* value1,
+                            const char* name2, const char* value2) {
+    http_header_t headers[2];
+    size_t count = 0;
+    if (name1) headers[count++] = (http_header_t){(char*)name1, (char*)value1};
+    if (name2) headers[count++] = (http_header_t){(char*)name2, (char*)value2};
+
+    http_request_t request = {0};
+    request.method = HTTP_GET;
+    request.path = (char*)path;
+    request.headers = headers;
+    request.header_count = count;
+    return http_service_handle_static_file(service, &request, path);
+}
+
+static const char* response_header(const request_result_t* result, const char* name) {
+    http_header_t* header = http_find_header(result->response.headers,
+                                             result->response.header_count, name);
+    return header ? header->value : NULL;
+}
+
+// Each content-coding has its own strong ETag; a 304 carries the ETag of
+// the variant the request negotiates
+static void test_variant_etags(http_service_t* service) {
+    request_result_t gzip = get(service, "/app.css", "Accept-Encoding", "gzip", NULL, NULL);
+    ASSERT_TRUE(gzip.success && gzip.response.status == HTTP_STATUS_OK);
+    ASSERT_STR_EQ("gzip", response_header(&gzip, "Content-Encoding"));
+    const char* gzip_etag = response_header(&gzip, "ETag");
+    ASSERT_TRUE(gzip_etag && strstr(gzip_etag, "-gz\"") != NULL);
+
+    request_result_t identity = get(service, "/app.css", NULL, NULL, NULL, NULL);
+    ASSERT_TRUE(identity.success && identity.response.status == HTTP_STATUS_OK);
+    ASSERT_TRUE(response_header(&identity, "Content-Encoding") == NULL);
+    const char* identity_etag = response_header(&identity, "ETag");
+    ASSERT_TRUE(identity_etag && strcmp(identity_etag, gzip_etag) != 0);
+
+    // Revalidating the gzip copy
+    request_result_t revalidated = get(service, "/app.css", "Accept-Encoding", "gzip",
+                                       "If-None-Match", gzip_etag);
+    ASSERT_TRUE(revalidated.success && revalidated.response.status == HTTP_STATUS_NOT_MODIFIED);
+    ASSERT_TRUE(revalidated.response.body_size == 0);
+    ASSERT_STR_EQ(gzip_etag, response_header(&revalidated, "ETag"));
+
+    // Same validator from a client now negotiating identity: the 304 names
+    // the identity variant, so a cache does not reuse its gzip bytes
+    request_result_t switched = get(service, "/app.css", "If-None-Match", gzip_etag, NULL, NULL);
+    ASSERT_TRUE(switched.success && switched.response.status == HTTP_STATUS_NOT_MODIFIED);
+    ASSERT_STR_EQ(identity_etag, response_header(&switched, "ETag"));
+
+    // Brotli preferred when smaller and accepted
+    request_result_t brotli = get(service, "/app.css", "Accept-Encoding", "gzip, br", NULL, NULL);
+    ASSERT_TRUE(brotli.success && brotli.response.status == HTTP_STATUS_OK);
+    ASSERT_STR_EQ("br", response_header(&brotli, "Content-Encoding"));
+    const char* brotli_etag = response_header(&brotli, "ETag");
+    ASSERT_TRUE(brotli_etag && strstr(brotli_etag, "-br\"") != NULL);
+
+    // A prefix of another variant's ETag does not match
+    request_result_t other = get(service, "/app.css", "If-None-Match", "\"0123456789abcdef-gz\"",
+                                 NULL, NULL);
+    ASSERT_TRUE(other.success && other.response.status == HTTP_STATUS_OK);
+
+    http_free_response(&gzip.response);
+    http_free_response(&identity.response);
+    http_free_response(&revalidated.response);
+    http_free_response(&switched.response);
+    http_free_response(&brotli.response);
+    http_free_response(&other.response);
+}
+
+// View-mode parse of a complete input; returns http_parser_parse's result
+static int parse_view(http_parser_t* parser, const char* input) {
+    http_parser_reset(parser);
+    return http_parser_parse(parser, input, strlen(input));
+}
+
+// Content-Length fields that disagree are rejected, so no body end is
+// guessed; identical repeats frame the body as one field would
+static void test_view_duplicate_content_length(void) {
+    http_parser_t* parser = http_parser_create(16 * 1024, 1024 * 1024);
+    ASSERT_TRUE(parser != NULL);
+    ASSERT_TRUE(http_parser_set_mode(parser, HTTP_PARSER_MODE_VIEWS));
+
+    const char* conflicting =
+        "POST /upload HTTP/1.1\r\n"
+        "Content-Length: 5\r\n"
+        "Host: example.com\r\n"
+        "Content-Length: 50\r\n"
+        "\r\n"
+        "helloGET /admin HTTP/1.1\r\n\r\n";
+    ASSERT_TRUE(parse_view(parser, conflicting) == -1);
+    ASSERT_STR_EQ("Invalid Content-Length", http_parser_get_error(parser));
+
+    const char* identical =
+        "POST /upload HTTP/1.1\r\n"
+        "Content-Length: 5\r\n"
+        "content-length: 5\r\n"
+        "\r\n"
+        "helloGET / HTTP/1.1\r\n\r\n";
+    ASSERT_TRUE(parse_view(parser, identical) == 1);
+    const http_request_view_t* view = http_parser_get_view(parser);
+    ASSERT_TRUE(view->body.length == 5);
+    ASSERT_TRUE(memcmp(identical + view->body.offset, "hello", 5) == 0);
+    ASSERT_TRUE(http_parser_consumed(parser) == strlen(identical) - strlen("GET / HTTP/1.1\r\n\r\n"));
+
+    http_parser_free(parser);
+}
+
+int main(void) {
+    char dir[] = "/tmp/http_service_test_XXXXXX";
+    ASSERT_TRUE(mkdtemp(dir) != NULL);
+    write_file(dir, "app.css", "body { color: #333; margin: 0; padding: 0; font-family: sans-serif; }\n");
+    write_file(dir, "app.css.gz", "gzip bytes of app.css");
+    write_file(dir, "app.css.br", "br bytes");
+
+    http_service_t* service = http_service_create("test", "1.0.0");
+    ASSERT_TRUE(service != NULL);
+    ASSERT_TRUE(http_service_enable_static_files(service, dir));
+
+    printf("Running static file tests...\n");
+    test_variant_etags(service);
+    printf("Running view parser tests...\n");
+    test_view_duplicate_content_length();
+    printf("All tests passed!\n");
+
+    http_service_free(service);
+    remove_file(dir, "app.css");
+    remove_file(dir, "app.css.gz");
+    remove_file(dir, "app.css.br");
+    rmdir(dir);
+    return 0;
+}
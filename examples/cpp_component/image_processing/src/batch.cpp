@@ -0,0 +1,414 @@
+#include "batch.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+namespace batch {
+
+using color_space::ColorFormat;
+using color_space::ColorSpaceConverter;
+using filters::FilterParams;
+using filters::FilterType;
+
+namespace {
+
+struct FilterName {
+    const char* name;
+    FilterType type;
+};
+
+// The WIT filter-type names, plus the filters only FilterProcessor has
+constexpr FilterName FILTER_NAMES[] = {
+    {"box-blur", FilterType::BOX_BLUR},
+    {"gaussian-blur", FilterType::GAUSSIAN_BLUR},
+    {"motion-blur", FilterType::MOTION_BLUR},
+    {"sharpen", FilterType::SHARPEN},
+    {"edge-detect", FilterType::EDGE_DETECT},
+    {"emboss", FilterType::EMBOSS},
+    {"sobel-x", FilterType::SOBEL_X},
+    {"sobel-y", FilterType::SOBEL_Y},
+    {"laplacian", FilterType::LAPLACIAN},
+    {"unsharp-mask", FilterType::UNSHARP_MASK},
+    {"noise-reduction", FilterType::NOISE_REDUCTION},
+    {"bilateral", FilterType::BILATERAL},
+    {"median", FilterType::MEDIAN},
+    {"kuwahara", FilterType::KUWAHARA},
+    {"oil-painting", FilterType::OIL_PAINTING},
+};
+
+std::string trim(const std::string& s, size_t begin, size_t end) {
+    while (begin < end && std::isspace(static_cast<unsigned char>(s[begin]))) {
+        begin++;
+    }
+    while (end > begin && std::isspace(static_cast<unsigned char>(s[end - 1]))) {
+        end--;
+    }
+    return s.substr(begin, end - begin);
+}
+
+// s split at sep, each part trimmed; "" gives no parts
+std::vector<std::string> split(const std::string& s, char sep) {
+    std::vector<std::string> parts;
+    if (trim(s, 0, s.size()).empty()) {
+        return parts;
+    }
+    size_t begin = 0;
+    for (;;) {
+        size_t end = s.find(sep, begin);
+        parts.push_back(trim(s, begin, end == std::string::npos ? s.size() : end));
+        if (end == std::string::npos) {
+            return parts;
+        }
+        begin = end + 1;
+    }
+}
+
+bool parse_number(const std::string& text, float& value) {
+    char* end = nullptr;
+    value = std::strtof(text.c_str(), &end);
+    return !text.empty() && end == text.c_str() + text.size() && std::isfinite(value);
+}
+
+bool apply_param(const std::string& key, float value, FilterParams& params) {
+    if (key == "radius") {
+        params.radius = value;
+    } else if (key == "strength") {
+        params.strength = value;
+    } else if (key == "angle") {
+        params.angle = value;
+    } else if (key == "threshold") {
+        params.threshold = value;
+    } else if (key == "sigma") {
+        params.sigma = value;
+    } else if (key == "kernel-size") {
+        params.kernel_size = static_cast<int>(value);
+    } else if (key == "grid") {
+        params.bilateral_grid = value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Formats the filters work on directly; the others go through RGB
+bool is_filterable(ColorFormat format) {
+    switch (format) {
+        case ColorFormat::RGB:
+        case ColorFormat::RGBA:
+        case ColorFormat::BGR:
+        case ColorFormat::BGRA:
+        case ColorFormat::GRAYSCALE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+ItemResult failed_item(const char* message) {
+    ItemResult item{};
+    item.success = false;
+    item.error_message = message;
+    return item;
+}
+
+} // namespace
+
+// Per-thread state for one operation
+struct BatchEngine::Lane {
+    filters::FilterChain chain;
+    ColorSpaceConverter converter;
+    simd_utils::PoolArray<uint8_t> gathered;  // Pixels of a strided view
+};
+
+struct BatchEngine::Operation {
+    std::string key;
+    std::vector<FilterParams> steps;
+    std::vector<std::unique_ptr<Lane>> lanes;
+
+    // False when out of memory for a lane
+    bool reserve_lanes(size_t count) {
+        while (lanes.size() < count) {
+            std::unique_ptr<Lane> lane(new (std::nothrow) Lane);
+            if (!lane) {
+                return false;
+            }
+            for (const FilterParams& step : steps) {
+                lane->chain.add_filter(step.type, step);
+            }
+            lanes.push_back(std::move(lane));
+        }
+        return true;
+    }
+};
+
+BatchEngine::BatchEngine() : use_simd_(SIMD_SUPPORTED != 0), thread_count_(0) {}
+
+BatchEngine::~BatchEngine() = default;
+
+BatchEngine& BatchEngine::shared() {
+    static BatchEngine engine;
+    return engine;
+}
+
+unsigned BatchEngine::thread_count() const {
+    return thread_count_ > 0 ? std::min(thread_count_, worker_pool::WorkerPool::MAX_THREADS)
+                             : worker_pool::WorkerPool::default_thread_count();
+}
+
+void BatchEngine::enable_simd(bool enable) {
+    use_simd_ = enable;
+}
+
+void BatchEngine::clear() {
+    operations_.clear();
+}
+
+bool BatchEngine::parse(const std::string& operation, const std::string& params,
+                        std::vector<FilterParams>& steps, std::string& error) {
+    steps.clear();
+    std::vector<std::string> names = split(operation, '|');
+    std::vector<std::string> groups = split(params, '|');
+    if (names.empty()) {
+        error = "Empty operation";
+        return false;
+    }
+    if (groups.size() > names.size()) {
+        error = "More parameter groups than operation steps";
+        return false;
+    }
+
+    for (size_t i = 0; i < names.size(); i++) {
+        const FilterName* found = nullptr;
+        for (const FilterName& entry : FILTER_NAMES) {
+            if (names[i] == entry.name) {
+                found = &entry;
+            }
+        }
+        if (!found) {
+            error = "Unknown operation: " + names[i];
+            return false;
+        }
+
+        FilterParams step;
+        step.type = found->type;
+        for (const std::string& pair : i < groups.size() ? split(groups[i], ',') : std::vector<std::string>()) {
+            size_t eq = pair.find('=');
+            float value = 0.0f;
+            if (eq == std::string::npos || !parse_number(trim(pair, eq + 1, pair.size()), value) ||
+                !apply_param(trim(pair, 0, eq), value, step)) {
+                error = "Bad parameter for " + names[i] + ": " + pair;
+                return false;
+            }
+        }
+        steps.push_back(step);
+    }
+    return true;
+}
+
+BatchEngine::Operation* BatchEngine::compile(const std::string& operation, const std::string& params,
+                                             std::string& error) {
+    std::string key = operation;
+    key += '\0';
+    key += params;
+    for (size_t i = 0; i < operations_.size(); i++) {
+        if (operations_[i]->key == key) {
+            std::rotate(operations_.begin(), operations_.begin() + i, operations_.begin() + i + 1);
+            return operations_.front().get();
+        }
+    }
+
+    std::unique_ptr<Operation> op(new (std::nothrow) Operation);
+    if (!op) {
+        error = "Out of memory";
+        return nullptr;
+    }
+    if (!parse(operation, params, op->steps, error)) {
+        return nullptr;
+    }
+    op->key = std::move(key);
+    if (operations_.size() >= CAPACITY) {
+        operations_.pop_back();
+    }
+    operations_.insert(operations_.begin(), std::move(op));
+    return operations_.front().get();
+}
+
+void BatchEngine::run_image(Lane& lane, const image_store::Image* image, ItemResult& out) {
+    if (!image || !image->valid()) {
+        out = failed_item("Invalid image");
+        return;
+    }
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    const uint32_t width = image->width();
+    const uint32_t height = image->height();
+    const ColorFormat format = image->format();
+    const size_t pixels = static_cast<size_t>(width) * height;
+
+    // Input: the pixels as one contiguous plane, in a format the filters take
+    const uint8_t* src = image->data();
+    if (!image->is_contiguous()) {
+        size_t bytes = image->size_bytes();
+        if (!lane.gathered.resize(bytes) || !image->read_pixels(image->bounds(), lane.gathered.data(), bytes)) {
+            out = failed_item("Out of memory for input");
+            return;
+        }
+        src = lane.gathered.data();
+    }
+    color_space::ConversionResult rgb;
+    int channels = ColorSpaceConverter::get_channels_per_pixel(format);
+    if (!is_filterable(format)) {
+        rgb = lane.converter.convert(src, width, height, format, ColorFormat::RGB);
+        if (!rgb.success) {
+            out = failed_item("Unsupported input format");
+            return;
+        }
+        src = rgb.data.data();
+        channels = 3;
+    }
+
+    filters::FilterResult filtered = lane.chain.apply_chain(src, width, height, channels);
+    if (!filtered.success) {
+        out = failed_item(filtered.error_message.c_str());
+        return;
+    }
+
+    // Output: back to the input format, into a new image
+    const uint8_t* result = filtered.data.data();
+    size_t result_size = filtered.data.size();
+    color_space::ConversionResult converted;
+    if (!is_filterable(format)) {
+        converted = lane.converter.convert(result, width, height, ColorFormat::RGB, format);
+        if (!converted.success) {
+            out = failed_item("Unsupported output format");
+            return;
+        }
+        result = converted.data.data();
+        result_size = converted.data.size();
+    }
+    if (!out.image.create_from(result, result_size, width, height, format)) {
+        out = failed_item("Out of memory for output");
+        return;
+    }
+
+    timer.stop();
+    out.success = true;
+    out.processing_time_ms = timer.elapsed_ms();
+    out.megapixels_per_second = timer.megapixels_per_second(pixels);
+}
+
+BatchResult BatchEngine::process(const image_store::Image* const* images, size_t count,
+                                 const std::string& operation, const std::string& params) {
+    return run_batch(images, count, operation, params, true);
+}
+
+BatchResult BatchEngine::run_batch(const image_store::Image* const* images, size_t count,
+                                   const std::string& operation, const std::string& params, bool keep_outputs) {
+    BatchResult result{};
+    result.simd_used = use_simd_ && SIMD_SUPPORTED;
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    Operation* op = compile(operation, params, result.error_message);
+    if (!op) {
+        result.success = false;
+        result.items.resize(count, failed_item(result.error_message.c_str()));
+        return result;
+    }
+    result.success = true;
+    result.items.resize(count);
+    if (count == 0) {
+        return result;
+    }
+
+    // Lanes across images, unless the images are large enough to keep every
+    // thread busy one at a time
+    uint64_t total_pixels = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (images[i] && images[i]->valid()) {
+            total_pixels += static_cast<uint64_t>(images[i]->width()) * images[i]->height();
+        }
+    }
+    const unsigned threads = thread_count();
+    const bool banded = total_pixels / count >= LARGE_IMAGE_PIXELS;
+    size_t lanes = banded ? 1 : std::min<size_t>(threads, count);
+    if (!op->reserve_lanes(lanes)) {
+        lanes = std::max<size_t>(op->lanes.size(), 1);
+        if (op->lanes.empty() && !op->reserve_lanes(1)) {
+            result.success = false;
+            result.error_message = "Out of memory";
+            std::fill(result.items.begin(), result.items.end(), failed_item("Out of memory"));
+            return result;
+        }
+    }
+    for (size_t l = 0; l < lanes; l++) {
+        Lane& lane = *op->lanes[l];
+        lane.chain.enable_simd(use_simd_);
+        lane.chain.enable_multithreading(banded);
+        lane.chain.set_thread_count(threads);
+        lane.converter.enable_simd(use_simd_);
+        lane.converter.enable_multithreading(banded);
+        lane.converter.set_thread_count(threads);
+    }
+
+    // One chunk per lane; each lane takes the next unclaimed image until none is left
+    std::atomic<size_t> next_image(0);
+    worker_pool::WorkerPool::shared().parallel_for(
+        lanes, 1, static_cast<unsigned>(lanes), [&](size_t begin, size_t end) {
+            for (size_t l = begin; l < end; l++) {
+                for (size_t i = next_image.fetch_add(1); i < count; i = next_image.fetch_add(1)) {
+                    run_image(*op->lanes[l], images[i], result.items[i]);
+                    if (!keep_outputs) {
+                        result.items[i].image.release();
+                    }
+                }
+            }
+        });
+
+    timer.stop();
+    for (size_t i = 0; i < count; i++) {
+        if (result.items[i].success) {
+            result.pixels_processed += static_cast<uint64_t>(images[i]->width()) * images[i]->height();
+        }
+    }
+    result.lanes = static_cast<unsigned>(lanes);
+    result.elapsed_ms = timer.elapsed_ms();
+    result.megapixels_per_second = timer.megapixels_per_second(static_cast<size_t>(result.pixels_processed));
+    return result;
+}
+
+BatchResult BatchEngine::benchmark(const std::string& operation, const std::string& params,
+                                   uint32_t image_size, uint32_t iterations) {
+    // A smooth gradient with a checkerboard, so edge filters have work too
+    image_store::Image source;
+    if (image_size == 0 || iterations == 0 || !source.create(image_size, image_size, ColorFormat::RGB)) {
+        BatchResult result{};
+        result.success = false;
+        result.error_message = image_size == 0 || iterations == 0 ? "Invalid benchmark size" : "Out of memory";
+        return result;
+    }
+    uint8_t* pixels = source.mutable_data();
+    for (uint32_t y = 0; y < image_size; y++) {
+        uint8_t* row = pixels + static_cast<size_t>(y) * source.stride();
+        for (uint32_t x = 0; x < image_size; x++) {
+            uint8_t check = ((x >> 3) ^ (y >> 3)) & 1 ? 64 : 0;
+            row[x * 3 + 0] = static_cast<uint8_t>((x * 255 / image_size) ^ check);
+            row[x * 3 + 1] = static_cast<uint8_t>((y * 255 / image_size) ^ check);
+            row[x * 3 + 2] = static_cast<uint8_t>(((x + y) * 127 / image_size) ^ check);
+        }
+    }
+
+    // Handles share the pixels, as clones from the host would. Outputs are
+    // made and then dropped, so memory stays at one image per lane.
+    std::vector<const image_store::Image*> batch(iterations, &source);
+    return run_batch(batch.data(), batch.size(), operation, params, false);
+}
+
+} // namespace batch
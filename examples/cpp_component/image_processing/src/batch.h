@@ -0,0 +1,106 @@
+#pragma once
+
+#include "color_space.h"
+#include "filters.h"
+#include "image_store.h"
+#include "simd_utils.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace batch {
+
+/**
+ * Batch engine behind the process-batch and benchmark-operation exports
+ *
+ * An operation string names filter steps separated by '|' ("gaussian-blur|
+ * sharpen"); the params string holds one group of comma-separated key=value
+ * pairs per step, also separated by '|' ("radius=3,sigma=1.5|strength=0.8").
+ * Missing groups and keys keep the FilterParams defaults. Keys are radius,
+ * strength, angle, threshold, sigma, kernel-size and grid (bilateral grid).
+ *
+ * Each operation is parsed and compiled into a FilterChain once and kept for
+ * later calls. Images are pulled from a shared counter by lanes, one thread
+ * each, which take an image through input (crop views gathered, non-RGB
+ * formats converted), the chain and output in turn, so while one lane
+ * filters another converts or writes out; a lane has its own chain and
+ * converter, kept warm between calls. Batches of large images instead run
+ * one image at a time with the chain's own row bands on every thread.
+ *
+ * Not thread safe: one engine per caller.
+ */
+
+// One image's outcome, in input order
+struct ItemResult {
+    bool success;
+    image_store::Image image;  // New handle to the output
+    std::string error_message;
+    double processing_time_ms;
+    double megapixels_per_second;
+};
+
+struct BatchResult {
+    bool success;               // False when the operation did not compile
+    std::string error_message;
+    std::vector<ItemResult> items;
+    uint64_t pixels_processed;  // Over the images that succeeded
+    double elapsed_ms;          // Wall time of the whole batch
+    double megapixels_per_second;
+    unsigned lanes;             // Images in flight at once
+    bool simd_used;
+};
+
+class BatchEngine {
+public:
+    static constexpr size_t CAPACITY = 8;  // Compiled operations kept
+    // Average image size from which images run one at a time
+    static constexpr size_t LARGE_IMAGE_PIXELS = size_t(2) << 20;
+
+    BatchEngine();
+    ~BatchEngine();
+    BatchEngine(const BatchEngine&) = delete;
+    BatchEngine& operator=(const BatchEngine&) = delete;
+
+    // images holds count handles, each read only; null entries fail alone
+    BatchResult process(const image_store::Image* const* images, size_t count, const std::string& operation,
+                        const std::string& params);
+
+    // Runs process()'s path on iterations handles of one image_size x
+    // image_size RGB test image, so it measures production throughput; the
+    // items carry timings but no images
+    BatchResult benchmark(const std::string& operation, const std::string& params, uint32_t image_size,
+                          uint32_t iterations);
+
+    // Parses operation and params into chain steps; false with a message
+    static bool parse(const std::string& operation, const std::string& params,
+                      std::vector<filters::FilterParams>& steps, std::string& error);
+
+    void enable_simd(bool enable);
+    bool is_simd_enabled() const { return use_simd_; }
+
+    // Threads per batch, caller included; 0 means one per hardware thread
+    void set_thread_count(unsigned threads) { thread_count_ = threads; }
+    unsigned thread_count() const;
+
+    // Drops every compiled operation and its lanes
+    void clear();
+
+    static BatchEngine& shared();
+
+private:
+    struct Lane;
+    struct Operation;
+
+    BatchResult run_batch(const image_store::Image* const* images, size_t count, const std::string& operation,
+                          const std::string& params, bool keep_outputs);
+    Operation* compile(const std::string& operation, const std::string& params, std::string& error);
+    static void run_image(Lane& lane, const image_store::Image* image, ItemResult& out);
+
+    std::vector<std::unique_ptr<Operation>> operations_;  // Most recently used first
+    bool use_simd_;
+    unsigned thread_count_;
+};
+
+} // namespace batch
@@ -0,0 +1,1289 @@
+#include "color_space.h"
+#include "worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace color_space {
+
+namespace {
+
+// Pixels per band below which splitting costs more than it saves
+constexpr size_t MIN_PIXELS_PER_BAND = 16384;
+
+// Hue is stored as 256 steps per turn, so 255 wraps back to red
+constexpr float HUE_STEPS = 256.0f;
+
+inline uint8_t clamp_u8(int v) {
+    return static_cast<uint8_t>(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+inline uint8_t unit_to_u8(float v) {
+    return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, v * 255.0f)) + 0.5f);
+}
+
+inline uint8_t hue_to_u8(float degrees) {
+    return static_cast<uint8_t>(static_cast<int>(std::lround(degrees * HUE_STEPS / 360.0f)) & 255);
+}
+
+// Hue in degrees of an RGB triple in [0, 1]; 0 for grays
+inline float hue_degrees(float r, float g, float b, float max, float delta) {
+    if (delta <= 0.0f) {
+        return 0.0f;
+    }
+    float h;
+    if (max == r) {
+        h = 60.0f * std::fmod((g - b) / delta, 6.0f);
+    } else if (max == g) {
+        h = 60.0f * ((b - r) / delta + 2.0f);
+    } else {
+        h = 60.0f * ((r - g) / delta + 4.0f);
+    }
+    return h < 0.0f ? h + 360.0f : h;
+}
+
+// RGB from hue, chroma and the offset added to every channel
+inline void chroma_to_rgb(uint8_t hue, float chroma, float offset, uint8_t& r, uint8_t& g, uint8_t& b) {
+    float sector = hue * (6.0f / HUE_STEPS);
+    float x = chroma * (1.0f - std::fabs(std::fmod(sector, 2.0f) - 1.0f));
+    float rf = 0.0f, gf = 0.0f, bf = 0.0f;
+    switch (static_cast<int>(sector)) {
+        case 0: rf = chroma; gf = x; break;
+        case 1: rf = x; gf = chroma; break;
+        case 2: gf = chroma; bf = x; break;
+        case 3: gf = x; bf = chroma; break;
+        case 4: rf = x; bf = chroma; break;
+        default: rf = chroma; bf = x; break;
+    }
+    r = unit_to_u8(rf + offset);
+    g = unit_to_u8(gf + offset);
+    b = unit_to_u8(bf + offset);
+}
+
+// BT.601 full-range (JFIF) YCbCr in 8.8 fixed point; the offsets keep sums non-negative
+inline void rgb_to_yuv_pixel(int r, int g, int b, uint8_t& y, uint8_t& u, uint8_t& v) {
+    y = clamp_u8((77 * r + 150 * g + 29 * b + 128) >> 8);
+    u = clamp_u8((-43 * r - 85 * g + 128 * b + 32896) >> 8);
+    v = clamp_u8((128 * r - 107 * g - 21 * b + 32896) >> 8);
+}
+
+inline void yuv_to_rgb_pixel(int y, int u, int v, uint8_t* rgb) {
+    u -= 128;
+    v -= 128;
+    rgb[0] = clamp_u8(y + ((91881 * v + 32768) >> 16));
+    rgb[1] = clamp_u8(y - ((22554 * u + 46802 * v + 32768) >> 16));
+    rgb[2] = clamp_u8(y + ((116130 * u + 32768) >> 16));
+}
+
+inline uint8_t luma_709(int r, int g, int b) {
+    return static_cast<uint8_t>((54 * r + 183 * g + 19 * b) >> 8);
+}
+
+size_t chroma_size(uint32_t width, uint32_t height) {
+    return static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+}
+
+// Bytes for a whole image; YUV420 is three planes with quarter-size chroma
+size_t image_bytes(ColorFormat format, uint32_t width, uint32_t height) {
+    size_t pixels = static_cast<size_t>(width) * height;
+    if (format == ColorFormat::YUV420) {
+        return pixels + 2 * chroma_size(width, height);
+    }
+    return pixels * ColorSpaceConverter::get_bytes_per_pixel(format);
+}
+
+// Any format to packed RGB (alpha is dropped)
+bool to_rgb(ColorSpaceConverter& converter, const uint8_t* src, ColorFormat format,
+            uint8_t* rgb, uint32_t width, uint32_t height) {
+    size_t pixels = static_cast<size_t>(width) * height;
+    switch (format) {
+        case ColorFormat::RGB:
+            std::memcpy(rgb, src, pixels * 3);
+            return true;
+        case ColorFormat::RGBA:
+            return converter.rgba_to_rgb(src, rgb, pixels);
+        case ColorFormat::BGR:
+            return converter.rgb_to_bgr(src, rgb, pixels);
+        case ColorFormat::BGRA:
+            return converter.rgba_to_rgb(src, rgb, pixels) && converter.rgb_to_bgr(rgb, rgb, pixels);
+        case ColorFormat::GRAYSCALE:
+            return converter.grayscale_to_rgb(src, rgb, pixels);
+        case ColorFormat::HSV:
+            return converter.hsv_to_rgb(src, rgb, pixels);
+        case ColorFormat::HSL:
+            return converter.hsl_to_rgb(src, rgb, pixels);
+        case ColorFormat::YUV444:
+            return converter.yuv444_to_rgb(src, rgb, pixels);
+        case ColorFormat::YUV420: {
+            const size_t chroma = chroma_size(width, height);
+            return converter.yuv420_to_rgb(src, src + pixels, src + pixels + chroma, rgb, width, height);
+        }
+    }
+    return false;
+}
+
+// Packed RGB to any format (alpha is set opaque)
+bool from_rgb(ColorSpaceConverter& converter, const uint8_t* rgb, ColorFormat format,
+              uint8_t* dst, uint32_t width, uint32_t height) {
+    size_t pixels = static_cast<size_t>(width) * height;
+    switch (format) {
+        case ColorFormat::RGB:
+            std::memcpy(dst, rgb, pixels * 3);
+            return true;
+        case ColorFormat::RGBA:
+            return converter.rgb_to_rgba(rgb, dst, pixels);
+        case ColorFormat::BGR:
+            return converter.rgb_to_bgr(rgb, dst, pixels);
+        case ColorFormat::BGRA:
+            return converter.rgb_to_rgba(rgb, dst, pixels) && converter.rgba_to_bgra(dst, dst, pixels);
+        case ColorFormat::GRAYSCALE:
+            return converter.rgb_to_grayscale(rgb, dst, pixels);
+        case ColorFormat::HSV:
+            return converter.rgb_to_hsv(rgb, dst, pixels);
+        case ColorFormat::HSL:
+            return converter.rgb_to_hsl(rgb, dst, pixels);
+        case ColorFormat::YUV444:
+            return converter.rgb_to_yuv444(rgb, dst, pixels);
+        case ColorFormat::YUV420: {
+            const size_t chroma = chroma_size(width, height);
+            return converter.rgb_to_yuv420(rgb, dst, dst + pixels, dst + pixels + chroma, width, height);
+        }
+    }
+    return false;
+}
+
+// Pairs with a direct path that keeps alpha, which a detour through RGB would lose
+bool has_alpha_path(ColorFormat src_format, ColorFormat dst_format) {
+    switch (src_format) {
+        case ColorFormat::RGBA:
+            return dst_format == ColorFormat::BGRA || dst_format == ColorFormat::GRAYSCALE ||
+                   dst_format == ColorFormat::HSV;
+        case ColorFormat::BGRA:
+            return dst_format == ColorFormat::RGBA;
+        case ColorFormat::GRAYSCALE:
+        case ColorFormat::HSV:
+            return dst_format == ColorFormat::RGBA;
+        default:
+            return false;
+    }
+}
+
+bool convert_with_alpha(ColorSpaceConverter& converter, const uint8_t* src, ColorFormat src_format,
+                        uint8_t* dst, ColorFormat dst_format, size_t pixels) {
+    if ((src_format == ColorFormat::RGBA && dst_format == ColorFormat::BGRA) ||
+        (src_format == ColorFormat::BGRA && dst_format == ColorFormat::RGBA)) {
+        return converter.rgba_to_bgra(src, dst, pixels);
+    }
+    if (src_format == ColorFormat::RGBA && dst_format == ColorFormat::GRAYSCALE) {
+        return converter.rgba_to_grayscale(src, dst, pixels);
+    }
+    if (src_format == ColorFormat::GRAYSCALE && dst_format == ColorFormat::RGBA) {
+        return converter.grayscale_to_rgba(src, dst, pixels);
+    }
+    if (src_format == ColorFormat::RGBA && dst_format == ColorFormat::HSV) {
+        return converter.rgba_to_hsv(src, dst, pixels);
+    }
+    if (src_format == ColorFormat::HSV && dst_format == ColorFormat::RGBA) {
+        return converter.hsv_to_rgba(src, dst, pixels);
+    }
+    return false;
+}
+
+} // namespace
+
+ColorSpaceConverter::ColorSpaceConverter()
+    : use_simd_(SIMD_SUPPORTED != 0), use_multithreading_(false), thread_count_(0), stats_() {}
+
+ColorSpaceConverter::~ColorSpaceConverter() = default;
+
+void ColorSpaceConverter::update_stats(size_t pixel_count, double time_ms) {
+    stats_.total_conversions++;
+    stats_.total_pixels_processed += pixel_count;
+    stats_.total_time_ms += time_ms;
+    if (stats_.total_time_ms > 0.0) {
+        stats_.average_megapixels_per_second =
+            (stats_.total_pixels_processed / 1e6) / (stats_.total_time_ms / 1000.0);
+    }
+}
+
+bool ColorSpaceConverter::validate_inputs(const uint8_t* src, uint8_t* dst, size_t pixel_count,
+                                          ColorFormat /*src_format*/, ColorFormat /*dst_format*/) {
+    return src && dst && pixel_count > 0;
+}
+
+void ColorSpaceConverter::parallel_for(size_t count, size_t min_chunk,
+                                       const std::function<void(size_t, size_t)>& body) {
+    unsigned threads = 1;
+    if (use_multithreading_) {
+        threads = thread_count_ > 0 ? std::min(thread_count_, worker_pool::WorkerPool::MAX_THREADS)
+                                    : worker_pool::WorkerPool::default_thread_count();
+    }
+    worker_pool::WorkerPool::shared().parallel_for(count, min_chunk, threads, body);
+}
+
+ConversionResult ColorSpaceConverter::convert(const uint8_t* src_data, uint32_t width, uint32_t height,
+                                              ColorFormat src_format, ColorFormat dst_format) {
+    ConversionResult result{};
+    result.width = width;
+    result.height = height;
+    result.format = dst_format;
+
+    const size_t pixels = static_cast<size_t>(width) * height;
+    if (!src_data || pixels == 0 || pixels > SIZE_MAX / 8) {
+        result.success = false;
+        result.error_message = "Invalid image";
+        return result;
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    result.data.resize(image_bytes(dst_format, width, height));
+    uint8_t* dst = result.data.data();
+    if (src_format == dst_format) {
+        std::memcpy(dst, src_data, result.data.size());
+        result.success = true;
+    } else if (has_alpha_path(src_format, dst_format)) {
+        result.success = convert_with_alpha(*this, src_data, src_format, dst, dst_format, pixels);
+    } else if (src_format == ColorFormat::RGB) {
+        result.success = from_rgb(*this, src_data, dst_format, dst, width, height);
+    } else if (dst_format == ColorFormat::RGB) {
+        result.success = to_rgb(*this, src_data, src_format, dst, width, height);
+    } else {
+        simd_utils::PoolArray<uint8_t> rgb(pixels * 3);
+        result.success = !rgb.empty() && to_rgb(*this, src_data, src_format, rgb.data(), width, height) &&
+                         from_rgb(*this, rgb.data(), dst_format, dst, width, height);
+    }
+
+    timer.stop();
+    if (!result.success) {
+        result.data.clear();
+        result.error_message = "Unsupported conversion";
+        return result;
+    }
+    update_stats(pixels, timer.elapsed_ms());
+    return result;
+}
+
+// Analysis
+
+bool ColorSpaceConverter::calculate_histogram(const uint8_t* pixels, size_t pixel_count, int channels,
+                                              uint32_t bins, Histogram& histogram) {
+    if (!pixels || pixel_count == 0 || channels < 1 || channels > 4 || bins == 0) {
+        return false;
+    }
+
+    // Bands count into their own histograms and add them to the totals once;
+    // atomics rather than a lock, which builds without threads lack
+    const int planes = channels >= 3 ? channels + 1 : channels;  // Luma last
+    std::atomic<uint32_t> totals[5][256];
+    for (auto& plane : totals) {
+        for (auto& bin : plane) bin.store(0, std::memory_order_relaxed);
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [&](size_t begin, size_t end) {
+        uint32_t local[5][256] = {};
+        uint32_t* hist[4] = {local[0], local[1], local[2], local[3]};
+        simd_utils::simd_accumulate_histograms(pixels + begin * channels, end - begin, channels, hist,
+                                               channels >= 3 ? local[channels] : nullptr);
+        for (int p = 0; p < planes; ++p) {
+            for (int v = 0; v < 256; ++v) {
+                if (local[p][v]) totals[p][v].fetch_add(local[p][v], std::memory_order_relaxed);
+            }
+        }
+    });
+
+    auto fold = [&](int plane, std::vector<uint32_t>& out) {
+        uint32_t counts[256];
+        for (int v = 0; v < 256; ++v) counts[v] = totals[plane][v].load(std::memory_order_relaxed);
+        out.assign(bins, 0);
+        simd_utils::simd_fold_histogram(counts, bins, out.data());
+    };
+    histogram.bins = bins;
+    for (int c = 0; c < 4; ++c) {
+        histogram.channel[c].clear();
+        if (c < channels) fold(c, histogram.channel[c]);
+    }
+    fold(channels >= 3 ? channels : 0, histogram.luminance);
+    return true;
+}
+
+// RGB conversions
+
+bool ColorSpaceConverter::rgb_to_rgba(const uint8_t* rgb, uint8_t* rgba, size_t pixel_count, uint8_t alpha) {
+    if (!validate_inputs(rgb, rgba, pixel_count, ColorFormat::RGB, ColorFormat::RGBA)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rgba[i * 4 + 0] = rgb[i * 3 + 0];
+            rgba[i * 4 + 1] = rgb[i * 3 + 1];
+            rgba[i * 4 + 2] = rgb[i * 3 + 2];
+            rgba[i * 4 + 3] = alpha;
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::rgba_to_rgb(const uint8_t* rgba, uint8_t* rgb, size_t pixel_count) {
+    if (!validate_inputs(rgba, rgb, pixel_count, ColorFormat::RGBA, ColorFormat::RGB)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rgb[i * 3 + 0] = rgba[i * 4 + 0];
+            rgb[i * 3 + 1] = rgba[i * 4 + 1];
+            rgb[i * 3 + 2] = rgba[i * 4 + 2];
+        }
+    });
+    return true;
+}
+
+// Safe in place (rgb == bgr)
+bool ColorSpaceConverter::rgb_to_bgr(const uint8_t* rgb, uint8_t* bgr, size_t pixel_count) {
+    if (!validate_inputs(rgb, bgr, pixel_count, ColorFormat::RGB, ColorFormat::BGR)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint8_t r = rgb[i * 3 + 0];
+            uint8_t g = rgb[i * 3 + 1];
+            uint8_t b = rgb[i * 3 + 2];
+            bgr[i * 3 + 0] = b;
+            bgr[i * 3 + 1] = g;
+            bgr[i * 3 + 2] = r;
+        }
+    });
+    return true;
+}
+
+// Safe in place (rgba == bgra)
+bool ColorSpaceConverter::rgba_to_bgra(const uint8_t* rgba, uint8_t* bgra, size_t pixel_count) {
+    if (!validate_inputs(rgba, bgra, pixel_count, ColorFormat::RGBA, ColorFormat::BGRA)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            uint8_t r = rgba[i * 4 + 0];
+            uint8_t g = rgba[i * 4 + 1];
+            uint8_t b = rgba[i * 4 + 2];
+            bgra[i * 4 + 0] = b;
+            bgra[i * 4 + 1] = g;
+            bgra[i * 4 + 2] = r;
+            bgra[i * 4 + 3] = rgba[i * 4 + 3];
+        }
+    });
+    return true;
+}
+
+// Grayscale conversions (BT.709 luma, matching simd_rgb_to_grayscale)
+
+bool ColorSpaceConverter::rgb_to_grayscale(const uint8_t* rgb, uint8_t* gray, size_t pixel_count) {
+    if (!validate_inputs(rgb, gray, pixel_count, ColorFormat::RGB, ColorFormat::GRAYSCALE)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        simd_utils::simd_rgb_to_grayscale(rgb + begin * 3, gray + begin, end - begin);
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::rgba_to_grayscale(const uint8_t* rgba, uint8_t* gray, size_t pixel_count) {
+    if (!validate_inputs(rgba, gray, pixel_count, ColorFormat::RGBA, ColorFormat::GRAYSCALE)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            gray[i] = luma_709(rgba[i * 4 + 0], rgba[i * 4 + 1], rgba[i * 4 + 2]);
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::grayscale_to_rgb(const uint8_t* gray, uint8_t* rgb, size_t pixel_count) {
+    if (!validate_inputs(gray, rgb, pixel_count, ColorFormat::GRAYSCALE, ColorFormat::RGB)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rgb[i * 3 + 0] = rgb[i * 3 + 1] = rgb[i * 3 + 2] = gray[i];
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::grayscale_to_rgba(const uint8_t* gray, uint8_t* rgba, size_t pixel_count, uint8_t alpha) {
+    if (!validate_inputs(gray, rgba, pixel_count, ColorFormat::GRAYSCALE, ColorFormat::RGBA)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rgba[i * 4 + 0] = rgba[i * 4 + 1] = rgba[i * 4 + 2] = gray[i];
+            rgba[i * 4 + 3] = alpha;
+        }
+    });
+    return true;
+}
+
+// HSV conversions (the simd_* kernels convert whole groups of four pixels,
+// the per-pixel helpers the rest)
+
+bool ColorSpaceConverter::rgb_to_hsv(const uint8_t* rgb, uint8_t* hsv, size_t pixel_count) {
+    if (!validate_inputs(rgb, hsv, pixel_count, ColorFormat::RGB, ColorFormat::HSV)) {
+        return false;
+    }
+    const bool simd = use_simd_;
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        size_t i = begin + (simd ? simd_utils::simd_rgb_to_hsv(rgb + begin * 3, 3, hsv + begin * 3, end - begin) : 0);
+        for (; i < end; ++i) {
+            simd_rgb_to_hsv_single(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2],
+                                   hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2]);
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::hsv_to_rgb(const uint8_t* hsv, uint8_t* rgb, size_t pixel_count) {
+    if (!validate_inputs(hsv, rgb, pixel_count, ColorFormat::HSV, ColorFormat::RGB)) {
+        return false;
+    }
+    const bool simd = use_simd_;
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        size_t i = begin + (simd ? simd_utils::simd_hsv_to_rgb(hsv + begin * 3, rgb + begin * 3, 3, 0, end - begin) : 0);
+        for (; i < end; ++i) {
+            simd_hsv_to_rgb_single(hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2],
+                                   rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::rgba_to_hsv(const uint8_t* rgba, uint8_t* hsv, size_t pixel_count) {
+    if (!validate_inputs(rgba, hsv, pixel_count, ColorFormat::RGBA, ColorFormat::HSV)) {
+        return false;
+    }
+    const bool simd = use_simd_;
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        size_t i = begin + (simd ? simd_utils::simd_rgb_to_hsv(rgba + begin * 4, 4, hsv + begin * 3, end - begin) : 0);
+        for (; i < end; ++i) {
+            simd_rgb_to_hsv_single(rgba[i * 4], rgba[i * 4 + 1], rgba[i * 4 + 2],
+                                   hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2]);
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::hsv_to_rgba(const uint8_t* hsv, uint8_t* rgba, size_t pixel_count, uint8_t alpha) {
+    if (!validate_inputs(hsv, rgba, pixel_count, ColorFormat::HSV, ColorFormat::RGBA)) {
+        return false;
+    }
+    const bool simd = use_simd_;
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        size_t i = begin + (simd ? simd_utils::simd_hsv_to_rgb(hsv + begin * 3, rgba + begin * 4, 4, alpha, end - begin) : 0);
+        for (; i < end; ++i) {
+            simd_hsv_to_rgb_single(hsv[i * 3], hsv[i * 3 + 1], hsv[i * 3 + 2],
+                                   rgba[i * 4], rgba[i * 4 + 1], rgba[i * 4 + 2]);
+            rgba[i * 4 + 3] = alpha;
+        }
+    });
+    return true;
+}
+
+// HSL conversions
+
+bool ColorSpaceConverter::rgb_to_hsl(const uint8_t* rgb, uint8_t* hsl, size_t pixel_count) {
+    if (!validate_inputs(rgb, hsl, pixel_count, ColorFormat::RGB, ColorFormat::HSL)) {
+        return false;
+    }
+    const bool simd = use_simd_;
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        size_t i = begin + (simd ? simd_utils::simd_rgb_to_hsl(rgb + begin * 3, 3, hsl + begin * 3, end - begin) : 0);
+        for (; i < end; ++i) {
+            simd_rgb_to_hsl_single(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2],
+                                   hsl[i * 3], hsl[i * 3 + 1], hsl[i * 3 + 2]);
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::hsl_to_rgb(const uint8_t* hsl, uint8_t* rgb, size_t pixel_count) {
+    if (!validate_inputs(hsl, rgb, pixel_count, ColorFormat::HSL, ColorFormat::RGB)) {
+        return false;
+    }
+    const bool simd = use_simd_;
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        size_t i = begin + (simd ? simd_utils::simd_hsl_to_rgb(hsl + begin * 3, rgb + begin * 3, 3, 0, end - begin) : 0);
+        for (; i < end; ++i) {
+            simd_hsl_to_rgb_single(hsl[i * 3], hsl[i * 3 + 1], hsl[i * 3 + 2],
+                                   rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        }
+    });
+    return true;
+}
+
+// YUV conversions
+
+bool ColorSpaceConverter::rgb_to_yuv444(const uint8_t* rgb, uint8_t* yuv, size_t pixel_count) {
+    if (!validate_inputs(rgb, yuv, pixel_count, ColorFormat::RGB, ColorFormat::YUV444)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            rgb_to_yuv_pixel(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2],
+                             yuv[i * 3], yuv[i * 3 + 1], yuv[i * 3 + 2]);
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::yuv444_to_rgb(const uint8_t* yuv, uint8_t* rgb, size_t pixel_count) {
+    if (!validate_inputs(yuv, rgb, pixel_count, ColorFormat::YUV444, ColorFormat::RGB)) {
+        return false;
+    }
+    parallel_for(pixel_count, MIN_PIXELS_PER_BAND, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            yuv_to_rgb_pixel(yuv[i * 3], yuv[i * 3 + 1], yuv[i * 3 + 2], rgb + i * 3);
+        }
+    });
+    return true;
+}
+
+// Chroma is the average of each 2x2 block (clipped at odd edges); bands are chroma rows
+bool ColorSpaceConverter::rgb_to_yuv420(const uint8_t* rgb, uint8_t* y, uint8_t* u, uint8_t* v,
+                                        uint32_t width, uint32_t height) {
+    if (!rgb || !y || !u || !v || width == 0 || height == 0) {
+        return false;
+    }
+    const size_t chroma_width = (width + 1) / 2;
+    const size_t chroma_height = (height + 1) / 2;
+    const size_t min_rows = std::max<size_t>(1, MIN_PIXELS_PER_BAND / (2 * static_cast<size_t>(width)));
+    parallel_for(chroma_height, min_rows, [=](size_t begin, size_t end) {
+        for (size_t cy = begin; cy < end; ++cy) {
+            for (size_t cx = 0; cx < chroma_width; ++cx) {
+                int u_sum = 0;
+                int v_sum = 0;
+                int samples = 0;
+                for (size_t py = 2 * cy; py < std::min<size_t>(2 * cy + 2, height); ++py) {
+                    for (size_t px = 2 * cx; px < std::min<size_t>(2 * cx + 2, width); ++px) {
+                        const size_t i = py * width + px;
+                        uint8_t pu, pv;
+                        rgb_to_yuv_pixel(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2], y[i], pu, pv);
+                        u_sum += pu;
+                        v_sum += pv;
+                        samples++;
+                    }
+                }
+                const size_t ci = cy * chroma_width + cx;
+                u[ci] = static_cast<uint8_t>((u_sum + samples / 2) / samples);
+                v[ci] = static_cast<uint8_t>((v_sum + samples / 2) / samples);
+            }
+        }
+    });
+    return true;
+}
+
+bool ColorSpaceConverter::yuv420_to_rgb(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                                        uint8_t* rgb, uint32_t width, uint32_t height) {
+    if (!y || !u || !v || !rgb || width == 0 || height == 0) {
+        return false;
+    }
+    const size_t chroma_width = (width + 1) / 2;
+    const size_t min_rows = std::max<size_t>(1, MIN_PIXELS_PER_BAND / width);
+    parallel_for(height, min_rows, [=](size_t begin, size_t end) {
+        for (size_t py = begin; py < end; ++py) {
+            const size_t chroma_row = (py / 2) * chroma_width;
+            for (uint32_t px = 0; px < width; ++px) {
+                const size_t i = py * width + px;
+                yuv_to_rgb_pixel(y[i], u[chroma_row + px / 2], v[chroma_row + px / 2], rgb + i * 3);
+            }
+        }
+    });
+    return true;
+}
+
+// Color space information
+
+int ColorSpaceConverter::get_channels_per_pixel(ColorFormat format) {
+    switch (format) {
+        case ColorFormat::GRAYSCALE:
+            return 1;
+        case ColorFormat::RGBA:
+        case ColorFormat::BGRA:
+            return 4;
+        default:
+            return 3;
+    }
+}
+
+// Bytes per pixel of packed formats; for planar YUV420 the luma byte only
+int ColorSpaceConverter::get_bytes_per_pixel(ColorFormat format) {
+    return format == ColorFormat::YUV420 ? 1 : get_channels_per_pixel(format);
+}
+
+bool ColorSpaceConverter::is_packed_format(ColorFormat format) {
+    return format != ColorFormat::YUV420;
+}
+
+bool ColorSpaceConverter::has_alpha_channel(ColorFormat format) {
+    return format == ColorFormat::RGBA || format == ColorFormat::BGRA;
+}
+
+const char* ColorSpaceConverter::format_to_string(ColorFormat format) {
+    switch (format) {
+        case ColorFormat::RGB: return "rgb";
+        case ColorFormat::RGBA: return "rgba";
+        case ColorFormat::BGR: return "bgr";
+        case ColorFormat::BGRA: return "bgra";
+        case ColorFormat::GRAYSCALE: return "grayscale";
+        case ColorFormat::HSV: return "hsv";
+        case ColorFormat::HSL: return "hsl";
+        case ColorFormat::YUV420: return "yuv420";
+        case ColorFormat::YUV444: return "yuv444";
+    }
+    return "unknown";
+}
+
+// Names as in format_to_string; anything else maps to RGB
+ColorFormat ColorSpaceConverter::string_to_format(const char* format_str) {
+    static const ColorFormat formats[] = {
+        ColorFormat::RGB, ColorFormat::RGBA, ColorFormat::BGR, ColorFormat::BGRA, ColorFormat::GRAYSCALE,
+        ColorFormat::HSV, ColorFormat::HSL, ColorFormat::YUV420, ColorFormat::YUV444,
+    };
+    if (format_str) {
+        for (ColorFormat format : formats) {
+            if (std::strcmp(format_str, format_to_string(format)) == 0) {
+                return format;
+            }
+        }
+    }
+    return ColorFormat::RGB;
+}
+
+// Per-pixel helpers; h is 256 steps per turn, s/v/l are 0-255
+
+void ColorSpaceConverter::simd_rgb_to_hsv_single(uint8_t r, uint8_t g, uint8_t b,
+                                                 uint8_t& h, uint8_t& s, uint8_t& v) {
+    const float rf = r / 255.0f, gf = g / 255.0f, bf = b / 255.0f;
+    const float max = std::max(rf, std::max(gf, bf));
+    const float delta = max - std::min(rf, std::min(gf, bf));
+    h = hue_to_u8(hue_degrees(rf, gf, bf, max, delta));
+    s = max > 0.0f ? unit_to_u8(delta / max) : 0;
+    v = std::max(r, std::max(g, b));
+}
+
+void ColorSpaceConverter::simd_hsv_to_rgb_single(uint8_t h, uint8_t s, uint8_t v,
+                                                 uint8_t& r, uint8_t& g, uint8_t& b) {
+    const float value = v / 255.0f;
+    const float chroma = value * (s / 255.0f);
+    chroma_to_rgb(h, chroma, value - chroma, r, g, b);
+}
+
+void ColorSpaceConverter::simd_rgb_to_hsl_single(uint8_t r, uint8_t g, uint8_t b,
+                                                 uint8_t& h, uint8_t& s, uint8_t& l) {
+    const float rf = r / 255.0f, gf = g / 255.0f, bf = b / 255.0f;
+    const float max = std::max(rf, std::max(gf, bf));
+    const float min = std::min(rf, std::min(gf, bf));
+    const float delta = max - min;
+    const float lightness = (max + min) * 0.5f;
+    const float denom = 1.0f - std::fabs(2.0f * lightness - 1.0f);
+    h = hue_to_u8(hue_degrees(rf, gf, bf, max, delta));
+    s = delta > 0.0f && denom > 0.0f ? unit_to_u8(delta / denom) : 0;
+    l = unit_to_u8(lightness);
+}
+
+void ColorSpaceConverter::simd_hsl_to_rgb_single(uint8_t h, uint8_t s, uint8_t l,
+                                                 uint8_t& r, uint8_t& g, uint8_t& b) {
+    const float lightness = l / 255.0f;
+    const float chroma = (1.0f - std::fabs(2.0f * lightness - 1.0f)) * (s / 255.0f);
+    chroma_to_rgb(h, chroma, lightness - chroma * 0.5f, r, g, b);
+}
+
+
+// Color space analysis
+
+namespace {
+
+void histogram_moments(const uint32_t* hist, int bins, double& mean, double& std_dev) {
+    double count = 0.0, sum = 0.0, sum_sq = 0.0;
+    for (int v = 0; v < bins; ++v) {
+        count += hist[v];
+        sum += static_cast<double>(hist[v]) * v;
+        sum_sq += static_cast<double>(hist[v]) * v * v;
+    }
+    mean = count > 0.0 ? sum / count : 0.0;
+    std_dev = count > 0.0 ? std::sqrt(std::max(0.0, sum_sq / count - mean * mean)) : 0.0;
+}
+
+} // namespace
+
+ColorDistribution analyze_color_distribution(const uint8_t* rgb_data, size_t pixel_count) {
+    ColorDistribution dist{};
+    if (!rgb_data || pixel_count == 0) {
+        return dist;
+    }
+
+    uint32_t* hist[4] = {dist.histogram_r, dist.histogram_g, dist.histogram_b, nullptr};
+    simd_utils::simd_accumulate_histograms(rgb_data, pixel_count, 3, hist);
+
+    // HSV with hue in whole degrees; grays have no hue and stay out of
+    // histogram_h. The dominant color is the fullest cell of a 16-level grid.
+    std::vector<uint32_t> cells(4096, 0);
+    for (size_t i = 0; i < pixel_count; ++i) {
+        const uint8_t* px = rgb_data + i * 3;
+        const uint8_t max = std::max(px[0], std::max(px[1], px[2]));
+        const uint8_t min = std::min(px[0], std::min(px[1], px[2]));
+        dist.histogram_v[max]++;
+        dist.histogram_s[max > 0 ? unit_to_u8(static_cast<float>(max - min) / max) : 0]++;
+        if (max > min) {
+            float hue = hue_degrees(px[0] / 255.0f, px[1] / 255.0f, px[2] / 255.0f, max / 255.0f,
+                                    (max - min) / 255.0f);
+            dist.histogram_h[std::min(359, static_cast<int>(hue))]++;
+        }
+        cells[(px[0] >> 4) << 8 | (px[1] >> 4) << 4 | px[2] >> 4]++;
+    }
+
+    histogram_moments(dist.histogram_r, 256, dist.mean_r, dist.std_dev_r);
+    histogram_moments(dist.histogram_g, 256, dist.mean_g, dist.std_dev_g);
+    histogram_moments(dist.histogram_b, 256, dist.mean_b, dist.std_dev_b);
+    double unused;
+    histogram_moments(dist.histogram_s, 256, dist.mean_s, unused);
+    histogram_moments(dist.histogram_v, 256, dist.mean_v, unused);
+
+    // Hue is an angle: circular mean, in degrees
+    double x = 0.0, y = 0.0;
+    for (int h = 0; h < 360; ++h) {
+        double angle = (h + 0.5) * 3.14159265358979323846 / 180.0;
+        x += dist.histogram_h[h] * std::cos(angle);
+        y += dist.histogram_h[h] * std::sin(angle);
+    }
+    dist.mean_h = x == 0.0 && y == 0.0 ? 0.0 : std::fmod(std::atan2(y, x) * 180.0 / 3.14159265358979323846 + 360.0, 360.0);
+
+    const size_t cell = std::max_element(cells.begin(), cells.end()) - cells.begin();
+    dist.dominant_color_rgb = static_cast<uint32_t>(((cell >> 8) << 4 | 8) << 16 |
+                                                    (((cell >> 4) & 15) << 4 | 8) << 8 |
+                                                    ((cell & 15) << 4 | 8));
+    dist.total_pixels = static_cast<uint32_t>(pixel_count);
+    return dist;
+}
+
+// Gray world: gains bring the channel means to their average. Clipped
+// samples (0 and 255) carry no color and are left out. The correction is
+// all in the gains; temperature and tint stay neutral, so apply_white_balance
+// applies exactly the gains.
+WhiteBalanceParams calculate_auto_white_balance(const uint8_t* rgb, size_t pixel_count) {
+    WhiteBalanceParams params{6500.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+    if (!rgb || pixel_count == 0) {
+        return params;
+    }
+
+    uint32_t hist[3][256] = {};
+    uint32_t* channels[4] = {hist[0], hist[1], hist[2], nullptr};
+    simd_utils::simd_accumulate_histograms(rgb, pixel_count, 3, channels);
+
+    double mean[3];
+    for (int c = 0; c < 3; ++c) {
+        double count = 0.0, sum = 0.0;
+        for (int v = 1; v < 255; ++v) {
+            count += hist[c][v];
+            sum += static_cast<double>(hist[c][v]) * v;
+        }
+        if (count == 0.0) {
+            return params;
+        }
+        mean[c] = sum / count;
+    }
+
+    const double gray = (mean[0] + mean[1] + mean[2]) / 3.0;
+    auto gain = [&](double m) { return static_cast<float>(std::min(4.0, std::max(0.25, gray / m))); };
+    params.red_gain = gain(mean[0]);
+    params.green_gain = gain(mean[1]);
+    params.blue_gain = gain(mean[2]);
+    return params;
+}
+
+// Color correction
+
+namespace {
+
+inline float clamp_unit(float v) {
+    return std::min(1.0f, std::max(0.0f, v));
+}
+
+// Channel multipliers of a white balance (see apply_white_balance)
+void white_balance_gains(const WhiteBalanceParams& params, float* gains) {
+    const float temperature = std::min(12000.0f, std::max(2000.0f, params.temperature));
+    const float warmth = std::sqrt(temperature / 6500.0f);
+    const float tint = std::min(1.0f, std::max(-1.0f, params.tint));
+    gains[0] = params.red_gain * warmth;
+    gains[1] = params.green_gain * (1.0f + 0.5f * tint);
+    gains[2] = params.blue_gain / warmth;
+}
+
+void hue_saturation_unit(float* rgb, float hue_shift, float saturation) {
+    const float max = std::max(rgb[0], std::max(rgb[1], rgb[2]));
+    const float delta = max - std::min(rgb[0], std::min(rgb[1], rgb[2]));
+    if (max <= 0.0f) {
+        return;
+    }
+    float h = std::fmod(hue_degrees(rgb[0], rgb[1], rgb[2], max, delta) + hue_shift, 360.0f);
+    h = h < 0.0f ? h + 360.0f : h;
+    const float chroma = max * clamp_unit(delta / max * saturation);
+    const float sector = h / 60.0f;
+    const float x = chroma * (1.0f - std::fabs(std::fmod(sector, 2.0f) - 1.0f));
+    const float m = max - chroma;
+    const float table[6][3] = {{chroma, x, 0}, {x, chroma, 0}, {0, chroma, x},
+                               {0, x, chroma}, {x, 0, chroma}, {chroma, 0, x}};
+    const float* out = table[std::min(5, static_cast<int>(sector))];
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = out[c] + m;
+    }
+}
+
+// A per-channel correction as a byte table
+template <class Curve>
+void build_curve(uint8_t* lut, Curve curve) {
+    for (int v = 0; v < 256; ++v) {
+        lut[v] = unit_to_u8(curve(v / 255.0f));
+    }
+}
+
+inline bool valid_pixels(const uint8_t* src, const uint8_t* dst, size_t pixel_count, int channels) {
+    return src && dst && pixel_count > 0 && channels >= 1 && channels <= 4;
+}
+
+} // namespace
+
+bool apply_gamma_correction(const uint8_t* src, uint8_t* dst, size_t pixel_count,
+                            int channels, float gamma) {
+    if (!valid_pixels(src, dst, pixel_count, channels) || !(gamma > 0.0f)) {
+        return false;
+    }
+    uint8_t lut[256];
+    build_curve(lut, [=](float v) { return std::pow(v, 1.0f / gamma); });
+    simd_utils::simd_apply_lut(src, dst, pixel_count * channels, lut, channels == 4);
+    return true;
+}
+
+bool adjust_brightness_contrast(const uint8_t* src, uint8_t* dst, size_t pixel_count,
+                                int channels, float brightness, float contrast) {
+    if (!valid_pixels(src, dst, pixel_count, channels)) {
+        return false;
+    }
+    uint8_t lut[256];
+    build_curve(lut, [=](float v) { return (v - 0.5f) * contrast + 0.5f + brightness; });
+    simd_utils::simd_apply_lut(src, dst, pixel_count * channels, lut, channels == 4);
+    return true;
+}
+
+bool adjust_hue_saturation(const uint8_t* rgb, uint8_t* output, size_t pixel_count,
+                           float hue_shift_degrees, float saturation_multiplier) {
+    if (!valid_pixels(rgb, output, pixel_count, 3)) {
+        return false;
+    }
+    for (size_t i = 0; i < pixel_count; ++i) {
+        float px[3] = {rgb[i * 3] / 255.0f, rgb[i * 3 + 1] / 255.0f, rgb[i * 3 + 2] / 255.0f};
+        hue_saturation_unit(px, hue_shift_degrees, saturation_multiplier);
+        for (int c = 0; c < 3; ++c) {
+            output[i * 3 + c] = unit_to_u8(px[c]);
+        }
+    }
+    return true;
+}
+
+bool apply_white_balance(const uint8_t* rgb, uint8_t* output, size_t pixel_count,
+                         const WhiteBalanceParams& params) {
+    if (!valid_pixels(rgb, output, pixel_count, 3)) {
+        return false;
+    }
+    float gains[3];
+    white_balance_gains(params, gains);
+    uint8_t luts[3][256];
+    for (int c = 0; c < 3; ++c) {
+        build_curve(luts[c], [=](float v) { return v * gains[c]; });
+    }
+    for (size_t i = 0; i < pixel_count * 3; i += 3) {
+        output[i] = luts[0][rgb[i]];
+        output[i + 1] = luts[1][rgb[i + 1]];
+        output[i + 2] = luts[2][rgb[i + 2]];
+    }
+    return true;
+}
+
+// ColorCorrectionChain
+
+void ColorCorrectionChain::add_gamma(float gamma) {
+    steps_.push_back({StepType::GAMMA, {gamma > 0.0f ? 1.0f / gamma : 1.0f, 0.0f, 0.0f}});
+}
+
+void ColorCorrectionChain::add_brightness_contrast(float brightness, float contrast) {
+    steps_.push_back({StepType::BRIGHTNESS_CONTRAST, {brightness, contrast, 0.0f}});
+}
+
+void ColorCorrectionChain::add_hue_saturation(float hue_shift_degrees, float saturation_multiplier) {
+    steps_.push_back({StepType::HUE_SATURATION, {hue_shift_degrees, saturation_multiplier, 0.0f}});
+}
+
+void ColorCorrectionChain::add_white_balance(const WhiteBalanceParams& params) {
+    Step step{StepType::CHANNEL_GAINS, {}};
+    white_balance_gains(params, step.values);
+    steps_.push_back(step);
+}
+
+void ColorCorrectionChain::apply(float* rgb) const {
+    for (const Step& step : steps_) {
+        for (int c = 0; c < 3; ++c) {
+            rgb[c] = clamp_unit(rgb[c]);
+        }
+        switch (step.type) {
+            case StepType::GAMMA:
+                for (int c = 0; c < 3; ++c) rgb[c] = std::pow(rgb[c], step.values[0]);
+                break;
+            case StepType::BRIGHTNESS_CONTRAST:
+                for (int c = 0; c < 3; ++c) rgb[c] = (rgb[c] - 0.5f) * step.values[1] + 0.5f + step.values[0];
+                break;
+            case StepType::HUE_SATURATION:
+                hue_saturation_unit(rgb, step.values[0], step.values[1]);
+                break;
+            case StepType::CHANNEL_GAINS:
+                for (int c = 0; c < 3; ++c) rgb[c] *= step.values[c];
+                break;
+        }
+    }
+    for (int c = 0; c < 3; ++c) {
+        rgb[c] = clamp_unit(rgb[c]);
+    }
+}
+
+// ColorLookupTable
+
+ColorLookupTable::ColorLookupTable()
+    : gamma_lut_(), rgb_to_yuv_lut_(), yuv_to_rgb_lut_(), gamma_built_(false), rgb_to_yuv_built_(false),
+      yuv_to_rgb_built_(false), cube_size_(0), cube_index_(), cube_fraction_() {}
+
+void ColorLookupTable::build_gamma_table(float gamma) {
+    if (!(gamma > 0.0f)) {
+        return;
+    }
+    build_curve(gamma_lut_, [=](float v) { return std::pow(v, 1.0f / gamma); });
+    gamma_built_ = true;
+}
+
+// The products rgb_to_yuv_pixel and yuv_to_rgb_pixel form, summed and
+// shifted the same way; offsets and rounding are folded into the first table
+void ColorLookupTable::build_rgb_to_yuv_table() {
+    static const int coefficients[3][3] = {{77, 150, 29}, {-43, -85, 128}, {128, -107, -21}};
+    static const int offsets[3] = {128, 32896, 32896};
+    for (int out = 0; out < 3; ++out) {
+        for (int in = 0; in < 3; ++in) {
+            for (int v = 0; v < 256; ++v) {
+                rgb_to_yuv_lut_[out][in][v] = coefficients[out][in] * v + (in == 0 ? offsets[out] : 0);
+            }
+        }
+    }
+    rgb_to_yuv_built_ = true;
+}
+
+void ColorLookupTable::build_yuv_to_rgb_table() {
+    for (int v = 0; v < 256; ++v) {
+        yuv_to_rgb_lut_[0][v] = 91881 * (v - 128) + 32768;
+        yuv_to_rgb_lut_[1][v] = 22554 * (v - 128) + 32768;
+        yuv_to_rgb_lut_[2][v] = 46802 * (v - 128);
+        yuv_to_rgb_lut_[3][v] = 116130 * (v - 128) + 32768;
+    }
+    yuv_to_rgb_built_ = true;
+}
+
+bool ColorLookupTable::gamma_correct_lut(const uint8_t* src, uint8_t* dst, size_t pixel_count, int channels) {
+    if (!gamma_built_ || !valid_pixels(src, dst, pixel_count, channels)) {
+        return false;
+    }
+    simd_utils::simd_apply_lut(src, dst, pixel_count * channels, gamma_lut_, channels == 4);
+    return true;
+}
+
+bool ColorLookupTable::rgb_to_yuv_lut(const uint8_t* rgb, uint8_t* yuv, size_t pixel_count) {
+    if (!rgb_to_yuv_built_ || !valid_pixels(rgb, yuv, pixel_count, 3)) {
+        return false;
+    }
+    const auto& t = rgb_to_yuv_lut_;
+    for (size_t i = 0; i < pixel_count * 3; i += 3) {
+        const uint8_t r = rgb[i], g = rgb[i + 1], b = rgb[i + 2];
+        yuv[i] = clamp_u8((t[0][0][r] + t[0][1][g] + t[0][2][b]) >> 8);
+        yuv[i + 1] = clamp_u8((t[1][0][r] + t[1][1][g] + t[1][2][b]) >> 8);
+        yuv[i + 2] = clamp_u8((t[2][0][r] + t[2][1][g] + t[2][2][b]) >> 8);
+    }
+    return true;
+}
+
+bool ColorLookupTable::yuv_to_rgb_lut(const uint8_t* yuv, uint8_t* rgb, size_t pixel_count) {
+    if (!yuv_to_rgb_built_ || !valid_pixels(yuv, rgb, pixel_count, 3)) {
+        return false;
+    }
+    const auto& t = yuv_to_rgb_lut_;
+    for (size_t i = 0; i < pixel_count * 3; i += 3) {
+        const int y = yuv[i];
+        const uint8_t u = yuv[i + 1], v = yuv[i + 2];
+        rgb[i] = clamp_u8(y + (t[0][v] >> 16));
+        rgb[i + 1] = clamp_u8(y - ((t[1][u] + t[2][v]) >> 16));
+        rgb[i + 2] = clamp_u8(y + (t[3][u] >> 16));
+    }
+    return true;
+}
+
+bool ColorLookupTable::build_3d_lut(const ColorCorrectionChain& chain, int size) {
+    if (size < 2 || size > MAX_CUBE_SIZE) {
+        return false;
+    }
+    cube_size_ = size;
+    cube_.resize(static_cast<size_t>(size) * size * size * 3);
+    const float step = 1.0f / (size - 1);
+    size_t n = 0;
+    for (int r = 0; r < size; ++r) {
+        for (int g = 0; g < size; ++g) {
+            for (int b = 0; b < size; ++b) {
+                float rgb[3] = {r * step, g * step, b * step};
+                chain.apply(rgb);
+                for (int c = 0; c < 3; ++c) {
+                    cube_[n++] = static_cast<uint16_t>(std::lround(rgb[c] * 255.0f * 256.0f));
+                }
+            }
+        }
+    }
+    // The top value sits at the far end of the last cell rather than the
+    // start of a missing one
+    for (int v = 0; v < 256; ++v) {
+        const float position = v * (size - 1) / 255.0f;
+        const int index = std::min(size - 2, static_cast<int>(position));
+        cube_index_[v] = static_cast<uint8_t>(index);
+        cube_fraction_[v] = static_cast<uint16_t>(std::lround((position - index) * 256.0f));
+    }
+    return true;
+}
+
+// Tetrahedral interpolation: the cell's diagonal from its lower to its
+// upper corner, and the order of the three fractions, pick the four corners
+// around the color. Weights are 8-bit fractions summing to 256.
+bool ColorLookupTable::apply_3d_lut(const uint8_t* src, uint8_t* dst, size_t pixel_count, int channels) const {
+    if (cube_size_ == 0 || !valid_pixels(src, dst, pixel_count, channels) || channels < 3) {
+        return false;
+    }
+    const size_t sb = 3;
+    const size_t sg = sb * cube_size_;
+    const size_t sr = sg * cube_size_;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        const uint8_t* in = src + i * channels;
+        const uint32_t fr = cube_fraction_[in[0]], fg = cube_fraction_[in[1]], fb = cube_fraction_[in[2]];
+        const uint16_t* base = &cube_[cube_index_[in[0]] * sr + cube_index_[in[1]] * sg + cube_index_[in[2]] * sb];
+
+        // Corners after the base: the first along the largest fraction, then
+        // the largest two, then all three
+        size_t first, second;
+        uint32_t w0, w1, w2, w3;
+        if (fr >= fg && fg >= fb) {
+            first = sr; second = sr + sg; w0 = 256 - fr; w1 = fr - fg; w2 = fg - fb; w3 = fb;
+        } else if (fr >= fb && fb >= fg) {
+            first = sr; second = sr + sb; w0 = 256 - fr; w1 = fr - fb; w2 = fb - fg; w3 = fg;
+        } else if (fb >= fr && fr >= fg) {
+            first = sb; second = sr + sb; w0 = 256 - fb; w1 = fb - fr; w2 = fr - fg; w3 = fg;
+        } else if (fg >= fr && fr >= fb) {
+            first = sg; second = sr + sg; w0 = 256 - fg; w1 = fg - fr; w2 = fr - fb; w3 = fb;
+        } else if (fg >= fb && fb >= fr) {
+            first = sg; second = sg + sb; w0 = 256 - fg; w1 = fg - fb; w2 = fb - fr; w3 = fr;
+        } else {
+            first = sb; second = sg + sb; w0 = 256 - fb; w1 = fb - fg; w2 = fg - fr; w3 = fr;
+        }
+        const uint16_t* c1 = base + first;
+        const uint16_t* c2 = base + second;
+        const uint16_t* c3 = base + sr + sg + sb;
+        uint8_t* out = dst + i * channels;
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t sum = w0 * base[c] + w1 * c1[c] + w2 * c2[c] + w3 * c3[c];
+            out[c] = static_cast<uint8_t>((sum + (1u << 15)) >> 16);
+        }
+        if (channels == 4) {
+            out[3] = in[3];
+        }
+    }
+    return true;
+}
+
+// Lab conversions and color difference
+
+bool rgb_to_lab(const uint8_t* rgb, uint8_t* lab, size_t pixel_count) {
+    if (!valid_pixels(rgb, lab, pixel_count, 3)) {
+        return false;
+    }
+    simd_utils::simd_rgb_to_lab(rgb, lab, pixel_count);
+    return true;
+}
+
+bool lab_to_rgb(const uint8_t* lab, uint8_t* rgb, size_t pixel_count) {
+    if (!valid_pixels(lab, rgb, pixel_count, 3)) {
+        return false;
+    }
+    simd_utils::simd_lab_to_rgb(lab, rgb, pixel_count);
+    return true;
+}
+
+float calculate_color_difference_lab(const uint8_t* lab1, const uint8_t* lab2) {
+    if (!lab1 || !lab2) {
+        return 0.0f;
+    }
+    const float dl = (lab1[0] - lab2[0]) / 2.55f;
+    const float da = static_cast<float>(lab1[1] - lab2[1]);
+    const float db = static_cast<float>(lab1[2] - lab2[2]);
+    return std::sqrt(dl * dl + da * da + db * db);
+}
+
+float calculate_color_difference_rgb(uint8_t r1, uint8_t g1, uint8_t b1,
+                                     uint8_t r2, uint8_t g2, uint8_t b2) {
+    const uint8_t rgb[6] = {r1, g1, b1, r2, g2, b2};
+    uint8_t lab[6];
+    simd_utils::simd_rgb_to_lab(rgb, lab, 2);
+    return calculate_color_difference_lab(lab, lab + 3);
+}
+
+// Palettes
+
+namespace {
+
+// Colors are binned on 5 bits per channel before clustering, so k-means
+// runs over at most 32768 weighted cell means rather than every pixel
+constexpr int PALETTE_CELL_BITS = 5;
+constexpr int MAX_PALETTE_COLORS = 256;
+constexpr int MAX_PALETTE_ITERATIONS = 16;
+
+struct PaletteCell {
+    float lab[3];
+    uint64_t sum[3];  // RGB sums of the cell's pixels
+    uint32_t count;
+};
+
+inline float lab_distance_sq(const float* a, const float* b) {
+    const float d0 = a[0] - b[0], d1 = a[1] - b[1], d2 = a[2] - b[2];
+    return d0 * d0 + d1 * d1 + d2 * d2;
+}
+
+} // namespace
+
+ColorPalette extract_color_palette(const uint8_t* rgb, size_t pixel_count, int num_colors) {
+    ColorPalette palette;
+    palette.total_pixels = rgb ? pixel_count : 0;
+    if (!rgb || pixel_count == 0 || pixel_count > UINT32_MAX || num_colors < 1) {
+        return palette;
+    }
+    num_colors = std::min(num_colors, MAX_PALETTE_COLORS);
+
+    const int shift = 8 - PALETTE_CELL_BITS;
+    std::vector<uint32_t> cell_of(size_t(1) << (3 * PALETTE_CELL_BITS), UINT32_MAX);
+    std::vector<PaletteCell> cells;
+    for (size_t i = 0; i < pixel_count; ++i) {
+        const uint8_t* px = rgb + i * 3;
+        const uint32_t key = (px[0] >> shift) << (2 * PALETTE_CELL_BITS) | (px[1] >> shift) << PALETTE_CELL_BITS |
+                             (px[2] >> shift);
+        if (cell_of[key] == UINT32_MAX) {
+            cell_of[key] = static_cast<uint32_t>(cells.size());
+            cells.push_back({{0.0f, 0.0f, 0.0f}, {0, 0, 0}, 0});
+        }
+        PaletteCell& cell = cells[cell_of[key]];
+        for (int c = 0; c < 3; ++c) {
+            cell.sum[c] += px[c];
+        }
+        cell.count++;
+    }
+
+    // Cell means in Lab, converted in one bulk call
+    std::vector<uint8_t> means(cells.size() * 3), lab(cells.size() * 3);
+    for (size_t i = 0; i < cells.size(); ++i) {
+        for (int c = 0; c < 3; ++c) {
+            means[i * 3 + c] = static_cast<uint8_t>((cells[i].sum[c] + cells[i].count / 2) / cells[i].count);
+        }
+    }
+    simd_utils::simd_rgb_to_lab(means.data(), lab.data(), cells.size());
+    for (size_t i = 0; i < cells.size(); ++i) {
+        cells[i].lab[0] = lab[i * 3] / 2.55f;
+        cells[i].lab[1] = lab[i * 3 + 1] - 128.0f;
+        cells[i].lab[2] = lab[i * 3 + 2] - 128.0f;
+    }
+
+    // Seeds: the most common cell, then repeatedly the cell whose weight
+    // times squared distance to its nearest seed is largest
+    const size_t k = std::min(cells.size(), static_cast<size_t>(num_colors));
+    std::vector<float> centers;
+    std::vector<float> nearest(cells.size(), INFINITY);
+    size_t seed = 0;
+    for (size_t i = 1; i < cells.size(); ++i) {
+        seed = cells[i].count > cells[seed].count ? i : seed;
+    }
+    while (centers.size() < k * 3) {
+        centers.insert(centers.end(), cells[seed].lab, cells[seed].lab + 3);
+        const float* center = &centers[centers.size() - 3];
+        double best = -1.0;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            nearest[i] = std::min(nearest[i], lab_distance_sq(cells[i].lab, center));
+            const double score = static_cast<double>(nearest[i]) * cells[i].count;
+            if (score > best) {
+                best = score;
+                seed = i;
+            }
+        }
+    }
+
+    std::vector<uint32_t> assignment(cells.size(), UINT32_MAX);
+    std::vector<double> lab_sums(k * 3);
+    std::vector<uint64_t> rgb_sums(k * 3);
+    std::vector<uint64_t> counts(k);
+    for (int iteration = 0; iteration < MAX_PALETTE_ITERATIONS; ++iteration) {
+        bool changed = false;
+        std::fill(lab_sums.begin(), lab_sums.end(), 0.0);
+        std::fill(rgb_sums.begin(), rgb_sums.end(), 0);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (size_t i = 0; i < cells.size(); ++i) {
+            uint32_t best = 0;
+            float best_distance = INFINITY;
+            for (size_t j = 0; j < k; ++j) {
+                const float distance = lab_distance_sq(cells[i].lab, &centers[j * 3]);
+                if (distance < best_distance) {
+                    best_distance = distance;
+                    best = static_cast<uint32_t>(j);
+                }
+            }
+            changed |= assignment[i] != best;
+            assignment[i] = best;
+            for (int c = 0; c < 3; ++c) {
+                lab_sums[best * 3 + c] += static_cast<double>(cells[i].lab[c]) * cells[i].count;
+                rgb_sums[best * 3 + c] += cells[i].sum[c];
+            }
+            counts[best] += cells[i].count;
+        }
+        for (size_t j = 0; j < k; ++j) {
+            for (int c = 0; c < 3 && counts[j] > 0; ++c) {
+                centers[j * 3 + c] = static_cast<float>(lab_sums[j * 3 + c] / counts[j]);
+            }
+        }
+        if (!changed) {
+            break;
+        }
+    }
+
+    // Colors are the mean RGB of each cluster's pixels, most common first
+    std::vector<size_t> order;
+    for (size_t j = 0; j < k; ++j) {
+        if (counts[j] > 0) {
+            order.push_back(j);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return counts[a] > counts[b]; });
+    for (size_t j : order) {
+        uint32_t color = 0;
+        for (int c = 0; c < 3; ++c) {
+            color = color << 8 | static_cast<uint32_t>((rgb_sums[j * 3 + c] + counts[j] / 2) / counts[j]);
+        }
+        palette.colors.push_back(color);
+        palette.counts.push_back(static_cast<uint32_t>(counts[j]));
+    }
+    return palette;
+}
+
+} // namespace color_space
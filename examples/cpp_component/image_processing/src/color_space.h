@@ -2,6 +2,8 @@
 
 #include "simd_utils.h"
 #include <cstdint>
+#include <functional>
+#include <string>
 #include <vector>
 
 namespace color_space {
@@ -36,6 +38,14 @@ struct ConversionResult {
     std::string error_message;
 };
 
+// Per-channel histograms with `bins` bins over 0-255 (bin = value * bins / 256),
+// laid out like the WIT histogram record
+struct Histogram {
+    uint32_t bins;
+    std::vector<uint32_t> channel[4];  // In pixel order; empty past the image's channels
+    std::vector<uint32_t> luminance;   // BT.709 luma, or channel 0 of a grayscale image
+};
+
 // Color space converter class
 class ColorSpaceConverter {
 public:
@@ -78,6 +88,11 @@ public:
     bool yuv420_to_rgb(const uint8_t* y, const uint8_t* u, const uint8_t* v,
                       uint8_t* rgb, uint32_t width, uint32_t height);
 
+    // Histograms of interleaved pixels with 1-4 channels, split into pixel
+    // bands like the bulk conversions; false for bad arguments
+    bool calculate_histogram(const uint8_t* pixels, size_t pixel_count, int channels, uint32_t bins,
+                             Histogram& histogram);
+
     // Color space information
     static int get_channels_per_pixel(ColorFormat format);
     static int get_bytes_per_pixel(ColorFormat format);
@@ -90,6 +105,13 @@ public:
     void enable_simd(bool enable) { use_simd_ = enable; }
     bool is_simd_enabled() const { return use_simd_; }
 
+    // Bulk conversions split into pixel bands on the shared worker_pool::WorkerPool
+    void enable_multithreading(bool enable) { use_multithreading_ = enable; }
+    bool is_multithreading_enabled() const { return use_multithreading_; }
+
+    // Threads per conversion, caller included; 0 means one per hardware thread
+    void set_thread_count(unsigned threads) { thread_count_ = threads; }
+
     // Statistics
     struct ConversionStats {
         uint64_t total_conversions;
@@ -104,11 +126,13 @@ public:
 
 private:
     bool use_simd_;
+    bool use_multithreading_;
+    unsigned thread_count_;
     ConversionStats stats_;
-    simd_utils::SIMDMemoryPool memory_pool_;
 
     // Helper functions
     void update_stats(size_t pixel_count, double time_ms);
+    void parallel_for(size_t count, size_t min_chunk, const std::function<void(size_t, size_t)>& body);
     bool validate_inputs(const uint8_t* src, uint8_t* dst, size_t pixel_count,
                         ColorFormat src_format, ColorFormat dst_format);
 
@@ -147,15 +171,18 @@ ColorDistribution analyze_color_distribution(const uint8_t* rgb_data, size_t pix
 
 // Color correction and adjustment functions
 
-// Gamma correction
+// Alpha (the fourth of four channels) passes through every correction below
+
+// Gamma correction: out = in^(1 / gamma) on [0, 1]
 bool apply_gamma_correction(const uint8_t* src, uint8_t* dst, size_t pixel_count,
                            int channels, float gamma);
 
-// Brightness and contrast adjustment
+// Brightness and contrast adjustment: out = (in - 0.5) * contrast + 0.5 +
+// brightness on [0, 1]
 bool adjust_brightness_contrast(const uint8_t* src, uint8_t* dst, size_t pixel_count,
                                int channels, float brightness, float contrast);
 
-// Hue and saturation adjustment
+// Hue and saturation adjustment in HSV
 bool adjust_hue_saturation(const uint8_t* rgb, uint8_t* output, size_t pixel_count,
                           float hue_shift_degrees, float saturation_multiplier);
 
@@ -168,12 +195,41 @@ struct WhiteBalanceParams {
     float blue_gain;     // Blue channel multiplier
 };
 
+// Multiplies each channel by its gain, then shifts away from a 6500 K
+// illuminant (a lower temperature cools the image: red down, blue up, by
+// the square root of the ratio) and by tint (the green multiplier is
+// 1 + tint / 2). Neutral is {6500, 0, 1, 1, 1}.
 bool apply_white_balance(const uint8_t* rgb, uint8_t* output, size_t pixel_count,
                         const WhiteBalanceParams& params);
 
 // Auto white balance using gray world assumption
 WhiteBalanceParams calculate_auto_white_balance(const uint8_t* rgb, size_t pixel_count);
 
+// Color corrections run in the order added, on RGB in [0, 1], with the
+// same math as the functions above; ColorLookupTable::build_3d_lut folds a
+// whole chain into one table
+class ColorCorrectionChain {
+public:
+    void add_gamma(float gamma);
+    void add_brightness_contrast(float brightness, float contrast);
+    void add_hue_saturation(float hue_shift_degrees, float saturation_multiplier);
+    void add_white_balance(const WhiteBalanceParams& params);
+
+    void clear() { steps_.clear(); }
+    size_t size() const { return steps_.size(); }
+
+    // Every step on rgb[0..2], in place; results are clamped to [0, 1]
+    void apply(float* rgb) const;
+
+private:
+    enum class StepType { GAMMA, BRIGHTNESS_CONTRAST, HUE_SATURATION, CHANNEL_GAINS };
+    struct Step {
+        StepType type;
+        float values[3];
+    };
+    std::vector<Step> steps_;
+};
+
 // Color space conversion lookup tables (for performance)
 class ColorLookupTable {
 public:
@@ -184,18 +240,34 @@ public:
     void build_rgb_to_yuv_table();
     void build_yuv_to_rgb_table();
 
-    // Use lookup tables for conversion
+    // Use lookup tables for conversion; false until the table is built.
+    // Results match apply_gamma_correction and the ColorSpaceConverter YUV444
+    // conversions exactly.
     bool gamma_correct_lut(const uint8_t* src, uint8_t* dst, size_t pixel_count, int channels);
     bool rgb_to_yuv_lut(const uint8_t* rgb, uint8_t* yuv, size_t pixel_count);
     bool yuv_to_rgb_lut(const uint8_t* yuv, uint8_t* rgb, size_t pixel_count);
 
+    // 3D LUT: the chain sampled on a size^3 grid of RGB nodes (2 to 65; 33
+    // and 65 are usual). Applying it interpolates within the tetrahedron of
+    // four nodes around each color, so any chain costs one pass. At 33
+    // nodes the mean error against running the chain per pixel is a quarter
+    // of a level; the largest errors sit where the chain clips.
+    static constexpr int MAX_CUBE_SIZE = 65;
+    bool build_3d_lut(const ColorCorrectionChain& chain, int size = 33);
+    bool apply_3d_lut(const uint8_t* src, uint8_t* dst, size_t pixel_count, int channels) const;
+
 private:
     uint8_t gamma_lut_[256];
-    int16_t rgb_to_y_lut_[256];
-    int16_t rgb_to_u_lut_[256];
-    int16_t rgb_to_v_lut_[256];
-    uint8_t yuv_to_rgb_lut_[256][3];
-    bool tables_built_;
+    int32_t rgb_to_yuv_lut_[3][3][256];  // [Y, U, V][R, G, B]: 8.8 products
+    int32_t yuv_to_rgb_lut_[4][256];     // V to R, U and V to G, U to B: 16.16 products
+    bool gamma_built_;
+    bool rgb_to_yuv_built_;
+    bool yuv_to_rgb_built_;
+
+    int cube_size_;
+    std::vector<uint16_t> cube_;         // RGB per node, red slowest, in 8.8 fixed point
+    uint8_t cube_index_[256];            // Lower node of each input value
+    uint16_t cube_fraction_[256];        // Position past it, 0 to 256
 };
 
 // Advanced color space operations
@@ -221,7 +293,9 @@ struct ColorPalette {
     size_t total_pixels;
 };
 
-// Extract dominant colors using K-means clustering
+// Extract dominant colors using K-means clustering in Lab. Pixels are first
+// binned on 5 bits per channel; the bins' means are clustered by weight.
+// Colors (0xRRGGBB) are each cluster's mean, most common first.
 ColorPalette extract_color_palette(const uint8_t* rgb, size_t pixel_count, int num_colors = 16);
 
 // Quantize image to palette
@@ -232,13 +306,14 @@ bool quantize_to_palette(const uint8_t* rgb, uint8_t* output, size_t pixel_count
 bool floyd_steinberg_dither(const uint8_t* src, uint8_t* dst, uint32_t width, uint32_t height,
                            int channels, const ColorPalette& palette);
 
-// Color difference calculation (Delta E)
+// Color difference calculation (Delta E, CIE76 on the 8-bit Lab encoding)
 float calculate_color_difference_rgb(uint8_t r1, uint8_t g1, uint8_t b1,
                                     uint8_t r2, uint8_t g2, uint8_t b2);
 
 float calculate_color_difference_lab(const uint8_t* lab1, const uint8_t* lab2);
 
-// LAB color space conversion (CIE L*a*b*)
+// LAB color space conversion (CIE L*a*b*, D65): 3 bytes per pixel holding
+// L* * 255 / 100, a* + 128 and b* + 128 (see simd_utils::simd_rgb_to_lab)
 bool rgb_to_lab(const uint8_t* rgb, uint8_t* lab, size_t pixel_count);
 bool lab_to_rgb(const uint8_t* lab, uint8_t* rgb, size_t pixel_count);
 
@@ -0,0 +1,367 @@
+#include "fft.h"
+#include "simd_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+namespace fft {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// One lane of butterflies
+struct ScalarLanes {
+    using V = float;
+    static constexpr size_t WIDTH = 1;
+
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V splat(float v) { return v; }
+    static V add(V a, V b) { return a + b; }
+    static V sub(V a, V b) { return a - b; }
+    static V mul(V a, V b) { return a * b; }
+};
+
+#if SIMD_SUPPORTED
+// Four butterflies of one group at a time
+struct SimdLanes {
+    using V = v128_t;
+    static constexpr size_t WIDTH = 4;
+
+    static V load(const float* p) { return simd_utils::simd_load_unaligned(p); }
+    static void store(float* p, V v) { simd_utils::simd_store_unaligned(p, v); }
+    static V splat(float v) { return simd_utils::simd_splat_f32(v); }
+    static V add(V a, V b) { return simd_utils::simd_add_f32(a, b); }
+    static V sub(V a, V b) { return simd_utils::simd_sub_f32(a, b); }
+    static V mul(V a, V b) { return simd_utils::simd_mul_f32(a, b); }
+};
+#endif
+
+template<typename L>
+struct Complex {
+    typename L::V re, im;
+};
+
+template<typename L>
+inline Complex<L> cadd(Complex<L> a, Complex<L> b) { return {L::add(a.re, b.re), L::add(a.im, b.im)}; }
+
+template<typename L>
+inline Complex<L> csub(Complex<L> a, Complex<L> b) { return {L::sub(a.re, b.re), L::sub(a.im, b.im)}; }
+
+template<typename L>
+inline Complex<L> cscale(Complex<L> a, typename L::V s) { return {L::mul(a.re, s), L::mul(a.im, s)}; }
+
+// a - i * b and a + i * b
+template<typename L>
+inline Complex<L> sub_i(Complex<L> a, Complex<L> b) { return {L::add(a.re, b.im), L::sub(a.im, b.re)}; }
+
+template<typename L>
+inline Complex<L> add_i(Complex<L> a, Complex<L> b) { return {L::sub(a.re, b.im), L::add(a.im, b.re)}; }
+
+// Radix-p butterflies for lanes j .. j + WIDTH of one group starting at base:
+// element q sits at base + j + q * span and is twiddled by row q - 1
+template<typename L, int P>
+void butterfly(float* re, float* im, size_t base, size_t j, size_t span,
+               const float* tw_re, const float* tw_im) {
+    Complex<L> a[P];
+    for (int q = 0; q < P; ++q) {
+        size_t at = base + j + q * span;
+        a[q] = {L::load(re + at), L::load(im + at)};
+        if (q > 0) {
+            typename L::V wr = L::load(tw_re + (q - 1) * span + j);
+            typename L::V wi = L::load(tw_im + (q - 1) * span + j);
+            a[q] = {L::sub(L::mul(a[q].re, wr), L::mul(a[q].im, wi)),
+                    L::add(L::mul(a[q].re, wi), L::mul(a[q].im, wr))};
+        }
+    }
+
+    Complex<L> y[P];
+    if (P == 2) {
+        y[0] = cadd(a[0], a[1]);
+        y[1] = csub(a[0], a[1]);
+    } else if (P == 4) {
+        Complex<L> s02 = cadd(a[0], a[2]);
+        Complex<L> d02 = csub(a[0], a[2]);
+        Complex<L> s13 = cadd(a[1], a[3]);
+        Complex<L> d13 = csub(a[1], a[3]);
+        y[0] = cadd(s02, s13);
+        y[2] = csub(s02, s13);
+        y[1] = sub_i(d02, d13);
+        y[3] = add_i(d02, d13);
+    } else if (P == 3) {
+        const typename L::V half = L::splat(0.5f);
+        const typename L::V s60 = L::splat(static_cast<float>(std::sqrt(3.0) / 2.0));
+        Complex<L> s = cadd(a[1], a[2]);
+        Complex<L> d = cscale(csub(a[1], a[2]), s60);
+        Complex<L> m = csub(a[0], cscale(s, half));
+        y[0] = cadd(a[0], s);
+        y[1] = sub_i(m, d);
+        y[2] = add_i(m, d);
+    } else {
+        const typename L::V c1 = L::splat(static_cast<float>(std::cos(2.0 * PI / 5.0)));
+        const typename L::V c2 = L::splat(static_cast<float>(std::cos(4.0 * PI / 5.0)));
+        const typename L::V s1 = L::splat(static_cast<float>(std::sin(2.0 * PI / 5.0)));
+        const typename L::V s2 = L::splat(static_cast<float>(std::sin(4.0 * PI / 5.0)));
+        Complex<L> s14 = cadd(a[1], a[4]);
+        Complex<L> d14 = csub(a[1], a[4]);
+        Complex<L> s23 = cadd(a[2], a[3]);
+        Complex<L> d23 = csub(a[2], a[3]);
+        Complex<L> t1 = cadd(a[0], cadd(cscale(s14, c1), cscale(s23, c2)));
+        Complex<L> t2 = cadd(a[0], cadd(cscale(s14, c2), cscale(s23, c1)));
+        Complex<L> u1 = cadd(cscale(d14, s1), cscale(d23, s2));
+        Complex<L> u2 = csub(cscale(d14, s2), cscale(d23, s1));
+        y[0] = cadd(a[0], cadd(s14, s23));
+        y[1] = sub_i(t1, u1);
+        y[4] = add_i(t1, u1);
+        y[2] = sub_i(t2, u2);
+        y[3] = add_i(t2, u2);
+    }
+
+    for (int q = 0; q < P; ++q) {
+        size_t at = base + j + q * span;
+        L::store(re + at, y[q].re);
+        L::store(im + at, y[q].im);
+    }
+}
+
+template<int P>
+void run_stage(float* re, float* im, size_t n, size_t span, const float* tw_re, const float* tw_im) {
+    for (size_t base = 0; base < n; base += P * span) {
+        size_t j = 0;
+#if SIMD_SUPPORTED
+        for (; j + SimdLanes::WIDTH <= span; j += SimdLanes::WIDTH) {
+            butterfly<SimdLanes, P>(re, im, base, j, span, tw_re, tw_im);
+        }
+#endif
+        for (; j < span; ++j) {
+            butterfly<ScalarLanes, P>(re, im, base, j, span, tw_re, tw_im);
+        }
+    }
+}
+
+// Digit-reversed order for the factorization, stages applied first to last
+void build_permutation(uint32_t* out, size_t n, uint32_t offset, uint32_t stride,
+                       const std::vector<int>& radices, size_t level) {
+    if (n == 1) {
+        out[0] = offset;
+        return;
+    }
+    const int radix = radices[level - 1];
+    const size_t sub = n / radix;
+    for (int q = 0; q < radix; ++q) {
+        build_permutation(out + q * sub, sub, offset + q * stride, stride * radix, radices, level - 1);
+    }
+}
+
+} // namespace
+
+size_t next_fast_size(size_t n) {
+    for (size_t size = std::max<size_t>(n, 1);; ++size) {
+        size_t m = size;
+        for (size_t p : {2, 3, 5}) {
+            while (m % p == 0) m /= p;
+        }
+        if (m == 1) {
+            return size;
+        }
+    }
+}
+
+// ComplexFFT
+
+bool ComplexFFT::init(size_t n) {
+    n_ = 0;
+    permutation_.clear();
+    stages_.clear();
+    if (n == 0 || n > UINT32_MAX) {
+        return false;
+    }
+
+    std::vector<int> radices;
+    size_t m = n;
+    for (int radix : {4, 2, 3, 5}) {
+        while (m % radix == 0) {
+            radices.push_back(radix);
+            m /= radix;
+        }
+    }
+    if (m != 1) {
+        return false;
+    }
+
+    permutation_.resize(n);
+    build_permutation(permutation_.data(), n, 0, 1, radices, radices.size());
+
+    size_t span = 1;
+    for (int radix : radices) {
+        Stage stage;
+        stage.radix = radix;
+        stage.span = span;
+        stage.tw_re.resize((radix - 1) * span);
+        stage.tw_im.resize((radix - 1) * span);
+        for (int q = 1; q < radix; ++q) {
+            for (size_t j = 0; j < span; ++j) {
+                double angle = -2.0 * PI * q * j / (radix * span);
+                stage.tw_re[(q - 1) * span + j] = static_cast<float>(std::cos(angle));
+                stage.tw_im[(q - 1) * span + j] = static_cast<float>(std::sin(angle));
+            }
+        }
+        stages_.push_back(std::move(stage));
+        span *= radix;
+    }
+    n_ = n;
+    return true;
+}
+
+void ComplexFFT::forward(const float* in_re, const float* in_im, size_t in_stride,
+                         float* out_re, float* out_im) const {
+    for (size_t i = 0; i < n_; ++i) {
+        size_t at = permutation_[i] * in_stride;
+        out_re[i] = in_re[at];
+        out_im[i] = in_im[at];
+    }
+    for (const Stage& stage : stages_) {
+        const float* tw_re = stage.tw_re.data();
+        const float* tw_im = stage.tw_im.data();
+        switch (stage.radix) {
+            case 2: run_stage<2>(out_re, out_im, n_, stage.span, tw_re, tw_im); break;
+            case 3: run_stage<3>(out_re, out_im, n_, stage.span, tw_re, tw_im); break;
+            case 4: run_stage<4>(out_re, out_im, n_, stage.span, tw_re, tw_im); break;
+            default: run_stage<5>(out_re, out_im, n_, stage.span, tw_re, tw_im); break;
+        }
+    }
+}
+
+// With real and imaginary parts swapped on both sides, a forward transform
+// computes the inverse
+void ComplexFFT::inverse(const float* in_re, const float* in_im, size_t in_stride,
+                         float* out_re, float* out_im) const {
+    forward(in_im, in_re, in_stride, out_im, out_re);
+}
+
+// RealFFT2D
+
+bool RealFFT2D::init(size_t width, size_t height) {
+    width_ = 0;
+    height_ = 0;
+    if (!rows_.init(width) || !columns_.init(height)) {
+        return false;
+    }
+    width_ = width;
+    height_ = height;
+    work_.assign(4 * std::max(width, height), 0.0f);
+    return true;
+}
+
+void RealFFT2D::forward(const float* plane, float* re, float* im) {
+    const size_t w = width_;
+    const size_t sw = spectrum_width();
+    float* z_re = work_.data();
+    float* z_im = z_re + std::max(w, height_);
+    float* zeros = z_im + std::max(w, height_);
+    std::fill(zeros, zeros + w, 0.0f);
+
+    // Rows a and b as one complex row z = a + ib: A[k] = (Z[k] + conj Z[-k]) / 2
+    // and B[k] = (Z[k] - conj Z[-k]) / 2i
+    for (size_t y = 0; y < height_; y += 2) {
+        const float* a = plane + y * w;
+        const float* b = y + 1 < height_ ? a + w : zeros;
+        rows_.forward(a, b, 1, z_re, z_im);
+        for (size_t k = 0; k < sw; ++k) {
+            size_t mirror = (w - k) % w;
+            float sum_re = z_re[k] + z_re[mirror];
+            float diff_re = z_re[k] - z_re[mirror];
+            float sum_im = z_im[k] + z_im[mirror];
+            float diff_im = z_im[k] - z_im[mirror];
+            re[y * sw + k] = 0.5f * sum_re;
+            im[y * sw + k] = 0.5f * diff_im;
+            if (y + 1 < height_) {
+                re[(y + 1) * sw + k] = 0.5f * sum_im;
+                im[(y + 1) * sw + k] = -0.5f * diff_re;
+            }
+        }
+    }
+
+    for (size_t u = 0; u < sw; ++u) {
+        columns_.forward(re + u, im + u, sw, z_re, z_im);
+        for (size_t v = 0; v < height_; ++v) {
+            re[v * sw + u] = z_re[v];
+            im[v * sw + u] = z_im[v];
+        }
+    }
+}
+
+void RealFFT2D::inverse(float* re, float* im, float* plane) {
+    const size_t w = width_;
+    const size_t sw = spectrum_width();
+    const size_t span = std::max(w, height_);
+    float* z_re = work_.data();
+    float* z_im = z_re + span;
+    float* r_re = z_im + span;
+    float* r_im = r_re + span;
+
+    for (size_t u = 0; u < sw; ++u) {
+        columns_.inverse(re + u, im + u, sw, z_re, z_im);
+        for (size_t v = 0; v < height_; ++v) {
+            re[v * sw + u] = z_re[v];
+            im[v * sw + u] = z_im[v];
+        }
+    }
+
+    // Rows a and b back as the real and imaginary parts of z, with
+    // Z = A + iB and the upper half from conjugate symmetry
+    const float scale = 1.0f / static_cast<float>(w * height_);
+    for (size_t y = 0; y < height_; y += 2) {
+        const bool pair = y + 1 < height_;
+        const float* a_re = re + y * sw;
+        const float* a_im = im + y * sw;
+        const float* b_re = pair ? a_re + sw : nullptr;
+        const float* b_im = pair ? a_im + sw : nullptr;
+        for (size_t k = 0; k < w; ++k) {
+            const bool upper = k >= sw;
+            const size_t at = upper ? w - k : k;
+            const float sign = upper ? -1.0f : 1.0f;
+            float ar = a_re[at];
+            float ai = sign * a_im[at];
+            float br = pair ? b_re[at] : 0.0f;
+            float bi = pair ? sign * b_im[at] : 0.0f;
+            r_re[k] = ar - bi;
+            r_im[k] = ai + br;
+        }
+        rows_.inverse(r_re, r_im, 1, z_re, z_im);
+        float* a = plane + y * w;
+        for (size_t k = 0; k < w; ++k) {
+            a[k] = z_re[k] * scale;
+        }
+        if (pair) {
+            for (size_t k = 0; k < w; ++k) {
+                a[w + k] = z_im[k] * scale;
+            }
+        }
+    }
+}
+
+// PlanCache
+
+RealFFT2D* PlanCache::get(size_t width, size_t height) {
+    for (size_t i = 0; i < plans_.size(); ++i) {
+        if (plans_[i]->width() == width && plans_[i]->height() == height) {
+            std::rotate(plans_.begin(), plans_.begin() + i, plans_.begin() + i + 1);
+            return plans_.front().get();
+        }
+    }
+
+    std::unique_ptr<RealFFT2D> plan(new (std::nothrow) RealFFT2D());
+    if (!plan || !plan->init(width, height)) {
+        return nullptr;
+    }
+    if (plans_.size() == CAPACITY) {
+        plans_.pop_back();
+    }
+    plans_.insert(plans_.begin(), std::move(plan));
+    return plans_.front().get();
+}
+
+} // namespace fft
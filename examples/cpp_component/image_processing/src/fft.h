@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fft {
+
+// Smallest size >= n whose only prime factors are 2, 3 and 5
+size_t next_fast_size(size_t n);
+
+/**
+ * Complex FFT of one length on split real/imaginary arrays
+ *
+ * Mixed radix (4, 2, 3, 5) decimation in time: the input is gathered into
+ * digit-reversed order, then each stage runs radix-p butterflies in place.
+ * The permutation and every stage's twiddles are computed once by init().
+ * Stages with at least four butterflies per group run them four at a time
+ * with simd_*_f32. Unnormalized: inverse(forward(x)) is size() * x.
+ */
+class ComplexFFT {
+public:
+    // False (plan unusable) unless n is positive and 2,3,5-smooth
+    bool init(size_t n);
+    size_t size() const { return n_; }
+
+    // Input element i is in_re[i * in_stride]; output is contiguous and
+    // must not overlap the input
+    void forward(const float* in_re, const float* in_im, size_t in_stride, float* out_re, float* out_im) const;
+    void inverse(const float* in_re, const float* in_im, size_t in_stride, float* out_re, float* out_im) const;
+
+private:
+    struct Stage {
+        int radix;
+        size_t span;                // Butterflies per group: product of earlier radices
+        std::vector<float> tw_re;   // (radix - 1) rows of span twiddles
+        std::vector<float> tw_im;
+    };
+
+    size_t n_ = 0;
+    std::vector<uint32_t> permutation_;
+    std::vector<Stage> stages_;
+};
+
+/**
+ * 2D FFT of real width x height planes
+ *
+ * Spectra are stored as the half a real input determines: spectrum_width()
+ * = width / 2 + 1 columns by height rows, row-major, on split arrays. Rows
+ * are transformed two at a time as the real and imaginary parts of one
+ * complex FFT and then separated, and only the stored columns are
+ * transformed, so a real plane costs about half a complex one.
+ */
+class RealFFT2D {
+public:
+    bool init(size_t width, size_t height);
+
+    size_t width() const { return width_; }
+    size_t height() const { return height_; }
+    size_t spectrum_width() const { return width_ / 2 + 1; }
+    size_t spectrum_size() const { return spectrum_width() * height_; }
+
+    // plane: width * height floats; re / im: spectrum_size() floats each
+    void forward(const float* plane, float* re, float* im);
+    // Consumes re / im; scaled so that inverse(forward(x)) == x
+    void inverse(float* re, float* im, float* plane);
+
+private:
+    ComplexFFT rows_;
+    ComplexFFT columns_;
+    size_t width_ = 0;
+    size_t height_ = 0;
+    std::vector<float> work_;  // Four rows or columns of scratch
+};
+
+/**
+ * The last few RealFFT2D plans by size, so repeated frames of one size skip
+ * twiddle and permutation setup. Not thread safe; one cache per owner.
+ */
+class PlanCache {
+public:
+    static constexpr size_t CAPACITY = 4;
+
+    // Plan for width x height (both 2,3,5-smooth), or nullptr
+    RealFFT2D* get(size_t width, size_t height);
+
+private:
+    std::vector<std::unique_ptr<RealFFT2D>> plans_;  // Most recently used first
+};
+
+} // namespace fft
@@ -0,0 +1,2428 @@
+#include "filters.h"
+#include "fft.h"
+#include "worker_pool.h"
+
+#include <atomic>
+#include <cmath>
+
+namespace filters {
+
+namespace {
+
+// Half-open pixel rectangle [x0, x1) x [y0, y1)
+struct Rect {
+    int x0, y0, x1, y1;
+
+    int width() const { return x1 - x0; }
+    int height() const { return y1 - y0; }
+};
+
+Rect grow(const Rect& r, int dx, int dy, const Rect& bounds) {
+    return Rect{std::max(r.x0 - dx, bounds.x0), std::max(r.y0 - dy, bounds.y0),
+                std::min(r.x1 + dx, bounds.x1), std::min(r.y1 + dy, bounds.y1)};
+}
+
+inline int clamp_to(int v, int lo, int hi_exclusive) {
+    return v < lo ? lo : (v >= hi_exclusive ? hi_exclusive - 1 : v);
+}
+
+// The pixels of `area`, row-major with `stride` bytes per row. A whole image
+// and a tile buffer are both planes; a tile plane just covers less.
+struct SourcePlane {
+    const uint8_t* data;
+    Rect area;
+    size_t stride;
+    int channels;
+
+    const uint8_t* at(int x, int y) const {
+        return data + static_cast<size_t>(y - area.y0) * stride +
+               static_cast<size_t>(x - area.x0) * channels;
+    }
+};
+
+struct TargetPlane {
+    uint8_t* data;
+    Rect area;
+    size_t stride;
+    int channels;
+
+    uint8_t* at(int x, int y) const {
+        return data + static_cast<size_t>(y - area.y0) * stride +
+               static_cast<size_t>(x - area.x0) * channels;
+    }
+    SourcePlane as_source() const { return SourcePlane{data, area, stride, channels}; }
+};
+
+inline uint8_t to_u8(float v) {
+    return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, v)) + 0.5f);
+}
+
+// A chain step reduced to a neighborhood operation: each output pixel reads
+// only source pixels within radius_x / radius_y of it, clamped at the image
+// border. That bound is what lets a chain run tile by tile with halos.
+struct StepPlan {
+    enum class Kind { SEPARABLE, DENSE, EDGE_MAGNITUDE };
+
+    Kind kind = Kind::DENSE;
+    FilterType type = FilterType::BOX_BLUR;
+    int radius_x = 0;
+    int radius_y = 0;
+    std::vector<float> taps_x;  // SEPARABLE: 2 * radius_x + 1 taps
+    std::vector<float> taps_y;  // SEPARABLE: 2 * radius_y + 1 taps
+    std::vector<float> taps;    // DENSE: (2 * radius_y + 1) rows of (2 * radius_x + 1)
+    std::vector<uint16_t> fixed_x;  // SEPARABLE in Q8 (see use_fixed_point); integer path when set
+    std::vector<uint16_t> fixed_y;
+    float bias = 0.0f;
+    bool absolute = false;      // DENSE: magnitude of the response (derivative kernels)
+    float threshold = 0.0f;     // EDGE_MAGNITUDE: responses below it become 0
+    bool preserve_alpha = false;
+
+    bool fixed_point() const { return !fixed_x.empty(); }
+
+    // Scratch the step needs to produce `out`: one float accumulator row, plus
+    // the horizontal pass over the vertical halo for separable steps; fixed
+    // point needs a block of u8 rows padded by the horizontal radius
+    size_t scratch_bytes(const Rect& out, int channels) const;
+};
+
+// Output rows the fixed-point vertical pass produces per sweep of its source rows
+constexpr int FIXED_ROWS = 4;
+constexpr int FIXED_SHIFT = 8;  // Q8 taps: 255 * 256 still fits a u16 lane
+constexpr int FIXED_ONE = 1 << FIXED_SHIFT;
+
+size_t StepPlan::scratch_bytes(const Rect& out, int channels) const {
+    if (fixed_point()) {
+        return static_cast<size_t>(out.width() + 2 * radius_x) * FIXED_ROWS * channels;
+    }
+    size_t rows = kind == Kind::SEPARABLE ? out.height() + 2 * radius_y + 1
+                : kind == Kind::DENSE ? 1 : 0;
+    return static_cast<size_t>(out.width()) * rows * channels * sizeof(float);
+}
+
+inline bool keeps_alpha(const StepPlan& plan, int channels, int c) {
+    return plan.preserve_alpha && channels == 4 && c == 3;
+}
+
+// Row spans are filtered on every channel, then alpha is copied back
+inline void restore_alpha(const StepPlan& plan, const uint8_t* in, uint8_t* out, size_t n, int channels) {
+    if (keeps_alpha(plan, channels, 3)) {
+        for (size_t i = 3; i < n; i += 4) {
+            out[i] = in[i];
+        }
+    }
+}
+
+// Columns whose whole horizontal footprint lies inside the image; rows are
+// clamped uniformly, so only columns need a separate border path
+inline void interior_columns(const Rect& out_area, const Rect& image, int radius_x,
+                             int& inner_x0, int& inner_x1) {
+    inner_x0 = std::max(out_area.x0, image.x0 + radius_x);
+    inner_x1 = std::max(inner_x0, std::min(out_area.x1, image.x1 - radius_x));
+}
+
+void run_dense(const StepPlan& plan, const SourcePlane& src, const TargetPlane& dst,
+               const Rect& out_area, const Rect& image, float* scratch) {
+    const int channels = dst.channels;
+    const int rx = plan.radius_x;
+    const int ry = plan.radius_y;
+    const int span = 2 * rx + 1;
+    int inner_x0, inner_x1;
+    interior_columns(out_area, image, rx, inner_x0, inner_x1);
+
+    auto finish = [&plan](float sum) {
+        return to_u8((plan.absolute ? std::fabs(sum) : sum) + plan.bias);
+    };
+
+    for (int y = out_area.y0; y < out_area.y1; ++y) {
+        // Border columns, one pixel at a time with clamped taps
+        for (int x = out_area.x0; x < out_area.x1; ++x) {
+            if (x == inner_x0 && inner_x1 > inner_x0) {
+                x = inner_x1 - 1;
+                continue;
+            }
+            uint8_t* out = dst.at(x, y);
+            for (int c = 0; c < channels; ++c) {
+                if (keeps_alpha(plan, channels, c)) {
+                    out[c] = src.at(x, y)[c];
+                    continue;
+                }
+                float sum = 0.0f;
+                for (int ky = -ry; ky <= ry; ++ky) {
+                    int sy = clamp_to(y + ky, image.y0, image.y1);
+                    for (int kx = -rx; kx <= rx; ++kx) {
+                        int sx = clamp_to(x + kx, image.x0, image.x1);
+                        sum += plan.taps[(ky + ry) * span + kx + rx] * src.at(sx, sy)[c];
+                    }
+                }
+                out[c] = finish(sum);
+            }
+        }
+
+        // Interior span, tap by tap over the whole row (same tap order as above)
+        if (inner_x1 > inner_x0) {
+            size_t n = static_cast<size_t>(inner_x1 - inner_x0) * channels;
+            std::fill(scratch, scratch + n, 0.0f);
+            for (int ky = -ry; ky <= ry; ++ky) {
+                int sy = clamp_to(y + ky, image.y0, image.y1);
+                for (int kx = -rx; kx <= rx; ++kx) {
+                    float w = plan.taps[(ky + ry) * span + kx + rx];
+                    const uint8_t* px = src.at(inner_x0 + kx, sy);
+                    for (size_t i = 0; i < n; ++i) {
+                        scratch[i] += w * px[i];
+                    }
+                }
+            }
+            uint8_t* out = dst.at(inner_x0, y);
+            for (size_t i = 0; i < n; ++i) {
+                out[i] = finish(scratch[i]);
+            }
+            restore_alpha(plan, src.at(inner_x0, y), out, n, channels);
+        }
+    }
+}
+
+// Horizontal pass into float rows covering the vertical halo, then a vertical
+// pass one output row at a time. Interior spans run tap-major over whole rows
+// so the inner loops vectorize; columns near the image border clamp per tap.
+// Both accumulate taps in the same order, so results do not depend on which
+// pixels a tile happens to cover.
+void run_separable(const StepPlan& plan, const SourcePlane& src, const TargetPlane& dst,
+                   const Rect& out_area, const Rect& image, float* scratch) {
+    const int channels = dst.channels;
+    const int rx = plan.radius_x;
+    const int ry = plan.radius_y;
+    const Rect rows = grow(out_area, 0, ry, image);
+    const size_t row_floats = static_cast<size_t>(out_area.width()) * channels;
+    int inner_x0, inner_x1;
+    interior_columns(out_area, image, rx, inner_x0, inner_x1);
+
+    for (int y = rows.y0; y < rows.y1; ++y) {
+        float* tmp = scratch + (y - rows.y0) * row_floats;
+        for (int x = out_area.x0; x < out_area.x1; ++x) {
+            if (x == inner_x0 && inner_x1 > inner_x0) {
+                x = inner_x1 - 1;
+                continue;
+            }
+            float* t = tmp + static_cast<size_t>(x - out_area.x0) * channels;
+            for (int c = 0; c < channels; ++c) {
+                float sum = 0.0f;
+                for (int k = -rx; k <= rx; ++k) {
+                    int sx = clamp_to(x + k, image.x0, image.x1);
+                    sum += plan.taps_x[k + rx] * src.at(sx, y)[c];
+                }
+                t[c] = sum;
+            }
+        }
+        if (inner_x1 > inner_x0) {
+            float* t = tmp + static_cast<size_t>(inner_x0 - out_area.x0) * channels;
+            size_t n = static_cast<size_t>(inner_x1 - inner_x0) * channels;
+            std::fill(t, t + n, 0.0f);
+            for (int k = 0; k <= 2 * rx; ++k) {
+                float w = plan.taps_x[k];
+                const uint8_t* px = src.at(inner_x0 - rx + k, y);
+                for (size_t i = 0; i < n; ++i) {
+                    t[i] += w * px[i];
+                }
+            }
+        }
+    }
+
+    float* acc = scratch + static_cast<size_t>(rows.height()) * row_floats;
+    for (int y = out_area.y0; y < out_area.y1; ++y) {
+        std::fill(acc, acc + row_floats, 0.0f);
+        for (int k = -ry; k <= ry; ++k) {
+            float w = plan.taps_y[k + ry];
+            const float* tmp = scratch + (clamp_to(y + k, image.y0, image.y1) - rows.y0) * row_floats;
+            for (size_t i = 0; i < row_floats; ++i) {
+                acc[i] += w * tmp[i];
+            }
+        }
+
+        uint8_t* out = dst.at(out_area.x0, y);
+        for (size_t i = 0; i < row_floats; ++i) {
+            out[i] = to_u8(acc[i] + plan.bias);
+        }
+        restore_alpha(plan, src.at(out_area.x0, y), out, row_floats, channels);
+    }
+}
+
+// Q8 products of u8 samples, summed in u16 lanes and rounded back to u8.
+// Shared by the vector loops' tails and non-SIMD builds, so every lane
+// gets the same integer result either way.
+inline uint8_t fixed_round(uint32_t acc) {
+    return static_cast<uint8_t>((acc + FIXED_ONE / 2) >> FIXED_SHIFT);
+}
+
+// Vertical pass for `count` output rows: rows[s] is the source row for output
+// row s - radius_y, clamped. Each source row is loaded and widened once and
+// added into every output row it reaches.
+void fixed_vertical(const std::vector<uint16_t>& taps, const uint8_t* const* rows, int count,
+                    size_t n, uint8_t* const* out) {
+    const int span = static_cast<int>(taps.size());
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    const int sources = count + span - 1;
+    for (; i + 16 <= n; i += 16) {
+        v128_t low[FIXED_ROWS];
+        v128_t high[FIXED_ROWS];
+        for (int j = 0; j < count; ++j) {
+            low[j] = simd_utils::simd_splat_u16(0);
+            high[j] = low[j];
+        }
+        for (int s = 0; s < sources; ++s) {
+            v128_t v = simd_utils::simd_load_unaligned(rows[s] + i);
+            v128_t v_low = simd_utils::simd_convert_u8_to_u16_low(v);
+            v128_t v_high = simd_utils::simd_convert_u8_to_u16_high(v);
+            for (int j = std::max(0, s - span + 1); j <= std::min(count - 1, s); ++j) {
+                v128_t w = simd_utils::simd_splat_u16(taps[s - j]);
+                low[j] = simd_utils::simd_add_u16(low[j], simd_utils::simd_mul_u16(v_low, w));
+                high[j] = simd_utils::simd_add_u16(high[j], simd_utils::simd_mul_u16(v_high, w));
+            }
+        }
+        v128_t round = simd_utils::simd_splat_u16(FIXED_ONE / 2);
+        for (int j = 0; j < count; ++j) {
+            v128_t lo = simd_utils::simd_shr_u16(simd_utils::simd_add_u16(low[j], round), FIXED_SHIFT);
+            v128_t hi = simd_utils::simd_shr_u16(simd_utils::simd_add_u16(high[j], round), FIXED_SHIFT);
+            simd_utils::simd_store_unaligned(out[j] + i, simd_utils::simd_convert_u16_to_u8(lo, hi));
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        for (int j = 0; j < count; ++j) {
+            uint32_t acc = 0;
+            for (int k = 0; k < span; ++k) {
+                acc += taps[k] * rows[j + k][i];
+            }
+            out[j][i] = fixed_round(acc);
+        }
+    }
+}
+
+// Horizontal pass over a row padded by the radius on both sides; the taps
+// are unaligned loads at channel-sized offsets into it
+void fixed_horizontal(const std::vector<uint16_t>& taps, const uint8_t* in, int channels,
+                      size_t n, uint8_t* out) {
+    const int span = static_cast<int>(taps.size());
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    v128_t round = simd_utils::simd_splat_u16(FIXED_ONE / 2);
+    for (; i + 16 <= n; i += 16) {
+        v128_t low = round;
+        v128_t high = round;
+        for (int k = 0; k < span; ++k) {
+            v128_t v = simd_utils::simd_load_unaligned(in + i + static_cast<size_t>(k) * channels);
+            v128_t w = simd_utils::simd_splat_u16(taps[k]);
+            low = simd_utils::simd_add_u16(low, simd_utils::simd_mul_u16(simd_utils::simd_convert_u8_to_u16_low(v), w));
+            high = simd_utils::simd_add_u16(high, simd_utils::simd_mul_u16(simd_utils::simd_convert_u8_to_u16_high(v), w));
+        }
+        simd_utils::simd_store_unaligned(out + i, simd_utils::simd_convert_u16_to_u8(
+            simd_utils::simd_shr_u16(low, FIXED_SHIFT), simd_utils::simd_shr_u16(high, FIXED_SHIFT)));
+    }
+#endif
+    for (; i < n; ++i) {
+        uint32_t acc = 0;
+        for (int k = 0; k < span; ++k) {
+            acc += taps[k] * in[i + static_cast<size_t>(k) * channels];
+        }
+        out[i] = fixed_round(acc);
+    }
+}
+
+// Separable step in Q8 fixed point: vertical first, FIXED_ROWS output rows
+// per sweep so the vertical taps share their loads, into u8 rows that cover
+// the horizontal halo; border columns are replicated into the padding rather
+// than clamped per tap. Both passes round to u8, and the integer math is
+// identical across tiles, bands and the SIMD/scalar split.
+void run_separable_fixed(const StepPlan& plan, const SourcePlane& src, const TargetPlane& dst,
+                         const Rect& out_area, const Rect& image, uint8_t* scratch) {
+    const int channels = dst.channels;
+    const int rx = plan.radius_x;
+    const int ry = plan.radius_y;
+    const Rect cols = grow(out_area, rx, 0, image);
+    const size_t padded_bytes = static_cast<size_t>(out_area.width() + 2 * rx) * channels;
+    const size_t col_offset = static_cast<size_t>(cols.x0 - (out_area.x0 - rx)) * channels;
+    const size_t col_bytes = static_cast<size_t>(cols.width()) * channels;
+    const size_t out_bytes = static_cast<size_t>(out_area.width()) * channels;
+
+    std::vector<const uint8_t*> rows(FIXED_ROWS + 2 * ry);
+    uint8_t* padded[FIXED_ROWS];
+    uint8_t* vertical[FIXED_ROWS];
+    for (int j = 0; j < FIXED_ROWS; ++j) {
+        padded[j] = scratch + j * padded_bytes;
+        vertical[j] = padded[j] + col_offset;
+    }
+
+    for (int y0 = out_area.y0; y0 < out_area.y1; y0 += FIXED_ROWS) {
+        const int count = std::min(FIXED_ROWS, out_area.y1 - y0);
+        for (int s = 0; s < count + 2 * ry; ++s) {
+            rows[s] = src.at(cols.x0, clamp_to(y0 - ry + s, image.y0, image.y1));
+        }
+        fixed_vertical(plan.fixed_y, rows.data(), count, col_bytes, vertical);
+
+        for (int j = 0; j < count; ++j) {
+            const uint8_t* first = vertical[j];
+            const uint8_t* last = vertical[j] + col_bytes - channels;
+            for (uint8_t* p = padded[j]; p < vertical[j]; p += channels) {
+                std::copy(first, first + channels, p);
+            }
+            for (uint8_t* p = vertical[j] + col_bytes; p < padded[j] + padded_bytes; p += channels) {
+                std::copy(last, last + channels, p);
+            }
+
+            uint8_t* out = dst.at(out_area.x0, y0 + j);
+            fixed_horizontal(plan.fixed_x, padded[j], channels, out_bytes, out);
+            restore_alpha(plan, src.at(out_area.x0, y0 + j), out, out_bytes, channels);
+        }
+    }
+}
+
+inline uint8_t edge_value(int gx, int gy, float threshold) {
+    float magnitude = std::sqrt(static_cast<float>(gx * gx + gy * gy));
+    return magnitude < threshold ? 0 : to_u8(magnitude);
+}
+
+// Sobel gradient magnitude; integer gradients, so both paths agree exactly
+void run_edge_magnitude(const StepPlan& plan, const SourcePlane& src, const TargetPlane& dst,
+                        const Rect& out_area, const Rect& image) {
+    static const int SOBEL_X[9] = {-1, 0, 1, -2, 0, 2, -1, 0, 1};
+    static const int SOBEL_Y[9] = {-1, -2, -1, 0, 0, 0, 1, 2, 1};
+    const int channels = dst.channels;
+    int inner_x0, inner_x1;
+    interior_columns(out_area, image, 1, inner_x0, inner_x1);
+
+    for (int y = out_area.y0; y < out_area.y1; ++y) {
+        int rows[3] = {clamp_to(y - 1, image.y0, image.y1), y, clamp_to(y + 1, image.y0, image.y1)};
+        for (int x = out_area.x0; x < out_area.x1; ++x) {
+            if (x == inner_x0 && inner_x1 > inner_x0) {
+                x = inner_x1 - 1;
+                continue;
+            }
+            int cols[3] = {clamp_to(x - 1, image.x0, image.x1), x, clamp_to(x + 1, image.x0, image.x1)};
+            uint8_t* out = dst.at(x, y);
+            for (int c = 0; c < channels; ++c) {
+                if (keeps_alpha(plan, channels, c)) {
+                    out[c] = src.at(x, y)[c];
+                    continue;
+                }
+                int gx = 0;
+                int gy = 0;
+                for (int k = 0; k < 9; ++k) {
+                    int v = src.at(cols[k % 3], rows[k / 3])[c];
+                    gx += SOBEL_X[k] * v;
+                    gy += SOBEL_Y[k] * v;
+                }
+                out[c] = edge_value(gx, gy, plan.threshold);
+            }
+        }
+
+        if (inner_x1 > inner_x0) {
+            size_t n = static_cast<size_t>(inner_x1 - inner_x0) * channels;
+            const uint8_t* above = src.at(inner_x0, rows[0]);
+            const uint8_t* center = src.at(inner_x0, rows[1]);
+            const uint8_t* below = src.at(inner_x0, rows[2]);
+            uint8_t* out = dst.at(inner_x0, y);
+            for (size_t i = 0; i < n; ++i) {
+                size_t l = i - channels;
+                size_t r = i + channels;
+                int gx = (above[r] - above[l]) + 2 * (center[r] - center[l]) + (below[r] - below[l]);
+                int gy = (below[l] + 2 * below[i] + below[r]) - (above[l] + 2 * above[i] + above[r]);
+                out[i] = edge_value(gx, gy, plan.threshold);
+            }
+            restore_alpha(plan, center, out, n, channels);
+        }
+    }
+}
+
+// Computes out_area (inside dst.area) from src, which must cover out_area
+// grown by the plan's radii and clipped to the image
+void run_step(const StepPlan& plan, const SourcePlane& src, const TargetPlane& dst,
+              const Rect& out_area, const Rect& image, float* scratch) {
+    switch (plan.kind) {
+        case StepPlan::Kind::SEPARABLE:
+            if (plan.fixed_point()) {
+                run_separable_fixed(plan, src, dst, out_area, image, reinterpret_cast<uint8_t*>(scratch));
+            } else {
+                run_separable(plan, src, dst, out_area, image, scratch);
+            }
+            break;
+        case StepPlan::Kind::EDGE_MAGNITUDE:
+            run_edge_magnitude(plan, src, dst, out_area, image);
+            break;
+        case StepPlan::Kind::DENSE:
+            run_dense(plan, src, dst, out_area, image, scratch);
+            break;
+    }
+}
+
+std::vector<float> box_taps(int radius) {
+    return std::vector<float>(2 * radius + 1, 1.0f / (2 * radius + 1));
+}
+
+std::vector<float> gaussian_taps(int radius, float sigma) {
+    std::vector<float> taps(2 * radius + 1);
+    float sum = 0.0f;
+    for (int i = -radius; i <= radius; ++i) {
+        taps[i + radius] = std::exp(-(i * i) / (2.0f * sigma * sigma));
+        sum += taps[i + radius];
+    }
+    for (float& t : taps) {
+        t /= sum;
+    }
+    return taps;
+}
+
+// Odd-sized kernels only; the anchor is the center tap
+bool plan_kernel(const ConvolutionKernel& kernel, bool absolute, StepPlan& plan) {
+    if (kernel.width <= 0 || kernel.height <= 0 || kernel.width % 2 == 0 || kernel.height % 2 == 0 ||
+        kernel.data.size() != static_cast<size_t>(kernel.width) * kernel.height) {
+        return false;
+    }
+
+    float scale = kernel.scale;
+    if (kernel.normalize) {
+        float sum = 0.0f;
+        for (float t : kernel.data) sum += t;
+        if (sum != 0.0f) scale /= sum;
+    }
+
+    plan.kind = StepPlan::Kind::DENSE;
+    plan.radius_x = kernel.width / 2;
+    plan.radius_y = kernel.height / 2;
+    plan.taps = kernel.data;
+    for (float& t : plan.taps) {
+        t *= scale;
+    }
+    plan.bias = kernel.bias;
+    plan.absolute = absolute;
+    return true;
+}
+
+bool plan_separable(const std::vector<float>& h_kernel, const std::vector<float>& v_kernel,
+                    StepPlan& plan) {
+    if (h_kernel.size() % 2 == 0 || v_kernel.size() % 2 == 0) {
+        return false;
+    }
+    plan.kind = StepPlan::Kind::SEPARABLE;
+    plan.radius_x = static_cast<int>(h_kernel.size() / 2);
+    plan.radius_y = static_cast<int>(v_kernel.size() / 2);
+    plan.taps_x = h_kernel;
+    plan.taps_y = v_kernel;
+    return true;
+}
+
+// Q8 taps summing to exactly FIXED_ONE, from rounded prefix sums so the
+// rounding error never accumulates across the kernel. False for kernels the
+// u16 lanes cannot represent: negative taps or a sum other than 1.
+bool quantize_taps(const std::vector<float>& taps, std::vector<uint16_t>& fixed) {
+    double sum = 0.0;
+    for (float t : taps) {
+        if (t < 0.0f) return false;
+        sum += t;
+    }
+    if (std::fabs(sum - 1.0) > 1e-3) {
+        return false;
+    }
+    fixed.resize(taps.size());
+    double prefix = 0.0;
+    long previous = 0;
+    for (size_t k = 0; k < taps.size(); ++k) {
+        prefix += taps[k] / sum;
+        long rounded = std::lround(prefix * FIXED_ONE);
+        fixed[k] = static_cast<uint16_t>(rounded - previous);
+        previous = rounded;
+    }
+    return true;
+}
+
+// Drops outer taps that quantized to zero in pairs, keeping the kernel centered
+int trim_fixed_taps(std::vector<uint16_t>& fixed) {
+    size_t drop = 0;
+    while (fixed.size() > 2 * drop + 1 && fixed[drop] == 0 && fixed[fixed.size() - 1 - drop] == 0) {
+        drop++;
+    }
+    fixed.erase(fixed.end() - drop, fixed.end());
+    fixed.erase(fixed.begin(), fixed.begin() + drop);
+    return static_cast<int>(fixed.size() / 2);
+}
+
+// Switches a separable blur (non-negative taps, no bias) to the fixed-point
+// path. Results then differ from the float path by at most a level or two;
+// plans that do not qualify stay in float.
+void use_fixed_point(StepPlan& plan) {
+    if (plan.kind != StepPlan::Kind::SEPARABLE || plan.bias != 0.0f ||
+        !quantize_taps(plan.taps_x, plan.fixed_x) || !quantize_taps(plan.taps_y, plan.fixed_y)) {
+        plan.fixed_x.clear();
+        plan.fixed_y.clear();
+        return;
+    }
+    plan.radius_x = trim_fixed_taps(plan.fixed_x);
+    plan.radius_y = trim_fixed_taps(plan.fixed_y);
+}
+
+// Neighborhood filters become plans; anything else runs outside the engine.
+// With fixed_point, blurs take the Q8 path (see use_fixed_point).
+bool plan_filter(const FilterParams& params, bool fixed_point, StepPlan& plan) {
+    plan = StepPlan();
+    plan.type = params.type;
+    plan.preserve_alpha = params.preserve_alpha;
+
+    int radius = std::max(1, static_cast<int>(std::lround(params.radius)));
+    switch (params.type) {
+        case FilterType::BOX_BLUR:
+            plan_separable(box_taps(radius), box_taps(radius), plan);
+            if (fixed_point) use_fixed_point(plan);
+            return true;
+        case FilterType::GAUSSIAN_BLUR: {
+            float sigma = params.sigma > 0.0f ? params.sigma : std::max(0.5f, radius / 2.0f);
+            std::vector<float> taps = gaussian_taps(radius, sigma);
+            plan_separable(taps, taps, plan);
+            if (fixed_point) use_fixed_point(plan);
+            return true;
+        }
+        case FilterType::SHARPEN:
+            return plan_kernel(FilterProcessor::create_sharpen_kernel(params.strength), false, plan);
+        case FilterType::EMBOSS: {
+            // Strength scales the relief around the identity center tap
+            ConvolutionKernel kernel = FilterProcessor::create_emboss_kernel();
+            for (int i = 0; i < 9; ++i) {
+                if (i != 4) kernel.data[i] *= params.strength;
+            }
+            return plan_kernel(kernel, false, plan);
+        }
+        case FilterType::SOBEL_X:
+            return plan_kernel(FilterProcessor::create_sobel_x_kernel(), true, plan);
+        case FilterType::SOBEL_Y:
+            return plan_kernel(FilterProcessor::create_sobel_y_kernel(), true, plan);
+        case FilterType::LAPLACIAN:
+            return plan_kernel(FilterProcessor::create_laplacian_kernel(), true, plan);
+        case FilterType::EDGE_DETECT:
+            plan.kind = StepPlan::Kind::EDGE_MAGNITUDE;
+            plan.radius_x = 1;
+            plan.radius_y = 1;
+            plan.threshold = params.threshold * 255.0f;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Runs steps [0, count) from src into output rows [row_begin, row_end) of dst
+ * one output tile at a time.
+ *
+ * For a tile T, step i produces T grown by the radii of the steps after it,
+ * so the last step produces exactly T. Intermediates ping-pong between two
+ * tile buffers; only dst is image sized. Every pixel is computed by the same
+ * arithmetic as a whole-image pass, so neither the tile size nor the row
+ * range changes results.
+ */
+bool execute_tiled(const StepPlan* steps, size_t count, const uint8_t* src, uint8_t* dst,
+                   uint32_t width, uint32_t height, int channels,
+                   uint32_t tile_width, uint32_t tile_height, int row_begin, int row_end) {
+    const Rect image{0, 0, static_cast<int>(width), static_cast<int>(height)};
+    const int tile_w = static_cast<int>(std::min(tile_width, width));
+    const int tile_h = static_cast<int>(std::min(tile_height, height));
+
+    // halo[i]: how far step i's output must extend past the tile
+    std::vector<std::pair<int, int>> halo(count);
+    int hx = 0;
+    int hy = 0;
+    for (size_t i = count; i-- > 0;) {
+        halo[i] = {hx, hy};
+        hx += steps[i].radius_x;
+        hy += steps[i].radius_y;
+    }
+
+    // Worst-case buffer sizes over a full interior tile
+    size_t buffer_bytes = 0;
+    size_t float_bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Rect out{0, 0, tile_w + 2 * halo[i].first, tile_h + 2 * halo[i].second};
+        if (i + 1 < count) {
+            buffer_bytes = std::max(buffer_bytes, static_cast<size_t>(out.width()) * out.height() * channels);
+        }
+        float_bytes = std::max(float_bytes, steps[i].scratch_bytes(out, channels));
+    }
+    buffer_bytes = simd_utils::align_size(buffer_bytes);
+
+    simd_utils::PoolArray<uint8_t> scratch;
+    if (!scratch.resize(2 * buffer_bytes + float_bytes)) {
+        return false;
+    }
+    uint8_t* buffers[2] = {scratch.data(), scratch.data() + buffer_bytes};
+    float* floats = reinterpret_cast<float*>(scratch.data() + 2 * buffer_bytes);
+
+    const size_t image_stride = static_cast<size_t>(width) * channels;
+    const SourcePlane image_src{src, image, image_stride, channels};
+    const TargetPlane image_dst{dst, image, image_stride, channels};
+
+    for (int ty = row_begin; ty < row_end; ty += tile_h) {
+        for (int tx = 0; tx < image.x1; tx += tile_w) {
+            const Rect tile{tx, ty, std::min(tx + tile_w, image.x1), std::min(ty + tile_h, row_end)};
+            SourcePlane input = image_src;
+            for (size_t i = 0; i < count; ++i) {
+                Rect out = grow(tile, halo[i].first, halo[i].second, image);
+                TargetPlane target = i + 1 == count
+                    ? image_dst
+                    : TargetPlane{buffers[i % 2], out, static_cast<size_t>(out.width()) * channels, channels};
+                run_step(steps[i], input, target, out, image, floats);
+                input = target.as_source();
+            }
+        }
+    }
+    return true;
+}
+
+// execute_tiled over the whole image, split into row bands across up to
+// `threads` threads. Bands only share src and disjoint rows of dst.
+bool execute_banded(const StepPlan* steps, size_t count, const uint8_t* src, uint8_t* dst,
+                    uint32_t width, uint32_t height, int channels,
+                    uint32_t tile_width, uint32_t tile_height, unsigned threads) {
+    if (threads <= 1) {
+        return execute_tiled(steps, count, src, dst, width, height, channels, tile_width, tile_height,
+                             0, static_cast<int>(height));
+    }
+    std::atomic<bool> ok(true);
+    worker_pool::WorkerPool::shared().parallel_for(
+        height, tile_height, threads, [&](size_t begin, size_t end) {
+            if (!execute_tiled(steps, count, src, dst, width, height, channels, tile_width, tile_height,
+                               static_cast<int>(begin), static_cast<int>(end))) {
+                ok.store(false);
+            }
+        });
+    return ok.load();
+}
+
+// Rows per strip when filters run one at a time over the whole image
+uint32_t strip_rows(const StepPlan& plan) {
+    return static_cast<uint32_t>(std::max(64, 8 * plan.radius_y));
+}
+
+bool valid_image(const uint8_t* src, uint32_t width, uint32_t height, int channels) {
+    return src && width > 0 && height > 0 && channels >= 1 && channels <= 4 &&
+           static_cast<uint64_t>(width) * height * channels <= SIZE_MAX / 2;
+}
+
+FilterResult failure(uint32_t width, uint32_t height, int channels, const char* message) {
+    FilterResult result{};
+    result.success = false;
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.error_message = message;
+    return result;
+}
+
+// Rank filters (Perreault & Hebert): a 256-bin histogram per image column
+// covers the window's rows and slides down one row at a time; the window
+// histogram slides right by adding one column histogram and subtracting
+// another. Both updates cost the same at any radius. Each histogram keeps 16
+// coarse bins ahead of the 256 fine ones, so a rank query scans at most
+// 16 + 16 bins.
+
+constexpr int RANK_COARSE = 16;
+constexpr int RANK_BINS = RANK_COARSE + 256;
+constexpr uint32_t MAX_RANK_SAMPLES = 65535;  // Window counts are u16 lanes
+
+// Pixels before and after the center in each direction; clipped at the border
+struct RankWindow {
+    int left, right, up, down;
+
+    uint32_t samples() const { return static_cast<uint32_t>(left + right + 1) * (up + down + 1); }
+};
+
+inline void histogram_add(uint16_t* hist, const uint16_t* column) {
+#if SIMD_SUPPORTED
+    for (int i = 0; i < RANK_BINS; i += 8) {
+        simd_utils::simd_store_unaligned(hist + i, simd_utils::simd_add_u16(
+            simd_utils::simd_load_unaligned(hist + i), simd_utils::simd_load_unaligned(column + i)));
+    }
+#else
+    for (int i = 0; i < RANK_BINS; ++i) {
+        hist[i] = static_cast<uint16_t>(hist[i] + column[i]);
+    }
+#endif
+}
+
+inline void histogram_sub(uint16_t* hist, const uint16_t* column) {
+#if SIMD_SUPPORTED
+    for (int i = 0; i < RANK_BINS; i += 8) {
+        simd_utils::simd_store_unaligned(hist + i, simd_utils::simd_sub_u16(
+            simd_utils::simd_load_unaligned(hist + i), simd_utils::simd_load_unaligned(column + i)));
+    }
+#else
+    for (int i = 0; i < RANK_BINS; ++i) {
+        hist[i] = static_cast<uint16_t>(hist[i] - column[i]);
+    }
+#endif
+}
+
+inline void histogram_count(uint16_t* hist, uint8_t value, int delta) {
+    hist[value >> 4] = static_cast<uint16_t>(hist[value >> 4] + delta);
+    hist[RANK_COARSE + value] = static_cast<uint16_t>(hist[RANK_COARSE + value] + delta);
+}
+
+// Value of 0-based rank `rank`, which must be below the histogram's total
+inline uint8_t histogram_rank(const uint16_t* hist, uint32_t rank) {
+    int coarse = 0;
+    while (rank >= hist[coarse]) {
+        rank -= hist[coarse++];
+    }
+    const uint16_t* fine = hist + RANK_COARSE + coarse * 16;
+    int bin = 0;
+    while (rank >= fine[bin]) {
+        rank -= fine[bin++];
+    }
+    return static_cast<uint8_t>(coarse * 16 + bin);
+}
+
+// Rows [y0, y1) of dst: each sample becomes the value at `percentile`
+// (0 = min, 0.5 = median, 1 = max) of its clipped window, picking index
+// floor(percentile * n) of the n sorted samples. Alpha is copied when
+// keep_alpha; window.samples() must not exceed MAX_RANK_SAMPLES.
+void rank_rows(const uint8_t* src, uint8_t* dst, int width, int height, int channels,
+               const RankWindow& window, float percentile, bool keep_alpha, int y0, int y1) {
+    const size_t stride = static_cast<size_t>(width) * channels;
+    simd_utils::PoolArray<uint16_t> columns(static_cast<size_t>(width) * RANK_BINS, 0);
+    alignas(16) uint16_t hist[RANK_BINS];
+
+    for (int c = 0; c < channels; ++c) {
+        if (keep_alpha && channels == 4 && c == 3) {
+            for (int y = y0; y < y1; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    dst[y * stride + static_cast<size_t>(x) * 4 + 3] = src[y * stride + static_cast<size_t>(x) * 4 + 3];
+                }
+            }
+            continue;
+        }
+
+        auto count_row = [&](int y, int delta) {
+            const uint8_t* row = src + y * stride + c;
+            for (int x = 0; x < width; ++x) {
+                histogram_count(&columns[static_cast<size_t>(x) * RANK_BINS], row[static_cast<size_t>(x) * channels], delta);
+            }
+        };
+        // Start from the window of row y0 - 1 (and below, of column -1), so
+        // every step is one add and one remove
+        std::fill(columns.begin(), columns.end(), 0);
+        for (int y = std::max(0, y0 - 1 - window.up); y < std::min(height, y0 + window.down); ++y) {
+            count_row(y, 1);
+        }
+
+        for (int y = y0; y < y1; ++y) {
+            if (y - window.up - 1 >= 0) count_row(y - window.up - 1, -1);
+            if (y + window.down < height) count_row(y + window.down, 1);
+            const uint32_t rows = std::min(height - 1, y + window.down) - std::max(0, y - window.up) + 1;
+
+            std::fill(hist, hist + RANK_BINS, 0);
+            for (int x = 0; x < std::min(width, window.right); ++x) {
+                histogram_add(hist, &columns[static_cast<size_t>(x) * RANK_BINS]);
+            }
+            uint8_t* out = dst + y * stride + c;
+            for (int x = 0; x < width; ++x) {
+                if (x + window.right < width) histogram_add(hist, &columns[static_cast<size_t>(x + window.right) * RANK_BINS]);
+                if (x - window.left - 1 >= 0) histogram_sub(hist, &columns[static_cast<size_t>(x - window.left - 1) * RANK_BINS]);
+                const uint32_t cols = std::min(width - 1, x + window.right) - std::max(0, x - window.left) + 1;
+                const uint32_t n = rows * cols;
+                const uint32_t rank = std::min(n - 1, static_cast<uint32_t>(percentile * n));
+                out[static_cast<size_t>(x) * channels] = histogram_rank(hist, rank);
+            }
+        }
+    }
+}
+
+// Summed-area tables
+
+// Table bytes per strip or tile; larger images are covered in pieces, each
+// rebuilt with its halo
+constexpr size_t SAT_BYTES = size_t(8) << 20;
+// Box blurs from this radius use a table; below it the separable passes are cheaper
+constexpr int SAT_MIN_BOX_RADIUS = 4;
+// Squared sums of a (2r + 1)^2 window stay exact up to this radius
+constexpr int MAX_SAT_RADIUS = 127;
+// Plain sums of a (2r + 1)^2 window stay exact up to this radius
+constexpr int MAX_SAT_BOX_RADIUS = 2047;
+constexpr int MAX_OIL_LEVELS = 64;
+constexpr int DEFAULT_OIL_LEVELS = 20;  // Through apply_filter, which has no level parameter
+
+// Box blurs apply_filter runs on a table; their rounding differs from the
+// separable plan's, so FilterChain never fuses them into a tiled run
+bool box_blur_uses_sat(const FilterParams& params) {
+    const int radius = std::max(1, static_cast<int>(std::lround(params.radius)));
+    return params.type == FilterType::BOX_BLUR && radius >= SAT_MIN_BOX_RADIUS &&
+           radius <= MAX_SAT_BOX_RADIUS;
+}
+
+// Summed-area table (integral image) of `rows` rows of `width` pixels:
+// entry (x, y) per channel is the sum of the samples above row y and left of
+// column x, so a box sum of any size is four lookups. Entries wrap modulo
+// 2^32, which the box differences undo exactly while the box's true sum fits:
+// up to 2^32 / 255 samples for sums, 2^32 / 255^2 (66051) for squares.
+// Each row is a SIMD column accumulation and a SIMD prefix sum.
+class IntegralImage {
+public:
+    // row(i) returns the width * channels samples of local row i; `pad`
+    // columns on each side repeat the edge pixels
+    template <class RowSource>
+    void build(int width, int rows, int channels, int pad, bool squares, RowSource row) {
+        channels_ = channels;
+        pad_ = pad;
+        stride_ = static_cast<size_t>(width + 2 * pad + 1) * channels;
+        const size_t samples = stride_ - channels;
+        sums_.resize(stride_ * (rows + 1));
+        squares_.resize(squares ? sums_.size() : 0);
+        column_sums_.assign(samples, 0);
+        column_squares_.assign(squares ? samples : 0, 0);
+        std::fill(sums_.begin(), sums_.begin() + stride_, 0u);
+        std::fill(squares_.begin(), squares_.begin() + (squares ? stride_ : 0), 0u);
+
+        for (int i = 0; i < rows; ++i) {
+            const uint8_t* samples_in = row(i);
+            if (pad > 0) {
+                padded_.resize(samples);
+                const size_t edge = static_cast<size_t>(pad) * channels;
+                std::copy(samples_in, samples_in + samples - 2 * edge, padded_.begin() + edge);
+                for (int p = 0; p < pad; ++p) {
+                    std::copy(samples_in, samples_in + channels, padded_.begin() + p * channels);
+                    std::copy(samples_in + samples - 2 * edge - channels, samples_in + samples - 2 * edge,
+                              padded_.end() - static_cast<size_t>(p + 1) * channels);
+                }
+                samples_in = padded_.data();
+            }
+            simd_utils::simd_accumulate_columns(samples_in, samples, column_sums_.data(),
+                                                squares ? column_squares_.data() : nullptr);
+            const size_t pixels = samples / channels;
+            simd_utils::simd_prefix_sum_u32(column_sums_.data(), pixels, channels, &sums_[stride_ * (i + 1)]);
+            if (squares) {
+                simd_utils::simd_prefix_sum_u32(column_squares_.data(), pixels, channels,
+                                                &squares_[stride_ * (i + 1)]);
+            }
+        }
+    }
+
+    // Table row i (0 to rows); column x (-pad to width + pad) starts at offset(x)
+    const uint32_t* sums(int i) const { return &sums_[stride_ * i]; }
+    const uint32_t* squares(int i) const { return &squares_[stride_ * i]; }
+    size_t offset(int x) const { return static_cast<size_t>(x + pad_) * channels_; }
+
+private:
+    int channels_ = 0;
+    int pad_ = 0;
+    size_t stride_ = 0;
+    simd_utils::PoolArray<uint32_t> sums_;
+    simd_utils::PoolArray<uint32_t> squares_;
+    simd_utils::PoolArray<uint32_t> column_sums_;
+    simd_utils::PoolArray<uint32_t> column_squares_;
+    simd_utils::PoolArray<uint8_t> padded_;
+};
+
+// Sample k of a box between table rows top and bottom, columns at offsets left and right
+inline uint32_t box_sum(const uint32_t* top, const uint32_t* bottom, size_t left, size_t right, int k) {
+    return bottom[right + k] - bottom[left + k] - top[right + k] + top[left + k];
+}
+
+// Output rows per strip whose table, halo rows included, fits SAT_BYTES;
+// never fewer than the halo, so halos at most double the build work
+int sat_strip_rows(size_t table_row_bytes, int halo) {
+    const int rows = static_cast<int>(SAT_BYTES / std::max<size_t>(table_row_bytes, 1)) - halo;
+    return std::max({rows, halo, 8});
+}
+
+// Bilateral grid
+
+// Cells narrower than this many pixels save too little over the exact filter
+constexpr float MIN_BILATERAL_GRID_PIXELS = 2.0f;
+// Coarser than two sigmas per cell the blur in the grid is under one cell
+constexpr float MAX_BILATERAL_GRID_CELL = 2.0f;
+// 256 MB over both grids; finer grids fall back to the exact filter
+constexpr size_t MAX_BILATERAL_GRID_CELLS = size_t(16) << 20;
+
+// Elements [i0, i1) of out = the Gaussian taps over elements of in, each
+// element `span` contiguous floats; taps past either end are dropped
+void blur_span(const float* in, float* out, int count, size_t span, int i0, int i1,
+               const std::vector<float>& taps) {
+    const int pad = static_cast<int>(taps.size() / 2);
+    for (int i = i0; i < i1; ++i) {
+        float* target = out + i * span;
+        std::fill(target, target + span, 0.0f);
+        for (int k = std::max(-pad, -i); k <= std::min(pad, count - 1 - i); ++k) {
+            const float tap = taps[k + pad];
+            const float* source = in + (i + k) * span;
+            for (size_t j = 0; j < span; ++j) {
+                target[j] += tap * source[j];
+            }
+        }
+    }
+}
+
+// Frequency domain
+
+// Taps per log2 of the padded plane size at which one spatial tap per pixel
+// costs about as much as a forward and inverse real FFT (measured natively)
+constexpr double FFT_TAPS_PER_LOG2 = 4.0;
+// Minimum padding around planes filtered in frequency, against wrap-around
+constexpr int FREQUENCY_MARGIN = 16;
+
+// Channel c of an image into a padded_w x padded_h plane. Each padding band
+// repeats the near edge for its first half and the far edge for the rest, so
+// the periodic image the FFT sees has no seam, and the first pad / 2 pixels
+// past either edge match the spatial filters' clamped border.
+void load_plane(const uint8_t* src, int width, int height, int channels, int c,
+                size_t padded_w, size_t padded_h, float* plane) {
+    auto source = [](size_t i, int n, size_t padded) -> int {
+        if (i < static_cast<size_t>(n)) return static_cast<int>(i);
+        return i - n < (padded - n + 1) / 2 ? n - 1 : 0;
+    };
+    for (size_t y = 0; y < padded_h; ++y) {
+        const uint8_t* row = src + static_cast<size_t>(source(y, height, padded_h)) * width * channels + c;
+        float* out = plane + y * padded_w;
+        for (size_t x = 0; x < padded_w; ++x) {
+            out[x] = row[static_cast<size_t>(source(x, width, padded_w)) * channels];
+        }
+    }
+}
+
+// Dense kernels go through the FFT once the spatial work, spread over its
+// threads, outgrows a forward and inverse transform
+bool fft_is_cheaper(const StepPlan& plan, uint32_t width, uint32_t height, unsigned threads,
+                    size_t padded_w, size_t padded_h) {
+    double taps = static_cast<double>(2 * plan.radius_x + 1) * (2 * plan.radius_y + 1);
+    double spatial = taps * width * height / std::max(threads, 1u);
+    double padded = static_cast<double>(padded_w) * padded_h;
+    return spatial > FFT_TAPS_PER_LOG2 * padded * std::log2(padded);
+}
+
+// A DENSE plan as one spectrum product: the kernel is laid out flipped and
+// wrapped around the origin, so the circular convolution computes the same
+// correlation as run_dense. False (caller falls back) without a plan.
+bool fft_convolution(const StepPlan& plan, const uint8_t* src, uint32_t width, uint32_t height,
+                     int channels, size_t padded_w, size_t padded_h, fft::PlanCache& cache,
+                     uint8_t* dst) {
+    fft::RealFFT2D* fft = cache.get(padded_w, padded_h);
+    if (!fft) {
+        return false;
+    }
+    const size_t bins = fft->spectrum_size();
+    simd_utils::PoolArray<float> plane(padded_w * padded_h, 0.0f);
+    simd_utils::PoolArray<float> kernel_re(bins), kernel_im(bins), re(bins), im(bins);
+    if (plane.empty() || kernel_re.empty() || kernel_im.empty() || re.empty() || im.empty()) {
+        return false;
+    }
+
+    const int rx = plan.radius_x;
+    const int ry = plan.radius_y;
+    for (int ky = 0; ky <= 2 * ry; ++ky) {
+        for (int kx = 0; kx <= 2 * rx; ++kx) {
+            size_t x = (rx - kx + padded_w) % padded_w;
+            size_t y = (ry - ky + padded_h) % padded_h;
+            plane[y * padded_w + x] = plan.taps[ky * (2 * rx + 1) + kx];
+        }
+    }
+    fft->forward(plane.data(), kernel_re.data(), kernel_im.data());
+
+    const size_t stride = static_cast<size_t>(width) * channels;
+    for (int c = 0; c < channels; ++c) {
+        if (keeps_alpha(plan, channels, c)) {
+            for (size_t i = c; i < stride * height; i += channels) dst[i] = src[i];
+            continue;
+        }
+        load_plane(src, width, height, channels, c, padded_w, padded_h, plane.data());
+        fft->forward(plane.data(), re.data(), im.data());
+        for (size_t i = 0; i < bins; ++i) {
+            float r = re[i] * kernel_re[i] - im[i] * kernel_im[i];
+            im[i] = re[i] * kernel_im[i] + im[i] * kernel_re[i];
+            re[i] = r;
+        }
+        fft->inverse(re.data(), im.data(), plane.data());
+        for (uint32_t y = 0; y < height; ++y) {
+            const float* row = plane.data() + y * padded_w;
+            uint8_t* out = dst + y * stride + c;
+            for (uint32_t x = 0; x < width; ++x) {
+                float v = row[x] + plan.bias;
+                out[static_cast<size_t>(x) * channels] = to_u8(plan.absolute ? std::fabs(v) : v);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// FilterProcessor
+
+FilterProcessor::FilterProcessor()
+    : use_simd_(SIMD_SUPPORTED != 0), use_multithreading_(false), thread_count_(0), stats_() {}
+
+FilterProcessor::~FilterProcessor() = default;
+
+bool FilterProcessor::validate_inputs(const uint8_t* src, uint32_t width, uint32_t height, int channels) {
+    return valid_image(src, width, height, channels);
+}
+
+void FilterProcessor::update_stats(FilterType type, size_t pixel_count, double time_ms) {
+    stats_.total_filters_applied++;
+    stats_.total_pixels_processed += pixel_count;
+    stats_.total_processing_time_ms += time_ms;
+    if (stats_.total_processing_time_ms > 0.0) {
+        stats_.average_megapixels_per_second =
+            (stats_.total_pixels_processed / 1e6) / (stats_.total_processing_time_ms / 1000.0);
+    }
+    for (auto& usage : stats_.filter_usage_count) {
+        if (usage.first == type) {
+            usage.second++;
+            return;
+        }
+    }
+    stats_.filter_usage_count.emplace_back(type, 1);
+}
+
+unsigned FilterProcessor::thread_count() const {
+    if (!use_multithreading_) {
+        return 1;
+    }
+    return thread_count_ > 0 ? std::min(thread_count_, worker_pool::WorkerPool::MAX_THREADS)
+                             : worker_pool::WorkerPool::default_thread_count();
+}
+
+void FilterProcessor::process_rows_parallel(const std::function<void(int, int)>& row_processor,
+                                            int total_rows, int num_threads) {
+    if (total_rows <= 0) {
+        return;
+    }
+    unsigned threads = num_threads > 0 && use_multithreading_ ? static_cast<unsigned>(num_threads) : thread_count();
+    // Small bands keep per-pixel heavy filters balanced; 8 rows bounds the overhead
+    worker_pool::WorkerPool::shared().parallel_for(
+        static_cast<size_t>(total_rows), 8, threads, [&](size_t begin, size_t end) {
+            row_processor(static_cast<int>(begin), static_cast<int>(end));
+        });
+}
+
+float FilterProcessor::gaussian_weight(float distance, float sigma) {
+    return std::exp(-(distance * distance) / (2.0f * sigma * sigma));
+}
+
+float FilterProcessor::intensity_weight(float intensity_diff, float sigma) {
+    return std::exp(-(intensity_diff * intensity_diff) / (2.0f * sigma * sigma));
+}
+
+namespace {
+
+FilterResult run_whole_image(const StepPlan& plan, const uint8_t* src, uint32_t width,
+                             uint32_t height, int channels, unsigned threads) {
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+    result.success = execute_banded(&plan, 1, src, result.data.data(), width, height, channels,
+                                    width, strip_rows(plan), threads);
+    if (!result.success) {
+        result.data.clear();
+        result.error_message = "Out of memory for filter scratch";
+    }
+
+    timer.stop();
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = SIMD_SUPPORTED && plan.fixed_point();
+    return result;
+}
+
+} // namespace
+
+FilterResult FilterProcessor::apply_filter(const uint8_t* src_data, uint32_t width, uint32_t height,
+                                           int channels, const FilterParams& params) {
+    if (!validate_inputs(src_data, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    switch (params.type) {
+        case FilterType::UNSHARP_MASK:
+            return unsharp_mask(src_data, width, height, channels, params.radius, params.strength, params.threshold);
+        case FilterType::MEDIAN:
+            return median_filter(src_data, width, height, channels, static_cast<int>(std::lround(params.radius)));
+        case FilterType::NOISE_REDUCTION:
+            return noise_reduction(src_data, width, height, channels, params.strength);
+        case FilterType::BILATERAL:
+            // sigma is the spatial sigma; threshold, a fraction of full scale, the intensity sigma
+            return bilateral_filter(src_data, width, height, channels, params.sigma, params.threshold * 255.0f,
+                                    params.bilateral_grid);
+        case FilterType::KUWAHARA:
+            return kuwahara(src_data, width, height, channels, static_cast<int>(std::lround(params.radius)));
+        case FilterType::OIL_PAINTING:
+            return oil_painting(src_data, width, height, channels, static_cast<int>(std::lround(params.radius)),
+                                DEFAULT_OIL_LEVELS);
+        case FilterType::BOX_BLUR:
+            if (box_blur_uses_sat(params)) {
+                return run_box_filter(src_data, width, height, channels,
+                                      static_cast<int>(std::lround(params.radius)), params.preserve_alpha);
+            }
+            break;
+        default:
+            break;
+    }
+    StepPlan plan;
+    if (!plan_filter(params, use_simd_, plan)) {
+        return failure(width, height, channels, "Filter type not supported");
+    }
+    FilterResult result = run_whole_image(plan, src_data, width, height, channels, thread_count());
+    if (result.success) {
+        update_stats(params.type, static_cast<size_t>(width) * height, result.processing_time_ms);
+    }
+    return result;
+}
+
+FilterResult FilterProcessor::box_blur(const uint8_t* src, uint32_t width, uint32_t height,
+                                       int channels, int radius) {
+    FilterParams params;
+    params.type = FilterType::BOX_BLUR;
+    params.radius = static_cast<float>(radius);
+    return apply_filter(src, width, height, channels, params);
+}
+
+FilterResult FilterProcessor::gaussian_blur(const uint8_t* src, uint32_t width, uint32_t height,
+                                            int channels, float radius, float sigma) {
+    FilterParams params;
+    params.type = FilterType::GAUSSIAN_BLUR;
+    params.radius = radius;
+    params.sigma = sigma;
+    return apply_filter(src, width, height, channels, params);
+}
+
+FilterResult FilterProcessor::sharpen(const uint8_t* src, uint32_t width, uint32_t height,
+                                      int channels, float strength) {
+    FilterParams params;
+    params.type = FilterType::SHARPEN;
+    params.strength = strength;
+    return apply_filter(src, width, height, channels, params);
+}
+
+// Adds back strength times the detail a Gaussian blur removes; differences
+// under threshold (a fraction of full scale) are left alone so flat areas
+// keep their noise level
+FilterResult FilterProcessor::unsharp_mask(const uint8_t* src, uint32_t width, uint32_t height,
+                                           int channels, float radius, float strength, float threshold) {
+    if (!validate_inputs(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+
+    FilterParams params;
+    params.type = FilterType::GAUSSIAN_BLUR;
+    params.radius = radius;
+    params.sigma = 0.0f;
+    StepPlan plan;
+    plan_filter(params, use_simd_, plan);
+    FilterResult result = run_whole_image(plan, src, width, height, channels, thread_count());
+    if (!result.success) {
+        return result;
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+    const int min_diff = static_cast<int>(std::lround(std::max(0.0f, threshold) * 255.0f));
+    const size_t stride = static_cast<size_t>(width) * channels;
+    uint8_t* dst = result.data.data();
+    process_rows_parallel([&](int y0, int y1) {
+        for (size_t i = y0 * stride; i < y1 * stride; ++i) {
+            const int diff = src[i] - dst[i];
+            if ((channels == 4 && i % 4 == 3) || std::abs(diff) < min_diff) {
+                dst[i] = src[i];
+            } else {
+                dst[i] = to_u8(src[i] + strength * diff);
+            }
+        }
+    }, static_cast<int>(height));
+    timer.stop();
+
+    result.processing_time_ms += timer.elapsed_ms();
+    update_stats(FilterType::UNSHARP_MASK, static_cast<size_t>(width) * height, result.processing_time_ms);
+    return result;
+}
+
+FilterResult FilterProcessor::edge_detect(const uint8_t* src, uint32_t width, uint32_t height,
+                                          int channels, float threshold) {
+    FilterParams params;
+    params.type = FilterType::EDGE_DETECT;
+    params.threshold = threshold;
+    return apply_filter(src, width, height, channels, params);
+}
+
+FilterResult FilterProcessor::sobel_x(const uint8_t* src, uint32_t width, uint32_t height, int channels) {
+    FilterParams params;
+    params.type = FilterType::SOBEL_X;
+    return apply_filter(src, width, height, channels, params);
+}
+
+FilterResult FilterProcessor::sobel_y(const uint8_t* src, uint32_t width, uint32_t height, int channels) {
+    FilterParams params;
+    params.type = FilterType::SOBEL_Y;
+    return apply_filter(src, width, height, channels, params);
+}
+
+FilterResult FilterProcessor::laplacian(const uint8_t* src, uint32_t width, uint32_t height, int channels) {
+    FilterParams params;
+    params.type = FilterType::LAPLACIAN;
+    return apply_filter(src, width, height, channels, params);
+}
+
+FilterResult FilterProcessor::emboss(const uint8_t* src, uint32_t width, uint32_t height,
+                                     int channels, float strength) {
+    FilterParams params;
+    params.type = FilterType::EMBOSS;
+    params.strength = strength;
+    return apply_filter(src, width, height, channels, params);
+}
+
+FilterResult FilterProcessor::apply_convolution(const uint8_t* src, uint32_t width, uint32_t height,
+                                                int channels, const ConvolutionKernel& kernel) {
+    if (!validate_inputs(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    StepPlan plan;
+    if (!plan_kernel(kernel, false, plan)) {
+        return failure(width, height, channels, "Kernel dimensions must be odd");
+    }
+
+    // Padding of twice the radius keeps the wrapped border equal to the clamped one
+    const size_t padded_w = fft::next_fast_size(width + 2 * plan.radius_x);
+    const size_t padded_h = fft::next_fast_size(height + 2 * plan.radius_y);
+    if (fft_is_cheaper(plan, width, height, thread_count(), padded_w, padded_h)) {
+        simd_utils::SIMDTimer timer;
+        timer.start();
+        FilterResult result{};
+        result.width = width;
+        result.height = height;
+        result.channels = channels;
+        result.data.resize(static_cast<size_t>(width) * height * channels);
+        if (fft_convolution(plan, src, width, height, channels, padded_w, padded_h, fft_plans_,
+                            result.data.data())) {
+            timer.stop();
+            result.success = true;
+            result.processing_time_ms = timer.elapsed_ms();
+            result.simd_used = SIMD_SUPPORTED != 0;
+            return result;
+        }
+    }
+    return run_whole_image(plan, src, width, height, channels, thread_count());
+}
+
+FilterResult FilterProcessor::apply_separable_convolution(const uint8_t* src, uint32_t width, uint32_t height,
+                                                          int channels, const std::vector<float>& h_kernel,
+                                                          const std::vector<float>& v_kernel) {
+    if (!validate_inputs(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    StepPlan plan;
+    if (!plan_separable(h_kernel, v_kernel, plan)) {
+        return failure(width, height, channels, "Kernel sizes must be odd");
+    }
+    if (use_simd_) {
+        use_fixed_point(plan);
+    }
+    return run_whole_image(plan, src, width, height, channels, thread_count());
+}
+
+// Edge-preserving filters (per-pixel windows, banded across threads)
+
+// Exact unless grid_cell is positive and the grid's cells would span at
+// least two pixels; then, and when the grid fits, run_bilateral_grid
+FilterResult FilterProcessor::bilateral_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                               int channels, float spatial_sigma, float intensity_sigma,
+                                               float grid_cell) {
+    if (!validate_inputs(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    if (!(spatial_sigma > 0.0f) || !(intensity_sigma > 0.0f)) {
+        return failure(width, height, channels, "Sigmas must be positive");
+    }
+    if (grid_cell > 0.0f && spatial_sigma * grid_cell >= MIN_BILATERAL_GRID_PIXELS) {
+        FilterResult result = run_bilateral_grid(src, width, height, channels, spatial_sigma, intensity_sigma,
+                                                 std::min(grid_cell, MAX_BILATERAL_GRID_CELL));
+        if (result.success) {
+            return result;
+        }
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    // Weights beyond two sigmas are negligible; both tables are built once per call
+    const int radius = std::max(1, static_cast<int>(std::ceil(2.0f * spatial_sigma)));
+    const int side = 2 * radius + 1;
+    std::vector<float> spatial(static_cast<size_t>(side) * side);
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            spatial[(dy + radius) * side + dx + radius] =
+                gaussian_weight(std::sqrt(static_cast<float>(dx * dx + dy * dy)), spatial_sigma);
+        }
+    }
+    float range[256];
+    for (int d = 0; d < 256; ++d) {
+        range[d] = intensity_weight(static_cast<float>(d), intensity_sigma);
+    }
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const size_t stride = static_cast<size_t>(width) * channels;
+    uint8_t* dst = result.data.data();
+    process_rows_parallel([&](int y0, int y1) {
+        for (int y = y0; y < y1; ++y) {
+            const int wy0 = std::max(0, y - radius);
+            const int wy1 = std::min(h - 1, y + radius);
+            for (int x = 0; x < w; ++x) {
+                const int wx0 = std::max(0, x - radius);
+                const int wx1 = std::min(w - 1, x + radius);
+                const uint8_t* center = src + y * stride + static_cast<size_t>(x) * channels;
+                uint8_t* out = dst + y * stride + static_cast<size_t>(x) * channels;
+                for (int c = 0; c < channels; ++c) {
+                    if (channels == 4 && c == 3) {
+                        out[c] = center[c];
+                        continue;
+                    }
+                    const int value = center[c];
+                    float sum = 0.0f;
+                    float weight_sum = 0.0f;
+                    for (int wy = wy0; wy <= wy1; ++wy) {
+                        const uint8_t* row = src + wy * stride;
+                        const float* weights = &spatial[(wy - y + radius) * side];
+                        for (int wx = wx0; wx <= wx1; ++wx) {
+                            const int sample = row[static_cast<size_t>(wx) * channels + c];
+                            const float weight = weights[wx - x + radius] * range[std::abs(sample - value)];
+                            sum += weight * sample;
+                            weight_sum += weight;
+                        }
+                    }
+                    out[c] = to_u8(sum / weight_sum);
+                }
+            }
+        }
+    }, h);
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = false;
+    update_stats(FilterType::BILATERAL, static_cast<size_t>(width) * height, result.processing_time_ms);
+    return result;
+}
+
+// Bilateral grid (Paris & Durand; Chen et al.): each channel is splatted
+// trilinearly into a (x, y, intensity) grid of cells grid_cell sigmas wide,
+// holding a value sum and a weight. A Gaussian blur of one sigma (1 /
+// grid_cell cells) per axis there stands in for both bilateral kernels, and each pixel
+// reads its result back by trilinear interpolation. The cost is a few
+// operations per pixel plus the grid, which shrinks with both sigmas.
+FilterResult FilterProcessor::run_bilateral_grid(const uint8_t* src, uint32_t width, uint32_t height,
+                                                 int channels, float spatial_sigma, float intensity_sigma,
+                                                 float grid_cell) {
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    const float cell_xy = spatial_sigma * grid_cell;
+    const float cell_z = std::max(1.0f, intensity_sigma * grid_cell);
+    const float blur_sigma = 1.0f / grid_cell;
+    const int pad = std::max(1, static_cast<int>(std::ceil(2.0f * blur_sigma)));
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const int gw = static_cast<int>((w - 1) / cell_xy) + 2 + 2 * pad;
+    const int gh = static_cast<int>((h - 1) / cell_xy) + 2 + 2 * pad;
+    const int gd = static_cast<int>(255.0f / cell_z) + 2 + 2 * pad;
+    const size_t cells = static_cast<size_t>(gw) * gh * gd;
+
+    if (cells > MAX_BILATERAL_GRID_CELLS) {
+        return failure(width, height, channels, "Bilateral grid too large");
+    }
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+
+    std::vector<float> taps(2 * pad + 1);
+    float tap_sum = 0.0f;
+    for (int i = -pad; i <= pad; ++i) {
+        taps[i + pad] = std::exp(-(i * i) / (2.0f * blur_sigma * blur_sigma));
+        tap_sum += taps[i + pad];
+    }
+    for (float& t : taps) t /= tap_sum;
+
+    // Cells are (sum, weight) pairs, intensity fastest, then x, then y. The
+    // blur ping-pongs between two grids, one axis per pass.
+    simd_utils::PoolArray<float> grid(cells * 2);
+    simd_utils::PoolArray<float> blurred(cells * 2);
+    if (grid.empty() || blurred.empty()) {
+        return failure(width, height, channels, "Out of memory for bilateral grid");
+    }
+    const size_t column = static_cast<size_t>(gd) * 2;
+    const size_t grid_row = static_cast<size_t>(gw) * column;
+    auto cell = [&](int gx, int gy, int gz) { return (static_cast<size_t>(gy) * gw + gx) * gd + gz; };
+
+    const size_t stride = static_cast<size_t>(width) * channels;
+    uint8_t* dst = result.data.data();
+    for (int c = 0; c < channels; ++c) {
+        if (channels == 4 && c == 3) {
+            for (size_t i = 3; i < stride * height; i += 4) dst[i] = src[i];
+            continue;
+        }
+
+        std::fill(grid.begin(), grid.end(), 0.0f);
+        for (int y = 0; y < h; ++y) {
+            const float fy = y / cell_xy + pad;
+            const int gy = static_cast<int>(fy);
+            const float ty = fy - gy;
+            const uint8_t* row = src + y * stride + c;
+            for (int x = 0; x < w; ++x) {
+                const float value = row[static_cast<size_t>(x) * channels];
+                const float fx = x / cell_xy + pad;
+                const float fz = value / cell_z + pad;
+                const int gx = static_cast<int>(fx);
+                const int gz = static_cast<int>(fz);
+                const float tx = fx - gx;
+                const float tz = fz - gz;
+                for (int k = 0; k < 8; ++k) {
+                    const float weight = (k & 1 ? tz : 1.0f - tz) * (k & 2 ? tx : 1.0f - tx) * (k & 4 ? ty : 1.0f - ty);
+                    float* target = &grid[cell(gx + (k >> 1 & 1), gy + (k >> 2), gz + (k & 1)) * 2];
+                    target[0] += weight * value;
+                    target[1] += weight;
+                }
+            }
+        }
+
+        process_rows_parallel([&](int y0, int y1) {
+            for (int gy = y0; gy < y1; ++gy) {
+                for (int gx = 0; gx < gw; ++gx) {
+                    const size_t at = gy * grid_row + gx * column;
+                    blur_span(&grid[at], &blurred[at], gd, 2, 0, gd, taps);
+                }
+                blur_span(&blurred[gy * grid_row], &grid[gy * grid_row], gw, column, 0, gw, taps);
+            }
+        }, gh);
+        process_rows_parallel([&](int y0, int y1) {
+            blur_span(grid.data(), blurred.data(), gh, grid_row, y0, y1, taps);
+        }, gh);
+
+        process_rows_parallel([&](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                const float fy = y / cell_xy + pad;
+                const int gy = static_cast<int>(fy);
+                const float ty = fy - gy;
+                const uint8_t* in = src + y * stride + c;
+                uint8_t* out = dst + y * stride + c;
+                for (int x = 0; x < w; ++x) {
+                    const float fx = x / cell_xy + pad;
+                    const float fz = in[static_cast<size_t>(x) * channels] / cell_z + pad;
+                    const int gx = static_cast<int>(fx);
+                    const int gz = static_cast<int>(fz);
+                    const float tx = fx - gx;
+                    const float tz = fz - gz;
+                    float sum = 0.0f, weight = 0.0f;
+                    for (int k = 0; k < 8; ++k) {
+                        const float t = (k & 1 ? tz : 1.0f - tz) * (k & 2 ? tx : 1.0f - tx) * (k & 4 ? ty : 1.0f - ty);
+                        const float* source = &blurred[cell(gx + (k >> 1 & 1), gy + (k >> 2), gz + (k & 1)) * 2];
+                        sum += t * source[0];
+                        weight += t * source[1];
+                    }
+                    out[static_cast<size_t>(x) * channels] = weight > 0.0f ? to_u8(sum / weight) : in[static_cast<size_t>(x) * channels];
+                }
+            }
+        }, h);
+    }
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = false;
+    update_stats(FilterType::BILATERAL, static_cast<size_t>(width) * height, result.processing_time_ms);
+    return result;
+}
+
+FilterResult FilterProcessor::median_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                            int channels, int radius) {
+    return run_rank_filter(src, width, height, channels, radius, 0.5f, FilterType::MEDIAN);
+}
+
+FilterResult FilterProcessor::rank_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                          int channels, int radius, float percentile) {
+    return run_rank_filter(src, width, height, channels, radius, percentile, FilterType::MEDIAN);
+}
+
+// Median whose radius grows with strength: 1 up to 0.75, 2 at 1.0, 4 at 2.0
+FilterResult FilterProcessor::noise_reduction(const uint8_t* src, uint32_t width, uint32_t height,
+                                              int channels, float strength) {
+    int radius = strength > 0.0f ? static_cast<int>(std::lround(std::min(strength, 64.0f) * 2.0f)) : 1;
+    radius = std::min(std::max(radius, 1), MAX_RANK_RADIUS);
+    return run_rank_filter(src, width, height, channels, radius, 0.5f, FilterType::NOISE_REDUCTION);
+}
+
+FilterResult FilterProcessor::run_rank_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                              int channels, int radius, float percentile, FilterType type) {
+    if (!validate_inputs(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    if (radius < 1 || radius > MAX_RANK_RADIUS) {
+        return failure(width, height, channels, "Radius must be between 1 and 127");
+    }
+    if (!(percentile >= 0.0f && percentile <= 1.0f)) {
+        return failure(width, height, channels, "Percentile must be between 0 and 1");
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+
+    const RankWindow window{radius, radius, radius, radius};
+    uint8_t* dst = result.data.data();
+    process_rows_parallel([&](int y0, int y1) {
+        rank_rows(src, dst, static_cast<int>(width), static_cast<int>(height), channels, window,
+                  percentile, true, y0, y1);
+    }, static_cast<int>(height));
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = SIMD_SUPPORTED != 0;
+    update_stats(type, static_cast<size_t>(width) * height, result.processing_time_ms);
+    return result;
+}
+
+// Window filters on summed-area tables (cost per pixel independent of the radius)
+
+// Box mean with the border clamped, as in the separable box blur: the table
+// is padded by the radius on every side, so every window is full size
+FilterResult FilterProcessor::run_box_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                             int channels, int radius, bool preserve_alpha) {
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const size_t stride = static_cast<size_t>(width) * channels;
+    const size_t span = static_cast<size_t>(2 * radius + 1) * channels;
+    const float scale = 1.0f / (static_cast<float>(2 * radius + 1) * (2 * radius + 1));
+    const int strip = sat_strip_rows((w + 2 * radius + 1) * channels * sizeof(uint32_t), 2 * radius + 1);
+    uint8_t* dst = result.data.data();
+    process_rows_parallel([&](int y0, int y1) {
+        IntegralImage sat;
+        for (int s0 = y0; s0 < y1; s0 += strip) {
+            const int s1 = std::min(y1, s0 + strip);
+            const int first = s0 - radius;
+            sat.build(w, s1 - s0 + 2 * radius, channels, radius, false, [&](int i) {
+                return src + static_cast<size_t>(clamp_to(first + i, 0, h)) * stride;
+            });
+            for (int y = s0; y < s1; ++y) {
+                const uint32_t* top = sat.sums(y - s0);
+                const uint32_t* bottom = sat.sums(y - s0 + 2 * radius + 1);
+                uint8_t* out = dst + y * stride;
+                for (size_t i = 0; i < stride; ++i) {
+                    out[i] = to_u8((bottom[i + span] - bottom[i] - top[i + span] + top[i]) * scale);
+                }
+                if (preserve_alpha && channels == 4) {
+                    const uint8_t* in = src + y * stride;
+                    for (size_t i = 3; i < stride; i += 4) out[i] = in[i];
+                }
+            }
+        }
+    }, h);
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = SIMD_SUPPORTED != 0;
+    update_stats(FilterType::BOX_BLUR, static_cast<size_t>(width) * height, result.processing_time_ms);
+    return result;
+}
+
+// Each pixel takes the mean of whichever of its four (r + 1)^2 quadrants,
+// clipped at the border, has the least variance summed over the color
+// channels. Means and variances come from sum and squared-sum tables.
+FilterResult FilterProcessor::kuwahara(const uint8_t* src, uint32_t width, uint32_t height,
+                                       int channels, int radius) {
+    if (!validate_inputs(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    if (radius < 1 || radius > MAX_SAT_RADIUS) {
+        return failure(width, height, channels, "Radius must be between 1 and 127");
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const int colors = channels == 4 ? 3 : channels;
+    const size_t stride = static_cast<size_t>(width) * channels;
+    const int strip = sat_strip_rows((w + 1) * channels * 2 * sizeof(uint32_t), 2 * radius);
+    uint8_t* dst = result.data.data();
+    process_rows_parallel([&](int y0, int y1) {
+        IntegralImage sat;
+        for (int s0 = y0; s0 < y1; s0 += strip) {
+            const int s1 = std::min(y1, s0 + strip);
+            const int first = std::max(0, s0 - radius);
+            const int last = std::min(h, s1 + radius);
+            sat.build(w, last - first, channels, 0, true, [&](int i) {
+                return src + static_cast<size_t>(first + i) * stride;
+            });
+            for (int y = s0; y < s1; ++y) {
+                // Quadrant rows [y - r, y] and [y, y + r], columns likewise
+                const int row_bounds[2][2] = {{std::max(0, y - radius), y + 1}, {y, std::min(h, y + radius + 1)}};
+                for (int x = 0; x < w; ++x) {
+                    const int col_bounds[2][2] = {{std::max(0, x - radius), x + 1}, {x, std::min(w, x + radius + 1)}};
+                    double best_variance = 0.0;
+                    uint32_t best_sums[3] = {};
+                    uint32_t best_count = 1;
+                    for (int q = 0; q < 4; ++q) {
+                        const int* rows = row_bounds[q >> 1];
+                        const int* cols = col_bounds[q & 1];
+                        const uint32_t count = static_cast<uint32_t>((rows[1] - rows[0]) * (cols[1] - cols[0]));
+                        const size_t left = sat.offset(cols[0]);
+                        const size_t right = sat.offset(cols[1]);
+                        uint32_t sums[3];
+                        double variance = 0.0;
+                        for (int c = 0; c < colors; ++c) {
+                            sums[c] = box_sum(sat.sums(rows[0] - first), sat.sums(rows[1] - first), left, right, c);
+                            const uint32_t sq = box_sum(sat.squares(rows[0] - first), sat.squares(rows[1] - first),
+                                                        left, right, c);
+                            variance += static_cast<double>(static_cast<uint64_t>(count) * sq -
+                                                            static_cast<uint64_t>(sums[c]) * sums[c]);
+                        }
+                        variance /= static_cast<double>(count) * count;
+                        if (q == 0 || variance < best_variance) {
+                            best_variance = variance;
+                            best_count = count;
+                            std::copy(sums, sums + colors, best_sums);
+                        }
+                    }
+                    uint8_t* out = dst + y * stride + static_cast<size_t>(x) * channels;
+                    for (int c = 0; c < colors; ++c) {
+                        out[c] = static_cast<uint8_t>((best_sums[c] + best_count / 2) / best_count);
+                    }
+                    if (channels == 4) {
+                        out[3] = src[y * stride + static_cast<size_t>(x) * 4 + 3];
+                    }
+                }
+            }
+        }
+    }, h);
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = SIMD_SUPPORTED != 0;
+    update_stats(FilterType::KUWAHARA, static_cast<size_t>(width) * height, result.processing_time_ms);
+    return result;
+}
+
+// Intensities (the mean of the color channels) fall into intensity_levels
+// levels; each pixel becomes the mean color of the most common level in its
+// clipped (2r + 1)^2 window, the lowest level on ties. One table holds, per
+// level, the count and the color sums of that level's pixels, so a window
+// costs a few lookups per level. Tiles keep the tables within SAT_BYTES.
+FilterResult FilterProcessor::oil_painting(const uint8_t* src, uint32_t width, uint32_t height,
+                                           int channels, int radius, int intensity_levels) {
+    if (!validate_inputs(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    if (radius < 1 || radius > MAX_SAT_RADIUS) {
+        return failure(width, height, channels, "Radius must be between 1 and 127");
+    }
+    if (intensity_levels < 1 || intensity_levels > MAX_OIL_LEVELS) {
+        return failure(width, height, channels, "Intensity levels must be between 1 and 64");
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const int colors = channels == 4 ? 3 : channels;
+    const int per_level = colors + 1;  // Count, then color sums
+    const int planes = intensity_levels * per_level;
+    const size_t stride = static_cast<size_t>(width) * channels;
+
+    // Square tiles at least as wide as the halo
+    const int halo = 2 * radius;
+    const double side = std::sqrt(static_cast<double>(SAT_BYTES) / (planes * sizeof(uint32_t)));
+    const int tile = std::max({static_cast<int>(side) - halo, halo, 8});
+
+    uint8_t* dst = result.data.data();
+    process_rows_parallel([&](int y0, int y1) {
+        IntegralImage sat;
+        std::vector<uint8_t> level_row;
+        for (int s0 = y0; s0 < y1; s0 += tile) {
+            const int s1 = std::min(y1, s0 + tile);
+            const int first = std::max(0, s0 - radius);
+            const int last = std::min(h, s1 + radius);
+            for (int t0 = 0; t0 < w; t0 += tile) {
+                const int t1 = std::min(w, t0 + tile);
+                const int left_col = std::max(0, t0 - radius);
+                const int cols = std::min(w, t1 + radius) - left_col;
+                level_row.resize(static_cast<size_t>(cols) * planes);
+                sat.build(cols, last - first, planes, 0, false, [&](int i) {
+                    std::fill(level_row.begin(), level_row.end(), uint8_t(0));
+                    const uint8_t* in = src + static_cast<size_t>(first + i) * stride + static_cast<size_t>(left_col) * channels;
+                    for (int x = 0; x < cols; ++x, in += channels) {
+                        int intensity = 0;
+                        for (int c = 0; c < colors; ++c) intensity += in[c];
+                        const int level = intensity * intensity_levels / (255 * colors + 1);
+                        uint8_t* slot = &level_row[static_cast<size_t>(x) * planes + level * per_level];
+                        slot[0] = 1;
+                        std::copy(in, in + colors, slot + 1);
+                    }
+                    return level_row.data();
+                });
+                for (int y = s0; y < s1; ++y) {
+                    const uint32_t* top = sat.sums(std::max(0, y - radius) - first);
+                    const uint32_t* bottom = sat.sums(std::min(h, y + radius + 1) - first);
+                    for (int x = t0; x < t1; ++x) {
+                        const size_t left = sat.offset(std::max(0, x - radius) - left_col);
+                        const size_t right = sat.offset(std::min(w, x + radius + 1) - left_col);
+                        int best = 0;
+                        uint32_t best_count = 0;
+                        for (int level = 0; level < intensity_levels; ++level) {
+                            const uint32_t count = box_sum(top, bottom, left, right, level * per_level);
+                            if (count > best_count) {
+                                best_count = count;
+                                best = level;
+                            }
+                        }
+                        uint8_t* out = dst + y * stride + static_cast<size_t>(x) * channels;
+                        for (int c = 0; c < colors; ++c) {
+                            const uint32_t sum = box_sum(top, bottom, left, right, best * per_level + 1 + c);
+                            out[c] = static_cast<uint8_t>((sum + best_count / 2) / best_count);
+                        }
+                        if (channels == 4) {
+                            out[3] = src[y * stride + static_cast<size_t>(x) * 4 + 3];
+                        }
+                    }
+                }
+            }
+        }
+    }, h);
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = SIMD_SUPPORTED != 0;
+    update_stats(FilterType::OIL_PAINTING, static_cast<size_t>(width) * height, result.processing_time_ms);
+    return result;
+}
+
+// Pre-defined kernels
+
+ConvolutionKernel FilterProcessor::create_gaussian_kernel(float sigma, int size) {
+    if (size <= 0) {
+        size = 2 * static_cast<int>(std::ceil(3.0f * sigma)) + 1;
+    }
+    std::vector<float> taps = gaussian_taps(size / 2, sigma);
+    ConvolutionKernel kernel(size, size);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            kernel(x, y) = taps[x] * taps[y];
+        }
+    }
+    return kernel;
+}
+
+ConvolutionKernel FilterProcessor::create_box_kernel(int size) {
+    ConvolutionKernel kernel(size, size);
+    std::fill(kernel.data.begin(), kernel.data.end(), 1.0f);
+    return kernel;
+}
+
+ConvolutionKernel FilterProcessor::create_sharpen_kernel(float strength) {
+    ConvolutionKernel kernel(3, 3);
+    kernel.data = {0.0f, -strength, 0.0f,
+                   -strength, 1.0f + 4.0f * strength, -strength,
+                   0.0f, -strength, 0.0f};
+    kernel.normalize = false;
+    return kernel;
+}
+
+ConvolutionKernel FilterProcessor::create_edge_kernel() {
+    ConvolutionKernel kernel(3, 3);
+    kernel.data = {-1.0f, -1.0f, -1.0f,
+                   -1.0f, 8.0f, -1.0f,
+                   -1.0f, -1.0f, -1.0f};
+    kernel.normalize = false;
+    return kernel;
+}
+
+ConvolutionKernel FilterProcessor::create_emboss_kernel() {
+    ConvolutionKernel kernel(3, 3);
+    kernel.data = {-2.0f, -1.0f, 0.0f,
+                   -1.0f, 1.0f, 1.0f,
+                   0.0f, 1.0f, 2.0f};
+    kernel.normalize = false;
+    return kernel;
+}
+
+ConvolutionKernel FilterProcessor::create_sobel_x_kernel() {
+    ConvolutionKernel kernel(3, 3);
+    kernel.data = {-1.0f, 0.0f, 1.0f,
+                   -2.0f, 0.0f, 2.0f,
+                   -1.0f, 0.0f, 1.0f};
+    kernel.normalize = false;
+    return kernel;
+}
+
+ConvolutionKernel FilterProcessor::create_sobel_y_kernel() {
+    ConvolutionKernel kernel(3, 3);
+    kernel.data = {-1.0f, -2.0f, -1.0f,
+                   0.0f, 0.0f, 0.0f,
+                   1.0f, 2.0f, 1.0f};
+    kernel.normalize = false;
+    return kernel;
+}
+
+ConvolutionKernel FilterProcessor::create_laplacian_kernel() {
+    ConvolutionKernel kernel(3, 3);
+    kernel.data = {0.0f, 1.0f, 0.0f,
+                   1.0f, -4.0f, 1.0f,
+                   0.0f, 1.0f, 0.0f};
+    kernel.normalize = false;
+    return kernel;
+}
+
+// FilterChain
+
+FilterChain::FilterChain()
+    : execution_(ChainExecution::TILED), tile_width_(256), tile_height_(64) {}
+
+void FilterChain::set_tile_size(uint32_t width, uint32_t height) {
+    tile_width_ = std::max<uint32_t>(width, 1);
+    tile_height_ = std::max<uint32_t>(height, 1);
+}
+
+void FilterChain::add_filter(FilterType type, const FilterParams& params) {
+    FilterStep step;
+    step.type = type;
+    step.params = params;
+    step.params.type = type;
+    step.is_custom = false;
+    filters_.push_back(std::move(step));
+}
+
+void FilterChain::add_custom_filter(const std::function<FilterResult(const uint8_t*, uint32_t, uint32_t, int)>& filter) {
+    FilterStep step;
+    step.type = FilterType::BOX_BLUR;
+    step.custom_filter = filter;
+    step.is_custom = true;
+    filters_.push_back(std::move(step));
+}
+
+FilterResult FilterChain::apply_chain(const uint8_t* src, uint32_t width, uint32_t height, int channels) {
+    if (!valid_image(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    FilterResult current{};
+    current.success = true;
+    current.width = width;
+    current.height = height;
+    current.channels = channels;
+    const uint8_t* input = src;
+
+    std::vector<StepPlan> plans;
+    size_t i = 0;
+    while (i < filters_.size()) {
+        // Longest run of neighborhood filters starting at i; table box blurs
+        // run alone, as apply_filter would run them under PER_FILTER
+        plans.clear();
+        StepPlan plan;
+        while (i + plans.size() < filters_.size() && !filters_[i + plans.size()].is_custom &&
+               !box_blur_uses_sat(filters_[i + plans.size()].params) &&
+               plan_filter(filters_[i + plans.size()].params, processor_.is_simd_enabled(), plan)) {
+            plans.push_back(plan);
+        }
+
+        FilterResult next;
+        if (plans.size() > 1 && execution_ == ChainExecution::TILED) {
+            next = current;
+            next.data.resize(static_cast<size_t>(current.width) * current.height * channels);
+            if (!execute_banded(plans.data(), plans.size(), input, next.data.data(), current.width,
+                                current.height, channels, tile_width_, tile_height_, processor_.thread_count())) {
+                return failure(width, height, channels, "Out of memory for tile scratch");
+            }
+            i += plans.size();
+        } else if (!plans.empty()) {
+            next = processor_.apply_filter(input, current.width, current.height, channels, filters_[i].params);
+            i++;
+        } else {
+            const FilterStep& step = filters_[i];
+            next = step.is_custom ? step.custom_filter(input, current.width, current.height, channels)
+                                  : processor_.apply_filter(input, current.width, current.height, channels,
+                                                            step.params);
+            i++;
+        }
+
+        if (!next.success || next.channels != channels) {
+            return next.success ? failure(width, height, channels, "Filter changed the channel count") : next;
+        }
+        current = std::move(next);
+        input = current.data.data();
+    }
+
+    if (input == src) {
+        current.data.assign(src, src + static_cast<size_t>(width) * height * channels);
+    }
+    timer.stop();
+    current.processing_time_ms = timer.elapsed_ms();
+    return current;
+}
+
+
+// FrequencyDomainFilter
+
+namespace {
+
+// Order-2 Butterworth low-pass gain at normalized radius r (1 = Nyquist)
+inline float butterworth(float r, float cutoff) {
+    float t = r / cutoff;
+    return 1.0f / (1.0f + t * t * t * t);
+}
+
+// Distance from DC in fractions of Nyquist
+inline float nyquist_radius(float fx, float fy) {
+    return 2.0f * std::sqrt(fx * fx + fy * fy);
+}
+
+} // namespace
+
+FrequencyDomainFilter::FrequencyDomainFilter() = default;
+
+FrequencyDomainFilter::~FrequencyDomainFilter() = default;
+
+FilterResult FrequencyDomainFilter::low_pass_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                                    int channels, float cutoff_frequency) {
+    if (!(cutoff_frequency > 0.0f)) {
+        return failure(width, height, channels, "Cutoff must be positive");
+    }
+    return apply_frequency_mask(src, width, height, channels, [=](float fx, float fy) {
+        return butterworth(nyquist_radius(fx, fy), cutoff_frequency);
+    });
+}
+
+FilterResult FrequencyDomainFilter::high_pass_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                                     int channels, float cutoff_frequency) {
+    if (!(cutoff_frequency > 0.0f)) {
+        return failure(width, height, channels, "Cutoff must be positive");
+    }
+    return apply_frequency_mask(src, width, height, channels, [=](float fx, float fy) {
+        return 1.0f - butterworth(nyquist_radius(fx, fy), cutoff_frequency);
+    });
+}
+
+FilterResult FrequencyDomainFilter::band_pass_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                                     int channels, float low_cutoff, float high_cutoff) {
+    if (!(low_cutoff > 0.0f) || !(high_cutoff > low_cutoff)) {
+        return failure(width, height, channels, "Cutoffs must satisfy 0 < low < high");
+    }
+    return apply_frequency_mask(src, width, height, channels, [=](float fx, float fy) {
+        float r = nyquist_radius(fx, fy);
+        return butterworth(r, high_cutoff) * (1.0f - butterworth(r, low_cutoff));
+    });
+}
+
+FilterResult FrequencyDomainFilter::notch_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                                 int channels, float center_freq, float bandwidth) {
+    if (!(bandwidth > 0.0f) || !(center_freq >= 0.0f)) {
+        return failure(width, height, channels, "Bandwidth must be positive");
+    }
+    // Gaussian reject band whose half-width at half depth is about bandwidth / 2
+    const float sigma = bandwidth / 2.0f;
+    return apply_frequency_mask(src, width, height, channels, [=](float fx, float fy) {
+        float d = nyquist_radius(fx, fy) - center_freq;
+        return 1.0f - std::exp(-(d * d) / (2.0f * sigma * sigma));
+    });
+}
+
+FilterResult FrequencyDomainFilter::apply_frequency_mask(const uint8_t* src, uint32_t width, uint32_t height,
+                                                         int channels,
+                                                         const std::function<float(float, float)>& mask_func) {
+    if (!valid_image(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    const size_t padded_w = fft::next_fast_size(width + 2 * FREQUENCY_MARGIN);
+    const size_t padded_h = fft::next_fast_size(height + 2 * FREQUENCY_MARGIN);
+    fft::RealFFT2D* fft = plans_.get(padded_w, padded_h);
+    if (!fft) {
+        return failure(width, height, channels, "Out of memory for FFT plan");
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    // Gains over the stored half spectrum: u >= 0, v wrapping to negative
+    const size_t spectrum_w = fft->spectrum_width();
+    const size_t bins = fft->spectrum_size();
+    std::vector<float> gain(bins);
+    for (size_t v = 0; v < padded_h; ++v) {
+        float fy = (v <= padded_h / 2 ? static_cast<float>(v) : static_cast<float>(v) - padded_h) / padded_h;
+        for (size_t u = 0; u < spectrum_w; ++u) {
+            gain[v * spectrum_w + u] = mask_func(static_cast<float>(u) / padded_w, fy);
+        }
+    }
+
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(static_cast<size_t>(width) * height * channels);
+    uint8_t* dst = result.data.data();
+
+    simd_utils::PoolArray<float> plane(padded_w * padded_h, 0.0f);
+    simd_utils::PoolArray<float> re(bins), im(bins);
+    if (plane.empty() || re.empty() || im.empty()) {
+        return failure(width, height, channels, "Out of memory for spectrum");
+    }
+    const size_t stride = static_cast<size_t>(width) * channels;
+    for (int c = 0; c < channels; ++c) {
+        if (channels == 4 && c == 3) {
+            for (size_t i = c; i < stride * height; i += channels) dst[i] = src[i];
+            continue;
+        }
+        load_plane(src, width, height, channels, c, padded_w, padded_h, plane.data());
+        fft->forward(plane.data(), re.data(), im.data());
+        for (size_t i = 0; i < bins; ++i) {
+            re[i] *= gain[i];
+            im[i] *= gain[i];
+        }
+        fft->inverse(re.data(), im.data(), plane.data());
+        for (uint32_t y = 0; y < height; ++y) {
+            const float* row = plane.data() + y * padded_w;
+            uint8_t* out = dst + y * stride + c;
+            for (uint32_t x = 0; x < width; ++x) {
+                out[static_cast<size_t>(x) * channels] = to_u8(row[x]);
+            }
+        }
+    }
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = SIMD_SUPPORTED != 0;
+    return result;
+}
+
+// Morphology
+
+MorphElement MorphElement::create_rect(int width, int height) {
+    return MorphElement(std::max(width, 1), std::max(height, 1));
+}
+
+MorphElement MorphElement::create_ellipse(int width, int height) {
+    MorphElement element = create_rect(width, height);
+    const float rx = element.width / 2.0f;
+    const float ry = element.height / 2.0f;
+    for (int y = 0; y < element.height; ++y) {
+        for (int x = 0; x < element.width; ++x) {
+            float dx = (x - (element.width - 1) / 2.0f) / rx;
+            float dy = (y - (element.height - 1) / 2.0f) / ry;
+            element.mask[y * element.width + x] = dx * dx + dy * dy <= 1.0f;
+        }
+    }
+    return element;
+}
+
+MorphElement MorphElement::create_cross(int size) {
+    MorphElement element = create_rect(size, size);
+    for (int y = 0; y < element.height; ++y) {
+        for (int x = 0; x < element.width; ++x) {
+            element.mask[y * element.width + x] = x == element.anchor_x || y == element.anchor_y;
+        }
+    }
+    return element;
+}
+
+namespace {
+
+bool valid_element(const MorphElement& element) {
+    return element.width > 0 && element.height > 0 &&
+           element.mask.size() == static_cast<size_t>(element.width) * element.height &&
+           element.anchor_x >= 0 && element.anchor_x < element.width &&
+           element.anchor_y >= 0 && element.anchor_y < element.height &&
+           std::find(element.mask.begin(), element.mask.end(), true) != element.mask.end();
+}
+
+// Erosion (min) or dilation (max) of every channel but alpha over the
+// element's pixels, anchored at each output pixel and clipped at the border.
+// Full rectangles run as rank filters; other shapes visit their offsets.
+void morph_pass(const uint8_t* src, uint8_t* dst, int width, int height, int channels,
+                const MorphElement& element, bool dilate) {
+    const RankWindow window{element.anchor_x, element.width - 1 - element.anchor_x,
+                            element.anchor_y, element.height - 1 - element.anchor_y};
+    const bool rect = std::find(element.mask.begin(), element.mask.end(), false) == element.mask.end();
+    if (rect && window.samples() <= MAX_RANK_SAMPLES) {
+        rank_rows(src, dst, width, height, channels, window, dilate ? 1.0f : 0.0f, true, 0, height);
+        return;
+    }
+
+    std::vector<std::pair<int, int>> offsets;
+    for (int y = 0; y < element.height; ++y) {
+        for (int x = 0; x < element.width; ++x) {
+            if (element.mask[y * element.width + x]) {
+                offsets.emplace_back(x - element.anchor_x, y - element.anchor_y);
+            }
+        }
+    }
+    const size_t stride = static_cast<size_t>(width) * channels;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            uint8_t* out = dst + y * stride + static_cast<size_t>(x) * channels;
+            for (int c = 0; c < channels; ++c) {
+                if (channels == 4 && c == 3) {
+                    out[c] = src[y * stride + static_cast<size_t>(x) * channels + c];
+                    continue;
+                }
+                // Clipped offsets can leave no sample; the pixel then keeps its value
+                int value = dilate ? -1 : 256;
+                for (const auto& offset : offsets) {
+                    int sx = x + offset.first;
+                    int sy = y + offset.second;
+                    if (sx < 0 || sx >= width || sy < 0 || sy >= height) continue;
+                    int sample = src[sy * stride + static_cast<size_t>(sx) * channels + c];
+                    value = dilate ? std::max(value, sample) : std::min(value, sample);
+                }
+                out[c] = value < 0 || value > 255 ? src[y * stride + static_cast<size_t>(x) * channels + c]
+                                                  : static_cast<uint8_t>(value);
+            }
+        }
+    }
+}
+
+// dst = a - b per sample, saturating at 0; alpha is taken from `alpha`
+void subtract_saturated(const uint8_t* a, const uint8_t* b, const uint8_t* alpha, uint8_t* dst,
+                        size_t n, int channels) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] = channels == 4 && i % 4 == 3 ? alpha[i] : static_cast<uint8_t>(a[i] > b[i] ? a[i] - b[i] : 0);
+    }
+}
+
+} // namespace
+
+FilterResult morphological_operation(const uint8_t* src, uint32_t width, uint32_t height,
+                                     int channels, MorphOp operation, const MorphElement& element) {
+    if (!valid_image(src, width, height, channels)) {
+        return failure(width, height, channels, "Invalid image");
+    }
+    if (!valid_element(element)) {
+        return failure(width, height, channels, "Invalid structuring element");
+    }
+
+    simd_utils::SIMDTimer timer;
+    timer.start();
+
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const size_t n = static_cast<size_t>(width) * height * channels;
+    FilterResult result{};
+    result.width = width;
+    result.height = height;
+    result.channels = channels;
+    result.data.resize(n);
+    uint8_t* dst = result.data.data();
+
+    std::vector<uint8_t> first;
+    std::vector<uint8_t> second;
+    switch (operation) {
+        case MorphOp::ERODE:
+        case MorphOp::DILATE:
+            morph_pass(src, dst, w, h, channels, element, operation == MorphOp::DILATE);
+            break;
+        case MorphOp::OPEN:
+        case MorphOp::CLOSE:
+        case MorphOp::TOPHAT:
+        case MorphOp::BLACKHAT: {
+            // Open erodes then dilates; close the reverse
+            const bool open = operation == MorphOp::OPEN || operation == MorphOp::TOPHAT;
+            first.resize(n);
+            morph_pass(src, first.data(), w, h, channels, element, !open);
+            if (operation == MorphOp::OPEN || operation == MorphOp::CLOSE) {
+                morph_pass(first.data(), dst, w, h, channels, element, open);
+                break;
+            }
+            second.resize(n);
+            morph_pass(first.data(), second.data(), w, h, channels, element, open);
+            if (open) {
+                subtract_saturated(src, second.data(), src, dst, n, channels);
+            } else {
+                subtract_saturated(second.data(), src, src, dst, n, channels);
+            }
+            break;
+        }
+        case MorphOp::GRADIENT:
+            first.resize(n);
+            second.resize(n);
+            morph_pass(src, first.data(), w, h, channels, element, true);
+            morph_pass(src, second.data(), w, h, channels, element, false);
+            subtract_saturated(first.data(), second.data(), src, dst, n, channels);
+            break;
+    }
+
+    timer.stop();
+    result.success = true;
+    result.processing_time_ms = timer.elapsed_ms();
+    result.simd_used = SIMD_SUPPORTED != 0;
+    return result;
+}
+
+
+// Texture analysis
+
+namespace {
+
+constexpr int GLCM_LEVELS = 16;
+constexpr int GLCM_FEATURES = 5;  // Energy, contrast, correlation, homogeneity, entropy
+
+// Haralick features of a symmetric co-occurrence count matrix
+void glcm_features(const std::vector<uint32_t>& counts, float* features) {
+    double total = 0.0;
+    for (uint32_t n : counts) total += n;
+    std::fill(features, features + GLCM_FEATURES, 0.0f);
+    if (total == 0.0) {
+        return;
+    }
+    double mean = 0.0;
+    for (int i = 0; i < GLCM_LEVELS; ++i) {
+        for (int j = 0; j < GLCM_LEVELS; ++j) mean += i * counts[i * GLCM_LEVELS + j] / total;
+    }
+    double energy = 0.0, contrast = 0.0, covariance = 0.0, variance = 0.0, homogeneity = 0.0, entropy = 0.0;
+    for (int i = 0; i < GLCM_LEVELS; ++i) {
+        for (int j = 0; j < GLCM_LEVELS; ++j) {
+            const double p = counts[i * GLCM_LEVELS + j] / total;
+            if (p == 0.0) continue;
+            energy += p * p;
+            contrast += (i - j) * (i - j) * p;
+            covariance += (i - mean) * (j - mean) * p;
+            variance += (i - mean) * (i - mean) * p;
+            homogeneity += p / (1.0 + std::abs(i - j));
+            entropy -= p * std::log2(p);
+        }
+    }
+    features[0] = static_cast<float>(energy);
+    features[1] = static_cast<float>(contrast);
+    features[2] = variance > 0.0 ? static_cast<float>(covariance / variance) : 1.0f;  // Flat image
+    features[3] = static_cast<float>(homogeneity);
+    features[4] = static_cast<float>(entropy);
+}
+
+} // namespace
+
+// Co-occurrences of 16 gray levels at distance 1 in four directions, plus
+// the spread of local contrast: the standard deviation over a patch_size
+// window around each pixel, from sum and squared-sum tables
+TextureFeatures analyze_texture(const uint8_t* src, uint32_t width, uint32_t height,
+                                int channels, int patch_size) {
+    TextureFeatures features{};
+    if (!valid_image(src, width, height, channels)) {
+        return features;
+    }
+
+    const int w = static_cast<int>(width);
+    const int h = static_cast<int>(height);
+    const size_t pixels = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> gray(pixels);
+    if (channels == 3) {
+        simd_utils::simd_rgb_to_grayscale(src, gray.data(), pixels);
+    } else {
+        // Same BT.709 weights for RGBA; channel 0 without color
+        for (size_t i = 0; i < pixels; ++i) {
+            const uint8_t* px = src + i * channels;
+            gray[i] = channels == 4 ? static_cast<uint8_t>((54 * px[0] + 183 * px[1] + 19 * px[2]) >> 8) : px[0];
+        }
+    }
+
+    // 0, 45, 90 and 135 degrees; each pair is counted both ways
+    static const int offsets[4][2] = {{1, 0}, {1, -1}, {0, -1}, {-1, -1}};
+    features.glcm_features.assign(4 * GLCM_FEATURES + 2, 0.0f);
+    std::vector<uint32_t> counts(GLCM_LEVELS * GLCM_LEVELS);
+    for (int d = 0; d < 4; ++d) {
+        std::fill(counts.begin(), counts.end(), 0u);
+        const int dx = offsets[d][0];
+        const int dy = offsets[d][1];
+        for (int y = std::max(0, -dy); y < h; ++y) {
+            const uint8_t* row = &gray[static_cast<size_t>(y) * w];
+            const uint8_t* other = row + static_cast<ptrdiff_t>(dy) * w;
+            for (int x = std::max(0, -dx); x < std::min(w, w - dx); ++x) {
+                const int a = row[x] >> 4;
+                const int b = other[x + dx] >> 4;
+                counts[a * GLCM_LEVELS + b]++;
+                counts[b * GLCM_LEVELS + a]++;
+            }
+        }
+        float* direction = &features.glcm_features[d * GLCM_FEATURES];
+        glcm_features(counts, direction);
+        features.energy += direction[0] / 4.0f;
+        features.contrast += direction[1] / 4.0f;
+        features.correlation += direction[2] / 4.0f;
+        features.homogeneity += direction[3] / 4.0f;
+        features.entropy += direction[4] / 4.0f;
+    }
+
+    // Local standard deviation over clipped windows of 2 * radius + 1
+    const int radius = std::min(MAX_SAT_RADIUS, std::max(1, patch_size / 2));
+    const int strip = sat_strip_rows((w + 1) * 2 * sizeof(uint32_t), 2 * radius);
+    IntegralImage sat;
+    double sum = 0.0, sum_sq = 0.0;
+    for (int s0 = 0; s0 < h; s0 += strip) {
+        const int s1 = std::min(h, s0 + strip);
+        const int first = std::max(0, s0 - radius);
+        const int last = std::min(h, s1 + radius);
+        sat.build(w, last - first, 1, 0, true, [&](int i) { return &gray[static_cast<size_t>(first + i) * w]; });
+        for (int y = s0; y < s1; ++y) {
+            const int top = std::max(0, y - radius) - first;
+            const int bottom = std::min(h, y + radius + 1) - first;
+            for (int x = 0; x < w; ++x) {
+                const size_t left = sat.offset(std::max(0, x - radius));
+                const size_t right = sat.offset(std::min(w, x + radius + 1));
+                const uint64_t n = static_cast<uint64_t>(bottom - top) * (right - left);
+                const uint64_t s = box_sum(sat.sums(top), sat.sums(bottom), left, right, 0);
+                const uint64_t q = box_sum(sat.squares(top), sat.squares(bottom), left, right, 0);
+                const double local = std::sqrt(static_cast<double>(n * q - s * s)) / static_cast<double>(n);
+                sum += local;
+                sum_sq += local * local;
+            }
+        }
+    }
+    const double mean = sum / pixels;
+    features.glcm_features[4 * GLCM_FEATURES] = static_cast<float>(mean);
+    features.glcm_features[4 * GLCM_FEATURES + 1] =
+        static_cast<float>(std::sqrt(std::max(0.0, sum_sq / pixels - mean * mean)));
+    return features;
+}
+
+} // namespace filters
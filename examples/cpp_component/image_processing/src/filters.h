@@ -1,10 +1,12 @@
 #pragma once
 
+#include "fft.h"
 #include "simd_utils.h"
-#include "color_space.h"
 #include <cstdint>
-#include <vector>
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace filters {
 
@@ -44,10 +46,11 @@ struct FilterParams {
     float sigma;           // For Gaussian filters
     int kernel_size;       // Custom kernel size
     bool preserve_alpha;   // Keep alpha channel unchanged
+    float bilateral_grid;  // Bilateral grid cell in sigmas; 0 = exact (see bilateral_filter for its error)
 
     FilterParams() : type(FilterType::BOX_BLUR), radius(1.0f), strength(1.0f),
                     angle(0.0f), threshold(0.5f), sigma(1.0f), kernel_size(3),
-                    preserve_alpha(true) {}
+                    preserve_alpha(true), bilateral_grid(1.0f) {}
 };
 
 // Filter result
@@ -121,6 +124,8 @@ public:
     FilterResult emboss(const uint8_t* src, uint32_t width, uint32_t height,
                        int channels, float strength);
 
+    // Window statistics come from summed-area tables, so the cost per pixel
+    // does not grow with the radius (1 to 127; intensity_levels 1 to 64)
     FilterResult oil_painting(const uint8_t* src, uint32_t width, uint32_t height,
                              int channels, int radius, int intensity_levels);
 
@@ -131,13 +136,31 @@ public:
     FilterResult noise_reduction(const uint8_t* src, uint32_t width, uint32_t height,
                                 int channels, float strength);
 
+    // Exact for small spatial sigmas or grid_cell 0. Otherwise a bilateral
+    // grid with cells grid_cell sigmas wide (at most 2) per axis approximates
+    // it: smaller cells track the exact filter more closely and cost more.
+    // grid_cell sets the cell, not an error bound; the error depends on the
+    // image and grows with intensity_sigma. Measured against grid_cell 0 at
+    // spatial sigmas 3 to 8, at 1 it averages 0.2 to 1.2 levels (at most 5)
+    // on smooth images, but 0.5, 1.3 and 3.8 levels (at most 5, 7 and 12) on
+    // uniform noise at intensity sigmas 13, 26 and 51; at 0.5 both stay
+    // under half a level on average and within 3.
     FilterResult bilateral_filter(const uint8_t* src, uint32_t width, uint32_t height,
-                                 int channels, float spatial_sigma, float intensity_sigma);
+                                 int channels, float spatial_sigma, float intensity_sigma,
+                                 float grid_cell = 1.0f);
 
     FilterResult median_filter(const uint8_t* src, uint32_t width, uint32_t height,
                               int channels, int radius);
 
-    // Custom convolution
+    // Each sample becomes the value at `percentile` of its (2r+1)^2 window
+    // (0 = min, 0.5 = median, 1 = max), clipped at the border. Histogram
+    // based, so the cost per pixel does not grow with the radius.
+    static constexpr int MAX_RANK_RADIUS = 127;
+    FilterResult rank_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                            int channels, int radius, float percentile);
+
+    // Custom convolution; large kernels switch to FFT convolution once it
+    // is cheaper than the spatial pass (results agree within a level)
     FilterResult apply_convolution(const uint8_t* src, uint32_t width, uint32_t height,
                                   int channels, const ConvolutionKernel& kernel);
 
@@ -157,12 +180,20 @@ public:
     static ConvolutionKernel create_laplacian_kernel();
 
     // Performance settings
+    // With SIMD on, Gaussian blurs, box blurs under radius 4 (larger ones
+    // use summed-area tables) and separable convolutions with non-negative
+    // normalized taps use Q8 fixed point, within a level or two of the float path
     void enable_simd(bool enable) { use_simd_ = enable; }
     bool is_simd_enabled() const { return use_simd_; }
 
+    // Row bands run on the shared worker_pool::WorkerPool when enabled
     void enable_multithreading(bool enable) { use_multithreading_ = enable; }
     bool is_multithreading_enabled() const { return use_multithreading_; }
 
+    // Threads per filter, caller included; 0 means one per hardware thread
+    void set_thread_count(unsigned threads) { thread_count_ = threads; }
+    unsigned thread_count() const;  // Effective count, 1 when multithreading is off
+
     // Statistics
     struct FilterStats {
         uint64_t total_filters_applied;
@@ -178,12 +209,19 @@ public:
 private:
     bool use_simd_;
     bool use_multithreading_;
+    unsigned thread_count_;
     FilterStats stats_;
-    simd_utils::SIMDMemoryPool memory_pool_;
+    fft::PlanCache fft_plans_;  // Large kernels in apply_convolution
 
     // Helper functions
     void update_stats(FilterType type, size_t pixel_count, double time_ms);
     bool validate_inputs(const uint8_t* src, uint32_t width, uint32_t height, int channels);
+    FilterResult run_rank_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                 int channels, int radius, float percentile, FilterType type);
+    FilterResult run_bilateral_grid(const uint8_t* src, uint32_t width, uint32_t height, int channels,
+                                    float spatial_sigma, float intensity_sigma, float grid_cell);
+    FilterResult run_box_filter(const uint8_t* src, uint32_t width, uint32_t height,
+                                int channels, int radius, bool preserve_alpha);
 
     // SIMD-optimized implementations
     void simd_box_blur_horizontal(const uint8_t* src, uint8_t* dst, uint32_t width,
@@ -218,7 +256,7 @@ private:
     float gaussian_weight(float distance, float sigma);
     float intensity_weight(float intensity_diff, float sigma);
 
-    // Multi-threading support
+    // Multi-threading support: row_processor(begin, end) over bands of [0, total_rows)
     void process_rows_parallel(const std::function<void(int, int)>& row_processor,
                               int total_rows, int num_threads = 0);
 };
@@ -289,6 +327,11 @@ FilterResult morphological_operation(const uint8_t* src, uint32_t width, uint32_
                                    int channels, MorphOp operation, const MorphElement& element);
 
 // Frequency domain filtering using FFT
+//
+// Frequencies are in cycles per pixel over the padded plane the FFT runs
+// on; cutoffs are fractions of Nyquist (0.5 cycles per pixel), so 1.0 is
+// the highest frequency along an axis. Gains roll off as order-2
+// Butterworth curves to limit ringing. Plans are cached per padded size.
 class FrequencyDomainFilter {
 public:
     FrequencyDomainFilter();
@@ -306,18 +349,26 @@ public:
     FilterResult band_pass_filter(const uint8_t* src, uint32_t width, uint32_t height,
                                  int channels, float low_cutoff, float high_cutoff);
 
-    // Notch filter (removes specific frequencies)
+    // Notch filter (removes the ring of frequencies within bandwidth of center_freq)
     FilterResult notch_filter(const uint8_t* src, uint32_t width, uint32_t height,
                              int channels, float center_freq, float bandwidth);
 
 private:
-    // FFT implementation (simplified - would use a proper FFT library in practice)
-    void fft_2d(float* real, float* imag, int width, int height, bool inverse = false);
-    void apply_frequency_mask(float* real, float* imag, int width, int height,
-                             const std::function<float(float, float)>& mask_func);
+    fft::PlanCache plans_;
+
+    // Every channel but alpha, scaled per frequency by mask_func(fx, fy)
+    // with fx, fy in [-0.5, 0.5] cycles per pixel
+    FilterResult apply_frequency_mask(const uint8_t* src, uint32_t width, uint32_t height, int channels,
+                                      const std::function<float(float, float)>& mask_func);
 };
 
 // Texture analysis and synthesis
+//
+// The scalar features average the gray-level co-occurrence matrix (GLCM) of
+// four directions. glcm_features holds energy, contrast, correlation,
+// homogeneity and entropy for 0, 45, 90 and 135 degrees in turn, then the
+// mean and standard deviation of the local standard deviation over
+// patch_size windows.
 struct TextureFeatures {
     float energy;
     float contrast;
@@ -330,6 +381,12 @@ struct TextureFeatures {
 TextureFeatures analyze_texture(const uint8_t* src, uint32_t width, uint32_t height,
                                int channels, int patch_size = 16);
 
+// How FilterChain::apply_chain schedules its steps; both give identical pixels
+enum class ChainExecution {
+    PER_FILTER,  // Each step over the whole image, materializing every intermediate
+    TILED        // Runs of neighborhood filters fused per tile; only the output is materialized
+};
+
 // Filter chain for applying multiple filters in sequence
 class FilterChain {
 public:
@@ -346,6 +403,22 @@ public:
     void clear() { filters_.clear(); }
     size_t size() const { return filters_.size(); }
 
+    // Execution strategy (TILED by default)
+    void set_execution(ChainExecution mode) { execution_ = mode; }
+    ChainExecution execution() const { return execution_; }
+
+    // Output tile for TILED execution; a width of at least the image width gives strips
+    void set_tile_size(uint32_t width, uint32_t height);
+    uint32_t tile_width() const { return tile_width_; }
+    uint32_t tile_height() const { return tile_height_; }
+
+    // Fixed-point blurs, as in FilterProcessor
+    void enable_simd(bool enable) { processor_.enable_simd(enable); }
+
+    // Rows of tiles, and single steps, spread across threads as in FilterProcessor
+    void enable_multithreading(bool enable) { processor_.enable_multithreading(enable); }
+    void set_thread_count(unsigned threads) { processor_.set_thread_count(threads); }
+
 private:
     struct FilterStep {
         FilterType type;
@@ -356,6 +429,10 @@ private:
 
     std::vector<FilterStep> filters_;
     FilterProcessor processor_;
+
+    ChainExecution execution_;
+    uint32_t tile_width_;
+    uint32_t tile_height_;
 };
 
 } // namespace filters
@@ -0,0 +1,272 @@
+#include "image_store.h"
+
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace image_store {
+
+using color_space::ColorSpaceConverter;
+
+namespace {
+
+std::atomic<size_t> g_live_bytes(0);
+
+size_t chroma_size(uint32_t width, uint32_t height) {
+    return static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+}
+
+// Bytes for a whole tightly packed image; YUV420 is three planes with
+// quarter-size chroma. 0 when the image is empty or would not fit a WIT u32.
+size_t image_bytes(ColorFormat format, uint32_t width, uint32_t height) {
+    uint64_t pixels = static_cast<uint64_t>(width) * height;
+    uint64_t bytes = format == ColorFormat::YUV420
+        ? pixels + 2 * static_cast<uint64_t>(chroma_size(width, height))
+        : pixels * ColorSpaceConverter::get_bytes_per_pixel(format);
+    return bytes <= UINT32_MAX ? static_cast<size_t>(bytes) : 0;
+}
+
+} // namespace
+
+Image::~Image() {
+    unref(storage_);
+}
+
+Image::Image(const Image& other)
+    : storage_(other.storage_), offset_(other.offset_), width_(other.width_),
+      height_(other.height_), stride_(other.stride_), format_(other.format_) {
+    if (storage_) {
+        storage_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Image& Image::operator=(const Image& other) {
+    if (this != &other) {
+        Image copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+Image::Image(Image&& other) noexcept
+    : storage_(other.storage_), offset_(other.offset_), width_(other.width_),
+      height_(other.height_), stride_(other.stride_), format_(other.format_) {
+    other.storage_ = nullptr;
+    other.release();
+}
+
+Image& Image::operator=(Image&& other) noexcept {
+    if (this != &other) {
+        unref(storage_);
+        storage_ = other.storage_;
+        offset_ = other.offset_;
+        width_ = other.width_;
+        height_ = other.height_;
+        stride_ = other.stride_;
+        format_ = other.format_;
+        other.storage_ = nullptr;
+        other.release();
+    }
+    return *this;
+}
+
+Image::Storage* Image::allocate_storage(size_t size) {
+    void* block = simd_utils::aligned_malloc(sizeof(Storage) + size);
+    if (!block) {
+        return nullptr;
+    }
+    Storage* storage = new (block) Storage;
+    storage->refs.store(1, std::memory_order_relaxed);
+    storage->size = size;
+    g_live_bytes.fetch_add(size, std::memory_order_relaxed);
+    return storage;
+}
+
+void Image::unref(Storage* storage) {
+    if (storage && storage->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        g_live_bytes.fetch_sub(storage->size, std::memory_order_relaxed);
+        storage->~Storage();
+        simd_utils::aligned_free(storage);
+    }
+}
+
+size_t Image::live_bytes() {
+    return g_live_bytes.load(std::memory_order_relaxed);
+}
+
+bool Image::create(uint32_t width, uint32_t height, ColorFormat format) {
+    size_t size = image_bytes(format, width, height);
+    Storage* storage = size ? allocate_storage(size) : nullptr;
+    if (!storage) {
+        return false;
+    }
+    std::memset(storage->bytes(), 0, size);
+    unref(storage_);
+    storage_ = storage;
+    offset_ = 0;
+    width_ = width;
+    height_ = height;
+    format_ = format;
+    stride_ = static_cast<uint32_t>(row_bytes());
+    return true;
+}
+
+bool Image::create_from(const uint8_t* pixels, size_t size, uint32_t width, uint32_t height,
+                        ColorFormat format, uint32_t stride) {
+    size_t bytes = image_bytes(format, width, height);
+    if (bytes == 0 || !pixels) {
+        return false;
+    }
+    size_t row = static_cast<size_t>(width) * ColorSpaceConverter::get_bytes_per_pixel(format);
+    if (format == ColorFormat::YUV420) {
+        // Planes are always tightly packed
+        if ((stride != 0 && stride != width) || size < bytes) {
+            return false;
+        }
+        stride = width;
+    } else {
+        stride = stride ? stride : static_cast<uint32_t>(row);
+        if (stride < row || size < static_cast<uint64_t>(stride) * (height - 1) + row) {
+            return false;
+        }
+    }
+
+    Storage* storage = allocate_storage(bytes);
+    if (!storage) {
+        return false;
+    }
+    if (format == ColorFormat::YUV420 || stride == row) {
+        std::memcpy(storage->bytes(), pixels, bytes);
+    } else {
+        for (uint32_t y = 0; y < height; y++) {
+            std::memcpy(storage->bytes() + y * row, pixels + static_cast<size_t>(y) * stride, row);
+        }
+    }
+    unref(storage_);
+    storage_ = storage;
+    offset_ = 0;
+    width_ = width;
+    height_ = height;
+    format_ = format;
+    stride_ = static_cast<uint32_t>(row_bytes());
+    return true;
+}
+
+void Image::release() {
+    unref(storage_);
+    storage_ = nullptr;
+    offset_ = 0;
+    width_ = 0;
+    height_ = 0;
+    stride_ = 0;
+}
+
+size_t Image::row_bytes() const {
+    return static_cast<size_t>(width_) * ColorSpaceConverter::get_bytes_per_pixel(format_);
+}
+
+size_t Image::size_bytes() const {
+    return storage_ ? image_bytes(format_, width_, height_) : 0;
+}
+
+bool Image::is_shared() const {
+    return storage_ && storage_->refs.load(std::memory_order_acquire) > 1;
+}
+
+bool Image::region_valid(const Rect& region) const {
+    if (!storage_ || region.width == 0 || region.height == 0 ||
+        region.x > width_ || region.width > width_ - region.x ||
+        region.y > height_ || region.height > height_ - region.y) {
+        return false;
+    }
+    // Regions of planar images would cut across the chroma planes
+    return format_ != ColorFormat::YUV420 || (region.width == width_ && region.height == height_);
+}
+
+bool Image::detach() {
+    if (!is_shared()) {
+        return storage_ != nullptr;
+    }
+    // Only this image's own pixels, tightly packed: a detached crop drops the
+    // rest of its parent
+    size_t bytes = size_bytes();
+    Storage* storage = allocate_storage(bytes);
+    if (!storage) {
+        return false;
+    }
+    if (!read_pixels(bounds(), storage->bytes(), bytes)) {
+        unref(storage);
+        return false;
+    }
+    unref(storage_);
+    storage_ = storage;
+    offset_ = 0;
+    stride_ = static_cast<uint32_t>(row_bytes());
+    return true;
+}
+
+uint8_t* Image::mutable_data() {
+    return detach() ? storage_->bytes() + offset_ : nullptr;
+}
+
+bool Image::crop(const Rect& region, Image& out) const {
+    if (!region_valid(region)) {
+        return false;
+    }
+    Image view(*this);
+    view.offset_ = offset_ + static_cast<size_t>(region.y) * stride_ +
+                   static_cast<size_t>(region.x) * ColorSpaceConverter::get_bytes_per_pixel(format_);
+    view.width_ = region.width;
+    view.height_ = region.height;
+    out = std::move(view);
+    return true;
+}
+
+size_t Image::region_bytes(const Rect& region) const {
+    if (!region_valid(region)) {
+        return 0;
+    }
+    if (format_ == ColorFormat::YUV420) {
+        return size_bytes();
+    }
+    return static_cast<size_t>(region.width) * region.height *
+           ColorSpaceConverter::get_bytes_per_pixel(format_);
+}
+
+bool Image::read_pixels(const Rect& region, uint8_t* out, size_t out_size) const {
+    size_t bytes = region_bytes(region);
+    if (bytes == 0 || !out || out_size < bytes) {
+        return false;
+    }
+    size_t pixel = ColorSpaceConverter::get_bytes_per_pixel(format_);
+    size_t row = region.width * pixel;
+    const uint8_t* src = data() + static_cast<size_t>(region.y) * stride_ + region.x * pixel;
+    if (format_ == ColorFormat::YUV420 || (row == stride_ && region.x == 0)) {
+        std::memcpy(out, src, bytes);
+        return true;
+    }
+    for (uint32_t y = 0; y < region.height; y++) {
+        std::memcpy(out + y * row, src + static_cast<size_t>(y) * stride_, row);
+    }
+    return true;
+}
+
+bool Image::write_pixels(const Rect& region, const uint8_t* pixels, size_t size) {
+    size_t bytes = region_bytes(region);
+    if (bytes == 0 || !pixels || size < bytes || !detach()) {
+        return false;
+    }
+    size_t pixel = ColorSpaceConverter::get_bytes_per_pixel(format_);
+    size_t row = region.width * pixel;
+    uint8_t* dst = storage_->bytes() + offset_ + static_cast<size_t>(region.y) * stride_ + region.x * pixel;
+    if (format_ == ColorFormat::YUV420 || (row == stride_ && region.x == 0)) {
+        std::memcpy(dst, pixels, bytes);
+        return true;
+    }
+    for (uint32_t y = 0; y < region.height; y++) {
+        std::memcpy(dst + static_cast<size_t>(y) * stride_, pixels + y * row, row);
+    }
+    return true;
+}
+
+} // namespace image_store
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "color_space.h"
+#include "simd_utils.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace image_store {
+
+using color_space::ColorFormat;
+
+// Pixel region; x + width <= image width and y + height <= image height
+struct Rect {
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+/**
+ * Representation of the WIT `image` resource
+ *
+ * Pixels live in reference-counted storage inside the component. Copying an
+ * Image (clone) shares storage, and crop() returns a view of a region of the
+ * same storage with the parent's stride, so neither copies pixels. The first
+ * write through mutable_data() or write_pixels() on storage that is shared
+ * detaches it: the image's own pixels (only the view's region for a crop)
+ * are copied into new, tightly strided storage, and the other handles keep
+ * the old pixels. Reading needs no copy at all.
+ *
+ * Packed formats only have views; a YUV420 image is three planes and can be
+ * cloned, but cropped or read / written only as a whole. Every operation
+ * returns false (leaving the image unchanged) on a bad region or when out
+ * of memory. Handles may be used from different threads as long as no two
+ * threads use the same Image at once.
+ */
+class Image {
+public:
+    Image() = default;
+    ~Image();
+    Image(const Image& other);
+    Image& operator=(const Image& other);
+    Image(Image&& other) noexcept;
+    Image& operator=(Image&& other) noexcept;
+
+    // Zero-filled image; false for an empty or oversized image
+    bool create(uint32_t width, uint32_t height, ColorFormat format);
+    // Copies pixels rows stride bytes apart (0: tightly packed) into new storage
+    bool create_from(const uint8_t* pixels, size_t size, uint32_t width, uint32_t height,
+                     ColorFormat format, uint32_t stride = 0);
+    void release();
+
+    bool valid() const { return storage_ != nullptr; }
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+    ColorFormat format() const { return format_; }
+    uint32_t stride() const { return stride_; }     // Bytes from one row to the next
+    size_t row_bytes() const;                       // Bytes of pixels in a row
+    size_t size_bytes() const;                      // Tightly packed size, all planes
+    bool is_contiguous() const { return stride_ == row_bytes(); }
+    bool is_shared() const;                         // A write would detach
+
+    // Read-only pixels; row y starts at data() + y * stride()
+    const uint8_t* data() const { return storage_ ? storage_->bytes() + offset_ : nullptr; }
+    // Writable pixels after detaching shared storage; nullptr when out of memory
+    uint8_t* mutable_data();
+
+    // Another handle to the same pixels
+    Image clone() const { return *this; }
+    // View of region, sharing storage
+    bool crop(const Rect& region, Image& out) const;
+
+    // Region bytes when tightly packed; 0 for an invalid region
+    size_t region_bytes(const Rect& region) const;
+    // Copies region out tightly packed; out must hold region_bytes(region)
+    bool read_pixels(const Rect& region, uint8_t* out, size_t out_size) const;
+    // Copies tightly packed pixels into region, detaching first if shared
+    bool write_pixels(const Rect& region, const uint8_t* pixels, size_t size);
+
+    Rect bounds() const { return {0, 0, width_, height_}; }
+
+    // Bytes of pixel storage alive in all images
+    static size_t live_bytes();
+
+private:
+    // Header of one allocation; the pixels follow it, SIMD aligned
+    struct alignas(simd_utils::SIMD_ALIGNMENT) Storage {
+        std::atomic<uint32_t> refs;
+        size_t size;
+        uint8_t* bytes() { return reinterpret_cast<uint8_t*>(this + 1); }
+    };
+
+    static Storage* allocate_storage(size_t size);
+    static void unref(Storage* storage);
+    bool region_valid(const Rect& region) const;
+    bool detach();
+
+    Storage* storage_ = nullptr;
+    size_t offset_ = 0;  // Byte offset of the first pixel (views)
+    uint32_t width_ = 0;
+    uint32_t height_ = 0;
+    uint32_t stride_ = 0;
+    ColorFormat format_ = ColorFormat::RGB;
+};
+
+} // namespace image_store
@@ -12,6 +12,24 @@ bool is_simd_supported() {
     return SIMD_SUPPORTED;
 }
 
+SimdLevel simd_level() {
+#if RELAXED_SIMD_SUPPORTED
+    return SimdLevel::RELAXED_SIMD;
+#elif SIMD_SUPPORTED
+    return SimdLevel::SIMD128;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SIMD128: return "simd128";
+        case SimdLevel::RELAXED_SIMD: return "relaxed-simd";
+        default: return "scalar";
+    }
+}
+
 // Memory alignment utilities
 void* aligned_malloc(size_t size, size_t alignment) {
     void* ptr;
@@ -123,6 +141,26 @@ v128_t simd_mul_f32(v128_t a, v128_t b) {
     return wasm_f32x4_mul(a, b);
 }
 
+v128_t simd_div_f32(v128_t a, v128_t b) {
+    return wasm_f32x4_div(a, b);
+}
+
+v128_t simd_madd_f32(v128_t a, v128_t b, v128_t c) {
+#if RELAXED_SIMD_SUPPORTED
+    return wasm_f32x4_relaxed_madd(a, b, c);
+#else
+    return wasm_f32x4_add(wasm_f32x4_mul(a, b), c);
+#endif
+}
+
+v128_t simd_abs_f32(v128_t a) {
+    return wasm_f32x4_abs(a);
+}
+
+v128_t simd_floor_f32(v128_t a) {
+    return wasm_f32x4_floor(a);
+}
+
 // Saturated arithmetic
 v128_t simd_adds_u8(v128_t a, v128_t b) {
     return wasm_u8x16_add_sat(a, b);
@@ -145,6 +183,27 @@ v128_t simd_lt_u8(v128_t a, v128_t b) {
     return wasm_u8x16_lt(a, b);
 }
 
+v128_t simd_eq_u32(v128_t a, v128_t b) {
+    return wasm_i32x4_eq(a, b);
+}
+
+v128_t simd_eq_f32(v128_t a, v128_t b) {
+    return wasm_f32x4_eq(a, b);
+}
+
+v128_t simd_gt_f32(v128_t a, v128_t b) {
+    return wasm_f32x4_gt(a, b);
+}
+
+v128_t simd_lt_f32(v128_t a, v128_t b) {
+    return wasm_f32x4_lt(a, b);
+}
+
+// Lane masks
+uint32_t simd_bitmask_u8(v128_t vec) {
+    return wasm_i8x16_bitmask(vec);
+}
+
 // Bitwise operations
 v128_t simd_and(v128_t a, v128_t b) {
     return wasm_v128_and(a, b);
@@ -162,6 +221,10 @@ v128_t simd_not(v128_t a) {
     return wasm_v128_not(a);
 }
 
+v128_t simd_select(v128_t mask, v128_t a, v128_t b) {
+    return wasm_v128_bitselect(a, b, mask);
+}
+
 // Shift operations
 v128_t simd_shl_u16(v128_t a, int shift) {
     return wasm_i16x8_shl(a, shift);
@@ -311,19 +374,13 @@ v128_t simd_swizzle(v128_t vec, v128_t indices) {
 v128_t simd_shuffle(v128_t a, v128_t b, int c0, int c1, int c2, int c3,
                    int c4, int c5, int c6, int c7, int c8, int c9,
                    int c10, int c11, int c12, int c13, int c14, int c15) {
-    // WebAssembly shuffle requires compile-time constants
-    // This function can only work if called with literal constants
-    // For runtime shuffle indices, use simd_swizzle with an index vector instead
-    #if defined(__wasm_simd128__)
-        // We cannot implement runtime shuffle with WebAssembly SIMD
-        // Return the first vector unchanged as a fallback
-        (void)b; (void)c0; (void)c1; (void)c2; (void)c3; (void)c4; (void)c5; (void)c6; (void)c7;
-        (void)c8; (void)c9; (void)c10; (void)c11; (void)c12; (void)c13; (void)c14; (void)c15;
-        return a;
-    #else
-        // Fallback implementation for non-WASM platforms would go here
-        return a;
-    #endif
+    // i8x16.shuffle needs immediate lanes, so this swizzles each input and
+    // merges: indices past 15 read 0 from a, and after subtracting 16 the
+    // indices of a wrap past 15 and read 0 from b. With literal arguments
+    // and inlining the index vectors are constants.
+    const v128_t indices = wasm_i8x16_make(c0, c1, c2, c3, c4, c5, c6, c7,
+                                           c8, c9, c10, c11, c12, c13, c14, c15);
+    return simd_or(simd_swizzle(a, indices), simd_swizzle(b, simd_sub_u8(indices, simd_splat_u8(16))));
 }
 
 // Type conversion
@@ -339,6 +396,26 @@ v128_t simd_convert_u16_to_u8(v128_t low, v128_t high) {
     return wasm_u8x16_narrow_i16x8(low, high);
 }
 
+v128_t simd_convert_u16_to_u32_low(v128_t vec) {
+    return wasm_u32x4_extend_low_u16x8(vec);
+}
+
+v128_t simd_convert_u16_to_u32_high(v128_t vec) {
+    return wasm_u32x4_extend_high_u16x8(vec);
+}
+
+v128_t simd_convert_u32_to_u16(v128_t low, v128_t high) {
+    return wasm_u16x8_narrow_i32x4(low, high);
+}
+
+v128_t simd_convert_u32_to_f32(v128_t vec) {
+    return wasm_f32x4_convert_u32x4(vec);
+}
+
+v128_t simd_convert_f32_to_u32(v128_t vec) {
+    return wasm_u32x4_trunc_sat_f32x4(vec);
+}
+
 // Horizontal operations
 uint32_t simd_horizontal_add_u8(v128_t vec) {
     uint32_t sum = 0;
@@ -595,6 +672,196 @@ void simd_add_pixels(const uint8_t* src1, const uint8_t* src2, uint8_t* dest, si
 #endif
 }
 
+// Float pixel arithmetic
+
+namespace {
+
+// Rounds and clamps v, computed with the 0.5 folded in, to a byte
+inline uint8_t round_to_byte(float v) {
+    return !(v > 0.0f) ? 0 : (v >= 255.0f ? 255 : static_cast<uint8_t>(v));
+}
+
+inline uint8_t rounded_quotient_255(uint32_t product) {
+    uint32_t t = product + 128;
+    return static_cast<uint8_t>((t + (t >> 8)) >> 8);  // round(product / 255), exact
+}
+
+#if SIMD_SUPPORTED
+
+// 16 bytes as four f32x4 vectors, in byte order
+inline void unpack_f32(v128_t bytes, v128_t out[4]) {
+    v128_t low = simd_convert_u8_to_u16_low(bytes);
+    v128_t high = simd_convert_u8_to_u16_high(bytes);
+    out[0] = simd_convert_u32_to_f32(simd_convert_u16_to_u32_low(low));
+    out[1] = simd_convert_u32_to_f32(simd_convert_u16_to_u32_high(low));
+    out[2] = simd_convert_u32_to_f32(simd_convert_u16_to_u32_low(high));
+    out[3] = simd_convert_u32_to_f32(simd_convert_u16_to_u32_high(high));
+}
+
+// Inverse of unpack_f32 for values with the 0.5 folded in: truncates and
+// clamps to 0-255 (NaN and negatives to 0) like round_to_byte
+inline v128_t pack_bytes(const v128_t in[4]) {
+    const v128_t max = simd_splat_f32(255.0f);
+    v128_t w[4];
+    for (int i = 0; i < 4; i++) {
+        w[i] = simd_convert_f32_to_u32(simd_min_f32(in[i], max));
+    }
+    return simd_convert_u16_to_u8(simd_convert_u32_to_u16(w[0], w[1]), simd_convert_u32_to_u16(w[2], w[3]));
+}
+
+// round(a * b / 255) on u16 lanes holding bytes, as rounded_quotient_255
+inline v128_t div255_u16(v128_t product) {
+    v128_t t = simd_add_u16(product, simd_splat_u16(128));
+    return simd_shr_u16(simd_add_u16(t, simd_shr_u16(t, 8)), 8);
+}
+
+inline v128_t multiply_bytes(v128_t a, v128_t b) {
+    v128_t low = div255_u16(simd_mul_u16(simd_convert_u8_to_u16_low(a), simd_convert_u8_to_u16_low(b)));
+    v128_t high = div255_u16(simd_mul_u16(simd_convert_u8_to_u16_high(a), simd_convert_u8_to_u16_high(b)));
+    return simd_convert_u16_to_u8(low, high);
+}
+
+#endif // SIMD_SUPPORTED
+
+} // namespace
+
+void simd_mul_pixels(const uint8_t* src, uint8_t* dest, float multiplier, size_t pixel_count) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    const v128_t m = simd_splat_f32(multiplier);
+    const v128_t half = simd_splat_f32(0.5f);
+    for (; i + 16 <= pixel_count; i += 16) {
+        v128_t v[4];
+        unpack_f32(simd_load_unaligned(src + i), v);
+        for (int k = 0; k < 4; k++) {
+            v[k] = simd_madd_f32(v[k], m, half);
+        }
+        simd_store_unaligned(dest + i, pack_bytes(v));
+    }
+#endif
+    for (; i < pixel_count; i++) {
+        dest[i] = round_to_byte(src[i] * multiplier + 0.5f);
+    }
+}
+
+void simd_alpha_blend(const uint8_t* src, const uint8_t* dest, uint8_t* result,
+                      size_t pixel_count, float alpha) {
+    alpha = alpha > 0.0f ? std::min(alpha, 1.0f) : 0.0f;
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    // dest + (src - dest) * alpha: one multiply-add per lane
+    const v128_t a = simd_splat_f32(alpha);
+    const v128_t half = simd_splat_f32(0.5f);
+    for (; i + 16 <= pixel_count; i += 16) {
+        v128_t s[4], d[4];
+        unpack_f32(simd_load_unaligned(src + i), s);
+        unpack_f32(simd_load_unaligned(dest + i), d);
+        for (int k = 0; k < 4; k++) {
+            s[k] = simd_madd_f32(simd_sub_f32(s[k], d[k]), a, simd_add_f32(d[k], half));
+        }
+        simd_store_unaligned(result + i, pack_bytes(s));
+    }
+#endif
+    for (; i < pixel_count; i++) {
+        float d = dest[i];
+        result[i] = round_to_byte((src[i] - d) * alpha + (d + 0.5f));
+    }
+}
+
+void simd_multiply_blend(const uint8_t* src1, const uint8_t* src2, uint8_t* dest, size_t pixel_count) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    for (; i + 16 <= pixel_count; i += 16) {
+        simd_store_unaligned(dest + i, multiply_bytes(simd_load_unaligned(src1 + i), simd_load_unaligned(src2 + i)));
+    }
+#endif
+    for (; i < pixel_count; i++) {
+        dest[i] = rounded_quotient_255(static_cast<uint32_t>(src1[i]) * src2[i]);
+    }
+}
+
+void simd_screen_blend(const uint8_t* src1, const uint8_t* src2, uint8_t* dest, size_t pixel_count) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    for (; i + 16 <= pixel_count; i += 16) {
+        v128_t a = simd_not(simd_load_unaligned(src1 + i));
+        v128_t b = simd_not(simd_load_unaligned(src2 + i));
+        simd_store_unaligned(dest + i, simd_not(multiply_bytes(a, b)));
+    }
+#endif
+    for (; i < pixel_count; i++) {
+        dest[i] = 255 - rounded_quotient_255(static_cast<uint32_t>(255 - src1[i]) * (255 - src2[i]));
+    }
+}
+
+void simd_convolve_3x3(const uint8_t* src, uint8_t* dest, int width, int height, int channels,
+                       const float kernel[9], float bias, bool normalize) {
+    if (!src || !dest || width <= 0 || height <= 0 || channels <= 0) {
+        return;
+    }
+    float k[9];
+    float sum = 0.0f;
+    for (int t = 0; t < 9; t++) {
+        sum += kernel[t];
+    }
+    const float scale = normalize && sum != 0.0f ? 1.0f / sum : 1.0f;
+    for (int t = 0; t < 9; t++) {
+        k[t] = kernel[t] * scale;
+    }
+    const float start = bias + 0.5f;
+    const size_t stride = static_cast<size_t>(width) * channels;
+
+    // Taps in the order (dy, dx) row-major; every path accumulates in this order
+    auto scalar_sample = [&](int x, int y, int c) {
+        float acc = start;
+        for (int dy = -1; dy <= 1; dy++) {
+            int yy = std::min(std::max(y + dy, 0), height - 1);
+            for (int dx = -1; dx <= 1; dx++) {
+                int xx = std::min(std::max(x + dx, 0), width - 1);
+                acc = acc + src[yy * stride + static_cast<size_t>(xx) * channels + c] * k[(dy + 1) * 3 + dx + 1];
+            }
+        }
+        return round_to_byte(acc);
+    };
+
+    for (int y = 0; y < height; y++) {
+        uint8_t* out = dest + y * stride;
+        size_t i = 0;
+#if SIMD_SUPPORTED
+        // Interior samples: every tap is in bounds, one vector load per tap
+        if (y > 0 && y < height - 1 && width > 2) {
+            const size_t step = static_cast<size_t>(channels);
+            const v128_t taps[9] = {simd_splat_f32(k[0]), simd_splat_f32(k[1]), simd_splat_f32(k[2]),
+                                    simd_splat_f32(k[3]), simd_splat_f32(k[4]), simd_splat_f32(k[5]),
+                                    simd_splat_f32(k[6]), simd_splat_f32(k[7]), simd_splat_f32(k[8])};
+            for (i = 0; i < step; i++) {
+                out[i] = scalar_sample(0, y, static_cast<int>(i));
+            }
+            const uint8_t* rows[3] = {src + (y - 1) * stride, src + y * stride, src + (y + 1) * stride};
+            for (; i + 16 + step <= stride; i += 16) {
+                v128_t acc[4];
+                for (int lane = 0; lane < 4; lane++) {
+                    acc[lane] = simd_splat_f32(start);
+                }
+                for (int dy = 0; dy < 3; dy++) {
+                    for (int dx = 0; dx < 3; dx++) {
+                        v128_t v[4];
+                        unpack_f32(simd_load_unaligned(rows[dy] + i - step + dx * step), v);
+                        for (int lane = 0; lane < 4; lane++) {
+                            acc[lane] = simd_madd_f32(v[lane], taps[dy * 3 + dx], acc[lane]);
+                        }
+                    }
+                }
+                simd_store_unaligned(out + i, pack_bytes(acc));
+            }
+        }
+#endif
+        for (; i < stride; i++) {
+            out[i] = scalar_sample(static_cast<int>(i / channels), y, static_cast<int>(i % channels));
+        }
+    }
+}
+
 PixelStats simd_calculate_stats(const uint8_t* pixels, size_t pixel_count, int channels) {
     PixelStats stats = {0};
 
@@ -658,6 +925,603 @@ PixelStats simd_calculate_stats(const uint8_t* pixels, size_t pixel_count, int c
     return stats;
 }
 
+// Histogram calculation
+
+namespace {
+
+// Interleaved copies per histogram; four pixels are in flight per step
+constexpr size_t HISTOGRAM_COPIES = 4;
+constexpr size_t HISTOGRAM_BINS = 256;
+
+// hist += the sum of the copies
+void merge_histogram_copies(const uint32_t* copies, uint32_t* hist) {
+#if SIMD_SUPPORTED
+    for (size_t i = 0; i < HISTOGRAM_BINS; i += 4) {
+        v128_t sum = simd_load_unaligned(hist + i);
+        for (size_t k = 0; k < HISTOGRAM_COPIES; ++k) {
+            sum = simd_add_u32(sum, simd_load_unaligned(copies + k * HISTOGRAM_BINS + i));
+        }
+        simd_store_unaligned(hist + i, sum);
+    }
+#else
+    for (size_t i = 0; i < HISTOGRAM_BINS; ++i) {
+        uint32_t sum = hist[i];
+        for (size_t k = 0; k < HISTOGRAM_COPIES; ++k) {
+            sum += copies[k * HISTOGRAM_BINS + i];
+        }
+        hist[i] = sum;
+    }
+#endif
+}
+
+inline uint8_t histogram_luma(const uint8_t* px) {
+    return static_cast<uint8_t>((54 * px[0] + 183 * px[1] + 19 * px[2]) >> 8);
+}
+
+} // namespace
+
+void simd_accumulate_histograms(const uint8_t* pixels, size_t pixel_count, int channels,
+                                uint32_t* const hist[4], uint32_t* luma) {
+    if (!pixels || channels < 1 || channels > 4) {
+        return;
+    }
+    if (channels < 3) {
+        luma = nullptr;
+    }
+
+    // Copies for channels 0-3, then luma
+    const size_t stride = HISTOGRAM_COPIES * HISTOGRAM_BINS;
+    std::vector<uint32_t> copies(5 * stride, 0);
+    uint32_t* luma_copies = copies.data() + 4 * stride;
+
+    size_t i = 0;
+    for (; i + HISTOGRAM_COPIES <= pixel_count; i += HISTOGRAM_COPIES) {
+        const uint8_t* px = pixels + i * channels;
+        for (int c = 0; c < channels; ++c) {
+            uint32_t* h = copies.data() + c * stride;
+            h[px[c]]++;
+            h[HISTOGRAM_BINS + px[channels + c]]++;
+            h[2 * HISTOGRAM_BINS + px[2 * channels + c]]++;
+            h[3 * HISTOGRAM_BINS + px[3 * channels + c]]++;
+        }
+        if (luma) {
+            luma_copies[histogram_luma(px)]++;
+            luma_copies[HISTOGRAM_BINS + histogram_luma(px + channels)]++;
+            luma_copies[2 * HISTOGRAM_BINS + histogram_luma(px + 2 * channels)]++;
+            luma_copies[3 * HISTOGRAM_BINS + histogram_luma(px + 3 * channels)]++;
+        }
+    }
+    for (; i < pixel_count; ++i) {
+        const uint8_t* px = pixels + i * channels;
+        for (int c = 0; c < channels; ++c) {
+            copies[c * stride + px[c]]++;
+        }
+        if (luma) {
+            luma_copies[histogram_luma(px)]++;
+        }
+    }
+
+    for (int c = 0; c < channels; ++c) {
+        if (hist[c]) {
+            merge_histogram_copies(copies.data() + c * stride, hist[c]);
+        }
+    }
+    if (luma) {
+        merge_histogram_copies(luma_copies, luma);
+    }
+}
+
+void simd_calculate_histogram(const uint8_t* pixels, size_t pixel_count, int channels,
+                              uint32_t* hist_r, uint32_t* hist_g, uint32_t* hist_b,
+                              uint32_t* hist_a) {
+    uint32_t* hist[4] = {hist_r, hist_g, hist_b, hist_a};
+    for (uint32_t* h : hist) {
+        if (h) {
+            std::fill(h, h + HISTOGRAM_BINS, 0u);
+        }
+    }
+    for (int c = std::max(channels, 0); c < 4; ++c) {
+        hist[c] = nullptr;
+    }
+    simd_accumulate_histograms(pixels, pixel_count, channels, hist);
+}
+
+void simd_fold_histogram(const uint32_t* hist256, uint32_t bins, uint32_t* out) {
+    if (bins == 0) {
+        return;
+    }
+    for (uint32_t v = 0; v < HISTOGRAM_BINS; ++v) {
+        out[static_cast<uint64_t>(v) * bins / HISTOGRAM_BINS] += hist256[v];
+    }
+}
+
+// Color model kernels
+
+namespace {
+
+#if SIMD_SUPPORTED
+
+// Pixels a kernel may convert: 16-byte loads of 3-byte pixels read up to
+// two pixels past the four they convert
+inline size_t color_run(size_t pixel_count, int channels) {
+    const size_t slack = channels == 3 ? 2 : 0;
+    return pixel_count > slack ? (pixel_count - slack) & ~size_t(3) : 0;
+}
+
+// Channel c of four pixels as u32 lanes
+inline v128_t channel_u32(v128_t pixels, int channels, int c) {
+    return simd_shuffle(pixels, simd_splat_u8(0),
+                        c, 16, 16, 16, c + channels, 16, 16, 16,
+                        c + 2 * channels, 16, 16, 16, c + 3 * channels, 16, 16, 16);
+}
+
+inline v128_t channel_unit(v128_t pixels, int channels, int c) {
+    return simd_div_f32(simd_convert_u32_to_f32(channel_u32(pixels, channels, c)), simd_splat_f32(255.0f));
+}
+
+// Values already in 0-255: truncate value + 0.5, as unit_to_u8 does
+inline v128_t round_to_u32(v128_t value) {
+    return simd_convert_f32_to_u32(simd_add_f32(simd_min_f32(simd_max_f32(value, simd_splat_f32(0.0f)),
+                                                             simd_splat_f32(255.0f)),
+                                                simd_splat_f32(0.5f)));
+}
+
+inline v128_t unit_to_u32(v128_t unit) {
+    return round_to_u32(simd_mul_f32(unit, simd_splat_f32(255.0f)));
+}
+
+// Four pixels from three u32 lanes of bytes (and alpha for 4 channels)
+inline void store_pixels(uint8_t* dst, int channels, uint8_t alpha, v128_t c0, v128_t c1, v128_t c2) {
+    v128_t packed = simd_or(c0, simd_or(simd_shl_u32(c1, 8), simd_shl_u32(c2, 16)));
+    if (channels == 4) {
+        simd_store_unaligned(dst, simd_or(packed, simd_splat_u32(static_cast<uint32_t>(alpha) << 24)));
+        return;
+    }
+    packed = simd_shuffle(packed, packed, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 16, 16, 16, 16);
+    uint8_t bytes[16];
+    simd_store_unaligned(bytes, packed);
+    std::memcpy(dst, bytes, 12);
+}
+
+// Hue in 256 steps per turn; the sector formulas of color_space's
+// hue_degrees, picked per lane
+v128_t hue_steps(v128_t r, v128_t g, v128_t b, v128_t max, v128_t delta) {
+    const v128_t zero = simd_splat_f32(0.0f);
+    const v128_t is_r = simd_eq_f32(max, r);
+    const v128_t is_g = simd_and(simd_eq_f32(max, g), simd_not(is_r));
+    const v128_t difference = simd_select(is_r, simd_sub_f32(g, b),
+                                          simd_select(is_g, simd_sub_f32(b, r), simd_sub_f32(r, g)));
+    const v128_t offset = simd_select(is_r, zero, simd_select(is_g, simd_splat_f32(2.0f), simd_splat_f32(4.0f)));
+    v128_t h = simd_mul_f32(simd_splat_f32(60.0f), simd_add_f32(simd_div_f32(difference, delta), offset));
+    h = simd_add_f32(h, simd_and(simd_lt_f32(h, zero), simd_splat_f32(360.0f)));
+    h = simd_and(h, simd_gt_f32(delta, zero));
+    h = simd_div_f32(simd_mul_f32(h, simd_splat_f32(256.0f)), simd_splat_f32(360.0f));
+    return simd_and(simd_convert_f32_to_u32(simd_add_f32(h, simd_splat_f32(0.5f))), simd_splat_u32(255));
+}
+
+// color_space's chroma_to_rgb: the two nonzero components of each sector
+void chroma_to_rgb(v128_t hue, v128_t chroma, v128_t offset, v128_t& r, v128_t& g, v128_t& b) {
+    const v128_t sector = simd_mul_f32(simd_convert_u32_to_f32(hue), simd_splat_f32(6.0f / 256.0f));
+    const v128_t wrapped = simd_sub_f32(sector, simd_mul_f32(simd_splat_f32(2.0f),
+                                                             simd_floor_f32(simd_mul_f32(sector, simd_splat_f32(0.5f)))));
+    const v128_t x = simd_mul_f32(chroma, simd_sub_f32(simd_splat_f32(1.0f),
+                                                       simd_abs_f32(simd_sub_f32(wrapped, simd_splat_f32(1.0f)))));
+    const v128_t index = simd_convert_f32_to_u32(sector);
+    v128_t in_sector[6];
+    for (uint32_t k = 0; k < 6; ++k) {
+        in_sector[k] = simd_eq_u32(index, simd_splat_u32(k));
+    }
+    const v128_t zero = simd_splat_f32(0.0f);
+    auto component = [&](int chroma_a, int chroma_b, int x_a, int x_b) {
+        v128_t value = simd_select(simd_or(in_sector[x_a], in_sector[x_b]), x, zero);
+        value = simd_select(simd_or(in_sector[chroma_a], in_sector[chroma_b]), chroma, value);
+        return unit_to_u32(simd_add_f32(value, offset));
+    };
+    r = component(0, 5, 1, 4);
+    g = component(1, 2, 0, 3);
+    b = component(3, 4, 2, 5);
+}
+
+#endif
+
+} // namespace
+
+size_t simd_rgb_to_hsv(const uint8_t* src, int channels, uint8_t* hsv, size_t pixel_count) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    if (channels != 3 && channels != 4) {
+        return 0;
+    }
+    const v128_t zero = simd_splat_f32(0.0f);
+    for (const size_t end = color_run(pixel_count, channels); i < end; i += 4) {
+        const v128_t pixels = simd_load_unaligned(src + i * channels);
+        const v128_t r = channel_unit(pixels, channels, 0);
+        const v128_t g = channel_unit(pixels, channels, 1);
+        const v128_t b = channel_unit(pixels, channels, 2);
+        const v128_t max = simd_max_f32(r, simd_max_f32(g, b));
+        const v128_t delta = simd_sub_f32(max, simd_min_f32(r, simd_min_f32(g, b)));
+        const v128_t s = simd_and(unit_to_u32(simd_div_f32(delta, max)), simd_gt_f32(max, zero));
+        store_pixels(hsv + i * 3, 3, 0, hue_steps(r, g, b, max, delta), s, unit_to_u32(max));
+    }
+#else
+    (void)src; (void)channels; (void)hsv; (void)pixel_count;
+#endif
+    return i;
+}
+
+size_t simd_rgb_to_hsl(const uint8_t* src, int channels, uint8_t* hsl, size_t pixel_count) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    if (channels != 3 && channels != 4) {
+        return 0;
+    }
+    const v128_t zero = simd_splat_f32(0.0f);
+    const v128_t one = simd_splat_f32(1.0f);
+    for (const size_t end = color_run(pixel_count, channels); i < end; i += 4) {
+        const v128_t pixels = simd_load_unaligned(src + i * channels);
+        const v128_t r = channel_unit(pixels, channels, 0);
+        const v128_t g = channel_unit(pixels, channels, 1);
+        const v128_t b = channel_unit(pixels, channels, 2);
+        const v128_t max = simd_max_f32(r, simd_max_f32(g, b));
+        const v128_t min = simd_min_f32(r, simd_min_f32(g, b));
+        const v128_t delta = simd_sub_f32(max, min);
+        const v128_t lightness = simd_mul_f32(simd_add_f32(max, min), simd_splat_f32(0.5f));
+        const v128_t denom = simd_sub_f32(one, simd_abs_f32(simd_sub_f32(simd_mul_f32(simd_splat_f32(2.0f), lightness), one)));
+        const v128_t has_s = simd_and(simd_gt_f32(delta, zero), simd_gt_f32(denom, zero));
+        const v128_t s = simd_and(unit_to_u32(simd_div_f32(delta, denom)), has_s);
+        store_pixels(hsl + i * 3, 3, 0, hue_steps(r, g, b, max, delta), s, unit_to_u32(lightness));
+    }
+#else
+    (void)src; (void)channels; (void)hsl; (void)pixel_count;
+#endif
+    return i;
+}
+
+size_t simd_hsv_to_rgb(const uint8_t* hsv, uint8_t* dst, int channels, uint8_t alpha, size_t pixel_count) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    if (channels != 3 && channels != 4) {
+        return 0;
+    }
+    for (const size_t end = color_run(pixel_count, 3); i < end; i += 4) {
+        const v128_t pixels = simd_load_unaligned(hsv + i * 3);
+        const v128_t value = channel_unit(pixels, 3, 2);
+        const v128_t chroma = simd_mul_f32(value, channel_unit(pixels, 3, 1));
+        v128_t r, g, b;
+        chroma_to_rgb(channel_u32(pixels, 3, 0), chroma, simd_sub_f32(value, chroma), r, g, b);
+        store_pixels(dst + i * channels, channels, alpha, r, g, b);
+    }
+#else
+    (void)hsv; (void)dst; (void)channels; (void)alpha; (void)pixel_count;
+#endif
+    return i;
+}
+
+size_t simd_hsl_to_rgb(const uint8_t* hsl, uint8_t* dst, int channels, uint8_t alpha, size_t pixel_count) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    if (channels != 3 && channels != 4) {
+        return 0;
+    }
+    const v128_t one = simd_splat_f32(1.0f);
+    for (const size_t end = color_run(pixel_count, 3); i < end; i += 4) {
+        const v128_t pixels = simd_load_unaligned(hsl + i * 3);
+        const v128_t lightness = channel_unit(pixels, 3, 2);
+        const v128_t spread = simd_sub_f32(one, simd_abs_f32(simd_sub_f32(simd_mul_f32(simd_splat_f32(2.0f), lightness), one)));
+        const v128_t chroma = simd_mul_f32(spread, channel_unit(pixels, 3, 1));
+        v128_t r, g, b;
+        chroma_to_rgb(channel_u32(pixels, 3, 0), chroma,
+                      simd_sub_f32(lightness, simd_mul_f32(chroma, simd_splat_f32(0.5f))), r, g, b);
+        store_pixels(dst + i * channels, channels, alpha, r, g, b);
+    }
+#else
+    (void)hsl; (void)dst; (void)channels; (void)alpha; (void)pixel_count;
+#endif
+    return i;
+}
+
+// CIE L*a*b*
+
+namespace {
+
+// sRGB primaries to XYZ, with the D65 white point divided out of X and Z
+// so that white maps to (1, 1, 1)
+constexpr float RGB_TO_XYZ[3][3] = {
+    {0.4124564f / 0.95047f, 0.3575761f / 0.95047f, 0.1804375f / 0.95047f},
+    {0.2126729f, 0.7151522f, 0.0721750f},
+    {0.0193339f / 1.08883f, 0.1191920f / 1.08883f, 0.9503041f / 1.08883f},
+};
+constexpr float XYZ_TO_RGB[3][3] = {
+    {3.2404542f * 0.95047f, -1.5371385f, -0.4985314f * 1.08883f},
+    {-0.9692660f * 0.95047f, 1.8760108f, 0.0415560f * 1.08883f},
+    {0.0556434f * 0.95047f, -0.2040259f, 1.0572252f * 1.08883f},
+};
+constexpr float LAB_EPSILON = 216.0f / 24389.0f;  // (6/29)^3
+constexpr float LAB_KAPPA = 24389.0f / 27.0f;
+constexpr float LAB_DELTA = 6.0f / 29.0f;
+
+// Linear light of each sRGB byte, and the linear values halfway between
+// consecutive bytes: a byte is the number of midpoints below its value
+struct SrgbTables {
+    float linear[256];
+    float midpoints[255];
+
+    SrgbTables() {
+        auto decode = [](double c) {
+            return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+        };
+        for (int v = 0; v < 256; ++v) {
+            linear[v] = static_cast<float>(decode(v / 255.0));
+        }
+        for (int v = 0; v < 255; ++v) {
+            midpoints[v] = static_cast<float>(decode((v + 0.5) / 255.0));
+        }
+    }
+};
+
+const SrgbTables& srgb_tables() {
+    static const SrgbTables tables;
+    return tables;
+}
+
+inline uint8_t encode_srgb(const SrgbTables& tables, float linear) {
+    int v = 0;
+    for (int step = 128; step > 0; step >>= 1) {
+        if (v + step <= 255 && tables.midpoints[v + step - 1] < linear) {
+            v += step;
+        }
+    }
+    return static_cast<uint8_t>(v);
+}
+
+inline uint8_t lab_byte(float v) {
+    return static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, v)) + 0.5f);
+}
+
+inline float lab_f(float t) {
+    return t > LAB_EPSILON ? std::cbrt(t) : (LAB_KAPPA * t + 16.0f) / 116.0f;
+}
+
+inline float lab_f_inverse(float t) {
+    return t > LAB_DELTA ? t * t * t : (116.0f * t - 16.0f) / LAB_KAPPA;
+}
+
+void rgb_to_lab_pixel(const SrgbTables& tables, const uint8_t* rgb, uint8_t* lab) {
+    const float r = tables.linear[rgb[0]], g = tables.linear[rgb[1]], b = tables.linear[rgb[2]];
+    float f[3];
+    for (int k = 0; k < 3; ++k) {
+        f[k] = lab_f(RGB_TO_XYZ[k][0] * r + RGB_TO_XYZ[k][1] * g + RGB_TO_XYZ[k][2] * b);
+    }
+    lab[0] = lab_byte((116.0f * f[1] - 16.0f) * 2.55f);
+    lab[1] = lab_byte(500.0f * (f[0] - f[1]) + 128.0f);
+    lab[2] = lab_byte(200.0f * (f[1] - f[2]) + 128.0f);
+}
+
+void lab_to_rgb_pixel(const SrgbTables& tables, const uint8_t* lab, uint8_t* rgb) {
+    const float fy = (lab[0] / 2.55f + 16.0f) / 116.0f;
+    const float x = lab_f_inverse(fy + (lab[1] - 128.0f) / 500.0f);
+    const float y = lab_f_inverse(fy);
+    const float z = lab_f_inverse(fy - (lab[2] - 128.0f) / 200.0f);
+    for (int k = 0; k < 3; ++k) {
+        rgb[k] = encode_srgb(tables, XYZ_TO_RGB[k][0] * x + XYZ_TO_RGB[k][1] * y + XYZ_TO_RGB[k][2] * z);
+    }
+}
+
+#if SIMD_SUPPORTED
+
+// Cube root for t > LAB_EPSILON: a third of the exponent from the bits
+// (the integer-to-float difference of the bit patterns), then three Newton
+// steps y = (2y + t / y^2) / 3
+inline v128_t cube_root(v128_t t) {
+    v128_t y = simd_convert_u32_to_f32(t);
+    y = simd_add_f32(simd_mul_f32(y, simd_splat_f32(1.0f / 3.0f)), simd_splat_f32(709921077.0f));
+    y = simd_convert_f32_to_u32(y);
+    const v128_t third = simd_splat_f32(1.0f / 3.0f);
+    for (int k = 0; k < 3; ++k) {
+        y = simd_mul_f32(simd_add_f32(simd_add_f32(y, y), simd_div_f32(t, simd_mul_f32(y, y))), third);
+    }
+    return y;
+}
+
+inline v128_t lab_f(v128_t t) {
+    const v128_t linear = simd_div_f32(simd_add_f32(simd_mul_f32(simd_splat_f32(LAB_KAPPA), t), simd_splat_f32(16.0f)),
+                                       simd_splat_f32(116.0f));
+    return simd_select(simd_gt_f32(t, simd_splat_f32(LAB_EPSILON)), cube_root(t), linear);
+}
+
+inline v128_t lab_f_inverse(v128_t t) {
+    const v128_t linear = simd_div_f32(simd_sub_f32(simd_mul_f32(simd_splat_f32(116.0f), t), simd_splat_f32(16.0f)),
+                                       simd_splat_f32(LAB_KAPPA));
+    return simd_select(simd_gt_f32(t, simd_splat_f32(LAB_DELTA)), simd_mul_f32(t, simd_mul_f32(t, t)), linear);
+}
+
+inline v128_t matrix_row(const float* row, v128_t a, v128_t b, v128_t c) {
+    return simd_add_f32(simd_add_f32(simd_mul_f32(simd_splat_f32(row[0]), a), simd_mul_f32(simd_splat_f32(row[1]), b)),
+                        simd_mul_f32(simd_splat_f32(row[2]), c));
+}
+
+#endif
+
+} // namespace
+
+void simd_rgb_to_lab(const uint8_t* rgb, uint8_t* lab, size_t pixel_count) {
+    const SrgbTables& tables = srgb_tables();
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    for (const size_t end = pixel_count & ~size_t(3); i < end; i += 4) {
+        // No gather: the linear values are looked up a lane at a time
+        const uint8_t* px = rgb + i * 3;
+        const float* lin = tables.linear;
+        const v128_t r = wasm_f32x4_make(lin[px[0]], lin[px[3]], lin[px[6]], lin[px[9]]);
+        const v128_t g = wasm_f32x4_make(lin[px[1]], lin[px[4]], lin[px[7]], lin[px[10]]);
+        const v128_t b = wasm_f32x4_make(lin[px[2]], lin[px[5]], lin[px[8]], lin[px[11]]);
+        const v128_t fx = lab_f(matrix_row(RGB_TO_XYZ[0], r, g, b));
+        const v128_t fy = lab_f(matrix_row(RGB_TO_XYZ[1], r, g, b));
+        const v128_t fz = lab_f(matrix_row(RGB_TO_XYZ[2], r, g, b));
+        const v128_t l = simd_mul_f32(simd_sub_f32(simd_mul_f32(simd_splat_f32(116.0f), fy), simd_splat_f32(16.0f)),
+                                      simd_splat_f32(2.55f));
+        const v128_t a = simd_add_f32(simd_mul_f32(simd_splat_f32(500.0f), simd_sub_f32(fx, fy)), simd_splat_f32(128.0f));
+        const v128_t bb = simd_add_f32(simd_mul_f32(simd_splat_f32(200.0f), simd_sub_f32(fy, fz)), simd_splat_f32(128.0f));
+        store_pixels(lab + i * 3, 3, 0, round_to_u32(l), round_to_u32(a), round_to_u32(bb));
+    }
+#endif
+    for (; i < pixel_count; ++i) {
+        rgb_to_lab_pixel(tables, rgb + i * 3, lab + i * 3);
+    }
+}
+
+void simd_lab_to_rgb(const uint8_t* lab, uint8_t* rgb, size_t pixel_count) {
+    const SrgbTables& tables = srgb_tables();
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    for (const size_t end = color_run(pixel_count, 3); i < end; i += 4) {
+        const v128_t pixels = simd_load_unaligned(lab + i * 3);
+        const v128_t fy = simd_div_f32(simd_add_f32(simd_div_f32(simd_convert_u32_to_f32(channel_u32(pixels, 3, 0)),
+                                                                 simd_splat_f32(2.55f)),
+                                                    simd_splat_f32(16.0f)),
+                                       simd_splat_f32(116.0f));
+        const v128_t a = simd_sub_f32(simd_convert_u32_to_f32(channel_u32(pixels, 3, 1)), simd_splat_f32(128.0f));
+        const v128_t b = simd_sub_f32(simd_convert_u32_to_f32(channel_u32(pixels, 3, 2)), simd_splat_f32(128.0f));
+        const v128_t x = lab_f_inverse(simd_add_f32(fy, simd_div_f32(a, simd_splat_f32(500.0f))));
+        const v128_t y = lab_f_inverse(fy);
+        const v128_t z = lab_f_inverse(simd_sub_f32(fy, simd_div_f32(b, simd_splat_f32(200.0f))));
+        // sRGB encoding searches the midpoint table, a lane at a time
+        float linear[3][4];
+        for (int k = 0; k < 3; ++k) {
+            simd_store_unaligned(linear[k], matrix_row(XYZ_TO_RGB[k], x, y, z));
+        }
+        uint8_t* out = rgb + i * 3;
+        for (int p = 0; p < 4; ++p) {
+            for (int k = 0; k < 3; ++k) {
+                out[p * 3 + k] = encode_srgb(tables, linear[k][p]);
+            }
+        }
+    }
+#endif
+    for (; i < pixel_count; ++i) {
+        lab_to_rgb_pixel(tables, lab + i * 3, rgb + i * 3);
+    }
+}
+
+// Table lookup
+
+void simd_apply_lut(const uint8_t* src, uint8_t* dst, size_t count, const uint8_t lut[256], bool keep_alpha) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    v128_t chunks[16];
+    for (int k = 0; k < 16; ++k) {
+        chunks[k] = simd_load_unaligned(lut + 16 * k);
+    }
+    alignas(16) static const uint8_t alpha_lanes[16] = {0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff, 0, 0, 0, 0xff};
+    const v128_t alpha = keep_alpha ? simd_load(alpha_lanes) : simd_splat_u8(0);
+    const v128_t step = simd_splat_u8(16);
+    for (; i + 16 <= count; i += 16) {
+        const v128_t in = simd_load_unaligned(src + i);
+        // Chunk k sees value - 16k, which is in range only for its own values
+        v128_t index = in;
+        v128_t out = simd_swizzle(chunks[0], index);
+        for (int k = 1; k < 16; ++k) {
+            index = simd_sub_u8(index, step);
+            out = simd_or(out, simd_swizzle(chunks[k], index));
+        }
+        out = simd_or(simd_and(out, simd_not(alpha)), simd_and(in, alpha));
+        simd_store_unaligned(dst + i, out);
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = keep_alpha && (i & 3) == 3 ? src[i] : lut[src[i]];
+    }
+}
+
+// Summed-area table rows
+
+void simd_accumulate_columns(const uint8_t* row, size_t count, uint32_t* sums, uint32_t* squares) {
+    size_t i = 0;
+#if SIMD_SUPPORTED
+    // Squares of u8 fit u16 lanes, so both widen from the same halves
+    for (; i + 16 <= count; i += 16) {
+        v128_t pixels = simd_load_unaligned(row + i);
+        v128_t halves[2] = {simd_convert_u8_to_u16_low(pixels), simd_convert_u8_to_u16_high(pixels)};
+        for (int k = 0; k < 2; ++k) {
+            uint32_t* s = sums + i + 8 * k;
+            simd_store_unaligned(s, simd_add_u32(simd_load_unaligned(s), simd_convert_u16_to_u32_low(halves[k])));
+            simd_store_unaligned(s + 4, simd_add_u32(simd_load_unaligned(s + 4), simd_convert_u16_to_u32_high(halves[k])));
+            if (squares) {
+                v128_t sq = simd_mul_u16(halves[k], halves[k]);
+                uint32_t* q = squares + i + 8 * k;
+                simd_store_unaligned(q, simd_add_u32(simd_load_unaligned(q), simd_convert_u16_to_u32_low(sq)));
+                simd_store_unaligned(q + 4, simd_add_u32(simd_load_unaligned(q + 4), simd_convert_u16_to_u32_high(sq)));
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        sums[i] += row[i];
+        if (squares) {
+            squares[i] += static_cast<uint32_t>(row[i]) * row[i];
+        }
+    }
+}
+
+void simd_prefix_sum_u32(const uint32_t* in, size_t pixel_count, int channels, uint32_t* out) {
+    if (channels < 1) {
+        return;
+    }
+    const size_t step = static_cast<size_t>(channels);
+    std::fill(out, out + step, 0u);
+    size_t p = 0;
+#if SIMD_SUPPORTED
+    if (channels == 1) {
+        // Four samples at a time: an in-register scan, plus the carry
+        const v128_t zero = simd_splat_u32(0);
+        v128_t carry = zero;
+        for (; p + 4 <= pixel_count; p += 4) {
+            v128_t v = simd_load_unaligned(in + p);
+            v = simd_add_u32(v, wasm_i32x4_shuffle(zero, v, 3, 4, 5, 6));
+            v = simd_add_u32(v, wasm_i32x4_shuffle(zero, v, 2, 3, 4, 5));
+            v = simd_add_u32(v, carry);
+            simd_store_unaligned(out + p + 1, v);
+            carry = wasm_i32x4_shuffle(v, v, 3, 3, 3, 3);
+        }
+    } else if (channels == 2) {
+        const v128_t zero = simd_splat_u32(0);
+        v128_t carry = zero;
+        for (; p + 2 <= pixel_count; p += 2) {
+            v128_t v = simd_load_unaligned(in + p * 2);
+            v = simd_add_u32(simd_add_u32(v, wasm_i32x4_shuffle(zero, v, 2, 3, 4, 5)), carry);
+            simd_store_unaligned(out + p * 2 + 2, v);
+            carry = wasm_i32x4_shuffle(v, v, 2, 3, 2, 3);
+        }
+    } else if (channels == 3) {
+        // One pixel per vector; lane 3 holds the next pixel's first sample,
+        // which the following store overwrites, so the last pixel is left
+        // to the scalar loop
+        v128_t sum = simd_splat_u32(0);
+        for (; p + 1 < pixel_count; ++p) {
+            sum = simd_add_u32(sum, simd_load_unaligned(in + p * 3));
+            simd_store_unaligned(out + (p + 1) * 3, sum);
+        }
+    } else {
+        // Each pixel adds onto the previous one, four channels per vector
+        const size_t vector_end = step & ~size_t(3);
+        for (; p < pixel_count; ++p) {
+            const uint32_t* prev = out + p * step;
+            uint32_t* next = out + (p + 1) * step;
+            const uint32_t* samples = in + p * step;
+            for (size_t k = 0; k < vector_end; k += 4) {
+                simd_store_unaligned(next + k, simd_add_u32(simd_load_unaligned(prev + k), simd_load_unaligned(samples + k)));
+            }
+            for (size_t k = vector_end; k < step; ++k) {
+                next[k] = prev[k] + samples[k];
+            }
+        }
+    }
+#endif
+    for (size_t i = p * step; i < pixel_count * step; ++i) {
+        out[i + step] = out[i] + in[i];
+    }
+}
+
 // Performance measurement
 SIMDTimer::SIMDTimer() : start_time_(0), end_time_(0) {}
 
@@ -680,48 +1544,178 @@ double SIMDTimer::megapixels_per_second(size_t pixel_count) const {
 }
 
 // Memory pool implementation
-SIMDMemoryPool::SIMDMemoryPool(size_t pool_size)
-    : pool_size_(align_size(pool_size)), used_size_(0) {
-    pool_ = static_cast<uint8_t*>(aligned_malloc(pool_size_));
-    if (pool_) {
-        blocks_.reserve(64);  // Pre-allocate space for block tracking
+
+namespace {
+
+// Spin lock around the pool's lists; every critical section is a few loads
+// and stores, or one aligned_malloc when a chunk runs out
+class PoolLock {
+public:
+    explicit PoolLock(std::atomic_flag& flag) : flag_(flag) {
+        while (flag_.test_and_set(std::memory_order_acquire)) {
+        }
     }
+    ~PoolLock() { flag_.clear(std::memory_order_release); }
+
+private:
+    std::atomic_flag& flag_;
+};
+
+// Smallest class whose blocks hold bytes (at most MAX_BLOCK)
+inline int size_class_of(size_t bytes) {
+    int k = 0;
+    while ((SIMDMemoryPool::MIN_BLOCK << k) < bytes) {
+        ++k;
+    }
+    return k;
 }
 
+} // namespace
+
+SIMDMemoryPool::SIMDMemoryPool(size_t chunk_size)
+    : chunk_size_(align_size(std::max(chunk_size, MIN_BLOCK))), chunk_next_(nullptr), chunk_end_(nullptr),
+      free_(), large_(nullptr), pool_size_(0), used_size_(0), peak_size_(0), allocations_(0),
+      system_allocations_(0) {}
+
 SIMDMemoryPool::~SIMDMemoryPool() {
-    aligned_free(pool_);
+    free_all();
+}
+
+SIMDMemoryPool& SIMDMemoryPool::shared() {
+    static SIMDMemoryPool pool;
+    return pool;
 }
 
 void* SIMDMemoryPool::allocate(size_t size) {
-    if (!pool_) return nullptr;
+    if (size > SIZE_MAX / 2) {
+        return nullptr;
+    }
+    const size_t bytes = align_size(size + sizeof(BlockHeader));
+    if (bytes > MAX_BLOCK) {
+        BlockHeader* block = static_cast<BlockHeader*>(aligned_malloc(bytes));
+        if (!block) {
+            return nullptr;
+        }
+        block->bytes = bytes;
+        block->size_class = -1;
+        PoolLock lock(lock_);
+        block->next = large_;
+        large_ = block;
+        pool_size_ += bytes;
+        system_allocations_++;
+        used_size_ += bytes;
+        peak_size_ = std::max(peak_size_, used_size_);
+        allocations_++;
+        return block + 1;
+    }
 
-    size = align_size(size);
+    const int k = size_class_of(bytes);
+    PoolLock lock(lock_);
+    BlockHeader* block = free_[k];
+    if (block) {
+        free_[k] = block->next;
+    } else if (!(block = carve(MIN_BLOCK << k))) {
+        return nullptr;
+    }
+    block->size_class = k;
+    used_size_ += block->bytes;
+    peak_size_ = std::max(peak_size_, used_size_);
+    allocations_++;
+    return block + 1;
+}
 
-    if (used_size_ + size > pool_size_) {
-        return nullptr;  // Not enough space
+void SIMDMemoryPool::deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+    BlockHeader* block = static_cast<BlockHeader*>(ptr) - 1;
+    PoolLock lock(lock_);
+    used_size_ -= block->bytes;
+    if (block->size_class >= 0) {
+        block->next = free_[block->size_class];
+        free_[block->size_class] = block;
+        return;
     }
+    // Large blocks are few; unlinking walks their list
+    for (BlockHeader** link = &large_; *link; link = &(*link)->next) {
+        if (*link == block) {
+            *link = block->next;
+            break;
+        }
+    }
+    pool_size_ -= block->bytes;
+    aligned_free(block);
+}
 
-    void* ptr = pool_ + used_size_;
-    used_size_ += size;
+void SIMDMemoryPool::reset() {
+    PoolLock lock(lock_);
+    free_all();
+}
 
-    Block block = {ptr, size, false};
-    blocks_.push_back(block);
+SIMDMemoryPool::Stats SIMDMemoryPool::stats() const {
+    PoolLock lock(lock_);
+    return {pool_size_, used_size_, peak_size_, allocations_, system_allocations_};
+}
 
-    return ptr;
+void SIMDMemoryPool::reset_peak() {
+    PoolLock lock(lock_);
+    peak_size_ = used_size_;
 }
 
-void SIMDMemoryPool::deallocate(void* ptr) {
-    for (auto& block : blocks_) {
-        if (block.ptr == ptr) {
-            block.free = true;
-            break;
+// A bytes-sized block from the newest chunk, starting a new chunk when it
+// is too short; called with the lock held
+SIMDMemoryPool::BlockHeader* SIMDMemoryPool::carve(size_t bytes) {
+    if (static_cast<size_t>(chunk_end_ - chunk_next_) < bytes) {
+        const size_t chunk_bytes = std::max(chunk_size_, bytes);
+        uint8_t* chunk = static_cast<uint8_t*>(aligned_malloc(chunk_bytes));
+        if (!chunk) {
+            return nullptr;
         }
+        retire_chunk_tail();
+        chunks_.push_back(chunk);
+        chunk_next_ = chunk;
+        chunk_end_ = chunk + chunk_bytes;
+        pool_size_ += chunk_bytes;
+        system_allocations_++;
+    }
+    BlockHeader* block = reinterpret_cast<BlockHeader*>(chunk_next_);
+    block->bytes = bytes;
+    chunk_next_ += bytes;
+    return block;
+}
+
+// The newest chunk's unused tail, as free blocks of the largest classes
+// that fit
+void SIMDMemoryPool::retire_chunk_tail() {
+    while (static_cast<size_t>(chunk_end_ - chunk_next_) >= MIN_BLOCK) {
+        int k = SIZE_CLASSES - 1;
+        while ((MIN_BLOCK << k) > static_cast<size_t>(chunk_end_ - chunk_next_)) {
+            --k;
+        }
+        BlockHeader* block = reinterpret_cast<BlockHeader*>(chunk_next_);
+        block->bytes = MIN_BLOCK << k;
+        block->size_class = k;
+        block->next = free_[k];
+        free_[k] = block;
+        chunk_next_ += block->bytes;
     }
 }
 
-void SIMDMemoryPool::reset() {
+void SIMDMemoryPool::free_all() {
+    for (void* chunk : chunks_) {
+        aligned_free(chunk);
+    }
+    chunks_.clear();
+    while (large_) {
+        BlockHeader* next = large_->next;
+        aligned_free(large_);
+        large_ = next;
+    }
+    std::fill(free_, free_ + SIZE_CLASSES, nullptr);
+    chunk_next_ = chunk_end_ = nullptr;
+    pool_size_ = 0;
     used_size_ = 0;
-    blocks_.clear();
+    peak_size_ = 0;
 }
 
 void simd_prefetch(const void* ptr, size_t size) {
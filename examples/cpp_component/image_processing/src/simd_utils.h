@@ -1,22 +1,31 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
 #include <vector>
 
-// WebAssembly SIMD support
-#ifdef __wasm__
+// WebAssembly SIMD support (-msimd128); baseline wasm builds use the scalar paths
+#if defined(__wasm__) && defined(__wasm_simd128__)
 #include <wasm_simd128.h>
 #define SIMD_SUPPORTED 1
 #else
 #define SIMD_SUPPORTED 0
-// Fallback definitions for non-WASM builds
+// Fallback definitions for non-SIMD builds
 typedef struct {
     uint8_t bytes[16];
 } v128_t;
 #endif
 
+// Relaxed SIMD (-mrelaxed-simd): fused multiply-add in the float kernels
+#if SIMD_SUPPORTED && defined(__wasm_relaxed_simd__)
+#define RELAXED_SIMD_SUPPORTED 1
+#else
+#define RELAXED_SIMD_SUPPORTED 0
+#endif
+
 namespace simd_utils {
 
 /**
@@ -34,6 +43,19 @@ constexpr size_t SIMD_ALIGNMENT = 16;
 // SIMD availability check
 bool is_simd_supported();
 
+// Instruction set this build was compiled for. A wasm module cannot probe
+// its host: code using an unsupported instruction fails validation as a
+// whole, so the choice is made per build (cpp_component simd) and the host
+// loads the variant its runtime supports.
+enum class SimdLevel {
+    SCALAR,
+    SIMD128,
+    RELAXED_SIMD
+};
+
+SimdLevel simd_level();
+const char* simd_level_name(SimdLevel level);  // "scalar", "simd128" or "relaxed-simd"
+
 // Memory alignment utilities
 void* aligned_malloc(size_t size, size_t alignment = SIMD_ALIGNMENT);
 void aligned_free(void* ptr);
@@ -73,6 +95,14 @@ v128_t simd_sub_f32(v128_t a, v128_t b);
 v128_t simd_mul_u16(v128_t a, v128_t b);
 v128_t simd_mul_u32(v128_t a, v128_t b);
 v128_t simd_mul_f32(v128_t a, v128_t b);
+v128_t simd_div_f32(v128_t a, v128_t b);
+
+// a * b + c; fused (one rounding) in relaxed SIMD builds, so results may
+// differ from the separate multiply and add in the last bit
+v128_t simd_madd_f32(v128_t a, v128_t b, v128_t c);
+
+v128_t simd_abs_f32(v128_t a);
+v128_t simd_floor_f32(v128_t a);
 
 // Saturated arithmetic (clamps to type bounds)
 v128_t simd_adds_u8(v128_t a, v128_t b);  // Saturated add
@@ -82,12 +112,20 @@ v128_t simd_subs_u8(v128_t a, v128_t b);  // Saturated subtract
 v128_t simd_eq_u8(v128_t a, v128_t b);
 v128_t simd_gt_u8(v128_t a, v128_t b);
 v128_t simd_lt_u8(v128_t a, v128_t b);
+v128_t simd_eq_u32(v128_t a, v128_t b);
+v128_t simd_eq_f32(v128_t a, v128_t b);
+v128_t simd_gt_f32(v128_t a, v128_t b);
+v128_t simd_lt_f32(v128_t a, v128_t b);
+
+// Lane masks (bit i set when the top bit of lane i is set)
+uint32_t simd_bitmask_u8(v128_t vec);
 
 // Bitwise operations
 v128_t simd_and(v128_t a, v128_t b);
 v128_t simd_or(v128_t a, v128_t b);
 v128_t simd_xor(v128_t a, v128_t b);
 v128_t simd_not(v128_t a);
+v128_t simd_select(v128_t mask, v128_t a, v128_t b);  // a where mask bits are set, else b
 
 // Shift operations
 v128_t simd_shl_u16(v128_t a, int shift);
@@ -114,6 +152,7 @@ v128_t simd_replace_f32(v128_t vec, int lane, float value);
 
 // Swizzle and shuffle operations
 v128_t simd_swizzle(v128_t vec, v128_t indices);
+// Lane i is byte ci of a (0-15) or of b (16-31); other indices give 0
 v128_t simd_shuffle(v128_t a, v128_t b, int c0, int c1, int c2, int c3,
                    int c4, int c5, int c6, int c7, int c8, int c9,
                    int c10, int c11, int c12, int c13, int c14, int c15);
@@ -122,6 +161,11 @@ v128_t simd_shuffle(v128_t a, v128_t b, int c0, int c1, int c2, int c3,
 v128_t simd_convert_u8_to_u16_low(v128_t vec);   // Convert low 8 u8s to u16s
 v128_t simd_convert_u8_to_u16_high(v128_t vec);  // Convert high 8 u8s to u16s
 v128_t simd_convert_u16_to_u8(v128_t low, v128_t high);  // Pack u16s to u8s with saturation
+v128_t simd_convert_u16_to_u32_low(v128_t vec);  // Convert low 4 u16s to u32s
+v128_t simd_convert_u16_to_u32_high(v128_t vec); // Convert high 4 u16s to u32s
+v128_t simd_convert_u32_to_u16(v128_t low, v128_t high);  // Pack u32s (below 2^31) to u16s with saturation
+v128_t simd_convert_u32_to_f32(v128_t vec);
+v128_t simd_convert_f32_to_u32(v128_t vec);      // Truncates; saturates, NaN to 0
 
 // Horizontal operations (reduce across lanes)
 uint32_t simd_horizontal_add_u8(v128_t vec);
@@ -163,10 +207,16 @@ void simd_merge_channels_rgba(const uint8_t* r, const uint8_t* g, const uint8_t*
 // Arithmetic operations on pixel arrays
 void simd_add_pixels(const uint8_t* src1, const uint8_t* src2, uint8_t* dest, size_t pixel_count);
 void simd_sub_pixels(const uint8_t* src1, const uint8_t* src2, uint8_t* dest, size_t pixel_count);
+// dest = src * multiplier, rounded and clamped to 0-255, over pixel_count bytes
 void simd_mul_pixels(const uint8_t* src, uint8_t* dest, float multiplier, size_t pixel_count);
 void simd_add_scalar(const uint8_t* src, uint8_t* dest, uint8_t value, size_t pixel_count);
 
-// Blend operations
+// Blend operations, byte by byte over pixel_count bytes (alpha included).
+// alpha_blend gives src * alpha + dest * (1 - alpha), rounded, with alpha
+// clamped to 0-1, and runs 16 bytes per step as four f32x4 multiply-adds
+// (fused in relaxed SIMD builds, within a level of the scalar result).
+// multiply_blend (a * b / 255) and screen_blend (255 - (255 - a)(255 - b) /
+// 255) are exact integer rounding in every build.
 void simd_alpha_blend(const uint8_t* src, const uint8_t* dest, uint8_t* result,
                      size_t pixel_count, float alpha);
 void simd_multiply_blend(const uint8_t* src1, const uint8_t* src2, uint8_t* dest, size_t pixel_count);
@@ -183,11 +233,66 @@ struct PixelStats {
 PixelStats simd_calculate_stats(const uint8_t* pixels, size_t pixel_count, int channels);
 
 // Histogram calculation
+// 256-bin histograms of each channel (channel 0 only for grayscale); the
+// arrays given are overwritten
 void simd_calculate_histogram(const uint8_t* pixels, size_t pixel_count, int channels,
                              uint32_t* hist_r, uint32_t* hist_g, uint32_t* hist_b,
                              uint32_t* hist_a = nullptr);
 
+// Adds the 256-bin histogram of channel c to hist[c] wherever hist[c] is
+// non-null, and of BT.709 luma to luma when non-null (3 or 4 channels).
+// Consecutive pixels count into interleaved copies of each histogram, so a
+// run of equal values never waits on its own previous increment; the copies
+// are merged with SIMD adds at the end.
+void simd_accumulate_histograms(const uint8_t* pixels, size_t pixel_count, int channels,
+                                uint32_t* const hist[4], uint32_t* luma = nullptr);
+
+// Adds a 256-bin histogram into `bins` bins over 0-255 (bin = value * bins / 256)
+void simd_fold_histogram(const uint32_t* hist256, uint32_t bins, uint32_t* out);
+
+// Color model kernels on interleaved 8-bit pixels (3 or 4 channels, color
+// first; a fourth input channel is ignored, a fourth output channel is set
+// to alpha), four pixels per f32x4 step: channels are split out with
+// simd_shuffle and the hue sector is chosen with lane masks, not branches.
+// Hue is 256 steps per turn and the other components 0-255, as in
+// color_space. Each converts the longest prefix it can and returns its
+// length in pixels (0 without SIMD); the caller converts the rest. Results
+// are byte for byte those of color_space's per-pixel helpers.
+size_t simd_rgb_to_hsv(const uint8_t* src, int channels, uint8_t* hsv, size_t pixel_count);
+size_t simd_rgb_to_hsl(const uint8_t* src, int channels, uint8_t* hsl, size_t pixel_count);
+size_t simd_hsv_to_rgb(const uint8_t* hsv, uint8_t* dst, int channels, uint8_t alpha, size_t pixel_count);
+size_t simd_hsl_to_rgb(const uint8_t* hsl, uint8_t* dst, int channels, uint8_t alpha, size_t pixel_count);
+
+// CIE L*a*b* (D65) of sRGB pixels, 3 bytes each: L* * 255 / 100, a* + 128,
+// b* + 128. Four pixels per f32x4 step where SIMD is available; the cube
+// root there is a bit-level estimate refined by Newton steps rather than
+// cbrtf, within a level of the scalar path.
+void simd_rgb_to_lab(const uint8_t* rgb, uint8_t* lab, size_t pixel_count);
+void simd_lab_to_rgb(const uint8_t* lab, uint8_t* rgb, size_t pixel_count);
+
+// Table lookup: dst[i] = lut[src[i]] over count bytes; with keep_alpha
+// every fourth byte (RGBA alpha) is copied instead. src may equal dst. The
+// SIMD path swizzles 16 bytes at a time through each 16-entry chunk of the
+// table and merges the results (out-of-range swizzle lanes read as zero).
+void simd_apply_lut(const uint8_t* src, uint8_t* dst, size_t count, const uint8_t lut[256],
+                    bool keep_alpha = false);
+
+// Summed-area table rows
+// sums[i] += row[i] and, when squares is non-null, squares[i] += row[i]^2
+void simd_accumulate_columns(const uint8_t* row, size_t count, uint32_t* sums, uint32_t* squares);
+
+// Running sum along a row of interleaved pixels: out[0, channels) = 0 and
+// out[i + channels] = out[i] + in[i] for every sample i of pixel_count pixels
+// (any number of channels; a summed-area table may stack many planes)
+void simd_prefix_sum_u32(const uint32_t* in, size_t pixel_count, int channels, uint32_t* out);
+
 // Convolution helper (for filters)
+// 3x3 kernel over interleaved pixels with clamped (replicated) borders, the
+// same kernel for every channel; dest = round(bias + sum of taps), clamped
+// to 0-255. normalize divides the kernel by its sum when that is nonzero.
+// Interior rows run 16 samples per step with one f32 multiply-add per tap,
+// fused in relaxed SIMD builds (within a level of the scalar result).
+// src and dest must not overlap.
 void simd_convolve_3x3(const uint8_t* src, uint8_t* dest, int width, int height, int channels,
                       const float kernel[9], float bias = 0.0f, bool normalize = true);
 
@@ -217,29 +322,125 @@ private:
 };
 
 // Memory pool for aligned allocations
+//
+// Blocks come in power-of-two size classes (MIN_BLOCK to MAX_BLOCK bytes,
+// a 16-byte header included), each with a free list, so allocate and
+// deallocate are O(1): a freed block is reused by the next request of its
+// class instead of going back to the heap. Blocks are carved from chunks of
+// at least chunk_size bytes, taken from aligned_malloc as needed; larger
+// requests get their own aligned_malloc block. Memory only goes back to the
+// system in reset() and the destructor. Thread safe.
 class SIMDMemoryPool {
 public:
-    SIMDMemoryPool(size_t pool_size = 1024 * 1024);  // 1MB default
+    static constexpr size_t MIN_BLOCK = 64;
+    static constexpr size_t MAX_BLOCK = size_t(64) << 20;
+    static constexpr int SIZE_CLASSES = 21;  // MIN_BLOCK << 0 .. MIN_BLOCK << 20
+
+    explicit SIMDMemoryPool(size_t chunk_size = 1024 * 1024);  // 1MB default
     ~SIMDMemoryPool();
+    SIMDMemoryPool(const SIMDMemoryPool&) = delete;
+    SIMDMemoryPool& operator=(const SIMDMemoryPool&) = delete;
+
+    // The pool of this component instance, shared by every filter and
+    // converter for per-call scratch
+    static SIMDMemoryPool& shared();
 
+    // SIMD_ALIGNMENT-aligned, or nullptr when the system is out of memory
     void* allocate(size_t size);
-    void deallocate(void* ptr);
+    void deallocate(void* ptr);  // ptr from allocate, or nullptr
+    // Frees every block at once and returns all memory to the system;
+    // earlier pointers become invalid. Only for when no block is in use,
+    // such as between component calls.
     void reset();
 
-    size_t total_size() const { return pool_size_; }
-    size_t used_size() const { return used_size_; }
-    size_t available_size() const { return pool_size_ - used_size_; }
+    size_t total_size() const { return pool_size_; }  // Bytes reserved from the system
+    size_t used_size() const { return used_size_; }   // Bytes in live blocks, headers included
+    size_t available_size() const { return pool_size_ - std::min(pool_size_, used_size_); }
+
+    struct Stats {
+        size_t reserved_bytes;         // total_size()
+        size_t used_bytes;             // used_size()
+        size_t peak_used_bytes;        // High-water mark of used_size() since reset_peak()
+        uint64_t allocations;          // allocate() calls that succeeded
+        uint64_t system_allocations;   // aligned_malloc calls for chunks and large blocks
+    };
+    Stats stats() const;
+    void reset_peak();
 
 private:
-    uint8_t* pool_;
+    struct alignas(SIMD_ALIGNMENT) BlockHeader {
+        BlockHeader* next;  // Free list or large block list link
+        size_t bytes;       // Block size, header included
+        int size_class;     // -1 for large blocks
+    };
+
+    BlockHeader* carve(size_t bytes);
+    void retire_chunk_tail();
+    void free_all();
+
+    mutable std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+    size_t chunk_size_;
+    std::vector<void*> chunks_;
+    uint8_t* chunk_next_;  // Unused tail of the newest chunk
+    uint8_t* chunk_end_;
+    BlockHeader* free_[SIZE_CLASSES];
+    BlockHeader* large_;   // Live large blocks, so reset() can free them
+
     size_t pool_size_;
     size_t used_size_;
-    struct Block {
-        void* ptr;
-        size_t size;
-        bool free;
-    };
-    std::vector<Block> blocks_;
+    size_t peak_size_;
+    uint64_t allocations_;
+    uint64_t system_allocations_;
+};
+
+// Array of trivially copyable T from SIMDMemoryPool::shared(), for per-call
+// scratch that would otherwise be a std::vector. resize() keeps the block
+// while it is big enough; contents are unspecified after resize().
+template <class T>
+class PoolArray {
+public:
+    PoolArray() = default;
+    explicit PoolArray(size_t count) { resize(count); }
+    PoolArray(size_t count, const T& value) { assign(count, value); }
+    ~PoolArray() { SIMDMemoryPool::shared().deallocate(data_); }
+    PoolArray(const PoolArray&) = delete;
+    PoolArray& operator=(const PoolArray&) = delete;
+
+    // False (and empty) when out of memory
+    bool resize(size_t count) {
+        if (count > capacity_) {
+            SIMDMemoryPool& pool = SIMDMemoryPool::shared();
+            pool.deallocate(data_);
+            data_ = count <= SIZE_MAX / sizeof(T) ? static_cast<T*>(pool.allocate(count * sizeof(T))) : nullptr;
+            capacity_ = data_ ? count : 0;
+        }
+        size_ = data_ ? count : 0;
+        return size_ == count;
+    }
+    bool assign(size_t count, const T& value) {
+        if (!resize(count)) {
+            return false;
+        }
+        std::fill(data_, data_ + count, value);
+        return true;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+private:
+    static_assert(std::is_trivially_copyable<T>::value, "PoolArray holds raw memory");
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
 };
 
 // Prefetch hints for better cache performance
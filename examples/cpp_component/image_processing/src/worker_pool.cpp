@@ -0,0 +1,173 @@
+#include "worker_pool.h"
+
+#include <algorithm>
+
+#if WORKER_POOL_THREADS
+#include <thread>
+#endif
+
+namespace worker_pool {
+
+namespace {
+
+// Chunks per participating thread, so a slow chunk does not stall the range
+constexpr size_t CHUNKS_PER_THREAD = 4;
+
+} // namespace
+
+#if WORKER_POOL_THREADS
+
+WorkerPool::WorkerPool()
+    : stop_(false), generation_(0), participants_(0), active_(0), body_(nullptr),
+      total_(0), chunk_(0), chunk_count_(0), next_chunk_(0), done_chunks_(0),
+      busy_(false), worker_count_(0) {}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (pthread_t thread : threads_) {
+        pthread_join(thread, nullptr);
+    }
+}
+
+unsigned WorkerPool::default_thread_count() {
+    unsigned count = std::thread::hardware_concurrency();
+    return std::min(std::max(count, 1u), MAX_THREADS);
+}
+
+void* WorkerPool::worker_main(void* arg) {
+    const WorkerStart* start = static_cast<const WorkerStart*>(arg);
+    start->pool->worker_loop(start->index);
+    return nullptr;
+}
+
+void WorkerPool::start_workers(unsigned count) {
+    // pthread_create rather than std::thread: a failed start (wasi-threads
+    // spawn refused, out of memory) leaves a smaller pool instead of aborting
+    count = std::min(count, MAX_THREADS - 1);
+    while (threads_.size() < count) {
+        unsigned index = static_cast<unsigned>(threads_.size());
+        starts_[index] = {this, index};
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, &WorkerPool::worker_main, &starts_[index]) != 0) {
+            break;
+        }
+        threads_.push_back(thread);
+        worker_count_.store(static_cast<unsigned>(threads_.size()));
+    }
+}
+
+void WorkerPool::worker_loop(unsigned index) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t seen = 0;  // From 0 so a worker started for a range still joins it
+    for (;;) {
+        wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+            return;
+        }
+        seen = generation_;
+        if (index >= participants_) {
+            continue;
+        }
+        active_++;
+        lock.unlock();
+        run_chunks();
+        lock.lock();
+        if (--active_ == 0) {
+            finished_.notify_all();
+        }
+    }
+}
+
+void WorkerPool::run_chunks() {
+    for (;;) {
+        size_t chunk = next_chunk_.fetch_add(1);
+        if (chunk >= chunk_count_) {
+            return;
+        }
+        size_t begin = chunk * chunk_;
+        (*body_)(begin, std::min(total_, begin + chunk_));
+        if (done_chunks_.fetch_add(1) + 1 == chunk_count_) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            finished_.notify_all();
+        }
+    }
+}
+
+void WorkerPool::parallel_for(size_t total, size_t min_chunk, unsigned max_threads,
+                              const std::function<void(size_t, size_t)>& body) {
+    if (total == 0) {
+        return;
+    }
+    min_chunk = std::max<size_t>(min_chunk, 1);
+    max_threads = std::min(max_threads, MAX_THREADS);
+    size_t chunks = std::min((total + min_chunk - 1) / min_chunk, size_t(max_threads) * CHUNKS_PER_THREAD);
+
+    bool expected = false;
+    if (max_threads <= 1 || chunks <= 1 || !busy_.compare_exchange_strong(expected, true)) {
+        body(0, total);
+        return;
+    }
+
+    start_workers(max_threads - 1);
+    unsigned helpers = std::min(worker_count(), max_threads - 1);
+    if (helpers == 0) {
+        busy_.store(false);
+        body(0, total);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        total_ = total;
+        chunk_ = (total + chunks - 1) / chunks;
+        chunk_count_ = (total + chunk_ - 1) / chunk_;
+        next_chunk_.store(0);
+        done_chunks_.store(0);
+        participants_ = helpers;
+        generation_++;
+    }
+    wake_.notify_all();
+
+    run_chunks();
+
+    // Wait for the last chunk and for every worker to leave run_chunks, so
+    // none is still reading this range when the next one is published
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [&] { return done_chunks_.load() == chunk_count_ && active_ == 0; });
+        body_ = nullptr;
+        participants_ = 0;
+    }
+    busy_.store(false);
+}
+
+#else
+
+WorkerPool::WorkerPool() : busy_(false), worker_count_(0) {}
+
+WorkerPool::~WorkerPool() = default;
+
+unsigned WorkerPool::default_thread_count() {
+    return 1;
+}
+
+void WorkerPool::parallel_for(size_t total, size_t /*min_chunk*/, unsigned /*max_threads*/,
+                              const std::function<void(size_t, size_t)>& body) {
+    if (total > 0) {
+        body(0, total);
+    }
+}
+
+#endif
+
+WorkerPool& WorkerPool::shared() {
+    static WorkerPool pool;
+    return pool;
+}
+
+} // namespace worker_pool
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Threads exist on native builds and on wasm built with -pthread (wasi-threads)
+#if !defined(__wasm__) || defined(_REENTRANT)
+#define WORKER_POOL_THREADS 1
+#include <condition_variable>
+#include <mutex>
+#include <pthread.h>
+#else
+#define WORKER_POOL_THREADS 0
+#endif
+
+namespace worker_pool {
+
+/**
+ * Persistent worker threads for data-parallel image loops
+ *
+ * A range [0, total) is cut into chunks that the caller and the workers pull
+ * from a shared counter, so uneven rows balance themselves. Workers are
+ * started lazily up to the requested thread count and then reused. When the
+ * build has no threads, when a thread cannot be started, or when the pool is
+ * already running a range (nested or concurrent use), the work simply runs
+ * on the calling thread.
+ */
+class WorkerPool {
+public:
+    static constexpr unsigned MAX_THREADS = 64;
+
+    WorkerPool();
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Process-wide pool shared by all filters and converters
+    static WorkerPool& shared();
+
+    // Hardware threads, or 1 when unknown or threads are unavailable
+    static unsigned default_thread_count();
+
+    // Runs body(begin, end) over disjoint chunks covering [0, total) on up to
+    // max_threads threads (the caller included); chunks hold at least
+    // min_chunk items. Returns once every chunk has run.
+    void parallel_for(size_t total, size_t min_chunk, unsigned max_threads,
+                      const std::function<void(size_t, size_t)>& body);
+
+    unsigned worker_count() const { return static_cast<unsigned>(worker_count_.load()); }
+
+private:
+#if WORKER_POOL_THREADS
+    struct WorkerStart {
+        WorkerPool* pool;
+        unsigned index;
+    };
+
+    static void* worker_main(void* arg);
+    void worker_loop(unsigned index);
+    void start_workers(unsigned count);
+    void run_chunks();
+
+    std::mutex mutex_;
+    std::condition_variable wake_;      // Workers: new range or shutdown
+    std::condition_variable finished_;  // Caller: range complete
+
+    std::vector<pthread_t> threads_;
+    WorkerStart starts_[MAX_THREADS];
+    bool stop_;
+    uint64_t generation_;     // Bumped for every range
+    unsigned participants_;   // Workers invited to the current range
+    unsigned active_;         // Workers still inside the current range
+
+    // Current range, written under mutex_ before generation_ is bumped
+    const std::function<void(size_t, size_t)>* body_;
+    size_t total_;
+    size_t chunk_;
+    size_t chunk_count_;
+    std::atomic<size_t> next_chunk_;
+    std::atomic<size_t> done_chunks_;
+#endif
+
+    std::atomic<bool> busy_;
+    std::atomic<unsigned> worker_count_;
+};
+
+} // namespace worker_pool
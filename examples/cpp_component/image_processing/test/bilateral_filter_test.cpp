@@ -0,0 +1,126 @@
+#include "../src/filters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace filters;
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::cerr << "ASSERTION FAILED: " << #condition << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+namespace {
+
+constexpr uint32_t kWidth = 192;
+constexpr uint32_t kHeight = 160;
+
+// Slow gradients plus a little noise
+std::vector<uint8_t> smooth_image(int channels, std::mt19937& rng) {
+    std::vector<uint8_t> image(static_cast<size_t>(kWidth) * kHeight * channels);
+    for (uint32_t y = 0; y < kHeight; ++y) {
+        for (uint32_t x = 0; x < kWidth; ++x) {
+            for (int c = 0; c < channels; ++c) {
+                float value = 128.0f + 60.0f * std::sin(x * 0.05f + c) * std::cos(y * 0.04f) +
+                              static_cast<int>(rng() % 9) - 4;
+                image[(static_cast<size_t>(y) * kWidth + x) * channels + c] =
+                    static_cast<uint8_t>(std::min(255.0f, std::max(0.0f, value)));
+            }
+        }
+    }
+    return image;
+}
+
+std::vector<uint8_t> noise_image(int channels, std::mt19937& rng) {
+    std::vector<uint8_t> image(static_cast<size_t>(kWidth) * kHeight * channels);
+    for (uint8_t& sample : image) sample = static_cast<uint8_t>(rng());
+    return image;
+}
+
+struct Difference {
+    double mean;
+    int max;
+};
+
+// Grid result against grid_cell 0 (the exact filter), color channels only
+Difference grid_error(const std::vector<uint8_t>& image, int channels, float spatial_sigma,
+                      float intensity_sigma, float grid_cell) {
+    FilterProcessor processor;
+    FilterResult exact = processor.bilateral_filter(image.data(), kWidth, kHeight, channels,
+                                                    spatial_sigma, intensity_sigma, 0.0f);
+    FilterResult grid = processor.bilateral_filter(image.data(), kWidth, kHeight, channels,
+                                                   spatial_sigma, intensity_sigma, grid_cell);
+    ASSERT_TRUE(exact.success && grid.success);
+    ASSERT_TRUE(exact.data.size() == grid.data.size());
+
+    double sum = 0.0;
+    int max = 0;
+    size_t count = 0;
+    for (size_t i = 0; i < exact.data.size(); ++i) {
+        if (channels == 4 && i % 4 == 3) {
+            ASSERT_TRUE(grid.data[i] == image[i]);
+            continue;
+        }
+        const int difference = std::abs(exact.data[i] - grid.data[i]);
+        sum += difference;
+        max = std::max(max, difference);
+        count++;
+    }
+    return {sum / count, max};
+}
+
+// The figures bilateral_filter documents, with a little headroom
+void expect_within(const Difference& difference, double mean, int max) {
+    ASSERT_TRUE(difference.mean <= mean);
+    ASSERT_TRUE(difference.max <= max);
+}
+
+void test_grid_on_smooth_images() {
+    std::mt19937 rng(3);
+    for (int channels : {3, 4}) {
+        std::vector<uint8_t> image = smooth_image(channels, rng);
+        for (float spatial_sigma : {3.0f, 4.0f, 8.0f}) {
+            for (float intensity_sigma : {12.75f, 25.5f, 51.0f}) {
+                expect_within(grid_error(image, channels, spatial_sigma, intensity_sigma, 1.0f), 1.3, 5);
+                expect_within(grid_error(image, channels, spatial_sigma, intensity_sigma, 0.5f), 0.5, 3);
+            }
+        }
+    }
+}
+
+// Uniform noise is the worst case: every cell holds the full intensity range
+void test_grid_on_noise() {
+    std::mt19937 rng(5);
+    const struct {
+        float intensity_sigma;
+        double mean;
+        int max;
+    } bounds[] = {{12.75f, 0.6, 5}, {25.5f, 1.4, 7}, {51.0f, 4.0, 12}};
+    for (int channels : {3, 4}) {
+        std::vector<uint8_t> image = noise_image(channels, rng);
+        for (float spatial_sigma : {3.0f, 4.0f, 8.0f}) {
+            for (const auto& bound : bounds) {
+                expect_within(grid_error(image, channels, spatial_sigma, bound.intensity_sigma, 1.0f),
+                              bound.mean, bound.max);
+                expect_within(grid_error(image, channels, spatial_sigma, bound.intensity_sigma, 0.5f), 0.5, 3);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Running bilateral filter tests..." << std::endl;
+    test_grid_on_smooth_images();
+    test_grid_on_noise();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
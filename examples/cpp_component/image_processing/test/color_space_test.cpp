@@ -0,0 +1,128 @@
+#include "../src/color_space.h"
+#include "../src/simd_utils.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace color_space;
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::cerr << "ASSERTION FAILED: " << #condition << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+namespace {
+
+constexpr size_t kRandomPixels = 1 << 16;
+
+// Random pixels, then every gray; an odd total leaves a scalar tail
+std::vector<uint8_t> test_pixels(int channels) {
+    std::mt19937 rng(11);
+    std::vector<uint8_t> pixels;
+    pixels.reserve((kRandomPixels + 256 + 3) * channels);
+    for (size_t i = 0; i < kRandomPixels * channels; ++i) {
+        pixels.push_back(static_cast<uint8_t>(rng()));
+    }
+    for (int gray = 0; gray < 256; ++gray) {
+        for (int c = 0; c < channels; ++c) {
+            pixels.push_back(static_cast<uint8_t>(c == 3 ? 255 - gray : gray));
+        }
+    }
+    for (int c = 0; c < 3 * channels; ++c) {
+        pixels.push_back(static_cast<uint8_t>(rng()));
+    }
+    return pixels;
+}
+
+size_t pixel_count(const std::vector<uint8_t>& pixels, int channels) {
+    return pixels.size() / channels;
+}
+
+using Conversion = bool (ColorSpaceConverter::*)(const uint8_t*, uint8_t*, size_t);
+
+// The same conversion with the simd_* kernels and with the per-pixel helpers
+void expect_identical(Conversion conversion, const std::vector<uint8_t>& src, size_t pixels,
+                      int dst_channels) {
+    ColorSpaceConverter bulk;
+    bulk.enable_simd(true);
+    ColorSpaceConverter scalar;
+    scalar.enable_simd(false);
+
+    std::vector<uint8_t> expected(pixels * dst_channels);
+    std::vector<uint8_t> actual(pixels * dst_channels);
+    ASSERT_TRUE((scalar.*conversion)(src.data(), expected.data(), pixels));
+    ASSERT_TRUE((bulk.*conversion)(src.data(), actual.data(), pixels));
+    ASSERT_TRUE(actual == expected);
+}
+
+void test_hsv_matches_scalar() {
+    std::vector<uint8_t> rgb = test_pixels(3);
+    std::vector<uint8_t> rgba = test_pixels(4);
+    expect_identical(&ColorSpaceConverter::rgb_to_hsv, rgb, pixel_count(rgb, 3), 3);
+    expect_identical(&ColorSpaceConverter::rgba_to_hsv, rgba, pixel_count(rgba, 4), 3);
+    // Random bytes as HSV: every hue sector, saturation and value
+    expect_identical(&ColorSpaceConverter::hsv_to_rgb, rgb, pixel_count(rgb, 3), 3);
+
+    ColorSpaceConverter bulk;
+    ColorSpaceConverter scalar;
+    scalar.enable_simd(false);
+    const size_t pixels = pixel_count(rgb, 3);
+    std::vector<uint8_t> expected(pixels * 4);
+    std::vector<uint8_t> actual(pixels * 4);
+    ASSERT_TRUE(scalar.hsv_to_rgba(rgb.data(), expected.data(), pixels, 200));
+    ASSERT_TRUE(bulk.hsv_to_rgba(rgb.data(), actual.data(), pixels, 200));
+    ASSERT_TRUE(actual == expected);
+}
+
+void test_hsl_matches_scalar() {
+    std::vector<uint8_t> rgb = test_pixels(3);
+    expect_identical(&ColorSpaceConverter::rgb_to_hsl, rgb, pixel_count(rgb, 3), 3);
+    expect_identical(&ColorSpaceConverter::hsl_to_rgb, rgb, pixel_count(rgb, 3), 3);
+}
+
+// simd_rgb_to_lab and simd_lab_to_rgb convert a single pixel on the scalar
+// path, so pixel by pixel calls are the reference for the bulk call
+void expect_lab_within_a_level(void (*conversion)(const uint8_t*, uint8_t*, size_t),
+                               const std::vector<uint8_t>& src) {
+    const size_t pixels = pixel_count(src, 3);
+    std::vector<uint8_t> expected(src.size());
+    std::vector<uint8_t> actual(src.size());
+    for (size_t i = 0; i < pixels; ++i) {
+        conversion(src.data() + i * 3, expected.data() + i * 3, 1);
+    }
+    conversion(src.data(), actual.data(), pixels);
+    for (size_t i = 0; i < src.size(); ++i) {
+        ASSERT_TRUE(std::abs(actual[i] - expected[i]) <= 1);
+    }
+}
+
+void test_lab_matches_scalar() {
+    std::vector<uint8_t> rgb = test_pixels(3);
+    expect_lab_within_a_level(simd_utils::simd_rgb_to_lab, rgb);
+    // Random bytes as Lab, many out of the sRGB gamut and clamped
+    expect_lab_within_a_level(simd_utils::simd_lab_to_rgb, rgb);
+
+    // Grays keep a* and b* at 128
+    std::vector<uint8_t> lab(rgb.size());
+    simd_utils::simd_rgb_to_lab(rgb.data(), lab.data(), pixel_count(rgb, 3));
+    for (size_t i = kRandomPixels; i < kRandomPixels + 256; ++i) {
+        ASSERT_TRUE(std::abs(lab[i * 3 + 1] - 128) <= 1);
+        ASSERT_TRUE(std::abs(lab[i * 3 + 2] - 128) <= 1);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Running color space tests..." << std::endl;
+    test_hsv_matches_scalar();
+    test_hsl_matches_scalar();
+    test_lab_matches_scalar();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "../src/filters.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace filters;
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::cerr << "ASSERTION FAILED: " << #condition << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+namespace {
+
+struct Step {
+    FilterType type;
+    float radius;
+};
+
+FilterResult run_chain(const std::vector<Step>& steps, ChainExecution execution, bool simd,
+                       uint32_t tile_width, uint32_t tile_height, const std::vector<uint8_t>& image,
+                       uint32_t width, uint32_t height, int channels) {
+    FilterChain chain;
+    chain.set_execution(execution);
+    chain.enable_simd(simd);
+    chain.set_tile_size(tile_width, tile_height);
+    for (const Step& step : steps) {
+        FilterParams params;
+        params.radius = step.radius;
+        params.strength = 0.8f;
+        params.preserve_alpha = true;
+        chain.add_filter(step.type, params);
+    }
+    return chain.apply_chain(image.data(), width, height, channels);
+}
+
+// TILED output equals PER_FILTER output for every tile size, channel count
+// and fixed-point setting
+void expect_schedules_match(const std::vector<Step>& steps) {
+    std::mt19937 rng(7);
+    const uint32_t shapes[][2] = {{1, 1}, {13, 5}, {64, 64}, {131, 97}};
+    const uint32_t tiles[][2] = {{1, 1}, {16, 16}, {256, 64}, {1000, 8}};
+    for (const auto& shape : shapes) {
+        for (int channels = 1; channels <= 4; ++channels) {
+            std::vector<uint8_t> image(static_cast<size_t>(shape[0]) * shape[1] * channels);
+            for (uint8_t& sample : image) sample = static_cast<uint8_t>(rng());
+            for (bool simd : {false, true}) {
+                FilterResult expected = run_chain(steps, ChainExecution::PER_FILTER, simd, 256, 64,
+                                                  image, shape[0], shape[1], channels);
+                ASSERT_TRUE(expected.success);
+                for (const auto& tile : tiles) {
+                    FilterResult tiled = run_chain(steps, ChainExecution::TILED, simd, tile[0], tile[1],
+                                                   image, shape[0], shape[1], channels);
+                    ASSERT_TRUE(tiled.success);
+                    ASSERT_TRUE(tiled.data == expected.data);
+                }
+            }
+        }
+    }
+}
+
+// Box blurs from radius 4 run on a summed-area table, next to filters that fuse
+void test_table_box_blur_in_chain() {
+    expect_schedules_match({{FilterType::SHARPEN, 1}, {FilterType::BOX_BLUR, 6}});
+    expect_schedules_match({{FilterType::BOX_BLUR, 4}, {FilterType::SHARPEN, 1}});
+    expect_schedules_match({{FilterType::GAUSSIAN_BLUR, 2}, {FilterType::BOX_BLUR, 5},
+                            {FilterType::EDGE_DETECT, 1}});
+    expect_schedules_match({{FilterType::BOX_BLUR, 4}, {FilterType::BOX_BLUR, 9}});
+}
+
+// Separable box blurs below the table radius stay fused
+void test_separable_box_blur_in_chain() {
+    expect_schedules_match({{FilterType::SHARPEN, 1}, {FilterType::BOX_BLUR, 3},
+                            {FilterType::GAUSSIAN_BLUR, 2}});
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Running filter chain tests..." << std::endl;
+    test_table_box_blur_in_chain();
+    test_separable_box_blur_in_chain();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
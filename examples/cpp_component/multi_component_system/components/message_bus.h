@@ -5,6 +5,7 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <queue>
 #include <mutex>
@@ -12,6 +13,13 @@
 #include <thread>
 #include <atomic>
 
+#include "mpmc_lanes.h"
+#include "payload_buffer.h"
+#include "sharded_stats.h"
+#include "timer_wheel.h"
+#include "topic_trie.h"
+#include "wire_frame.h"
+
 namespace multi_component_system {
 
 /**
@@ -31,6 +39,8 @@ enum class MessageType {
     HEARTBEAT
 };
 
+inline constexpr size_t kMessageTypeCount = 6;
+
 enum class MessagePriority {
     LOW,
     NORMAL,
@@ -38,6 +48,9 @@ enum class MessagePriority {
     CRITICAL
 };
 
+// One queue lane per priority
+inline constexpr size_t kMessagePriorityCount = 4;
+
 struct MessageHeader {
     std::string message_id;
     std::string correlation_id;
@@ -50,10 +63,12 @@ struct MessageHeader {
     std::unordered_map<std::string, std::string> metadata;
 };
 
+// Copies of a message share its payload; handlers read it through view()
 struct Message {
     MessageHeader header;
-    std::vector<uint8_t> payload;
+    PayloadBuffer payload;
     size_t size() const { return payload.size(); }
+    PayloadView view() const { return payload.view(); }
     bool is_expired() const;
 };
 
@@ -77,7 +92,8 @@ struct ServiceInfo {
 
 // Message bus configuration
 struct MessageBusConfig {
-    size_t max_queue_size;
+    size_t max_queue_size;        // Across all lanes
+    size_t worker_batch_size;     // Messages a worker dequeues at once
     size_t max_message_size;
     uint32_t default_ttl_seconds;
     uint32_t heartbeat_interval_seconds;
@@ -88,7 +104,7 @@ struct MessageBusConfig {
     std::string encryption_key;
 
     MessageBusConfig()
-        : max_queue_size(10000), max_message_size(1024 * 1024),
+        : max_queue_size(10000), worker_batch_size(32), max_message_size(1024 * 1024),
           default_ttl_seconds(300), heartbeat_interval_seconds(30),
           service_timeout_seconds(60), enable_persistence(false),
           enable_compression(false), enable_encryption(false) {}
@@ -139,6 +155,17 @@ public:
 
     bool broadcast_event(const std::string& event_name, const std::vector<uint8_t>& payload);
 
+    // Zero-copy variants: the buffer is shared with every recipient, the
+    // queue and the history instead of being copied for each
+    bool send_message(const std::string& recipient_id, PayloadBuffer payload,
+                     MessageType type = MessageType::REQUEST,
+                     MessagePriority priority = MessagePriority::NORMAL);
+
+    bool send_response(const std::string& correlation_id, PayloadBuffer payload,
+                      bool success = true);
+
+    bool broadcast_event(const std::string& event_name, PayloadBuffer payload);
+
     bool broadcast_message(const std::vector<uint8_t>& payload,
                           const std::vector<std::string>& recipient_filter = {});
 
@@ -158,23 +185,36 @@ public:
                            std::function<bool(const Message&)> filter);
     void remove_message_filter(const std::string& filter_name);
 
+    // Patterns and event names are '.'-separated; "*" matches one segment,
+    // "**" any number
     void add_routing_rule(const std::string& pattern, const std::string& target_service_id);
     void remove_routing_rule(const std::string& pattern);
 
-    // Statistics and monitoring
+    // Statistics and monitoring; get_stats merges the counter shards
     MessageBusStats get_stats() const;
     void reset_stats();
+
+    // Delivery latency distribution of one message type, for metrics export
+    LatencyHistogram::Snapshot get_latency_histogram(MessageType type) const {
+        return stats_.latency(static_cast<size_t>(type));
+    }
     std::vector<Message> get_recent_messages(size_t count = 100) const;
 
     // Configuration
     void update_config(const MessageBusConfig& config);
     MessageBusConfig get_config() const { return config_; }
 
+    // Timers on the bus's wheel; callbacks run on the timer thread and must
+    // not block
+    TimerWheel::TimerId schedule_timer(uint64_t delay_ms, TimerWheel::Callback callback);
+    bool cancel_timer(TimerWheel::TimerId timer);
+
     // Health check
     bool health_check() const;
     std::string get_health_status() const;
 
-    // Persistence (if enabled)
+    // Persistence (if enabled): services and queued messages as a sequence
+    // of wire frames (wire_frame.h)
     bool save_state(const std::string& filepath) const;
     bool load_state(const std::string& filepath);
 
@@ -193,11 +233,11 @@ private:
     std::unordered_map<std::string, ServiceInfo> services_;
     mutable std::mutex services_mutex_;
 
-    // Message queues
-    std::queue<Message> message_queue_;
-    std::queue<Message> priority_queue_;
-    mutable std::mutex queue_mutex_;
-    std::condition_variable queue_condition_;
+    // Message queues: a lock-free lane per MessagePriority, each sized for
+    // max_queue_size so any mix of priorities fits. Workers take batches of
+    // worker_batch_size, CRITICAL first, and park on the lanes when idle;
+    // stop() wakes them with wake_all(). A full lane drops the message.
+    PriorityLanes<Message, kMessagePriorityCount> queue_lanes_;
 
     // Message handlers
     MessageHandler default_message_handler_;
@@ -205,10 +245,12 @@ private:
     std::unordered_map<std::string, std::vector<EventHandler>> event_handlers_;
     mutable std::mutex handlers_mutex_;
 
-    // Pending responses
+    // Pending responses; each has a timeout timer, cancelled when the
+    // response arrives
     struct PendingResponse {
         ResponseHandler handler;
         uint64_t expires_at;
+        TimerWheel::TimerId timeout;
     };
     std::unordered_map<std::string, PendingResponse> pending_responses_;
     mutable std::mutex responses_mutex_;
@@ -218,29 +260,46 @@ private:
     std::unordered_map<std::string, std::string> routing_rules_;
     mutable std::mutex routing_mutex_;
 
+    // Routing rules and event subscriptions compiled into tries, rebuilt when
+    // add/remove_routing_rule or (un)subscribe_to_event change them. Only
+    // those writers take routing_mutex_ / handlers_mutex_; route_message and
+    // event dispatch read the published snapshot without a lock.
+    SnapshotCell<TopicTrie<std::string>> routing_trie_;
+    SnapshotCell<TopicTrie<EventHandler>> event_trie_;
+
     // Worker threads
     std::vector<std::thread> worker_threads_;
-    std::thread heartbeat_thread_;
-    std::thread cleanup_thread_;
 
-    // Statistics
-    mutable MessageBusStats stats_;
-    mutable std::mutex stats_mutex_;
+    // Request timeouts, heartbeat deadlines and circuit-breaker cooldowns,
+    // all driven by one thread that sleeps until the wheel's next tick with
+    // work. A heartbeat pushes its service's deadline back with reschedule().
+    static constexpr uint64_t TIMER_TICK_MS = 10;
+    TimerWheel timers_;
+    std::unordered_map<std::string, TimerWheel::TimerId> heartbeat_timers_;
+    mutable std::mutex timers_mutex_;
+    std::condition_variable timers_condition_;
+    std::thread timer_thread_;
+
+    // Statistics: per-thread counter shards and latency histograms by
+    // MessageType, updated without a lock
+    ShardedStats<kMessageTypeCount> stats_;
     uint64_t start_time_;
 
-    // Message history (for debugging)
+    // Message history (for debugging); entries share payloads with the
+    // messages they record
     std::queue<Message> recent_messages_;
     mutable std::mutex history_mutex_;
     static constexpr size_t MAX_HISTORY_SIZE = 1000;
 
     // Internal methods
     void worker_thread_main();
-    void heartbeat_thread_main();
-    void cleanup_thread_main();
+    void timer_thread_main();
 
     void process_message(const Message& message);
     void route_message(const Message& message);
     bool apply_filters(const Message& message);
+    void rebuild_routing_trie();  // Caller holds routing_mutex_
+    void rebuild_event_trie();    // Caller holds handlers_mutex_
 
     std::string generate_message_id();
     std::string generate_correlation_id();
@@ -248,14 +307,19 @@ private:
 
     void update_stats(const Message& message, bool sent);
     void add_to_history(const Message& message);
-    void cleanup_expired_responses();
-    void cleanup_inactive_services();
+    void expire_response(const std::string& correlation_id);
+    void expire_service(const std::string& service_id);
 
-    // Serialization helpers
+    // Serialization helpers: a single message travels as a frame of one;
+    // deserialize_batch leaves views into frame in reader and returns the
+    // bytes consumed, 0 when the frame is malformed
     std::vector<uint8_t> serialize_message(const Message& message);
     Message deserialize_message(const std::vector<uint8_t>& data);
+    std::vector<uint8_t> serialize_batch(const std::vector<Message>& messages);
+    size_t deserialize_batch(std::span<const uint8_t> frame, FrameReader& reader);
+    Message message_from_view(const MessageView& view);
 
-    // Compression helpers
+    // Compression helpers (LZ4 block format, see wire::lz4_compress)
     std::vector<uint8_t> compress_payload(const std::vector<uint8_t>& payload);
     std::vector<uint8_t> decompress_payload(const std::vector<uint8_t>& compressed);
 
@@ -342,12 +406,15 @@ public:
 private:
     MessageBus* bus_;
 
+    // An OPEN breaker moves to HALF_OPEN when its cooldown timer on the
+    // bus fires
     struct CircuitBreakerState {
         CircuitState state;
         uint32_t failure_count;
         uint64_t last_failure_time;
         uint32_t failure_threshold;
         uint32_t recovery_timeout;
+        TimerWheel::TimerId cooldown_timer;
     };
 
     std::unordered_map<std::string, CircuitBreakerState> circuit_breakers_;
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace multi_component_system {
+
+/**
+ * Bounded lock-free queues for the message bus
+ *
+ * MpmcRing is a multi-producer multi-consumer ring in the style of Dmitry
+ * Vyukov's bounded queue: every cell carries a sequence number that tells
+ * producers and consumers whose turn it is, so a push or pop is one CAS on
+ * the shared index plus a move, with no lock. PriorityLanes keeps one ring
+ * per priority and hands workers batches, highest priority first.
+ *
+ * Idle workers park on a futex-style word (std::atomic::wait, which is
+ * futex on Linux and memory.atomic.wait32 on threaded WebAssembly). A push
+ * only issues a wake when somebody is parked, and wakes one worker rather
+ * than broadcasting.
+ */
+
+// Keeps producer and consumer indices off each other's cache line
+inline constexpr size_t kCacheLineSize = 64;
+
+template <typename T>
+class MpmcRing {
+public:
+    // Capacity is rounded up to a power of two (at least 2)
+    explicit MpmcRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_ = std::make_unique<Cell[]>(size);
+        for (size_t i = 0; i < size; i++) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // False when the ring is full
+    bool try_push(T&& value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // False when the ring is empty
+    bool try_pop(T& value) {
+        size_t position = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[position & mask_];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t difference =
+                static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+            if (difference == 0) {
+                if (head_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.value = T();
+                    cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate while producers or consumers are active
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_ = 0;
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+};
+
+template <typename T, size_t LaneCount>
+class PriorityLanes {
+public:
+    explicit PriorityLanes(size_t lane_capacity) {
+        for (auto& lane : lanes_) {
+            lane = std::make_unique<MpmcRing<T>>(lane_capacity);
+        }
+    }
+
+    // Push into a lane (0 is the lowest priority); false when it is full or
+    // the total size limit is reached
+    bool push(T&& value, size_t lane) {
+        if (lane >= LaneCount) lane = LaneCount - 1;
+        if (size() >= size_limit_.load(std::memory_order_relaxed)) return false;
+        if (!lanes_[lane]->try_push(std::move(value))) return false;
+
+        // Pairs with park(): either the worker sees the new signal or we see
+        // the worker parked
+        signal_.fetch_add(1, std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_seq_cst) > 0) {
+            signal_.notify_one();
+        }
+        return true;
+    }
+
+    // Move up to max_count values into out, draining higher lanes first;
+    // returns how many were taken
+    size_t pop_batch(std::vector<T>& out, size_t max_count) {
+        size_t taken = 0;
+        T value;
+        for (size_t lane = LaneCount; lane-- > 0 && taken < max_count;) {
+            while (taken < max_count && lanes_[lane]->try_pop(value)) {
+                out.push_back(std::move(value));
+                taken++;
+            }
+        }
+        return taken;
+    }
+
+    // Block until a push since last_signal or wake_all; pass the value of
+    // signal() read before the empty pop_batch, so no push is missed
+    void park(uint32_t last_signal) {
+        parked_.fetch_add(1, std::memory_order_seq_cst);
+        if (signal_.load(std::memory_order_seq_cst) == last_signal) {
+            signal_.wait(last_signal, std::memory_order_acquire);
+        }
+        parked_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    uint32_t signal() const { return signal_.load(std::memory_order_acquire); }
+
+    // Release every parked worker, e.g. on shutdown
+    void wake_all() {
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_all();
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const auto& lane : lanes_) {
+            total += lane->size();
+        }
+        return total;
+    }
+
+    size_t lane_size(size_t lane) const { return lane < LaneCount ? lanes_[lane]->size() : 0; }
+
+    // Pop and discard everything queued
+    void clear() {
+        T value;
+        for (auto& lane : lanes_) {
+            while (lane->try_pop(value)) {
+            }
+        }
+    }
+
+    // Soft limit on queued values across lanes, at most the lanes' capacity
+    void set_size_limit(size_t limit) { size_limit_.store(limit, std::memory_order_relaxed); }
+
+private:
+    std::array<std::unique_ptr<MpmcRing<T>>, LaneCount> lanes_;
+    std::atomic<size_t> size_limit_{SIZE_MAX};
+    alignas(kCacheLineSize) std::atomic<uint32_t> signal_{0};
+    alignas(kCacheLineSize) std::atomic<uint32_t> parked_{0};
+};
+
+} // namespace multi_component_system
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace multi_component_system {
+
+/**
+ * Immutable ref-counted message payloads
+ *
+ * A PayloadBuffer is a view of bytes in a shared block. Copying one bumps
+ * the block's reference count instead of copying bytes, so a message
+ * broadcast to N subscribers, queued and kept in history shares a single
+ * allocation; slices share it too. The bytes are written once when the
+ * buffer is made and never change afterwards, which is what makes sharing
+ * across worker threads safe.
+ *
+ * Blocks come from PayloadPool, which keeps freed blocks of a few size
+ * classes for reuse; bigger payloads are allocated and freed directly.
+ */
+
+using PayloadView = std::span<const uint8_t>;
+
+struct PayloadBlock {
+    std::atomic<uint32_t> references;
+    uint32_t size_class;  // PayloadPool::kUnpooled for direct allocations
+    size_t capacity;
+
+    uint8_t* bytes() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+class PayloadPool {
+public:
+    static constexpr std::array<size_t, 4> kClassSizes = {256, 4096, 64 * 1024, 256 * 1024};
+    static constexpr uint32_t kUnpooled = UINT32_MAX;
+    static constexpr size_t kMaxCachedPerClass = 64;
+
+    // Process-wide pool; never destroyed, so buffers may outlive statics
+    static PayloadPool& instance() {
+        static PayloadPool* pool = new PayloadPool();
+        return *pool;
+    }
+
+    // Block of at least size bytes with one reference; nullptr when out of
+    // memory
+    PayloadBlock* allocate(size_t size) {
+        uint32_t size_class = kUnpooled;
+        for (uint32_t i = 0; i < kClassSizes.size(); i++) {
+            if (size <= kClassSizes[i]) {
+                size_class = i;
+                break;
+            }
+        }
+
+        PayloadBlock* block = nullptr;
+        if (size_class != kUnpooled) {
+            FreeList& list = free_lists_[size_class];
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (!list.blocks.empty()) {
+                block = list.blocks.back();
+                list.blocks.pop_back();
+            }
+        }
+        if (!block) {
+            size_t capacity = size_class != kUnpooled ? kClassSizes[size_class] : size;
+            void* memory = ::operator new(sizeof(PayloadBlock) + capacity, std::nothrow);
+            if (!memory) return nullptr;
+            block = new (memory) PayloadBlock;
+            block->size_class = size_class;
+            block->capacity = capacity;
+        }
+        block->references.store(1, std::memory_order_relaxed);
+        return block;
+    }
+
+    // Drop a reference, recycling the block with the last one
+    void release(PayloadBlock* block) {
+        if (block->references.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        if (block->size_class != kUnpooled) {
+            FreeList& list = free_lists_[block->size_class];
+            std::lock_guard<std::mutex> lock(list.mutex);
+            if (list.blocks.size() < kMaxCachedPerClass) {
+                list.blocks.push_back(block);
+                return;
+            }
+        }
+        block->~PayloadBlock();
+        ::operator delete(block);
+    }
+
+    size_t cached_blocks() {
+        size_t total = 0;
+        for (auto& list : free_lists_) {
+            std::lock_guard<std::mutex> lock(list.mutex);
+            total += list.blocks.size();
+        }
+        return total;
+    }
+
+private:
+    PayloadPool() = default;
+
+    struct FreeList {
+        std::mutex mutex;
+        std::vector<PayloadBlock*> blocks;
+    };
+    std::array<FreeList, kClassSizes.size()> free_lists_;
+};
+
+class PayloadBuffer {
+public:
+    PayloadBuffer() = default;
+
+    // Copy bytes into a new block; the only copy the payload will see
+    static PayloadBuffer copy_of(const uint8_t* data, size_t size) {
+        return build(size, [&](uint8_t* bytes) {
+            if (size > 0) std::memcpy(bytes, data, size);
+        });
+    }
+
+    static PayloadBuffer copy_of(const std::vector<uint8_t>& bytes) {
+        return copy_of(bytes.data(), bytes.size());
+    }
+
+    // Let fill write size bytes straight into a new block; empty when out of
+    // memory
+    template <typename Fill>
+    static PayloadBuffer build(size_t size, Fill&& fill) {
+        if (size == 0) return PayloadBuffer();
+
+        PayloadBlock* block = PayloadPool::instance().allocate(size);
+        if (!block) return PayloadBuffer();
+        fill(block->bytes());
+        return PayloadBuffer(block, block->bytes(), size);
+    }
+
+    PayloadBuffer(const PayloadBuffer& other)
+        : block_(other.block_), data_(other.data_), size_(other.size_) {
+        retain();
+    }
+
+    PayloadBuffer(PayloadBuffer&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr)),
+          data_(std::exchange(other.data_, nullptr)),
+          size_(std::exchange(other.size_, 0)) {}
+
+    PayloadBuffer& operator=(const PayloadBuffer& other) {
+        if (this != &other) {
+            PayloadBuffer copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    PayloadBuffer& operator=(PayloadBuffer&& other) noexcept {
+        if (this != &other) {
+            PayloadBuffer moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~PayloadBuffer() {
+        if (block_) PayloadPool::instance().release(block_);
+    }
+
+    void swap(PayloadBuffer& other) noexcept {
+        std::swap(block_, other.block_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+    uint8_t operator[](size_t index) const { return data_[index]; }
+
+    PayloadView view() const { return PayloadView(data_, size_); }
+
+    // Bytes [offset, offset + length) sharing this block, clamped to the end
+    PayloadBuffer slice(size_t offset, size_t length) const {
+        if (offset >= size_) return PayloadBuffer();
+        if (length > size_ - offset) length = size_ - offset;
+
+        retain();
+        return PayloadBuffer(block_, data_ + offset, length);
+    }
+
+    // Owned copy, for code that needs to modify the bytes
+    std::vector<uint8_t> to_vector() const { return std::vector<uint8_t>(begin(), end()); }
+
+    // Buffers sharing the block, for tests and diagnostics
+    uint32_t use_count() const {
+        return block_ ? block_->references.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    PayloadBuffer(PayloadBlock* block, const uint8_t* data, size_t size)
+        : block_(block), data_(data), size_(size) {}
+
+    void retain() const {
+        if (block_) block_->references.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    PayloadBlock* block_ = nullptr;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace multi_component_system
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "mpmc_lanes.h"  // kCacheLineSize
+
+namespace multi_component_system {
+
+/**
+ * Contention-free counters and latency histograms
+ *
+ * Each thread updates its own shard, picked once per thread, with relaxed
+ * atomic adds; shards are padded to cache lines so workers never bounce a
+ * line between cores. Readers merge all shards, so totals observed while
+ * traffic flows are a moment-in-time sum rather than a locked snapshot.
+ *
+ * Latencies go into HDR-style log buckets: every power of two of
+ * microseconds is split into kSubBuckets linear buckets, which keeps the
+ * relative error under 1/kSubBuckets from 1us to about six days in a fixed
+ * number of counters.
+ */
+
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBucketBits = 3;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kMagnitudes = 37;  // Up to 2^39 us
+    static constexpr size_t kBucketCount = kMagnitudes * kSubBuckets;
+
+    // Bucket of a latency; values below kSubBuckets get exact buckets,
+    // larger ones clamp into the last
+    static size_t bucket_of(uint64_t latency_us) {
+        if (latency_us < kSubBuckets) return static_cast<size_t>(latency_us);
+
+        size_t magnitude = 63 - static_cast<size_t>(__builtin_clzll(latency_us));
+        size_t sub = static_cast<size_t>(latency_us >> (magnitude - kSubBucketBits)) & (kSubBuckets - 1);
+        size_t bucket = (magnitude - kSubBucketBits + 1) * kSubBuckets + sub;
+        return bucket < kBucketCount ? bucket : kBucketCount - 1;
+    }
+
+    // Smallest latency that lands in bucket
+    static uint64_t bucket_floor(size_t bucket) {
+        if (bucket < kSubBuckets) return bucket;
+
+        size_t magnitude = bucket / kSubBuckets + kSubBucketBits - 1;
+        uint64_t sub = bucket % kSubBuckets;
+        return (uint64_t(1) << magnitude) | (sub << (magnitude - kSubBucketBits));
+    }
+
+    // Merged, plain copy for reading
+    struct Snapshot {
+        std::array<uint64_t, kBucketCount> counts{};
+        uint64_t count = 0;
+        uint64_t sum_us = 0;
+
+        double mean_us() const { return count ? static_cast<double>(sum_us) / count : 0.0; }
+
+        // Lower bound of the bucket holding quantile q (0..1)
+        uint64_t percentile_us(double q) const {
+            if (count == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount; i++) {
+                seen += counts[i];
+                if (seen >= rank) return bucket_floor(i);
+            }
+            return bucket_floor(kBucketCount - 1);
+        }
+    };
+
+    void record(uint64_t latency_us) {
+        counts_[bucket_of(latency_us)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_us_.fetch_add(latency_us, std::memory_order_relaxed);
+    }
+
+    void add_to(Snapshot& snapshot) const {
+        for (size_t i = 0; i < kBucketCount; i++) {
+            snapshot.counts[i] += counts_[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += count_.load(std::memory_order_relaxed);
+        snapshot.sum_us += sum_us_.load(std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& count : counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_us_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBucketCount> counts_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_us_{0};
+};
+
+template <size_t TypeCount>
+class ShardedStats {
+public:
+    static constexpr size_t kShardCount = 16;
+
+    struct Totals {
+        uint64_t messages_sent = 0;
+        uint64_t messages_received = 0;
+        uint64_t messages_dropped = 0;
+        uint64_t messages_expired = 0;
+        uint64_t bytes_transferred = 0;
+    };
+
+    void record_sent(size_t bytes) {
+        Shard& shard = local_shard();
+        shard.messages_sent.fetch_add(1, std::memory_order_relaxed);
+        shard.bytes_transferred.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void record_received(size_t bytes) {
+        Shard& shard = local_shard();
+        shard.messages_received.fetch_add(1, std::memory_order_relaxed);
+        shard.bytes_transferred.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void record_dropped() { local_shard().messages_dropped.fetch_add(1, std::memory_order_relaxed); }
+    void record_expired() { local_shard().messages_expired.fetch_add(1, std::memory_order_relaxed); }
+
+    // Delivery latency of a message of type (MessageType as an index)
+    void record_latency(size_t type, uint64_t latency_us) {
+        if (type < TypeCount) local_shard().latency[type].record(latency_us);
+    }
+
+    Totals totals() const {
+        Totals totals;
+        for (const Shard& shard : shards_) {
+            totals.messages_sent += shard.messages_sent.load(std::memory_order_relaxed);
+            totals.messages_received += shard.messages_received.load(std::memory_order_relaxed);
+            totals.messages_dropped += shard.messages_dropped.load(std::memory_order_relaxed);
+            totals.messages_expired += shard.messages_expired.load(std::memory_order_relaxed);
+            totals.bytes_transferred += shard.bytes_transferred.load(std::memory_order_relaxed);
+        }
+        return totals;
+    }
+
+    LatencyHistogram::Snapshot latency(size_t type) const {
+        LatencyHistogram::Snapshot snapshot;
+        if (type >= TypeCount) return snapshot;
+        for (const Shard& shard : shards_) {
+            shard.latency[type].add_to(snapshot);
+        }
+        return snapshot;
+    }
+
+    // All types together
+    LatencyHistogram::Snapshot latency() const {
+        LatencyHistogram::Snapshot snapshot;
+        for (const Shard& shard : shards_) {
+            for (const auto& histogram : shard.latency) {
+                histogram.add_to(snapshot);
+            }
+        }
+        return snapshot;
+    }
+
+    void reset() {
+        for (Shard& shard : shards_) {
+            shard.messages_sent.store(0, std::memory_order_relaxed);
+            shard.messages_received.store(0, std::memory_order_relaxed);
+            shard.messages_dropped.store(0, std::memory_order_relaxed);
+            shard.messages_expired.store(0, std::memory_order_relaxed);
+            shard.bytes_transferred.store(0, std::memory_order_relaxed);
+            for (auto& histogram : shard.latency) {
+                histogram.reset();
+            }
+        }
+    }
+
+private:
+    struct alignas(kCacheLineSize) Shard {
+        std::atomic<uint64_t> messages_sent{0};
+        std::atomic<uint64_t> messages_received{0};
+        std::atomic<uint64_t> messages_dropped{0};
+        std::atomic<uint64_t> messages_expired{0};
+        std::atomic<uint64_t> bytes_transferred{0};
+        alignas(kCacheLineSize) std::array<LatencyHistogram, TypeCount> latency;
+    };
+
+    // Threads take shards round robin, once each
+    Shard& local_shard() {
+        static std::atomic<size_t> next_shard{0};
+        thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+        return shards_[shard];
+    }
+
+    std::array<Shard, kShardCount> shards_;
+};
+
+} // namespace multi_component_system
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace multi_component_system {
+
+/**
+ * Hashed hierarchical timer wheel
+ *
+ * Timers hang in intrusive lists off the slots of four wheels: 256 slots of
+ * one tick, then three wheels of 64 slots each covering 64 times the span of
+ * the wheel below (2^26 ticks in all). Scheduling, cancelling and
+ * rescheduling are O(1) whatever the number of timers; as time advances a
+ * slot of an outer wheel is redistributed into the wheels below when its
+ * turn comes. Deadlines beyond the outermost wheel wait in its last slot and
+ * are placed again on the way down.
+ *
+ * The wheel does no locking; its owner serializes access. advance() runs due
+ * callbacks after the wheel is updated, so callbacks may schedule or cancel
+ * timers, including their own.
+ */
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+
+    // Handle to a scheduled timer; stale once it fired or was cancelled
+    struct TimerId {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+        bool valid() const { return index != UINT32_MAX; }
+    };
+
+    TimerWheel(uint64_t tick_ms, uint64_t now_ms)
+        : tick_ms_(tick_ms ? tick_ms : 1), origin_ms_(now_ms), now_ms_(now_ms) {
+        heads_.fill(kNone);
+    }
+
+    uint64_t tick_ms() const { return tick_ms_; }
+    size_t size() const { return active_count_; }
+
+    // Run callback once delay_ms past the time of the last advance()
+    TimerId schedule(uint64_t delay_ms, Callback callback) {
+        return schedule_at(now_ms_ + delay_ms, std::move(callback));
+    }
+
+    // Run callback at the first advance() to deadline_ms or later
+    TimerId schedule_at(uint64_t deadline_ms, Callback callback) {
+        uint32_t index = allocate();
+        Timer& timer = timers_[index];
+        timer.expiry_tick = tick_for(deadline_ms);
+        timer.callback = std::move(callback);
+        link(index);
+        active_count_++;
+        return TimerId{index, timer.generation};
+    }
+
+    // Stop a timer; false when it already fired or was cancelled
+    bool cancel(TimerId id) {
+        if (!is_pending(id)) return false;
+
+        unlink(id.index);
+        release(id.index);
+        active_count_--;
+        return true;
+    }
+
+    // Move a pending timer's deadline to delay_ms past the last advance(),
+    // keeping its callback; false when it is no longer pending
+    bool reschedule(TimerId id, uint64_t delay_ms) {
+        return reschedule_at(id, now_ms_ + delay_ms);
+    }
+
+    bool reschedule_at(TimerId id, uint64_t deadline_ms) {
+        if (!is_pending(id)) return false;
+
+        unlink(id.index);
+        timers_[id.index].expiry_tick = tick_for(deadline_ms);
+        link(id.index);
+        return true;
+    }
+
+    bool is_pending(TimerId id) const {
+        return id.index < timers_.size() && timers_[id.index].generation == id.generation &&
+               timers_[id.index].slot != kNone;
+    }
+
+    // Advance to now_ms and run every timer that came due; returns how many
+    size_t advance(uint64_t now_ms) {
+        if (now_ms > now_ms_) now_ms_ = now_ms;
+        uint64_t target = now_ms > origin_ms_ ? (now_ms - origin_ms_) / tick_ms_ : 0;
+        std::vector<Callback> due;
+        while (current_tick_ < target) {
+            if (active_count_ == 0) {
+                current_tick_ = target;
+                break;
+            }
+            current_tick_++;
+
+            // Bring the outer slots whose turn it is down a level
+            for (size_t level = 1; level < kLevels; level++) {
+                if ((current_tick_ & ((uint64_t(1) << level_shift(level)) - 1)) != 0) break;
+                cascade(slot_of(level, current_tick_));
+            }
+
+            uint32_t index = heads_[slot_of(0, current_tick_)];
+            while (index != kNone) {
+                uint32_t next = timers_[index].next;
+                if (timers_[index].expiry_tick <= current_tick_) {
+                    unlink(index);
+                    due.push_back(std::move(timers_[index].callback));
+                    release(index);
+                    active_count_--;
+                }
+                index = next;
+            }
+        }
+
+        for (auto& callback : due) {
+            if (callback) callback();
+        }
+        return due.size();
+    }
+
+    // Milliseconds until the earliest tick that may have work, at most
+    // max_ms; for sizing the owner's sleep
+    uint64_t time_to_next_ms(uint64_t now_ms, uint64_t max_ms) const {
+        if (active_count_ == 0) return max_ms;
+
+        uint64_t now_tick = now_ms > origin_ms_ ? (now_ms - origin_ms_) / tick_ms_ : 0;
+        for (uint64_t tick = current_tick_ + 1; tick <= current_tick_ + kLevel0Slots; tick++) {
+            bool cascades = (tick & (kLevel0Slots - 1)) == 0;
+            if (cascades || heads_[slot_of(0, tick)] != kNone) {
+                uint64_t wait_ticks = tick > now_tick ? tick - now_tick : 0;
+                uint64_t wait_ms = wait_ticks * tick_ms_;
+                return wait_ms < max_ms ? wait_ms : max_ms;
+            }
+        }
+        return max_ms;
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr size_t kLevels = 4;
+    static constexpr uint64_t kLevel0Bits = 8;
+    static constexpr uint64_t kLevelBits = 6;
+    static constexpr uint64_t kLevel0Slots = uint64_t(1) << kLevel0Bits;
+    static constexpr uint64_t kLevelSlots = uint64_t(1) << kLevelBits;
+    static constexpr size_t kSlotCount = kLevel0Slots + (kLevels - 1) * kLevelSlots;
+    static constexpr uint64_t kMaxDelta = (uint64_t(1) << (kLevel0Bits + (kLevels - 1) * kLevelBits)) - 1;
+
+    struct Timer {
+        uint64_t expiry_tick = 0;
+        uint32_t prev = kNone;
+        uint32_t next = kNone;
+        uint32_t slot = kNone;  // kNone when free
+        uint32_t generation = 0;
+        Callback callback;
+    };
+
+    static uint64_t level_shift(size_t level) {
+        return level == 0 ? 0 : kLevel0Bits + (level - 1) * kLevelBits;
+    }
+
+    static uint32_t slot_of(size_t level, uint64_t tick) {
+        if (level == 0) return static_cast<uint32_t>(tick & (kLevel0Slots - 1));
+        uint64_t index = (tick >> level_shift(level)) & (kLevelSlots - 1);
+        return static_cast<uint32_t>(kLevel0Slots + (level - 1) * kLevelSlots + index);
+    }
+
+    // First tick at or after deadline_ms, so a timer never fires early;
+    // overdue deadlines get the next tick
+    uint64_t tick_for(uint64_t deadline_ms) const {
+        uint64_t offset = deadline_ms > origin_ms_ ? deadline_ms - origin_ms_ : 0;
+        uint64_t tick = (offset + tick_ms_ - 1) / tick_ms_;
+        return tick > current_tick_ ? tick : current_tick_ + 1;
+    }
+
+    void link(uint32_t index) {
+        Timer& timer = timers_[index];
+        uint64_t delta = timer.expiry_tick > current_tick_ ? timer.expiry_tick - current_tick_ : 0;
+        uint64_t placed = delta > kMaxDelta ? current_tick_ + kMaxDelta : timer.expiry_tick;
+        if (delta == 0) placed = current_tick_ + 1;  // Overdue: next tick
+        delta = placed - current_tick_;
+
+        size_t level = 0;
+        while (level + 1 < kLevels && delta >= (uint64_t(1) << level_shift(level + 1))) {
+            level++;
+        }
+        push(index, slot_of(level, placed));
+    }
+
+    void push(uint32_t index, uint32_t slot) {
+        Timer& timer = timers_[index];
+        timer.slot = slot;
+        timer.prev = kNone;
+        timer.next = heads_[slot];
+        if (timer.next != kNone) timers_[timer.next].prev = index;
+        heads_[slot] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Timer& timer = timers_[index];
+        if (timer.prev != kNone) {
+            timers_[timer.prev].next = timer.next;
+        } else {
+            heads_[timer.slot] = timer.next;
+        }
+        if (timer.next != kNone) timers_[timer.next].prev = timer.prev;
+        timer.prev = kNone;
+        timer.next = kNone;
+        timer.slot = kNone;
+    }
+
+    // Runs before advance() scans the current level-0 slot, so timers due
+    // on this very tick (an outer wheel's boundary) go into that slot
+    // rather than being treated as overdue and placed on the next tick
+    void cascade(uint32_t slot) {
+        uint32_t index = heads_[slot];
+        heads_[slot] = kNone;
+        while (index != kNone) {
+            uint32_t next = timers_[index].next;
+            timers_[index].slot = kNone;
+            if (timers_[index].expiry_tick <= current_tick_) {
+                push(index, slot_of(0, current_tick_));
+            } else {
+                link(index);
+            }
+            index = next;
+        }
+    }
+
+    uint32_t allocate() {
+        if (!free_.empty()) {
+            uint32_t index = free_.back();
+            free_.pop_back();
+            return index;
+        }
+        timers_.emplace_back();
+        return static_cast<uint32_t>(timers_.size() - 1);
+    }
+
+    void release(uint32_t index) {
+        Timer& timer = timers_[index];
+        timer.callback = nullptr;
+        timer.slot = kNone;
+        timer.generation++;
+        free_.push_back(index);
+    }
+
+    uint64_t tick_ms_;
+    uint64_t origin_ms_;
+    uint64_t now_ms_;  // Latest time passed to advance()
+    uint64_t current_tick_ = 0;
+    size_t active_count_ = 0;
+
+    std::vector<Timer> timers_;
+    std::vector<uint32_t> free_;
+    std::array<uint32_t, kSlotCount> heads_;
+};
+
+} // namespace multi_component_system
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace multi_component_system {
+
+/**
+ * Compiled topic trie for routing rules and event subscriptions
+ *
+ * Patterns are '.'-separated segments; "*" matches exactly one segment and
+ * "**" any number, including none ("user.*.created", "audit.**"). A
+ * TopicTrie is built once from a Builder and never changes: nodes, edges
+ * and values sit in flat arrays, each node's edges sorted for a binary
+ * search, so a lookup costs the number of segments in the topic rather than
+ * the number of patterns.
+ *
+ * SnapshotCell publishes the current trie RCU-style: readers pin it with
+ * two atomic increments and no lock, writers swap in a rebuilt trie and
+ * wait for the readers of the old one before freeing it.
+ */
+template <typename Value>
+class TopicTrie {
+public:
+    class Builder {
+    public:
+        void add(const std::string& pattern, Value value) {
+            patterns_[pattern].push_back(std::move(value));
+        }
+
+        void remove(const std::string& pattern) { patterns_.erase(pattern); }
+
+        bool empty() const { return patterns_.empty(); }
+
+        std::unique_ptr<const TopicTrie> build() const {
+            return std::unique_ptr<const TopicTrie>(new TopicTrie(patterns_));
+        }
+
+    private:
+        std::map<std::string, std::vector<Value>> patterns_;
+    };
+
+    size_t pattern_count() const { return pattern_count_; }
+
+    // Every value whose pattern matches topic, each once
+    void match(std::string_view topic, std::vector<const Value*>& out) const {
+        std::vector<std::string_view> segments = split(topic);
+        std::vector<uint32_t> hits;
+        collect(0, segments, 0, hits);
+        std::sort(hits.begin(), hits.end());
+        hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+        for (uint32_t node : hits) {
+            for (uint32_t i = 0; i < nodes_[node].value_count; i++) {
+                out.push_back(&values_[nodes_[node].value_begin + i]);
+            }
+        }
+    }
+
+    // First value of the most specific matching pattern, preferring a literal
+    // segment over "*" over "**" from left to right; nullptr for no match
+    const Value* find_best(std::string_view topic) const {
+        std::vector<std::string_view> segments = split(topic);
+        uint32_t node = best(0, segments, 0);
+        return node == kNone ? nullptr : &values_[nodes_[node].value_begin];
+    }
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    struct Node {
+        uint32_t edge_begin = 0;
+        uint32_t edge_count = 0;
+        uint32_t star = kNone;       // "*" child
+        uint32_t globstar = kNone;   // "**" child
+        uint32_t value_begin = 0;
+        uint32_t value_count = 0;
+    };
+
+    struct Edge {
+        uint32_t segment_offset;
+        uint32_t segment_length;
+        uint32_t child;
+    };
+
+    // Build-time tree, flattened breadth first so siblings are contiguous
+    struct BuildNode {
+        std::map<std::string, std::unique_ptr<BuildNode>> children;
+        std::unique_ptr<BuildNode> star;
+        std::unique_ptr<BuildNode> globstar;
+        const std::vector<Value>* values = nullptr;
+    };
+
+    explicit TopicTrie(const std::map<std::string, std::vector<Value>>& patterns) {
+        BuildNode root;
+        for (const auto& [pattern, values] : patterns) {
+            BuildNode* node = &root;
+            for (std::string_view segment : split(pattern)) {
+                std::unique_ptr<BuildNode>* next;
+                if (segment == "*") {
+                    next = &node->star;
+                } else if (segment == "**") {
+                    next = &node->globstar;
+                } else {
+                    next = &node->children[std::string(segment)];
+                }
+                if (!*next) *next = std::make_unique<BuildNode>();
+                node = next->get();
+            }
+            node->values = &values;
+            pattern_count_++;
+        }
+
+        std::vector<const BuildNode*> order{&root};
+        nodes_.emplace_back();
+        for (size_t i = 0; i < order.size(); i++) {
+            const BuildNode* source = order[i];
+            auto add_child = [&](const BuildNode* child) {
+                order.push_back(child);
+                nodes_.emplace_back();
+                return static_cast<uint32_t>(nodes_.size() - 1);
+            };
+
+            uint32_t edge_begin = static_cast<uint32_t>(edges_.size());
+            for (const auto& [segment, child] : source->children) {
+                Edge edge{static_cast<uint32_t>(segments_.size()),
+                          static_cast<uint32_t>(segment.size()), add_child(child.get())};
+                segments_ += segment;
+                edges_.push_back(edge);
+            }
+            uint32_t star = source->star ? add_child(source->star.get()) : kNone;
+            uint32_t globstar = source->globstar ? add_child(source->globstar.get()) : kNone;
+
+            Node& node = nodes_[i];
+            node.edge_begin = edge_begin;
+            node.edge_count = static_cast<uint32_t>(edges_.size()) - edge_begin;
+            node.star = star;
+            node.globstar = globstar;
+            if (source->values && !source->values->empty()) {
+                node.value_begin = static_cast<uint32_t>(values_.size());
+                node.value_count = static_cast<uint32_t>(source->values->size());
+                values_.insert(values_.end(), source->values->begin(), source->values->end());
+            }
+        }
+    }
+
+    static std::vector<std::string_view> split(std::string_view topic) {
+        std::vector<std::string_view> segments;
+        size_t start = 0;
+        while (start <= topic.size()) {
+            size_t end = topic.find('.', start);
+            if (end == std::string_view::npos) end = topic.size();
+            segments.push_back(topic.substr(start, end - start));
+            start = end + 1;
+        }
+        return segments;
+    }
+
+    // std::map orders the edges, so compare the same way
+    uint32_t find_edge(const Node& node, std::string_view segment) const {
+        const Edge* begin = edges_.data() + node.edge_begin;
+        const Edge* end = begin + node.edge_count;
+        const Edge* edge = std::lower_bound(begin, end, segment,
+                                            [this](const Edge& e, std::string_view key) {
+                                                return edge_segment(e) < key;
+                                            });
+        return edge != end && edge_segment(*edge) == segment ? edge->child : kNone;
+    }
+
+    std::string_view edge_segment(const Edge& edge) const {
+        return std::string_view(segments_).substr(edge.segment_offset, edge.segment_length);
+    }
+
+    void collect(uint32_t index, const std::vector<std::string_view>& segments, size_t depth,
+                 std::vector<uint32_t>& hits) const {
+        const Node& node = nodes_[index];
+        if (node.globstar != kNone) {
+            // "**" takes zero or more of the remaining segments
+            for (size_t skip = depth; skip <= segments.size(); skip++) {
+                collect(node.globstar, segments, skip, hits);
+            }
+        }
+        if (depth == segments.size()) {
+            if (node.value_count > 0) hits.push_back(index);
+            return;
+        }
+
+        uint32_t child = find_edge(node, segments[depth]);
+        if (child != kNone) collect(child, segments, depth + 1, hits);
+        if (node.star != kNone) collect(node.star, segments, depth + 1, hits);
+    }
+
+    uint32_t best(uint32_t index, const std::vector<std::string_view>& segments,
+                  size_t depth) const {
+        const Node& node = nodes_[index];
+        if (depth == segments.size()) {
+            if (node.value_count > 0) return index;
+        } else {
+            uint32_t child = find_edge(node, segments[depth]);
+            if (child != kNone) {
+                uint32_t hit = best(child, segments, depth + 1);
+                if (hit != kNone) return hit;
+            }
+            if (node.star != kNone) {
+                uint32_t hit = best(node.star, segments, depth + 1);
+                if (hit != kNone) return hit;
+            }
+        }
+        if (node.globstar != kNone) {
+            // Shortest expansion first
+            for (size_t skip = depth; skip <= segments.size(); skip++) {
+                uint32_t hit = best(node.globstar, segments, skip);
+                if (hit != kNone) return hit;
+            }
+        }
+        return kNone;
+    }
+
+    std::vector<Node> nodes_;
+    std::vector<Edge> edges_;
+    std::vector<Value> values_;
+    std::string segments_;
+    size_t pattern_count_ = 0;
+};
+
+template <typename T>
+class SnapshotCell {
+public:
+    SnapshotCell() = default;
+    explicit SnapshotCell(std::unique_ptr<const T> initial) : current_(initial.release()) {}
+
+    SnapshotCell(const SnapshotCell&) = delete;
+    SnapshotCell& operator=(const SnapshotCell&) = delete;
+
+    ~SnapshotCell() { delete current_.load(std::memory_order_relaxed); }
+
+    // Pins the snapshot that was current when it was made; keep it short
+    class Reader {
+    public:
+        explicit Reader(const SnapshotCell& cell) : cell_(cell) {
+            for (;;) {
+                epoch_ = cell_.epoch_.load(std::memory_order_seq_cst);
+                cell_.readers_[epoch_ & 1].fetch_add(1, std::memory_order_seq_cst);
+                if (cell_.epoch_.load(std::memory_order_seq_cst) == epoch_) break;
+                cell_.readers_[epoch_ & 1].fetch_sub(1, std::memory_order_release);
+            }
+            snapshot_ = cell_.current_.load(std::memory_order_acquire);
+        }
+
+        ~Reader() { cell_.readers_[epoch_ & 1].fetch_sub(1, std::memory_order_release); }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        const T* get() const { return snapshot_; }
+        const T* operator->() const { return snapshot_; }
+        explicit operator bool() const { return snapshot_ != nullptr; }
+
+    private:
+        const SnapshotCell& cell_;
+        uint32_t epoch_;
+        const T* snapshot_;
+    };
+
+    // Swap in a new snapshot and free the old one once no reader holds it;
+    // writers must be serialized by the caller
+    void publish(std::unique_ptr<const T> snapshot) {
+        const T* old = current_.exchange(snapshot.release(), std::memory_order_acq_rel);
+
+        // Readers that might hold old registered under the current epoch
+        uint32_t epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+        while (readers_[epoch & 1].load(std::memory_order_acquire) != 0) {
+            std::this_thread::yield();
+        }
+        delete old;
+    }
+
+private:
+    std::atomic<const T*> current_{nullptr};
+    mutable std::atomic<uint32_t> epoch_{0};
+    mutable std::array<std::atomic<uint64_t>, 2> readers_{};
+};
+
+} // namespace multi_component_system
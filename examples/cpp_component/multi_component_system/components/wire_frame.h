@@ -0,0 +1,396 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "payload_buffer.h"
+
+namespace multi_component_system {
+
+/**
+ * Batched wire framing for the message bus
+ *
+ * A frame packs many messages behind one header:
+ *
+ *   "MBF1" | flags:u8 | body_size:varint | stored_size:varint | stored body
+ *
+ * flags bit 0 says the body is LZ4 block compressed (stored_size bytes that
+ * inflate to body_size). The body is
+ *
+ *   string_count:varint | (length:varint bytes)*       shared dictionary
+ *   message_count:varint | message*
+ *
+ * and a message is its ids, sender and recipient as dictionary indices,
+ * type:u8, priority:u8, timestamp and ttl as varints, metadata as pairs of
+ * dictionary indices and the payload as length:varint bytes. Ids, service
+ * names and metadata keys repeat across small messages, so each is sent
+ * once per frame.
+ *
+ * FrameReader decodes a frame into MessageViews that point into the frame
+ * (or its one inflated copy) without allocating per field. save_state and
+ * load_state write and read the same frames.
+ */
+
+namespace wire {
+
+inline void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+// False on truncated input or a varint over 64 bits
+inline bool get_varint(std::span<const uint8_t> in, size_t& position, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position >= in.size()) return false;
+        uint8_t byte = in[position++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// LZ4 block format, compatible with LZ4_decompress_safe
+inline std::vector<uint8_t> lz4_compress(std::span<const uint8_t> in) {
+    constexpr size_t kMinMatch = 4;
+    constexpr size_t kLastLiterals = 5;
+    constexpr size_t kMatchFindLimit = 12;
+    constexpr int kHashBits = 12;
+
+    std::vector<uint8_t> out;
+    out.reserve(in.size() + in.size() / 255 + 16);
+    const uint8_t* src = in.data();
+    size_t size = in.size();
+
+    auto read32 = [src](size_t at) {
+        uint32_t value;
+        std::memcpy(&value, src + at, sizeof(value));
+        return value;
+    };
+    auto put_length = [&out](size_t length) {
+        for (; length >= 255; length -= 255) {
+            out.push_back(255);
+        }
+        out.push_back(static_cast<uint8_t>(length));
+    };
+    auto emit = [&](size_t literal_start, size_t literal_length, size_t offset,
+                    size_t match_length) {
+        uint8_t token = static_cast<uint8_t>((literal_length >= 15 ? 15 : literal_length) << 4);
+        if (offset) {
+            size_t code = match_length - kMinMatch;
+            token |= static_cast<uint8_t>(code >= 15 ? 15 : code);
+        }
+        out.push_back(token);
+        if (literal_length >= 15) put_length(literal_length - 15);
+        out.insert(out.end(), src + literal_start, src + literal_start + literal_length);
+        if (offset) {
+            out.push_back(static_cast<uint8_t>(offset));
+            out.push_back(static_cast<uint8_t>(offset >> 8));
+            if (match_length - kMinMatch >= 15) put_length(match_length - kMinMatch - 15);
+        }
+    };
+
+    size_t anchor = 0;
+    if (size > kMatchFindLimit) {
+        std::vector<uint32_t> table(size_t(1) << kHashBits, 0);  // Position + 1
+        size_t match_limit = size - kLastLiterals;
+        size_t position = 0;
+        while (position + kMatchFindLimit < size) {
+            uint32_t sequence = read32(position);
+            uint32_t hash = (sequence * 2654435761u) >> (32 - kHashBits);
+            size_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > 65535 ||
+                read32(candidate - 1) != sequence) {
+                position++;
+                continue;
+            }
+            size_t reference = candidate - 1;
+            size_t length = kMinMatch;
+            while (position + length < match_limit && src[reference + length] == src[position + length]) {
+                length++;
+            }
+            emit(anchor, position - anchor, position - reference, length);
+            position += length;
+            anchor = position;
+        }
+    }
+    emit(anchor, size - anchor, 0, 0);
+    return out;
+}
+
+// Inflate into exactly out.size() bytes; false on malformed input
+inline bool lz4_decompress(std::span<const uint8_t> in, std::span<uint8_t> out) {
+    size_t in_position = 0;
+    size_t out_position = 0;
+    auto get_length = [&](size_t& length) {
+        uint8_t byte;
+        do {
+            if (in_position >= in.size()) return false;
+            byte = in[in_position++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (in_position < in.size()) {
+        uint8_t token = in[in_position++];
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !get_length(literal_length)) return false;
+        if (literal_length > in.size() - in_position ||
+            literal_length > out.size() - out_position) {
+            return false;
+        }
+        if (literal_length > 0) {
+            std::memcpy(out.data() + out_position, in.data() + in_position, literal_length);
+        }
+        in_position += literal_length;
+        out_position += literal_length;
+        if (in_position == in.size()) break;  // Last sequence has no match
+
+        if (in.size() - in_position < 2) return false;
+        size_t offset = in[in_position] | (static_cast<size_t>(in[in_position + 1]) << 8);
+        in_position += 2;
+        size_t match_length = token & 15;
+        if (match_length == 15 && !get_length(match_length)) return false;
+        match_length += 4;
+        if (offset == 0 || offset > out_position || match_length > out.size() - out_position) {
+            return false;
+        }
+        // Byte by byte: the match may overlap what it produces
+        for (size_t i = 0; i < match_length; i++, out_position++) {
+            out[out_position] = out[out_position - offset];
+        }
+    }
+    return out_position == out.size();
+}
+
+} // namespace wire
+
+struct MessageView {
+    std::string_view message_id;
+    std::string_view correlation_id;
+    std::string_view sender_id;
+    std::string_view recipient_id;
+    uint8_t type = 0;
+    uint8_t priority = 0;
+    uint64_t timestamp = 0;
+    uint32_t ttl_seconds = 0;
+    std::span<const std::pair<std::string_view, std::string_view>> metadata;
+    PayloadView payload;
+};
+
+class FrameWriter {
+public:
+    static constexpr uint8_t kCompressed = 1;
+
+    explicit FrameWriter(bool compress = true) : compress_(compress) {}
+
+    template <typename Metadata>
+    void add(std::string_view message_id, std::string_view correlation_id,
+             std::string_view sender_id, std::string_view recipient_id, uint8_t type,
+             uint8_t priority, uint64_t timestamp, uint32_t ttl_seconds,
+             const Metadata& metadata, PayloadView payload) {
+        put_string(message_id);
+        put_string(correlation_id);
+        put_string(sender_id);
+        put_string(recipient_id);
+        messages_.push_back(type);
+        messages_.push_back(priority);
+        wire::put_varint(messages_, timestamp);
+        wire::put_varint(messages_, ttl_seconds);
+        wire::put_varint(messages_, metadata.size());
+        for (const auto& [key, value] : metadata) {
+            put_string(key);
+            put_string(value);
+        }
+        wire::put_varint(messages_, payload.size());
+        messages_.insert(messages_.end(), payload.begin(), payload.end());
+        message_count_++;
+    }
+
+    size_t message_count() const { return message_count_; }
+    size_t pending_bytes() const { return messages_.size(); }
+
+    // Encode everything added so far as one frame and start over
+    std::vector<uint8_t> finish() {
+        std::vector<uint8_t> body;
+        body.reserve(messages_.size() + dictionary_bytes_ + 16);
+        wire::put_varint(body, strings_.size());
+        for (const std::string& string : strings_) {
+            wire::put_varint(body, string.size());
+            body.insert(body.end(), string.begin(), string.end());
+        }
+        wire::put_varint(body, message_count_);
+        body.insert(body.end(), messages_.begin(), messages_.end());
+
+        std::vector<uint8_t> frame = {'M', 'B', 'F', '1'};
+        std::vector<uint8_t> packed;
+        if (compress_) {
+            packed = wire::lz4_compress(body);
+        }
+        bool compressed = compress_ && packed.size() < body.size();
+        const std::vector<uint8_t>& stored = compressed ? packed : body;
+        frame.push_back(compressed ? kCompressed : 0);
+        wire::put_varint(frame, body.size());
+        wire::put_varint(frame, stored.size());
+        frame.insert(frame.end(), stored.begin(), stored.end());
+
+        strings_.clear();
+        indices_.clear();
+        messages_.clear();
+        message_count_ = 0;
+        dictionary_bytes_ = 0;
+        return frame;
+    }
+
+private:
+    void put_string(std::string_view string) {
+        auto found = indices_.find(std::string(string));
+        uint32_t index;
+        if (found != indices_.end()) {
+            index = found->second;
+        } else {
+            index = static_cast<uint32_t>(strings_.size());
+            strings_.emplace_back(string);
+            indices_.emplace(strings_.back(), index);
+            dictionary_bytes_ += string.size() + 2;
+        }
+        wire::put_varint(messages_, index);
+    }
+
+    bool compress_;
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, uint32_t> indices_;
+    std::vector<uint8_t> messages_;
+    size_t message_count_ = 0;
+    size_t dictionary_bytes_ = 0;
+};
+
+class FrameReader {
+public:
+    // Decode a frame; the views stay valid while frame does and until the
+    // next parse. Returns how many bytes the frame took, 0 when malformed.
+    size_t parse(std::span<const uint8_t> frame) {
+        messages_.clear();
+        metadata_.clear();
+        dictionary_.clear();
+
+        size_t position = 4;
+        uint64_t body_size;
+        uint64_t stored_size;
+        if (frame.size() < 5 || std::memcmp(frame.data(), "MBF1", 4) != 0) return 0;
+        uint8_t flags = frame[position++];
+        if ((flags & ~FrameWriter::kCompressed) != 0 || !wire::get_varint(frame, position, body_size) ||
+            !wire::get_varint(frame, position, stored_size) ||
+            stored_size > frame.size() - position) {
+            return 0;
+        }
+        std::span<const uint8_t> stored = frame.subspan(position, stored_size);
+        size_t frame_size = position + stored_size;
+
+        std::span<const uint8_t> body = stored;
+        if (flags & FrameWriter::kCompressed) {
+            // A valid LZ4 block expands at most 255 times
+            if (body_size > stored_size * 255) return 0;
+            inflated_.resize(body_size);
+            if (!wire::lz4_decompress(stored, inflated_)) return 0;
+            body = inflated_;
+        } else if (body_size != stored_size) {
+            return 0;
+        }
+
+        return decode(body) ? frame_size : 0;
+    }
+
+    const std::vector<MessageView>& messages() const { return messages_; }
+
+private:
+    bool decode(std::span<const uint8_t> body) {
+        size_t position = 0;
+        uint64_t count;
+        if (!wire::get_varint(body, position, count) || count > body.size()) return false;
+        dictionary_.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t length;
+            if (!wire::get_varint(body, position, length) || length > body.size() - position) {
+                return false;
+            }
+            dictionary_.emplace_back(reinterpret_cast<const char*>(body.data() + position), length);
+            position += length;
+        }
+
+        if (!wire::get_varint(body, position, count) || count > body.size()) return false;
+        messages_.reserve(count);
+        std::vector<std::pair<size_t, size_t>> metadata_ranges;
+        metadata_ranges.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            MessageView view;
+            uint64_t value;
+            if (!get_string(body, position, view.message_id) ||
+                !get_string(body, position, view.correlation_id) ||
+                !get_string(body, position, view.sender_id) ||
+                !get_string(body, position, view.recipient_id) || body.size() - position < 2) {
+                return false;
+            }
+            view.type = body[position++];
+            view.priority = body[position++];
+            if (!wire::get_varint(body, position, view.timestamp) ||
+                !wire::get_varint(body, position, value) || value > UINT32_MAX) {
+                return false;
+            }
+            view.ttl_seconds = static_cast<uint32_t>(value);
+
+            if (!wire::get_varint(body, position, value) || value > body.size()) return false;
+            size_t metadata_begin = metadata_.size();
+            for (uint64_t j = 0; j < value; j++) {
+                std::string_view key;
+                std::string_view metadata_value;
+                if (!get_string(body, position, key) ||
+                    !get_string(body, position, metadata_value)) {
+                    return false;
+                }
+                metadata_.emplace_back(key, metadata_value);
+            }
+            metadata_ranges.emplace_back(metadata_begin, metadata_.size() - metadata_begin);
+
+            if (!wire::get_varint(body, position, value) || value > body.size() - position) {
+                return false;
+            }
+            view.payload = body.subspan(position, value);
+            position += value;
+            messages_.push_back(view);
+        }
+
+        // metadata_ has stopped growing; point the views at it
+        for (size_t i = 0; i < messages_.size(); i++) {
+            messages_[i].metadata = std::span<const std::pair<std::string_view, std::string_view>>(
+                metadata_.data() + metadata_ranges[i].first, metadata_ranges[i].second);
+        }
+        return position == body.size();
+    }
+
+    bool get_string(std::span<const uint8_t> body, size_t& position, std::string_view& out) {
+        uint64_t index;
+        if (!wire::get_varint(body, position, index) || index >= dictionary_.size()) return false;
+        out = dictionary_[index];
+        return true;
+    }
+
+    std::vector<uint8_t> inflated_;
+    std::vector<std::string_view> dictionary_;
+    std::vector<std::pair<std::string_view, std::string_view>> metadata_;
+    std::vector<MessageView> messages_;
+};
+
+} // namespace multi_component_system
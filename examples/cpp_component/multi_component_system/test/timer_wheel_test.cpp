@@ -0,0 +1,94 @@
+#include "../components/timer_wheel.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using multi_component_system::TimerWheel;
+
+#define ASSERT_TRUE(condition) do { \
+    if (!(condition)) { \
+        std::cerr << "ASSERTION FAILED: " << #condition << " at " << __FILE__ << ":" << __LINE__ << std::endl; \
+        exit(1); \
+    } \
+} while(0)
+
+#define ASSERT_EQ(expected, actual) ASSERT_TRUE((expected) == (actual))
+
+namespace {
+
+// Fires exactly at deadline_ms, not a tick before or after
+void expect_fires_at(uint64_t deadline_ms) {
+    TimerWheel wheel(1, 0);
+    bool fired = false;
+    wheel.schedule_at(deadline_ms, [&fired] { fired = true; });
+
+    ASSERT_EQ(size_t(0), wheel.advance(deadline_ms - 1));
+    ASSERT_TRUE(!fired);
+    ASSERT_EQ(size_t(1), wheel.advance(deadline_ms));
+    ASSERT_TRUE(fired);
+    ASSERT_EQ(size_t(0), wheel.size());
+}
+
+// Expiries on and around the ticks where an outer wheel cascades
+void test_level_boundaries() {
+    const uint64_t boundaries[] = {256, 16384, uint64_t(1) << 20};
+    for (uint64_t boundary : boundaries) {
+        expect_fires_at(boundary - 1);
+        expect_fires_at(boundary);
+        expect_fires_at(boundary + 1);
+        expect_fires_at(boundary * 2);
+    }
+}
+
+// Timers scheduled part way through a wheel's span, stepped a tick at a time
+void test_fire_tick_matches_deadline() {
+    TimerWheel wheel(1, 0);
+    uint64_t now = 0;
+    std::vector<uint64_t> scheduled_at = {0, 1, 100, 255, 256, 300, 16000};
+    const uint64_t delays[] = {1, 155, 156, 256, 257, 16384 - 100, 16384, 20000};
+
+    struct Expect {
+        uint64_t deadline;
+        uint64_t fired_at;
+    };
+    std::vector<Expect> expects;
+    expects.reserve(scheduled_at.size() * (sizeof(delays) / sizeof(delays[0])));
+
+    size_t next_start = 0;
+    size_t fired = 0;
+    uint64_t last_deadline = 0;
+    while (next_start < scheduled_at.size() || wheel.size() > 0) {
+        while (next_start < scheduled_at.size() && scheduled_at[next_start] == now) {
+            for (uint64_t delay : delays) {
+                expects.push_back({now + delay, 0});
+                Expect* expect = &expects.back();
+                wheel.schedule(delay, [expect, &now, &fired] {
+                    expect->fired_at = now;
+                    fired++;
+                });
+                if (now + delay > last_deadline) last_deadline = now + delay;
+            }
+            next_start++;
+        }
+        now++;
+        wheel.advance(now);
+        ASSERT_TRUE(now <= last_deadline || wheel.size() == 0);
+    }
+
+    ASSERT_EQ(expects.size(), fired);
+    for (const Expect& expect : expects) {
+        ASSERT_EQ(expect.deadline, expect.fired_at);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "Running timer wheel tests..." << std::endl;
+    test_level_boundaries();
+    test_fire_tick_matches_deadline();
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
@@ -1,5 +1,13 @@
 #include "foundation/utils.h"
 
+#include <algorithm>
+#include <charconv>
+
+// WebAssembly SIMD support (-msimd128); other builds scan eight bytes per step
+#if defined(__wasm__) && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
 namespace foundation {
 namespace utils {
 
@@ -106,6 +114,133 @@ bool load_config_from_json(const std::string& json_str) {
     }
 }
 
+// CsvPointParser implementation
+
+// Offset of the first '\n' in data, or size when there is none
+static size_t find_newline(const char* data, size_t size) {
+    size_t i = 0;
+#if defined(__wasm__) && defined(__wasm_simd128__)
+    const v128_t newline = wasm_i8x16_splat('\n');
+    for (; i + 16 <= size; i += 16) {
+        uint32_t mask = wasm_i8x16_bitmask(wasm_i8x16_eq(wasm_v128_load(data + i), newline));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+#else
+    // Bytes equal to '\n' become zero; the lowest flagged byte is exact
+    constexpr uint64_t kOnes = 0x0101010101010101ULL;
+    constexpr uint64_t kHighs = 0x8080808080808080ULL;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        uint64_t x = word ^ (kOnes * '\n');
+        uint64_t zeros = (x - kOnes) & ~x & kHighs;
+        if (zeros) return i + (__builtin_ctzll(zeros) >> 3);
+    }
+#endif
+    for (; i < size; i++) {
+        if (data[i] == '\n') return i;
+    }
+    return size;
+}
+
+static const char* skip_blanks(const char* p, const char* end) {
+    while (p != end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+// Integer field at p, allowing surrounding blanks and a leading '+';
+// returns the end of the field or nullptr
+static const char* parse_coordinate(const char* p, const char* end, int32_t* value) {
+    p = skip_blanks(p, end);
+    if (p != end && *p == '+') p++;
+    std::from_chars_result result = std::from_chars(p, end, *value);
+    if (result.ec != std::errc()) return nullptr;
+    return skip_blanks(result.ptr, end);
+}
+
+CsvPointParser::FeedResult CsvPointParser::feed(absl::string_view chunk, absl::Span<Point> out) {
+    size_t pos = 0;
+    size_t written = 0;
+
+    while (pos < chunk.size() && written < out.size()) {
+        size_t newline = pos + find_newline(chunk.data() + pos, chunk.size() - pos);
+        absl::string_view piece = chunk.substr(pos, newline - pos);
+
+        // Keep a trailing partial line for the next chunk, unless it's too long
+        if (newline == chunk.size()) {
+            if (!overlong_ && partial_.size() + piece.size() <= kMaxLineLength) {
+                partial_.append(piece.data(), piece.size());
+            } else {
+                overlong_ = true;
+                partial_.clear();
+            }
+            return FeedResult{chunk.size(), written};
+        }
+
+        absl::string_view line = piece;
+        if (!partial_.empty() && !overlong_) {
+            if (partial_.size() + piece.size() <= kMaxLineLength) {
+                partial_.append(piece.data(), piece.size());
+                line = partial_;
+            } else {
+                overlong_ = true;
+            }
+        }
+
+        if (overlong_ || line.size() > kMaxLineLength) {
+            lines_skipped_++;
+        } else if (parse_line(line, &out[written])) {
+            written++;
+        }
+        partial_.clear();
+        overlong_ = false;
+        pos = newline + 1;
+    }
+
+    return FeedResult{pos, written};
+}
+
+size_t CsvPointParser::finish(absl::Span<Point> out) {
+    size_t written = 0;
+    if (overlong_) {
+        lines_skipped_++;
+    } else if (!partial_.empty() && !out.empty() && parse_line(partial_, &out[0])) {
+        written = 1;
+    }
+    partial_.clear();
+    overlong_ = false;
+    return written;
+}
+
+void CsvPointParser::reset() {
+    partial_.clear();
+    overlong_ = false;
+    points_parsed_ = 0;
+    lines_skipped_ = 0;
+}
+
+bool CsvPointParser::parse_line(absl::string_view line, Point* out) {
+    const char* p = line.data();
+    const char* end = p + line.size();
+    if (p != end && end[-1] == '\r') end--;
+    if (skip_blanks(p, end) == end) return false;  // Blank lines aren't errors
+
+    int32_t x;
+    int32_t y;
+    p = parse_coordinate(p, end, &x);
+    if (p && p != end && *p == ',') {
+        p = parse_coordinate(p + 1, end, &y);
+        if (p && (p == end || *p == ',')) {
+            *out = create_point(x, y);
+            points_parsed_++;
+            return true;
+        }
+    }
+
+    lines_skipped_++;
+    return false;
+}
+
 // GeometryCache implementation demonstrating Abseil containers and time utilities
 void GeometryCache::cache_rectangle(absl::string_view id, const Rectangle& rect) {
     std::string key(id);
@@ -136,27 +271,24 @@ std::vector<std::string> GeometryCache::list_cached_ids() const {
 }
 
 std::vector<Point> GeometryCache::parse_points_from_csv(absl::string_view csv_data) {
+    CsvPointParser parser;
     std::vector<Point> points;
-
-    // Split by lines first
-    std::vector<absl::string_view> lines = absl::StrSplit(csv_data, '\n');
-
-    for (absl::string_view line : lines) {
-        if (line.empty()) continue;
-
-        // Split each line by comma
-        std::vector<absl::string_view> coords = absl::StrSplit(line, ',');
-        if (coords.size() >= 2) {
-            try {
-                int32_t x = std::stoi(std::string(coords[0]));
-                int32_t y = std::stoi(std::string(coords[1]));
-                points.push_back(create_point(x, y));
-            } catch (const std::exception& e) {
-                spdlog::warn("Failed to parse coordinates from line: '{}'", line);
-            }
-        }
+    size_t count = 0;
+
+    // Grow the buffer as it fills; the parser resumes where it stopped
+    while (!csv_data.empty()) {
+        if (count == points.size()) points.resize(std::max<size_t>(64, points.size() * 2));
+        CsvPointParser::FeedResult result = parser.feed(csv_data, absl::MakeSpan(points).subspan(count));
+        count += result.written;
+        csv_data.remove_prefix(result.consumed);
     }
+    if (count == points.size()) points.resize(count + 1);
+    count += parser.finish(absl::MakeSpan(points).subspan(count));
+    points.resize(count);
 
+    if (parser.lines_skipped() > 0) {
+        spdlog::warn("Skipped {} malformed lines in CSV data", parser.lines_skipped());
+    }
     spdlog::info("Parsed {} points from CSV data", points.size());
     return points;
 }
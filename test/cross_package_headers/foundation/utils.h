@@ -14,6 +14,7 @@
 #include "absl/strings/str_split.h"         // String splitting
 #include "absl/strings/str_join.h"          // String joining
 #include "absl/container/flat_hash_map.h"   // High-performance hash map
+#include "absl/types/span.h"                // Non-owning output buffers
 #include "absl/time/time.h"                 // Time utilities
 #include "absl/time/clock.h"                // Clock utilities
 #include "spdlog/spdlog.h"                  // Fast logging
@@ -72,6 +73,45 @@ Rectangle rectangle_from_json(const nlohmann::json& j);
 std::string get_config_as_json();
 bool load_config_from_json(const std::string& json_str);
 
+// Streaming "x,y" CSV point parser for inputs too large to hold in memory
+//
+// Feed the input in chunks of any size, split anywhere: points are written
+// straight into a caller-supplied buffer and the parser keeps at most one
+// partial line between calls, so memory stays bounded however big the
+// input is. Lines need two integer fields; extra fields are ignored, blank
+// lines are skipped and malformed or overlong lines are skipped and
+// counted. Newlines are found with vector compares and numbers converted
+// with std::from_chars.
+class CsvPointParser {
+public:
+    static constexpr size_t kMaxLineLength = 4096;
+
+    struct FeedResult {
+        size_t consumed;  // Bytes of the chunk used; feed the rest once out is drained
+        size_t written;   // Points written to the front of out
+    };
+
+    // Parse the complete lines of chunk until out is full
+    FeedResult feed(absl::string_view chunk, absl::Span<Point> out);
+
+    // Parse a last line that had no newline; returns the points written (0 or 1)
+    size_t finish(absl::Span<Point> out);
+
+    void reset();
+
+    size_t points_parsed() const { return points_parsed_; }
+    size_t lines_skipped() const { return lines_skipped_; }
+
+private:
+    // Handle one line without its newline, writing its point to *out
+    bool parse_line(absl::string_view line, Point* out);
+
+    std::string partial_;      // Start of a line split across chunks
+    bool overlong_ = false;    // Current line passed kMaxLineLength; drop it
+    size_t points_parsed_ = 0;
+    size_t lines_skipped_ = 0;
+};
+
 // Real-world Abseil utilities demonstrating compiled library usage
 class GeometryCache {
 public:
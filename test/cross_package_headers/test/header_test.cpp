@@ -47,6 +47,19 @@ int main() {
     assert(center.y == 40); // (20 + 60) / 2 = 40
     std::cout << "✓ Center calculation works: " << foundation::utils::point_to_string(center) << "\n";
 
+    // Test 7: Streaming CSV parser with a line split across chunks
+    foundation::utils::CsvPointParser parser;
+    foundation::Point parsed[2];
+    auto first = parser.feed("1,2\n3,", absl::MakeSpan(parsed));
+    assert(first.consumed == 6 && first.written == 1);
+    auto second = parser.feed("4\nbad\n", absl::MakeSpan(parsed + 1, 1));
+    assert(second.consumed == 2 && second.written == 1);  // Stops once out is full
+    assert(parsed[1].x == 3 && parsed[1].y == 4);
+    assert(parser.feed("bad\n", absl::MakeSpan(parsed)).written == 0);
+    assert(parser.finish(absl::MakeSpan(parsed)) == 0);
+    assert(parser.points_parsed() == 2 && parser.lines_skipped() == 1);
+    std::cout << "✓ Streaming CSV parsing works\n";
+
     std::cout << "\n🎉 All cross-package header tests passed!\n";
     std::cout << "Headers are properly staged and include paths work correctly.\n";
 
@@ -12,6 +12,7 @@ def _cpp_component_toolchain_impl(ctx):
         clang = ctx.file.clang,
         clang_cpp = ctx.file.clang_cpp,
         llvm_ar = ctx.file.llvm_ar,
+        llvm_profdata = ctx.files.llvm_profdata[0] if ctx.files.llvm_profdata else None,
         wit_bindgen = ctx.file.wit_bindgen,
         wasm_tools = ctx.file.wasm_tools,
         sysroot = ctx.attr.sysroot_path,
@@ -43,6 +44,11 @@ cpp_component_toolchain = rule(
             cfg = "exec",
             doc = "LLVM archiver binary",
         ),
+        "llvm_profdata": attr.label(
+            allow_files = True,
+            cfg = "exec",
+            doc = "llvm-profdata binary for merging PGO profiles; optional, may be an empty filegroup",
+        ),
         "wit_bindgen": attr.label(
             allow_single_file = True,
             executable = True,
@@ -217,6 +223,7 @@ def _create_wasi_sdk_wrappers(repository_ctx, wasi_sdk_dir, platform):
     clang_path = "{}/bin/clang{}".format(repo_root, exe_suffix)
     clang_cpp_path = "{}/bin/clang++{}".format(repo_root, exe_suffix)
     llvm_ar_path = "{}/bin/llvm-ar{}".format(repo_root, exe_suffix)
+    llvm_profdata_path = "{}/bin/llvm-profdata{}".format(repo_root, exe_suffix)
 
     if repository_ctx.path(clang_path).exists:
         repository_ctx.symlink(clang_path, "clang")
@@ -233,6 +240,10 @@ def _create_wasi_sdk_wrappers(repository_ctx, wasi_sdk_dir, platform):
     else:
         fail("WASI SDK llvm-ar not found at {}".format(llvm_ar_path))
 
+    # Only cpp_pgo_profile needs it, and not every WASI SDK ships it
+    if repository_ctx.path(llvm_profdata_path).exists:
+        repository_ctx.symlink(llvm_profdata_path, "llvm_profdata")
+
 def _setup_component_tools(repository_ctx):
     """Set up wit-bindgen and wasm-tools using Bazel toolchain resolution"""
 
@@ -287,6 +298,12 @@ filegroup(
     visibility = ["//visibility:public"],
 )
 
+filegroup(
+    name = "llvm_profdata_binary",
+    srcs = glob(["llvm_profdata"], allow_empty = True),
+    visibility = ["//visibility:public"],
+)
+
 # Reference tools from WASM toolchain instead of local files
 alias(
     name = "wit_bindgen_binary",
@@ -312,6 +329,7 @@ cpp_component_toolchain(
     clang = ":clang_binary",
     clang_cpp = ":clang_cpp_binary",
     llvm_ar = ":llvm_ar_binary",
+    llvm_profdata = ":llvm_profdata_binary",
     wit_bindgen = ":wit_bindgen_binary",
     wasm_tools = ":wasm_tools_binary",
     sysroot_path = "sysroot",